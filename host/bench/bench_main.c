@@ -0,0 +1,162 @@
+/**
+ * @file bench_main.c
+ * @brief tripta_bench: los micro-benchmarks de bench.h compilados para el PC.
+ * @details Arranca el firmware como tripta_sim (sim_boot()), lo deja calentar el horno
+ *          BENCH_SETTLE_S segundos virtuales para que el PID, la gráfica y las métricas tengan
+ *          datos, y corre las pruebas desde una tarea con la prioridad de la consola del equipo.
+ *          El reloj virtual no avanza mientras corren, así que ninguna otra tarea las interrumpe.
+ *
+ *          Cada prueba escribe una línea JSON por stdout (la de bench_format_json(), con
+ *          "target":"host"); el firmware escribe en /dev/null. Los ciclos son del TSC en x86 y
+ *          nanosegundos en otras arquitecturas: sirven para comparar dos versiones en la misma
+ *          máquina, no para predecir las cifras del ESP32-S3.
+ *
+ *          Uso: tripta_bench [nombre|all|list] [-n iteraciones] [-r repeticiones]
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-22
+ */
+
+#include "sim.h"
+#include "bench.h"
+#include "hal_host.h"
+#include "pid_controller.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define BENCH_SETTLE_S          60      ///< Calentamiento del horno antes de medir
+#define BENCH_TASK_PRIORITY     2       ///< La de la tarea de la consola (REPL de esp_console)
+#define BENCH_TASK_STACK        6144
+#define BENCH_SETPOINT_C        60.0f
+
+typedef struct {
+    const char *name;
+    uint32_t iterations;
+    uint32_t repeats;
+} bench_opts_t;
+
+static FILE *s_out = NULL;
+static bench_opts_t s_opts = { .name = "all" };
+static volatile bool s_done = false;
+static int s_failed = 0;
+
+static int quiet_vprintf(const char *format, va_list args)
+{
+    (void)format;
+    (void)args;
+    return 0;
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "uso: tripta_bench [nombre|all|list] [-n iteraciones] [-r repeticiones]\n");
+}
+
+static bool parse_u32(const char *s, uint32_t min, uint32_t max, uint32_t *out)
+{
+    char *end = NULL;
+    const unsigned long v = strtoul(s, &end, 0);
+    if (end == s || *end != '\0' || v < min || v > max) {
+        return false;
+    }
+    *out = (uint32_t)v;
+    return true;
+}
+
+static bool parse_args(int argc, char **argv, bench_opts_t *o)
+{
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            if (!parse_u32(argv[++i], 1, UINT32_MAX, &o->iterations)) {
+                return false;
+            }
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            if (!parse_u32(argv[++i], 1, BENCH_MAX_REPEATS, &o->repeats)) {
+                return false;
+            }
+        } else if (argv[i][0] == '-') {
+            return false;
+        } else {
+            o->name = argv[i];
+        }
+    }
+    return true;
+}
+
+static void run_one(const char *name)
+{
+    bench_result_t res;
+    const esp_err_t err = bench_run(name, s_opts.iterations, s_opts.repeats, &res);
+    if (err != ESP_OK) {
+        fprintf(s_out, "{\"bench\":\"%s\",\"target\":\"host\",\"error\":\"%s\"}\n", name, esp_err_to_name(err));
+        s_failed = 1;
+        return;
+    }
+    char line[320];
+    bench_format_json(&res, line, sizeof(line));
+    fprintf(s_out, "%s\n", line);
+}
+
+static void bench_task(void *arg)
+{
+    (void)arg;
+    if (strcmp(s_opts.name, "all") != 0) {
+        run_one(s_opts.name);
+    } else {
+        for (size_t i = 0; i < bench_count(); i++) {
+            run_one(bench_name(i));
+        }
+    }
+    s_done = true;
+    // Sin vTaskDelete(NULL): el kernel del host no libera el TCB de una tarea que se borra sola
+    for (;;) {
+        vTaskDelay(portMAX_DELAY);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (!parse_args(argc, argv, &s_opts)) {
+        usage();
+        return 2;
+    }
+    if (strcmp(s_opts.name, "list") == 0) {
+        for (size_t i = 0; i < bench_count(); i++) {
+            printf("%-12s %lu\n", bench_name(i), (unsigned long)bench_default_iterations(i));
+        }
+        return 0;
+    }
+
+    // El firmware imprime por stdout (p. ej. el PID en cada ciclo); los resultados van aparte
+    s_out = fdopen(dup(STDOUT_FILENO), "w");
+    if (s_out == NULL || freopen("/dev/null", "w", stdout) == NULL) {
+        perror("tripta_bench");
+        return 2;
+    }
+
+    esp_log_set_vprintf(quiet_vprintf);
+    esp_log_level_set("*", ESP_LOG_INFO);
+    ESP_ERROR_CHECK(sim_boot(1));
+    pid_set_setpoint(BENCH_SETPOINT_C);
+    enable_pid();
+    if (hal_host_kernel_run_until_us(BENCH_SETTLE_S * 1000000LL) != ESP_OK) {
+        return 2;
+    }
+
+    if (xTaskCreate(bench_task, "bench", BENCH_TASK_STACK, NULL, BENCH_TASK_PRIORITY, NULL) != pdPASS) {
+        return 2;
+    }
+    // Las pruebas no gastan tiempo virtual: terminan antes del próximo segundo
+    if (hal_host_kernel_run_until_us((BENCH_SETTLE_S + 1) * 1000000LL) != ESP_OK || !s_done) {
+        fprintf(stderr, "tripta_bench: las pruebas no terminaron\n");
+        return 2;
+    }
+    fflush(s_out);
+    return s_failed;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file event_bus_fake.c
+ * @brief event_bus.h síncrono: cada suscriptor recibe el evento dentro de evbus_publish().
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#include "host_fakes.h"
+#include "timebase.h"
+#include <string.h>
+
+typedef struct {
+    const char *name;
+    uint32_t mask;
+    evbus_handler_t handler;
+    void *ctx;
+    uint32_t delivered;
+} fake_sub_t;
+
+static fake_sub_t s_subs[EVBUS_MAX_SUBSCRIBERS];
+static size_t s_sub_count = 0;
+static uint32_t s_seq = 0;
+static uint32_t s_count[EVBUS_TYPE_COUNT];
+static evbus_event_t s_last[EVBUS_TYPE_COUNT];
+
+esp_err_t evbus_init(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t evbus_subscribe(const char *name, uint32_t mask, size_t depth,
+                          evbus_handler_t handler, void *ctx)
+{
+    (void)depth;
+    if (handler == NULL || mask == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_sub_count == EVBUS_MAX_SUBSCRIBERS) {
+        return ESP_ERR_NO_MEM;
+    }
+    s_subs[s_sub_count++] = (fake_sub_t){ .name = name, .mask = mask, .handler = handler, .ctx = ctx };
+    return ESP_OK;
+}
+
+esp_err_t evbus_publish(evbus_event_t *ev)
+{
+    if (ev == NULL || ev->type >= EVBUS_TYPE_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ev->seq = ++s_seq;
+    ev->t_us = timebase_mono_us();
+    s_count[ev->type]++;
+    s_last[ev->type] = *ev;
+    for (size_t i = 0; i < s_sub_count; i++) {
+        if (s_subs[i].mask & EVBUS_MASK(ev->type)) {
+            s_subs[i].delivered++;
+            s_subs[i].handler(ev, s_subs[i].ctx);
+        }
+    }
+    return ESP_OK;
+}
+
+void evbus_get_stats(evbus_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    stats->published = s_seq;
+}
+
+size_t evbus_get_sub_stats(evbus_sub_stats_t *out, size_t max)
+{
+    const size_t n = max < s_sub_count ? max : s_sub_count;
+    for (size_t i = 0; i < n; i++) {
+        out[i] = (evbus_sub_stats_t){ .name = s_subs[i].name, .delivered = s_subs[i].delivered };
+    }
+    return n;
+}
+
+// ───────────────────────────────────────────────────────
+// host_fakes.h
+
+uint32_t evbus_fake_count(evbus_type_t type)
+{
+    return type < EVBUS_TYPE_COUNT ? s_count[type] : 0;
+}
+
+bool evbus_fake_last(evbus_type_t type, evbus_event_t *out)
+{
+    if (type >= EVBUS_TYPE_COUNT || s_count[type] == 0) {
+        return false;
+    }
+    *out = s_last[type];
+    return true;
+}
+
+void evbus_fake_deliver(const evbus_event_t *ev)
+{
+    for (size_t i = 0; i < s_sub_count; i++) {
+        if (s_subs[i].mask & EVBUS_MASK(ev->type)) {
+            s_subs[i].delivered++;
+            s_subs[i].handler(ev, s_subs[i].ctx);
+        }
+    }
+}
+
+void evbus_fake_reset(void)
+{
+    memset(s_subs, 0, sizeof(s_subs));
+    s_sub_count = 0;
+    s_seq = 0;
+    memset(s_count, 0, sizeof(s_count));
+}
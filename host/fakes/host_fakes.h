@@ -0,0 +1,89 @@
+/**
+ * @file host_fakes.h
+ * @brief Planificador, bus de eventos y pila WiFi de prueba para las pruebas unitarias del host.
+ * @details Las pruebas unitarias no arrancan tareas, así que scheduler.h y event_bus.h se
+ *          reemplazan por versiones síncronas: los trabajos corren cuando la prueba los pide
+ *          (o cuando adelanta el reloj) y los eventos se entregan dentro de evbus_publish().
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#ifndef HOST_FAKES_H
+#define HOST_FAKES_H
+
+#include "scheduler.h"
+#include "event_bus.h"
+#include "esp_wifi.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Ejecuta una vez el trabajo con ese nombre, esté armado o no
+ * @return true si existe
+ */
+bool sched_fake_run(const char *name);
+
+/**
+ * @brief Adelanta el reloj hasta el vencimiento del trabajo con ese nombre y lo ejecuta
+ * @return false si no existe o está desarmado
+ */
+bool sched_fake_run_armed(const char *name);
+
+/**
+ * @brief Ejecuta los trabajos vencidos según el reloj actual
+ * @return Ejecuciones
+ */
+uint32_t sched_fake_run_due(void);
+
+/**
+ * @brief Adelanta el reloj de a un vencimiento, ejecutando cada trabajo en su momento
+ */
+void sched_fake_advance_ms(uint32_t ms);
+
+/**
+ * @brief Olvida todos los trabajos
+ */
+void sched_fake_reset(void);
+
+/**
+ * @brief Eventos publicados de un tipo desde el último reinicio
+ */
+uint32_t evbus_fake_count(evbus_type_t type);
+
+/**
+ * @brief Copia el último evento publicado de un tipo
+ * @return false si no hubo ninguno
+ */
+bool evbus_fake_last(evbus_type_t type, evbus_event_t *out);
+
+/**
+ * @brief Entrega ahora un evento ya publicado, conservando su `seq` y `t_us`
+ * @details Simula la entrega diferida del bus real (cola por suscriptor).
+ */
+void evbus_fake_deliver(const evbus_event_t *ev);
+
+/**
+ * @brief Olvida suscriptores y eventos
+ */
+void evbus_fake_reset(void);
+
+/**
+ * @brief Última configuración de la estación pasada a esp_wifi_set_config()
+ */
+const wifi_config_t *wifi_fake_sta_config(void);
+
+/**
+ * @brief Asocia la estación al AP indicado y publica IP_EVENT_STA_GOT_IP
+ */
+void wifi_fake_got_ip(const uint8_t bssid[6], uint8_t channel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_FAKES_H
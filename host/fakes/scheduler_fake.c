@@ -0,0 +1,207 @@
+/**
+ * @file scheduler_fake.c
+ * @brief scheduler.h síncrono: los trabajos corren cuando la prueba lo decide.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#include "host_fakes.h"
+#include "hal_host.h"
+#include "hal_clock.h"
+#include <string.h>
+
+struct sched_job {
+    const char *name;
+    sched_fn_t fn;
+    void *ctx;
+    uint32_t period_ms;
+    int64_t due_us;             ///< INT64_MAX si está desarmado
+    bool used;
+    sched_job_stats_t stats;
+};
+
+static struct sched_job s_jobs[SCHED_MAX_JOBS];
+
+static void run_job(struct sched_job *job)
+{
+    job->stats.runs++;
+    job->fn(job->ctx);
+}
+
+esp_err_t sched_init(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t sched_add(const char *name, sched_fn_t fn, void *ctx, uint32_t delay_ms,
+                    uint32_t period_ms, sched_job_handle_t *out)
+{
+    if (fn == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (size_t i = 0; i < SCHED_MAX_JOBS; i++) {
+        struct sched_job *job = &s_jobs[i];
+        if (!job->used) {
+            *job = (struct sched_job){ .name = name, .fn = fn, .ctx = ctx, .period_ms = period_ms,
+                                       .used = true };
+            job->stats.name = name;
+            job->stats.period_ms = period_ms;
+            job->due_us = delay_ms == SCHED_DISARMED ? INT64_MAX
+                                                     : hal_clock_mono_us() + (int64_t)delay_ms * 1000;
+            if (out != NULL) {
+                *out = job;
+            }
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+esp_err_t sched_trigger(sched_job_handle_t job, uint32_t delay_ms)
+{
+    if (job == NULL || !job->used) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    job->due_us = hal_clock_mono_us() + (int64_t)delay_ms * 1000;
+    return ESP_OK;
+}
+
+esp_err_t sched_set_period(sched_job_handle_t job, uint32_t period_ms)
+{
+    if (job == NULL || !job->used) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    job->period_ms = period_ms;
+    job->stats.period_ms = period_ms;
+    return ESP_OK;
+}
+
+esp_err_t sched_disarm(sched_job_handle_t job)
+{
+    if (job == NULL || !job->used) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    job->due_us = INT64_MAX;
+    return ESP_OK;
+}
+
+esp_err_t sched_cancel(sched_job_handle_t job)
+{
+    if (job == NULL || !job->used) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    job->used = false;
+    return ESP_OK;
+}
+
+void sched_get_stats(sched_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    for (size_t i = 0; i < SCHED_MAX_JOBS; i++) {
+        if (s_jobs[i].used) {
+            stats->jobs++;
+            stats->runs += s_jobs[i].stats.runs;
+        }
+    }
+}
+
+size_t sched_get_job_stats(sched_job_stats_t *out, size_t max)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < SCHED_MAX_JOBS && n < max; i++) {
+        if (s_jobs[i].used) {
+            out[n++] = s_jobs[i].stats;
+        }
+    }
+    return n;
+}
+
+void sched_log_report(void)
+{
+}
+
+// ───────────────────────────────────────────────────────
+// host_fakes.h
+
+bool sched_fake_run(const char *name)
+{
+    for (size_t i = 0; i < SCHED_MAX_JOBS; i++) {
+        if (s_jobs[i].used && strcmp(s_jobs[i].name, name) == 0) {
+            run_job(&s_jobs[i]);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Trabajo armado con el vencimiento más próximo
+ */
+static struct sched_job *next_due(void)
+{
+    struct sched_job *next = NULL;
+    for (size_t i = 0; i < SCHED_MAX_JOBS; i++) {
+        struct sched_job *job = &s_jobs[i];
+        if (job->used && job->due_us != INT64_MAX && (next == NULL || job->due_us < next->due_us)) {
+            next = job;
+        }
+    }
+    return next;
+}
+
+static void fire(struct sched_job *job)
+{
+    // Se rearma antes de correr: el trabajo puede desarmarse o cambiar su periodo
+    job->due_us = job->period_ms > 0 ? job->due_us + (int64_t)job->period_ms * 1000 : INT64_MAX;
+    run_job(job);
+}
+
+bool sched_fake_run_armed(const char *name)
+{
+    for (size_t i = 0; i < SCHED_MAX_JOBS; i++) {
+        struct sched_job *job = &s_jobs[i];
+        if (job->used && strcmp(job->name, name) == 0) {
+            if (job->due_us == INT64_MAX) {
+                return false;
+            }
+            if (job->due_us > hal_clock_mono_us()) {
+                hal_host_clock_set_us(job->due_us);
+            }
+            fire(job);
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t sched_fake_run_due(void)
+{
+    uint32_t runs = 0;
+    struct sched_job *job;
+    while ((job = next_due()) != NULL && job->due_us <= hal_clock_mono_us()) {
+        fire(job);
+        runs++;
+    }
+    return runs;
+}
+
+void sched_fake_advance_ms(uint32_t ms)
+{
+    const int64_t end = hal_clock_mono_us() + (int64_t)ms * 1000;
+    struct sched_job *job;
+    while ((job = next_due()) != NULL && job->due_us <= end) {
+        if (job->due_us > hal_clock_mono_us()) {
+            hal_host_clock_set_us(job->due_us);
+        }
+        fire(job);
+    }
+    if (end > hal_clock_mono_us()) {
+        hal_host_clock_set_us(end);
+    }
+}
+
+void sched_fake_reset(void)
+{
+    memset(s_jobs, 0, sizeof(s_jobs));
+}
@@ -0,0 +1,225 @@
+/**
+ * @file wifi_fake.c
+ * @brief Pila WiFi de prueba para wifi_manager.c y wifi_prov.c.
+ * @details Bucle de eventos síncrono (cada esp_event_post() llama a los manejadores antes de
+ *          volver, con una copia del dato), esp_wifi que guarda la última configuración de la
+ *          estación, temporizadores de esp_timer que no disparan, y mDNS y BLE vacíos. La
+ *          conexión y la IP las decide la prueba con wifi_fake_got_ip().
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#include "host_fakes.h"
+#include "esp_netif.h"
+#include "esp_timer.h"
+#include "mdns.h"
+#include "bt.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define FAKE_MAX_HANDLERS   8
+#define FAKE_MAX_TIMERS     4
+
+ESP_EVENT_DEFINE_BASE(WIFI_EVENT);
+ESP_EVENT_DEFINE_BASE(IP_EVENT);
+
+typedef struct {
+    esp_event_base_t base;
+    int32_t id;
+    esp_event_handler_t handler;
+    void *arg;
+} fake_handler_t;
+
+struct esp_timer {
+    esp_timer_create_args_t args;
+    bool armed;
+};
+
+static fake_handler_t s_handlers[FAKE_MAX_HANDLERS];
+static size_t s_handler_count = 0;
+static struct esp_timer s_timers[FAKE_MAX_TIMERS];
+static size_t s_timer_count = 0;
+static wifi_config_t s_sta_config;
+static wifi_ap_record_t s_ap_record;
+static bool s_associated = false;
+
+// ───────────────────────────────────────────────────────
+// Bucle de eventos
+
+esp_err_t esp_event_loop_create_default(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_event_handler_instance_register(esp_event_base_t base, int32_t id, esp_event_handler_t handler,
+                                              void *arg, esp_event_handler_instance_t *instance)
+{
+    if (s_handler_count == FAKE_MAX_HANDLERS) {
+        return ESP_ERR_NO_MEM;
+    }
+    s_handlers[s_handler_count] = (fake_handler_t){ .base = base, .id = id, .handler = handler, .arg = arg };
+    if (instance != NULL) {
+        *instance = &s_handlers[s_handler_count];
+    }
+    s_handler_count++;
+    return ESP_OK;
+}
+
+esp_err_t esp_event_post(esp_event_base_t base, int32_t id, const void *data, size_t size, TickType_t ticks)
+{
+    (void)ticks;
+    void *copy = NULL;
+    if (size > 0) {
+        copy = malloc(size);
+        if (copy == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+        memcpy(copy, data, size);
+    }
+    for (size_t i = 0; i < s_handler_count; i++) {
+        const fake_handler_t *h = &s_handlers[i];
+        if (h->base == base && (h->id == ESP_EVENT_ANY_ID || h->id == id)) {
+            h->handler(h->arg, base, id, copy);
+        }
+    }
+    free(copy);
+    return ESP_OK;
+}
+
+// ───────────────────────────────────────────────────────
+// WiFi, red y mDNS
+
+esp_err_t esp_netif_init(void)
+{
+    return ESP_OK;
+}
+
+esp_netif_t *esp_netif_create_default_wifi_sta(void)
+{
+    return NULL;
+}
+
+esp_err_t esp_wifi_init(const wifi_init_config_t *config)
+{
+    (void)config;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_mode(wifi_mode_t mode)
+{
+    (void)mode;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_start(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_config(wifi_interface_t interface, wifi_config_t *conf)
+{
+    if (interface != WIFI_IF_STA || conf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_sta_config = *conf;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_connect(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_disconnect(void)
+{
+    s_associated = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_sta_get_ap_info(wifi_ap_record_t *ap_info)
+{
+    if (!s_associated) {
+        return ESP_ERR_WIFI_NOT_STARTED;
+    }
+    *ap_info = s_ap_record;
+    return ESP_OK;
+}
+
+esp_err_t mdns_init(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t mdns_hostname_set(const char *hostname)
+{
+    (void)hostname;
+    return ESP_OK;
+}
+
+esp_err_t mdns_service_add(const char *instance, const char *service, const char *proto, uint16_t port,
+                           mdns_txt_item_t txt[], size_t num_items)
+{
+    (void)instance;
+    (void)service;
+    (void)proto;
+    (void)port;
+    (void)txt;
+    (void)num_items;
+    return ESP_OK;
+}
+
+esp_err_t bt_start(void)
+{
+    // El provisioning BLE no existe en el host
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+// ───────────────────────────────────────────────────────
+// Temporizadores
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *out)
+{
+    if (args == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_timer_count == FAKE_MAX_TIMERS) {
+        return ESP_ERR_NO_MEM;
+    }
+    s_timers[s_timer_count] = (struct esp_timer){ .args = *args };
+    *out = &s_timers[s_timer_count++];
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    (void)timeout_us;
+    timer->armed = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    const bool was_armed = timer->armed;
+    timer->armed = false;
+    return was_armed ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+// ───────────────────────────────────────────────────────
+// host_fakes.h
+
+const wifi_config_t *wifi_fake_sta_config(void)
+{
+    return &s_sta_config;
+}
+
+void wifi_fake_got_ip(const uint8_t bssid[6], uint8_t channel)
+{
+    memset(&s_ap_record, 0, sizeof(s_ap_record));
+    memcpy(s_ap_record.bssid, bssid, sizeof(s_ap_record.bssid));
+    memcpy(s_ap_record.ssid, s_sta_config.sta.ssid, sizeof(s_sta_config.sta.ssid));
+    s_ap_record.primary = channel;
+    s_ap_record.rssi = -50;
+    s_associated = true;
+    esp_event_post(IP_EVENT, IP_EVENT_STA_GOT_IP, NULL, 0, 0);
+}
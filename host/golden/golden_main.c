@@ -0,0 +1,582 @@
+/**
+ * @file golden_main.c
+ * @brief tripta_golden: regresión del lazo de control contra trazas de referencia.
+ * @details Corre en el simulador (sim_boot(), planta de plant.c, sin carga de red) escenarios
+ *          canónicos: arranques en frío a 60/120/180 °C, un escalón de setpoint, la puerta
+ *          abierta y el sensor mudo. Cada GOLDEN_SAMPLE_S segundos virtuales anota la
+ *          temperatura de la cámara, la EMA del firmware, la salida del PID, la fracción con el
+ *          SSR encendido y los flancos acumulados, y compara la traza con la guardada en
+ *          GOLDEN_DIR/<escenario>.csv muestra a muestra, con una tolerancia por columna. Un
+ *          cambio en el filtro, en la cuenta del PID o en la modulación que mueva alguna columna
+ *          más allá de su tolerancia hace fallar el escenario.
+ *
+ *          El informe de cada escenario trae el mayor desvío por columna, los indicadores de
+ *          control (llegada, sobrepico, banda, ciclo útil, conmutaciones, perturbación) de la
+ *          referencia y de la corrida con su diferencia, y el costo por tick de control en CPU
+ *          del PC (hal_host_task_stats_t::cpu_ns), que solo sirve para comparar en la misma
+ *          máquina y no forma parte de la comparación.
+ *
+ *          Los módulos del firmware se inicializan una sola vez por proceso: cada escenario
+ *          corre en un proceso hijo, todos a la vez, y el padre imprime los informes en orden.
+ *
+ *          Uso: tripta_golden [--update] [--dir DIR] [escenario]...
+ *          --update reescribe las referencias con la corrida actual.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-23
+ */
+
+#include "sim.h"
+#include "hal_host.h"
+#include "ch422g_model.h"
+#include "modbus_sensor_model.h"
+#include "deadline.h"
+#include "sensor.h"
+#include "pid_controller.h"
+#include "esp_log.h"
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef GOLDEN_DIR
+#define GOLDEN_DIR "."
+#endif
+
+#define GOLDEN_SAMPLE_S     30          ///< Periodo de muestreo de la traza
+#define GOLDEN_MAX_SAMPLES  256
+#define GOLDEN_BAND_C       1.0f        ///< Banda que cuenta como "en el setpoint"
+#define GOLDEN_SETTLE_S     600         ///< Recuperación excluida de la banda tras una perturbación
+#define GOLDEN_REPORT_MAX   8192        ///< Informe de un escenario (lo que lee el padre)
+
+typedef enum {
+    GOLDEN_NONE = 0,
+    GOLDEN_STEP,        ///< Cambia el setpoint a `value_c`
+    GOLDEN_DOOR,        ///< Abre la puerta `len_s` segundos
+    GOLDEN_DROPOUT,     ///< Silencia el sensor `len_s` segundos
+} golden_event_t;
+
+typedef struct {
+    const char *name;
+    const char *desc;
+    uint32_t minutes;
+    float setpoint_c;
+    golden_event_t event;
+    uint32_t at_s;
+    uint32_t len_s;
+    float value_c;
+} golden_scenario_t;
+
+static const golden_scenario_t s_scenarios[] = {
+    { "cold_60",     "arranque en frío a 60 °C",           30, 60.0f,  GOLDEN_NONE,    0,    0,  0.0f   },
+    { "cold_120",    "arranque en frío a 120 °C",          45, 120.0f, GOLDEN_NONE,    0,    0,  0.0f   },
+    { "cold_180",    "arranque en frío a 180 °C",          70, 180.0f, GOLDEN_NONE,    0,    0,  0.0f   },
+    { "step_60_120", "escalón de 60 a 120 °C a los 20 min", 50, 60.0f,  GOLDEN_STEP,    1200, 0,  120.0f },
+    { "door_120",    "puerta abierta 60 s a 120 °C",        45, 120.0f, GOLDEN_DOOR,    1800, 60, 0.0f   },
+    { "dropout_120", "sensor mudo 60 s a 120 °C",           45, 120.0f, GOLDEN_DROPOUT, 1800, 60, 0.0f   },
+};
+
+#define GOLDEN_SCENARIOS (sizeof(s_scenarios) / sizeof(s_scenarios[0]))
+
+/**
+ * @brief Columnas de la traza y su tolerancia (diferencia absoluta admitida por muestra)
+ */
+typedef enum {
+    COL_CHAMBER = 0,
+    COL_EMA,
+    COL_DUTY,
+    COL_SSR_ON,
+    COL_SSR_EDGES,
+    COL_COUNT,
+} golden_col_t;
+
+static const struct {
+    const char *name;
+    double tolerance;
+} s_cols[COL_COUNT] = {
+    [COL_CHAMBER]   = { "chamber_c",  0.5  },
+    [COL_EMA]       = { "ema_c",      0.5  },
+    [COL_DUTY]      = { "duty_pct",   10.0 },
+    [COL_SSR_ON]    = { "ssr_on_pct", 10.0 },
+    [COL_SSR_EDGES] = { "ssr_edges",  6.0  },
+};
+
+typedef struct {
+    uint32_t t_s;
+    double v[COL_COUNT];
+} golden_sample_t;
+
+typedef struct {
+    golden_sample_t s[GOLDEN_MAX_SAMPLES];
+    size_t count;
+} golden_trace_t;
+
+/**
+ * @brief Indicadores de control de una traza
+ */
+typedef struct {
+    double reach_min;           ///< Llegada a la banda desde el último cambio de setpoint (-1: nunca)
+    double overshoot_c;
+    double band_c;              ///< Mayor desvío en régimen, fuera de perturbaciones
+    double duty_pct;            ///< Salida media del PID en régimen
+    double edges_per_h;
+    double disturb_c;           ///< Mayor desvío desde la perturbación
+    double recovery_min;        ///< Vuelta a la banda tras la perturbación (-1: nunca)
+} golden_kpi_t;
+
+typedef struct {
+    const char *dir;
+    bool update;
+    bool selected[GOLDEN_SCENARIOS];
+} golden_opts_t;
+
+static FILE *s_out = NULL;      ///< Informe del escenario (el hijo escribe en su tubería)
+
+static void out(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    vfprintf(s_out, fmt, args);
+    va_end(args);
+}
+
+static int quiet_vprintf(const char *format, va_list args)
+{
+    (void)format;
+    (void)args;
+    return 0;
+}
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// ───────────────────────────────────────────────────────
+// Corrida
+
+static float final_setpoint(const golden_scenario_t *sc)
+{
+    return sc->event == GOLDEN_STEP ? sc->value_c : sc->setpoint_c;
+}
+
+static void apply_events(const golden_scenario_t *sc, uint32_t t_s)
+{
+    if (sc->event == GOLDEN_NONE || (t_s != sc->at_s && t_s != sc->at_s + sc->len_s)) {
+        return;
+    }
+    const bool start = t_s == sc->at_s;
+    switch (sc->event) {
+    case GOLDEN_STEP:
+        if (start) {
+            pid_set_setpoint(sc->value_c);
+        }
+        break;
+    case GOLDEN_DOOR:
+        plant_set_door(start);
+        break;
+    case GOLDEN_DROPOUT:
+        modbus_sensor_model_set_fault(start ? MODBUS_SENSOR_SILENT : MODBUS_SENSOR_OK);
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Costo de CPU del PC de la tarea del PID y de todo el firmware, y ticks de control
+ */
+static void tick_cost(double *pid_us, double *all_us, uint32_t *ticks)
+{
+    hal_host_task_stats_t ts[16];
+    const size_t n = hal_host_kernel_get_task_stats(ts, 16);
+    uint64_t pid_ns = 0;
+    uint64_t all_ns = 0;
+    for (size_t i = 0; i < n; i++) {
+        all_ns += ts[i].cpu_ns;
+        if (strcmp(ts[i].name, "PID_Task") == 0) {
+            pid_ns = ts[i].cpu_ns;
+        }
+    }
+    *ticks = 0;
+    deadline_stats_t ds[16];
+    const size_t m = deadline_get_stats(ds, 16);
+    for (size_t i = 0; i < m; i++) {
+        if (strcmp(ds[i].name, "pid_tick") == 0) {
+            *ticks = ds[i].runs;
+        }
+    }
+    *pid_us = *ticks > 0 ? pid_ns / 1e3 / *ticks : 0.0;
+    *all_us = *ticks > 0 ? all_ns / 1e3 / *ticks : 0.0;
+}
+
+static esp_err_t run_scenario(const golden_scenario_t *sc, golden_trace_t *tr)
+{
+    esp_log_set_vprintf(quiet_vprintf);
+    esp_log_level_set("*", ESP_LOG_INFO);
+    ESP_ERROR_CHECK(sim_boot(0));
+    pid_set_setpoint(sc->setpoint_c);
+    enable_pid();
+
+    tr->count = 0;
+    ch422g_model_state_t ch;
+    int64_t last_on_us = ch422g_model_ssr_on_us();
+    for (uint32_t t = 1; t <= sc->minutes * 60; t++) {
+        if (hal_host_kernel_run_until_us(t * 1000000LL) != ESP_OK) {
+            return ESP_FAIL;
+        }
+        apply_events(sc, t);
+        if (t % GOLDEN_SAMPLE_S != 0 || tr->count == GOLDEN_MAX_SAMPLES) {
+            continue;
+        }
+        const int64_t on_us = ch422g_model_ssr_on_us();
+        ch422g_model_get(&ch);
+        golden_sample_t *s = &tr->s[tr->count++];
+        s->t_s = t;
+        s->v[COL_CHAMBER] = plant_chamber_c();
+        s->v[COL_EMA] = read_ema_temp();
+        s->v[COL_DUTY] = pid_get_output();
+        s->v[COL_SSR_ON] = (on_us - last_on_us) / (GOLDEN_SAMPLE_S * 1e4);
+        s->v[COL_SSR_EDGES] = ch.ssr_edges;
+        last_on_us = on_us;
+    }
+    return ESP_OK;
+}
+
+// ───────────────────────────────────────────────────────
+// Trazas en CSV
+
+static void trace_path(const golden_opts_t *o, const golden_scenario_t *sc, char *buf, size_t size)
+{
+    snprintf(buf, size, "%s/%s.csv", o->dir, sc->name);
+}
+
+static esp_err_t trace_write(const char *path, const golden_scenario_t *sc, const golden_trace_t *tr)
+{
+    FILE *f = fopen(path, "w");
+    if (f == NULL) {
+        return ESP_FAIL;
+    }
+    fprintf(f, "# %s: %s, %lu min, muestra cada %d s (tripta_golden --update)\n", sc->name, sc->desc,
+            (unsigned long)sc->minutes, GOLDEN_SAMPLE_S);
+    fprintf(f, "t_s");
+    for (int c = 0; c < COL_COUNT; c++) {
+        fprintf(f, ",%s", s_cols[c].name);
+    }
+    fprintf(f, "\n");
+    for (size_t i = 0; i < tr->count; i++) {
+        const golden_sample_t *s = &tr->s[i];
+        fprintf(f, "%lu,%.3f,%.3f,%.2f,%.2f,%.0f\n", (unsigned long)s->t_s, s->v[COL_CHAMBER], s->v[COL_EMA],
+                s->v[COL_DUTY], s->v[COL_SSR_ON], s->v[COL_SSR_EDGES]);
+    }
+    return fclose(f) == 0 ? ESP_OK : ESP_FAIL;
+}
+
+static esp_err_t trace_read(const char *path, golden_trace_t *tr)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    char line[256];
+    tr->count = 0;
+    esp_err_t err = ESP_OK;
+    while (fgets(line, sizeof(line), f) != NULL) {
+        if (line[0] == '#' || strncmp(line, "t_s", 3) == 0) {
+            continue;
+        }
+        golden_sample_t *s = &tr->s[tr->count];
+        unsigned long t = 0;
+        if (tr->count == GOLDEN_MAX_SAMPLES ||
+            sscanf(line, "%lu,%lf,%lf,%lf,%lf,%lf", &t, &s->v[COL_CHAMBER], &s->v[COL_EMA], &s->v[COL_DUTY],
+                   &s->v[COL_SSR_ON], &s->v[COL_SSR_EDGES]) != 1 + COL_COUNT) {
+            err = ESP_ERR_INVALID_SIZE;
+            break;
+        }
+        s->t_s = (uint32_t)t;
+        tr->count++;
+    }
+    fclose(f);
+    return err;
+}
+
+// ───────────────────────────────────────────────────────
+// Comparación e indicadores
+
+static bool in_disturbance(const golden_scenario_t *sc, uint32_t t_s)
+{
+    return (sc->event == GOLDEN_DOOR || sc->event == GOLDEN_DROPOUT) && t_s >= sc->at_s &&
+           t_s < sc->at_s + sc->len_s + GOLDEN_SETTLE_S;
+}
+
+static void kpi_compute(const golden_scenario_t *sc, const golden_trace_t *tr, golden_kpi_t *k)
+{
+    const double sp = final_setpoint(sc);
+    const uint32_t from_s = sc->event == GOLDEN_STEP ? sc->at_s : 0;
+    const uint32_t event_end_s = sc->at_s + sc->len_s;
+    const bool disturbed = sc->event == GOLDEN_DOOR || sc->event == GOLDEN_DROPOUT;
+    int64_t reach_s = -1;
+    int64_t recovered_s = -1;
+    double duty_sum = 0.0;
+    uint32_t duty_n = 0;
+
+    memset(k, 0, sizeof(*k));
+    for (size_t i = 0; i < tr->count; i++) {
+        const golden_sample_t *s = &tr->s[i];
+        const double err = s->v[COL_CHAMBER] - sp;
+        if (s->t_s < from_s) {
+            continue;
+        }
+        if (err > k->overshoot_c) {
+            k->overshoot_c = err;
+        }
+        if (disturbed && s->t_s >= sc->at_s) {
+            k->disturb_c = fmax(k->disturb_c, fabs(err));
+            if (recovered_s < 0 && s->t_s >= event_end_s && fabs(err) <= GOLDEN_BAND_C) {
+                recovered_s = s->t_s;
+            }
+        }
+        if (reach_s < 0) {
+            if (err >= -GOLDEN_BAND_C) {
+                reach_s = s->t_s;
+            }
+            continue;
+        }
+        if (!in_disturbance(sc, s->t_s)) {
+            k->band_c = fmax(k->band_c, fabs(err));
+            duty_sum += s->v[COL_DUTY];
+            duty_n++;
+        }
+    }
+    k->reach_min = reach_s >= 0 ? (reach_s - from_s) / 60.0 : -1.0;
+    k->duty_pct = duty_n > 0 ? duty_sum / duty_n : 0.0;
+    k->edges_per_h = tr->count > 0 ? tr->s[tr->count - 1].v[COL_SSR_EDGES] * 3600.0 / tr->s[tr->count - 1].t_s : 0.0;
+    k->recovery_min = !disturbed ? 0.0 : recovered_s >= 0 ? (recovered_s - (int64_t)event_end_s) / 60.0 : -1.0;
+}
+
+/**
+ * @brief Nombre alineado a `width` columnas (los nombres llevan tildes y °)
+ */
+static void out_name(const char *name, int width)
+{
+    int cols = 0;
+    for (const char *c = name; *c != '\0'; c++) {
+        cols += ((unsigned char)*c & 0xC0) != 0x80;
+    }
+    out("%s%*s", name, width > cols ? width - cols : 0, "");
+}
+
+/**
+ * @brief Compara muestra a muestra; informa el mayor desvío de cada columna
+ * @return true si todas las columnas quedan dentro de su tolerancia
+ */
+static bool trace_compare(const golden_trace_t *ref, const golden_trace_t *run)
+{
+    if (ref->count != run->count) {
+        out("la referencia tiene %zu muestras y la corrida %zu: el escenario cambió (--update)\n",
+            ref->count, run->count);
+        return false;
+    }
+    bool ok = true;
+    out("%-12s %10s ", "columna", "tolerancia");
+    out_name("desvío máx", 12);
+    out(" %8s\n", "en t (s)");
+    for (int c = 0; c < COL_COUNT; c++) {
+        double worst = 0.0;
+        uint32_t worst_t = 0;
+        for (size_t i = 0; i < ref->count; i++) {
+            if (ref->s[i].t_s != run->s[i].t_s) {
+                out("la muestra %zu es de t=%lu s en la referencia y de t=%lu s en la corrida\n", i,
+                    (unsigned long)ref->s[i].t_s, (unsigned long)run->s[i].t_s);
+                return false;
+            }
+            const double d = fabs(run->s[i].v[c] - ref->s[i].v[c]);
+            if (d > worst) {
+                worst = d;
+                worst_t = ref->s[i].t_s;
+            }
+        }
+        const bool col_ok = worst <= s_cols[c].tolerance;
+        ok &= col_ok;
+        out("%-12s %10.2f %12.3f %8lu%s\n", s_cols[c].name, s_cols[c].tolerance, worst, (unsigned long)worst_t,
+            col_ok ? "" : "  FUERA DE TOLERANCIA");
+    }
+    return ok;
+}
+
+static void kpi_report(const golden_kpi_t *ref, const golden_kpi_t *run)
+{
+    static const char *names[] = {
+        "llegada min", "sobrepico °C", "banda °C", "salida PID %", "flancos SSR/h", "perturbación °C",
+        "recuperación min",
+    };
+    const double *a = (const double *)ref;
+    const double *b = (const double *)run;
+    out("%-18s %10s %10s %10s\n", "indicador", "referencia", "corrida", "delta");
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (ref != NULL) {
+            out_name(names[i], 18);
+            out(" %10.2f %10.2f %+10.2f\n", a[i], b[i], b[i] - a[i]);
+        } else {
+            out_name(names[i], 18);
+            out(" %10s %10.2f\n", "-", b[i]);
+        }
+    }
+}
+
+// ───────────────────────────────────────────────────────
+// Escenario (en el proceso hijo)
+
+static int scenario_main(const golden_opts_t *o, const golden_scenario_t *sc)
+{
+    static golden_trace_t run;
+    static golden_trace_t ref;
+    char path[512];
+    trace_path(o, sc, path, sizeof(path));
+
+    out("\n== %s: %s (%lu min) ==\n", sc->name, sc->desc, (unsigned long)sc->minutes);
+    const double t0 = now_s();
+    if (run_scenario(sc, &run) != ESP_OK) {
+        out("FALLA: el planificador del host se detuvo\n");
+        return 1;
+    }
+    const double elapsed = now_s() - t0;
+    double pid_us;
+    double all_us;
+    uint32_t ticks;
+    tick_cost(&pid_us, &all_us, &ticks);
+
+    golden_kpi_t k_run;
+    kpi_compute(sc, &run, &k_run);
+    bool ok = true;
+    if (o->update) {
+        ok = trace_write(path, sc, &run) == ESP_OK;
+        out("%s %s (%zu muestras)\n", ok ? "referencia escrita en" : "FALLA: no se pudo escribir", path, run.count);
+        kpi_report(NULL, &k_run);
+    } else {
+        const esp_err_t err = trace_read(path, &ref);
+        if (err != ESP_OK) {
+            out("FALLA: sin referencia legible en %s (%s); generarla con --update\n", path, esp_err_to_name(err));
+            return 1;
+        }
+        ok = trace_compare(&ref, &run);
+        golden_kpi_t k_ref;
+        kpi_compute(sc, &ref, &k_ref);
+        kpi_report(&k_ref, &k_run);
+    }
+    out("costo por tick de control (CPU del PC): PID_Task %.2f µs, firmware %.2f µs, %lu ticks, %.2f s reales\n",
+        pid_us, all_us, (unsigned long)ticks, elapsed);
+    out("%s\n", ok ? "OK" : "FALLA");
+    return ok ? 0 : 1;
+}
+
+// ───────────────────────────────────────────────────────
+// Programa
+
+static void usage(void)
+{
+    fprintf(stderr, "uso: tripta_golden [--update] [--dir DIR] [escenario]...\nescenarios:");
+    for (size_t i = 0; i < GOLDEN_SCENARIOS; i++) {
+        fprintf(stderr, " %s", s_scenarios[i].name);
+    }
+    fprintf(stderr, "\n");
+}
+
+static bool parse_args(int argc, char **argv, golden_opts_t *o)
+{
+    *o = (golden_opts_t){ .dir = GOLDEN_DIR };
+    bool any = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--update") == 0) {
+            o->update = true;
+        } else if (strcmp(argv[i], "--dir") == 0 && i + 1 < argc) {
+            o->dir = argv[++i];
+        } else {
+            size_t k = 0;
+            while (k < GOLDEN_SCENARIOS && strcmp(argv[i], s_scenarios[k].name) != 0) {
+                k++;
+            }
+            if (k == GOLDEN_SCENARIOS) {
+                return false;
+            }
+            o->selected[k] = true;
+            any = true;
+        }
+    }
+    if (!any) {
+        for (size_t k = 0; k < GOLDEN_SCENARIOS; k++) {
+            o->selected[k] = true;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    golden_opts_t o;
+    if (!parse_args(argc, argv, &o)) {
+        usage();
+        return 2;
+    }
+
+    pid_t pids[GOLDEN_SCENARIOS];
+    int pipes[GOLDEN_SCENARIOS];
+    for (size_t k = 0; k < GOLDEN_SCENARIOS; k++) {
+        pids[k] = -1;
+        if (!o.selected[k]) {
+            continue;
+        }
+        int fds[2];
+        if (pipe(fds) != 0) {
+            perror("tripta_golden");
+            return 2;
+        }
+        fflush(stdout);
+        pids[k] = fork();
+        if (pids[k] < 0) {
+            perror("tripta_golden");
+            return 2;
+        }
+        if (pids[k] == 0) {
+            // El firmware imprime por stdout (p. ej. el PID en cada ciclo); el informe va por la tubería
+            close(fds[0]);
+            s_out = fdopen(fds[1], "w");
+            if (s_out == NULL || freopen("/dev/null", "w", stdout) == NULL) {
+                _exit(2);
+            }
+            const int rc = scenario_main(&o, &s_scenarios[k]);
+            fclose(s_out);
+            _exit(rc);
+        }
+        close(fds[1]);
+        pipes[k] = fds[0];
+    }
+
+    int failed = 0;
+    for (size_t k = 0; k < GOLDEN_SCENARIOS; k++) {
+        if (pids[k] < 0) {
+            continue;
+        }
+        char buf[GOLDEN_REPORT_MAX];
+        ssize_t n;
+        while ((n = read(pipes[k], buf, sizeof(buf))) > 0) {
+            fwrite(buf, 1, (size_t)n, stdout);
+        }
+        close(pipes[k]);
+        int status = 0;
+        if (waitpid(pids[k], &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            if (!WIFEXITED(status)) {
+                printf("FALLA: el escenario %s terminó con una señal\n", s_scenarios[k].name);
+            }
+            failed = 1;
+        }
+    }
+    printf("\n%s\n", failed ? "FALLA: alguna traza se apartó de su referencia" : "OK: todas las trazas dentro de tolerancia");
+    return failed;
+}
@@ -0,0 +1,169 @@
+/**
+ * @file esp_host.c
+ * @brief Registro, nombres de error, aborto, números aleatorios y frecuencia de la CPU de ESP-IDF en el host.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_cpu.h"
+#include "esp_random.h"
+#include "esp_private/esp_clk.h"
+#include "hal_clock.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static int s_level = -1;    ///< esp_log_level_t; -1 hasta leer TRIPTA_LOG
+
+static int stderr_vprintf(const char *format, va_list args)
+{
+    return vfprintf(stderr, format, args);
+}
+
+static vprintf_like_t s_vprintf = stderr_vprintf;
+
+static esp_log_level_t level_from_env(void)
+{
+    const char *env = getenv("TRIPTA_LOG");
+    if (env == NULL) {
+        return ESP_LOG_WARN;
+    }
+    switch (env[0]) {
+    case 'N': case 'n': return ESP_LOG_NONE;
+    case 'E': case 'e': return ESP_LOG_ERROR;
+    case 'I': case 'i': return ESP_LOG_INFO;
+    case 'D': case 'd': return ESP_LOG_DEBUG;
+    case 'V': case 'v': return ESP_LOG_VERBOSE;
+    default:            return ESP_LOG_WARN;
+    }
+}
+
+void esp_log_level_set(const char *tag, esp_log_level_t level)
+{
+    (void)tag;
+    s_level = level;
+}
+
+vprintf_like_t esp_log_set_vprintf(vprintf_like_t func)
+{
+    const vprintf_like_t prev = s_vprintf;
+    s_vprintf = func;
+    return prev;
+}
+
+static void emit(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    s_vprintf(format, args);
+    va_end(args);
+}
+
+void host_log_write(esp_log_level_t level, const char *tag, const char *format, ...)
+{
+    static const char letters[] = "NEWIDV";
+    if (s_level < 0) {
+        s_level = level_from_env();
+    }
+    if ((int)level > s_level) {
+        return;
+    }
+    char msg[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(msg, sizeof(msg), format, args);
+    va_end(args);
+    // Una sola llamada por línea, como ESP-IDF: la salida puede ser otra (esp_log_set_vprintf)
+    emit("%c (%lld) %s: %s\n", letters[level], (long long)(hal_clock_mono_us() / 1000), tag, msg);
+}
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+    case ESP_OK:                        return "ESP_OK";
+    case ESP_FAIL:                      return "ESP_FAIL";
+    case ESP_ERR_NO_MEM:                return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:           return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE:         return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE:          return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND:             return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NOT_SUPPORTED:         return "ESP_ERR_NOT_SUPPORTED";
+    case ESP_ERR_TIMEOUT:               return "ESP_ERR_TIMEOUT";
+    case ESP_ERR_INVALID_RESPONSE:      return "ESP_ERR_INVALID_RESPONSE";
+    case ESP_ERR_INVALID_CRC:           return "ESP_ERR_INVALID_CRC";
+    case ESP_ERR_INVALID_VERSION:       return "ESP_ERR_INVALID_VERSION";
+    case ESP_ERR_NOT_FINISHED:          return "ESP_ERR_NOT_FINISHED";
+    case ESP_ERR_NVS_NOT_INITIALIZED:   return "ESP_ERR_NVS_NOT_INITIALIZED";
+    case ESP_ERR_NVS_NOT_FOUND:         return "ESP_ERR_NVS_NOT_FOUND";
+    case ESP_ERR_NVS_TYPE_MISMATCH:     return "ESP_ERR_NVS_TYPE_MISMATCH";
+    case ESP_ERR_NVS_READ_ONLY:         return "ESP_ERR_NVS_READ_ONLY";
+    case ESP_ERR_NVS_NOT_ENOUGH_SPACE:  return "ESP_ERR_NVS_NOT_ENOUGH_SPACE";
+    case ESP_ERR_NVS_INVALID_NAME:      return "ESP_ERR_NVS_INVALID_NAME";
+    case ESP_ERR_NVS_INVALID_HANDLE:    return "ESP_ERR_NVS_INVALID_HANDLE";
+    case ESP_ERR_NVS_KEY_TOO_LONG:      return "ESP_ERR_NVS_KEY_TOO_LONG";
+    case ESP_ERR_NVS_INVALID_LENGTH:    return "ESP_ERR_NVS_INVALID_LENGTH";
+    case ESP_ERR_NVS_NO_FREE_PAGES:     return "ESP_ERR_NVS_NO_FREE_PAGES";
+    case ESP_ERR_NVS_NEW_VERSION_FOUND: return "ESP_ERR_NVS_NEW_VERSION_FOUND";
+    default:                            return "UNKNOWN ERROR";
+    }
+}
+
+void host_esp_error_check_failed(esp_err_t rc, const char *file, int line, const char *expr)
+{
+    fprintf(stderr, "ESP_ERROR_CHECK falló: %s (0x%x) en %s:%d\nexpresión: %s\n",
+            esp_err_to_name(rc), (unsigned)rc, file, line, expr);
+    abort();
+}
+
+void esp_system_abort(const char *details)
+{
+    fprintf(stderr, "esp_system_abort: %s\n", details);
+    abort();
+}
+
+uint32_t esp_random(void)
+{
+    // xorshift32 con semilla fija
+    static uint32_t s_state = 0x2545F491u;
+    s_state ^= s_state << 13;
+    s_state ^= s_state >> 17;
+    s_state ^= s_state << 5;
+    return s_state;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CLK_CALIBRATION_NS  20000000    ///< Ventana de la medición del TSC
+
+static int64_t wall_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+#endif
+
+int esp_clk_cpu_freq(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    // Espera activa: el reloj virtual no avanza y un sleep cedería la CPU del planificador
+    static int s_hz = 0;
+    if (s_hz == 0) {
+        const int64_t t0 = wall_ns();
+        const esp_cpu_cycle_count_t c0 = esp_cpu_get_cycle_count();
+        int64_t t1;
+        do {
+            t1 = wall_ns();
+        } while (t1 - t0 < CLK_CALIBRATION_NS);
+        const esp_cpu_cycle_count_t cycles = esp_cpu_get_cycle_count() - c0;
+        s_hz = (int)((double)cycles * 1e9 / (double)(t1 - t0));
+    }
+    return s_hz;
+#else
+    return 1000000000;
+#endif
+}
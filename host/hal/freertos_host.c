@@ -0,0 +1,841 @@
+/**
+ * @file freertos_host.c
+ * @brief FreeRTOS del host: objetos reales y esperas sobre el reloj virtual, con o sin planificador.
+ * @details Sin planificador (pruebas unitarias) las tareas se registran pero no se ejecutan, y
+ *          el código corre siempre en el contexto de la prueba (xTaskGetCurrentTaskHandle()
+ *          devuelve NULL). Una espera que no se puede cumplir adelanta el reloj el plazo pedido
+ *          y vence; si el plazo es portMAX_DELAY la prueba se detiene, porque en el equipo sería
+ *          un bloqueo eterno.
+ *
+ *          Con hal_host_kernel_run_until_us() (simulador) cada tarea corre en su propio hilo,
+ *          pero solo una tiene la CPU: la lista de mayor prioridad, y entre iguales la que llegó
+ *          primero. El código no consume tiempo virtual; el reloj avanza únicamente cuando todas
+ *          las tareas esperan, y salta directo al vencimiento más próximo. Despertar a una tarea
+ *          de más prioridad desaloja a la actual en el acto (o al salir de la sección crítica),
+ *          como el planificador con desalojo de FreeRTOS en un solo núcleo.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include "hal_host.h"
+#include "hal_clock.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define HOST_MAX_TASKS          32
+#define HOST_THREAD_STACK       (1024 * 1024)   ///< Pila de cada hilo (la del equipo no aplica)
+#define HOST_SPIN_LIMIT         1000000         ///< Cambios de contexto sin que avance el reloj
+
+enum {
+    TASK_READY = 0,
+    TASK_BLOCKED,
+    TASK_DELETED,
+};
+
+/**
+ * @brief Hilo de una tarea
+ */
+struct host_thread {
+    pthread_t id;
+    pthread_cond_t turn;        ///< Se señala cuando la tarea recibe la CPU
+};
+
+static pthread_mutex_t s_kernel = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_driver_turn = PTHREAD_COND_INITIALIZER;
+static struct host_task *s_tasks[HOST_MAX_TASKS];
+static struct host_task *s_current = NULL;      ///< Tarea con la CPU (NULL: el programa principal)
+static int64_t s_stop_us = 0;                   ///< Fin de la corrida en curso
+static int64_t s_seq = 0;                       ///< Llegadas a la lista de listas
+static int64_t s_front = 0;                     ///< Desalojadas: vuelven por delante de sus iguales
+static uint32_t s_rng = 0;                      ///< 0: sin desempate al azar
+static uint32_t s_critical = 0;                 ///< Anidamiento de secciones críticas de la tarea en curso
+static bool s_yield_pending = false;            ///< Desalojo diferido hasta salir de la sección crítica
+static uint64_t s_spin = 0;
+static hal_host_kernel_stats_t s_stats;
+static __thread struct host_task *t_self = NULL;
+
+/**
+ * @brief Espera `ticks` sin que nada pueda despertarla (fuera de una tarea)
+ */
+static void block(const char *what, TickType_t ticks)
+{
+    if (ticks == portMAX_DELAY) {
+        fprintf(stderr, "[freertos_host] %s sin plazo y sin otra tarea que lo despierte\n", what);
+        abort();
+    }
+    hal_host_clock_advance_us((int64_t)pdTICKS_TO_MS(ticks) * 1000);
+}
+
+// ───────────────────────────────────────────────────────
+// Planificador
+
+/**
+ * @brief Instante en que vence una espera de `ticks`, en el borde del tick como FreeRTOS
+ */
+static int64_t tick_deadline(TickType_t ticks)
+{
+    if (ticks == portMAX_DELAY) {
+        return -1;
+    }
+    const int64_t tick_us = (int64_t)portTICK_PERIOD_MS * 1000;
+    return (hal_clock_mono_us() / tick_us + ticks) * tick_us;
+}
+
+static void task_register(struct host_task *t)
+{
+    int free_slot = -1;
+    for (int i = 0; i < HOST_MAX_TASKS; i++) {
+        if (s_tasks[i] == t) {
+            return;
+        }
+        if (s_tasks[i] == NULL && free_slot < 0) {
+            free_slot = i;
+        }
+    }
+    if (free_slot < 0) {
+        fprintf(stderr, "[freertos_host] más de %d tareas\n", HOST_MAX_TASKS);
+        abort();
+    }
+    s_tasks[free_slot] = t;
+}
+
+static void task_unregister(struct host_task *t)
+{
+    for (int i = 0; i < HOST_MAX_TASKS; i++) {
+        if (s_tasks[i] == t) {
+            s_tasks[i] = NULL;
+        }
+    }
+}
+
+static void make_ready_locked(struct host_task *t)
+{
+    t->state = TASK_READY;
+    t->wait_obj = NULL;
+    t->wake_us = -1;
+    t->seq = ++s_seq;
+}
+
+static uint32_t rng_next(void)
+{
+    // xorshift32: determinista para una misma semilla
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+/**
+ * @brief Prioridad más alta entre las listas, o -1 si no hay ninguna
+ */
+static int top_ready_priority_locked(const struct host_task *except)
+{
+    int top = -1;
+    for (int i = 0; i < HOST_MAX_TASKS; i++) {
+        const struct host_task *t = s_tasks[i];
+        if (t != NULL && t != except && t->state == TASK_READY && (int)t->priority > top) {
+            top = (int)t->priority;
+        }
+    }
+    return top;
+}
+
+static void check_deadlock_locked(void)
+{
+    bool found = false;
+    for (int i = 0; i < HOST_MAX_TASKS; i++) {
+        const struct host_task *t = s_tasks[i];
+        if (t == NULL || t->state != TASK_BLOCKED || t->wake_us >= 0 || t->wait_obj == NULL ||
+            t->wait_obj == (const void *)t) {
+            continue;
+        }
+        const struct host_queue *q = t->wait_obj;
+        if (q->mutex && q->holder != NULL) {
+            fprintf(stderr, "[freertos_host] bloqueo mutuo: %s espera sin plazo un mutex que tiene %s\n",
+                    t->name, q->holder->name);
+            found = true;
+        }
+    }
+    if (found) {
+        s_stats.deadlocks++;
+    }
+}
+
+/**
+ * @brief Próxima tarea a ejecutar; si no hay ninguna lista, adelanta el reloj
+ * @return La tarea, o NULL si la próxima espera vence después del fin de la corrida
+ */
+static struct host_task *pick_next_locked(void)
+{
+    for (;;) {
+        const int top = top_ready_priority_locked(NULL);
+        if (top >= 0) {
+            struct host_task *candidates[HOST_MAX_TASKS];
+            size_t n = 0;
+            for (int i = 0; i < HOST_MAX_TASKS; i++) {
+                struct host_task *t = s_tasks[i];
+                if (t != NULL && t->state == TASK_READY && (int)t->priority == top) {
+                    candidates[n++] = t;
+                }
+            }
+            struct host_task *best = candidates[0];
+            if (s_rng != 0 && n > 1) {
+                best = candidates[rng_next() % n];
+            } else {
+                for (size_t i = 1; i < n; i++) {
+                    if (candidates[i]->seq < best->seq) {
+                        best = candidates[i];
+                    }
+                }
+            }
+            return best;
+        }
+
+        // Todas esperan: el reloj salta al vencimiento más próximo
+        int64_t next = -1;
+        for (int i = 0; i < HOST_MAX_TASKS; i++) {
+            const struct host_task *t = s_tasks[i];
+            if (t != NULL && t->state == TASK_BLOCKED && t->wake_us >= 0 && (next < 0 || t->wake_us < next)) {
+                next = t->wake_us;
+            }
+        }
+        const int64_t now = hal_clock_mono_us();
+        if (next < 0 || next > s_stop_us) {
+            if (next < 0) {
+                check_deadlock_locked();
+            }
+            if (s_stop_us > now) {
+                hal_host_clock_advance_us(s_stop_us - now);
+            }
+            return NULL;
+        }
+        if (next > now) {
+            hal_host_clock_advance_us(next - now);
+            s_stats.clock_jumps++;
+        }
+        s_spin = 0;
+        for (int i = 0; i < HOST_MAX_TASKS; i++) {
+            struct host_task *t = s_tasks[i];
+            if (t != NULL && t->state == TASK_BLOCKED && t->wake_us >= 0 && t->wake_us <= next) {
+                make_ready_locked(t);
+                t->timed_out = true;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Reloj real, para el tiempo de CPU de cada tarea (el reloj virtual no avanza con el código)
+ */
+static int64_t real_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void wait_turn_locked(struct host_task *self)
+{
+    pthread_cond_t *turn = self != NULL ? &self->thread->turn : &s_driver_turn;
+    while (s_current != self) {
+        pthread_cond_wait(turn, &s_kernel);
+    }
+    if (self != NULL) {
+        self->resumed_ns = real_ns();   // Sin la demora del sistema operativo en despertar el hilo
+    }
+}
+
+static void *task_thread(void *arg)
+{
+    struct host_task *t = arg;
+    t_self = t;
+    pthread_mutex_lock(&s_kernel);
+    wait_turn_locked(t);
+    pthread_mutex_unlock(&s_kernel);
+
+    t->fn(t->arg);
+    fprintf(stderr, "[freertos_host] la tarea %s volvió de su función sin vTaskDelete()\n", t->name);
+    abort();
+}
+
+/**
+ * @brief Da la CPU a `next` (NULL: al programa principal)
+ */
+static void hand_over_locked(struct host_task *next)
+{
+    if (++s_spin > HOST_SPIN_LIMIT) {
+        fprintf(stderr, "[freertos_host] %d cambios de contexto sin que avance el reloj (¿espera activa?)\n",
+                HOST_SPIN_LIMIT);
+        abort();
+    }
+    s_stats.switches++;
+    if (s_current != NULL) {
+        s_current->cpu_ns += real_ns() - s_current->resumed_ns;
+    }
+    s_current = next;
+    if (next == NULL) {
+        pthread_cond_signal(&s_driver_turn);
+        return;
+    }
+    next->dispatches++;
+    if (next->thread != NULL) {
+        pthread_cond_signal(&next->thread->turn);
+        return;
+    }
+    next->thread = calloc(1, sizeof(*next->thread));
+    pthread_attr_t attr;
+    if (next->thread == NULL || pthread_attr_init(&attr) != 0) {
+        fprintf(stderr, "[freertos_host] sin memoria para el hilo de %s\n", next->name);
+        abort();
+    }
+    pthread_cond_init(&next->thread->turn, NULL);
+    pthread_attr_setstacksize(&attr, HOST_THREAD_STACK);
+    if (pthread_create(&next->thread->id, &attr, task_thread, next) != 0) {
+        fprintf(stderr, "[freertos_host] no se pudo crear el hilo de %s\n", next->name);
+        abort();
+    }
+    pthread_attr_destroy(&attr);
+}
+
+/**
+ * @brief Entrega la CPU a `next` y vuelve cuando `self` la recupera
+ */
+static void switch_locked(struct host_task *self, struct host_task *next)
+{
+    if (next != self) {
+        hand_over_locked(next);
+    }
+    wait_turn_locked(self);
+}
+
+/**
+ * @brief Bloquea la tarea en curso sobre `obj` hasta que la despierten o venza `wake_us`
+ * @return true si la despertaron, false si venció
+ */
+static bool wait_locked(struct host_task *self, const void *obj, int64_t wake_us)
+{
+    if (s_critical > 0) {
+        fprintf(stderr, "[freertos_host] %s espera dentro de una sección crítica\n", self->name);
+        abort();
+    }
+    self->state = TASK_BLOCKED;
+    self->wait_obj = obj;
+    self->wake_us = wake_us;
+    self->blocked_us = hal_clock_mono_us();
+    self->timed_out = false;
+    self->waits++;
+    switch_locked(self, pick_next_locked());
+    if (self->timed_out) {
+        self->timeouts++;
+    }
+    return !self->timed_out;
+}
+
+/**
+ * @brief Despierta a la tarea de más prioridad (y más antigua) que espera `obj`
+ */
+static bool wake_one_locked(const void *obj)
+{
+    struct host_task *best = NULL;
+    for (int i = 0; i < HOST_MAX_TASKS; i++) {
+        struct host_task *t = s_tasks[i];
+        if (t == NULL || t->state != TASK_BLOCKED || t->wait_obj != obj) {
+            continue;
+        }
+        if (best == NULL || t->priority > best->priority ||
+            (t->priority == best->priority && t->blocked_us < best->blocked_us)) {
+            best = t;
+        }
+    }
+    if (best != NULL) {
+        make_ready_locked(best);
+    }
+    return best != NULL;
+}
+
+static void yield_locked(void)
+{
+    struct host_task *self = t_self;
+    s_yield_pending = false;
+    struct host_task *next = pick_next_locked();
+    if (next != self) {
+        self->preemptions++;
+        s_stats.preemptions++;
+        self->seq = --s_front;
+        switch_locked(self, next);
+    }
+}
+
+/**
+ * @brief Desaloja a la tarea en curso si hay una lista de más prioridad
+ */
+static void preempt_locked(void)
+{
+    struct host_task *self = t_self;
+    if (self == NULL || top_ready_priority_locked(self) <= (int)self->priority) {
+        return;
+    }
+    if (s_critical > 0) {
+        s_yield_pending = true;
+        return;
+    }
+    yield_locked();
+}
+
+bool host_task_sleep_us(int64_t us)
+{
+    struct host_task *self = t_self;
+    if (self == NULL) {
+        return false;
+    }
+    if (us > 0) {
+        pthread_mutex_lock(&s_kernel);
+        wait_locked(self, NULL, hal_clock_mono_us() + us);
+        pthread_mutex_unlock(&s_kernel);
+    }
+    return true;
+}
+
+void hal_host_kernel_seed(uint32_t seed)
+{
+    s_rng = seed;
+}
+
+esp_err_t hal_host_kernel_run_until_us(int64_t until_us)
+{
+    if (t_self != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    pthread_mutex_lock(&s_kernel);
+    s_stop_us = until_us;
+    s_spin = 0;
+    switch_locked(NULL, pick_next_locked());
+    pthread_mutex_unlock(&s_kernel);
+    return ESP_OK;
+}
+
+void hal_host_kernel_get_stats(hal_host_kernel_stats_t *out)
+{
+    pthread_mutex_lock(&s_kernel);
+    *out = s_stats;
+    out->tasks = uxTaskGetNumberOfTasks();
+    pthread_mutex_unlock(&s_kernel);
+}
+
+size_t hal_host_kernel_get_task_stats(hal_host_task_stats_t *out, size_t max)
+{
+    size_t n = 0;
+    pthread_mutex_lock(&s_kernel);
+    for (int i = 0; i < HOST_MAX_TASKS && n < max; i++) {
+        const struct host_task *t = s_tasks[i];
+        if (t == NULL) {
+            continue;
+        }
+        hal_host_task_stats_t *o = &out[n++];
+        snprintf(o->name, sizeof(o->name), "%s", t->name);
+        o->priority = t->priority;
+        o->dispatches = t->dispatches;
+        o->preemptions = t->preemptions;
+        o->waits = t->waits;
+        o->timeouts = t->timeouts;
+        o->mutex_wait_max_us = t->mutex_wait_max_us;
+        o->cpu_ns = t->cpu_ns;
+    }
+    pthread_mutex_unlock(&s_kernel);
+    return n;
+}
+
+// ───────────────────────────────────────────────────────
+// Secciones críticas
+
+void host_port_enter_critical(portMUX_TYPE *mux)
+{
+    mux->count++;
+    if (t_self != NULL) {
+        s_critical++;
+    }
+}
+
+void host_port_exit_critical(portMUX_TYPE *mux)
+{
+    if (mux->count > 0) {
+        mux->count--;
+    }
+    if (t_self != NULL && s_critical > 0 && --s_critical == 0 && s_yield_pending) {
+        pthread_mutex_lock(&s_kernel);
+        yield_locked();
+        pthread_mutex_unlock(&s_kernel);
+    }
+}
+
+// ───────────────────────────────────────────────────────
+// Tareas
+
+static void task_setup(struct host_task *t, TaskFunction_t fn, const char *name, uint32_t stack_depth,
+                       void *arg, UBaseType_t priority, bool dynamic)
+{
+    memset(t, 0, sizeof(*t));
+    snprintf(t->name, sizeof(t->name), "%s", name ? name : "");
+    t->fn = fn;
+    t->arg = arg;
+    t->priority = priority;
+    t->stack_depth = stack_depth;
+    t->dynamic = dynamic;
+
+    pthread_mutex_lock(&s_kernel);
+    make_ready_locked(t);
+    task_register(t);
+    preempt_locked();
+    pthread_mutex_unlock(&s_kernel);
+}
+
+TaskHandle_t xTaskCreateStatic(TaskFunction_t fn, const char *name, uint32_t stack_depth, void *arg,
+                               UBaseType_t priority, StackType_t *stack, StaticTask_t *tcb)
+{
+    (void)stack;
+    if (fn == NULL || tcb == NULL) {
+        return NULL;
+    }
+    task_setup(tcb, fn, name, stack_depth, arg, priority, false);
+    return tcb;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_depth, void *arg,
+                       UBaseType_t priority, TaskHandle_t *out)
+{
+    struct host_task *t = malloc(sizeof(*t));
+    if (fn == NULL || t == NULL) {
+        free(t);
+        return pdFAIL;
+    }
+    if (out != NULL) {
+        *out = t;       // Antes de que la tarea pueda correr, como en FreeRTOS
+    }
+    task_setup(t, fn, name, stack_depth, arg, priority, true);
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    if (task == NULL) {
+        task = t_self;
+    }
+    if (task == NULL) {
+        fprintf(stderr, "[freertos_host] vTaskDelete(NULL) fuera de una tarea\n");
+        abort();
+    }
+    pthread_mutex_lock(&s_kernel);
+    task->deleted = true;
+    task->state = TASK_DELETED;
+    task_unregister(task);
+    if (task == t_self) {
+        // El TCB y el hilo no se liberan: el hilo termina aquí mismo
+        hand_over_locked(pick_next_locked());
+        pthread_mutex_unlock(&s_kernel);
+        pthread_exit(NULL);
+    }
+    pthread_mutex_unlock(&s_kernel);
+    // Una tarea con hilo queda detenida en su espera para siempre; su TCB no se libera
+    if (task->dynamic && task->thread == NULL) {
+        free(task);
+    }
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    struct host_task *self = t_self;
+    if (self == NULL) {
+        block("vTaskDelay", ticks);
+        return;
+    }
+    pthread_mutex_lock(&s_kernel);
+    if (ticks > 0) {
+        wait_locked(self, NULL, tick_deadline(ticks));
+    } else {
+        // Cede la CPU a las de igual prioridad
+        self->seq = ++s_seq;
+        switch_locked(self, pick_next_locked());
+    }
+    pthread_mutex_unlock(&s_kernel);
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)pdMS_TO_TICKS(hal_clock_mono_us() / 1000);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return t_self;
+}
+
+char *pcTaskGetName(TaskHandle_t task)
+{
+    static char main_name[] = "main";
+    if (task == NULL) {
+        task = t_self;
+    }
+    return task != NULL ? task->name : main_name;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks)
+{
+    struct host_task *self = t_self;
+    if (self == NULL) {
+        // Sin tarea en curso no hay a quién notificar: solo puede vencer
+        block("ulTaskNotifyTake", ticks);
+        return 0;
+    }
+    pthread_mutex_lock(&s_kernel);
+    if (self->notify == 0 && ticks > 0) {
+        wait_locked(self, self, tick_deadline(ticks));
+    }
+    const uint32_t value = self->notify;
+    if (value > 0) {
+        self->notify = clear_on_exit ? 0 : value - 1;
+    }
+    pthread_mutex_unlock(&s_kernel);
+    return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    if (task == NULL) {
+        return pdPASS;
+    }
+    pthread_mutex_lock(&s_kernel);
+    task->notify++;
+    if (task->state == TASK_BLOCKED && task->wait_obj == (const void *)task) {
+        make_ready_locked(task);
+        preempt_locked();
+    }
+    pthread_mutex_unlock(&s_kernel);
+    return pdPASS;
+}
+
+UBaseType_t uxTaskGetNumberOfTasks(void)
+{
+    UBaseType_t n = 0;
+    for (int i = 0; i < HOST_MAX_TASKS; i++) {
+        n += s_tasks[i] != NULL;
+    }
+    return n;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task)
+{
+    if (task == NULL) {
+        task = t_self;
+    }
+    return task != NULL ? task->stack_depth : 0;
+}
+
+// ───────────────────────────────────────────────────────
+// Colas y semáforos
+
+static QueueHandle_t queue_setup(struct host_queue *q, UBaseType_t length, UBaseType_t item_size,
+                                 uint8_t *storage)
+{
+    memset(q, 0, sizeof(*q));
+    q->storage = storage;
+    q->length = length;
+    q->item_size = item_size;
+    return q;
+}
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t item_size, uint8_t *storage,
+                                 StaticQueue_t *buffer)
+{
+    if (buffer == NULL || length == 0 || (item_size > 0 && storage == NULL)) {
+        return NULL;
+    }
+    return queue_setup(buffer, length, item_size, storage);
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    struct host_queue *q = malloc(sizeof(*q));
+    uint8_t *storage = item_size > 0 ? malloc((size_t)length * item_size) : NULL;
+    if (q == NULL || length == 0 || (item_size > 0 && storage == NULL)) {
+        free(q);
+        free(storage);
+        return NULL;
+    }
+    queue_setup(q, length, item_size, storage);
+    q->dynamic = true;
+    return q;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    if (queue != NULL && queue->dynamic) {
+        free(queue->storage);
+        free(queue);
+    }
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks)
+{
+    struct host_task *self = t_self;
+    pthread_mutex_lock(&s_kernel);
+    const int64_t wake_us = tick_deadline(ticks);
+    while (queue->count == queue->length) {
+        if (self == NULL || ticks == 0 || !wait_locked(self, queue, wake_us)) {
+            pthread_mutex_unlock(&s_kernel);
+            if (self == NULL) {
+                block("xQueueSend con la cola llena", ticks);
+            }
+            return errQUEUE_FULL;
+        }
+    }
+    if (queue->item_size > 0) {
+        const UBaseType_t tail = (queue->head + queue->count) % queue->length;
+        memcpy(queue->storage + (size_t)tail * queue->item_size, item, queue->item_size);
+    }
+    queue->count++;
+    queue->holder = NULL;
+    if (wake_one_locked(queue)) {
+        preempt_locked();
+    }
+    pthread_mutex_unlock(&s_kernel);
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks)
+{
+    struct host_task *self = t_self;
+    pthread_mutex_lock(&s_kernel);
+    const int64_t start_us = hal_clock_mono_us();
+    const int64_t wake_us = tick_deadline(ticks);
+    while (queue->count == 0) {
+        if (self == NULL || ticks == 0 || !wait_locked(self, queue, wake_us)) {
+            pthread_mutex_unlock(&s_kernel);
+            if (self == NULL) {
+                block("xQueueReceive con la cola vacía", ticks);
+            }
+            return errQUEUE_EMPTY;
+        }
+    }
+    if (queue->item_size > 0) {
+        memcpy(item, queue->storage + (size_t)queue->head * queue->item_size, queue->item_size);
+    }
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    if (queue->mutex) {
+        queue->holder = self;
+        const uint32_t waited = (uint32_t)(hal_clock_mono_us() - start_us);
+        if (self != NULL && waited > self->mutex_wait_max_us) {
+            self->mutex_wait_max_us = waited;
+        }
+    }
+    if (wake_one_locked(queue)) {
+        preempt_locked();
+    }
+    pthread_mutex_unlock(&s_kernel);
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    return queue->count;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t *buffer)
+{
+    SemaphoreHandle_t sem = xQueueCreateStatic(1, 0, NULL, buffer);
+    if (sem != NULL) {
+        sem->count = 1;
+        sem->mutex = true;
+    }
+    return sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t *buffer)
+{
+    return xQueueCreateStatic(1, 0, NULL, buffer);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    SemaphoreHandle_t sem = xQueueCreate(1, 0);
+    if (sem != NULL) {
+        sem->count = 1;
+        sem->mutex = true;
+    }
+    return sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return xQueueCreate(1, 0);
+}
+
+// ───────────────────────────────────────────────────────
+// Grupos de eventos
+
+EventGroupHandle_t xEventGroupCreateStatic(StaticEventGroup_t *buffer)
+{
+    if (buffer != NULL) {
+        buffer->bits = 0;
+    }
+    return buffer;
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits)
+{
+    pthread_mutex_lock(&s_kernel);
+    group->bits |= bits;
+    // Todas las que esperan vuelven a comprobar sus bits
+    bool woken = false;
+    while (wake_one_locked(group)) {
+        woken = true;
+    }
+    const EventBits_t now = group->bits;
+    if (woken) {
+        preempt_locked();
+    }
+    pthread_mutex_unlock(&s_kernel);
+    return now;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits)
+{
+    pthread_mutex_lock(&s_kernel);
+    const EventBits_t before = group->bits;
+    group->bits &= ~bits;
+    pthread_mutex_unlock(&s_kernel);
+    return before;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clear_on_exit,
+                                BaseType_t wait_all, TickType_t ticks)
+{
+    struct host_task *self = t_self;
+    pthread_mutex_lock(&s_kernel);
+    const int64_t wake_us = tick_deadline(ticks);
+    while (wait_all ? (group->bits & bits) != bits : (group->bits & bits) == 0) {
+        if (self == NULL || ticks == 0 || !wait_locked(self, group, wake_us)) {
+            const EventBits_t now = group->bits;
+            pthread_mutex_unlock(&s_kernel);
+            if (self == NULL) {
+                block("xEventGroupWaitBits sin los bits pedidos", ticks);
+            }
+            return now;
+        }
+    }
+    const EventBits_t now = group->bits;
+    if (clear_on_exit) {
+        group->bits &= ~bits;
+    }
+    pthread_mutex_unlock(&s_kernel);
+    return now;
+}
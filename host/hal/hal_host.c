@@ -0,0 +1,70 @@
+/**
+ * @file hal_host.c
+ * @brief Reloj virtual del host y reinicio del estado de la HAL.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#include "hal_host.h"
+#include "hal_clock.h"
+#include "freertos/FreeRTOS.h"
+
+static int64_t s_now_us = 0;
+static int64_t s_wall_base_s = 0;       ///< Hora de pared fijada (0 = nunca)
+static int64_t s_wall_base_us = 0;      ///< Instante monotónico en que se fijó
+
+int64_t hal_clock_mono_us(void)
+{
+    return s_now_us;
+}
+
+int64_t hal_clock_wall_s(void)
+{
+    if (s_wall_base_s == 0) {
+        return 0;
+    }
+    return s_wall_base_s + (s_now_us - s_wall_base_us) / 1000000;
+}
+
+esp_err_t hal_clock_set_wall_s(int64_t utc_s)
+{
+    hal_host_set_wall_s(utc_s);
+    return ESP_OK;
+}
+
+void hal_host_clock_set_us(int64_t now_us)
+{
+    s_now_us = now_us;
+}
+
+void hal_host_clock_advance_us(int64_t us)
+{
+    if (us > 0) {
+        s_now_us += us;
+    }
+}
+
+void hal_host_sleep_us(int64_t us)
+{
+    // En una tarea el reloj lo mueve el planificador, cuando no queda nadie listo
+    if (!host_task_sleep_us(us)) {
+        hal_host_clock_advance_us(us);
+    }
+}
+
+void hal_host_set_wall_s(int64_t utc_s)
+{
+    s_wall_base_s = utc_s;
+    s_wall_base_us = s_now_us;
+}
+
+void hal_host_reset(void)
+{
+    s_now_us = 0;
+    s_wall_base_s = 0;
+    s_wall_base_us = 0;
+    hal_host_nvs_reset();
+    hal_host_uart_reset();
+    hal_host_i2c_reset();
+}
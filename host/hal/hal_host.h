@@ -0,0 +1,223 @@
+/**
+ * @file hal_host.h
+ * @brief Control de las implementaciones de host de la HAL (pruebas, modelos y simulador).
+ * @details - Reloj: virtual, en µs. Solo avanza cuando el firmware espera (vTaskDelay, colas,
+ *            lecturas de UART) o cuando la prueba lo adelanta; así una prueba es determinista
+ *            y no tarda lo que tardaría en el equipo.
+ *          - NVS: tabla en RAM por espacio de nombres con fallas programables y corte de
+ *            energía (se pierden las escrituras sin confirmar).
+ *          - UART: cada puerto es un tubo; lo que escribe el firmware se entrega a un modelo de
+ *            dispositivo, que responde dejando bytes en la recepción.
+ *          - I2C: las transacciones de i2c_bus.h se resuelven contra modelos por dirección.
+ *          - Planificador: con hal_host_kernel_run_until_us() las tareas de FreeRTOS corren de
+ *            verdad (una por vez, por prioridad) y el reloj salta de espera en espera.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#ifndef HAL_HOST_H
+#define HAL_HOST_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ───────────────────────────────────────────────────────
+// Reloj
+
+/**
+ * @brief Fija el reloj monotónico
+ */
+void hal_host_clock_set_us(int64_t now_us);
+
+/**
+ * @brief Adelanta el reloj monotónico (y la hora de pared con él)
+ */
+void hal_host_clock_advance_us(int64_t us);
+
+/**
+ * @brief Espera del firmware: en el host adelanta el reloj virtual
+ */
+void hal_host_sleep_us(int64_t us);
+
+/**
+ * @brief Fija la hora de pared (0 = nunca fijada)
+ */
+void hal_host_set_wall_s(int64_t utc_s);
+
+// ───────────────────────────────────────────────────────
+// NVS
+
+/**
+ * @brief Operaciones de NVS (para contar y para inyectar fallas)
+ */
+typedef enum {
+    HAL_HOST_NVS_INIT = 0,
+    HAL_HOST_NVS_OPEN,
+    HAL_HOST_NVS_GET,
+    HAL_HOST_NVS_SET,
+    HAL_HOST_NVS_ERASE,
+    HAL_HOST_NVS_COMMIT,
+    HAL_HOST_NVS_OP_COUNT
+} hal_host_nvs_op_t;
+
+/**
+ * @brief Contadores de la NVS en RAM
+ */
+typedef struct {
+    uint32_t ops[HAL_HOST_NVS_OP_COUNT];    ///< Llamadas por operación (incluye las fallidas)
+    uint32_t injected;                      ///< Fallas inyectadas
+    uint32_t entries;                       ///< Claves guardadas
+    uint32_t uncommitted;                   ///< Claves escritas sin confirmar
+} hal_host_nvs_stats_t;
+
+/**
+ * @brief Borra todas las claves, las fallas programadas y los contadores
+ */
+void hal_host_nvs_reset(void);
+
+/**
+ * @brief Programa fallas de una operación
+ * @param op    Operación
+ * @param err   Error que devuelve
+ * @param skip  Llamadas que todavía funcionan antes de la primera falla
+ * @param count Llamadas que fallan (UINT32_MAX: todas desde ahí)
+ */
+void hal_host_nvs_fail(hal_host_nvs_op_t op, esp_err_t err, uint32_t skip, uint32_t count);
+
+/**
+ * @brief Corte de energía: descarta lo escrito sin confirmar e invalida los handles abiertos
+ */
+void hal_host_nvs_power_cut(void);
+
+/**
+ * @brief Copia los contadores
+ */
+void hal_host_nvs_get_stats(hal_host_nvs_stats_t *out);
+
+// ───────────────────────────────────────────────────────
+// UART
+
+/**
+ * @brief Modelo de dispositivo: recibe lo que escribe el firmware
+ * @details Responde con hal_host_uart_inject() desde la propia llamada.
+ */
+typedef void (*hal_host_uart_device_fn_t)(int port, const uint8_t *data, size_t len, void *ctx);
+
+/**
+ * @brief Conecta un modelo a un puerto (NULL lo desconecta)
+ */
+void hal_host_uart_attach(int port, hal_host_uart_device_fn_t fn, void *ctx);
+
+/**
+ * @brief Deja bytes en la recepción del puerto
+ * @details Se pueden leer cuando terminan de llegar: tras lo escrito pendiente y su propio
+ *          tiempo en la línea.
+ * @return Bytes aceptados (el resto se pierde, como con el búfer del driver lleno)
+ */
+size_t hal_host_uart_inject(int port, const uint8_t *data, size_t len);
+
+/**
+ * @brief Vacía los puertos y desconecta los modelos
+ */
+void hal_host_uart_reset(void);
+
+// ───────────────────────────────────────────────────────
+// I2C
+
+/**
+ * @brief Modelo de dispositivo I2C: escribe `tx` y luego lee `rx` (cualquiera puede ser vacío)
+ * @return ESP_OK, o el error que vería el firmware (p. ej. ESP_FAIL por NACK)
+ */
+typedef esp_err_t (*hal_host_i2c_device_fn_t)(uint16_t addr, const uint8_t *tx, size_t tx_len,
+                                              uint8_t *rx, size_t rx_len, void *ctx);
+
+/**
+ * @brief Conecta un modelo a una dirección de 7 bits
+ * @return ESP_OK o ESP_ERR_NO_MEM si no quedan entradas
+ */
+esp_err_t hal_host_i2c_attach(uint16_t addr, hal_host_i2c_device_fn_t fn, void *ctx);
+
+/**
+ * @brief Hace fallar las próximas `count` transacciones con una dirección
+ */
+void hal_host_i2c_fail(uint16_t addr, esp_err_t err, uint32_t count);
+
+/**
+ * @brief Desconecta los modelos y borra fallas y contadores
+ */
+void hal_host_i2c_reset(void);
+
+// ───────────────────────────────────────────────────────
+// Planificador
+
+/**
+ * @brief Contadores de una tarea
+ */
+typedef struct {
+    char name[16];
+    uint32_t priority;
+    uint32_t dispatches;        ///< Veces que recibió la CPU
+    uint32_t preemptions;       ///< Veces que la desalojó otra de más prioridad
+    uint32_t waits;             ///< Esperas que llegaron a bloquearla
+    uint32_t timeouts;          ///< Esperas que vencieron
+    uint32_t mutex_wait_max_us; ///< Espera más larga por un mutex
+    uint64_t cpu_ns;            ///< Tiempo real con la CPU: lo que cuesta su código en el PC
+} hal_host_task_stats_t;
+
+/**
+ * @brief Contadores del planificador
+ */
+typedef struct {
+    uint64_t switches;          ///< Cambios de contexto
+    uint64_t preemptions;       ///< Desalojos por una tarea de más prioridad
+    uint64_t clock_jumps;       ///< Saltos del reloj (todas las tareas esperando)
+    uint32_t tasks;             ///< Tareas vivas
+    uint32_t deadlocks;         ///< Veces que quedaron tareas esperando para siempre un mutex tomado
+} hal_host_kernel_stats_t;
+
+/**
+ * @brief Semilla para desempatar tareas listas de igual prioridad
+ * @details 0 (por defecto) las toma en orden de llegada, como FreeRTOS; otra semilla elige
+ *          al azar entre ellas, para recorrer otros entrelazados en busca de carreras.
+ */
+void hal_host_kernel_seed(uint32_t seed);
+
+/**
+ * @brief Ejecuta las tareas hasta que el reloj llegue a `until_us`
+ * @details Solo desde fuera de las tareas (el programa principal). Las tareas quedan
+ *          detenidas en su próxima espera; entre dos llamadas el programa puede leer estado y
+ *          usar llamadas que no bloqueen.
+ * @return ESP_OK, o ESP_ERR_INVALID_STATE si la llama una tarea
+ */
+esp_err_t hal_host_kernel_run_until_us(int64_t until_us);
+
+/**
+ * @brief Copia los contadores del planificador
+ */
+void hal_host_kernel_get_stats(hal_host_kernel_stats_t *out);
+
+/**
+ * @brief Copia los contadores de hasta `max` tareas vivas
+ * @return Tareas copiadas
+ */
+size_t hal_host_kernel_get_task_stats(hal_host_task_stats_t *out, size_t max);
+
+// ───────────────────────────────────────────────────────
+
+/**
+ * @brief Vuelve todo al estado inicial (reloj en 0, NVS vacía, sin modelos conectados)
+ */
+void hal_host_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HAL_HOST_H
@@ -0,0 +1,439 @@
+/**
+ * @file hal_nvs_host.c
+ * @brief NVS en RAM con fallas programables y corte de energía.
+ * @details Lo escrito se ve de inmediato (como en ESP-IDF), pero hasta hal_nvs_commit() se
+ *          guarda también el último valor confirmado: hal_host_nvs_power_cut() vuelve a él.
+ *          Los límites de nombres (15 caracteres) y los errores son los de ESP-IDF.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#include "hal_nvs.h"
+#include "hal_host.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define NVS_MAX_ENTRIES     64
+#define NVS_MAX_HANDLES     16
+#define NVS_MAX_NAMESPACES  16
+#define NVS_NAME_MAX        15
+
+typedef enum {
+    NVS_TYPE_BLOB = 0,
+    NVS_TYPE_I64,
+} nvs_type_t;
+
+/**
+ * @brief Clave guardada: valor vigente y último valor confirmado
+ */
+typedef struct {
+    bool used;
+    char ns[NVS_NAME_MAX + 1];
+    char key[NVS_NAME_MAX + 1];
+    nvs_type_t type;
+    bool present;               ///< El valor vigente existe (false: borrado sin confirmar)
+    uint8_t *data;
+    size_t len;
+    bool dirty;                 ///< Cambió desde el último commit
+    bool saved_present;
+    nvs_type_t saved_type;
+    uint8_t *saved;
+    size_t saved_len;
+} nvs_entry_t;
+
+typedef struct {
+    bool open;
+    char ns[NVS_NAME_MAX + 1];
+    hal_nvs_mode_t mode;
+} nvs_open_t;
+
+typedef struct {
+    esp_err_t err;
+    uint32_t skip;
+    uint32_t count;
+} nvs_fault_t;
+
+static bool s_initialized = false;
+static nvs_entry_t s_entries[NVS_MAX_ENTRIES];
+static nvs_open_t s_handles[NVS_MAX_HANDLES];
+static char s_namespaces[NVS_MAX_NAMESPACES][NVS_NAME_MAX + 1];
+static nvs_fault_t s_faults[HAL_HOST_NVS_OP_COUNT];
+static hal_host_nvs_stats_t s_stats;
+
+static esp_err_t inject(hal_host_nvs_op_t op)
+{
+    s_stats.ops[op]++;
+    nvs_fault_t *f = &s_faults[op];
+    if (f->count == 0) {
+        return ESP_OK;
+    }
+    if (f->skip > 0) {
+        f->skip--;
+        return ESP_OK;
+    }
+    if (f->count != UINT32_MAX) {
+        f->count--;
+    }
+    s_stats.injected++;
+    return f->err;
+}
+
+static bool valid_name(const char *name)
+{
+    return name != NULL && name[0] != '\0' && strlen(name) <= NVS_NAME_MAX;
+}
+
+static nvs_open_t *get_handle(hal_nvs_handle_t handle)
+{
+    if (handle == 0 || handle > NVS_MAX_HANDLES || !s_handles[handle - 1].open) {
+        return NULL;
+    }
+    return &s_handles[handle - 1];
+}
+
+static bool namespace_exists(const char *ns)
+{
+    for (int i = 0; i < NVS_MAX_NAMESPACES; i++) {
+        if (strcmp(s_namespaces[i], ns) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static esp_err_t namespace_create(const char *ns)
+{
+    if (namespace_exists(ns)) {
+        return ESP_OK;
+    }
+    for (int i = 0; i < NVS_MAX_NAMESPACES; i++) {
+        if (s_namespaces[i][0] == '\0') {
+            strcpy(s_namespaces[i], ns);
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+}
+
+static nvs_entry_t *find(const char *ns, const char *key)
+{
+    for (int i = 0; i < NVS_MAX_ENTRIES; i++) {
+        nvs_entry_t *e = &s_entries[i];
+        if (e->used && strcmp(e->ns, ns) == 0 && strcmp(e->key, key) == 0) {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+static void free_entry(nvs_entry_t *e)
+{
+    free(e->data);
+    free(e->saved);
+    memset(e, 0, sizeof(*e));
+}
+
+/**
+ * @brief Guarda el valor confirmado antes del primer cambio desde el último commit
+ */
+static void mark_dirty(nvs_entry_t *e)
+{
+    if (e->dirty) {
+        return;
+    }
+    e->dirty = true;
+    e->saved_present = e->present;
+    e->saved_type = e->type;
+    e->saved_len = e->len;
+    e->saved = NULL;
+    if (e->present && e->len > 0) {
+        e->saved = malloc(e->len);
+        memcpy(e->saved, e->data, e->len);
+    }
+}
+
+static esp_err_t write_value(hal_nvs_handle_t handle, const char *key, nvs_type_t type,
+                             const void *value, size_t len)
+{
+    esp_err_t err = inject(HAL_HOST_NVS_SET);
+    if (err != ESP_OK) {
+        return err;
+    }
+    nvs_open_t *h = get_handle(handle);
+    if (h == NULL) {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    if (h->mode != HAL_NVS_READWRITE) {
+        return ESP_ERR_NVS_READ_ONLY;
+    }
+    if (!valid_name(key)) {
+        return ESP_ERR_NVS_KEY_TOO_LONG;
+    }
+
+    nvs_entry_t *e = find(h->ns, key);
+    if (e == NULL) {
+        for (int i = 0; i < NVS_MAX_ENTRIES && e == NULL; i++) {
+            if (!s_entries[i].used) {
+                e = &s_entries[i];
+            }
+        }
+        if (e == NULL) {
+            return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+        }
+        e->used = true;
+        strcpy(e->ns, h->ns);
+        strcpy(e->key, key);
+    }
+
+    mark_dirty(e);
+    uint8_t *data = len > 0 ? malloc(len) : NULL;
+    if (len > 0) {
+        memcpy(data, value, len);
+    }
+    free(e->data);
+    e->data = data;
+    e->len = len;
+    e->type = type;
+    e->present = true;
+    return ESP_OK;
+}
+
+static esp_err_t read_value(hal_nvs_handle_t handle, const char *key, nvs_type_t type,
+                            const nvs_entry_t **out)
+{
+    esp_err_t err = inject(HAL_HOST_NVS_GET);
+    if (err != ESP_OK) {
+        return err;
+    }
+    nvs_open_t *h = get_handle(handle);
+    if (h == NULL) {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    if (!valid_name(key)) {
+        return ESP_ERR_NVS_KEY_TOO_LONG;
+    }
+    const nvs_entry_t *e = find(h->ns, key);
+    if (e == NULL || !e->present) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    if (e->type != type) {
+        return ESP_ERR_NVS_TYPE_MISMATCH;
+    }
+    *out = e;
+    return ESP_OK;
+}
+
+// ───────────────────────────────────────────────────────
+// hal_nvs.h
+
+esp_err_t hal_nvs_init(void)
+{
+    esp_err_t err = inject(HAL_HOST_NVS_INIT);
+    if (err == ESP_OK) {
+        s_initialized = true;
+    }
+    return err;
+}
+
+esp_err_t hal_nvs_open(const char *ns, hal_nvs_mode_t mode, hal_nvs_handle_t *out)
+{
+    esp_err_t err = inject(HAL_HOST_NVS_OPEN);
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (!s_initialized) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+    if (!valid_name(ns) || out == NULL) {
+        return ESP_ERR_NVS_INVALID_NAME;
+    }
+    if (mode == HAL_NVS_READONLY && !namespace_exists(ns)) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    if (mode == HAL_NVS_READWRITE && (err = namespace_create(ns)) != ESP_OK) {
+        return err;
+    }
+    for (int i = 0; i < NVS_MAX_HANDLES; i++) {
+        if (!s_handles[i].open) {
+            s_handles[i].open = true;
+            s_handles[i].mode = mode;
+            strcpy(s_handles[i].ns, ns);
+            *out = (hal_nvs_handle_t)(i + 1);
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+}
+
+void hal_nvs_close(hal_nvs_handle_t handle)
+{
+    nvs_open_t *h = get_handle(handle);
+    if (h != NULL) {
+        h->open = false;
+    }
+}
+
+esp_err_t hal_nvs_get_blob(hal_nvs_handle_t handle, const char *key, void *out, size_t *len)
+{
+    if (len == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const nvs_entry_t *e = NULL;
+    esp_err_t err = read_value(handle, key, NVS_TYPE_BLOB, &e);
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (out == NULL) {
+        *len = e->len;
+        return ESP_OK;
+    }
+    if (*len < e->len) {
+        *len = e->len;
+        return ESP_ERR_NVS_INVALID_LENGTH;
+    }
+    memcpy(out, e->data, e->len);
+    *len = e->len;
+    return ESP_OK;
+}
+
+esp_err_t hal_nvs_set_blob(hal_nvs_handle_t handle, const char *key, const void *value, size_t len)
+{
+    if (value == NULL && len > 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return write_value(handle, key, NVS_TYPE_BLOB, value, len);
+}
+
+esp_err_t hal_nvs_get_i64(hal_nvs_handle_t handle, const char *key, int64_t *out)
+{
+    if (out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const nvs_entry_t *e = NULL;
+    esp_err_t err = read_value(handle, key, NVS_TYPE_I64, &e);
+    if (err == ESP_OK) {
+        memcpy(out, e->data, sizeof(*out));
+    }
+    return err;
+}
+
+esp_err_t hal_nvs_set_i64(hal_nvs_handle_t handle, const char *key, int64_t value)
+{
+    return write_value(handle, key, NVS_TYPE_I64, &value, sizeof(value));
+}
+
+esp_err_t hal_nvs_erase_all(hal_nvs_handle_t handle)
+{
+    esp_err_t err = inject(HAL_HOST_NVS_ERASE);
+    if (err != ESP_OK) {
+        return err;
+    }
+    nvs_open_t *h = get_handle(handle);
+    if (h == NULL) {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    if (h->mode != HAL_NVS_READWRITE) {
+        return ESP_ERR_NVS_READ_ONLY;
+    }
+    for (int i = 0; i < NVS_MAX_ENTRIES; i++) {
+        nvs_entry_t *e = &s_entries[i];
+        if (e->used && e->present && strcmp(e->ns, h->ns) == 0) {
+            mark_dirty(e);
+            e->present = false;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t hal_nvs_commit(hal_nvs_handle_t handle)
+{
+    esp_err_t err = inject(HAL_HOST_NVS_COMMIT);
+    if (err != ESP_OK) {
+        return err;
+    }
+    nvs_open_t *h = get_handle(handle);
+    if (h == NULL) {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    for (int i = 0; i < NVS_MAX_ENTRIES; i++) {
+        nvs_entry_t *e = &s_entries[i];
+        if (!e->used || !e->dirty || strcmp(e->ns, h->ns) != 0) {
+            continue;
+        }
+        if (!e->present) {
+            free_entry(e);
+            continue;
+        }
+        free(e->saved);
+        e->saved = NULL;
+        e->dirty = false;
+    }
+    return ESP_OK;
+}
+
+// ───────────────────────────────────────────────────────
+// hal_host.h
+
+void hal_host_nvs_reset(void)
+{
+    for (int i = 0; i < NVS_MAX_ENTRIES; i++) {
+        if (s_entries[i].used) {
+            free_entry(&s_entries[i]);
+        }
+    }
+    memset(s_handles, 0, sizeof(s_handles));
+    memset(s_namespaces, 0, sizeof(s_namespaces));
+    memset(s_faults, 0, sizeof(s_faults));
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_initialized = false;
+}
+
+void hal_host_nvs_fail(hal_host_nvs_op_t op, esp_err_t err, uint32_t skip, uint32_t count)
+{
+    if (op >= HAL_HOST_NVS_OP_COUNT) {
+        return;
+    }
+    s_faults[op] = (nvs_fault_t){ .err = err, .skip = skip, .count = count };
+}
+
+void hal_host_nvs_power_cut(void)
+{
+    for (int i = 0; i < NVS_MAX_ENTRIES; i++) {
+        nvs_entry_t *e = &s_entries[i];
+        if (!e->used || !e->dirty) {
+            continue;
+        }
+        if (!e->saved_present) {
+            free_entry(e);
+            continue;
+        }
+        free(e->data);
+        e->data = e->saved;
+        e->len = e->saved_len;
+        e->type = e->saved_type;
+        e->present = true;
+        e->saved = NULL;
+        e->dirty = false;
+    }
+    memset(s_handles, 0, sizeof(s_handles));
+    s_initialized = false;
+}
+
+void hal_host_nvs_get_stats(hal_host_nvs_stats_t *out)
+{
+    if (out == NULL) {
+        return;
+    }
+    *out = s_stats;
+    out->entries = 0;
+    out->uncommitted = 0;
+    for (int i = 0; i < NVS_MAX_ENTRIES; i++) {
+        if (s_entries[i].used && s_entries[i].present) {
+            out->entries++;
+        }
+        if (s_entries[i].used && s_entries[i].dirty) {
+            out->uncommitted++;
+        }
+    }
+}
@@ -0,0 +1,174 @@
+/**
+ * @file hal_uart_host.c
+ * @brief Puertos serie del host: tubos hacia modelos de dispositivo.
+ * @details La transmisión tarda lo que tardaría la trama en la línea (10 bits por byte a la
+ *          velocidad configurada), en los dos sentidos: la respuesta de un modelo está completa
+ *          cuando termina de salir la consulta y de llegar la respuesta. hal_uart_read() vuelve
+ *          entonces si le alcanza, y si no espera el plazo completo, igual que uart_read_bytes().
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#include "hal_uart.h"
+#include "hal_host.h"
+#include "hal_clock.h"
+#include <string.h>
+
+#define UART_RX_CAPACITY    256
+
+typedef struct {
+    bool open;
+    hal_uart_config_t config;
+    uint8_t rx[UART_RX_CAPACITY];
+    size_t rx_head;
+    size_t rx_count;
+    int64_t tx_done_us;         ///< Instante en que termina de salir lo escrito
+    int64_t rx_ready_us;        ///< Instante en que termina de llegar lo inyectado
+    hal_host_uart_device_fn_t device;
+    void *device_ctx;
+} uart_port_t;
+
+static uart_port_t s_ports[HAL_UART_PORTS];
+
+static uart_port_t *get_port(int port)
+{
+    if (port < 0 || port >= HAL_UART_PORTS) {
+        return NULL;
+    }
+    return &s_ports[port];
+}
+
+static int64_t wire_us(const uart_port_t *p, size_t len)
+{
+    return p->config.baud_rate > 0 ? (int64_t)len * 10 * 1000000 / p->config.baud_rate : 0;
+}
+
+static size_t rx_pop(uart_port_t *p, uint8_t *out, size_t len)
+{
+    size_t n = 0;
+    while (n < len && p->rx_count > 0) {
+        out[n++] = p->rx[p->rx_head];
+        p->rx_head = (p->rx_head + 1) % UART_RX_CAPACITY;
+        p->rx_count--;
+    }
+    return n;
+}
+
+// ───────────────────────────────────────────────────────
+// hal_uart.h
+
+esp_err_t hal_uart_open(int port, const hal_uart_config_t *config)
+{
+    uart_port_t *p = get_port(port);
+    if (p == NULL || config == NULL || config->baud_rate == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    p->open = true;
+    p->config = *config;
+    p->rx_head = 0;
+    p->rx_count = 0;
+    p->tx_done_us = 0;
+    p->rx_ready_us = 0;
+    return ESP_OK;
+}
+
+int hal_uart_write(int port, const void *data, size_t len)
+{
+    uart_port_t *p = get_port(port);
+    if (p == NULL || !p->open || (data == NULL && len > 0)) {
+        return -1;
+    }
+    const int64_t now = hal_clock_mono_us();
+    const int64_t start = p->tx_done_us > now ? p->tx_done_us : now;
+    p->tx_done_us = start + wire_us(p, len);
+    if (p->device != NULL) {
+        p->device(port, data, len, p->device_ctx);
+    }
+    return (int)len;
+}
+
+esp_err_t hal_uart_wait_tx_done(int port, uint32_t timeout_ms)
+{
+    uart_port_t *p = get_port(port);
+    if (p == NULL || !p->open) {
+        return ESP_FAIL;
+    }
+    const int64_t pending = p->tx_done_us - hal_clock_mono_us();
+    if (pending <= 0) {
+        return ESP_OK;
+    }
+    if (pending > (int64_t)timeout_ms * 1000) {
+        hal_host_sleep_us((int64_t)timeout_ms * 1000);
+        return ESP_ERR_TIMEOUT;
+    }
+    hal_host_sleep_us(pending);
+    return ESP_OK;
+}
+
+int hal_uart_read(int port, void *buf, size_t len, uint32_t timeout_ms)
+{
+    uart_port_t *p = get_port(port);
+    if (p == NULL || !p->open || buf == NULL) {
+        return -1;
+    }
+    // Los modelos responden al escribir: lo que falta ya no va a llegar
+    const int64_t now = hal_clock_mono_us();
+    int64_t wake = now + (int64_t)timeout_ms * 1000;
+    if (p->rx_count >= len && p->rx_ready_us < wake) {
+        wake = p->rx_ready_us;
+    }
+    if (wake > now) {
+        hal_host_sleep_us(wake - now);
+    }
+    return hal_clock_mono_us() >= p->rx_ready_us ? (int)rx_pop(p, buf, len) : 0;
+}
+
+esp_err_t hal_uart_flush_input(int port)
+{
+    uart_port_t *p = get_port(port);
+    if (p == NULL || !p->open) {
+        return ESP_FAIL;
+    }
+    p->rx_head = 0;
+    p->rx_count = 0;
+    p->rx_ready_us = 0;
+    return ESP_OK;
+}
+
+// ───────────────────────────────────────────────────────
+// hal_host.h
+
+void hal_host_uart_attach(int port, hal_host_uart_device_fn_t fn, void *ctx)
+{
+    uart_port_t *p = get_port(port);
+    if (p != NULL) {
+        p->device = fn;
+        p->device_ctx = ctx;
+    }
+}
+
+size_t hal_host_uart_inject(int port, const uint8_t *data, size_t len)
+{
+    uart_port_t *p = get_port(port);
+    if (p == NULL || data == NULL) {
+        return 0;
+    }
+    const int64_t now = hal_clock_mono_us();
+    int64_t start = p->tx_done_us > now ? p->tx_done_us : now;
+    if (p->rx_ready_us > start) {
+        start = p->rx_ready_us;
+    }
+    p->rx_ready_us = start + wire_us(p, len);
+    size_t n = 0;
+    while (n < len && p->rx_count < UART_RX_CAPACITY) {
+        p->rx[(p->rx_head + p->rx_count) % UART_RX_CAPACITY] = data[n++];
+        p->rx_count++;
+    }
+    return n;
+}
+
+void hal_host_uart_reset(void)
+{
+    memset(s_ports, 0, sizeof(s_ports));
+}
@@ -0,0 +1,250 @@
+/**
+ * @file i2c_bus_host.c
+ * @brief i2c_bus.h en el host: transacciones síncronas contra modelos de dispositivo.
+ * @details i2c_bus.h ya es el único punto por el que el firmware habla con el bus, así que en
+ *          el host lo reemplaza entero. No hay tarea del bus ni colas: cada transacción se
+ *          resuelve en la tarea que la pide y dura lo que duraría a 400 kHz (9 bits por byte,
+ *          dirección incluida). Las estadísticas, la traza y los contadores por dispositivo
+ *          tienen el mismo formato que en el equipo.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#include "i2c_bus.h"
+#include "hal_host.h"
+#include "hal_clock.h"
+#include "esp_log.h"
+#include <string.h>
+
+#define I2C_HOST_MAX_DEVICES    16
+#define I2C_HOST_FREQ_HZ        400000
+
+typedef struct {
+    uint16_t addr;
+    hal_host_i2c_device_fn_t fn;
+    void *ctx;
+    esp_err_t fail_err;
+    uint32_t fail_count;
+} i2c_host_device_t;
+
+static i2c_host_device_t s_devices[I2C_HOST_MAX_DEVICES];
+static size_t s_device_count = 0;
+static i2c_bus_stats_t s_stats;
+static i2c_bus_device_stats_t s_dev_stats[I2C_BUS_MAX_TRACKED];
+static size_t s_dev_stats_count = 0;
+static i2c_bus_trace_entry_t s_trace[I2C_BUS_TRACE_LEN];
+static uint32_t s_trace_head = 0;
+static bool s_initialized = false;
+
+static i2c_host_device_t *find_device(uint16_t addr)
+{
+    for (size_t i = 0; i < s_device_count; i++) {
+        if (s_devices[i].addr == addr) {
+            return &s_devices[i];
+        }
+    }
+    return NULL;
+}
+
+static i2c_bus_device_stats_t *tracked_device(uint16_t addr)
+{
+    for (size_t i = 0; i < s_dev_stats_count; i++) {
+        if (s_dev_stats[i].addr == addr) {
+            return &s_dev_stats[i];
+        }
+    }
+    if (s_dev_stats_count == I2C_BUS_MAX_TRACKED) {
+        return NULL;
+    }
+    i2c_bus_device_stats_t *d = &s_dev_stats[s_dev_stats_count++];
+    memset(d, 0, sizeof(*d));
+    d->addr = addr;
+    return d;
+}
+
+static void account(uint16_t addr, size_t len, i2c_bus_prio_t prio, int64_t start_us, esp_err_t err)
+{
+    static const uint32_t bounds[] = I2C_BUS_HIST_BOUNDS_US;
+    const uint32_t dur = (uint32_t)(hal_clock_mono_us() - start_us);
+
+    i2c_bus_prio_stats_t *p = &s_stats.prio[prio];
+    p->jobs++;
+    p->errors += err != ESP_OK;
+    p->wait_last_us = 0;
+    p->exec_last_us = dur;
+    if (dur > p->exec_max_us) {
+        p->exec_max_us = dur;
+    }
+    if (dur > p->total_max_us) {
+        p->total_max_us = dur;
+    }
+    s_stats.busy_us += dur;
+
+    i2c_bus_device_stats_t *d = tracked_device(addr);
+    if (d != NULL) {
+        d->transactions++;
+        d->errors += err != ESP_OK;
+        d->bytes += len;
+        size_t b = 0;
+        while (b < sizeof(bounds) / sizeof(bounds[0]) && dur > bounds[b]) {
+            b++;
+        }
+        d->hist[b]++;
+    }
+
+    i2c_bus_trace_entry_t *t = &s_trace[s_trace_head % I2C_BUS_TRACE_LEN];
+    t->start_us = (uint32_t)start_us;
+    t->wait_us = 0;
+    t->dur_us = dur;
+    t->addr = addr;
+    t->len = (uint16_t)len;
+    t->err = (int16_t)err;
+    t->prio = (uint8_t)prio;
+    s_trace_head++;
+}
+
+static esp_err_t transfer(uint16_t addr, const uint8_t *tx, size_t tx_len, uint8_t *rx, size_t rx_len,
+                          i2c_bus_prio_t prio)
+{
+    if (prio >= I2C_BUS_PRIO_COUNT || (tx == NULL && tx_len > 0) || (rx == NULL && rx_len > 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const int64_t start = hal_clock_mono_us();
+    // Byte de dirección por cada fase más los datos, 9 bits por byte
+    const size_t bytes = tx_len + rx_len + (tx_len > 0) + (rx_len > 0);
+    hal_host_sleep_us((int64_t)bytes * 9 * 1000000 / I2C_HOST_FREQ_HZ);
+
+    esp_err_t err;
+    i2c_host_device_t *dev = find_device(addr);
+    if (dev == NULL) {
+        err = ESP_FAIL;     // Sin ACK de la dirección
+    } else if (dev->fail_count > 0) {
+        dev->fail_count--;
+        err = dev->fail_err;
+    } else {
+        err = dev->fn(addr, tx, tx_len, rx, rx_len, dev->ctx);
+    }
+    account(addr, tx_len + rx_len, prio, start, err);
+    return err;
+}
+
+// ───────────────────────────────────────────────────────
+// i2c_bus.h
+
+esp_err_t i2c_bus_init(void)
+{
+    if (!s_initialized) {
+        s_initialized = true;
+        s_stats.since_us = hal_clock_mono_us();
+    }
+    return ESP_OK;
+}
+
+i2c_master_bus_handle_t i2c_bus_get_handle(void)
+{
+    return NULL;
+}
+
+i2c_master_dev_handle_t i2c_bus_get_device(uint16_t addr)
+{
+    (void)addr;
+    return NULL;
+}
+
+esp_err_t i2c_bus_write(uint16_t addr, const uint8_t *data, size_t len, i2c_bus_prio_t prio)
+{
+    return transfer(addr, data, len, NULL, 0, prio);
+}
+
+esp_err_t i2c_bus_read(uint16_t addr, uint8_t *data, size_t len, i2c_bus_prio_t prio)
+{
+    return transfer(addr, NULL, 0, data, len, prio);
+}
+
+esp_err_t i2c_bus_write_read(uint16_t addr, const uint8_t *tx, size_t tx_len,
+                             uint8_t *rx, size_t rx_len, i2c_bus_prio_t prio)
+{
+    return transfer(addr, tx, tx_len, rx, rx_len, prio);
+}
+
+esp_err_t i2c_bus_run(uint16_t addr, i2c_bus_job_fn_t fn, void *arg, i2c_bus_prio_t prio)
+{
+    if (fn == NULL || prio >= I2C_BUS_PRIO_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const int64_t start = hal_clock_mono_us();
+    esp_err_t err = fn(arg);
+    account(addr, 0, prio, start, err);
+    return err;
+}
+
+void i2c_bus_get_stats(i2c_bus_stats_t *stats)
+{
+    if (stats != NULL) {
+        *stats = s_stats;
+    }
+}
+
+size_t i2c_bus_get_trace(i2c_bus_trace_entry_t *out, size_t max)
+{
+    const uint32_t available = s_trace_head < I2C_BUS_TRACE_LEN ? s_trace_head : I2C_BUS_TRACE_LEN;
+    const size_t n = max < available ? max : available;
+    for (size_t i = 0; i < n; i++) {
+        out[i] = s_trace[(s_trace_head - n + i) % I2C_BUS_TRACE_LEN];
+    }
+    return n;
+}
+
+size_t i2c_bus_get_device_stats(i2c_bus_device_stats_t *out, size_t max)
+{
+    const size_t n = max < s_dev_stats_count ? max : s_dev_stats_count;
+    memcpy(out, s_dev_stats, n * sizeof(*out));
+    return n;
+}
+
+void i2c_bus_log_stats(void)
+{
+    for (int p = 0; p < I2C_BUS_PRIO_COUNT; p++) {
+        ESP_LOGI("I2C_BUS", "prio %d: %lu transacciones, %lu errores, máx %lu us", p,
+                 (unsigned long)s_stats.prio[p].jobs, (unsigned long)s_stats.prio[p].errors,
+                 (unsigned long)s_stats.prio[p].exec_max_us);
+    }
+}
+
+// ───────────────────────────────────────────────────────
+// hal_host.h
+
+esp_err_t hal_host_i2c_attach(uint16_t addr, hal_host_i2c_device_fn_t fn, void *ctx)
+{
+    i2c_host_device_t *dev = find_device(addr);
+    if (dev == NULL) {
+        if (s_device_count == I2C_HOST_MAX_DEVICES) {
+            return ESP_ERR_NO_MEM;
+        }
+        dev = &s_devices[s_device_count++];
+    }
+    *dev = (i2c_host_device_t){ .addr = addr, .fn = fn, .ctx = ctx };
+    return ESP_OK;
+}
+
+void hal_host_i2c_fail(uint16_t addr, esp_err_t err, uint32_t count)
+{
+    i2c_host_device_t *dev = find_device(addr);
+    if (dev != NULL) {
+        dev->fail_err = err;
+        dev->fail_count = count;
+    }
+}
+
+void hal_host_i2c_reset(void)
+{
+    memset(s_devices, 0, sizeof(s_devices));
+    s_device_count = 0;
+    memset(&s_stats, 0, sizeof(s_stats));
+    memset(s_dev_stats, 0, sizeof(s_dev_stats));
+    s_dev_stats_count = 0;
+    s_trace_head = 0;
+    s_initialized = false;
+}
@@ -0,0 +1,14 @@
+/**
+ * @file i2c_master.h
+ * @brief Tipos del driver i2c_master de ESP-IDF para la compilación en el host.
+ * @details Solo los identificadores opacos que expone i2c_bus.h; las transacciones del host
+ *          las resuelve host/hal/i2c_bus_host.c contra los modelos de dispositivo.
+ */
+
+#ifndef HOST_DRIVER_I2C_MASTER_H
+#define HOST_DRIVER_I2C_MASTER_H
+
+typedef struct i2c_master_bus_t *i2c_master_bus_handle_t;
+typedef struct i2c_master_dev_t *i2c_master_dev_handle_t;
+
+#endif // HOST_DRIVER_I2C_MASTER_H
@@ -0,0 +1,13 @@
+/**
+ * @file esp_attr.h
+ * @brief Atributos de ubicación de ESP-IDF para la compilación en el host.
+ * @details En el host no hay IRAM ni DRAM separadas: los atributos no hacen nada.
+ */
+
+#ifndef HOST_ESP_ATTR_H
+#define HOST_ESP_ATTR_H
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+
+#endif // HOST_ESP_ATTR_H
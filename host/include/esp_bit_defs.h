@@ -0,0 +1,14 @@
+/**
+ * @file esp_bit_defs.h
+ * @brief Macros BITn de ESP-IDF para la compilación en el host.
+ */
+
+#ifndef HOST_ESP_BIT_DEFS_H
+#define HOST_ESP_BIT_DEFS_H
+
+#define BIT0    0x00000001
+#define BIT1    0x00000002
+#define BIT2    0x00000004
+#define BIT3    0x00000008
+
+#endif // HOST_ESP_BIT_DEFS_H
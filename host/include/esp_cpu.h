@@ -0,0 +1,40 @@
+/**
+ * @file esp_cpu.h
+ * @brief Contador de ciclos de la CPU para la compilación en el host.
+ * @details A diferencia del reloj, no es virtual: mide lo que tarda el código en el PC. En x86
+ *          es el TSC (rdtsc); en otras arquitecturas, nanosegundos de CLOCK_MONOTONIC. Como en
+ *          el equipo, es de 32 bits y da la vuelta; solo sirve para restar dos lecturas cercanas.
+ */
+
+#ifndef HOST_ESP_CPU_H
+#define HOST_ESP_CPU_H
+
+#include <stdint.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint32_t esp_cpu_cycle_count_t;
+
+static inline esp_cpu_cycle_count_t esp_cpu_get_cycle_count(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return (esp_cpu_cycle_count_t)__rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (esp_cpu_cycle_count_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_ESP_CPU_H
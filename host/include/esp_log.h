@@ -0,0 +1,55 @@
+/**
+ * @file esp_log.h
+ * @brief Registro de ESP-IDF para la compilación en el host.
+ * @details Escribe en stderr con el instante del reloj virtual. El nivel se elige con la
+ *          variable de entorno TRIPTA_LOG (E, W, I, D o V; W por defecto, para que las pruebas
+ *          no llenen la salida). Con esp_log_set_vprintf() las líneas, ya filtradas, pasan
+ *          por otra salida (log_tap en el simulador) con el mismo formato que en el equipo.
+ */
+
+#ifndef HOST_ESP_LOG_H
+#define HOST_ESP_LOG_H
+
+#include <stdint.h>
+#include <stdarg.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    ESP_LOG_NONE = 0,
+    ESP_LOG_ERROR,
+    ESP_LOG_WARN,
+    ESP_LOG_INFO,
+    ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE,
+} esp_log_level_t;
+
+void host_log_write(esp_log_level_t level, const char *tag, const char *format, ...)
+    __attribute__((format(printf, 3, 4)));
+
+/**
+ * @brief Cambia el nivel (todas las etiquetas; la etiqueta se ignora)
+ */
+void esp_log_level_set(const char *tag, esp_log_level_t level);
+
+typedef int (*vprintf_like_t)(const char *format, va_list args);
+
+/**
+ * @brief Cambia la salida de las líneas (por defecto, stderr)
+ * @return La salida anterior
+ */
+vprintf_like_t esp_log_set_vprintf(vprintf_like_t func);
+
+#define ESP_LOGE(tag, format, ...) host_log_write(ESP_LOG_ERROR, tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) host_log_write(ESP_LOG_WARN, tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) host_log_write(ESP_LOG_INFO, tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) host_log_write(ESP_LOG_DEBUG, tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) host_log_write(ESP_LOG_VERBOSE, tag, format, ##__VA_ARGS__)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_ESP_LOG_H
@@ -0,0 +1,24 @@
+/**
+ * @file esp_clk.h
+ * @brief Frecuencia de la CPU para la compilación en el host.
+ * @details Es la del contador de esp_cpu.h: en x86 la del TSC, medida una vez contra
+ *          CLOCK_MONOTONIC; en otras arquitecturas el contador ya cuenta nanosegundos (1 GHz).
+ */
+
+#ifndef HOST_ESP_CLK_H
+#define HOST_ESP_CLK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Frecuencia del contador de ciclos, en Hz
+ */
+int esp_clk_cpu_freq(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_ESP_CLK_H
@@ -0,0 +1,22 @@
+/**
+ * @file esp_random.h
+ * @brief Números aleatorios de ESP-IDF para la compilación en el host.
+ * @details Secuencia fija: las corridas se repiten igual.
+ */
+
+#ifndef HOST_ESP_RANDOM_H
+#define HOST_ESP_RANDOM_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint32_t esp_random(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_ESP_RANDOM_H
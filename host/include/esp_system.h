@@ -0,0 +1,24 @@
+/**
+ * @file esp_system.h
+ * @brief Reinicio y aborto de ESP-IDF para la compilación en el host.
+ */
+
+#ifndef HOST_ESP_SYSTEM_H
+#define HOST_ESP_SYSTEM_H
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Escribe el motivo en stderr y aborta el proceso
+ */
+void esp_system_abort(const char *details) __attribute__((noreturn));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_ESP_SYSTEM_H
@@ -0,0 +1,42 @@
+/**
+ * @file esp_timer.h
+ * @brief Reloj de esp_timer para la compilación en el host.
+ * @details esp_timer_get_time() es el reloj monotónico virtual de hal_host.h. Los temporizadores
+ *          solo existen en las pruebas del gestor WiFi (host/fakes/wifi_fake.c): se arman y
+ *          detienen, pero no disparan.
+ */
+
+#ifndef HOST_ESP_TIMER_H
+#define HOST_ESP_TIMER_H
+
+#include "esp_err.h"
+#include "hal_clock.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline int64_t esp_timer_get_time(void)
+{
+    return hal_clock_mono_us();
+}
+
+typedef struct esp_timer *esp_timer_handle_t;
+typedef void (*esp_timer_cb_t)(void *arg);
+
+typedef struct {
+    esp_timer_cb_t callback;
+    void *arg;
+    const char *name;
+} esp_timer_create_args_t;
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *out);
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us);
+esp_err_t esp_timer_stop(esp_timer_handle_t timer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_ESP_TIMER_H
@@ -0,0 +1,141 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Subconjunto de la API de FreeRTOS (ESP-IDF) para la compilación en el host.
+ * @details Tareas, colas, semáforos, grupos de eventos, notificaciones y secciones críticas con la semántica de
+ *          FreeRTOS sobre el reloj virtual de hal_host.h. Sin planificador en marcha (pruebas
+ *          unitarias) las tareas creadas no se ejecutan y una espera con plazo adelanta el
+ *          reloj virtual; una espera sin plazo que nunca se cumpliría aborta la prueba.
+ *          Con hal_host_kernel_run_until_us() (simulador) cada tarea corre en su propio hilo,
+ *          de a una por vez y con desalojo por prioridad.
+ *          La pila es en bytes, como en ESP-IDF.
+ */
+
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+#include "sdkconfig.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint8_t StackType_t;
+typedef void (*TaskFunction_t)(void *arg);
+
+#define configTICK_RATE_HZ          CONFIG_FREERTOS_HZ
+#define configMAX_PRIORITIES        25
+#define configMAX_TASK_NAME_LEN     16
+#define portTICK_PERIOD_MS          ((TickType_t)(1000 / configTICK_RATE_HZ))
+#define portMAX_DELAY               ((TickType_t)0xffffffffUL)
+#define pdMS_TO_TICKS(ms)           ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000))
+#define pdTICKS_TO_MS(ticks)        ((uint32_t)(((uint64_t)(ticks) * 1000) / configTICK_RATE_HZ))
+
+#define pdFALSE                     ((BaseType_t)0)
+#define pdTRUE                      ((BaseType_t)1)
+#define pdPASS                      pdTRUE
+#define pdFAIL                      pdFALSE
+#define errQUEUE_EMPTY              ((BaseType_t)0)
+#define errQUEUE_FULL               ((BaseType_t)0)
+#define tskNO_AFFINITY              ((BaseType_t)0x7FFFFFFF)
+
+// ───────────────────────────────────────────────────────
+// Secciones críticas
+
+typedef struct {
+    uint32_t count;     ///< Anidamiento
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED    { 0 }
+
+void host_port_enter_critical(portMUX_TYPE *mux);
+void host_port_exit_critical(portMUX_TYPE *mux);
+
+/**
+ * @brief Espera de `us` de la tarea en curso (hal_host_sleep_us() con el planificador en marcha)
+ * @return false si no la llama una tarea del planificador
+ */
+bool host_task_sleep_us(int64_t us);
+
+#define portENTER_CRITICAL(mux)         host_port_enter_critical(mux)
+#define portEXIT_CRITICAL(mux)          host_port_exit_critical(mux)
+#define portENTER_CRITICAL_ISR(mux)     host_port_enter_critical(mux)
+#define portEXIT_CRITICAL_ISR(mux)      host_port_exit_critical(mux)
+#define portENTER_CRITICAL_SAFE(mux)    host_port_enter_critical(mux)
+#define portEXIT_CRITICAL_SAFE(mux)     host_port_exit_critical(mux)
+#define portYIELD_FROM_ISR(woken)       ((void)(woken))
+
+// ───────────────────────────────────────────────────────
+// Objetos (los Static*_t son los propios objetos: el host no usa otra memoria)
+
+struct host_thread;
+
+/**
+ * @brief Tarea
+ */
+struct host_task {
+    char name[configMAX_TASK_NAME_LEN];
+    TaskFunction_t fn;
+    void *arg;
+    UBaseType_t priority;
+    uint32_t stack_depth;       ///< Bytes pedidos al crearla
+    uint32_t notify;            ///< Valor de notificación (xTaskNotifyGive)
+    bool dynamic;               ///< Creada con xTaskCreate (se libera al borrarla)
+    bool deleted;
+    // Planificador del simulador
+    uint8_t state;              ///< Lista, bloqueada o borrada
+    bool timed_out;             ///< La última espera venció sin que nada la despertara
+    const void *wait_obj;       ///< Cola o grupo de eventos que espera, la propia tarea (notificación) o NULL (demora)
+    int64_t wake_us;            ///< Vencimiento de la espera (-1: sin plazo)
+    int64_t blocked_us;         ///< Instante en que se bloqueó
+    int64_t seq;                ///< Orden de llegada entre las de igual prioridad
+    struct host_thread *thread; ///< Hilo que la ejecuta (se crea al despacharla por primera vez)
+    uint32_t dispatches;        ///< Veces que recibió la CPU
+    uint32_t preemptions;       ///< Veces que la desalojó otra de más prioridad
+    uint32_t waits;             ///< Esperas que llegaron a bloquearla
+    uint32_t timeouts;          ///< Esperas que vencieron
+    uint32_t mutex_wait_max_us; ///< Espera más larga por un mutex
+    int64_t resumed_ns;         ///< Instante real en que recuperó la CPU
+    uint64_t cpu_ns;            ///< Tiempo real acumulado con la CPU
+};
+
+/**
+ * @brief Cola o semáforo (item_size 0)
+ */
+struct host_queue {
+    uint8_t *storage;           ///< length * item_size bytes
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t head;           ///< Próximo elemento a leer
+    UBaseType_t count;          ///< Elementos (o cuenta del semáforo)
+    bool dynamic;               ///< Creada con xQueueCreate (se libera al borrarla)
+    bool mutex;                 ///< Creado con xSemaphoreCreateMutex*
+    struct host_task *holder;   ///< Tarea que tiene el mutex (NULL: libre o tomado fuera de una tarea)
+};
+
+/**
+ * @brief Grupo de eventos
+ */
+struct host_event_group {
+    uint32_t bits;
+};
+
+typedef struct host_task StaticTask_t;
+typedef struct host_queue StaticQueue_t;
+typedef struct host_queue StaticSemaphore_t;
+typedef struct host_task *TaskHandle_t;
+typedef struct host_queue *QueueHandle_t;
+typedef struct host_event_group StaticEventGroup_t;
+typedef struct host_event_group *EventGroupHandle_t;
+typedef uint32_t EventBits_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_FREERTOS_H
@@ -0,0 +1,42 @@
+/**
+ * @file task.h
+ * @brief Tareas y notificaciones de FreeRTOS para la compilación en el host.
+ */
+
+#ifndef HOST_FREERTOS_TASK_H
+#define HOST_FREERTOS_TASK_H
+
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+TaskHandle_t xTaskCreateStatic(TaskFunction_t fn, const char *name, uint32_t stack_depth, void *arg,
+                               UBaseType_t priority, StackType_t *stack, StaticTask_t *tcb);
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_depth, void *arg,
+                       UBaseType_t priority, TaskHandle_t *out);
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount(void);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+char *pcTaskGetName(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+UBaseType_t uxTaskGetNumberOfTasks(void);
+
+/**
+ * @brief El host no mide la pila: devuelve el tamaño pedido al crear la tarea
+ */
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+
+#define xTaskCreatePinnedToCore(fn, name, depth, arg, prio, out, core) \
+    xTaskCreate(fn, name, depth, arg, prio, out)
+#define xTaskCreateStaticPinnedToCore(fn, name, depth, arg, prio, stack, tcb, core) \
+    xTaskCreateStatic(fn, name, depth, arg, prio, stack, tcb)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_FREERTOS_TASK_H
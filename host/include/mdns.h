@@ -0,0 +1,31 @@
+/**
+ * @file mdns.h
+ * @brief Componente mDNS de ESP-IDF para la compilación en el host.
+ */
+
+#ifndef HOST_MDNS_H
+#define HOST_MDNS_H
+
+#include "esp_err.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    const char *key;
+    const char *value;
+} mdns_txt_item_t;
+
+esp_err_t mdns_init(void);
+esp_err_t mdns_hostname_set(const char *hostname);
+esp_err_t mdns_service_add(const char *instance, const char *service, const char *proto, uint16_t port,
+                           mdns_txt_item_t txt[], size_t num_items);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_MDNS_H
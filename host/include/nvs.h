@@ -0,0 +1,65 @@
+/**
+ * @file nvs.h
+ * @brief API de nvs_flash para la compilación en el host, sobre la NVS en RAM de hal_nvs.h.
+ * @details Las cadenas se guardan como blobs con su '\0'; los errores (clave inexistente,
+ *          destino corto) son los de ESP-IDF.
+ */
+
+#ifndef HOST_NVS_H
+#define HOST_NVS_H
+
+#include "esp_err.h"
+#include "hal_nvs.h"
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef hal_nvs_handle_t nvs_handle_t;
+
+typedef enum {
+    NVS_READONLY = HAL_NVS_READONLY,
+    NVS_READWRITE = HAL_NVS_READWRITE,
+} nvs_open_mode_t;
+
+static inline esp_err_t nvs_open(const char *ns, nvs_open_mode_t mode, nvs_handle_t *out)
+{
+    return hal_nvs_open(ns, (hal_nvs_mode_t)mode, out);
+}
+
+static inline void nvs_close(nvs_handle_t handle)
+{
+    hal_nvs_close(handle);
+}
+
+static inline esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out, size_t *len)
+{
+    return hal_nvs_get_blob(handle, key, out, len);
+}
+
+static inline esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t len)
+{
+    return hal_nvs_set_blob(handle, key, value, len);
+}
+
+static inline esp_err_t nvs_get_str(nvs_handle_t handle, const char *key, char *out, size_t *len)
+{
+    return hal_nvs_get_blob(handle, key, out, len);
+}
+
+static inline esp_err_t nvs_set_str(nvs_handle_t handle, const char *key, const char *value)
+{
+    return hal_nvs_set_blob(handle, key, value, strlen(value) + 1);
+}
+
+static inline esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    return hal_nvs_commit(handle);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_NVS_H
@@ -0,0 +1,24 @@
+/**
+ * @file nvs_flash.h
+ * @brief Inicialización de nvs_flash para la compilación en el host (ver nvs.h).
+ */
+
+#ifndef HOST_NVS_FLASH_H
+#define HOST_NVS_FLASH_H
+
+#include "nvs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline esp_err_t nvs_flash_init(void)
+{
+    return hal_nvs_init();
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_NVS_FLASH_H
@@ -0,0 +1,33 @@
+/**
+ * @file sdkconfig.h
+ * @brief Opciones de configuración para la compilación en el host.
+ * @details Solo las que leen los módulos compilados en el host. Las herramientas de
+ *          diagnóstico que dependen del equipo (tracer, consola) quedan apagadas; log_tap solo
+ *          lo compila el simulador, para los clientes del log remoto.
+ */
+
+#ifndef HOST_SDKCONFIG_H
+#define HOST_SDKCONFIG_H
+
+#define CONFIG_IDF_TARGET           "host"
+#define CONFIG_FREERTOS_HZ          1000
+#define CONFIG_MEM_BUDGET_ABORT     1
+#define CONFIG_LOG_TAP_ENABLE       1
+#define CONFIG_LOG_TAP_LINES        256
+#define CONFIG_LOG_TAP_UART_IDLE_WARN 1
+#define CONFIG_LWIP_MAX_SOCKETS     10
+
+// Gestor WiFi (los valores por defecto de main/Kconfig.projbuild)
+#define CONFIG_WIFI_MANAGER_BACKOFF_MIN_MS          500
+#define CONFIG_WIFI_MANAGER_BACKOFF_MAX_MS          60000
+#define CONFIG_WIFI_MANAGER_FAST_RECONNECT_ATTEMPTS 2
+
+// Tarea de LVGL del simulador (los valores de sdkconfig)
+#define CONFIG_EXAMPLE_LVGL_PORT_TASK_MAX_DELAY_MS  500
+#define CONFIG_EXAMPLE_LVGL_PORT_TASK_MIN_DELAY_MS  10
+#define CONFIG_EXAMPLE_LVGL_PORT_TASK_PRIORITY      2
+#define CONFIG_EXAMPLE_LVGL_PORT_TASK_STACK_SIZE_KB 6
+#define CONFIG_EXAMPLE_LVGL_PORT_ROTATION_DEGREE    0
+#define CONFIG_LV_DISP_DEF_REFR_PERIOD              30
+
+#endif // HOST_SDKCONFIG_H
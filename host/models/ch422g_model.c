@@ -0,0 +1,102 @@
+/**
+ * @file ch422g_model.c
+ * @brief Modelo del CH422G para el I2C del host.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#include "ch422g_model.h"
+#include "CH422G.h"
+#include "hal_host.h"
+#include "hal_clock.h"
+#include <string.h>
+
+static ch422g_model_state_t s_state;
+
+static bool ssr_on(uint8_t od_out)
+{
+    return (od_out & CH422G_OD_OUT_1) == 0;
+}
+
+static void write_od(uint8_t value)
+{
+    const bool was_on = ssr_on(s_state.od_out);
+    s_state.od_out = value & 0x0F;
+    if (ssr_on(s_state.od_out) != was_on) {
+        const int64_t now = hal_clock_mono_us();
+        if (was_on) {
+            s_state.ssr_on_us += now - s_state.ssr_changed_us;
+        }
+        s_state.ssr_changed_us = now;
+        s_state.ssr_edges++;
+    }
+}
+
+static esp_err_t on_transfer(uint16_t addr, const uint8_t *tx, size_t tx_len,
+                             uint8_t *rx, size_t rx_len, void *ctx)
+{
+    (void)ctx;
+    if (tx_len > 0) {
+        // El chip se queda con el último byte de la escritura
+        const uint8_t value = tx[tx_len - 1];
+        s_state.writes++;
+        switch (addr) {
+        case CH422G_Mode:   s_state.mode = value; break;
+        case CH422G_OD_OUT: write_od(value); break;
+        case CH422G_IO_OUT: s_state.io_out = value; break;
+        default:            return ESP_FAIL;    // 0x26 solo se lee
+        }
+    }
+    if (rx_len > 0) {
+        s_state.reads++;
+        uint8_t value;
+        switch (addr) {
+        case CH422G_IO_IN:  value = s_state.io_in; break;
+        case CH422G_OD_OUT: value = s_state.od_out; break;
+        case CH422G_IO_OUT: value = s_state.io_out; break;
+        default:            value = s_state.mode; break;
+        }
+        memset(rx, value, rx_len);
+    }
+    return ESP_OK;
+}
+
+esp_err_t ch422g_model_attach(void)
+{
+    memset(&s_state, 0, sizeof(s_state));
+    s_state.od_out = 0x0F;
+    s_state.ssr_changed_us = hal_clock_mono_us();
+    const uint16_t addrs[] = { CH422G_Mode, CH422G_OD_OUT, CH422G_IO_OUT, CH422G_IO_IN };
+    for (size_t i = 0; i < sizeof(addrs) / sizeof(addrs[0]); i++) {
+        esp_err_t err = hal_host_i2c_attach(addrs[i], on_transfer, NULL);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+    return ESP_OK;
+}
+
+void ch422g_model_get(ch422g_model_state_t *out)
+{
+    *out = s_state;
+}
+
+void ch422g_model_set_inputs(uint8_t io_in)
+{
+    s_state.io_in = io_in;
+}
+
+bool ch422g_model_ssr_on(void)
+{
+    return ssr_on(s_state.od_out);
+}
+
+int64_t ch422g_model_ssr_on_us(void)
+{
+    int64_t total = s_state.ssr_on_us;
+    if (ssr_on(s_state.od_out)) {
+        total += hal_clock_mono_us() - s_state.ssr_changed_us;
+    }
+    return total;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file ch422g_model.h
+ * @brief Modelo del expansor CH422G sobre el I2C del host.
+ * @details El CH422G no tiene registros direccionables: cada "registro" es una dirección I2C
+ *          propia (0x24 modo, 0x23 salidas OC, 0x38 salidas IO, 0x26 entradas). El modelo
+ *          atiende las cuatro y lleva la cuenta de los flancos de OC1, que maneja el SSR
+ *          (encendido = OC1 en bajo).
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#ifndef CH422G_MODEL_H
+#define CH422G_MODEL_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Estado de los registros y del SSR
+ */
+typedef struct {
+    uint8_t mode;               ///< Último byte escrito en 0x24
+    uint8_t od_out;             ///< Salidas OC (0x23)
+    uint8_t io_out;             ///< Salidas IO (0x38)
+    uint8_t io_in;              ///< Lo que devuelve una lectura de 0x26
+    uint32_t writes;            ///< Escrituras recibidas
+    uint32_t reads;             ///< Lecturas atendidas
+    uint32_t ssr_edges;         ///< Cambios de estado del SSR
+    int64_t ssr_on_us;          ///< Tiempo acumulado con el SSR encendido (hasta el último flanco)
+    int64_t ssr_changed_us;     ///< Instante del último flanco
+} ch422g_model_state_t;
+
+/**
+ * @brief Conecta el modelo a sus cuatro direcciones con las salidas OC en alto (SSR apagado)
+ */
+esp_err_t ch422g_model_attach(void);
+
+/**
+ * @brief Copia el estado actual
+ */
+void ch422g_model_get(ch422g_model_state_t *out);
+
+/**
+ * @brief Fija las entradas digitales que verá el firmware
+ */
+void ch422g_model_set_inputs(uint8_t io_in);
+
+/**
+ * @brief Estado del SSR según la salida OC1
+ */
+bool ch422g_model_ssr_on(void);
+
+/**
+ * @brief Tiempo total con el SSR encendido, contando el tramo en curso
+ */
+int64_t ch422g_model_ssr_on_us(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CH422G_MODEL_H
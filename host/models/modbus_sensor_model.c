@@ -0,0 +1,88 @@
+/**
+ * @file modbus_sensor_model.c
+ * @brief Modelo del transmisor de temperatura Modbus RTU.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#include "modbus_sensor_model.h"
+#include "sensor.h"
+#include "hal_host.h"
+#include <math.h>
+#include <string.h>
+
+#define SLAVE_ID    1
+
+static float s_temp_c = 25.0f;
+static modbus_sensor_temp_fn_t s_source = NULL;
+static void *s_source_ctx = NULL;
+static modbus_sensor_fault_t s_fault = MODBUS_SENSOR_OK;
+static modbus_sensor_stats_t s_stats;
+
+static void on_frame(int port, const uint8_t *data, size_t len, void *ctx)
+{
+    (void)ctx;
+    s_stats.requests++;
+    uint8_t frame[8];
+    if (len != sizeof(frame)) {
+        s_stats.bad_frames++;
+        return;
+    }
+    memcpy(frame, data, len);
+    const uint16_t crc = modbus_crc(frame, 6);
+    if (frame[0] != SLAVE_ID || frame[1] != 0x03 || frame[6] != (crc & 0xFF) || frame[7] != (crc >> 8)) {
+        s_stats.bad_frames++;
+        return;
+    }
+    if (s_fault == MODBUS_SENSOR_SILENT) {
+        return;
+    }
+
+    const float temp = s_source != NULL ? s_source(s_source_ctx) : s_temp_c;
+    const int16_t raw = (int16_t)lroundf(temp * 10.0f);
+    uint8_t reply[7] = { SLAVE_ID, 0x03, 2, (uint8_t)((uint16_t)raw >> 8), (uint8_t)raw, 0, 0 };
+    if (s_fault == MODBUS_SENSOR_WRONG_SLAVE) {
+        reply[0] = SLAVE_ID + 1;
+    }
+    const uint16_t reply_crc = modbus_crc(reply, 5);
+    reply[5] = reply_crc & 0xFF;
+    reply[6] = reply_crc >> 8;
+    if (s_fault == MODBUS_SENSOR_BAD_CRC) {
+        // Un bit alterado en el registro: encabezado correcto, CRC que no coincide
+        reply[3] ^= 0x40;
+    }
+    hal_host_uart_inject(port, reply, s_fault == MODBUS_SENSOR_SHORT ? 4 : sizeof(reply));
+    s_stats.replies++;
+}
+
+void modbus_sensor_model_attach(int port)
+{
+    s_temp_c = 25.0f;
+    s_source = NULL;
+    s_source_ctx = NULL;
+    s_fault = MODBUS_SENSOR_OK;
+    memset(&s_stats, 0, sizeof(s_stats));
+    hal_host_uart_attach(port, on_frame, NULL);
+}
+
+void modbus_sensor_model_set_temp(float temp_c)
+{
+    s_temp_c = temp_c;
+}
+
+void modbus_sensor_model_set_source(modbus_sensor_temp_fn_t fn, void *ctx)
+{
+    s_source = fn;
+    s_source_ctx = ctx;
+}
+
+void modbus_sensor_model_set_fault(modbus_sensor_fault_t fault)
+{
+    s_fault = fault;
+}
+
+void modbus_sensor_model_get_stats(modbus_sensor_stats_t *out)
+{
+    *out = s_stats;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file modbus_sensor_model.h
+ * @brief Modelo del transmisor de temperatura Modbus RTU (esclavo 1, registro 0x0000).
+ * @details Responde a "leer 1 registro holding" con la temperatura en décimas de °C como
+ *          entero con signo, igual que el transmisor del horno. La respuesta llega dentro de
+ *          la propia escritura del firmware; los modos de falla cubren un sensor mudo, otro
+ *          esclavo contestando, una trama cortada y una trama alterada en la línea.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#ifndef MODBUS_SENSOR_MODEL_H
+#define MODBUS_SENSOR_MODEL_H
+
+#include "esp_err.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Comportamiento del modelo
+ */
+typedef enum {
+    MODBUS_SENSOR_OK = 0,       ///< Responde bien
+    MODBUS_SENSOR_SILENT,       ///< No responde
+    MODBUS_SENSOR_WRONG_SLAVE,  ///< Responde con otro número de esclavo
+    MODBUS_SENSOR_SHORT,        ///< Corta la respuesta a 4 bytes
+    MODBUS_SENSOR_BAD_CRC,      ///< Altera la temperatura después de calcular el CRC
+} modbus_sensor_fault_t;
+
+/**
+ * @brief Temperatura dinámica (p. ej. la de un modelo de planta)
+ */
+typedef float (*modbus_sensor_temp_fn_t)(void *ctx);
+
+/**
+ * @brief Contadores del modelo
+ */
+typedef struct {
+    uint32_t requests;          ///< Tramas recibidas
+    uint32_t replies;           ///< Respuestas enviadas
+    uint32_t bad_frames;        ///< Tramas con CRC o función inválidos
+} modbus_sensor_stats_t;
+
+/**
+ * @brief Conecta el modelo a un puerto serie con temperatura fija de 25 °C
+ */
+void modbus_sensor_model_attach(int port);
+
+/**
+ * @brief Temperatura fija que reporta
+ */
+void modbus_sensor_model_set_temp(float temp_c);
+
+/**
+ * @brief Toma la temperatura de una función en cada pedido (NULL vuelve a la fija)
+ */
+void modbus_sensor_model_set_source(modbus_sensor_temp_fn_t fn, void *ctx);
+
+/**
+ * @brief Fija el modo de falla
+ */
+void modbus_sensor_model_set_fault(modbus_sensor_fault_t fault);
+
+/**
+ * @brief Copia los contadores
+ */
+void modbus_sensor_model_get_stats(modbus_sensor_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MODBUS_SENSOR_MODEL_H
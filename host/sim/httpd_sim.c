@@ -0,0 +1,702 @@
+/**
+ * @file httpd_sim.c
+ * @brief esp_http_server del simulador: una tarea "httpd" y conexiones virtuales.
+ * @details Como el servidor de ESP-IDF, una sola tarea acepta conexiones, corre los manejadores
+ *          y los trabajos de httpd_queue_work() de a uno; httpd_ws_send_frame_async() en cambio
+ *          envía desde la tarea que lo llama (la del planificador en la difusión de estado).
+ *
+ *          Cada conexión tiene un enlace con su velocidad y el búfer de envío de lwIP
+ *          (TCP_SND_BUF). Un envío que no entra en el búfer bloquea a quien lo hace hasta que el
+ *          enlace lo vacíe; si eso supera send_wait_timeout el envío falla, como el socket con
+ *          SO_SNDTIMEO. Lo recibido se anota del lado del cliente en el instante en que llega.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#include "sim.h"
+#include "esp_http_server.h"
+#include "hal_host.h"
+#include "hal_clock.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_NET_MAX_CONNS       32
+#define SIM_NET_FD_BASE         54      ///< LWIP_SOCKET_OFFSET: el primer socket de lwIP
+#define SIM_NET_SNDBUF          5744    ///< TCP_SND_BUF por defecto de ESP-IDF
+#define SIM_NET_ONE_WAY_US      2000    ///< Latencia de la red local, en un sentido
+#define SIM_HTTP_HEADER_BYTES   96      ///< Línea de estado y cabeceras de una respuesta
+#define SIM_WS_HANDSHAKE_BYTES  129     ///< "101 Switching Protocols" con Sec-WebSocket-Accept
+#define SIM_WS_MSG_MAX          160     ///< Mensaje entrante más largo que acepta el cliente
+#define SIM_HTTPD_QUEUE_LEN     16
+#define SIM_HTTPD_MAX_HANDLERS  8
+
+/**
+ * @brief Pedidos que atiende la tarea del servidor
+ */
+typedef enum {
+    ITEM_OPEN = 0,      ///< Conexión nueva con su solicitud
+    ITEM_WS_MSG,        ///< Mensaje de texto de un cliente WebSocket
+    ITEM_CLOSE,         ///< El cliente cerró
+    ITEM_WORK,          ///< httpd_queue_work()
+    ITEM_STOP,          ///< httpd_stop()
+} item_type_t;
+
+typedef struct {
+    uint8_t type;
+    int conn;
+    uint32_t gen;
+    httpd_work_fn_t fn;
+    void *arg;
+    char text[SIM_WS_MSG_MAX];
+} httpd_item_t;
+
+/**
+ * @brief Conexión: la sesión del servidor y lo que ve el cliente
+ */
+typedef struct {
+    sim_conn_stats_t st;
+    uint32_t gen;               ///< Cambia al reutilizar el lugar (descarta pedidos viejos)
+    bool session;               ///< El servidor tiene la sesión abierta
+    bool ws;                    ///< Handshake WebSocket hecho
+    bool peer_closed;           ///< El cliente cerró su lado
+    bool async;                 ///< Hay una solicitud asíncrona en curso
+    bool log_requested;         ///< El cliente pidió el log alguna vez
+    uint32_t link_kbps;
+    int64_t tx_free_us;         ///< Cuándo termina el enlace de llevar lo ya enviado
+    int64_t last_status_us;     ///< Llegada de la última difusión de estado
+    char uri[HTTPD_MAX_URI_LEN + 1];
+} conn_t;
+
+/**
+ * @brief Estado privado de una solicitud (httpd_req_t::aux)
+ */
+typedef struct {
+    int conn;
+    uint32_t gen;
+    const char *msg;            ///< Mensaje WebSocket en curso, o NULL
+    size_t msg_len;
+    bool headers_sent;
+} req_aux_t;
+
+/**
+ * @brief Solicitud asíncrona: la copia que sobrevive al manejador
+ */
+typedef struct {
+    httpd_req_t req;
+    req_aux_t aux;
+} async_req_t;
+
+static struct {
+    bool running;
+    httpd_config_t config;
+    httpd_uri_t handlers[SIM_HTTPD_MAX_HANDLERS];
+    size_t handler_count;
+    QueueHandle_t items;
+    StaticQueue_t items_buffer;
+    uint8_t items_storage[SIM_HTTPD_QUEUE_LEN * sizeof(httpd_item_t)];
+    uint32_t open;
+} s_srv;
+
+static conn_t s_conns[SIM_NET_MAX_CONNS];
+static sim_net_stats_t s_stats;
+
+// ───────────────────────────────────────────────────────
+// Enlace
+
+static conn_t *conn_alive(int idx, uint32_t gen)
+{
+    if (idx < 0 || idx >= SIM_NET_MAX_CONNS) {
+        return NULL;
+    }
+    conn_t *c = &s_conns[idx];
+    return c->gen == gen && c->session && !c->peer_closed ? c : NULL;
+}
+
+/**
+ * @brief Anota en el cliente un mensaje WebSocket que llega en `arrival_us`
+ */
+static void note_ws_frame(conn_t *c, const httpd_ws_frame_t *frame, int64_t arrival_us)
+{
+    c->st.frames++;
+    const char *text = (const char *)frame->payload;
+    if (frame->type != HTTPD_WS_TYPE_TEXT || text == NULL) {
+        return;
+    }
+    if (frame->len >= 16 && strncmp(text, "{\"type\":\"status\"", 16) == 0) {
+        if (c->st.status_frames > 0 && arrival_us - c->last_status_us > c->st.status_gap_max_us) {
+            c->st.status_gap_max_us = (uint32_t)(arrival_us - c->last_status_us);
+        }
+        c->last_status_us = arrival_us;
+        c->st.status_frames++;
+    } else if (!c->log_requested && text[0] != '{' && strncmp(text, "log:", 4) != 0) {
+        c->st.unsolicited++;
+    }
+}
+
+/**
+ * @brief Envía `len` bytes por el enlace de la conexión, bloqueando mientras el búfer esté lleno
+ * @param frame Mensaje WebSocket a anotar en el cliente, o NULL
+ */
+static esp_err_t link_send(int idx, uint32_t gen, size_t len, const httpd_ws_frame_t *frame)
+{
+    const int64_t start_us = hal_clock_mono_us();
+    const int64_t timeout_us = (int64_t)s_srv.config.send_wait_timeout * 1000000;
+    size_t left = len;
+    while (left > 0) {
+        conn_t *c = conn_alive(idx, gen);
+        if (c == NULL) {
+            return ESP_FAIL;
+        }
+        const double bytes_per_us = c->link_kbps * 1000.0 / 8.0 / 1e6;
+        const int64_t now = hal_clock_mono_us();
+        if (c->tx_free_us < now) {
+            c->tx_free_us = now;
+        }
+        const size_t piece = left < SIM_NET_SNDBUF ? left : SIM_NET_SNDBUF;
+        const double queued = (double)(c->tx_free_us - now) * bytes_per_us;
+        const double excess = queued + (double)piece - SIM_NET_SNDBUF;
+        if (excess > 0.0) {
+            const int64_t wait_us = (int64_t)ceil(excess / bytes_per_us);
+            if (now + wait_us - start_us > timeout_us) {
+                hal_host_sleep_us(start_us + timeout_us - now);
+                s_stats.send_timeouts++;
+                return ESP_FAIL;
+            }
+            hal_host_sleep_us(wait_us);
+            continue;   // La conexión pudo cerrarse mientras tanto
+        }
+        c->tx_free_us += (int64_t)ceil((double)piece / bytes_per_us);
+        left -= piece;
+    }
+
+    conn_t *c = &s_conns[idx];
+    const int64_t blocked_us = hal_clock_mono_us() - start_us;
+    if (blocked_us > s_stats.send_block_max_us) {
+        s_stats.send_block_max_us = (uint32_t)blocked_us;
+    }
+    const int64_t arrival_us = c->tx_free_us + SIM_NET_ONE_WAY_US;
+    if (arrival_us - start_us > c->st.latency_max_us) {
+        c->st.latency_max_us = (uint32_t)(arrival_us - start_us);
+    }
+    c->st.bytes += len;
+    if (frame != NULL) {
+        note_ws_frame(c, frame, arrival_us);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t ws_send(int idx, uint32_t gen, const httpd_ws_frame_t *frame)
+{
+    const size_t header = frame->len < 126 ? 2 : 4;
+    return link_send(idx, gen, header + frame->len, frame);
+}
+
+// ───────────────────────────────────────────────────────
+// Sesiones
+
+static void session_close(conn_t *c, bool error)
+{
+    if (c->session) {
+        c->session = false;
+        s_srv.open--;
+        if (error && !c->peer_closed) {
+            c->st.closed_by_server = true;
+            s_stats.closed_by_server++;
+        }
+    }
+    c->ws = false;
+    c->async = false;
+    c->st.state = SIM_CONN_CLOSED;
+}
+
+static const httpd_uri_t *find_handler(const char *uri)
+{
+    const size_t path_len = strcspn(uri, "?");
+    for (size_t i = 0; i < s_srv.handler_count; i++) {
+        const httpd_uri_t *h = &s_srv.handlers[i];
+        if (h->method == HTTP_GET && strlen(h->uri) == path_len && strncmp(h->uri, uri, path_len) == 0) {
+            return h;
+        }
+    }
+    return NULL;
+}
+
+static void req_init(httpd_req_t *req, req_aux_t *aux, int idx, int method, const httpd_uri_t *h)
+{
+    memset(req, 0, sizeof(*req));
+    memset(aux, 0, sizeof(*aux));
+    aux->conn = idx;
+    aux->gen = s_conns[idx].gen;
+    req->handle = &s_srv;
+    req->method = method;
+    memcpy((char *)req->uri, s_conns[idx].uri, sizeof(req->uri));
+    req->aux = aux;
+    req->user_ctx = h->user_ctx;
+}
+
+static void handle_open(int idx)
+{
+    conn_t *c = &s_conns[idx];
+    if (c->peer_closed) {
+        c->st.state = SIM_CONN_CLOSED;
+        return;
+    }
+    if (s_srv.open >= s_srv.config.max_open_sockets) {
+        c->st.rejected = true;
+        c->st.state = SIM_CONN_CLOSED;
+        s_stats.rejected++;
+        return;
+    }
+    c->session = true;
+    c->tx_free_us = hal_clock_mono_us();
+    s_srv.open++;
+    s_stats.accepted++;
+    if (s_srv.open > s_stats.open_max) {
+        s_stats.open_max = s_srv.open;
+    }
+
+    httpd_req_t req;
+    req_aux_t aux;
+    const httpd_uri_t *h = find_handler(c->uri);
+    if (h == NULL) {
+        c->st.state = SIM_CONN_HTTP;
+        req_init(&req, &aux, idx, HTTP_GET, &(httpd_uri_t){ 0 });
+        httpd_resp_send_err(&req, HTTPD_404_NOT_FOUND, "Not found");
+        session_close(c, false);
+        return;
+    }
+    req_init(&req, &aux, idx, HTTP_GET, h);
+    if (h->is_websocket) {
+        if (link_send(idx, aux.gen, SIM_WS_HANDSHAKE_BYTES, NULL) != ESP_OK || h->handler(&req) != ESP_OK) {
+            session_close(c, true);
+            return;
+        }
+        c->ws = true;
+        c->st.state = SIM_CONN_WS;
+        return;
+    }
+    c->st.state = SIM_CONN_HTTP;
+    s_stats.requests++;
+    const esp_err_t ret = h->handler(&req);
+    if (ret != ESP_OK) {
+        session_close(c, true);
+    } else if (!c->async) {
+        session_close(c, false);    // Respuesta completa; el cliente no reutiliza la conexión
+    }
+}
+
+static void handle_ws_msg(int idx, uint32_t gen, const char *text)
+{
+    conn_t *c = conn_alive(idx, gen);
+    if (c == NULL || !c->ws) {
+        return;
+    }
+    const httpd_uri_t *h = find_handler(c->uri);
+    if (h == NULL) {
+        return;
+    }
+    s_stats.ws_messages++;
+    httpd_req_t req;
+    req_aux_t aux;
+    req_init(&req, &aux, idx, HTTP_DELETE, h);     // Método 0: mensaje, no handshake
+    aux.msg = text;
+    aux.msg_len = strlen(text);
+    if (h->handler(&req) != ESP_OK && conn_alive(idx, gen) != NULL) {
+        session_close(c, true);
+    }
+}
+
+static void httpd_sim_task(void *arg)
+{
+    (void)arg;
+    httpd_item_t item;
+    for (;;) {
+        if (xQueueReceive(s_srv.items, &item, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        conn_t *c = item.conn >= 0 ? &s_conns[item.conn] : NULL;
+        switch (item.type) {
+        case ITEM_OPEN:
+            if (c->gen == item.gen && c->st.state == SIM_CONN_CONNECTING) {
+                handle_open(item.conn);
+            }
+            break;
+        case ITEM_WS_MSG:
+            handle_ws_msg(item.conn, item.gen, item.text);
+            break;
+        case ITEM_CLOSE:
+            if (c->gen == item.gen) {
+                session_close(c, false);
+            }
+            break;
+        case ITEM_WORK:
+            s_stats.works++;
+            item.fn(item.arg);
+            break;
+        case ITEM_STOP:
+            for (int i = 0; i < SIM_NET_MAX_CONNS; i++) {
+                if (s_conns[i].session) {
+                    session_close(&s_conns[i], true);
+                }
+            }
+            s_srv.running = false;
+            vTaskDelete(NULL);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+static esp_err_t post_item(const httpd_item_t *item)
+{
+    if (xQueueSend(s_srv.items, item, 0) != pdTRUE) {
+        s_stats.queue_full++;
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+// ───────────────────────────────────────────────────────
+// API de esp_http_server
+
+esp_err_t httpd_start(httpd_handle_t *handle, const httpd_config_t *config)
+{
+    if (handle == NULL || config == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_srv.running) {
+        return ESP_ERR_HTTPD_TASK;     // Un solo servidor, como el firmware
+    }
+    s_srv.config = *config;
+    s_srv.handler_count = 0;
+    s_srv.open = 0;
+    if (s_srv.items == NULL) {
+        s_srv.items = xQueueCreateStatic(SIM_HTTPD_QUEUE_LEN, sizeof(httpd_item_t), s_srv.items_storage,
+                                         &s_srv.items_buffer);
+    }
+    s_srv.running = true;
+    if (xTaskCreate(httpd_sim_task, "httpd", config->stack_size, NULL, config->task_priority, NULL) != pdPASS) {
+        s_srv.running = false;
+        return ESP_ERR_HTTPD_TASK;
+    }
+    *handle = &s_srv;
+    return ESP_OK;
+}
+
+esp_err_t httpd_stop(httpd_handle_t handle)
+{
+    if (handle != &s_srv || !s_srv.running) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const httpd_item_t item = { .type = ITEM_STOP, .conn = -1 };
+    return post_item(&item);
+}
+
+esp_err_t httpd_register_uri_handler(httpd_handle_t handle, const httpd_uri_t *uri_handler)
+{
+    if (handle != &s_srv || uri_handler == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_srv.handler_count >= s_srv.config.max_uri_handlers ||
+        s_srv.handler_count >= SIM_HTTPD_MAX_HANDLERS) {
+        return ESP_ERR_HTTPD_HANDLERS_FULL;
+    }
+    s_srv.handlers[s_srv.handler_count++] = *uri_handler;
+    return ESP_OK;
+}
+
+esp_err_t httpd_queue_work(httpd_handle_t handle, httpd_work_fn_t work, void *arg)
+{
+    if (handle != &s_srv || !s_srv.running || work == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const httpd_item_t item = { .type = ITEM_WORK, .conn = -1, .fn = work, .arg = arg };
+    return post_item(&item);
+}
+
+esp_err_t httpd_get_client_list(httpd_handle_t handle, size_t *fds, int *client_fds)
+{
+    if (handle != &s_srv || fds == NULL || client_fds == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    size_t n = 0;
+    for (int i = 0; i < SIM_NET_MAX_CONNS; i++) {
+        if (s_conns[i].session) {
+            if (n == *fds) {
+                return ESP_ERR_INVALID_ARG;
+            }
+            client_fds[n++] = SIM_NET_FD_BASE + i;
+        }
+    }
+    *fds = n;
+    return ESP_OK;
+}
+
+int httpd_req_to_sockfd(httpd_req_t *req)
+{
+    const req_aux_t *aux = req->aux;
+    return SIM_NET_FD_BASE + aux->conn;
+}
+
+httpd_ws_client_info_t httpd_ws_get_fd_info(httpd_handle_t handle, int fd)
+{
+    const int idx = fd - SIM_NET_FD_BASE;
+    if (handle != &s_srv || idx < 0 || idx >= SIM_NET_MAX_CONNS || !s_conns[idx].session) {
+        return HTTPD_WS_CLIENT_INVALID;
+    }
+    return s_conns[idx].ws ? HTTPD_WS_CLIENT_WEBSOCKET : HTTPD_WS_CLIENT_HTTP;
+}
+
+esp_err_t httpd_req_get_url_query_str(httpd_req_t *req, char *buf, size_t buf_len)
+{
+    const char *q = strchr(req->uri, '?');
+    if (q == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    q++;
+    const size_t len = strlen(q);
+    snprintf(buf, buf_len, "%s", q);
+    return len < buf_len ? ESP_OK : ESP_ERR_HTTPD_RESULT_TRUNC;
+}
+
+esp_err_t httpd_query_key_value(const char *qry, const char *key, char *val, size_t val_size)
+{
+    const size_t key_len = strlen(key);
+    for (const char *p = qry; p != NULL && *p; p = strchr(p, '&') ? strchr(p, '&') + 1 : NULL) {
+        if (strncmp(p, key, key_len) != 0 || p[key_len] != '=') {
+            continue;
+        }
+        const char *v = p + key_len + 1;
+        const size_t len = strcspn(v, "&");
+        const size_t copy = len < val_size ? len : val_size - 1;
+        memcpy(val, v, copy);
+        val[copy] = '\0';
+        return copy == len ? ESP_OK : ESP_ERR_HTTPD_RESULT_TRUNC;
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t httpd_req_async_handler_begin(httpd_req_t *req, httpd_req_t **out)
+{
+    async_req_t *copy = malloc(sizeof(*copy));
+    if (copy == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    memcpy(&copy->req, req, sizeof(*req));
+    copy->aux = *(const req_aux_t *)req->aux;
+    copy->req.aux = &copy->aux;
+    s_conns[copy->aux.conn].async = true;
+    *out = &copy->req;
+    return ESP_OK;
+}
+
+esp_err_t httpd_req_async_handler_complete(httpd_req_t *req)
+{
+    async_req_t *copy = (async_req_t *)req;
+    conn_t *c = &s_conns[copy->aux.conn];
+    if (c->gen == copy->aux.gen && c->session) {
+        session_close(c, false);
+    }
+    free(copy);
+    return ESP_OK;
+}
+
+static esp_err_t resp_headers(httpd_req_t *req, int status)
+{
+    req_aux_t *aux = req->aux;
+    if (aux->headers_sent) {
+        return ESP_OK;
+    }
+    aux->headers_sent = true;
+    if (conn_alive(aux->conn, aux->gen) != NULL) {
+        s_conns[aux->conn].st.http_status = status;
+    }
+    return link_send(aux->conn, aux->gen, SIM_HTTP_HEADER_BYTES, NULL);
+}
+
+esp_err_t httpd_resp_set_type(httpd_req_t *req, const char *type)
+{
+    (void)req;
+    (void)type;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_hdr(httpd_req_t *req, const char *field, const char *value)
+{
+    (void)req;
+    (void)field;
+    (void)value;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_send(httpd_req_t *req, const char *buf, ssize_t buf_len)
+{
+    const req_aux_t *aux = req->aux;
+    const size_t len = buf_len == HTTPD_RESP_USE_STRLEN ? strlen(buf) : (size_t)buf_len;
+    if (resp_headers(req, 200) != ESP_OK || link_send(aux->conn, aux->gen, len, NULL) != ESP_OK) {
+        return ESP_ERR_HTTPD_RESP_SEND;
+    }
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_send_chunk(httpd_req_t *req, const char *buf, ssize_t buf_len)
+{
+    const req_aux_t *aux = req->aux;
+    const size_t len = buf == NULL ? 0 : buf_len == HTTPD_RESP_USE_STRLEN ? strlen(buf) : (size_t)buf_len;
+    // Tamaño en hexadecimal y los dos CRLF del tramo
+    if (resp_headers(req, 200) != ESP_OK || link_send(aux->conn, aux->gen, len + 8, NULL) != ESP_OK) {
+        return ESP_ERR_HTTPD_RESP_SEND;
+    }
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_send_err(httpd_req_t *req, httpd_err_code_t error, const char *msg)
+{
+    static const int codes[] = {
+        [HTTPD_400_BAD_REQUEST] = 400,
+        [HTTPD_404_NOT_FOUND] = 404,
+        [HTTPD_500_INTERNAL_SERVER_ERROR] = 500,
+    };
+    const req_aux_t *aux = req->aux;
+    if (resp_headers(req, codes[error]) != ESP_OK ||
+        link_send(aux->conn, aux->gen, msg != NULL ? strlen(msg) : 0, NULL) != ESP_OK) {
+        return ESP_ERR_HTTPD_RESP_SEND;
+    }
+    return ESP_OK;
+}
+
+esp_err_t httpd_ws_recv_frame(httpd_req_t *req, httpd_ws_frame_t *frame, size_t max_len)
+{
+    const req_aux_t *aux = req->aux;
+    if (aux->msg == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    frame->type = HTTPD_WS_TYPE_TEXT;
+    frame->final = true;
+    frame->fragmented = false;
+    if (max_len == 0) {
+        frame->len = aux->msg_len;
+        return ESP_OK;
+    }
+    if (aux->msg_len > max_len || frame->payload == NULL) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(frame->payload, aux->msg, aux->msg_len);
+    frame->len = aux->msg_len;
+    return ESP_OK;
+}
+
+esp_err_t httpd_ws_send_frame(httpd_req_t *req, httpd_ws_frame_t *frame)
+{
+    const req_aux_t *aux = req->aux;
+    return ws_send(aux->conn, aux->gen, frame);
+}
+
+esp_err_t httpd_ws_send_frame_async(httpd_handle_t handle, int fd, httpd_ws_frame_t *frame)
+{
+    const int idx = fd - SIM_NET_FD_BASE;
+    if (handle != &s_srv || idx < 0 || idx >= SIM_NET_MAX_CONNS || !s_conns[idx].session) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ws_send(idx, s_conns[idx].gen, frame);
+}
+
+// ───────────────────────────────────────────────────────
+// Lado cliente
+
+static int conn_open(const char *uri)
+{
+    if (!s_srv.running) {
+        return -1;
+    }
+    for (int i = 0; i < SIM_NET_MAX_CONNS; i++) {
+        conn_t *c = &s_conns[i];
+        if (c->st.state != SIM_CONN_FREE) {
+            continue;
+        }
+        const uint32_t gen = c->gen + 1;
+        memset(c, 0, sizeof(*c));
+        c->gen = gen;
+        c->st.state = SIM_CONN_CONNECTING;
+        snprintf(c->uri, sizeof(c->uri), "%s", uri);
+        const httpd_item_t item = { .type = ITEM_OPEN, .conn = i, .gen = gen };
+        if (post_item(&item) != ESP_OK) {
+            c->st.rejected = true;
+            c->st.state = SIM_CONN_CLOSED;
+        }
+        return i;
+    }
+    return -1;
+}
+
+int sim_net_ws_open(const char *uri, uint32_t link_kbps)
+{
+    const int idx = conn_open(uri);
+    if (idx >= 0) {
+        s_conns[idx].link_kbps = link_kbps;
+    }
+    return idx;
+}
+
+int sim_net_http_get(const char *uri, uint32_t link_kbps)
+{
+    // Misma conexión que un WebSocket; lo que cambia es el manejador que la atiende
+    return sim_net_ws_open(uri, link_kbps);
+}
+
+esp_err_t sim_net_ws_send(int conn, const char *text)
+{
+    if (conn < 0 || conn >= SIM_NET_MAX_CONNS || s_conns[conn].st.state != SIM_CONN_WS) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    conn_t *c = &s_conns[conn];
+    if (strncmp(text, "log", 3) == 0 && strcmp(text, "log off") != 0) {
+        c->log_requested = true;
+    }
+    httpd_item_t item = { .type = ITEM_WS_MSG, .conn = conn, .gen = c->gen };
+    snprintf(item.text, sizeof(item.text), "%s", text);
+    return post_item(&item);
+}
+
+void sim_net_close(int conn)
+{
+    if (conn < 0 || conn >= SIM_NET_MAX_CONNS) {
+        return;
+    }
+    conn_t *c = &s_conns[conn];
+    if (c->st.state == SIM_CONN_FREE || c->st.state == SIM_CONN_CLOSED) {
+        return;
+    }
+    c->peer_closed = true;
+    const httpd_item_t item = { .type = ITEM_CLOSE, .conn = conn, .gen = c->gen };
+    if (post_item(&item) != ESP_OK) {
+        session_close(c, false);    // El servidor lo notará en el próximo envío
+    }
+}
+
+void sim_net_release(int conn)
+{
+    if (conn >= 0 && conn < SIM_NET_MAX_CONNS && s_conns[conn].st.state == SIM_CONN_CLOSED) {
+        s_conns[conn].st.state = SIM_CONN_FREE;
+    }
+}
+
+bool sim_net_get_conn(int conn, sim_conn_stats_t *out)
+{
+    if (conn < 0 || conn >= SIM_NET_MAX_CONNS || s_conns[conn].st.state == SIM_CONN_FREE) {
+        return false;
+    }
+    *out = s_conns[conn].st;
+    return true;
+}
+
+void sim_net_get_stats(sim_net_stats_t *out)
+{
+    *out = s_stats;
+}
@@ -0,0 +1,11 @@
+/**
+ * @file esp_lcd_touch.h
+ * @brief Tipos del panel táctil para el simulador (sin pantalla: solo el handle opaco).
+ */
+
+#ifndef SIM_ESP_LCD_TOUCH_H
+#define SIM_ESP_LCD_TOUCH_H
+
+typedef struct esp_lcd_touch_s *esp_lcd_touch_handle_t;
+
+#endif // SIM_ESP_LCD_TOUCH_H
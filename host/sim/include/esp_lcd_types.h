@@ -0,0 +1,11 @@
+/**
+ * @file esp_lcd_types.h
+ * @brief Tipos del panel LCD para el simulador (sin pantalla: solo el handle opaco).
+ */
+
+#ifndef SIM_ESP_LCD_TYPES_H
+#define SIM_ESP_LCD_TYPES_H
+
+typedef struct esp_lcd_panel_t *esp_lcd_panel_handle_t;
+
+#endif // SIM_ESP_LCD_TYPES_H
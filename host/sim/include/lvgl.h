@@ -0,0 +1,17 @@
+/**
+ * @file lvgl.h
+ * @brief LVGL para el simulador: la interfaz corre sin pantalla (ui_headless.c).
+ * @details lvgl_port.h y ui_events.h la incluyen; lo que declaran con tipos de LVGL solo usa
+ *          punteros, así que alcanzan los tipos incompletos.
+ */
+
+#ifndef SIM_LVGL_H
+#define SIM_LVGL_H
+
+#include <stdint.h>
+
+typedef int16_t lv_coord_t;
+typedef struct _lv_event_t lv_event_t;
+typedef struct _lv_timer_t lv_timer_t;
+
+#endif // SIM_LVGL_H
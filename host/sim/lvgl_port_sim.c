@@ -0,0 +1,108 @@
+/**
+ * @file lvgl_port_sim.c
+ * @brief Tarea de LVGL del simulador: el lazo de lvgl_port.c sin pantalla ni táctil.
+ * @details Con el mutex tomado corre los hooks (ui_queue) y un lv_timer_handler() que no
+ *          dibuja y pide volver en un periodo de refresco; después espera ese plazo o un
+ *          lvgl_port_wake(). Así la tarea despierta tantas veces como en el equipo y compite
+ *          por la CPU y por la cola de UI igual.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#include "sim.h"
+#include "lvgl_port.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#define LVGL_PORT_TASK_HOOKS_MAX    4
+
+static SemaphoreHandle_t s_mux = NULL;
+static StaticSemaphore_t s_mux_buffer;
+static SemaphoreHandle_t s_wake = NULL;
+static StaticSemaphore_t s_wake_buffer;
+static lvgl_port_task_hook_t s_hooks[LVGL_PORT_TASK_HOOKS_MAX];
+static lvgl_port_stats_t s_stats;
+
+/**
+ * @brief lv_timer_handler() sin objetos que dibujar: solo el temporizador de refresco
+ */
+static uint32_t timer_handler(void)
+{
+    s_stats.frames++;
+    return CONFIG_LV_DISP_DEF_REFR_PERIOD;
+}
+
+static void lvgl_sim_task(void *arg)
+{
+    (void)arg;
+    uint32_t delay_ms = LVGL_PORT_TASK_MAX_DELAY_MS;
+    for (;;) {
+        if (lvgl_port_lock(-1)) {
+            for (int i = 0; i < LVGL_PORT_TASK_HOOKS_MAX && s_hooks[i]; i++) {
+                s_hooks[i]();
+            }
+            delay_ms = timer_handler();
+            s_stats.loops++;
+            lvgl_port_unlock();
+        }
+        if (delay_ms > LVGL_PORT_TASK_MAX_DELAY_MS) {
+            delay_ms = LVGL_PORT_TASK_MAX_DELAY_MS;
+        } else if (delay_ms < LVGL_PORT_TASK_MIN_DELAY_MS) {
+            delay_ms = LVGL_PORT_TASK_MIN_DELAY_MS;
+        }
+        xSemaphoreTake(s_wake, pdMS_TO_TICKS(delay_ms));
+    }
+}
+
+esp_err_t lvgl_port_sim_start(void)
+{
+    if (s_mux != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_mux = xSemaphoreCreateMutexStatic(&s_mux_buffer);
+    s_wake = xSemaphoreCreateBinaryStatic(&s_wake_buffer);
+    if (xTaskCreate(lvgl_sim_task, "lvgl", LVGL_PORT_TASK_STACK_SIZE, NULL, LVGL_PORT_TASK_PRIORITY,
+                    NULL) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+bool lvgl_port_lock(int timeout_ms)
+{
+    const TickType_t ticks = timeout_ms < 0 ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    return xSemaphoreTake(s_mux, ticks) == pdTRUE;
+}
+
+void lvgl_port_unlock(void)
+{
+    xSemaphoreGive(s_mux);
+}
+
+void lvgl_port_wake(void)
+{
+    if (s_wake != NULL) {
+        xSemaphoreGive(s_wake);
+    }
+}
+
+esp_err_t lvgl_port_add_task_hook(lvgl_port_task_hook_t hook)
+{
+    if (hook == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int i = 0; i < LVGL_PORT_TASK_HOOKS_MAX; i++) {
+        if (s_hooks[i] == NULL) {
+            s_hooks[i] = hook;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+void lvgl_port_get_stats(lvgl_port_stats_t *stats)
+{
+    *stats = s_stats;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file plant.c
+ * @brief Modelo térmico del horno para el simulador.
+ * @details La cámara se integra a pedido (cada lectura del sensor o consulta del simulador)
+ *          desde la última vez, con el tiempo de SSR encendido que acumuló el modelo del CH422G
+ *          en ese tramo. Dentro del tramo el calor se reparte parejo en pasos de 1 s como máximo:
+ *          el periodo del SSR es corto frente a la constante de tiempo de la cámara.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#include "sim.h"
+#include "ch422g_model.h"
+#include "modbus_sensor_model.h"
+#include "hal_clock.h"
+#include <math.h>
+
+#define PLANT_STEP_US   1000000
+
+static plant_params_t s_params;
+static float s_chamber_c;
+static float s_probe_c;
+static bool s_door_open;
+static int64_t s_last_us;
+static int64_t s_last_on_us;
+
+plant_params_t plant_default_params(void)
+{
+    return (plant_params_t){
+        .ambient_c = 25.0f,
+        .heater_w = 1500.0f,
+        .capacity_j_per_c = 12000.0f,
+        .loss_w_per_c = 8.0f,
+        .door_loss_w_per_c = 40.0f,
+        .probe_tau_s = 20.0f,
+    };
+}
+
+static void plant_update(void)
+{
+    const int64_t now = hal_clock_mono_us();
+    const int64_t on_us = ch422g_model_ssr_on_us();
+    int64_t span_us = now - s_last_us;
+    if (span_us <= 0) {
+        return;
+    }
+    const float duty = (float)(on_us - s_last_on_us) / (float)span_us;
+    const float loss = s_params.loss_w_per_c + (s_door_open ? s_params.door_loss_w_per_c : 0.0f);
+    while (span_us > 0) {
+        const int64_t step_us = span_us < PLANT_STEP_US ? span_us : PLANT_STEP_US;
+        const float dt = (float)step_us / 1e6f;
+        const float power = duty * s_params.heater_w - loss * (s_chamber_c - s_params.ambient_c);
+        s_chamber_c += power * dt / s_params.capacity_j_per_c;
+        // Sonda: primer orden exacto dentro del paso
+        s_probe_c += (s_chamber_c - s_probe_c) * (1.0f - expf(-dt / s_params.probe_tau_s));
+        span_us -= step_us;
+    }
+    s_last_us = now;
+    s_last_on_us = on_us;
+}
+
+static float probe_source(void *ctx)
+{
+    (void)ctx;
+    return plant_probe_c();
+}
+
+void plant_init(const plant_params_t *params)
+{
+    s_params = params != NULL ? *params : plant_default_params();
+    s_chamber_c = s_params.ambient_c;
+    s_probe_c = s_params.ambient_c;
+    s_door_open = false;
+    s_last_us = hal_clock_mono_us();
+    s_last_on_us = ch422g_model_ssr_on_us();
+    modbus_sensor_model_set_source(probe_source, NULL);
+}
+
+float plant_chamber_c(void)
+{
+    plant_update();
+    return s_chamber_c;
+}
+
+float plant_probe_c(void)
+{
+    plant_update();
+    return s_probe_c;
+}
+
+void plant_set_door(bool open)
+{
+    plant_update();     // El tramo anterior se integra con la puerta como estaba
+    s_door_open = open;
+}
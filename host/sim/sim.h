@@ -0,0 +1,228 @@
+/**
+ * @file sim.h
+ * @brief Piezas del simulador del firmware completo (tripta_sim).
+ * @details El simulador arranca los módulos reales (planificador, bus de eventos, sensor, PID,
+ *          estadísticas, servidor WebSocket, cola de UI) sobre el planificador de FreeRTOS del
+ *          host y el reloj virtual. Lo que en el equipo es hardware o interfaz lo ponen:
+ *          - plant.c: el horno (modelo térmico) que calienta el SSR y lee el sensor Modbus;
+ *          - lvgl_port_sim.c y ui_headless.c: la tarea de LVGL y la interfaz sin pantalla;
+ *          - httpd_sim.c: esp_http_server con clientes virtuales en lugar de sockets;
+ *          - sim_clients.c: la carga de red (clientes WebSocket, /metrics y /logs);
+ *          - sim_boot.c: el arranque, que también usa tripta_bench (host/bench).
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#ifndef SIM_H
+#define SIM_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ───────────────────────────────────────────────────────
+// Arranque
+
+/**
+ * @brief Reinicia el host y arranca los módulos en el orden de app_main() y de sus etapas
+ * @details Solo lo que corre en el host: sin pantalla, WiFi ni consola. El registro va a donde
+ *          lo haya dejado esp_log_set_vprintf() antes de llamarla.
+ * @param seed Semilla del planificador (hal_host_kernel_seed())
+ */
+esp_err_t sim_boot(uint32_t seed);
+
+// ───────────────────────────────────────────────────────
+// Planta
+
+/**
+ * @brief Parámetros del modelo térmico
+ * @details Cámara de primer orden calentada por el SSR, y una sonda que sigue a la cámara con
+ *          su propia constante de tiempo (el retardo que ve el PID).
+ */
+typedef struct {
+    float ambient_c;            ///< Temperatura ambiente y de arranque
+    float heater_w;             ///< Potencia con el SSR encendido
+    float capacity_j_per_c;     ///< Capacidad térmica de la cámara
+    float loss_w_per_c;         ///< Pérdidas con la puerta cerrada
+    float door_loss_w_per_c;    ///< Pérdidas adicionales con la puerta abierta
+    float probe_tau_s;          ///< Constante de tiempo de la sonda
+} plant_params_t;
+
+/**
+ * @brief Parámetros por defecto: 1,5 kW, ~18 min hasta 120 °C, equilibrio a plena potencia ~210 °C
+ */
+plant_params_t plant_default_params(void);
+
+/**
+ * @brief Arranca el modelo en `ambient_c` y lo conecta al sensor Modbus y al CH422G
+ */
+void plant_init(const plant_params_t *params);
+
+/**
+ * @brief Integra hasta el instante actual y devuelve la temperatura de la cámara
+ */
+float plant_chamber_c(void);
+
+/**
+ * @brief Integra hasta el instante actual y devuelve la temperatura que mide la sonda
+ */
+float plant_probe_c(void);
+
+/**
+ * @brief Abre o cierra la puerta (perturbación)
+ */
+void plant_set_door(bool open);
+
+// ───────────────────────────────────────────────────────
+// LVGL e interfaz sin pantalla
+
+/**
+ * @brief Crea el mutex y la tarea de LVGL (misma prioridad y lazo que lvgl_port.c)
+ */
+esp_err_t lvgl_port_sim_start(void);
+
+/**
+ * @brief Contadores de la interfaz sin pantalla
+ */
+typedef struct {
+    uint32_t events;            ///< Eventos recibidos del bus
+    uint32_t refreshes;         ///< Volcados ejecutados en la tarea de LVGL
+    uint32_t post_failures;     ///< Volcados que no entraron en la cola de UI
+    uint32_t sample_to_screen_max_us;   ///< Publicación de una muestra → volcado, máximo
+    uint64_t sample_to_screen_sum_us;
+    uint32_t samples_shown;     ///< Muestras con latencia medida
+    char label[64];             ///< Último texto de la etiqueta de estado
+} ui_headless_stats_t;
+
+/**
+ * @brief Suscribe la interfaz al bus, como ui_events_init()
+ */
+esp_err_t ui_headless_init(void);
+
+void ui_headless_get_stats(ui_headless_stats_t *out);
+
+// ───────────────────────────────────────────────────────
+// Red
+
+/**
+ * @brief Estado de una conexión virtual
+ */
+typedef enum {
+    SIM_CONN_FREE = 0,
+    SIM_CONN_CONNECTING,        ///< Esperando que la tarea httpd la acepte
+    SIM_CONN_HTTP,              ///< Solicitud HTTP en curso
+    SIM_CONN_WS,                ///< WebSocket abierto
+    SIM_CONN_CLOSED,            ///< Cerrada (por el cliente, el servidor o un rechazo)
+} sim_conn_state_t;
+
+/**
+ * @brief Contadores de una conexión (lado cliente)
+ */
+typedef struct {
+    sim_conn_state_t state;
+    uint32_t frames;            ///< Mensajes WebSocket recibidos
+    uint32_t status_frames;     ///< De ellos, difusiones de estado
+    uint64_t bytes;             ///< Bytes recibidos
+    uint32_t latency_max_us;    ///< Envío → llegada al cliente, máximo
+    uint32_t status_gap_max_us; ///< Mayor separación entre dos difusiones de estado
+    uint32_t unsolicited;       ///< Líneas de log recibidas sin haberlas pedido
+    int http_status;            ///< Código de la respuesta HTTP (0 si no hubo)
+    bool rejected;              ///< El servidor no la aceptó (sin lugar)
+    bool closed_by_server;
+} sim_conn_stats_t;
+
+/**
+ * @brief Contadores del servidor virtual
+ */
+typedef struct {
+    uint32_t accepted;
+    uint32_t rejected;          ///< Conexiones sin lugar (max_open_sockets)
+    uint32_t requests;          ///< Solicitudes HTTP atendidas
+    uint32_t ws_messages;       ///< Mensajes WebSocket recibidos
+    uint32_t works;             ///< Trabajos de httpd_queue_work()
+    uint32_t queue_full;        ///< Pedidos perdidos con la cola de la tarea llena
+    uint32_t send_timeouts;     ///< Envíos que superaron send_wait_timeout
+    uint32_t closed_by_server;  ///< Cierres por error del manejador o del envío
+    uint32_t open_max;          ///< Conexiones abiertas a la vez, máximo
+    uint32_t send_block_max_us; ///< Mayor bloqueo de un envío (búfer del socket lleno)
+} sim_net_stats_t;
+
+/**
+ * @brief Abre un WebSocket a `uri`
+ * @param link_kbps Velocidad del enlace del cliente
+ * @return Identificador de la conexión, o -1 si el servidor no corre o no hay lugar en la tabla
+ */
+int sim_net_ws_open(const char *uri, uint32_t link_kbps);
+
+/**
+ * @brief Pide `uri` (con su consulta) por una conexión HTTP nueva
+ * @return Identificador de la conexión, o -1
+ */
+int sim_net_http_get(const char *uri, uint32_t link_kbps);
+
+/**
+ * @brief Envía un mensaje de texto por un WebSocket abierto
+ */
+esp_err_t sim_net_ws_send(int conn, const char *text);
+
+/**
+ * @brief Cierra la conexión desde el cliente
+ */
+void sim_net_close(int conn);
+
+/**
+ * @brief Libera una conexión cerrada para volver a usar su lugar en la tabla
+ */
+void sim_net_release(int conn);
+
+bool sim_net_get_conn(int conn, sim_conn_stats_t *out);
+void sim_net_get_stats(sim_net_stats_t *out);
+
+// ───────────────────────────────────────────────────────
+// Carga de red
+
+/**
+ * @brief Perfil de la carga
+ */
+typedef struct {
+    uint32_t ws_clients;        ///< Clientes WebSocket (se reconectan si los cierran)
+    uint32_t log_clients;       ///< De ellos, suscritos al log remoto ("log *:I")
+    uint32_t http_streams;      ///< Flujos GET /logs abiertos todo el tiempo
+    uint32_t metrics_period_ms; ///< Cada cliente pide /metrics con este periodo (0: nunca)
+    uint32_t link_kbps;         ///< Velocidad del enlace de cada cliente
+    uint32_t slow_clients;      ///< Clientes WebSocket con un enlace de 8 kbit/s
+} sim_load_t;
+
+/**
+ * @brief Crea la tarea que genera la carga
+ */
+esp_err_t sim_clients_start(const sim_load_t *load);
+
+/**
+ * @brief Resumen de los clientes
+ */
+typedef struct {
+    uint32_t connects;          ///< Aperturas de WebSocket intentadas
+    uint32_t reconnects;        ///< De ellas, tras un cierre o un rechazo
+    uint32_t metrics_ok;        ///< Respuestas 200 de /metrics
+    uint32_t metrics_failed;    ///< Pedidos de /metrics rechazados o con error
+    uint64_t frames;            ///< Mensajes WebSocket recibidos por todos
+    uint64_t bytes;
+    uint32_t latency_max_us;    ///< Envío → llegada, peor cliente
+    uint32_t status_gap_max_us; ///< Mayor hueco entre difusiones, peor cliente rápido
+    uint32_t unsolicited;       ///< Líneas de log que llegaron a quien no las pidió
+} sim_clients_stats_t;
+
+void sim_clients_get_stats(sim_clients_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_H
@@ -0,0 +1,59 @@
+/**
+ * @file sim_boot.c
+ * @brief Arranque del firmware en el host, compartido por tripta_sim y tripta_bench.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#include "sim.h"
+#include "hal_host.h"
+#include "hal_nvs.h"
+#include "ch422g_model.h"
+#include "modbus_sensor_model.h"
+#include "config_store.h"
+#include "timebase.h"
+#include "scheduler.h"
+#include "event_bus.h"
+#include "log_tap.h"
+#include "sensor.h"
+#include "pid_controller.h"
+#include "statistics.h"
+#include "ui_queue.h"
+#include "ws_server.h"
+
+#define SIM_SETPOINT_MAX_C  200.0f  ///< Tope de setpoint del simulador (pid.sp_max)
+
+esp_err_t sim_boot(uint32_t seed)
+{
+    hal_host_reset();
+    hal_host_kernel_seed(seed);
+    ESP_ERROR_CHECK(log_tap_init());
+
+    ESP_ERROR_CHECK(sched_init());
+    ESP_ERROR_CHECK(evbus_init());
+
+    // nvs, i2c
+    ESP_ERROR_CHECK(hal_nvs_init());
+    ESP_ERROR_CHECK(cfg_init());
+    // La planta simulada es un horno de 180 °C (escenarios de tripta_golden), más que el arco de la pantalla
+    ESP_ERROR_CHECK(cfg_set_float(CFG_PID_SETPOINT_MAX, SIM_SETPOINT_MAX_C));
+    ESP_ERROR_CHECK(timebase_init());
+    ESP_ERROR_CHECK(ch422g_model_attach());
+    modbus_sensor_model_attach(1);
+    plant_init(NULL);
+
+    // ui (sin pantalla)
+    ESP_ERROR_CHECK(lvgl_port_sim_start());
+    ESP_ERROR_CHECK(ui_queue_init());
+    ESP_ERROR_CHECK(ui_headless_init());
+
+    // sensor, control
+    start_temperature_task();
+    pid_controller_init(0.0f);
+
+    // wifi, statistics
+    ESP_ERROR_CHECK(ws_server_init());
+    ESP_ERROR_CHECK(statistics_init());
+    return ESP_OK;
+}
@@ -0,0 +1,172 @@
+/**
+ * @file sim_clients.c
+ * @brief Carga de red del simulador: clientes WebSocket, /metrics y flujos de /logs.
+ * @details Una tarea revisa a los clientes cada SIM_CLIENTS_TICK_MS. Cada cliente WebSocket
+ *          se conecta (escalonado al arrancar), pide el log si le toca y vuelve a conectarse
+ *          SIM_CLIENTS_BACKOFF_MS después de un cierre o un rechazo; además pide /metrics con su
+ *          periodo por una conexión aparte. La tarea tiene la prioridad de la de lwIP (tcpip),
+ *          que es la que entrega los paquetes en el equipo.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#include "sim.h"
+#include "hal_clock.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <string.h>
+
+#define SIM_CLIENTS_MAX         16
+#define SIM_CLIENTS_TICK_MS     50
+#define SIM_CLIENTS_BACKOFF_MS  2000
+#define SIM_CLIENTS_STAGGER_MS  137     ///< Separación entre las primeras conexiones
+#define SIM_CLIENTS_PRIORITY    18      ///< La de la tarea tcpip de ESP-IDF
+#define SIM_CLIENTS_SLOW_KBPS   8
+
+typedef struct {
+    int ws;                     ///< Conexión WebSocket, o -1
+    int metrics;                ///< Pedido de /metrics en curso, o -1
+    int stream;                 ///< Flujo GET /logs, o -1
+    bool wants_log;
+    bool wants_stream;
+    bool log_sent;
+    bool opened_once;
+    uint32_t link_kbps;
+    int64_t next_open_us;
+    int64_t next_metrics_us;
+} client_t;
+
+static sim_load_t s_load;
+static client_t s_clients[SIM_CLIENTS_MAX];
+static size_t s_client_count;
+static sim_clients_stats_t s_done;      ///< Lo de las conexiones ya liberadas
+
+/**
+ * @brief Suma los contadores de una conexión a `acc`
+ */
+static void fold(sim_clients_stats_t *acc, const sim_conn_stats_t *st, bool fast)
+{
+    acc->frames += st->frames;
+    acc->bytes += st->bytes;
+    acc->unsolicited += st->unsolicited;
+    if (st->latency_max_us > acc->latency_max_us) {
+        acc->latency_max_us = st->latency_max_us;
+    }
+    if (fast && st->status_gap_max_us > acc->status_gap_max_us) {
+        acc->status_gap_max_us = st->status_gap_max_us;
+    }
+}
+
+/**
+ * @brief Si la conexión terminó, la cuenta y libera su lugar
+ * @return true si `*conn` quedó libre (-1)
+ */
+static bool reap(int *conn, bool fast, sim_conn_stats_t *last)
+{
+    if (*conn < 0) {
+        return true;
+    }
+    sim_conn_stats_t st;
+    if (!sim_net_get_conn(*conn, &st) || st.state != SIM_CONN_CLOSED) {
+        return false;
+    }
+    fold(&s_done, &st, fast);
+    if (last != NULL) {
+        *last = st;
+    }
+    sim_net_release(*conn);
+    *conn = -1;
+    return true;
+}
+
+static void client_step(client_t *cl, int64_t now)
+{
+    const bool fast = cl->link_kbps == s_load.link_kbps;
+
+    if (cl->ws >= 0 && reap(&cl->ws, fast, NULL)) {
+        cl->next_open_us = now + SIM_CLIENTS_BACKOFF_MS * 1000LL;
+    }
+    if (cl->ws < 0 && now >= cl->next_open_us) {
+        cl->ws = sim_net_ws_open("/ws", cl->link_kbps);
+        if (cl->ws < 0) {
+            cl->next_open_us = now + SIM_CLIENTS_BACKOFF_MS * 1000LL;  // Servidor aún sin arrancar
+        } else {
+            s_done.connects++;
+            s_done.reconnects += cl->opened_once;
+            cl->opened_once = true;
+            cl->log_sent = false;
+        }
+    } else if (cl->ws >= 0 && cl->wants_log && !cl->log_sent) {
+        sim_conn_stats_t st;
+        if (sim_net_get_conn(cl->ws, &st) && st.state == SIM_CONN_WS) {
+            cl->log_sent = sim_net_ws_send(cl->ws, "log *:I") == ESP_OK;
+        }
+    }
+
+    sim_conn_stats_t last;
+    if (cl->metrics >= 0 && reap(&cl->metrics, false, &last)) {
+        if (last.http_status == 200) {
+            s_done.metrics_ok++;
+        } else {
+            s_done.metrics_failed++;
+        }
+    }
+    if (cl->metrics < 0 && s_load.metrics_period_ms > 0 && now >= cl->next_metrics_us) {
+        cl->metrics = sim_net_http_get("/metrics", cl->link_kbps);
+        cl->next_metrics_us += s_load.metrics_period_ms * 1000LL;
+    }
+
+    if (cl->wants_stream && reap(&cl->stream, false, NULL)) {
+        cl->stream = sim_net_http_get("/logs?filter=*:I", cl->link_kbps);
+    }
+}
+
+static void sim_clients_task(void *arg)
+{
+    (void)arg;
+    for (;;) {
+        const int64_t now = hal_clock_mono_us();
+        for (size_t i = 0; i < s_client_count; i++) {
+            client_step(&s_clients[i], now);
+        }
+        vTaskDelay(pdMS_TO_TICKS(SIM_CLIENTS_TICK_MS));
+    }
+}
+
+esp_err_t sim_clients_start(const sim_load_t *load)
+{
+    const uint32_t count = load->ws_clients > load->http_streams ? load->ws_clients : load->http_streams;
+    if (count > SIM_CLIENTS_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_load = *load;
+    s_client_count = count;
+    const int64_t now = hal_clock_mono_us();
+    for (uint32_t i = 0; i < count; i++) {
+        client_t *cl = &s_clients[i];
+        *cl = (client_t){ .ws = -1, .metrics = -1, .stream = -1 };
+        cl->link_kbps = i < load->slow_clients ? SIM_CLIENTS_SLOW_KBPS : load->link_kbps;
+        cl->wants_log = i < load->log_clients;
+        cl->wants_stream = i < load->http_streams;
+        cl->next_open_us = i < load->ws_clients ? now + i * SIM_CLIENTS_STAGGER_MS * 1000LL : INT64_MAX;
+        cl->next_metrics_us = i < load->ws_clients ? now + (i + 1) * SIM_CLIENTS_STAGGER_MS * 1000LL : INT64_MAX;
+    }
+    return xTaskCreate(sim_clients_task, "NetLoad", 4096, NULL, SIM_CLIENTS_PRIORITY, NULL) == pdPASS
+           ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+void sim_clients_get_stats(sim_clients_stats_t *out)
+{
+    *out = s_done;
+    for (size_t i = 0; i < s_client_count; i++) {
+        const client_t *cl = &s_clients[i];
+        const int conns[] = { cl->ws, cl->metrics, cl->stream };
+        for (size_t k = 0; k < 3; k++) {
+            sim_conn_stats_t st;
+            if (conns[k] >= 0 && sim_net_get_conn(conns[k], &st)) {
+                fold(out, &st, k == 0 && cl->link_kbps == s_load.link_kbps);
+            }
+        }
+    }
+}
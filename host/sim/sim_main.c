@@ -0,0 +1,404 @@
+/**
+ * @file sim_main.c
+ * @brief tripta_sim: el firmware completo sobre el reloj virtual, con planta, interfaz y red simuladas.
+ * @details Arranca los mismos módulos y en el mismo orden que app_main() (sin pantalla, WiFi ni
+ *          consola), fija un setpoint, y deja correr el sistema las horas pedidas de tiempo
+ *          virtual con la carga de red indicada. Al final imprime un informe: planificación por
+ *          tarea, trabajos y plazos, bus de eventos, órdenes del PID, interfaz, red y la calidad
+ *          del control. Devuelve distinto de cero si hubo un bloqueo mutuo o eventos perdidos.
+ *
+ *          Uso: tripta_sim [--hours H] [--clients N] [--log-clients N] [--streams N]
+ *                          [--metrics-ms MS] [--link-kbps K] [--slow N] [--setpoint C]
+ *                          [--door MIN:SEG]... [--sensor-dropout MIN:SEG] [--seed S] [--verbose]
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#include "sim.h"
+#include "hal_host.h"
+#include "hal_clock.h"
+#include "ch422g_model.h"
+#include "modbus_sensor_model.h"
+#include "scheduler.h"
+#include "event_bus.h"
+#include "deadline.h"
+#include "log_tap.h"
+#include "pid_controller.h"
+#include "lvgl_port.h"
+#include "wifi_manager.h"
+#include "esp_log.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define SIM_MAX_EVENTS      8
+#define SIM_REPORT_ROWS     32
+#define SIM_SETTLE_BAND_C   1.0f    ///< Banda que cuenta como "en el setpoint"
+
+/**
+ * @brief Perturbación programada: puerta abierta o sensor mudo
+ */
+typedef struct {
+    int64_t at_us;
+    int64_t len_us;
+    bool sensor;        ///< true: falla del sensor; false: puerta
+} sim_event_t;
+
+typedef struct {
+    double hours;
+    float setpoint_c;
+    uint32_t seed;
+    bool verbose;
+    sim_load_t load;
+    sim_event_t events[SIM_MAX_EVENTS];
+    size_t event_count;
+} sim_opts_t;
+
+/**
+ * @brief Calidad del control, medida en la cámara cada segundo
+ */
+typedef struct {
+    int64_t reach_us;           ///< Primera vez dentro de la banda (-1: nunca)
+    float overshoot_c;          ///< Máximo por encima del setpoint
+    float band_min_c;           ///< Mínimo tras llegar y fuera de perturbaciones
+    float band_max_c;
+    float disturb_dev_c;        ///< Mayor desvío durante una perturbación y su recuperación
+    double duty_sum;
+    uint32_t samples;
+} sim_kpi_t;
+
+static FILE *s_report = NULL;
+static bool s_verbose = false;
+
+static int quiet_vprintf(const char *format, va_list args)
+{
+    return s_verbose ? vfprintf(stderr, format, args) : 0;
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "uso: tripta_sim [--hours H] [--clients N] [--log-clients N] [--streams N] [--metrics-ms MS]\n"
+            "                [--link-kbps K] [--slow N] [--setpoint C] [--door MIN:SEG]...\n"
+            "                [--sensor-dropout MIN:SEG] [--seed S] [--verbose]\n");
+}
+
+static bool parse_event(const char *arg, bool sensor, sim_opts_t *o)
+{
+    double at_min = 0;
+    double len_s = 0;
+    if (o->event_count >= SIM_MAX_EVENTS || sscanf(arg, "%lf:%lf", &at_min, &len_s) != 2 || len_s <= 0) {
+        return false;
+    }
+    o->events[o->event_count++] = (sim_event_t){
+        .at_us = (int64_t)(at_min * 60e6), .len_us = (int64_t)(len_s * 1e6), .sensor = sensor,
+    };
+    return true;
+}
+
+static bool parse_args(int argc, char **argv, sim_opts_t *o)
+{
+    *o = (sim_opts_t){
+        .hours = 2.0,
+        .setpoint_c = 120.0f,
+        .load = { .ws_clients = 4, .log_clients = 1, .metrics_period_ms = 10000, .link_kbps = 2000 },
+    };
+    for (int i = 1; i < argc; i++) {
+        const char *opt = argv[i];
+        const char *val = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(opt, "--verbose") == 0) {
+            o->verbose = true;
+            continue;
+        }
+        if (val == NULL) {
+            return false;
+        }
+        i++;
+        if (strcmp(opt, "--hours") == 0) {
+            o->hours = atof(val);
+        } else if (strcmp(opt, "--clients") == 0) {
+            o->load.ws_clients = (uint32_t)atoi(val);
+        } else if (strcmp(opt, "--log-clients") == 0) {
+            o->load.log_clients = (uint32_t)atoi(val);
+        } else if (strcmp(opt, "--streams") == 0) {
+            o->load.http_streams = (uint32_t)atoi(val);
+        } else if (strcmp(opt, "--metrics-ms") == 0) {
+            o->load.metrics_period_ms = (uint32_t)atoi(val);
+        } else if (strcmp(opt, "--link-kbps") == 0) {
+            o->load.link_kbps = (uint32_t)atoi(val);
+        } else if (strcmp(opt, "--slow") == 0) {
+            o->load.slow_clients = (uint32_t)atoi(val);
+        } else if (strcmp(opt, "--setpoint") == 0) {
+            o->setpoint_c = (float)atof(val);
+        } else if (strcmp(opt, "--seed") == 0) {
+            o->seed = (uint32_t)strtoul(val, NULL, 0);
+        } else if (strcmp(opt, "--door") == 0 || strcmp(opt, "--sensor-dropout") == 0) {
+            if (!parse_event(val, opt[2] == 's', o)) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+    return o->hours > 0 && o->load.link_kbps > 0 && o->load.log_clients <= o->load.ws_clients &&
+           o->load.slow_clients <= o->load.ws_clients;
+}
+
+/**
+ * @brief Lo que haría wifi_manager al conectarse
+ */
+static void sim_publish_connected(void)
+{
+    evbus_event_t ev = { .type = EVBUS_NET_STATE, .net = { .state = WIFI_MANAGER_STATE_CONNECTED } };
+    evbus_publish(&ev);
+}
+
+static bool event_active(const sim_opts_t *o, int64_t now, bool sensor, int64_t recovery_us)
+{
+    for (size_t i = 0; i < o->event_count; i++) {
+        const sim_event_t *e = &o->events[i];
+        if (e->sensor == sensor && now >= e->at_us && now < e->at_us + e->len_us + recovery_us) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void kpi_sample(sim_kpi_t *k, const sim_opts_t *o, int64_t now, float temp, double duty)
+{
+    const float sp = o->setpoint_c;
+    k->samples++;
+    k->duty_sum += duty;
+    if (temp - sp > k->overshoot_c) {
+        k->overshoot_c = temp - sp;
+    }
+    if (k->reach_us < 0) {
+        if (temp >= sp - SIM_SETTLE_BAND_C) {
+            k->reach_us = now;
+            k->band_min_c = k->band_max_c = temp;
+        }
+        return;
+    }
+    // Perturbación más 10 min de recuperación: cuenta aparte
+    const int64_t recovery_us = 600 * 1000000LL;
+    if (event_active(o, now, false, recovery_us) || event_active(o, now, true, recovery_us)) {
+        const float dev = temp > sp ? temp - sp : sp - temp;
+        if (dev > k->disturb_dev_c) {
+            k->disturb_dev_c = dev;
+        }
+        return;
+    }
+    if (temp < k->band_min_c) {
+        k->band_min_c = temp;
+    }
+    if (temp > k->band_max_c) {
+        k->band_max_c = temp;
+    }
+}
+
+static void report(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    vfprintf(s_report, fmt, args);
+    va_end(args);
+}
+
+static void report_kernel(void)
+{
+    hal_host_kernel_stats_t ks;
+    hal_host_kernel_get_stats(&ks);
+    report("\n== Planificador (FreeRTOS del host) ==\n");
+    report("cambios de contexto %llu  desalojos %llu  saltos de reloj %llu  tareas %lu  bloqueos mutuos %lu\n",
+           (unsigned long long)ks.switches, (unsigned long long)ks.preemptions,
+           (unsigned long long)ks.clock_jumps, (unsigned long)ks.tasks, (unsigned long)ks.deadlocks);
+    hal_host_task_stats_t ts[SIM_REPORT_ROWS];
+    const size_t n = hal_host_kernel_get_task_stats(ts, SIM_REPORT_ROWS);
+    report("%-12s %4s %10s %10s %10s %10s %14s %10s\n", "tarea", "prio", "despachos", "desalojos", "esperas",
+           "vencidas", "mutex máx µs", "CPU ms");
+    for (size_t i = 0; i < n; i++) {
+        report("%-12s %4lu %10lu %10lu %10lu %10lu %14lu %10.1f\n", ts[i].name, (unsigned long)ts[i].priority,
+               (unsigned long)ts[i].dispatches, (unsigned long)ts[i].preemptions, (unsigned long)ts[i].waits,
+               (unsigned long)ts[i].timeouts, (unsigned long)ts[i].mutex_wait_max_us, ts[i].cpu_ns / 1e6);
+    }
+}
+
+static void report_jobs(void)
+{
+    sched_job_stats_t js[SIM_REPORT_ROWS];
+    const size_t n = sched_get_job_stats(js, SIM_REPORT_ROWS);
+    report("\n== Trabajos del planificador ==\n");
+    report("%-14s %8s %10s %9s %14s\n", "trabajo", "periodo", "corridas", "perdidas", "atraso máx µs");
+    for (size_t i = 0; i < n; i++) {
+        report("%-14s %8lu %10lu %9lu %14lu\n", js[i].name, (unsigned long)js[i].period_ms,
+               (unsigned long)js[i].runs, (unsigned long)js[i].overruns, (unsigned long)js[i].max_late_us);
+    }
+
+    deadline_stats_t ds[SIM_REPORT_ROWS];
+    const size_t m = deadline_get_stats(ds, SIM_REPORT_ROWS);
+    report("\n== Plazos ==\n");
+    report("%-14s %10s %10s %10s %14s %14s\n", "actividad", "activ.", "tarde", "excedidas", "periodo máx µs",
+           "periodo mín µs");
+    for (size_t i = 0; i < m; i++) {
+        report("%-14s %10lu %10lu %10lu %14lu %14lu\n", ds[i].name, (unsigned long)ds[i].runs,
+               (unsigned long)ds[i].misses_late, (unsigned long)ds[i].misses_overrun,
+               (unsigned long)ds[i].period_max_us, (unsigned long)ds[i].period_min_us);
+    }
+}
+
+static uint32_t report_bus(void)
+{
+    evbus_stats_t bs;
+    evbus_get_stats(&bs);
+    report("\n== Bus de eventos ==\n");
+    report("publicados %lu  descartados %lu\n", (unsigned long)bs.published, (unsigned long)bs.dropped);
+    evbus_sub_stats_t ss[SIM_REPORT_ROWS];
+    const size_t n = evbus_get_sub_stats(ss, SIM_REPORT_ROWS);
+    report("%-12s %10s %10s %16s %16s\n", "suscriptor", "entregados", "perdidos", "latencia máx µs",
+           "latencia media µs");
+    for (size_t i = 0; i < n; i++) {
+        report("%-12s %10lu %10lu %16lu %16llu\n", ss[i].name, (unsigned long)ss[i].delivered,
+               (unsigned long)ss[i].dropped, (unsigned long)ss[i].latency_max_us,
+               (unsigned long long)(ss[i].delivered ? ss[i].latency_sum_us / ss[i].delivered : 0));
+    }
+
+    pid_cmd_stats_t ps;
+    pid_get_cmd_stats(&ps);
+    report("\n== Órdenes del PID ==\n");
+    report("encoladas %lu  aplicadas %lu  rechazadas %lu  descartadas %lu  latencia máx %lu µs\n",
+           (unsigned long)ps.submitted, (unsigned long)ps.applied, (unsigned long)ps.rejected,
+           (unsigned long)ps.dropped, (unsigned long)ps.latency_max_us);
+    return bs.dropped + ps.dropped;
+}
+
+static void report_ui(void)
+{
+    ui_headless_stats_t us;
+    ui_headless_get_stats(&us);
+    lvgl_port_stats_t ls;
+    lvgl_port_get_stats(&ls);
+    report("\n== Interfaz (sin pantalla) ==\n");
+    report("vueltas de LVGL %lu  eventos %lu  volcados %lu  cola llena %lu\n", (unsigned long)ls.loops,
+           (unsigned long)us.events, (unsigned long)us.refreshes, (unsigned long)us.post_failures);
+    report("muestra → pantalla: máx %lu µs, media %llu µs  (etiqueta: \"%s\")\n",
+           (unsigned long)us.sample_to_screen_max_us,
+           (unsigned long long)(us.samples_shown ? us.sample_to_screen_sum_us / us.samples_shown : 0),
+           strtok(us.label, "\n"));
+}
+
+static void report_net(void)
+{
+    sim_net_stats_t ns;
+    sim_net_get_stats(&ns);
+    sim_clients_stats_t cs;
+    sim_clients_get_stats(&cs);
+    log_tap_stats_t lt;
+    log_tap_get_stats(&lt);
+    report("\n== Red ==\n");
+    report("aceptadas %lu  rechazadas %lu  abiertas máx %lu  solicitudes %lu  mensajes WS %lu  trabajos %lu\n",
+           (unsigned long)ns.accepted, (unsigned long)ns.rejected, (unsigned long)ns.open_max,
+           (unsigned long)ns.requests, (unsigned long)ns.ws_messages, (unsigned long)ns.works);
+    report("cola de httpd llena %lu  envíos vencidos %lu  cierres por error %lu  bloqueo de envío máx %lu µs\n",
+           (unsigned long)ns.queue_full, (unsigned long)ns.send_timeouts, (unsigned long)ns.closed_by_server,
+           (unsigned long)ns.send_block_max_us);
+    report("clientes: conexiones %lu (reconexiones %lu)  mensajes %llu  bytes %llu\n",
+           (unsigned long)cs.connects, (unsigned long)cs.reconnects, (unsigned long long)cs.frames,
+           (unsigned long long)cs.bytes);
+    report("          /metrics ok %lu, fallidos %lu  latencia máx %lu µs  hueco de estado máx %lu µs\n",
+           (unsigned long)cs.metrics_ok, (unsigned long)cs.metrics_failed, (unsigned long)cs.latency_max_us,
+           (unsigned long)cs.status_gap_max_us);
+    report("          log no pedido %lu  anillo: líneas %lu, pisadas %lu\n", (unsigned long)cs.unsolicited,
+           (unsigned long)lt.lines, (unsigned long)lt.dropped);
+}
+
+static void report_control(const sim_opts_t *o, const sim_kpi_t *k)
+{
+    ch422g_model_state_t ch;
+    ch422g_model_get(&ch);
+    const double hours = hal_clock_mono_us() / 3600e6;
+    report("\n== Control (setpoint %.1f °C) ==\n", o->setpoint_c);
+    if (k->reach_us < 0) {
+        report("no llegó a %.1f °C; cámara %.2f °C al final\n", o->setpoint_c - SIM_SETTLE_BAND_C, plant_chamber_c());
+    } else {
+        report("llegada %.1f min  sobrepico %.2f °C  banda en régimen [%.2f, %.2f] °C\n", k->reach_us / 60e6,
+               k->overshoot_c, k->band_min_c, k->band_max_c);
+    }
+    if (o->event_count > 0) {
+        report("desvío máximo con perturbaciones %.2f °C\n", k->disturb_dev_c);
+    }
+    report("ciclo útil medio %.1f %%  conmutaciones del SSR %lu (%.0f por hora)\n",
+           k->samples ? 100.0 * k->duty_sum / k->samples : 0.0, (unsigned long)ch.ssr_edges,
+           hours > 0 ? ch.ssr_edges / hours : 0.0);
+}
+
+int main(int argc, char **argv)
+{
+    sim_opts_t o;
+    if (!parse_args(argc, argv, &o)) {
+        usage();
+        return 2;
+    }
+    s_verbose = o.verbose;
+
+    // El firmware imprime por stdout (p. ej. el PID en cada ciclo); el informe va aparte
+    s_report = fdopen(dup(STDOUT_FILENO), "w");
+    if (s_report == NULL || (!o.verbose && freopen("/dev/null", "w", stdout) == NULL)) {
+        perror("tripta_sim");
+        return 2;
+    }
+
+    // Consola callada (o a stderr con --verbose); log_tap la encadena
+    esp_log_set_vprintf(quiet_vprintf);
+    esp_log_level_set("*", ESP_LOG_INFO);
+    ESP_ERROR_CHECK(sim_boot(o.seed));
+    ESP_ERROR_CHECK(sim_clients_start(&o.load));
+
+    // La red aparece enseguida; el horno arranca con el setpoint pedido
+    sim_publish_connected();
+    pid_set_setpoint(o.setpoint_c);
+    enable_pid();
+
+    const int64_t end_us = (int64_t)(o.hours * 3600e6);
+    sim_kpi_t kpi = { .reach_us = -1 };
+    int64_t last_on_us = ch422g_model_ssr_on_us();
+    bool door = false;
+    bool dropout = false;
+    for (int64_t t = 1000000; t <= end_us; t += 1000000) {
+        if (hal_host_kernel_run_until_us(t) != ESP_OK) {
+            return 2;
+        }
+        const bool door_now = event_active(&o, t, false, 0);
+        if (door_now != door) {
+            plant_set_door(door_now);
+            door = door_now;
+        }
+        const bool dropout_now = event_active(&o, t, true, 0);
+        if (dropout_now != dropout) {
+            modbus_sensor_model_set_fault(dropout_now ? MODBUS_SENSOR_SILENT : MODBUS_SENSOR_OK);
+            dropout = dropout_now;
+        }
+        const int64_t on_us = ch422g_model_ssr_on_us();
+        kpi_sample(&kpi, &o, t, plant_chamber_c(), (on_us - last_on_us) / 1e6);
+        last_on_us = on_us;
+    }
+
+    report("tripta_sim: %.2f h virtuales, %lu clientes WS (%lu con log, %lu lentos), %lu flujos /logs, semilla %lu\n",
+           o.hours, (unsigned long)o.load.ws_clients, (unsigned long)o.load.log_clients,
+           (unsigned long)o.load.slow_clients, (unsigned long)o.load.http_streams, (unsigned long)o.seed);
+    report_kernel();
+    report_jobs();
+    const uint32_t lost = report_bus();
+    report_ui();
+    report_net();
+    report_control(&o, &kpi);
+
+    hal_host_kernel_stats_t ks;
+    hal_host_kernel_get_stats(&ks);
+    const bool failed = ks.deadlocks > 0 || lost > 0;
+    report("\n%s\n", failed ? "FALLA: bloqueo mutuo o eventos perdidos" : "OK");
+    fflush(s_report);
+    return failed ? 1 : 0;
+}
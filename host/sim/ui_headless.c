@@ -0,0 +1,142 @@
+/**
+ * @file ui_headless.c
+ * @brief Suscriptor "ui" del simulador: el de ui_events.c con la pantalla reemplazada por un arreglo.
+ * @details El manejador y el volcado son los de ui_events.c, línea por línea, salvo que la
+ *          gráfica es un arreglo, la etiqueta un texto y una falla no tiene pantalla que
+ *          despertar. Además mide cuánto tarda una muestra publicada en llegar a la "pantalla"
+ *          (la tarea de LVGL ejecutando el volcado).
+ *          ui_events_bench_chart() es la de ui_events.c sin lv_chart_refresh(): en el host la
+ *          prueba "chart" de bench.h mide solo la copia del historial al arreglo.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#include "sim.h"
+#include "event_bus.h"
+#include "ui_queue.h"
+#include "ui_events.h"
+#include "lvgl.h"
+#include "hal_clock.h"
+#include "freertos/FreeRTOS.h"
+#include <stdio.h>
+#include <string.h>
+
+#define CHART_POINT_COUNT 240
+
+static lv_coord_t s_chart_array[CHART_POINT_COUNT];    ///< ui_Chart_series_1_array
+static char s_label[64];                                ///< ui_editLabelGetStatus
+
+static float s_chart_buf[CHART_POINT_COUNT];
+static int s_chart_head = 0;
+static float s_bus_temp = 0.0f;
+static bool s_bus_heating = false;
+static uint32_t s_bus_faults = 0;
+static bool s_chart_dirty = false;
+static bool s_refresh_pending = false;
+static int64_t s_oldest_sample_us = -1;     ///< Publicación de la muestra más vieja sin volcar
+static portMUX_TYPE s_bus_lock = portMUX_INITIALIZER_UNLOCKED;
+static ui_headless_stats_t s_stats;
+
+static void ui_bus_refresh(void *arg)
+{
+    (void)arg;
+    bool chart_dirty;
+    float temp;
+    bool heating;
+    int64_t sample_us;
+
+    portENTER_CRITICAL(&s_bus_lock);
+    chart_dirty = s_chart_dirty;
+    if (chart_dirty) {
+        for (int i = 0; i < CHART_POINT_COUNT; i++) {
+            s_chart_array[i] = (lv_coord_t)s_chart_buf[(s_chart_head + i) % CHART_POINT_COUNT];
+        }
+    }
+    temp = s_bus_temp;
+    heating = s_bus_heating;
+    sample_us = s_oldest_sample_us;
+    s_oldest_sample_us = -1;
+    s_chart_dirty = false;
+    s_refresh_pending = false;
+    portEXIT_CRITICAL(&s_bus_lock);
+
+    snprintf(s_label, sizeof(s_label), "%.1f°C\nTemperatura%s", temp, heating ? " *" : "");
+    s_stats.refreshes++;
+    if (sample_us >= 0) {
+        const uint32_t latency = (uint32_t)(hal_clock_mono_us() - sample_us);
+        if (latency > s_stats.sample_to_screen_max_us) {
+            s_stats.sample_to_screen_max_us = latency;
+        }
+        s_stats.sample_to_screen_sum_us += latency;
+        s_stats.samples_shown++;
+    }
+}
+
+static void ui_on_bus_event(const evbus_event_t *ev, void *ctx)
+{
+    (void)ctx;
+    bool post;
+
+    portENTER_CRITICAL(&s_bus_lock);
+    s_stats.events++;
+    switch (ev->type) {
+    case EVBUS_SAMPLE:
+        s_chart_buf[s_chart_head] = ev->sample.temp_c;
+        s_chart_head = (s_chart_head + 1) % CHART_POINT_COUNT;
+        s_bus_temp = ev->sample.temp_c;
+        s_chart_dirty = true;
+        if (s_oldest_sample_us < 0) {
+            s_oldest_sample_us = ev->t_us;
+        }
+        break;
+    case EVBUS_SSR_EDGE:
+        s_bus_heating = ev->ssr.on;
+        break;
+    case EVBUS_FAULT:
+        if (ev->fault.active) {
+            s_bus_faults |= 1u << ev->fault.code;
+        } else {
+            s_bus_faults &= ~(1u << ev->fault.code);
+        }
+        break;
+    default:
+        break;
+    }
+    post = !s_refresh_pending;
+    s_refresh_pending = true;
+    portEXIT_CRITICAL(&s_bus_lock);
+
+    if (post && ui_queue_post(ui_bus_refresh, NULL) != ESP_OK) {
+        portENTER_CRITICAL(&s_bus_lock);
+        s_refresh_pending = false;
+        s_stats.post_failures++;
+        portEXIT_CRITICAL(&s_bus_lock);
+    }
+}
+
+esp_err_t ui_headless_init(void)
+{
+    return evbus_subscribe("ui", EVBUS_MASK(EVBUS_SAMPLE) | EVBUS_MASK(EVBUS_SSR_EDGE) | EVBUS_MASK(EVBUS_FAULT),
+                           32, ui_on_bus_event, NULL);
+}
+
+esp_err_t ui_events_bench_chart(uint32_t iterations)
+{
+    for (uint32_t n = 0; n < iterations; n++) {
+        portENTER_CRITICAL(&s_bus_lock);
+        for (int i = 0; i < CHART_POINT_COUNT; i++) {
+            s_chart_array[i] = (lv_coord_t)s_chart_buf[(s_chart_head + i) % CHART_POINT_COUNT];
+        }
+        portEXIT_CRITICAL(&s_bus_lock);
+    }
+    return ESP_OK;
+}
+
+void ui_headless_get_stats(ui_headless_stats_t *out)
+{
+    portENTER_CRITICAL(&s_bus_lock);
+    *out = s_stats;
+    snprintf(out->label, sizeof(out->label), "%s", s_label);
+    portEXIT_CRITICAL(&s_bus_lock);
+}
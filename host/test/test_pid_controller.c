@@ -0,0 +1,126 @@
+/**
+ * @file test_pid_controller.c
+ * @brief Pruebas del controlador PID (pid_controller.c) sin la tarea de control en marcha.
+ * @details La tarea se crea pero no corre, así que las órdenes quedan en la cola: se prueban
+ *          el cálculo, el encolado, el manejo del SSR a través del CH422G y la persistencia.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#include "test_util.h"
+#include "host_fakes.h"
+#include "ch422g_model.h"
+#include "pid_controller.h"
+#include "config_store.h"
+#include "hal_nvs.h"
+#include "hal_clock.h"
+
+static void test_submit_before_init(void)
+{
+    const pid_cmd_t cmd = { .type = PID_CMD_ENABLE, .source = PID_SRC_UI };
+    TEST_ASSERT_EQ(ESP_ERR_INVALID_STATE, pid_submit(&cmd, 0));
+    TEST_ASSERT_EQ(ESP_ERR_INVALID_ARG, pid_submit(NULL, 0));
+}
+
+static void test_bench_compute(void)
+{
+    // Ganancias por defecto (1, 0.1, 2) y dt = 5 s: el primer paso con error 34.5 °C da
+    // 34.5 + 0.1·172.5 + 2·6.9 = 65.55 %
+    TEST_ASSERT_NEAR(65.55, pid_bench_compute(1), 1e-3);
+    // El cálculo trabaja sobre una copia: repetirlo da lo mismo
+    const float a = pid_bench_compute(1000);
+    TEST_ASSERT_NEAR(a, pid_bench_compute(1000), 0);
+    // La salida queda siempre entre los límites
+    TEST_ASSERT(a >= 0.0f && a <= 100.0f * 1000);
+}
+
+static void test_ssr_drives_expander(void)
+{
+    const uint32_t edges = evbus_fake_count(EVBUS_SSR_EDGE);
+    evbus_event_t ev;
+
+    activar_ssr();
+    TEST_ASSERT(ch422g_model_ssr_on());
+    TEST_ASSERT(pid_ssr_status());
+    TEST_ASSERT(evbus_fake_last(EVBUS_SSR_EDGE, &ev));
+    TEST_ASSERT(ev.ssr.on);
+
+    // Repetir la orden no publica otro flanco ni vuelve a escribir el registro
+    ch422g_model_state_t before, after;
+    ch422g_model_get(&before);
+    activar_ssr();
+    ch422g_model_get(&after);
+    TEST_ASSERT_EQ(before.writes, after.writes);
+    TEST_ASSERT_EQ(edges + 1, evbus_fake_count(EVBUS_SSR_EDGE));
+
+    hal_host_clock_advance_us(2500000);
+    desactivar_ssr();
+    TEST_ASSERT(!ch422g_model_ssr_on());
+    TEST_ASSERT(!pid_ssr_status());
+    TEST_ASSERT_EQ(edges + 2, evbus_fake_count(EVBUS_SSR_EDGE));
+    TEST_ASSERT(ch422g_model_ssr_on_us() >= 2500000);
+}
+
+static void test_params_persist(void)
+{
+    hal_host_nvs_stats_t before, after;
+    hal_host_nvs_get_stats(&before);
+
+    TEST_ASSERT_EQ(ESP_OK, cfg_set_float(CFG_PID_KP, 3.5f));
+    TEST_ASSERT_EQ(ESP_OK, pid_load_params());
+    TEST_ASSERT_EQ(ESP_OK, pid_save_params());
+
+    hal_host_nvs_get_stats(&after);
+    TEST_ASSERT_EQ(before.ops[HAL_HOST_NVS_COMMIT] + 1, after.ops[HAL_HOST_NVS_COMMIT]);
+    TEST_ASSERT_EQ(0, after.uncommitted);
+    // Con la nueva Kp el primer paso (3.5·34.5 + 17.25 + 13.8) satura en el máximo
+    TEST_ASSERT_NEAR(100.0, pid_bench_compute(1), 1e-3);
+
+    // Un valor fuera de rango no llega al almacén
+    TEST_ASSERT(cfg_set_float(CFG_PID_KP, -1.0f) != ESP_OK);
+    TEST_ASSERT_NEAR(3.5, cfg_get_float(CFG_PID_KP), 0);
+}
+
+static void test_queue_full_drops(void)
+{
+    pid_cmd_stats_t st;
+    pid_get_cmd_stats(&st);
+    const uint32_t submitted = st.submitted;
+
+    // Sin la tarea de control nadie vacía la cola: se llena y las siguientes se descartan
+    const pid_cmd_t cmd = { .type = PID_CMD_SET_SETPOINT, .source = PID_SRC_WEBSOCKET, .setpoint = 80.0f };
+    uint32_t queued = 0;
+    while (pid_submit(&cmd, 0) == ESP_OK && queued < 64) {
+        queued++;
+    }
+    TEST_ASSERT(queued > 0 && queued < 64);
+
+    const int64_t start = hal_clock_mono_us();
+    TEST_ASSERT_EQ(ESP_ERR_TIMEOUT, pid_submit(&cmd, 20));
+    // Con plazo se espera antes de rendirse
+    TEST_ASSERT_EQ(20000, hal_clock_mono_us() - start);
+
+    pid_get_cmd_stats(&st);
+    TEST_ASSERT_EQ(submitted + queued, st.submitted);
+    TEST_ASSERT_EQ(2, st.dropped);
+    TEST_ASSERT_EQ(0, st.applied);
+    TEST_ASSERT_EQ(2, test_metric("pid", "pid_cmd_dropped_total"));
+}
+
+int main(void)
+{
+    hal_host_reset();
+    if (hal_nvs_init() != ESP_OK || ch422g_model_attach() != ESP_OK || cfg_init() != ESP_OK) {
+        fprintf(stderr, "no se pudo preparar la HAL del host\n");
+        return 1;
+    }
+
+    RUN_TEST(test_submit_before_init);
+    pid_controller_init(60.0f);
+    RUN_TEST(test_bench_compute);
+    RUN_TEST(test_ssr_drives_expander);
+    RUN_TEST(test_params_persist);
+    RUN_TEST(test_queue_full_drops);
+    return TEST_REPORT();
+}
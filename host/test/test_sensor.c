@@ -0,0 +1,213 @@
+/**
+ * @file test_sensor.c
+ * @brief Pruebas del lector Modbus de temperatura (sensor.c) contra el modelo del transmisor.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#include "test_util.h"
+#include "host_fakes.h"
+#include "modbus_sensor_model.h"
+#include "sensor.h"
+#include "hal_clock.h"
+
+#define SENSOR_PORT 1
+
+/**
+ * @brief Una lectura periódica completa: la consulta y los trabajos que recogen la respuesta
+ */
+static void poll_once(void)
+{
+    TEST_ASSERT(sched_fake_run("temperature"));
+    while (sched_fake_run_armed("temperature_rx")) {
+    }
+}
+
+static void test_crc_reference_frame(void)
+{
+    // Lectura del registro 0 del esclavo 1: trama de referencia 01 03 00 00 00 01 84 0A
+    uint8_t frame[] = { 0x01, 0x03, 0x00, 0x00, 0x00, 0x01 };
+    const uint16_t crc = modbus_crc(frame, sizeof(frame));
+    TEST_ASSERT_EQ(0x84, crc & 0xFF);
+    TEST_ASSERT_EQ(0x0A, crc >> 8);
+}
+
+static void test_reads_positive_and_negative(void)
+{
+    modbus_sensor_model_set_fault(MODBUS_SENSOR_OK);
+    modbus_sensor_model_set_temp(23.5f);
+    TEST_ASSERT_NEAR(23.5, read_temperature_raw(), 1e-4);
+
+    modbus_sensor_model_set_temp(-12.3f);
+    TEST_ASSERT_NEAR(-12.3, read_temperature_raw(), 1e-4);
+
+    modbus_sensor_model_set_temp(180.0f);
+    TEST_ASSERT_NEAR(180.0, read_temperature_raw(), 1e-4);
+
+    modbus_sensor_stats_t st;
+    modbus_sensor_model_get_stats(&st);
+    TEST_ASSERT_EQ(0, st.bad_frames);
+}
+
+static void test_silent_sensor_times_out(void)
+{
+    const double timeouts = test_metric("sensor", "sensor_modbus_timeouts_total");
+    modbus_sensor_model_set_fault(MODBUS_SENSOR_SILENT);
+
+    const int64_t start = hal_clock_mono_us();
+    TEST_ASSERT_EQ(-1, read_temperature_raw());
+    // Sin respuesta se espera el plazo completo de 1 s
+    TEST_ASSERT(hal_clock_mono_us() - start >= 1000000);
+    TEST_ASSERT_EQ(timeouts + 1, test_metric("sensor", "sensor_modbus_timeouts_total"));
+}
+
+static void test_invalid_replies_are_rejected(void)
+{
+    const double invalid = test_metric("sensor", "sensor_modbus_invalid_total");
+
+    modbus_sensor_model_set_fault(MODBUS_SENSOR_WRONG_SLAVE);
+    TEST_ASSERT_EQ(-1, read_temperature_raw());
+    modbus_sensor_model_set_fault(MODBUS_SENSOR_SHORT);
+    TEST_ASSERT_EQ(-1, read_temperature_raw());
+
+    TEST_ASSERT_EQ(invalid + 2, test_metric("sensor", "sensor_modbus_invalid_total"));
+    modbus_sensor_model_set_fault(MODBUS_SENSOR_OK);
+}
+
+static void test_ema_seeds_then_smooths(void)
+{
+    modbus_sensor_model_set_fault(MODBUS_SENSOR_OK);
+    modbus_sensor_model_set_temp(100.0f);
+    poll_once();
+    TEST_ASSERT_NEAR(100.0, read_ema_temp(), 1e-4);
+
+    modbus_sensor_model_set_temp(200.0f);
+    poll_once();
+    TEST_ASSERT_NEAR(0.15 * 200.0 + 0.85 * 100.0, read_ema_temp(), 1e-3);
+
+    evbus_event_t ev;
+    TEST_ASSERT(evbus_fake_last(EVBUS_SAMPLE, &ev));
+    TEST_ASSERT_NEAR(200.0, ev.sample.raw_c, 1e-4);
+    TEST_ASSERT_NEAR(read_ema_temp(), ev.sample.temp_c, 1e-6);
+}
+
+static void test_poll_does_not_block(void)
+{
+    modbus_sensor_model_set_fault(MODBUS_SENSOR_OK);
+    modbus_sensor_model_set_temp(120.0f);
+    const uint32_t samples = evbus_fake_count(EVBUS_SAMPLE);
+
+    // La consulta no espera a la UART: la respuesta llega ~16 ms después y la recoge otro trabajo
+    int64_t start = hal_clock_mono_us();
+    TEST_ASSERT(sched_fake_run("temperature"));
+    TEST_ASSERT_EQ(start, hal_clock_mono_us());
+    TEST_ASSERT_EQ(samples, evbus_fake_count(EVBUS_SAMPLE));
+    TEST_ASSERT(sched_fake_run_armed("temperature_rx"));
+    TEST_ASSERT_EQ(samples + 1, evbus_fake_count(EVBUS_SAMPLE));
+    TEST_ASSERT(hal_clock_mono_us() - start <= 50000);
+    TEST_ASSERT(!sched_fake_run_armed("temperature_rx"));
+
+    // Sin respuesta se sigue consultando en pasos cortos hasta el plazo de 1 s
+    const double timeouts = test_metric("sensor", "sensor_modbus_timeouts_total");
+    modbus_sensor_model_set_fault(MODBUS_SENSOR_SILENT);
+    start = hal_clock_mono_us();
+    TEST_ASSERT(sched_fake_run("temperature"));
+    uint32_t checks = 0;
+    while (sched_fake_run_armed("temperature_rx")) {
+        checks++;
+    }
+    TEST_ASSERT(checks > 10);
+    TEST_ASSERT(hal_clock_mono_us() - start >= 1000000);
+    TEST_ASSERT(hal_clock_mono_us() - start < 1100000);
+    TEST_ASSERT_EQ(timeouts + 1, test_metric("sensor", "sensor_modbus_timeouts_total"));
+    modbus_sensor_model_set_fault(MODBUS_SENSOR_OK);
+    poll_once();
+}
+
+static void test_bench_filter(void)
+{
+    // Rampa de 25,0 °C en décimas: la primera muestra inicializa la EMA, la segunda la suaviza
+    const float ema = read_ema_temp();
+    TEST_ASSERT_NEAR(25.0, sensor_bench_filter(1), 1e-4);
+    TEST_ASSERT_NEAR(0.15 * 25.1 + 0.85 * 25.0, sensor_bench_filter(2), 1e-4);
+    // No toca la EMA publicada
+    TEST_ASSERT_NEAR(ema, read_ema_temp(), 0);
+}
+
+static void test_fault_published_on_transitions(void)
+{
+    const uint32_t faults = evbus_fake_count(EVBUS_FAULT);
+    const float ema = read_ema_temp();
+    evbus_event_t ev;
+
+    modbus_sensor_model_set_fault(MODBUS_SENSOR_SILENT);
+    poll_once();
+    poll_once();
+    TEST_ASSERT_EQ(faults + 1, evbus_fake_count(EVBUS_FAULT));
+    TEST_ASSERT(evbus_fake_last(EVBUS_FAULT, &ev));
+    TEST_ASSERT_EQ(EVBUS_FAULT_SENSOR, ev.fault.code);
+    TEST_ASSERT(ev.fault.active);
+    // Una lectura fallida no mueve el filtro
+    TEST_ASSERT_NEAR(ema, read_ema_temp(), 1e-6);
+
+    modbus_sensor_model_set_fault(MODBUS_SENSOR_OK);
+    poll_once();
+    TEST_ASSERT_EQ(faults + 2, evbus_fake_count(EVBUS_FAULT));
+    TEST_ASSERT(evbus_fake_last(EVBUS_FAULT, &ev));
+    TEST_ASSERT(!ev.fault.active);
+}
+
+static void test_corrupted_reply_is_rejected(void)
+{
+    const double invalid = test_metric("sensor", "sensor_modbus_invalid_total");
+    const uint32_t samples = evbus_fake_count(EVBUS_SAMPLE);
+    const float ema = read_ema_temp();
+
+    // Encabezado correcto y registro alterado: solo el CRC la rechaza
+    modbus_sensor_model_set_fault(MODBUS_SENSOR_BAD_CRC);
+    modbus_sensor_model_set_temp(23.5f);
+    TEST_ASSERT_EQ(-1, read_temperature_raw());
+    poll_once();
+    TEST_ASSERT_EQ(invalid + 2, test_metric("sensor", "sensor_modbus_invalid_total"));
+    // Ni la EMA ni el PID la ven
+    TEST_ASSERT_EQ(samples, evbus_fake_count(EVBUS_SAMPLE));
+    TEST_ASSERT_NEAR(ema, read_ema_temp(), 0);
+
+    modbus_sensor_model_set_fault(MODBUS_SENSOR_OK);
+    poll_once();
+}
+
+static void test_poll_period(void)
+{
+    TEST_ASSERT_EQ(ESP_ERR_INVALID_ARG, sensor_set_poll_period(SENSOR_POLL_MIN_MS - 1));
+    TEST_ASSERT_EQ(ESP_ERR_INVALID_ARG, sensor_set_poll_period(SENSOR_POLL_MAX_MS + 1));
+    TEST_ASSERT_EQ(ESP_OK, sensor_set_poll_period(2000));
+    TEST_ASSERT_EQ(2000, sensor_get_poll_period());
+
+    // El cambio dispara una lectura inmediata (la muestra sale al llegar la respuesta) y luego una cada 2 s
+    const uint32_t samples = evbus_fake_count(EVBUS_SAMPLE);
+    sched_fake_advance_ms(100);
+    TEST_ASSERT_EQ(samples + 1, evbus_fake_count(EVBUS_SAMPLE));
+    sched_fake_advance_ms(10000);
+    TEST_ASSERT(evbus_fake_count(EVBUS_SAMPLE) >= samples + 4);
+}
+
+int main(void)
+{
+    hal_host_reset();
+    modbus_sensor_model_attach(SENSOR_PORT);
+    start_temperature_task();
+
+    RUN_TEST(test_crc_reference_frame);
+    RUN_TEST(test_reads_positive_and_negative);
+    RUN_TEST(test_silent_sensor_times_out);
+    RUN_TEST(test_invalid_replies_are_rejected);
+    RUN_TEST(test_ema_seeds_then_smooths);
+    RUN_TEST(test_poll_does_not_block);
+    RUN_TEST(test_bench_filter);
+    RUN_TEST(test_fault_published_on_transitions);
+    RUN_TEST(test_corrupted_reply_is_rejected);
+    RUN_TEST(test_poll_period);
+    return TEST_REPORT();
+}
@@ -0,0 +1,164 @@
+/**
+ * @file test_statistics.c
+ * @brief Pruebas de las estadísticas de uso (statistics.c) sobre la NVS en RAM.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#include "test_util.h"
+#include "host_fakes.h"
+#include "statistics.h"
+#include "hal_nvs.h"
+#include "timebase.h"
+
+/**
+ * @brief Publica un flanco del SSR como lo hace el PID
+ */
+static void ssr_edge(bool on)
+{
+    evbus_event_t ev = { .type = EVBUS_SSR_EDGE, .ssr.on = on };
+    evbus_publish(&ev);
+}
+
+static void test_empty_nvs_starts_at_zero(void)
+{
+    statistics_data_t data;
+    TEST_ASSERT_EQ(ESP_OK, statistics_get_data(&data));
+    TEST_ASSERT_EQ(0, data.total_sessions);
+    TEST_ASSERT_EQ(0, data.ssr_cycle_count);
+    TEST_ASSERT_EQ(0, data.total_operation_time_seconds);
+    TEST_ASSERT_EQ(0, data.total_heating_time_seconds);
+}
+
+static void test_session_time_is_accumulated(void)
+{
+    TEST_ASSERT_EQ(ESP_OK, statistics_start_session());
+    hal_host_clock_advance_us(3661LL * 1000000);
+    TEST_ASSERT_EQ(ESP_OK, statistics_end_session());
+    TEST_ASSERT_EQ(ESP_ERR_INVALID_STATE, statistics_end_session());
+
+    statistics_formatted_t f;
+    TEST_ASSERT_EQ(ESP_OK, statistics_get_formatted(&f));
+    TEST_ASSERT_STR("1h 1min", f.total_operation_time);
+    TEST_ASSERT_STR("1", f.total_sessions);
+}
+
+static void test_ssr_edges_count_heating_time(void)
+{
+    // Tres ciclos de 20 s encendido / 10 s apagado, con un flanco repetido que no cuenta
+    for (int i = 0; i < 3; i++) {
+        ssr_edge(true);
+        ssr_edge(true);
+        hal_host_clock_advance_us(20LL * 1000000);
+        ssr_edge(false);
+        hal_host_clock_advance_us(10LL * 1000000);
+    }
+
+    statistics_data_t data;
+    TEST_ASSERT_EQ(ESP_OK, statistics_get_data(&data));
+    TEST_ASSERT_EQ(3, data.ssr_cycle_count);
+    TEST_ASSERT_EQ(60, data.total_heating_time_seconds);
+
+    statistics_formatted_t f;
+    TEST_ASSERT_EQ(ESP_OK, statistics_get_formatted(&f));
+    TEST_ASSERT_STR("1min 0s", f.total_heating_time);
+    TEST_ASSERT_STR("3", f.ssr_cycle_count);
+}
+
+static void test_values_survive_reload(void)
+{
+    TEST_ASSERT_EQ(ESP_OK, statistics_save_to_nvs());
+    // Un corte de energía después de confirmar no pierde nada
+    hal_host_nvs_power_cut();
+    TEST_ASSERT_EQ(ESP_OK, hal_nvs_init());
+    TEST_ASSERT_EQ(ESP_OK, statistics_load_from_nvs());
+
+    statistics_data_t data;
+    TEST_ASSERT_EQ(ESP_OK, statistics_get_data(&data));
+    TEST_ASSERT_EQ(1, data.total_sessions);
+    TEST_ASSERT_EQ(3, data.ssr_cycle_count);
+    TEST_ASSERT_EQ(3661, data.total_operation_time_seconds);
+    TEST_ASSERT_EQ(60, data.total_heating_time_seconds);
+}
+
+static void test_late_edge_counts_at_publish_time(void)
+{
+    statistics_data_t before;
+    TEST_ASSERT_EQ(ESP_OK, statistics_get_data(&before));
+
+    // El apagado se publica a los 20 s pero el suscriptor lo recibe 5 s después
+    ssr_edge(true);
+    hal_host_clock_advance_us(20LL * 1000000);
+    const evbus_event_t off = { .type = EVBUS_SSR_EDGE, .t_us = timebase_mono_us(), .ssr.on = false };
+    hal_host_clock_advance_us(5LL * 1000000);
+    evbus_fake_deliver(&off);
+
+    statistics_data_t after;
+    TEST_ASSERT_EQ(ESP_OK, statistics_get_data(&after));
+    TEST_ASSERT_EQ(before.ssr_cycle_count + 1, after.ssr_cycle_count);
+    TEST_ASSERT_EQ(before.total_heating_time_seconds + 20, after.total_heating_time_seconds);
+}
+
+static void test_failed_commit_is_reported(void)
+{
+    hal_host_nvs_fail(HAL_HOST_NVS_COMMIT, ESP_ERR_NVS_NOT_ENOUGH_SPACE, 0, 1);
+    TEST_ASSERT_EQ(ESP_ERR_NVS_NOT_ENOUGH_SPACE, statistics_save_to_nvs());
+    TEST_ASSERT_EQ(ESP_OK, statistics_save_to_nvs());
+
+    hal_host_nvs_stats_t st;
+    hal_host_nvs_get_stats(&st);
+    TEST_ASSERT_EQ(1, st.injected);
+}
+
+static void test_uncommitted_session_lost_on_power_cut(void)
+{
+    // La sesión se guarda al empezar; la segunda escritura no llega a confirmarse
+    hal_host_nvs_fail(HAL_HOST_NVS_COMMIT, ESP_FAIL, 0, UINT32_MAX);
+    TEST_ASSERT_EQ(ESP_OK, statistics_start_session());
+    hal_host_nvs_power_cut();
+    hal_host_nvs_fail(HAL_HOST_NVS_COMMIT, ESP_OK, 0, 0);
+    TEST_ASSERT_EQ(ESP_OK, hal_nvs_init());
+    TEST_ASSERT_EQ(ESP_OK, statistics_load_from_nvs());
+
+    statistics_data_t data;
+    TEST_ASSERT_EQ(ESP_OK, statistics_get_data(&data));
+    TEST_ASSERT_EQ(1, data.total_sessions);
+}
+
+static void test_bench_format(void)
+{
+    // Duraciones 0 s, 37 s, 74 s...: "0s", "37s", "1min 14s"
+    TEST_ASSERT_EQ(2, statistics_bench_format(1));
+    TEST_ASSERT_EQ(2 + 3 + 8, statistics_bench_format(3));
+}
+
+static void test_reset_clears_nvs(void)
+{
+    TEST_ASSERT_EQ(ESP_OK, statistics_reset());
+    TEST_ASSERT_EQ(ESP_OK, statistics_load_from_nvs());
+    statistics_data_t data;
+    TEST_ASSERT_EQ(ESP_OK, statistics_get_data(&data));
+    TEST_ASSERT_EQ(0, data.total_sessions);
+    TEST_ASSERT_EQ(0, data.ssr_cycle_count);
+}
+
+int main(void)
+{
+    hal_host_reset();
+    if (statistics_start_session() != ESP_ERR_INVALID_STATE || statistics_init() != ESP_OK) {
+        fprintf(stderr, "statistics_init falló\n");
+        return 1;
+    }
+
+    RUN_TEST(test_empty_nvs_starts_at_zero);
+    RUN_TEST(test_session_time_is_accumulated);
+    RUN_TEST(test_ssr_edges_count_heating_time);
+    RUN_TEST(test_values_survive_reload);
+    RUN_TEST(test_late_edge_counts_at_publish_time);
+    RUN_TEST(test_failed_commit_is_reported);
+    RUN_TEST(test_uncommitted_session_lost_on_power_cut);
+    RUN_TEST(test_reset_clears_nvs);
+    RUN_TEST(test_bench_format);
+    return TEST_REPORT();
+}
@@ -0,0 +1,122 @@
+/**
+ * @file test_system_test.c
+ * @brief Pruebas del autodiagnóstico (system_test.c) con el sensor y el CH422G modelados.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#include "test_util.h"
+#include "host_fakes.h"
+#include "ch422g_model.h"
+#include "modbus_sensor_model.h"
+#include "system_test.h"
+#include "sensor.h"
+#include "pid_controller.h"
+#include "config_store.h"
+#include "hal_nvs.h"
+
+static void test_format_all_ok(void)
+{
+    const system_test_result_t r = {
+        .sensor_test_passed = true, .ssr_test_passed = true,
+        .sensor_temperature = 25.04f, .system_overall_status = true,
+    };
+    char out[SYSTEM_TEST_RESULT_MAX_LEN];
+    TEST_ASSERT_EQ(ESP_OK, format_test_results(&r, out, sizeof(out)));
+    TEST_ASSERT(strstr(out, "SENSOR: OK - 25.0°C") != NULL);
+    TEST_ASSERT(strstr(out, "SSR: OK") != NULL);
+    TEST_ASSERT(strstr(out, "SISTEMA: Funcionando correctamente") != NULL);
+}
+
+static void test_format_failures(void)
+{
+    system_test_result_t r = { .sensor_temperature = -1.0f };
+    char out[SYSTEM_TEST_RESULT_MAX_LEN];
+    TEST_ASSERT_EQ(ESP_OK, format_test_results(&r, out, sizeof(out)));
+    TEST_ASSERT(strstr(out, "SENSOR: ERROR - Sin comunicación") != NULL);
+    TEST_ASSERT(strstr(out, "SSR: ERROR") != NULL);
+    TEST_ASSERT(strstr(out, "SISTEMA: Requiere atención") != NULL);
+
+    r.sensor_temperature = 250.0f;
+    TEST_ASSERT_EQ(ESP_OK, format_test_results(&r, out, sizeof(out)));
+    TEST_ASSERT(strstr(out, "ADVERTENCIA - 250.0°C") != NULL);
+}
+
+static void test_format_truncates(void)
+{
+    const system_test_result_t r = { 0 };
+    char out[12];
+    TEST_ASSERT_EQ(ESP_OK, format_test_results(&r, out, sizeof(out)));
+    TEST_ASSERT_EQ(sizeof(out) - 1, strlen(out));
+    TEST_ASSERT_EQ(ESP_ERR_INVALID_ARG, format_test_results(&r, out, 0));
+    TEST_ASSERT_EQ(ESP_ERR_INVALID_ARG, format_test_results(NULL, out, sizeof(out)));
+}
+
+static void test_run_passes_with_healthy_hardware(void)
+{
+    modbus_sensor_model_set_fault(MODBUS_SENSOR_OK);
+    modbus_sensor_model_set_temp(24.0f);
+    ch422g_model_state_t before, after;
+    ch422g_model_get(&before);
+
+    system_test_result_t r;
+    TEST_ASSERT_EQ(ESP_OK, system_test_run(&r));
+    TEST_ASSERT(r.sensor_test_passed);
+    TEST_ASSERT_NEAR(24.0, r.sensor_temperature, 1e-4);
+    TEST_ASSERT(r.ssr_test_passed);
+    TEST_ASSERT(r.system_overall_status);
+
+    // El SSR se encendió y apagó de verdad en el expansor, y quedó apagado
+    ch422g_model_get(&after);
+    TEST_ASSERT_EQ(before.ssr_edges + 2, after.ssr_edges);
+    TEST_ASSERT(!ch422g_model_ssr_on());
+    TEST_ASSERT(!pid_ssr_status());
+}
+
+static void test_run_reports_sensor_faults(void)
+{
+    system_test_result_t r;
+
+    modbus_sensor_model_set_fault(MODBUS_SENSOR_SILENT);
+    TEST_ASSERT_EQ(ESP_OK, system_test_run(&r));
+    TEST_ASSERT(!r.sensor_test_passed);
+    TEST_ASSERT_EQ(-1, r.sensor_temperature);
+    TEST_ASSERT(!r.system_overall_status);
+    TEST_ASSERT(strstr(r.formatted_result, "Sin comunicación") != NULL);
+
+    modbus_sensor_model_set_fault(MODBUS_SENSOR_OK);
+    modbus_sensor_model_set_temp(2.0f);
+    TEST_ASSERT_EQ(ESP_OK, system_test_run(&r));
+    TEST_ASSERT(!r.sensor_test_passed);
+    TEST_ASSERT(r.ssr_test_passed);
+    TEST_ASSERT(!r.system_overall_status);
+}
+
+static void test_run_quick(void)
+{
+    modbus_sensor_model_set_temp(30.0f);
+    char out[64];
+    TEST_ASSERT_EQ(ESP_OK, system_test_run_quick(out, sizeof(out)));
+    TEST_ASSERT(strncmp(out, "=== TEST DEL SISTEMA ===", 24) == 0);
+    TEST_ASSERT_EQ(ESP_ERR_INVALID_ARG, system_test_run_quick(NULL, sizeof(out)));
+}
+
+int main(void)
+{
+    hal_host_reset();
+    if (hal_nvs_init() != ESP_OK || ch422g_model_attach() != ESP_OK || cfg_init() != ESP_OK) {
+        fprintf(stderr, "no se pudo preparar la HAL del host\n");
+        return 1;
+    }
+    modbus_sensor_model_attach(1);
+    start_temperature_task();
+
+    RUN_TEST(test_format_all_ok);
+    RUN_TEST(test_format_failures);
+    RUN_TEST(test_format_truncates);
+    RUN_TEST(test_run_passes_with_healthy_hardware);
+    RUN_TEST(test_run_reports_sensor_faults);
+    RUN_TEST(test_run_quick);
+    return TEST_REPORT();
+}
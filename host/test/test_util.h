@@ -0,0 +1,86 @@
+/**
+ * @file test_util.h
+ * @brief Aserciones mínimas para las pruebas del host (sin dependencias externas).
+ * @details Cada prueba es una función `static void test_x(void)` que RUN_TEST ejecuta e informa.
+ *          Los módulos del firmware guardan estado propio, así que cada ejecutable prepara la HAL
+ *          una vez en main() y las pruebas corren en orden. Una aserción fallida se cuenta, se
+ *          informa con archivo y línea, y termina la prueba en curso.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include "hal_host.h"
+#include "metrics.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int s_test_failures = 0;
+static int s_test_count = 0;
+
+#define TEST_FAIL_(fmt, ...)                                                            \
+    do {                                                                                \
+        fprintf(stderr, "  %s:%d: " fmt "\n", __FILE__, __LINE__, __VA_ARGS__);         \
+        s_test_failures++;                                                              \
+        return;                                                                         \
+    } while (0)
+
+#define TEST_ASSERT(cond)                                                               \
+    do {                                                                                \
+        if (!(cond)) TEST_FAIL_("falló %s", #cond);                                     \
+    } while (0)
+
+#define TEST_ASSERT_EQ(expected, actual)                                                \
+    do {                                                                                \
+        const long long e_ = (long long)(expected), a_ = (long long)(actual);            \
+        if (e_ != a_) TEST_FAIL_("%s: se esperaba %lld, vale %lld", #actual, e_, a_);   \
+    } while (0)
+
+#define TEST_ASSERT_NEAR(expected, actual, tol)                                         \
+    do {                                                                                \
+        const double e_ = (expected), a_ = (actual);                                    \
+        if (!(fabs(e_ - a_) <= (tol)))                                                  \
+            TEST_FAIL_("%s: se esperaba %g ± %g, vale %g", #actual, e_, (double)(tol), a_); \
+    } while (0)
+
+#define TEST_ASSERT_STR(expected, actual)                                               \
+    do {                                                                                \
+        if (strcmp((expected), (actual)) != 0)                                          \
+            TEST_FAIL_("%s: se esperaba \"%s\", vale \"%s\"", #actual, (expected), (actual)); \
+    } while (0)
+
+#define RUN_TEST(fn)                                                                    \
+    do {                                                                                \
+        const int before_ = s_test_failures;                                            \
+        s_test_count++;                                                                 \
+        fn();                                                                           \
+        printf("%s %s\n", s_test_failures == before_ ? "ok  " : "FAIL", #fn);           \
+    } while (0)
+
+#define TEST_REPORT()                                                                   \
+    (printf("%d pruebas, %d fallidas\n", s_test_count, s_test_failures), s_test_failures != 0)
+
+/**
+ * @brief Valor de una métrica sin etiquetas de un proveedor (-1 si no está)
+ */
+static inline double test_metric(const char *provider, const char *name)
+{
+    static char buf[4096];
+    metrics_render(buf, sizeof(buf), provider);
+    const size_t len = strlen(name);
+    for (const char *line = buf; *line != '\0'; ) {
+        if (strncmp(line, name, len) == 0 && line[len] == ' ') {
+            return strtod(line + len + 1, NULL);
+        }
+        const char *next = strchr(line, '\n');
+        line = next != NULL ? next + 1 : line + strlen(line);
+    }
+    return -1;
+}
+
+#endif // TEST_UTIL_H
@@ -0,0 +1,80 @@
+/**
+ * @file test_wifi_manager.c
+ * @brief Pruebas del gestor WiFi (wifi_manager.c y wifi_prov.c) sobre la pila WiFi de prueba.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#include "test_util.h"
+#include "host_fakes.h"
+#include "wifi_manager.h"
+#include "wifi_prov.h"
+#include "hal_nvs.h"
+
+/// PSK de 64 dígitos hexadecimales y SSID de 32 caracteres: ambos llenan su campo de ESP-IDF
+static const char HEX_PSK[] = "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef";
+static const char LONG_SSID[] = "horno-de-vacio-laboratorio-ab-32";
+static const uint8_t AP_BSSID[6] = { 0x24, 0x0a, 0xc4, 0x11, 0x22, 0x33 };
+
+static void test_hex_psk_round_trip(void)
+{
+    TEST_ASSERT_EQ(WIFI_PASS_MAX_LEN, strlen(HEX_PSK));
+    TEST_ASSERT_EQ(WIFI_SSID_MAX_LEN, strlen(LONG_SSID));
+
+    // Conexión: la estación recibe los 64 y 32 bytes completos
+    TEST_ASSERT_EQ(ESP_OK, wifi_manager_connect(LONG_SSID, HEX_PSK));
+    TEST_ASSERT_EQ(WIFI_MANAGER_STATE_CONNECTING, wifi_manager_get_state());
+    const wifi_config_t *sta = wifi_fake_sta_config();
+    TEST_ASSERT(memcmp(sta->sta.ssid, LONG_SSID, WIFI_SSID_MAX_LEN) == 0);
+    TEST_ASSERT(memcmp(sta->sta.password, HEX_PSK, WIFI_PASS_MAX_LEN) == 0);
+
+    // Con IP se guardan en NVS
+    wifi_fake_got_ip(AP_BSSID, 6);
+    TEST_ASSERT_EQ(WIFI_MANAGER_STATE_CONNECTED, wifi_manager_get_state());
+
+    // Tras un corte de energía se leen enteras
+    hal_host_nvs_power_cut();
+    TEST_ASSERT_EQ(ESP_OK, hal_nvs_init());
+    wifi_credentials_t creds;
+    TEST_ASSERT_EQ(ESP_OK, wifi_prov_get_credentials(&creds));
+    TEST_ASSERT_STR(LONG_SSID, creds.ssid);
+    TEST_ASSERT_STR(HEX_PSK, creds.password);
+
+    wifi_ap_info_t ap;
+    TEST_ASSERT_EQ(ESP_OK, wifi_prov_get_ap_info(LONG_SSID, &ap));
+    TEST_ASSERT(ap.valid);
+    TEST_ASSERT_EQ(6, ap.channel);
+    TEST_ASSERT(memcmp(ap.bssid, AP_BSSID, sizeof(AP_BSSID)) == 0);
+}
+
+static void test_oversized_credentials_rejected(void)
+{
+    // Un carácter de más no se recorta: la clave quedaría inválida
+    char pass[WIFI_PASS_MAX_LEN + 2];
+    memset(pass, 'a', sizeof(pass) - 1);
+    pass[sizeof(pass) - 1] = '\0';
+    TEST_ASSERT_EQ(ESP_ERR_INVALID_ARG, wifi_manager_connect("red", pass));
+
+    char ssid[WIFI_SSID_MAX_LEN + 2];
+    memset(ssid, 's', sizeof(ssid) - 1);
+    ssid[sizeof(ssid) - 1] = '\0';
+    TEST_ASSERT_EQ(ESP_ERR_INVALID_ARG, wifi_manager_connect(ssid, "clave-valida"));
+
+    // La red guardada sigue conectada
+    TEST_ASSERT_EQ(WIFI_MANAGER_STATE_CONNECTED, wifi_manager_get_state());
+}
+
+int main(void)
+{
+    hal_host_reset();
+    // Sin credenciales guardadas el gestor arranca esperando el provisioning
+    if (hal_nvs_init() != ESP_OK || wifi_manager_init() != ESP_OK) {
+        fprintf(stderr, "wifi_manager_init falló\n");
+        return 1;
+    }
+
+    RUN_TEST(test_hex_psk_round_trip);
+    RUN_TEST(test_oversized_credentials_rejected);
+    return TEST_REPORT();
+}
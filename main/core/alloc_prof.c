@@ -0,0 +1,424 @@
+/**
+ * @file alloc_prof.c
+ * @brief Implementación del perfil de reservas de heap.
+ * @details Las envolturas __wrap_* existen solo con CONFIG_ALLOC_PROF_ENABLE, que es también
+ *          cuando main/CMakeLists.txt agrega los -Wl,--wrap. Mientras el perfil no está activo
+ *          cada envoltura cuesta una lectura de `s_active`. Las tablas son estáticas: contar
+ *          una reserva nunca reserva memoria.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#include "alloc_prof.h"
+#include "sdkconfig.h"
+#include <string.h>
+
+#if CONFIG_ALLOC_PROF_ENABLE
+
+#include "metrics.h"
+#include "scheduler.h"
+#include "pid_controller.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_heap_caps.h"
+#include "esp_cpu.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include <stdio.h>
+
+static const char *TAG = "ALLOC";
+
+#define ALLOC_PROF_LOG_SITES    12      ///< Sitios listados en el informe del log
+
+typedef struct {
+    TaskHandle_t handle;
+    alloc_prof_task_t stats;
+} task_entry_t;
+
+static volatile bool s_active = false;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static alloc_prof_site_t s_sites[ALLOC_PROF_MAX_SITES];
+static size_t s_site_count = 0;
+static task_entry_t s_tasks[ALLOC_PROF_MAX_TASKS];
+static size_t s_task_count = 0;
+static alloc_prof_stats_t s_totals;
+static int64_t s_window_start_us = 0;
+static sched_job_handle_t s_warmup_job = NULL;
+
+// ───────────────────────────────────────────────────────
+// Registro (sin reservar memoria; lock tomado)
+
+static alloc_prof_site_t *site_find(uintptr_t caller)
+{
+    for (size_t i = 0; i < s_site_count; i++) {
+        if (s_sites[i].caller == caller) {
+            return &s_sites[i];
+        }
+    }
+    return NULL;
+}
+
+static task_entry_t *task_find(TaskHandle_t handle)
+{
+    for (size_t i = 0; i < s_task_count; i++) {
+        if (s_tasks[i].handle == handle) {
+            return &s_tasks[i];
+        }
+    }
+    return NULL;
+}
+
+static void copy_task_name(char *dst, TaskHandle_t handle)
+{
+    const char *name = handle ? pcTaskGetName(handle) : "boot";
+    strncpy(dst, name, ALLOC_PROF_NAME_LEN - 1);
+    dst[ALLOC_PROF_NAME_LEN - 1] = '\0';
+}
+
+static void record_alloc(uintptr_t ra, size_t size)
+{
+    if (!s_active) {
+        return;
+    }
+    if (xPortInIsrContext()) {
+        portENTER_CRITICAL_ISR(&s_lock);
+        s_totals.allocs++;
+        s_totals.bytes_alloc += size;
+        s_totals.isr_allocs++;
+        portEXIT_CRITICAL_ISR(&s_lock);
+        return;
+    }
+
+    const TaskHandle_t task = xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED ? NULL
+                                                                                  : xTaskGetCurrentTaskHandle();
+    const uintptr_t caller = esp_cpu_process_stack_pc(ra);
+    bool dropped = false;
+
+    portENTER_CRITICAL(&s_lock);
+    s_totals.allocs++;
+    s_totals.bytes_alloc += size;
+
+    alloc_prof_site_t *site = site_find(caller);
+    if (site == NULL && s_site_count < ALLOC_PROF_MAX_SITES) {
+        site = &s_sites[s_site_count++];
+        site->caller = caller;
+        copy_task_name(site->task, task);
+    }
+    if (site) {
+        site->allocs++;
+        site->bytes += size;
+    } else {
+        dropped = true;
+    }
+
+    task_entry_t *t = task_find(task);
+    if (t == NULL && s_task_count < ALLOC_PROF_MAX_TASKS) {
+        t = &s_tasks[s_task_count++];
+        t->handle = task;
+        copy_task_name(t->stats.name, task);
+    }
+    if (t) {
+        t->stats.allocs++;
+        t->stats.bytes += size;
+    } else {
+        dropped = true;
+    }
+    if (dropped) {
+        s_totals.dropped++;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+static void record_free(void *ptr)
+{
+    if (!s_active || ptr == NULL) {
+        return;
+    }
+    const size_t size = heap_caps_get_allocated_size(ptr);
+    portENTER_CRITICAL_SAFE(&s_lock);
+    s_totals.frees++;
+    s_totals.bytes_freed += size;
+    portEXIT_CRITICAL_SAFE(&s_lock);
+}
+
+#define CALLER() ((uintptr_t)__builtin_return_address(0))
+
+// ───────────────────────────────────────────────────────
+// Envolturas del enlazador (-Wl,--wrap=<función>)
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+void *__real_heap_caps_malloc(size_t size, uint32_t caps);
+void *__real_heap_caps_calloc(size_t n, size_t size, uint32_t caps);
+
+void *__wrap_malloc(size_t size)
+{
+    void *p = __real_malloc(size);
+    if (p) {
+        record_alloc(CALLER(), size);
+    }
+    return p;
+}
+
+void *__wrap_calloc(size_t n, size_t size)
+{
+    void *p = __real_calloc(n, size);
+    if (p) {
+        record_alloc(CALLER(), n * size);
+    }
+    return p;
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    // El bloque viejo se mide antes de que realloc lo libere
+    const size_t old = (s_active && ptr) ? heap_caps_get_allocated_size(ptr) : 0;
+    void *p = __real_realloc(ptr, size);
+    if (p == NULL && size != 0) {
+        return NULL;    // Falló: el bloque viejo sigue reservado
+    }
+    if (s_active && ptr) {
+        portENTER_CRITICAL_SAFE(&s_lock);
+        s_totals.frees++;
+        s_totals.bytes_freed += old;
+        portEXIT_CRITICAL_SAFE(&s_lock);
+    }
+    if (p) {
+        record_alloc(CALLER(), size);
+    }
+    return p;
+}
+
+void __wrap_free(void *ptr)
+{
+    record_free(ptr);
+    __real_free(ptr);
+}
+
+void *__wrap_heap_caps_malloc(size_t size, uint32_t caps)
+{
+    void *p = __real_heap_caps_malloc(size, caps);
+    if (p) {
+        record_alloc(CALLER(), size);
+    }
+    return p;
+}
+
+void *__wrap_heap_caps_calloc(size_t n, size_t size, uint32_t caps)
+{
+    void *p = __real_heap_caps_calloc(n, size, caps);
+    if (p) {
+        record_alloc(CALLER(), n * size);
+    }
+    return p;
+}
+
+// ───────────────────────────────────────────────────────
+// Ventana, informes y métricas
+
+static void warmup_job(void *arg)
+{
+    (void)arg;
+    alloc_prof_reset(0);
+    ESP_LOGI(TAG, "Calentamiento terminado: se mide la rotación en régimen");
+}
+
+static void report_job(void *arg)
+{
+    (void)arg;
+    alloc_prof_log_report();
+}
+
+static void alloc_prof_metrics(metrics_writer_t *w, void *ctx)
+{
+    (void)ctx;
+    alloc_prof_stats_t st;
+    alloc_prof_get_stats(&st);
+    metrics_write_uint(w, "alloc_prof_steady", NULL, st.steady);
+    metrics_write_uint(w, "alloc_prof_window_ms", NULL, st.window_ms);
+    metrics_write_uint(w, "alloc_prof_allocs_total", NULL, st.allocs);
+    metrics_write_uint(w, "alloc_prof_frees_total", NULL, st.frees);
+    metrics_write_uint(w, "alloc_prof_alloc_bytes_total", NULL, st.bytes_alloc);
+    metrics_write_uint(w, "alloc_prof_freed_bytes_total", NULL, st.bytes_freed);
+    metrics_write_uint(w, "alloc_prof_isr_allocs_total", NULL, st.isr_allocs);
+    metrics_write_uint(w, "alloc_prof_dropped_total", NULL, st.dropped);
+    metrics_write_float(w, "alloc_prof_allocs_per_s", NULL, st.allocs_per_s);
+    metrics_write_float(w, "alloc_prof_allocs_per_cycle", NULL, st.allocs_per_cycle);
+
+    alloc_prof_task_t tasks[ALLOC_PROF_MAX_TASKS];
+    const size_t n = alloc_prof_get_tasks(tasks, ALLOC_PROF_MAX_TASKS);
+    char labels[40];
+    for (size_t i = 0; i < n; i++) {
+        snprintf(labels, sizeof(labels), "task=\"%s\"", tasks[i].name);
+        metrics_write_uint(w, "alloc_prof_task_allocs_total", labels, tasks[i].allocs);
+        metrics_write_uint(w, "alloc_prof_task_alloc_bytes_total", labels, tasks[i].bytes);
+    }
+}
+
+esp_err_t alloc_prof_init(void)
+{
+    if (s_warmup_job != NULL) {
+        return ESP_OK;
+    }
+    esp_err_t ret = sched_add("alloc_warmup", warmup_job, NULL, SCHED_DISARMED, 0, &s_warmup_job);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = sched_add("alloc_report", report_job, NULL, (CONFIG_ALLOC_PROF_WARMUP_S + CONFIG_ALLOC_PROF_REPORT_S) * 1000,
+                    CONFIG_ALLOC_PROF_REPORT_S * 1000, NULL);
+    metrics_register("alloc", alloc_prof_metrics, NULL);
+    alloc_prof_reset(CONFIG_ALLOC_PROF_WARMUP_S * 1000);
+    s_active = true;
+    ESP_LOGI(TAG, "Perfil de reservas activo; calentamiento de %d s", CONFIG_ALLOC_PROF_WARMUP_S);
+    return ret;
+}
+
+void alloc_prof_reset(uint32_t warmup_ms)
+{
+    portENTER_CRITICAL(&s_lock);
+    memset(s_sites, 0, sizeof(s_sites));
+    s_site_count = 0;
+    memset(s_tasks, 0, sizeof(s_tasks));
+    s_task_count = 0;
+    memset(&s_totals, 0, sizeof(s_totals));
+    s_totals.steady = warmup_ms == 0;
+    s_window_start_us = esp_timer_get_time();
+    portEXIT_CRITICAL(&s_lock);
+
+    if (s_warmup_job) {
+        if (warmup_ms) {
+            sched_trigger(s_warmup_job, warmup_ms);
+        } else {
+            sched_disarm(s_warmup_job);
+        }
+    }
+}
+
+void alloc_prof_get_stats(alloc_prof_stats_t *out)
+{
+    if (out == NULL) {
+        return;
+    }
+    portENTER_CRITICAL(&s_lock);
+    *out = s_totals;
+    const int64_t start = s_window_start_us;
+    portEXIT_CRITICAL(&s_lock);
+
+    out->window_ms = (uint32_t)((esp_timer_get_time() - start) / 1000);
+    out->allocs_per_s = out->window_ms ? out->allocs * 1000.0f / out->window_ms : 0.0f;
+    out->allocs_per_cycle = out->allocs_per_s * pid_get_sample_time_ms() / 1000.0f;
+}
+
+size_t alloc_prof_get_sites(alloc_prof_site_t *out, size_t max)
+{
+    if (out == NULL) {
+        return 0;
+    }
+    // Selección parcial: la tabla es corta y así no hace falta una copia en la pila
+    uint64_t taken = 0;
+    size_t n = 0;
+    portENTER_CRITICAL(&s_lock);
+    for (; n < max && n < s_site_count; n++) {
+        size_t best = SIZE_MAX;
+        for (size_t i = 0; i < s_site_count; i++) {
+            if (!(taken & (1ULL << i)) && (best == SIZE_MAX || s_sites[i].allocs > s_sites[best].allocs)) {
+                best = i;
+            }
+        }
+        taken |= 1ULL << best;
+        out[n] = s_sites[best];
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return n;
+}
+
+size_t alloc_prof_get_tasks(alloc_prof_task_t *out, size_t max)
+{
+    if (out == NULL) {
+        return 0;
+    }
+    uint32_t taken = 0;
+    size_t n = 0;
+    portENTER_CRITICAL(&s_lock);
+    for (; n < max && n < s_task_count; n++) {
+        size_t best = SIZE_MAX;
+        for (size_t i = 0; i < s_task_count; i++) {
+            if (!(taken & (1UL << i)) && (best == SIZE_MAX || s_tasks[i].stats.allocs > s_tasks[best].stats.allocs)) {
+                best = i;
+            }
+        }
+        taken |= 1UL << best;
+        out[n] = s_tasks[best].stats;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return n;
+}
+
+void alloc_prof_log_report(void)
+{
+    alloc_prof_stats_t st;
+    alloc_prof_get_stats(&st);
+    ESP_LOGI(TAG, "=== Reservas (%s): %lu en %lu ms, %.2f/s, %.2f por ciclo de control ===",
+             st.steady ? "régimen" : "calentamiento", (unsigned long)st.allocs, (unsigned long)st.window_ms,
+             st.allocs_per_s, st.allocs_per_cycle);
+    ESP_LOGI(TAG, "Bytes: +%lu -%lu (neto %ld), liberaciones %lu, ISR %lu, sin lugar %lu",
+             (unsigned long)st.bytes_alloc, (unsigned long)st.bytes_freed,
+             (long)(st.bytes_alloc - st.bytes_freed), (unsigned long)st.frees,
+             (unsigned long)st.isr_allocs, (unsigned long)st.dropped);
+
+    alloc_prof_task_t tasks[ALLOC_PROF_MAX_TASKS];
+    const size_t nt = alloc_prof_get_tasks(tasks, ALLOC_PROF_MAX_TASKS);
+    for (size_t i = 0; i < nt; i++) {
+        ESP_LOGI(TAG, "  tarea %-16s %8lu reservas %10lu bytes", tasks[i].name,
+                 (unsigned long)tasks[i].allocs, (unsigned long)tasks[i].bytes);
+    }
+
+    alloc_prof_site_t sites[ALLOC_PROF_LOG_SITES];
+    const size_t ns = alloc_prof_get_sites(sites, ALLOC_PROF_LOG_SITES);
+    for (size_t i = 0; i < ns; i++) {
+        ESP_LOGI(TAG, "  sitio 0x%08lx %-16s %8lu reservas %10lu bytes", (unsigned long)sites[i].caller,
+                 sites[i].task, (unsigned long)sites[i].allocs, (unsigned long)sites[i].bytes);
+    }
+}
+
+#else // !CONFIG_ALLOC_PROF_ENABLE
+
+esp_err_t alloc_prof_init(void)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void alloc_prof_reset(uint32_t warmup_ms)
+{
+    (void)warmup_ms;
+}
+
+void alloc_prof_get_stats(alloc_prof_stats_t *out)
+{
+    if (out) {
+        memset(out, 0, sizeof(*out));
+    }
+}
+
+size_t alloc_prof_get_sites(alloc_prof_site_t *out, size_t max)
+{
+    (void)out;
+    (void)max;
+    return 0;
+}
+
+size_t alloc_prof_get_tasks(alloc_prof_task_t *out, size_t max)
+{
+    (void)out;
+    (void)max;
+    return 0;
+}
+
+void alloc_prof_log_report(void)
+{
+}
+
+#endif // CONFIG_ALLOC_PROF_ENABLE
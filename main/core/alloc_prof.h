@@ -0,0 +1,114 @@
+/**
+ * @file alloc_prof.h
+ * @brief Perfil de reservas de heap por sitio de llamada y por tarea.
+ * @details Con CONFIG_ALLOC_PROF_ENABLE el enlazador redirige malloc, calloc, realloc, free,
+ *          heap_caps_malloc y heap_caps_calloc (-Wl,--wrap) a este módulo, que cuenta cada
+ *          reserva por dirección de retorno del llamador y por tarea antes de llamar a la
+ *          función original. Las direcciones se traducen con
+ *          `xtensa-esp32s3-elf-addr2line -pfe build/<app>.elf <dirección>`.
+ *
+ *          Tras CONFIG_ALLOC_PROF_WARMUP_S (arranque, conexión Wi-Fi, primeras pantallas) los
+ *          contadores se ponen en cero y empieza la ventana de régimen: lo que se cuenta desde
+ *          ahí es la rotación estable del heap. Cada CONFIG_ALLOC_PROF_REPORT_S se deja en el
+ *          log el informe de la ventana, con reservas por segundo y por ciclo de control. El
+ *          objetivo es que las tareas PID_Task y Sched queden en cero.
+ *
+ *          Quedan fuera las reservas internas de newlib (_malloc_r) y las hechas desde una
+ *          ISR, que solo se cuentan en total.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#ifndef ALLOC_PROF_H
+#define ALLOC_PROF_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ALLOC_PROF_MAX_SITES    64      ///< Sitios de llamada distintos que se siguen
+#define ALLOC_PROF_MAX_TASKS    24      ///< Tareas distintas que se siguen
+#define ALLOC_PROF_NAME_LEN     16      ///< Largo del nombre de tarea guardado
+
+/**
+ * @brief Reservas de un sitio de llamada en la ventana
+ */
+typedef struct {
+    uintptr_t caller;                   ///< Dirección de retorno en el llamador
+    char task[ALLOC_PROF_NAME_LEN];     ///< Tarea de la primera reserva del sitio
+    uint32_t allocs;                    ///< Reservas
+    uint32_t bytes;                     ///< Bytes pedidos
+} alloc_prof_site_t;
+
+/**
+ * @brief Reservas de una tarea en la ventana
+ */
+typedef struct {
+    char name[ALLOC_PROF_NAME_LEN];     ///< Nombre de la tarea ("isr" o "boot" fuera de tareas)
+    uint32_t allocs;                    ///< Reservas
+    uint32_t bytes;                     ///< Bytes pedidos
+} alloc_prof_task_t;
+
+/**
+ * @brief Totales de la ventana
+ */
+typedef struct {
+    bool steady;                ///< Terminó el calentamiento: la ventana mide el régimen
+    uint32_t window_ms;         ///< Duración de la ventana
+    uint32_t allocs;            ///< Reservas (incluye realloc)
+    uint32_t frees;             ///< Liberaciones
+    uint32_t bytes_alloc;       ///< Bytes reservados
+    uint32_t bytes_freed;       ///< Bytes liberados
+    uint32_t isr_allocs;        ///< Reservas desde una ISR (sin sitio)
+    uint32_t dropped;           ///< Reservas sin lugar en la tabla de sitios o de tareas
+    float allocs_per_s;         ///< Reservas por segundo en la ventana
+    float allocs_per_cycle;     ///< Reservas por ciclo de control (periodo del PID)
+} alloc_prof_stats_t;
+
+/**
+ * @brief Empieza a contar y programa el fin del calentamiento y los informes
+ * @details Requiere sched_init(). Las reservas anteriores no se cuentan.
+ * @return ESP_OK, el error de sched_add(), o ESP_ERR_NOT_SUPPORTED sin
+ *         CONFIG_ALLOC_PROF_ENABLE
+ */
+esp_err_t alloc_prof_init(void);
+
+/**
+ * @brief Pone los contadores en cero y empieza un calentamiento nuevo
+ * @param warmup_ms Duración del calentamiento; 0 abre la ventana de régimen de inmediato
+ */
+void alloc_prof_reset(uint32_t warmup_ms);
+
+/**
+ * @brief Copia los totales de la ventana
+ */
+void alloc_prof_get_stats(alloc_prof_stats_t *out);
+
+/**
+ * @brief Copia los sitios con más reservas, en orden descendente
+ * @return Sitios copiados
+ */
+size_t alloc_prof_get_sites(alloc_prof_site_t *out, size_t max);
+
+/**
+ * @brief Copia las tareas con más reservas, en orden descendente
+ * @return Tareas copiadas
+ */
+size_t alloc_prof_get_tasks(alloc_prof_task_t *out, size_t max);
+
+/**
+ * @brief Deja en el log los totales, las tareas y los sitios de la ventana
+ */
+void alloc_prof_log_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ALLOC_PROF_H
@@ -3,8 +3,8 @@
 #include "sensor.h"
 #include "CH422G.h"
 #include "pid_controller.h"
-#include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
+#include "timebase.h"
+#include "scheduler.h"
 #include <math.h>
 
 #ifndef M_PI
@@ -13,7 +13,13 @@
 
 static const char *TAG = "AH_AUTOTUNE";
 
-static TaskHandle_t ah_task_handle = NULL;
+#define AH_HYSTERESIS   0.5f    ///< °C
+#define AH_RELAY_HIGH   100.0f  ///< % duty high
+#define AH_RELAY_LOW    0.0f    ///< % duty low
+#define AH_MIN_CYCLES   5
+#define AH_STEP_MS      100     ///< Periodo del paso del relé
+
+static sched_job_handle_t ah_job = NULL;
 static bool params_ready = false;
 static float last_kp = 0.0f;
 static float last_ki = 0.0f;
@@ -21,64 +27,53 @@ static float last_kd = 0.0f;
 
 typedef struct {
     float setpoint;
-} ah_params_t;
-
-static ah_params_t s_params;
-
-static void astrom_hagglund_task(void *pv)
+    uint8_t cycleCount;
+    float periodSum;
+    int64_t lastOnUs;
+    float tempMax;
+    float tempMin;
+    bool relayState;
+} ah_state_t;
+
+static ah_state_t s_state;
+
+/**
+ * @brief Paso del ensayo de relé, ejecutado por el planificador cada AH_STEP_MS
+ */
+static void astrom_hagglund_step(void *ctx)
 {
-    const float hysteresis   = 0.5f;   // °C
-    const float relay_high   = 100.0f; // % duty high
-    const float relay_low    = 0.0f;   // % duty low
-    const uint8_t min_cycles = 5;
-    const uint32_t delay_ms  = 100;
-
-    const float d = (relay_high - relay_low) / 2.0f;  // Relay amplitude
-
-    uint8_t cycleCount = 0;
-    float periodSum = 0.0f;
-    TickType_t lastOnTick = 0;
-
-    float tempMax = -1000.0f;
-    float tempMin =  1000.0f;
-    bool relayState = false;
-
-    float setpoint = s_params.setpoint;
-
-    ESP_LOGI(TAG, "🧪 Autotune Åström-Hägglund iniciado (SP=%.2f)", setpoint);
-
-    while (cycleCount < min_cycles) {
-        float currentTemp = read_ema_temp();
-
-        if (currentTemp > tempMax) tempMax = currentTemp;
-        if (currentTemp < tempMin) tempMin = currentTemp;
-
-        if (!relayState && (currentTemp < setpoint - hysteresis)) {
-            relayState = true;
-            CH422G_EnsurePushPullMode();
-            CH422G_od_output(0x00); // SSR ON
-
-            TickType_t now = xTaskGetTickCount();
-            if (lastOnTick != 0) {
-                float period = (now - lastOnTick) / 1000.0f;
-                periodSum += period;
-                cycleCount++;
-                ESP_LOGI(TAG, "🔁 Periodo #%d: %.2f s", cycleCount, period);
-            }
-            lastOnTick = now;
-        } else if (relayState && (currentTemp > setpoint + hysteresis)) {
-            relayState = false;
-            CH422G_EnsurePushPullMode();
-            CH422G_od_output(0x02); // SSR OFF
+    ah_state_t *st = ctx;
+    const float currentTemp = read_ema_temp();
+
+    if (currentTemp > st->tempMax) st->tempMax = currentTemp;
+    if (currentTemp < st->tempMin) st->tempMin = currentTemp;
+
+    if (!st->relayState && (currentTemp < st->setpoint - AH_HYSTERESIS)) {
+        st->relayState = true;
+        CH422G_od_clear_bits(CH422G_OD_OUT_1); // SSR ON
+
+        int64_t now = timebase_mono_us();
+        if (st->lastOnUs != 0) {
+            float period = (now - st->lastOnUs) / 1e6f;
+            st->periodSum += period;
+            st->cycleCount++;
+            ESP_LOGI(TAG, "🔁 Periodo #%d: %.2f s", st->cycleCount, period);
         }
+        st->lastOnUs = now;
+    } else if (st->relayState && (currentTemp > st->setpoint + AH_HYSTERESIS)) {
+        st->relayState = false;
+        CH422G_od_set_bits(CH422G_OD_OUT_1); // SSR OFF
+    }
 
-        vTaskDelay(pdMS_TO_TICKS(delay_ms));
+    if (st->cycleCount < AH_MIN_CYCLES) {
+        return;
     }
 
-    CH422G_od_output(0x02); // Asegurar SSR OFF
+    CH422G_od_set_bits(CH422G_OD_OUT_1); // Asegurar SSR OFF
 
-    float Pu = periodSum / cycleCount;
-    float amplitude = (tempMax - tempMin) / 2.0f;
+    const float d = (AH_RELAY_HIGH - AH_RELAY_LOW) / 2.0f;  // Relay amplitude
+    float Pu = st->periodSum / st->cycleCount;
+    float amplitude = (st->tempMax - st->tempMin) / 2.0f;
     float Ku = (4.0f * d) / (M_PI * amplitude);
 
     // Fórmulas Åström-Hägglund (idénticas a Z-N para PID estándar)
@@ -93,23 +88,28 @@ static void astrom_hagglund_task(void *pv)
     pid_set_params(last_kp, last_ki, last_kd);
     enable_pid();
 
-    ah_task_handle = NULL;
-    vTaskDelete(NULL);
+    sched_cancel(ah_job);
+    ah_job = NULL;
 }
 
 esp_err_t astrom_hagglund_start(float setpoint)
 {
-    if (ah_task_handle != NULL) {
+    if (ah_job != NULL) {
         ESP_LOGW(TAG, "Autotune AH ya en ejecución");
         return ESP_ERR_INVALID_STATE;
     }
 
-    s_params.setpoint = setpoint;
+    s_state = (ah_state_t){
+        .setpoint = setpoint,
+        .tempMax = -1000.0f,
+        .tempMin = 1000.0f,
+    };
     params_ready = false;
 
-    if (xTaskCreate(astrom_hagglund_task, "AH_Autotune", 4096, NULL, 5, &ah_task_handle) != pdPASS) {
-        ESP_LOGE(TAG, "No se pudo crear la tarea AH");
-        ah_task_handle = NULL;
+    ESP_LOGI(TAG, "🧪 Autotune Åström-Hägglund iniciado (SP=%.2f)", setpoint);
+    if (sched_add("ah_autotune", astrom_hagglund_step, &s_state, 0, AH_STEP_MS, &ah_job) != ESP_OK) {
+        ESP_LOGE(TAG, "No se pudo registrar el autotune AH");
+        ah_job = NULL;
         return ESP_FAIL;
     }
     return ESP_OK;
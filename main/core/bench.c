@@ -0,0 +1,285 @@
+/**
+ * @file bench.c
+ * @brief Implementación de los micro-benchmarks.
+ * @details La repetición de calentamiento deja en la caché de flash el código de la prueba y
+ *          sus datos en la caché de la PSRAM; las medidas son del caso caliente. Las pruebas
+ *          que necesitan buffers grandes los reservan una vez por corrida (`setup`), fuera de
+ *          lo medido.
+ * @author TriptaLabs
+ * @version 1.1
+ * @date 2025-07-14
+ */
+
+#include "bench.h"
+#include "sensor.h"
+#include "pid_controller.h"
+#include "metrics.h"
+#include "statistics.h"
+#include "ws_server.h"
+#include "ui_events.h"
+#include "lvgl_port.h"
+#include "esp_cpu.h"
+#include "esp_heap_caps.h"
+#include "esp_private/esp_clk.h"
+#include "sdkconfig.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_METRICS_BUF   4096    ///< Salida de metrics_render() (todas las métricas)
+#define BENCH_FRAME_PIXELS  (LVGL_PORT_H_RES * LVGL_PORT_V_RES)
+
+/// Giro de la prueba de rotación: el configurado, o 90° si la pantalla no gira
+#if EXAMPLE_LVGL_PORT_ROTATION_DEGREE != 0
+#define BENCH_ROTATION      EXAMPLE_LVGL_PORT_ROTATION_DEGREE
+#else
+#define BENCH_ROTATION      90
+#endif
+
+/**
+ * @brief Una prueba: repite la operación `iterations` veces
+ * @details `setup` y `teardown` (opcionales) corren una vez por corrida, sin medir.
+ */
+typedef struct {
+    const char *name;
+    esp_err_t (*setup)(void);
+    esp_err_t (*run)(uint32_t iterations);
+    void (*teardown)(void);
+    uint32_t default_iterations;
+} bench_def_t;
+
+static volatile uint32_t s_sink;    ///< Evita que el compilador descarte los resultados
+static char *s_metrics_buf;
+static uint16_t *s_frame_src;
+static uint16_t *s_frame_dst;
+
+static esp_err_t bench_crc(uint32_t iterations)
+{
+    // Consulta de lectura del registro de temperatura, como en sensor.c
+    uint8_t frame[6] = { 0x01, 0x03, 0x00, 0x00, 0x00, 0x01 };
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        frame[5] = (uint8_t)i;
+        acc += modbus_crc(frame, sizeof(frame));
+    }
+    s_sink = acc;
+    return ESP_OK;
+}
+
+static esp_err_t bench_filter(uint32_t iterations)
+{
+    s_sink = (uint32_t)sensor_bench_filter(iterations);
+    return ESP_OK;
+}
+
+static esp_err_t bench_pid(uint32_t iterations)
+{
+    const float acc = pid_bench_compute(iterations);
+    s_sink = (uint32_t)acc;
+    return ESP_OK;
+}
+
+static esp_err_t bench_metrics_setup(void)
+{
+    s_metrics_buf = malloc(BENCH_METRICS_BUF);
+    return s_metrics_buf != NULL ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+static esp_err_t bench_metrics(uint32_t iterations)
+{
+    size_t len = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        len += metrics_render(s_metrics_buf, BENCH_METRICS_BUF, NULL);
+    }
+    s_sink = len;
+    return ESP_OK;
+}
+
+static void bench_metrics_teardown(void)
+{
+    free(s_metrics_buf);
+    s_metrics_buf = NULL;
+}
+
+static esp_err_t bench_status_json(uint32_t iterations)
+{
+    char json[160];
+    size_t len = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        len += ws_server_format_status(json, sizeof(json));
+    }
+    s_sink = len;
+    return ESP_OK;
+}
+
+static esp_err_t bench_chart(uint32_t iterations)
+{
+    return ui_events_bench_chart(iterations);
+}
+
+static esp_err_t bench_format_time(uint32_t iterations)
+{
+    s_sink = statistics_bench_format(iterations);
+    return ESP_OK;
+}
+
+static void bench_rotate_teardown(void)
+{
+    heap_caps_free(s_frame_src);
+    heap_caps_free(s_frame_dst);
+    s_frame_src = NULL;
+    s_frame_dst = NULL;
+}
+
+static esp_err_t bench_rotate_setup(void)
+{
+    // En la PSRAM, como los buffers de cuadro de lvgl_port.c
+    s_frame_src = heap_caps_malloc(BENCH_FRAME_PIXELS * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
+    s_frame_dst = heap_caps_malloc(BENCH_FRAME_PIXELS * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
+    if (s_frame_src == NULL || s_frame_dst == NULL) {
+        bench_rotate_teardown();
+        return ESP_ERR_NO_MEM;
+    }
+    for (uint32_t i = 0; i < BENCH_FRAME_PIXELS; i++) {
+        s_frame_src[i] = (uint16_t)(i * 2654435761u >> 16);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t bench_rotate(uint32_t iterations)
+{
+    // Cada iteración es un cuadro completo, lo que copia el modo de refresco completo
+    for (uint32_t i = 0; i < iterations; i++) {
+        lvgl_port_rotate_copy_pixel(s_frame_src, s_frame_dst, 0, 0, LVGL_PORT_H_RES - 1, LVGL_PORT_V_RES - 1,
+                                    LVGL_PORT_H_RES, LVGL_PORT_V_RES, BENCH_ROTATION);
+    }
+    s_sink = s_frame_dst[iterations % BENCH_FRAME_PIXELS];
+    return ESP_OK;
+}
+
+static const bench_def_t s_benches[] = {
+    { "crc",         NULL,                bench_crc,         NULL,                   100000 },
+    { "filter",      NULL,                bench_filter,      NULL,                   100000 },
+    { "pid_compute", NULL,                bench_pid,         NULL,                   100000 },
+    { "metrics",     bench_metrics_setup, bench_metrics,     bench_metrics_teardown, 100    },
+    { "status_json", NULL,                bench_status_json, NULL,                   1000   },
+    { "chart",       NULL,                bench_chart,       NULL,                   100    },
+    { "format_time", NULL,                bench_format_time, NULL,                   10000  },
+    { "rotate",      bench_rotate_setup,  bench_rotate,      bench_rotate_teardown,  5      },
+};
+
+#define BENCH_COUNT (sizeof(s_benches) / sizeof(s_benches[0]))
+
+size_t bench_count(void)
+{
+    return BENCH_COUNT;
+}
+
+const char *bench_name(size_t index)
+{
+    return index < BENCH_COUNT ? s_benches[index].name : NULL;
+}
+
+uint32_t bench_default_iterations(size_t index)
+{
+    return index < BENCH_COUNT ? s_benches[index].default_iterations : 0;
+}
+
+/**
+ * @brief Ordena las duraciones de las repeticiones (son pocas: inserción)
+ */
+static void sort_cycles(uint32_t *v, uint32_t n)
+{
+    for (uint32_t i = 1; i < n; i++) {
+        const uint32_t x = v[i];
+        uint32_t j = i;
+        while (j > 0 && v[j - 1] > x) {
+            v[j] = v[j - 1];
+            j--;
+        }
+        v[j] = x;
+    }
+}
+
+/**
+ * @brief Calentamiento y repeticiones medidas; deja los ciclos de cada repetición en `cycles`
+ */
+static esp_err_t bench_measure(const bench_def_t *def, uint32_t iterations, uint32_t repeats, uint32_t *cycles)
+{
+    esp_err_t err = def->run(iterations);
+    for (uint32_t r = 0; r < repeats && err == ESP_OK; r++) {
+        const esp_cpu_cycle_count_t start = esp_cpu_get_cycle_count();
+        err = def->run(iterations);
+        cycles[r] = (uint32_t)(esp_cpu_get_cycle_count() - start);
+    }
+    return err;
+}
+
+esp_err_t bench_run(const char *name, uint32_t iterations, uint32_t repeats, bench_result_t *out)
+{
+    if (name == NULL || out == NULL || repeats > BENCH_MAX_REPEATS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const bench_def_t *def = NULL;
+    for (size_t i = 0; i < BENCH_COUNT; i++) {
+        if (strcmp(s_benches[i].name, name) == 0) {
+            def = &s_benches[i];
+            break;
+        }
+    }
+    if (def == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (iterations == 0) {
+        iterations = def->default_iterations;
+    }
+    if (repeats == 0) {
+        repeats = BENCH_DEFAULT_REPEATS;
+    }
+
+    esp_err_t err = def->setup != NULL ? def->setup() : ESP_OK;
+    if (err != ESP_OK) {
+        return err;
+    }
+    uint32_t cycles[BENCH_MAX_REPEATS];
+    err = bench_measure(def, iterations, repeats, cycles);
+    if (def->teardown != NULL) {
+        def->teardown();
+    }
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    uint64_t sum = 0;
+    for (uint32_t r = 0; r < repeats; r++) {
+        sum += cycles[r];
+    }
+    sort_cycles(cycles, repeats);
+    const uint32_t median = repeats % 2 ? cycles[repeats / 2]
+                                        : (uint32_t)(((uint64_t)cycles[repeats / 2 - 1] + cycles[repeats / 2]) / 2);
+    const uint32_t mhz = (uint32_t)(esp_clk_cpu_freq() / 1000000);
+
+    memset(out, 0, sizeof(*out));
+    out->name = def->name;
+    out->iterations = iterations;
+    out->repeats = repeats;
+    out->cpu_mhz = mhz;
+    out->total_us = mhz > 0 ? (uint32_t)(sum / mhz) : 0;
+    out->cycles_per_op = (float)median / iterations;
+    out->cycles_min = (float)cycles[0] / iterations;
+    out->cycles_mean = (float)sum / repeats / iterations;
+    out->cycles_max = (float)cycles[repeats - 1] / iterations;
+    out->ns_per_op = mhz > 0 ? out->cycles_per_op * 1000.0f / mhz : 0.0f;
+    return ESP_OK;
+}
+
+int bench_format_json(const bench_result_t *res, char *buf, size_t size)
+{
+    return snprintf(buf, size,
+                    "{\"bench\":\"%s\",\"target\":\"%s\",\"iters\":%lu,\"reps\":%lu,\"total_us\":%lu,"
+                    "\"ns_per_op\":%.1f,\"cycles_per_op\":%.1f,\"cycles_min\":%.1f,\"cycles_mean\":%.1f,"
+                    "\"cycles_max\":%.1f,\"cpu_mhz\":%lu}",
+                    res->name, CONFIG_IDF_TARGET, (unsigned long)res->iterations, (unsigned long)res->repeats,
+                    (unsigned long)res->total_us, res->ns_per_op, res->cycles_per_op, res->cycles_min,
+                    res->cycles_mean, res->cycles_max, (unsigned long)res->cpu_mhz);
+}
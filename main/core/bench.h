@@ -0,0 +1,93 @@
+/**
+ * @file bench.h
+ * @brief Micro-benchmarks del camino caliente, en el equipo y en el host.
+ * @details Cada prueba repite una operación (CRC Modbus, decodificación y filtro EMA del sensor,
+ *          cálculo PID, serializadores de métricas y de estado, volcado de la gráfica, formato
+ *          de duraciones, rotación de píxeles) un número de iteraciones. Una corrida hace una
+ *          repetición de calentamiento sin medir y luego `repeats` repeticiones medidas con el
+ *          contador de ciclos de la CPU (esp_cpu_get_cycle_count(): CCOUNT en el ESP32-S3; en
+ *          el host, el TSC o CLOCK_MONOTONIC). Se informan los ciclos por iteración de la mejor,
+ *          la mediana, la media y la peor repetición; la mediana es la cifra a comparar entre
+ *          versiones, y la peor muestra cuánto molestaron las interrupciones y otras tareas.
+ *
+ *          El contador es de 32 bits: una repetición tiene que durar menos de 2^32 ciclos
+ *          (unos 17 s a 240 MHz). El resultado se formatea como una línea JSON para que un
+ *          script pueda recogerlo de la consola serie (serial_console.h) o de tripta_bench en
+ *          el host. Las pruebas corren en la tarea que las llama, sin ceder la CPU: con muchas
+ *          iteraciones pueden demorar otras tareas de igual o menor prioridad en ese núcleo.
+ * @author TriptaLabs
+ * @version 1.1
+ * @date 2025-07-14
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BENCH_DEFAULT_REPEATS   5       ///< Repeticiones medidas si no se piden otras
+#define BENCH_MAX_REPEATS       31      ///< Repeticiones medidas como máximo
+
+/**
+ * @brief Resultado de una corrida
+ */
+typedef struct {
+    const char *name;           ///< Nombre de la prueba
+    uint32_t iterations;        ///< Iteraciones por repetición
+    uint32_t repeats;           ///< Repeticiones medidas
+    uint32_t total_us;          ///< Tiempo de todas las repeticiones medidas
+    float ns_per_op;            ///< Nanosegundos por iteración (mediana)
+    float cycles_per_op;        ///< Ciclos por iteración (mediana)
+    float cycles_min;           ///< Ciclos por iteración de la mejor repetición
+    float cycles_mean;          ///< Ciclos por iteración, media de las repeticiones
+    float cycles_max;           ///< Ciclos por iteración de la peor repetición
+    uint32_t cpu_mhz;           ///< Frecuencia del contador de ciclos durante la corrida
+} bench_result_t;
+
+/**
+ * @brief Cantidad de pruebas registradas
+ */
+size_t bench_count(void);
+
+/**
+ * @brief Nombre de la prueba `index`, o NULL fuera de rango
+ */
+const char *bench_name(size_t index);
+
+/**
+ * @brief Iteraciones por defecto de la prueba `index` (0 fuera de rango)
+ */
+uint32_t bench_default_iterations(size_t index);
+
+/**
+ * @brief Ejecuta una prueba
+ * @param name Nombre de la prueba
+ * @param iterations Iteraciones por repetición; 0 usa las de por defecto
+ * @param repeats Repeticiones medidas (hasta BENCH_MAX_REPEATS); 0 usa BENCH_DEFAULT_REPEATS
+ * @param[out] out Resultado
+ * @return ESP_OK, ESP_ERR_NOT_FOUND (nombre desconocido), ESP_ERR_INVALID_ARG (demasiadas
+ *         repeticiones), o el error de la prueba (p. ej. ESP_ERR_INVALID_STATE si la interfaz
+ *         aún no existe, ESP_ERR_NO_MEM sin memoria para sus buffers)
+ */
+esp_err_t bench_run(const char *name, uint32_t iterations, uint32_t repeats, bench_result_t *out);
+
+/**
+ * @brief Formatea un resultado como objeto JSON en una línea
+ * @details `{"bench":"crc","target":"esp32s3","iters":100000,"reps":5,"total_us":61234,
+ *          "ns_per_op":122.4,"cycles_per_op":29.4,"cycles_min":29.3,"cycles_mean":29.5,
+ *          "cycles_max":30.1,"cpu_mhz":240}`
+ * @return Bytes necesarios (sin '\0'), como snprintf()
+ */
+int bench_format_json(const bench_result_t *res, char *buf, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BENCH_H
@@ -0,0 +1,790 @@
+/**
+ * @file ble_service.c
+ * @brief Implementación de los servicios GATT de telemetría, control y provisioning.
+ * @details Usa la API de publicidad extendida de Bluedroid (el proyecto habilita las
+ *          funciones BLE 5.0 y no las 4.2) con PDUs heredados, para que cualquier
+ *          teléfono vea el anuncio.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#include "ble_service.h"
+#include "bt.h"
+#include "pid_controller.h"
+#include "sensor.h"
+#include "timebase.h"
+#include "metrics.h"
+#include "wifi_manager.h"
+#include "scheduler.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "esp_gap_ble_api.h"
+#include "esp_gatts_api.h"
+#include "esp_gatt_common_api.h"
+#include "freertos/FreeRTOS.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "BLE_SVC";
+
+#define BLE_APP_ID              0x55
+#define BLE_ADV_INSTANCE        0
+#define BLE_SAMPLE_MS           CONFIG_BLE_TELEMETRY_SAMPLE_MS
+#define BLE_MAX_LATENCY_MS      CONFIG_BLE_TELEMETRY_MAX_LATENCY_MS
+#define BLE_BATCH_HEADER        6       ///< uint32 t0_ms + uint16 period_ms
+#define BLE_ATT_OVERHEAD        3       ///< Opcode + handle de una notificación
+#define BLE_PREP_BUF_LEN        128     ///< Escrituras largas (clave WiFi con MTU 23)
+
+// ───────────────────────────────────────────────────────
+// UUIDs (128 bits, little endian). Base: 6b1c0000-4a2e-4f5b-9c1d-7269707461ab
+
+#define TRIPTA_UUID(id) { 0xab, 0x61, 0x74, 0x70, 0x69, 0x72, 0x1d, 0x9c, \
+                          0x5b, 0x4f, 0x2e, 0x4a, (id) & 0xff, ((id) >> 8) & 0xff, 0x1c, 0x6b }
+
+static const uint8_t uuid_svc_telemetry[16] = TRIPTA_UUID(0x0100);
+static const uint8_t uuid_chr_temp[16]      = TRIPTA_UUID(0x0101);
+static const uint8_t uuid_chr_setpoint[16]  = TRIPTA_UUID(0x0102);
+static const uint8_t uuid_chr_duty[16]      = TRIPTA_UUID(0x0103);
+static const uint8_t uuid_chr_ssr[16]       = TRIPTA_UUID(0x0104);
+static const uint8_t uuid_chr_alarms[16]    = TRIPTA_UUID(0x0105);
+static const uint8_t uuid_chr_control[16]   = TRIPTA_UUID(0x0106);
+
+static const uint8_t uuid_svc_prov[16]      = TRIPTA_UUID(0x0200);
+static const uint8_t uuid_chr_ssid[16]      = TRIPTA_UUID(0x0201);
+static const uint8_t uuid_chr_pass[16]      = TRIPTA_UUID(0x0202);
+static const uint8_t uuid_chr_apply[16]     = TRIPTA_UUID(0x0203);
+static const uint8_t uuid_chr_status[16]    = TRIPTA_UUID(0x0204);
+
+static const uint16_t uuid_primary_service = ESP_GATT_UUID_PRI_SERVICE;
+static const uint16_t uuid_char_declare = ESP_GATT_UUID_CHAR_DECLARE;
+static const uint16_t uuid_char_cccd = ESP_GATT_UUID_CHAR_CLIENT_CONFIG;
+
+static const uint8_t prop_read_notify = ESP_GATT_CHAR_PROP_BIT_READ | ESP_GATT_CHAR_PROP_BIT_NOTIFY;
+static const uint8_t prop_read_write_notify = ESP_GATT_CHAR_PROP_BIT_READ | ESP_GATT_CHAR_PROP_BIT_WRITE |
+                                              ESP_GATT_CHAR_PROP_BIT_NOTIFY;
+static const uint8_t prop_write = ESP_GATT_CHAR_PROP_BIT_WRITE;
+
+// ───────────────────────────────────────────────────────
+// Tablas de atributos
+
+enum {
+    TEL_IDX_SVC,
+    TEL_IDX_TEMP_CHAR, TEL_IDX_TEMP_VAL, TEL_IDX_TEMP_CCCD,
+    TEL_IDX_SP_CHAR, TEL_IDX_SP_VAL, TEL_IDX_SP_CCCD,
+    TEL_IDX_DUTY_CHAR, TEL_IDX_DUTY_VAL, TEL_IDX_DUTY_CCCD,
+    TEL_IDX_SSR_CHAR, TEL_IDX_SSR_VAL, TEL_IDX_SSR_CCCD,
+    TEL_IDX_ALARM_CHAR, TEL_IDX_ALARM_VAL, TEL_IDX_ALARM_CCCD,
+    TEL_IDX_CTRL_CHAR, TEL_IDX_CTRL_VAL,
+    TEL_IDX_NB
+};
+
+enum {
+    PROV_IDX_SVC,
+    PROV_IDX_SSID_CHAR, PROV_IDX_SSID_VAL,
+    PROV_IDX_PASS_CHAR, PROV_IDX_PASS_VAL,
+    PROV_IDX_APPLY_CHAR, PROV_IDX_APPLY_VAL,
+    PROV_IDX_STATUS_CHAR, PROV_IDX_STATUS_VAL, PROV_IDX_STATUS_CCCD,
+    PROV_IDX_NB
+};
+
+static uint8_t temp_value[BLE_BATCH_HEADER + 2 * BLE_SERVICE_BATCH_MAX];
+static uint8_t setpoint_value[2];
+static uint8_t duty_value[1];
+static uint8_t ssr_value[1];
+static uint8_t alarm_value[4];
+static uint8_t status_value[1];
+static uint8_t cccd_default[2] = { 0x00, 0x00 };
+
+#define ATTR_DECL(prop) \
+    { { ESP_GATT_AUTO_RSP }, { ESP_UUID_LEN_16, (uint8_t *)&uuid_char_declare, ESP_GATT_PERM_READ, \
+      sizeof(uint8_t), sizeof(uint8_t), (uint8_t *)&(prop) } }
+#define ATTR_VALUE(uuid, perm, buf) \
+    { { ESP_GATT_AUTO_RSP }, { ESP_UUID_LEN_128, (uint8_t *)(uuid), (perm), sizeof(buf), sizeof(buf), (buf) } }
+#define ATTR_CCCD() \
+    { { ESP_GATT_AUTO_RSP }, { ESP_UUID_LEN_16, (uint8_t *)&uuid_char_cccd, \
+      ESP_GATT_PERM_READ | ESP_GATT_PERM_WRITE, sizeof(cccd_default), sizeof(cccd_default), cccd_default } }
+
+static const esp_gatts_attr_db_t telemetry_db[TEL_IDX_NB] = {
+    [TEL_IDX_SVC] = { { ESP_GATT_AUTO_RSP }, { ESP_UUID_LEN_16, (uint8_t *)&uuid_primary_service,
+                      ESP_GATT_PERM_READ, sizeof(uuid_svc_telemetry), sizeof(uuid_svc_telemetry),
+                      (uint8_t *)uuid_svc_telemetry } },
+    [TEL_IDX_TEMP_CHAR]  = ATTR_DECL(prop_read_notify),
+    [TEL_IDX_TEMP_VAL]   = ATTR_VALUE(uuid_chr_temp, ESP_GATT_PERM_READ, temp_value),
+    [TEL_IDX_TEMP_CCCD]  = ATTR_CCCD(),
+    [TEL_IDX_SP_CHAR]    = ATTR_DECL(prop_read_write_notify),
+    // Consigna y control responden desde la aplicación: el cliente recibe el estado real de la orden
+    [TEL_IDX_SP_VAL]     = { { ESP_GATT_RSP_BY_APP }, { ESP_UUID_LEN_128, (uint8_t *)uuid_chr_setpoint,
+                             ESP_GATT_PERM_READ | ESP_GATT_PERM_WRITE_ENCRYPTED, sizeof(setpoint_value),
+                             sizeof(setpoint_value), setpoint_value } },
+    [TEL_IDX_SP_CCCD]    = ATTR_CCCD(),
+    [TEL_IDX_DUTY_CHAR]  = ATTR_DECL(prop_read_notify),
+    [TEL_IDX_DUTY_VAL]   = ATTR_VALUE(uuid_chr_duty, ESP_GATT_PERM_READ, duty_value),
+    [TEL_IDX_DUTY_CCCD]  = ATTR_CCCD(),
+    [TEL_IDX_SSR_CHAR]   = ATTR_DECL(prop_read_notify),
+    [TEL_IDX_SSR_VAL]    = ATTR_VALUE(uuid_chr_ssr, ESP_GATT_PERM_READ, ssr_value),
+    [TEL_IDX_SSR_CCCD]   = ATTR_CCCD(),
+    [TEL_IDX_ALARM_CHAR] = ATTR_DECL(prop_read_notify),
+    [TEL_IDX_ALARM_VAL]  = ATTR_VALUE(uuid_chr_alarms, ESP_GATT_PERM_READ, alarm_value),
+    [TEL_IDX_ALARM_CCCD] = ATTR_CCCD(),
+    [TEL_IDX_CTRL_CHAR]  = ATTR_DECL(prop_write),
+    [TEL_IDX_CTRL_VAL]   = { { ESP_GATT_RSP_BY_APP }, { ESP_UUID_LEN_128, (uint8_t *)uuid_chr_control,
+                             ESP_GATT_PERM_WRITE_ENCRYPTED, 16, 0, NULL } },
+};
+
+static const esp_gatts_attr_db_t prov_db[PROV_IDX_NB] = {
+    [PROV_IDX_SVC] = { { ESP_GATT_AUTO_RSP }, { ESP_UUID_LEN_16, (uint8_t *)&uuid_primary_service,
+                       ESP_GATT_PERM_READ, sizeof(uuid_svc_prov), sizeof(uuid_svc_prov),
+                       (uint8_t *)uuid_svc_prov } },
+    [PROV_IDX_SSID_CHAR]   = ATTR_DECL(prop_write),
+    [PROV_IDX_SSID_VAL]    = { { ESP_GATT_AUTO_RSP }, { ESP_UUID_LEN_128, (uint8_t *)uuid_chr_ssid,
+                               ESP_GATT_PERM_WRITE_ENCRYPTED, 32, 0, NULL } },
+    [PROV_IDX_PASS_CHAR]   = ATTR_DECL(prop_write),
+    [PROV_IDX_PASS_VAL]    = { { ESP_GATT_AUTO_RSP }, { ESP_UUID_LEN_128, (uint8_t *)uuid_chr_pass,
+                               ESP_GATT_PERM_WRITE_ENCRYPTED, 64, 0, NULL } },
+    [PROV_IDX_APPLY_CHAR]  = ATTR_DECL(prop_write),
+    [PROV_IDX_APPLY_VAL]   = { { ESP_GATT_AUTO_RSP }, { ESP_UUID_LEN_128, (uint8_t *)uuid_chr_apply,
+                               ESP_GATT_PERM_WRITE_ENCRYPTED, 1, 0, NULL } },
+    [PROV_IDX_STATUS_CHAR] = ATTR_DECL(prop_read_notify),
+    [PROV_IDX_STATUS_VAL]  = ATTR_VALUE(uuid_chr_status, ESP_GATT_PERM_READ, status_value),
+    [PROV_IDX_STATUS_CCCD] = ATTR_CCCD(),
+};
+
+// ───────────────────────────────────────────────────────
+// Publicidad (PDU heredado a través de la API extendida)
+
+static esp_ble_gap_ext_adv_params_t ext_adv_params = {
+    .type = ESP_BLE_GAP_SET_EXT_ADV_PROP_LEGACY_IND,
+    .interval_min = 0x100,      // 160 ms
+    .interval_max = 0x200,      // 320 ms
+    .channel_map = ADV_CHNL_ALL,
+    .own_addr_type = BLE_ADDR_TYPE_PUBLIC,
+    .filter_policy = ADV_FILTER_ALLOW_SCAN_ANY_CON_ANY,
+    .primary_phy = ESP_BLE_GAP_PHY_1M,
+    .secondary_phy = ESP_BLE_GAP_PHY_1M,
+    .sid = 0,
+    .scan_req_notif = false,
+    .tx_power = EXT_ADV_TX_PWR_NO_PREFERENCE,
+};
+
+static const esp_ble_gap_ext_adv_t ext_adv = {
+    .instance = BLE_ADV_INSTANCE,
+    .duration = 0,
+    .max_events = 0,
+};
+
+static uint8_t adv_data[3 + 2 + 16];        ///< Flags + lista completa de UUID de 128 bits
+static uint8_t scan_rsp_data[2 + 29];       ///< Nombre completo (recortado a lo que quepa)
+static uint8_t scan_rsp_len = 0;
+
+// ───────────────────────────────────────────────────────
+// Estado
+
+static bool s_registered = false;
+static bool s_active = false;               ///< Publicidad o conexión habilitadas
+static esp_gatt_if_t s_gatts_if = ESP_GATT_IF_NONE;
+static uint16_t tel_handles[TEL_IDX_NB];
+static uint16_t prov_handles[PROV_IDX_NB];
+static char s_device_name[33];
+
+static bool s_connected = false;
+static uint16_t s_conn_id = 0;
+static int64_t s_connect_us = 0;
+static volatile bool s_congested = false;
+static uint16_t s_notify_mask = 0;          ///< Bit por índice de valor con CCCD activo
+
+static sched_job_handle_t s_sample_job = NULL;
+static int16_t s_batch[BLE_SERVICE_BATCH_MAX];
+static uint8_t s_batch_count = 0;
+static uint32_t s_batch_t0_ms = 0;
+
+static int16_t s_last_setpoint = INT16_MIN;
+static uint8_t s_last_duty = UINT8_MAX;
+static int8_t s_last_ssr = -1;
+static uint32_t s_last_alarms = UINT32_MAX;
+
+static char s_prov_ssid[33];
+static char s_prov_pass[65];
+static uint8_t s_prep_buf[BLE_PREP_BUF_LEN];
+static uint16_t s_prep_len = 0;
+static uint16_t s_prep_handle = 0;
+
+static ble_service_stats_t s_stats;
+static size_t s_heap_before_tables = 0;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// ───────────────────────────────────────────────────────
+// Envío de notificaciones
+
+/**
+ * @brief Bit de s_notify_mask asociado al handle de un valor
+ */
+static uint16_t notify_bit(uint16_t value_handle)
+{
+    static const uint8_t tel_values[] = { TEL_IDX_TEMP_VAL, TEL_IDX_SP_VAL, TEL_IDX_DUTY_VAL,
+                                          TEL_IDX_SSR_VAL, TEL_IDX_ALARM_VAL };
+    for (size_t i = 0; i < sizeof(tel_values); i++) {
+        if (tel_handles[tel_values[i]] == value_handle) {
+            return 1u << i;
+        }
+    }
+    return value_handle == prov_handles[PROV_IDX_STATUS_VAL] ? 1u << 5 : 0;
+}
+
+/**
+ * @brief Actualiza el valor de un atributo y lo notifica si el cliente lo pidió
+ * @return true si se envió la notificación
+ */
+static bool publish(uint16_t handle, const uint8_t *value, uint16_t len)
+{
+    esp_ble_gatts_set_attr_value(handle, len, value);
+    if (!s_connected || s_congested || !(s_notify_mask & notify_bit(handle))) {
+        return false;
+    }
+    if (esp_ble_gatts_send_indicate(s_gatts_if, s_conn_id, handle, len, (uint8_t *)value, false) != ESP_OK) {
+        return false;
+    }
+    portENTER_CRITICAL(&s_lock);
+    s_stats.notifications++;
+    s_stats.bytes += len;
+    portEXIT_CRITICAL(&s_lock);
+    return true;
+}
+
+/**
+ * @brief Muestras que caben en una notificación con el MTU actual
+ */
+static uint8_t batch_capacity(void)
+{
+    const uint16_t mtu = s_stats.mtu ? s_stats.mtu : ESP_GATT_DEF_BLE_MTU_SIZE;
+    const size_t cap = (mtu - BLE_ATT_OVERHEAD - BLE_BATCH_HEADER) / 2;
+    return cap > BLE_SERVICE_BATCH_MAX ? BLE_SERVICE_BATCH_MAX : (uint8_t)cap;
+}
+
+/**
+ * @brief Envía el lote de temperaturas acumulado en una sola notificación
+ */
+static void flush_batch(void)
+{
+    if (s_batch_count == 0) {
+        return;
+    }
+
+    const uint16_t period = BLE_SAMPLE_MS;
+    memcpy(&temp_value[0], &s_batch_t0_ms, 4);
+    memcpy(&temp_value[4], &period, 2);
+    memcpy(&temp_value[BLE_BATCH_HEADER], s_batch, s_batch_count * 2);
+    const uint16_t len = BLE_BATCH_HEADER + s_batch_count * 2;
+
+    if (publish(tel_handles[TEL_IDX_TEMP_VAL], temp_value, len)) {
+        portENTER_CRITICAL(&s_lock);
+        s_stats.samples += s_batch_count;
+        portEXIT_CRITICAL(&s_lock);
+        s_batch_count = 0;
+    } else if (s_batch_count >= batch_capacity()) {
+        // Enlace congestionado o sin suscripción: descartar el lote en vez de crecer sin límite
+        portENTER_CRITICAL(&s_lock);
+        s_stats.samples_dropped += s_batch_count;
+        portEXIT_CRITICAL(&s_lock);
+        s_batch_count = 0;
+    }
+}
+
+/**
+ * @brief Muestrea el estado del controlador y notifica lo que cambió
+ */
+static void sample_job(void *arg)
+{
+    (void)arg;
+    const uint32_t now_ms = (uint32_t)timebase_mono_ms();
+
+    if (s_batch_count == 0) {
+        s_batch_t0_ms = now_ms;
+    }
+    if (s_batch_count < BLE_SERVICE_BATCH_MAX) {
+        s_batch[s_batch_count++] = (int16_t)(read_ema_temp() * 100.0f);
+    }
+    if (s_batch_count >= batch_capacity() || now_ms - s_batch_t0_ms >= BLE_MAX_LATENCY_MS) {
+        flush_batch();
+    }
+
+    const int16_t setpoint = (int16_t)(pid_get_setpoint() * 100.0f);
+    if (setpoint != s_last_setpoint) {
+        memcpy(setpoint_value, &setpoint, sizeof(setpoint));
+        publish(tel_handles[TEL_IDX_SP_VAL], setpoint_value, sizeof(setpoint_value));
+        s_last_setpoint = setpoint;
+    }
+
+    const uint8_t duty = (uint8_t)(pid_get_output() + 0.5f);
+    if (duty != s_last_duty) {
+        duty_value[0] = duty;
+        publish(tel_handles[TEL_IDX_DUTY_VAL], duty_value, sizeof(duty_value));
+        s_last_duty = duty;
+    }
+
+    const int8_t ssr = pid_ssr_status() ? 1 : 0;
+    if (ssr != s_last_ssr) {
+        ssr_value[0] = (uint8_t)ssr;
+        publish(tel_handles[TEL_IDX_SSR_VAL], ssr_value, sizeof(ssr_value));
+        s_last_ssr = ssr;
+    }
+
+    const uint32_t alarms = pid_get_alarms();
+    if (alarms != s_last_alarms) {
+        memcpy(alarm_value, &alarms, sizeof(alarms));
+        publish(tel_handles[TEL_IDX_ALARM_VAL], alarm_value, sizeof(alarm_value));
+        s_last_alarms = alarms;
+    }
+}
+
+// ───────────────────────────────────────────────────────
+// Escrituras
+
+/**
+ * @brief Ejecuta una orden de la característica de control
+ */
+static esp_gatt_status_t handle_control(const uint8_t *data, uint16_t len)
+{
+    if (len < 1) {
+        return ESP_GATT_INVALID_ATTR_LEN;
+    }
+
+    pid_cmd_t cmd = { .source = PID_SRC_BLE };
+    switch (data[0]) {
+    case BLE_CMD_PID_ENABLE:
+        cmd.type = PID_CMD_ENABLE;
+        break;
+    case BLE_CMD_PID_DISABLE:
+        cmd.type = PID_CMD_DISABLE;
+        break;
+    case BLE_CMD_SET_SETPOINT: {
+        if (len != 3) {
+            return ESP_GATT_INVALID_ATTR_LEN;
+        }
+        int16_t centi;
+        memcpy(&centi, &data[1], sizeof(centi));
+        cmd.type = PID_CMD_SET_SETPOINT;
+        cmd.setpoint = centi / 100.0f;
+        break;
+    }
+    case BLE_CMD_SET_PID_PARAMS: {
+        if (len != 1 + 3 * sizeof(float)) {
+            return ESP_GATT_INVALID_ATTR_LEN;
+        }
+        float k[3];
+        memcpy(k, &data[1], sizeof(k));
+        cmd.type = PID_CMD_SET_PARAMS;
+        cmd.gains.kp = k[0];
+        cmd.gains.ki = k[1];
+        cmd.gains.kd = k[2];
+        break;
+    }
+    default:
+        return ESP_GATT_REQ_NOT_SUPPORTED;
+    }
+
+    // Sin espera: la tarea de Bluedroid no debe bloquearse por la cola del PID
+    if (pid_submit(&cmd, 0) != ESP_OK) {
+        return ESP_GATT_BUSY;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    s_stats.commands++;
+    portEXIT_CRITICAL(&s_lock);
+    ESP_LOGI(TAG, "Orden BLE 0x%02x enviada al PID", data[0]);
+    return ESP_GATT_OK;
+}
+
+/**
+ * @brief Procesa una escritura completa sobre un atributo
+ *
+ * @return Estado GATT a devolver al cliente (el de handle_control para consigna y control)
+ */
+static esp_gatt_status_t handle_write(uint16_t handle, const uint8_t *data, uint16_t len)
+{
+    // Suscripciones (CCCD): el valor es el atributo siguiente al handle del valor
+    if (len == 2) {
+        const uint16_t bit = notify_bit(handle - 1);
+        if (bit && (handle == tel_handles[TEL_IDX_TEMP_CCCD] || handle == tel_handles[TEL_IDX_SP_CCCD] ||
+                    handle == tel_handles[TEL_IDX_DUTY_CCCD] || handle == tel_handles[TEL_IDX_SSR_CCCD] ||
+                    handle == tel_handles[TEL_IDX_ALARM_CCCD] || handle == prov_handles[PROV_IDX_STATUS_CCCD])) {
+            if (data[0] & 0x01) {
+                s_notify_mask |= bit;
+            } else {
+                s_notify_mask &= ~bit;
+            }
+            return ESP_GATT_OK;
+        }
+    }
+
+    if (handle == tel_handles[TEL_IDX_CTRL_VAL]) {
+        return handle_control(data, len);
+    } else if (handle == tel_handles[TEL_IDX_SP_VAL]) {
+        if (len != 2) {
+            return ESP_GATT_INVALID_ATTR_LEN;
+        }
+        const uint8_t cmd[3] = { BLE_CMD_SET_SETPOINT, data[0], data[1] };
+        return handle_control(cmd, sizeof(cmd));
+    } else if (handle == prov_handles[PROV_IDX_SSID_VAL]) {
+        const size_t n = len < sizeof(s_prov_ssid) - 1 ? len : sizeof(s_prov_ssid) - 1;
+        memcpy(s_prov_ssid, data, n);
+        s_prov_ssid[n] = '\0';
+    } else if (handle == prov_handles[PROV_IDX_PASS_VAL]) {
+        const size_t n = len < sizeof(s_prov_pass) - 1 ? len : sizeof(s_prov_pass) - 1;
+        memcpy(s_prov_pass, data, n);
+        s_prov_pass[n] = '\0';
+    } else if (handle == prov_handles[PROV_IDX_APPLY_VAL] && len >= 1 && data[0] == 1) {
+        ESP_LOGI(TAG, "Provisioning BLE: conectando a '%s'", s_prov_ssid);
+        if (wifi_manager_connect(s_prov_ssid, s_prov_pass) != ESP_OK) {
+            ESP_LOGW(TAG, "No se pudo aplicar la configuración WiFi");
+        }
+        memset(s_prov_pass, 0, sizeof(s_prov_pass));
+    }
+    return ESP_GATT_OK;
+}
+
+static void on_wifi_state(void *arg, esp_event_base_t base, int32_t state, void *data)
+{
+    status_value[0] = (uint8_t)state;
+    if (s_registered) {
+        publish(prov_handles[PROV_IDX_STATUS_VAL], status_value, sizeof(status_value));
+    }
+}
+
+// ───────────────────────────────────────────────────────
+// Métricas
+
+static void ble_metrics(metrics_writer_t *w, void *ctx)
+{
+    (void)ctx;
+    ble_service_stats_t st;
+    ble_service_get_stats(&st);
+    metrics_write_uint(w, "ble_connected", NULL, s_connected);
+    metrics_write_uint(w, "ble_mtu", NULL, st.mtu);
+    metrics_write_uint(w, "ble_notifications_total", NULL, st.notifications);
+    metrics_write_uint(w, "ble_notify_bytes_total", NULL, st.bytes);
+    metrics_write_uint(w, "ble_samples_total", NULL, st.samples);
+    metrics_write_uint(w, "ble_samples_dropped_total", NULL, st.samples_dropped);
+    metrics_write_uint(w, "ble_commands_total", NULL, st.commands);
+    metrics_write_uint(w, "ble_connected_seconds_total", NULL, st.connected_us / 1000000);
+    metrics_write_uint(w, "ble_stack_heap_bytes", NULL, bt_get_heap_cost());
+    metrics_write_uint(w, "ble_gatt_heap_bytes", NULL, st.heap_cost);
+}
+
+// ───────────────────────────────────────────────────────
+// Callbacks de Bluedroid
+
+static void start_advertising(void)
+{
+    if (s_active && !s_connected) {
+        esp_ble_gap_ext_adv_set_params(BLE_ADV_INSTANCE, &ext_adv_params);
+    }
+}
+
+static void gap_event_handler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t *param)
+{
+    switch (event) {
+    case ESP_GAP_BLE_EXT_ADV_SET_PARAMS_COMPLETE_EVT:
+        esp_ble_gap_config_ext_adv_data_raw(BLE_ADV_INSTANCE, sizeof(adv_data), adv_data);
+        break;
+    case ESP_GAP_BLE_EXT_ADV_DATA_SET_COMPLETE_EVT:
+        esp_ble_gap_config_ext_scan_rsp_data_raw(BLE_ADV_INSTANCE, scan_rsp_len, scan_rsp_data);
+        break;
+    case ESP_GAP_BLE_EXT_SCAN_RSP_DATA_SET_COMPLETE_EVT:
+        esp_ble_gap_ext_adv_start(1, &ext_adv);
+        break;
+    case ESP_GAP_BLE_EXT_ADV_START_COMPLETE_EVT:
+        ESP_LOGI(TAG, "Publicidad iniciada (estado %d)", param->ext_adv_start.status);
+        break;
+    case ESP_GAP_BLE_SEC_REQ_EVT:
+        // "Just works": cifra el enlace para las escrituras de control y provisioning
+        esp_ble_gap_security_rsp(param->ble_security.ble_req.bd_addr, true);
+        break;
+    case ESP_GAP_BLE_AUTH_CMPL_EVT:
+        ESP_LOGI(TAG, "Emparejamiento %s", param->ble_security.auth_cmpl.success ? "correcto" : "fallido");
+        break;
+    default:
+        break;
+    }
+}
+
+static void gatts_event_handler(esp_gatts_cb_event_t event, esp_gatt_if_t gatts_if, esp_ble_gatts_cb_param_t *param)
+{
+    switch (event) {
+    case ESP_GATTS_REG_EVT:
+        if (param->reg.status != ESP_GATT_OK) {
+            ESP_LOGE(TAG, "Registro GATT fallido: %d", param->reg.status);
+            return;
+        }
+        s_gatts_if = gatts_if;
+        esp_ble_gap_set_device_name(s_device_name);
+        s_heap_before_tables = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+        esp_ble_gatts_create_attr_tab(telemetry_db, gatts_if, TEL_IDX_NB, 0);
+        esp_ble_gatts_create_attr_tab(prov_db, gatts_if, PROV_IDX_NB, 1);
+        break;
+
+    case ESP_GATTS_CREAT_ATTR_TAB_EVT: {
+        const struct gatts_add_attr_tab_evt_param *tab = &param->add_attr_tab;
+        if (tab->status != ESP_GATT_OK) {
+            ESP_LOGE(TAG, "Error creando tabla de atributos: 0x%x", tab->status);
+            return;
+        }
+        if (tab->svc_inst_id == 0 && tab->num_handle == TEL_IDX_NB) {
+            memcpy(tel_handles, tab->handles, sizeof(tel_handles));
+            esp_ble_gatts_start_service(tel_handles[TEL_IDX_SVC]);
+        } else if (tab->svc_inst_id == 1 && tab->num_handle == PROV_IDX_NB) {
+            memcpy(prov_handles, tab->handles, sizeof(prov_handles));
+            esp_ble_gatts_start_service(prov_handles[PROV_IDX_SVC]);
+            s_registered = true;
+            s_stats.heap_cost = s_heap_before_tables - heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+            start_advertising();
+        }
+        break;
+    }
+
+    case ESP_GATTS_CONNECT_EVT: {
+        s_connected = true;
+        s_conn_id = param->connect.conn_id;
+        s_connect_us = esp_timer_get_time();
+        s_notify_mask = 0;
+        s_congested = false;
+        s_batch_count = 0;
+        s_last_setpoint = INT16_MIN;
+        s_last_duty = UINT8_MAX;
+        s_last_ssr = -1;
+        s_last_alarms = UINT32_MAX;
+
+        bt_connection_info_t info = { .is_connected = true, .conn_id = param->connect.conn_id };
+        const uint8_t *a = param->connect.remote_bda;
+        snprintf(info.remote_addr, sizeof(info.remote_addr), "%02X:%02X:%02X:%02X:%02X:%02X",
+                 a[0], a[1], a[2], a[3], a[4], a[5]);
+        bt_update_connection(&info);
+
+        // Intervalo largo con latencia de periférico: pocas ventanas de radio, los lotes llenan cada una
+        esp_ble_conn_update_params_t conn_params = {
+            .min_int = 0x50,    // 100 ms
+            .max_int = 0xA0,    // 200 ms
+            .latency = 4,
+            .timeout = 600,     // 6 s
+        };
+        memcpy(conn_params.bda, param->connect.remote_bda, sizeof(esp_bd_addr_t));
+        esp_ble_gap_update_conn_params(&conn_params);
+
+        sched_trigger(s_sample_job, BLE_SAMPLE_MS);
+        ESP_LOGI(TAG, "Cliente conectado: %s", info.remote_addr);
+        break;
+    }
+
+    case ESP_GATTS_DISCONNECT_EVT: {
+        sched_disarm(s_sample_job);
+        portENTER_CRITICAL(&s_lock);
+        s_stats.connected_us += esp_timer_get_time() - s_connect_us;
+        s_stats.mtu = 0;
+        portEXIT_CRITICAL(&s_lock);
+        s_connected = false;
+
+        const bt_connection_info_t info = { 0 };
+        bt_update_connection(&info);
+        ESP_LOGI(TAG, "Cliente desconectado (motivo 0x%x)", param->disconnect.reason);
+        ble_service_log_stats();
+        start_advertising();
+        break;
+    }
+
+    case ESP_GATTS_MTU_EVT:
+        portENTER_CRITICAL(&s_lock);
+        s_stats.mtu = param->mtu.mtu;
+        portEXIT_CRITICAL(&s_lock);
+        ESP_LOGI(TAG, "MTU negociado: %u (%u muestras por notificación)", param->mtu.mtu, batch_capacity());
+        break;
+
+    case ESP_GATTS_CONGEST_EVT:
+        s_congested = param->congest.congested;
+        break;
+
+    case ESP_GATTS_WRITE_EVT:
+        if (!param->write.is_prep) {
+            const esp_gatt_status_t status = handle_write(param->write.handle, param->write.value, param->write.len);
+            if (param->write.need_rsp) {
+                esp_ble_gatts_send_response(gatts_if, param->write.conn_id, param->write.trans_id, status, NULL);
+            }
+        } else {
+            // Escritura larga: acumular hasta la orden de ejecución
+            esp_gatt_status_t status = ESP_GATT_OK;
+            if (param->write.offset + param->write.len > sizeof(s_prep_buf)) {
+                status = ESP_GATT_INVALID_ATTR_LEN;
+            } else {
+                memcpy(&s_prep_buf[param->write.offset], param->write.value, param->write.len);
+                s_prep_len = param->write.offset + param->write.len;
+                s_prep_handle = param->write.handle;
+            }
+            if (param->write.need_rsp) {
+                esp_gatt_rsp_t rsp = { 0 };
+                rsp.attr_value.handle = param->write.handle;
+                rsp.attr_value.offset = param->write.offset;
+                rsp.attr_value.len = param->write.len;
+                rsp.attr_value.auth_req = ESP_GATT_AUTH_REQ_NONE;
+                memcpy(rsp.attr_value.value, param->write.value, param->write.len);
+                esp_ble_gatts_send_response(gatts_if, param->write.conn_id, param->write.trans_id, status, &rsp);
+            }
+        }
+        break;
+
+    case ESP_GATTS_EXEC_WRITE_EVT: {
+        esp_gatt_status_t status = ESP_GATT_OK;
+        if (param->exec_write.exec_write_flag == ESP_GATT_PREP_WRITE_EXEC && s_prep_len) {
+            status = handle_write(s_prep_handle, s_prep_buf, s_prep_len);
+        }
+        s_prep_len = 0;
+        esp_ble_gatts_send_response(gatts_if, param->exec_write.conn_id, param->exec_write.trans_id, status, NULL);
+        break;
+    }
+
+    case ESP_GATTS_READ_EVT:
+        // Solo la consigna se lee con respuesta de aplicación
+        if (param->read.need_rsp) {
+            esp_gatt_rsp_t rsp = { 0 };
+            esp_gatt_status_t status = ESP_GATT_READ_NOT_PERMIT;
+            if (param->read.handle == tel_handles[TEL_IDX_SP_VAL]) {
+                status = param->read.offset > sizeof(setpoint_value) ? ESP_GATT_INVALID_OFFSET : ESP_GATT_OK;
+                if (status == ESP_GATT_OK) {
+                    rsp.attr_value.handle = param->read.handle;
+                    rsp.attr_value.offset = param->read.offset;
+                    rsp.attr_value.len = sizeof(setpoint_value) - param->read.offset;
+                    memcpy(rsp.attr_value.value, &setpoint_value[param->read.offset], rsp.attr_value.len);
+                }
+            }
+            esp_ble_gatts_send_response(gatts_if, param->read.conn_id, param->read.trans_id, status, &rsp);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+// ───────────────────────────────────────────────────────
+// API pública
+
+/**
+ * @brief Arma los datos de publicidad y de respuesta al escaneo
+ */
+static void build_adv_payload(const char *name)
+{
+    size_t i = 0;
+    adv_data[i++] = 2;
+    adv_data[i++] = ESP_BLE_AD_TYPE_FLAG;
+    adv_data[i++] = ESP_BLE_ADV_FLAG_GEN_DISC | ESP_BLE_ADV_FLAG_BREDR_NOT_SPT;
+    adv_data[i++] = 17;
+    adv_data[i++] = ESP_BLE_AD_TYPE_128SRV_CMPL;
+    memcpy(&adv_data[i], uuid_svc_telemetry, 16);
+
+    size_t name_len = strlen(name);
+    if (name_len > sizeof(scan_rsp_data) - 2) {
+        name_len = sizeof(scan_rsp_data) - 2;
+    }
+    scan_rsp_data[0] = (uint8_t)(name_len + 1);
+    scan_rsp_data[1] = ESP_BLE_AD_TYPE_NAME_CMPL;
+    memcpy(&scan_rsp_data[2], name, name_len);
+    scan_rsp_len = (uint8_t)(name_len + 2);
+}
+
+esp_err_t ble_service_start(const char *device_name)
+{
+    if (device_name == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    strlcpy(s_device_name, device_name, sizeof(s_device_name));
+    build_adv_payload(s_device_name);
+    s_active = true;
+
+    if (s_registered) {
+        start_advertising();
+        return ESP_OK;
+    }
+
+    if (s_sample_job == NULL) {
+        esp_err_t ret = sched_add("ble_sample", sample_job, NULL, SCHED_DISARMED, BLE_SAMPLE_MS, &s_sample_job);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+
+        // Emparejamiento sin pantalla ni teclado, con bonding y conexiones seguras
+        uint8_t auth_req = ESP_LE_AUTH_REQ_SC_BOND;
+        uint8_t iocap = ESP_IO_CAP_NONE;
+        uint8_t key_size = 16;
+        uint8_t keys = ESP_BLE_ENC_KEY_MASK | ESP_BLE_ID_KEY_MASK;
+        esp_ble_gap_set_security_param(ESP_BLE_SM_AUTHEN_REQ_MODE, &auth_req, sizeof(auth_req));
+        esp_ble_gap_set_security_param(ESP_BLE_SM_IOCAP_MODE, &iocap, sizeof(iocap));
+        esp_ble_gap_set_security_param(ESP_BLE_SM_MAX_KEY_SIZE, &key_size, sizeof(key_size));
+        esp_ble_gap_set_security_param(ESP_BLE_SM_SET_INIT_KEY, &keys, sizeof(keys));
+        esp_ble_gap_set_security_param(ESP_BLE_SM_SET_RSP_KEY, &keys, sizeof(keys));
+
+        metrics_register("ble", ble_metrics, NULL);
+        if (esp_event_handler_register(WIFI_MANAGER_EVENT, ESP_EVENT_ANY_ID, on_wifi_state, NULL) != ESP_OK) {
+            ESP_LOGW(TAG, "Estado WiFi no disponible para el provisioning");
+        }
+        status_value[0] = (uint8_t)wifi_manager_get_state();
+    }
+
+    esp_err_t ret = esp_ble_gatts_register_callback(gatts_event_handler);
+    if (ret == ESP_OK) {
+        ret = esp_ble_gap_register_callback(gap_event_handler);
+    }
+    if (ret == ESP_OK) {
+        ret = esp_ble_gatt_set_local_mtu(BLE_SERVICE_LOCAL_MTU);
+    }
+    if (ret == ESP_OK) {
+        ret = esp_ble_gatts_app_register(BLE_APP_ID);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Error registrando el servicio GATT: %s", esp_err_to_name(ret));
+        s_active = false;
+    }
+    return ret;
+}
+
+esp_err_t ble_service_stop(void)
+{
+    s_active = false;
+    if (!s_registered) {
+        return ESP_OK;
+    }
+
+    const uint8_t instance = BLE_ADV_INSTANCE;
+    esp_ble_gap_ext_adv_stop(1, &instance);
+    if (s_connected) {
+        esp_ble_gatts_close(s_gatts_if, s_conn_id);
+    }
+    sched_disarm(s_sample_job);
+    return ESP_OK;
+}
+
+void ble_service_get_stats(ble_service_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    portENTER_CRITICAL(&s_lock);
+    *stats = s_stats;
+    if (s_connected) {
+        stats->connected_us += esp_timer_get_time() - s_connect_us;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void ble_service_log_stats(void)
+{
+    ble_service_stats_t st;
+    ble_service_get_stats(&st);
+    const double seconds = st.connected_us / 1e6;
+    ESP_LOGI(TAG, "Notificaciones: %lu (%llu B, %lu muestras, %lu descartadas) en %.1f s conectado: "
+             "%.1f B/s, %.2f notif/s",
+             (unsigned long)st.notifications, (unsigned long long)st.bytes, (unsigned long)st.samples,
+             (unsigned long)st.samples_dropped, seconds,
+             seconds > 0 ? st.bytes / seconds : 0.0, seconds > 0 ? st.notifications / seconds : 0.0);
+    ESP_LOGI(TAG, "RAM interna: stack BT %lu B, tablas GATT %lu B",
+             (unsigned long)bt_get_heap_cost(), (unsigned long)st.heap_cost);
+}
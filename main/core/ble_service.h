@@ -0,0 +1,93 @@
+/**
+ * @file ble_service.h
+ * @brief Servicios GATT de telemetría, control y provisioning WiFi sobre Bluedroid.
+ *
+ * Servicio de telemetría:
+ * - Temperatura (read/notify): lotes de muestras en una sola notificación.
+ *   Formato: `uint32 t0_ms | uint16 period_ms | int16 temp_c_x100[n]` (little endian),
+ *   con `t0_ms` en el reloj monotónico de la base de tiempo.
+ * - Setpoint (read/write/notify): `int16` en centésimas de °C.
+ * - Duty (read/notify): `uint8` 0–100 %.
+ * - SSR (read/notify): `uint8` 0/1.
+ * - Alarmas (read/notify): `uint32` máscara PID_ALARM_*.
+ * - Control (write cifrado): `uint8 opcode | argumentos` (ver ble_cmd_t).
+ *
+ * Servicio de provisioning WiFi (escrituras cifradas):
+ * - SSID, clave y "aplicar" (write); estado de la conexión (read/notify, wifi_manager_state_t).
+ *
+ * Se negocia un MTU grande para que cada notificación lleve tantas muestras como quepan.
+ * Los valores que cambian poco (setpoint, duty, SSR, alarmas) solo se notifican al cambiar.
+ *
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#ifndef BLE_SERVICE_H
+#define BLE_SERVICE_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BLE_SERVICE_LOCAL_MTU       517     ///< MTU ofrecido al cliente
+#define BLE_SERVICE_BATCH_MAX       64      ///< Muestras máximas por notificación
+
+/**
+ * @brief Órdenes aceptadas por la característica de control
+ */
+typedef enum {
+    BLE_CMD_PID_ENABLE = 0x01,      ///< Sin argumentos
+    BLE_CMD_PID_DISABLE = 0x02,     ///< Sin argumentos
+    BLE_CMD_SET_SETPOINT = 0x03,    ///< `int16` centésimas de °C
+    BLE_CMD_SET_PID_PARAMS = 0x04,  ///< `float kp | float ki | float kd`
+} ble_cmd_t;
+
+/**
+ * @brief Estadísticas del servicio
+ */
+typedef struct {
+    uint32_t notifications;     ///< Notificaciones enviadas
+    uint64_t bytes;             ///< Bytes de carga útil enviados
+    uint32_t samples;           ///< Muestras de temperatura enviadas
+    uint32_t samples_dropped;   ///< Muestras descartadas por congestión
+    uint32_t commands;          ///< Órdenes de control enviadas al PID
+    uint16_t mtu;               ///< MTU negociado con el cliente actual
+    uint64_t connected_us;      ///< Tiempo total con un cliente conectado
+    uint32_t heap_cost;         ///< Bytes de heap interno usados por las tablas GATT
+} ble_service_stats_t;
+
+/**
+ * @brief Registra los servicios GATT e inicia la publicidad
+ * @details Requiere el stack Bluedroid habilitado (bt_init()).
+ * @param device_name Nombre anunciado
+ * @return ESP_OK si el registro se inició
+ */
+esp_err_t ble_service_start(const char *device_name);
+
+/**
+ * @brief Detiene la publicidad, desconecta al cliente y deja de muestrear
+ * @return ESP_OK
+ */
+esp_err_t ble_service_stop(void);
+
+/**
+ * @brief Obtiene las estadísticas del servicio
+ * @param stats Estructura donde se copiarán las estadísticas
+ */
+void ble_service_get_stats(ble_service_stats_t *stats);
+
+/**
+ * @brief Imprime en el log el caudal de notificaciones y el costo en RAM
+ */
+void ble_service_log_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BLE_SERVICE_H
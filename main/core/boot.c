@@ -0,0 +1,185 @@
+/**
+ * @file boot.c
+ * @brief Implementación del arranque por etapas.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#include "boot.h"
+#include "metrics.h"
+#include "mem_budget.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include <stdio.h>
+
+static const char *TAG = "BOOT";
+
+#define BOOT_TASK_PRIORITY  3       ///< Por debajo del PID y del sensor
+
+static const boot_stage_t *s_stages = NULL;
+static size_t s_count = 0;
+static boot_stage_timing_t s_timing[BOOT_MAX_STAGES];
+static EventGroupHandle_t s_done_group = NULL;  ///< Un bit por etapa terminada
+static StaticEventGroup_t s_done_group_buffer;
+MEM_BUDGET_STATIC_ASSERT(BOOT, INTERNAL, sizeof(s_done_group_buffer));
+static uint32_t s_failed = 0;                   ///< Máscara de etapas fallidas u omitidas
+static portMUX_TYPE s_failed_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Ejecuta una etapa registrando sus tiempos
+ */
+static void run_stage(size_t id)
+{
+    const boot_stage_t *stage = &s_stages[id];
+    boot_stage_timing_t *t = &s_timing[id];
+
+    t->start_us = esp_timer_get_time();
+    portENTER_CRITICAL(&s_failed_lock);
+    const uint32_t failed = s_failed;
+    portEXIT_CRITICAL(&s_failed_lock);
+    if (stage->deps & failed) {
+        t->result = ESP_ERR_INVALID_STATE;
+        ESP_LOGW(TAG, "Etapa '%s' omitida: falló una dependencia", stage->name);
+    } else {
+        t->result = stage->fn();
+        if (t->result != ESP_OK) {
+            ESP_LOGE(TAG, "Etapa '%s' falló: %s", stage->name, esp_err_to_name(t->result));
+        }
+    }
+    t->end_us = esp_timer_get_time();
+    t->done = true;
+
+    if (t->result != ESP_OK) {
+        portENTER_CRITICAL(&s_failed_lock);
+        s_failed |= BOOT_DEP(id);
+        portEXIT_CRITICAL(&s_failed_lock);
+    }
+    ESP_LOGI(TAG, "[%7.3f s] %-12s %6lld ms", t->end_us / 1e6, stage->name, (t->end_us - t->start_us) / 1000);
+    xEventGroupSetBits(s_done_group, BOOT_DEP(id));
+}
+
+/**
+ * @brief Tarea de segundo plano: ejecuta cada etapa cuando sus dependencias terminaron
+ */
+static void boot_background_task(void *arg)
+{
+    (void)arg;
+    for (size_t id = 0; id < s_count; id++) {
+        if (!s_stages[id].background) {
+            continue;
+        }
+        if (s_stages[id].deps) {
+            xEventGroupWaitBits(s_done_group, s_stages[id].deps, pdFALSE, pdTRUE, portMAX_DELAY);
+        }
+        run_stage(id);
+    }
+
+    boot_log_report();
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Proveedor de métricas con la duración y el fin de cada etapa
+ */
+static void boot_metrics(metrics_writer_t *w, void *ctx)
+{
+    (void)ctx;
+    char labels[48];
+    for (size_t id = 0; id < s_count; id++) {
+        if (!s_timing[id].done) {
+            continue;
+        }
+        snprintf(labels, sizeof(labels), "stage=\"%s\"", s_stages[id].name);
+        metrics_write_uint(w, "boot_stage_end_ms", labels, s_timing[id].end_us / 1000);
+        metrics_write_uint(w, "boot_stage_duration_ms", labels, (s_timing[id].end_us - s_timing[id].start_us) / 1000);
+        metrics_write_uint(w, "boot_stage_ok", labels, s_timing[id].result == ESP_OK);
+    }
+}
+
+esp_err_t boot_run(const boot_stage_t *stages, size_t count)
+{
+    if (stages == NULL || count == 0 || count > BOOT_MAX_STAGES) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    s_stages = stages;
+    s_count = count;
+    s_done_group = xEventGroupCreateStatic(&s_done_group_buffer);
+    mem_budget_claim(MEM_MOD_BOOT, MEM_REGION_INTERNAL, sizeof(s_done_group_buffer));
+
+    // Verificar el orden antes de ejecutar nada
+    uint32_t background_mask = 0;
+    for (size_t id = 0; id < count; id++) {
+        if (stages[id].deps & ~(BOOT_DEP(id) - 1)) {
+            ESP_LOGE(TAG, "Etapa '%s' depende de una etapa posterior", stages[id].name);
+            return ESP_ERR_INVALID_ARG;
+        }
+        if (!stages[id].background && (stages[id].deps & background_mask)) {
+            ESP_LOGE(TAG, "Etapa '%s' de primer plano depende de una de segundo plano", stages[id].name);
+            return ESP_ERR_INVALID_ARG;
+        }
+        if (stages[id].background) {
+            background_mask |= BOOT_DEP(id);
+        }
+    }
+
+    // La tarea de segundo plano arranca ya: sus etapas esperan solo a sus dependencias. Termina
+    // con el arranque, así que su pila vuelve al heap y no entra en el presupuesto.
+    if (background_mask &&
+        xTaskCreate(boot_background_task, "Boot_BG", MEM_STACK_BOOT, NULL, BOOT_TASK_PRIORITY, NULL) != pdPASS) {
+        ESP_LOGE(TAG, "No se pudo crear la tarea de arranque en segundo plano");
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t ret = ESP_OK;
+    for (size_t id = 0; id < count; id++) {
+        if (stages[id].background) {
+            continue;
+        }
+        run_stage(id);
+        if (s_timing[id].result != ESP_OK) {
+            ret = s_timing[id].result;
+        }
+    }
+
+    metrics_register("boot", boot_metrics, NULL);
+    return ret;
+}
+
+bool boot_wait(uint32_t deps, uint32_t timeout_ms)
+{
+    if (s_done_group == NULL) {
+        return false;
+    }
+    const EventBits_t bits = xEventGroupWaitBits(s_done_group, deps, pdFALSE, pdTRUE, pdMS_TO_TICKS(timeout_ms));
+    return (bits & deps) == deps;
+}
+
+esp_err_t boot_get_timing(size_t id, boot_stage_timing_t *timing)
+{
+    if (id >= s_count || timing == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *timing = s_timing[id];
+    return ESP_OK;
+}
+
+void boot_log_report(void)
+{
+    ESP_LOGI(TAG, "=== Informe de arranque ===");
+    for (size_t id = 0; id < s_count; id++) {
+        const boot_stage_timing_t *t = &s_timing[id];
+        if (!t->done) {
+            ESP_LOGI(TAG, "%-12s %-3s en curso", s_stages[id].name, s_stages[id].background ? "BG" : "FG");
+            continue;
+        }
+        ESP_LOGI(TAG, "%-12s %-3s inicio %7.3f s  fin %7.3f s  (%5lld ms) %s",
+                 s_stages[id].name, s_stages[id].background ? "BG" : "FG",
+                 t->start_us / 1e6, t->end_us / 1e6, (t->end_us - t->start_us) / 1000,
+                 t->result == ESP_OK ? "OK" : esp_err_to_name(t->result));
+    }
+}
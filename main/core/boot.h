@@ -0,0 +1,94 @@
+/**
+ * @file boot.h
+ * @brief Arranque del sistema en etapas ordenadas por dependencias.
+ * @details Las etapas de primer plano (pantalla, UI, sensor, control) se ejecutan en orden
+ *          en la tarea que llama a `boot_run()`. Las de segundo plano (Wi-Fi, escaneo, SNTP,
+ *          estadísticas) se ejecutan en una tarea aparte, cada una en cuanto terminan las
+ *          etapas de las que depende, sin retrasar el lazo de control.
+ *
+ *          Se registra el inicio y el fin de cada etapa respecto al arranque del sistema;
+ *          el informe se imprime al terminar las etapas de segundo plano y se publica en el
+ *          registro de métricas bajo el proveedor "boot".
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#ifndef BOOT_H
+#define BOOT_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BOOT_MAX_STAGES     16              ///< Número máximo de etapas
+#define BOOT_DEP(id)        (1UL << (id))   ///< Máscara de dependencia sobre la etapa `id`
+
+/**
+ * @brief Función de una etapa de arranque
+ * @return ESP_OK si la etapa terminó correctamente
+ */
+typedef esp_err_t (*boot_stage_fn_t)(void);
+
+/**
+ * @brief Descripción de una etapa de arranque
+ */
+typedef struct {
+    const char *name;       ///< Nombre de la etapa (para el informe)
+    boot_stage_fn_t fn;     ///< Función de la etapa
+    uint32_t deps;          ///< Máscara BOOT_DEP() de las etapas requeridas
+    bool background;        ///< true si se ejecuta en la tarea de segundo plano
+} boot_stage_t;
+
+/**
+ * @brief Tiempos de una etapa
+ */
+typedef struct {
+    int64_t start_us;       ///< Inicio de la etapa desde el arranque
+    int64_t end_us;         ///< Fin de la etapa desde el arranque
+    esp_err_t result;       ///< Resultado (ESP_ERR_INVALID_STATE si se omitió por dependencias)
+    bool done;              ///< La etapa terminó (o se omitió)
+} boot_stage_timing_t;
+
+/**
+ * @brief Ejecuta el arranque
+ * @details Ejecuta las etapas de primer plano en orden y lanza la tarea de segundo plano.
+ *          Una etapa cuyo requisito falló se omite. Una etapa de primer plano no puede
+ *          depender de una de segundo plano.
+ * @param stages Tabla de etapas; el índice de cada etapa es su identificador en BOOT_DEP()
+ * @param count Número de etapas
+ * @return ESP_OK si las etapas de primer plano terminaron correctamente
+ */
+esp_err_t boot_run(const boot_stage_t *stages, size_t count);
+
+/**
+ * @brief Espera a que terminen las etapas indicadas
+ * @param deps Máscara BOOT_DEP() de las etapas a esperar
+ * @param timeout_ms Tiempo máximo de espera
+ * @return true si todas terminaron dentro del plazo
+ */
+bool boot_wait(uint32_t deps, uint32_t timeout_ms);
+
+/**
+ * @brief Obtiene los tiempos de una etapa
+ * @param id Identificador de la etapa
+ * @param timing Estructura donde se copiarán los tiempos
+ * @return ESP_OK si la etapa existe
+ */
+esp_err_t boot_get_timing(size_t id, boot_stage_timing_t *timing);
+
+/**
+ * @brief Imprime en el log el inicio, fin y duración de cada etapa
+ */
+void boot_log_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BOOT_H
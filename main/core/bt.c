@@ -26,9 +26,7 @@
  * LIMITACIONES ACTUALES:
  * ======================
  * - Solo soporta una conexión BLE simultánea
- * - No implementa servicios GATT personalizados
- * - Advertising básico (implementación futura)
- * - No maneja perfiles BLE específicos
+ * - Los servicios GATT y la publicidad viven en ble_service.c
  * 
  * CONSUMO DE RECURSOS:
  * ====================
@@ -47,7 +45,9 @@
  */
 
 #include "bt.h"
+#include "ble_service.h"
 #include "esp_log.h"
+#include "esp_heap_caps.h"
 #include "esp_bt.h"
 #include "esp_bt_main.h"
 #include "esp_bt_device.h"
@@ -103,6 +103,13 @@ static bt_connection_info_t connection_info = {0};
  */
 static char device_name[MAX_DEVICE_NAME_LEN + 1] = DEFAULT_DEVICE_NAME;
 
+/**
+ * @brief RAM interna consumida por el controlador y Bluedroid
+ * 
+ * Se mide en bt_init() como diferencia del heap interno libre.
+ */
+static size_t stack_heap_cost = 0;
+
 //=============================================================================
 // IMPLEMENTACIÓN DE FUNCIONES PÚBLICAS
 //=============================================================================
@@ -121,6 +128,7 @@ esp_err_t bt_init(void)
     }
 
     esp_err_t ret;
+    const size_t free_before = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
 
     // PASO 1: Liberar memoria de controlador BT clásico
     // El ESP32 puede manejar BT clásico o BLE, pero no ambos simultáneamente.
@@ -175,9 +183,14 @@ esp_err_t bt_init(void)
     }
     ESP_LOGI(BT_TAG, "Stack Bluedroid habilitado correctamente");
 
+    // La liberación de BT clásico devuelve memoria al heap; en ese caso no hay costo neto
+    const size_t free_after = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    stack_heap_cost = free_before > free_after ? free_before - free_after : 0;
+
     // Actualizar estado del módulo
     bt_current_state = BT_STATE_INITIALIZED;
-    ESP_LOGI(BT_TAG, "Módulo BT inicializado exitosamente");
+    ESP_LOGI(BT_TAG, "Módulo BT inicializado exitosamente (%u bytes de RAM interna)",
+            (unsigned)stack_heap_cost);
     
     return ESP_OK;
 }
@@ -205,18 +218,17 @@ esp_err_t bt_start(void)
         return ESP_OK;
     }
 
-    // TODO: En implementaciones futuras, aquí se configurará:
-    // - Parámetros de advertising (nombre, servicios, potencia TX)
-    // - Servicios GATT personalizados
-    // - Callbacks para conexiones y desconexiones
-    // - Configuración de seguridad (pairing, bonding)
-    
+    // Servicios GATT, seguridad y publicidad
     ESP_LOGD(BT_TAG, "Configurando servicios BLE...");
-    // Por ahora, implementación simplificada sin advertising activo
+    esp_err_t ret = ble_service_start(device_name);
+    if (ret != ESP_OK) {
+        ESP_LOGE(BT_TAG, "Error al iniciar servicios GATT: %s", esp_err_to_name(ret));
+        return ret;
+    }
     
     // Actualizar estado del módulo
     bt_current_state = BT_STATE_STARTED;
-    ESP_LOGI(BT_TAG, "Servicio BLE iniciado exitosamente (implementación simplificada)");
+    ESP_LOGI(BT_TAG, "Servicio BLE iniciado exitosamente");
     
     return ESP_OK;
 }
@@ -234,13 +246,9 @@ esp_err_t bt_stop(void)
         return ESP_OK;
     }
 
-    // TODO: En implementaciones futuras, aquí se realizará:
-    // - Detener advertising activo
-    // - Cerrar conexiones GATT activas de forma elegante
-    // - Limpiar buffers de notificaciones pendientes
-    // - Desregistrar callbacks de eventos
-    
+    // Detener publicidad y muestreo, y cerrar la conexión GATT activa
     ESP_LOGD(BT_TAG, "Cerrando conexiones activas...");
+    ble_service_stop();
     
     // Limpiar información de conexión interna
     connection_info.is_connected = false;
@@ -251,7 +259,7 @@ esp_err_t bt_stop(void)
 
     // Actualizar estado del módulo
     bt_current_state = BT_STATE_STOPPED;
-    ESP_LOGI(BT_TAG, "Servicio BLE detenido exitosamente (implementación simplificada)");
+    ESP_LOGI(BT_TAG, "Servicio BLE detenido exitosamente");
     
     return ESP_OK;
 }
@@ -319,6 +327,7 @@ esp_err_t bt_deinit(void)
     }
 
     // Actualizar estado del módulo
+    stack_heap_cost = 0;
     bt_current_state = BT_STATE_UNINITIALIZED;
     ESP_LOGI(BT_TAG, "Módulo BT desinicializado exitosamente");
     
@@ -449,4 +458,23 @@ esp_err_t bt_get_device_name(char* name, size_t max_len)
     
     ESP_LOGD(BT_TAG, "Nombre del dispositivo obtenido: '%s'", name);
     return ESP_OK;
-} 
\ No newline at end of file
+} 
+
+/**
+ * @brief Actualiza la información de conexión
+ */
+void bt_update_connection(const bt_connection_info_t* info)
+{
+    if (!info) {
+        return;
+    }
+    memcpy(&connection_info, info, sizeof(connection_info));
+}
+
+/**
+ * @brief Obtiene la RAM interna consumida por el stack BT
+ */
+size_t bt_get_heap_cost(void)
+{
+    return stack_heap_cost;
+}
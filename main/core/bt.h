@@ -25,6 +25,8 @@
 
 #include "esp_err.h"
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -85,10 +87,8 @@ esp_err_t bt_init(void);
  * conexiones entrantes. Si el módulo no está inicializado, lo inicializa
  * automáticamente.
  * 
- * En implementaciones futuras, esta función también:
- * - Configurará y iniciará la publicidad BLE
- * - Registrará servicios GATT
- * - Habilitará notificaciones
+ * Registra los servicios GATT de telemetría, control y provisioning
+ * (ble_service.h) e inicia la publicidad con el nombre del dispositivo.
  * 
  * @return ESP_OK si el inicio fue exitoso
  * @return ESP_ERR_* códigos de error específicos si falla la inicialización automática
@@ -106,7 +106,7 @@ esp_err_t bt_start(void);
  * con bt_start().
  * 
  * Acciones realizadas:
- * - Detiene la publicidad BLE (implementación futura)
+ * - Detiene la publicidad BLE y el muestreo de telemetría
  * - Cierra conexiones BLE activas
  * - Limpia información de conexión interna
  * - Cambia estado a BT_STATE_STOPPED
@@ -257,6 +257,24 @@ esp_err_t bt_get_connection_info(bt_connection_info_t* info);
  */
 esp_err_t bt_get_device_name(char* name, size_t max_len);
 
+/**
+ * @brief Actualiza la información de conexión
+ * 
+ * La llama el servicio GATT al conectarse o desconectarse un cliente.
+ * 
+ * @param info Nueva información de conexión (no puede ser NULL)
+ */
+void bt_update_connection(const bt_connection_info_t* info);
+
+/**
+ * @brief Obtiene la RAM interna consumida por el controlador y Bluedroid
+ * 
+ * Diferencia del heap interno libre antes y después de bt_init().
+ * 
+ * @return Bytes consumidos, 0 si el stack no está inicializado
+ */
+size_t bt_get_heap_cost(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,506 @@
+/**
+ * @file config_store.c
+ * @brief Implementación del almacén de configuración.
+ * @details Los valores son palabras de 32 bits: se leen sin lock y se escriben bajo un
+ *          spinlock. El guardado arma el blob desde la copia en RAM y lo compara con el
+ *          último escrito, así que un cambio que vuelve al valor anterior no toca la flash.
+ *          Un mutex serializa el guardado entre el trabajo agrupado y cfg_flush().
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#include "config_store.h"
+#include "pid_controller.h"
+#include "scheduler.h"
+#include "metrics.h"
+#include "mem_budget.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "hal_nvs.h"
+#include "timebase.h"
+#include "esp_log.h"
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "CFG";
+
+#define CFG_NVS_NAMESPACE       "cfg"
+#define CFG_NVS_KEY             "store"
+#define CFG_BLOB_VERSION        1
+#define CFG_LEGACY_NAMESPACE    "pid_params"    ///< Ganancias guardadas como tres blobs sueltos
+
+/**
+ * @brief Definición de una clave
+ */
+typedef struct {
+    const char *name;
+    cfg_type_t type;
+    cfg_value_t def;
+    cfg_value_t min;
+    cfg_value_t max;
+} cfg_schema_t;
+
+#define CFG_U32(n, d, lo, hi)   { n, CFG_TYPE_U32,   { .u32 = (d) }, { .u32 = (lo) }, { .u32 = (hi) } }
+#define CFG_FLOAT(n, d, lo, hi) { n, CFG_TYPE_FLOAT, { .f = (d) },   { .f = (lo) },   { .f = (hi) } }
+
+static const cfg_schema_t s_schema[CFG_KEY_COUNT] = {
+    [CFG_PID_KP]              = CFG_FLOAT("pid.kp",          1.0f,   0.0f, 10000.0f),
+    [CFG_PID_KI]              = CFG_FLOAT("pid.ki",          0.1f,   0.0f, 10000.0f),
+    [CFG_PID_KD]              = CFG_FLOAT("pid.kd",          2.0f,   0.0f, 10000.0f),
+    [CFG_PID_SAMPLE_TIME_MS]  = CFG_U32("pid.sample_ms",     5000,   PID_SAMPLE_TIME_MIN_MS, PID_SAMPLE_TIME_MAX_MS),
+    [CFG_PID_OUTPUT_MIN]      = CFG_FLOAT("pid.out_min",     0.0f,   0.0f, 100.0f),
+    [CFG_PID_OUTPUT_MAX]      = CFG_FLOAT("pid.out_max",     100.0f, 0.0f, 100.0f),
+    [CFG_AUTOTUNE_HYSTERESIS] = CFG_FLOAT("at.hysteresis",   0.5f,   0.05f, 10.0f),
+    [CFG_AUTOTUNE_RELAY_HIGH] = CFG_FLOAT("at.relay_high",   100.0f, 0.0f, 100.0f),
+    [CFG_AUTOTUNE_RELAY_LOW]  = CFG_FLOAT("at.relay_low",    0.0f,   0.0f, 100.0f),
+    [CFG_AUTOTUNE_MIN_CYCLES] = CFG_U32("at.min_cycles",     5,      2, 50),
+    [CFG_AUTOTUNE_DELAY_MS]   = CFG_U32("at.delay_ms",       100,    10, 10000),
+    // Por defecto el tope del arco de setpoint de la pantalla (0–100 °C)
+    [CFG_PID_SETPOINT_MAX]    = CFG_FLOAT("pid.sp_max",      100.0f, 0.0f, 250.0f),
+};
+
+/**
+ * @brief Formato guardado: encabezado seguido de `count` registros
+ */
+typedef struct {
+    uint16_t version;
+    uint16_t count;
+} cfg_blob_header_t;
+
+typedef struct {
+    uint16_t id;                ///< cfg_key_t
+    uint16_t reserved;
+    cfg_value_t value;
+} cfg_blob_record_t;
+
+typedef struct {
+    cfg_blob_header_t hdr;
+    cfg_blob_record_t rec[CFG_KEY_COUNT];
+} cfg_blob_t;
+
+_Static_assert(sizeof(cfg_blob_record_t) == 8, "el formato guardado fija registros de 8 bytes");
+
+typedef struct {
+    uint32_t mask;
+    cfg_change_fn_t fn;
+    void *ctx;
+} cfg_subscriber_t;
+
+static cfg_value_t s_values[CFG_KEY_COUNT];
+static cfg_blob_t s_saved;                  ///< Último blob escrito o leído tal cual
+static bool s_legacy_pending = false;       ///< Falta borrar "pid_params" tras migrar
+static cfg_subscriber_t s_subs[CFG_MAX_SUBSCRIBERS];
+static size_t s_sub_count = 0;
+static cfg_stats_t s_stats;
+static sched_job_handle_t s_save_job = NULL;
+static SemaphoreHandle_t s_save_mutex = NULL;
+static StaticSemaphore_t s_save_mutex_buffer;
+MEM_BUDGET_STATIC_ASSERT(CFG, INTERNAL, sizeof(s_save_mutex_buffer));
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// ───────────────────────────────────────────────────────
+// Validación
+
+static bool in_range(cfg_key_t key, cfg_value_t v)
+{
+    const cfg_schema_t *s = &s_schema[key];
+    if (s->type == CFG_TYPE_U32) {
+        return v.u32 >= s->min.u32 && v.u32 <= s->max.u32;
+    }
+    return isfinite(v.f) && v.f >= s->min.f && v.f <= s->max.f;
+}
+
+static void load_defaults(void)
+{
+    for (int k = 0; k < CFG_KEY_COUNT; k++) {
+        s_values[k] = s_schema[k].def;
+    }
+}
+
+// ───────────────────────────────────────────────────────
+// Persistencia
+
+static void build_blob(cfg_blob_t *blob)
+{
+    memset(blob, 0, sizeof(*blob));
+    blob->hdr.version = CFG_BLOB_VERSION;
+    blob->hdr.count = CFG_KEY_COUNT;
+    portENTER_CRITICAL(&s_lock);
+    for (int k = 0; k < CFG_KEY_COUNT; k++) {
+        blob->rec[k].id = k;
+        blob->rec[k].value = s_values[k];
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+static esp_err_t erase_legacy(void)
+{
+    hal_nvs_handle_t handle;
+    s_stats.nvs_opens++;
+    esp_err_t err = hal_nvs_open(CFG_LEGACY_NAMESPACE, HAL_NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    s_stats.nvs_writes++;
+    err = hal_nvs_erase_all(handle);
+    if (err == ESP_OK) {
+        s_stats.nvs_commits++;
+        err = hal_nvs_commit(handle);
+    }
+    hal_nvs_close(handle);
+    return err;
+}
+
+static esp_err_t save(void)
+{
+    cfg_blob_t blob;
+    build_blob(&blob);
+
+    xSemaphoreTake(s_save_mutex, portMAX_DELAY);
+    esp_err_t err = ESP_OK;
+    if (memcmp(&blob, &s_saved, sizeof(blob)) == 0) {
+        s_stats.saves_skipped++;
+    } else {
+        hal_nvs_handle_t handle;
+        s_stats.nvs_opens++;
+        err = hal_nvs_open(CFG_NVS_NAMESPACE, HAL_NVS_READWRITE, &handle);
+        if (err == ESP_OK) {
+            s_stats.nvs_writes++;
+            err = hal_nvs_set_blob(handle, CFG_NVS_KEY, &blob, sizeof(blob));
+            if (err == ESP_OK) {
+                s_stats.nvs_commits++;
+                err = hal_nvs_commit(handle);
+            }
+            hal_nvs_close(handle);
+        }
+        if (err == ESP_OK) {
+            s_saved = blob;
+        }
+    }
+    // Las ganancias viejas se borran recién con el blob nuevo ya escrito
+    if (err == ESP_OK && s_legacy_pending && erase_legacy() == ESP_OK) {
+        s_legacy_pending = false;
+    }
+    xSemaphoreGive(s_save_mutex);
+
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "No se pudo guardar la configuración: %s", esp_err_to_name(err));
+    }
+    return err;
+}
+
+static void save_job(void *ctx)
+{
+    (void)ctx;
+    save();
+}
+
+/**
+ * @brief Copia las ganancias del formato anterior (tres blobs en "pid_params")
+ * @return true si se migraron las tres
+ */
+static bool migrate_legacy(void)
+{
+    static const struct {
+        const char *key;
+        cfg_key_t cfg;
+    } gains[] = {
+        { "Kp", CFG_PID_KP },
+        { "Ki", CFG_PID_KI },
+        { "Kd", CFG_PID_KD },
+    };
+    hal_nvs_handle_t handle;
+    s_stats.nvs_opens++;
+    if (hal_nvs_open(CFG_LEGACY_NAMESPACE, HAL_NVS_READONLY, &handle) != ESP_OK) {
+        return false;
+    }
+    cfg_value_t values[3];
+    bool ok = true;
+    for (int i = 0; i < 3 && ok; i++) {
+        size_t size = sizeof(float);
+        s_stats.nvs_reads++;
+        ok = hal_nvs_get_blob(handle, gains[i].key, &values[i].f, &size) == ESP_OK &&
+             size == sizeof(float) && in_range(gains[i].cfg, values[i]);
+    }
+    hal_nvs_close(handle);
+    if (!ok) {
+        return false;
+    }
+    for (int i = 0; i < 3; i++) {
+        s_values[gains[i].cfg] = values[i];
+    }
+    return true;
+}
+
+/**
+ * @brief Aplica un blob leído de NVS
+ * @return true si estaba en el formato vigente, completo y en rango (no hace falta reescribirlo)
+ */
+static bool apply_blob(const uint8_t *data, size_t len)
+{
+    cfg_blob_header_t hdr;
+    if (len < sizeof(hdr)) {
+        return false;
+    }
+    memcpy(&hdr, data, sizeof(hdr));
+    const size_t count = (len - sizeof(hdr)) / sizeof(cfg_blob_record_t);
+    bool canonical = hdr.version == CFG_BLOB_VERSION && hdr.count == CFG_KEY_COUNT && count == hdr.count;
+    if (hdr.version != CFG_BLOB_VERSION) {
+        ESP_LOGW(TAG, "Formato guardado v%u; se reescribe como v%u", hdr.version, CFG_BLOB_VERSION);
+    }
+
+    for (size_t i = 0; i < count && i < hdr.count; i++) {
+        cfg_blob_record_t rec;
+        memcpy(&rec, data + sizeof(hdr) + i * sizeof(rec), sizeof(rec));
+        if (rec.id >= CFG_KEY_COUNT) {
+            canonical = false;      // Clave de otra versión del firmware
+        } else if (!in_range(rec.id, rec.value)) {
+            ESP_LOGW(TAG, "%s guardado fuera de rango; se usa el valor por defecto", s_schema[rec.id].name);
+            canonical = false;
+        } else {
+            s_values[rec.id] = rec.value;
+        }
+    }
+    return canonical;
+}
+
+/**
+ * @brief Lee el blob; sin él intenta la migración
+ * @return true si hay que reescribir el blob
+ */
+static bool load(void)
+{
+    hal_nvs_handle_t handle;
+    size_t len = 0;
+    s_stats.nvs_opens++;
+    esp_err_t err = hal_nvs_open(CFG_NVS_NAMESPACE, HAL_NVS_READONLY, &handle);
+    if (err == ESP_OK) {
+        s_stats.nvs_reads++;
+        err = hal_nvs_get_blob(handle, CFG_NVS_KEY, NULL, &len);
+        if (err == ESP_OK) {
+            uint8_t *data = malloc(len);
+            if (data == NULL) {
+                err = ESP_ERR_NO_MEM;
+            } else {
+                s_stats.nvs_reads++;
+                err = hal_nvs_get_blob(handle, CFG_NVS_KEY, data, &len);
+                if (err == ESP_OK) {
+                    const bool canonical = apply_blob(data, len);
+                    if (canonical) {
+                        memcpy(&s_saved, data, sizeof(s_saved));
+                    }
+                    free(data);
+                    hal_nvs_close(handle);
+                    return !canonical;
+                }
+                free(data);
+            }
+        }
+        hal_nvs_close(handle);
+    }
+    if (err != HAL_NVS_ERR_NOT_FOUND) {
+        ESP_LOGE(TAG, "No se pudo leer la configuración: %s", esp_err_to_name(err));
+        return false;
+    }
+
+    if (migrate_legacy()) {
+        s_stats.migrated = true;
+        s_legacy_pending = true;
+        ESP_LOGI(TAG, "Ganancias migradas desde \"%s\"", CFG_LEGACY_NAMESPACE);
+        return true;
+    }
+    return false;
+}
+
+static void cfg_metrics(metrics_writer_t *w, void *ctx)
+{
+    (void)ctx;
+    cfg_stats_t st;
+    cfg_get_stats(&st);
+    metrics_write_uint(w, "cfg_load_us", NULL, st.load_us);
+    metrics_write_uint(w, "cfg_nvs_opens_total", NULL, st.nvs_opens);
+    metrics_write_uint(w, "cfg_nvs_reads_total", NULL, st.nvs_reads);
+    metrics_write_uint(w, "cfg_nvs_writes_total", NULL, st.nvs_writes);
+    metrics_write_uint(w, "cfg_nvs_commits_total", NULL, st.nvs_commits);
+    metrics_write_uint(w, "cfg_changes_total", NULL, st.changes);
+    metrics_write_uint(w, "cfg_rejected_total", NULL, st.rejected);
+    metrics_write_uint(w, "cfg_saves_skipped_total", NULL, st.saves_skipped);
+}
+
+// ───────────────────────────────────────────────────────
+// API
+
+esp_err_t cfg_init(void)
+{
+    if (s_save_mutex != NULL) {
+        return ESP_OK;
+    }
+    s_save_mutex = xSemaphoreCreateMutexStatic(&s_save_mutex_buffer);
+    mem_budget_claim(MEM_MOD_CFG, MEM_REGION_INTERNAL, sizeof(s_save_mutex_buffer));
+
+    const int64_t start = timebase_mono_us();
+    load_defaults();
+    const bool rewrite = load();
+    s_stats.load_us = (uint32_t)(timebase_mono_us() - start);
+    ESP_LOGI(TAG, "Configuración cargada en %lu us (%lu aperturas, %lu lecturas de NVS)",
+             (unsigned long)s_stats.load_us, (unsigned long)s_stats.nvs_opens,
+             (unsigned long)s_stats.nvs_reads);
+
+    metrics_register("cfg", cfg_metrics, NULL);
+    esp_err_t err = sched_add("cfg_save", save_job, NULL,
+                              rewrite ? CFG_SAVE_DELAY_MS : SCHED_DISARMED, 0, &s_save_job);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Sin guardado agrupado: %s", esp_err_to_name(err));
+    }
+    return err;
+}
+
+bool cfg_valid(cfg_key_t key, cfg_value_t value)
+{
+    return key < CFG_KEY_COUNT && in_range(key, value);
+}
+
+uint32_t cfg_get_u32(cfg_key_t key)
+{
+    return key < CFG_KEY_COUNT && s_schema[key].type == CFG_TYPE_U32 ? s_values[key].u32 : 0;
+}
+
+float cfg_get_float(cfg_key_t key)
+{
+    return key < CFG_KEY_COUNT && s_schema[key].type == CFG_TYPE_FLOAT ? s_values[key].f : 0.0f;
+}
+
+static esp_err_t set_value(cfg_key_t key, cfg_type_t type, cfg_value_t value)
+{
+    if (key >= CFG_KEY_COUNT || s_schema[key].type != type || !in_range(key, value)) {
+        portENTER_CRITICAL(&s_lock);
+        s_stats.rejected++;
+        portEXIT_CRITICAL(&s_lock);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    const bool changed = s_values[key].u32 != value.u32;
+    if (changed) {
+        s_values[key] = value;
+        s_stats.changes++;
+    }
+    const size_t sub_count = s_sub_count;
+    portEXIT_CRITICAL(&s_lock);
+    if (!changed) {
+        return ESP_OK;
+    }
+
+    if (s_save_job != NULL) {
+        sched_trigger(s_save_job, CFG_SAVE_DELAY_MS);
+    }
+    for (size_t i = 0; i < sub_count; i++) {
+        if (s_subs[i].mask & (1u << key)) {
+            s_subs[i].fn(key, value, s_subs[i].ctx);
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t cfg_set_u32(cfg_key_t key, uint32_t value)
+{
+    return set_value(key, CFG_TYPE_U32, (cfg_value_t){ .u32 = value });
+}
+
+esp_err_t cfg_set_float(cfg_key_t key, float value)
+{
+    return set_value(key, CFG_TYPE_FLOAT, (cfg_value_t){ .f = value });
+}
+
+esp_err_t cfg_set_from_string(const char *name, const char *text)
+{
+    if (name == NULL || text == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int k = 0; k < CFG_KEY_COUNT; k++) {
+        if (strcmp(s_schema[k].name, name) != 0) {
+            continue;
+        }
+        char *end;
+        errno = 0;
+        if (s_schema[k].type == CFG_TYPE_U32) {
+            const unsigned long v = strtoul(text, &end, 10);
+            if (errno != 0 || end == text || *end != '\0' || v > UINT32_MAX) {
+                return ESP_ERR_INVALID_ARG;
+            }
+            return cfg_set_u32(k, (uint32_t)v);
+        }
+        const float v = strtof(text, &end);
+        if (errno != 0 || end == text || *end != '\0') {
+            return ESP_ERR_INVALID_ARG;
+        }
+        return cfg_set_float(k, v);
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t cfg_subscribe(uint32_t mask, cfg_change_fn_t fn, void *ctx)
+{
+    if (fn == NULL || mask == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t err = ESP_OK;
+    portENTER_CRITICAL(&s_lock);
+    if (s_sub_count >= CFG_MAX_SUBSCRIBERS) {
+        err = ESP_ERR_NO_MEM;
+    } else {
+        s_subs[s_sub_count] = (cfg_subscriber_t){ .mask = mask, .fn = fn, .ctx = ctx };
+        s_sub_count++;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return err;
+}
+
+esp_err_t cfg_flush(void)
+{
+    if (s_save_mutex == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (s_save_job != NULL) {
+        sched_disarm(s_save_job);
+    }
+    return save();
+}
+
+bool cfg_describe(cfg_key_t key, const char **name, cfg_type_t *type, cfg_value_t *def,
+                  cfg_value_t *min, cfg_value_t *max)
+{
+    if (key >= CFG_KEY_COUNT) {
+        return false;
+    }
+    const cfg_schema_t *s = &s_schema[key];
+    if (name) {
+        *name = s->name;
+    }
+    if (type) {
+        *type = s->type;
+    }
+    if (def) {
+        *def = s->def;
+    }
+    if (min) {
+        *min = s->min;
+    }
+    if (max) {
+        *max = s->max;
+    }
+    return true;
+}
+
+void cfg_get_stats(cfg_stats_t *out)
+{
+    if (out == NULL) {
+        return;
+    }
+    portENTER_CRITICAL(&s_lock);
+    *out = s_stats;
+    portEXIT_CRITICAL(&s_lock);
+}
@@ -0,0 +1,161 @@
+/**
+ * @file config_store.h
+ * @brief Almacén central de configuración con tipos, rangos y persistencia agrupada.
+ * @details El esquema (config_store.c) define para cada clave su nombre, tipo, valor por
+ *          defecto y rango. cfg_init() carga una sola vez el blob guardado en NVS a una copia
+ *          en RAM; desde ahí las lecturas no tocan la flash. Cada cambio se valida contra el
+ *          rango, avisa a los suscriptores y arma un trabajo del planificador que escribe el
+ *          blob completo CFG_SAVE_DELAY_MS después del último cambio, de modo que una ráfaga
+ *          de cambios cuesta una sola escritura y un solo commit.
+ *
+ *          El blob lleva versión y guarda cada valor junto a su identificador, así que una
+ *          versión nueva del firmware puede agregar claves sin perder las existentes. Los
+ *          identificadores de cfg_key_t son parte del formato: solo se agregan al final.
+ *          Si no hay blob se migran las ganancias del espacio antiguo "pid_params".
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#ifndef CONFIG_STORE_H
+#define CONFIG_STORE_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CFG_MAX_SUBSCRIBERS     8       ///< Suscriptores registrados simultáneamente
+#define CFG_SAVE_DELAY_MS       2000    ///< Agrupa los cambios seguidos en una escritura
+
+/**
+ * @brief Claves de configuración (identificadores estables del formato guardado)
+ */
+typedef enum {
+    CFG_PID_KP = 0,             ///< Ganancia proporcional
+    CFG_PID_KI,                 ///< Ganancia integral
+    CFG_PID_KD,                 ///< Ganancia derivativa
+    CFG_PID_SAMPLE_TIME_MS,     ///< Periodo de control y ventana del SSR
+    CFG_PID_OUTPUT_MIN,         ///< Límite inferior de la salida (%)
+    CFG_PID_OUTPUT_MAX,         ///< Límite superior de la salida (%)
+    CFG_AUTOTUNE_HYSTERESIS,    ///< Histéresis del relé de autotuning (°C)
+    CFG_AUTOTUNE_RELAY_HIGH,    ///< Salida alta del relé (%)
+    CFG_AUTOTUNE_RELAY_LOW,     ///< Salida baja del relé (%)
+    CFG_AUTOTUNE_MIN_CYCLES,    ///< Oscilaciones mínimas para calcular Ku y Pu
+    CFG_AUTOTUNE_DELAY_MS,      ///< Espera entre pasos del autotuning
+    CFG_PID_SETPOINT_MAX,       ///< Setpoint máximo aceptado (°C)
+    CFG_KEY_COUNT
+} cfg_key_t;
+
+/**
+ * @brief Tipo de una clave
+ */
+typedef enum {
+    CFG_TYPE_U32 = 0,
+    CFG_TYPE_FLOAT,
+} cfg_type_t;
+
+/**
+ * @brief Valor de una clave (el campo según cfg_type_t)
+ */
+typedef union {
+    uint32_t u32;
+    float f;
+} cfg_value_t;
+
+/**
+ * @brief Aviso de cambio; corre en la tarea que hizo el cambio y debe ser breve
+ */
+typedef void (*cfg_change_fn_t)(cfg_key_t key, cfg_value_t value, void *ctx);
+
+/**
+ * @brief Contadores de acceso a NVS
+ */
+typedef struct {
+    uint32_t load_us;           ///< Duración de la carga en cfg_init()
+    uint32_t nvs_opens;         ///< nvs_open() realizados
+    uint32_t nvs_reads;         ///< Lecturas de NVS
+    uint32_t nvs_writes;        ///< Escrituras de NVS (blob, borrado del espacio antiguo)
+    uint32_t nvs_commits;       ///< nvs_commit() realizados
+    uint32_t changes;           ///< Cambios aceptados
+    uint32_t rejected;          ///< Cambios fuera de rango o de tipo equivocado
+    uint32_t saves_skipped;     ///< Guardados evitados porque el blob no cambió
+    bool migrated;              ///< Se migraron las ganancias de "pid_params"
+} cfg_stats_t;
+
+/**
+ * @brief Carga la configuración de NVS y registra el guardado agrupado y las métricas "cfg"
+ * @details Requiere nvs_flash_init() y sched_init(). Si no hay blob se usan los valores por
+ *          defecto; un valor guardado fuera de rango también se reemplaza por su defecto.
+ * @return ESP_OK, o el error de sched_add() (los valores igual quedan cargados)
+ */
+esp_err_t cfg_init(void);
+
+/**
+ * @brief Indica si un valor está dentro del rango de la clave (sin cambiarla)
+ */
+bool cfg_valid(cfg_key_t key, cfg_value_t value);
+
+/**
+ * @brief Lee una clave entera (0 si la clave no es CFG_TYPE_U32)
+ */
+uint32_t cfg_get_u32(cfg_key_t key);
+
+/**
+ * @brief Lee una clave de punto flotante (0 si la clave no es CFG_TYPE_FLOAT)
+ */
+float cfg_get_float(cfg_key_t key);
+
+/**
+ * @brief Cambia una clave entera
+ * @return ESP_OK (también si el valor no cambió), ESP_ERR_INVALID_ARG fuera de rango o
+ *         con una clave de otro tipo
+ */
+esp_err_t cfg_set_u32(cfg_key_t key, uint32_t value);
+
+/**
+ * @brief Cambia una clave de punto flotante
+ * @return ESP_OK (también si el valor no cambió), ESP_ERR_INVALID_ARG fuera de rango, no
+ *         finito o con una clave de otro tipo
+ */
+esp_err_t cfg_set_float(cfg_key_t key, float value);
+
+/**
+ * @brief Cambia una clave a partir de su nombre y un texto (consola)
+ * @return Como cfg_set_u32()/cfg_set_float(), o ESP_ERR_NOT_FOUND con un nombre desconocido
+ */
+esp_err_t cfg_set_from_string(const char *name, const char *text);
+
+/**
+ * @brief Registra un aviso de cambio
+ * @param mask Claves de interés, un bit por cfg_key_t
+ * @return ESP_OK, ESP_ERR_INVALID_ARG o ESP_ERR_NO_MEM
+ */
+esp_err_t cfg_subscribe(uint32_t mask, cfg_change_fn_t fn, void *ctx);
+
+/**
+ * @brief Guarda ya los cambios pendientes (sin esperar al trabajo agrupado)
+ * @return ESP_OK (también sin cambios) o el error de NVS
+ */
+esp_err_t cfg_flush(void);
+
+/**
+ * @brief Nombre, tipo y límites de una clave
+ * @return false si `key` está fuera de rango
+ */
+bool cfg_describe(cfg_key_t key, const char **name, cfg_type_t *type, cfg_value_t *def,
+                  cfg_value_t *min, cfg_value_t *max);
+
+/**
+ * @brief Copia los contadores de acceso a NVS
+ */
+void cfg_get_stats(cfg_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CONFIG_STORE_H
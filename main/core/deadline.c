@@ -0,0 +1,271 @@
+/**
+ * @file deadline.c
+ * @brief Implementación del monitor de plazos.
+ * @details Cada monitor lo actualiza una sola tarea, así que sus campos se escriben sin
+ *          lock; los lectores (métricas, informe) pueden ver un valor a medio actualizar,
+ *          lo que es aceptable para diagnóstico. Solo el recuento global de monitores en
+ *          alarma, que decide cuándo publicar la falla, se protege con un spinlock.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#include "deadline.h"
+#include "event_bus.h"
+#include "timebase.h"
+#include "metrics.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include <stdio.h>
+
+static const char *TAG = "DEADLINE";
+
+struct deadline_monitor {
+    deadline_stats_t stats;
+    int64_t begin_us;           ///< Inicio de la activación en curso (o la última)
+    int64_t prev_begin_us;      ///< Inicio anterior; 0 si no hay con qué comparar
+    uint32_t on_time_runs;      ///< Activaciones seguidas sin perder el plazo
+    bool late;                  ///< La activación en curso empezó fuera de tolerancia
+};
+
+static struct deadline_monitor s_monitors[DEADLINE_MAX_MONITORS];
+static size_t s_count = 0;
+static uint32_t s_alarms = 0;       ///< Monitores en alarma
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static const uint32_t s_bounds[DEADLINE_HIST_BUCKETS] = DEADLINE_HIST_BOUNDS_US;
+
+// ───────────────────────────────────────────────────────
+// Alarmas
+
+static void publish_fault(bool active)
+{
+    evbus_event_t ev = { .type = EVBUS_FAULT, .fault = { .code = EVBUS_FAULT_DEADLINE, .active = active } };
+    evbus_publish(&ev);
+}
+
+static void record_miss(struct deadline_monitor *m, const char *what, uint32_t value_us, uint32_t limit_us)
+{
+    m->on_time_runs = 0;
+    if (m->stats.alarm) {
+        return;         // Solo se avisa la primera de una racha
+    }
+    m->stats.alarm = true;
+    ESP_LOGW(TAG, "'%s' perdió el plazo: %s %lu us (límite %lu us)", m->stats.name, what,
+             (unsigned long)value_us, (unsigned long)limit_us);
+
+    portENTER_CRITICAL(&s_lock);
+    const bool first = s_alarms++ == 0;
+    portEXIT_CRITICAL(&s_lock);
+    if (first) {
+        publish_fault(true);
+    }
+}
+
+static void record_on_time(struct deadline_monitor *m)
+{
+    if (!m->stats.alarm || ++m->on_time_runs < DEADLINE_CLEAR_RUNS) {
+        return;
+    }
+    m->stats.alarm = false;
+    portENTER_CRITICAL(&s_lock);
+    const bool last = --s_alarms == 0;
+    portEXIT_CRITICAL(&s_lock);
+    if (last) {
+        publish_fault(false);
+    }
+}
+
+// ───────────────────────────────────────────────────────
+// Métricas
+
+static void deadline_metrics(metrics_writer_t *w, void *ctx)
+{
+    (void)ctx;
+    deadline_stats_t st[DEADLINE_MAX_MONITORS];
+    const size_t n = deadline_get_stats(st, DEADLINE_MAX_MONITORS);
+    char labels[64];
+    for (size_t i = 0; i < n; i++) {
+        const deadline_stats_t *s = &st[i];
+        snprintf(labels, sizeof(labels), "activity=\"%s\"", s->name);
+        metrics_write_uint(w, "deadline_period_expected_us", labels, s->period_us);
+        metrics_write_uint(w, "deadline_runs_total", labels, s->runs);
+        metrics_write_uint(w, "deadline_misses_late_total", labels, s->misses_late);
+        metrics_write_uint(w, "deadline_misses_overrun_total", labels, s->misses_overrun);
+        metrics_write_uint(w, "deadline_period_min_us", labels, s->period_min_us);
+        metrics_write_uint(w, "deadline_period_max_us", labels, s->period_max_us);
+        metrics_write_uint(w, "deadline_exec_max_us", labels, s->exec_max_us);
+        metrics_write_uint(w, "deadline_exec_sum_us", labels, s->exec_sum_us);
+        metrics_write_uint(w, "deadline_alarm", labels, s->alarm);
+
+        // Histograma acumulado al estilo Prometheus
+        uint32_t cumulative = 0;
+        for (int b = 0; b < DEADLINE_HIST_BUCKETS; b++) {
+            cumulative += s->jitter_hist[b];
+            if (s_bounds[b] == UINT32_MAX) {
+                snprintf(labels, sizeof(labels), "activity=\"%s\",le=\"+Inf\"", s->name);
+            } else {
+                snprintf(labels, sizeof(labels), "activity=\"%s\",le=\"%lu\"", s->name, (unsigned long)s_bounds[b]);
+            }
+            metrics_write_uint(w, "deadline_jitter_us_bucket", labels, cumulative);
+        }
+    }
+}
+
+// ───────────────────────────────────────────────────────
+// API pública
+
+esp_err_t deadline_register(const char *name, uint32_t period_us, uint32_t tolerance_us,
+                            uint32_t budget_us, deadline_handle_t *out)
+{
+    if (name == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    struct deadline_monitor *m = NULL;
+    bool first = false;
+    portENTER_CRITICAL(&s_lock);
+    if (s_count < DEADLINE_MAX_MONITORS) {
+        first = s_count == 0;
+        m = &s_monitors[s_count++];
+        m->stats.name = name;
+        m->stats.period_us = period_us;
+        m->stats.tolerance_us = tolerance_us;
+        m->stats.budget_us = budget_us;
+        m->stats.period_min_us = UINT32_MAX;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    if (m == NULL) {
+        ESP_LOGE(TAG, "Sin espacio para el monitor '%s'", name);
+        return ESP_ERR_NO_MEM;
+    }
+    if (first) {
+        metrics_register("deadline", deadline_metrics, NULL);
+    }
+    *out = m;
+    return ESP_OK;
+}
+
+void deadline_begin(deadline_handle_t h)
+{
+    if (h == NULL) {
+        return;
+    }
+    const int64_t now = timebase_mono_us();
+    h->begin_us = now;
+    h->late = false;
+    h->stats.runs++;
+
+    if (h->stats.period_us == 0 || h->prev_begin_us == 0) {
+        h->prev_begin_us = now;
+        return;
+    }
+    const uint32_t period = (uint32_t)(now - h->prev_begin_us);
+    h->prev_begin_us = now;
+
+    h->stats.period_last_us = period;
+    if (period < h->stats.period_min_us) {
+        h->stats.period_min_us = period;
+    }
+    if (period > h->stats.period_max_us) {
+        h->stats.period_max_us = period;
+    }
+
+    const int32_t jitter = (int32_t)(period - h->stats.period_us);
+    const uint32_t abs_jitter = jitter < 0 ? (uint32_t)-jitter : (uint32_t)jitter;
+    int b = 0;
+    while (abs_jitter > s_bounds[b]) {
+        b++;
+    }
+    h->stats.jitter_hist[b]++;
+
+    if (jitter > 0 && (uint32_t)jitter > h->stats.tolerance_us) {
+        h->stats.misses_late++;
+        h->late = true;
+        record_miss(h, "periodo", period, h->stats.period_us + h->stats.tolerance_us);
+    }
+}
+
+void deadline_end(deadline_handle_t h)
+{
+    if (h == NULL || h->begin_us == 0) {
+        return;
+    }
+    const uint32_t exec = (uint32_t)(timebase_mono_us() - h->begin_us);
+    h->stats.exec_last_us = exec;
+    if (exec > h->stats.exec_max_us) {
+        h->stats.exec_max_us = exec;
+    }
+    h->stats.exec_sum_us += exec;
+
+    if (h->stats.budget_us && exec > h->stats.budget_us) {
+        h->stats.misses_overrun++;
+        record_miss(h, "ejecución", exec, h->stats.budget_us);
+    } else if (!h->late) {
+        record_on_time(h);
+    }
+}
+
+void deadline_set_period(deadline_handle_t h, uint32_t period_us)
+{
+    if (h) {
+        h->stats.period_us = period_us;
+        h->prev_begin_us = 0;
+    }
+}
+
+void deadline_set_budget(deadline_handle_t h, uint32_t budget_us)
+{
+    if (h) {
+        h->stats.budget_us = budget_us;
+    }
+}
+
+void deadline_restart(deadline_handle_t h)
+{
+    if (h) {
+        h->prev_begin_us = 0;
+    }
+}
+
+size_t deadline_get_stats(deadline_stats_t *out, size_t max)
+{
+    if (out == NULL) {
+        return 0;
+    }
+    portENTER_CRITICAL(&s_lock);
+    const size_t count = s_count;
+    portEXIT_CRITICAL(&s_lock);
+
+    size_t n = 0;
+    for (size_t i = 0; i < count && n < max; i++) {
+        out[n] = s_monitors[i].stats;
+        if (out[n].period_min_us == UINT32_MAX) {
+            out[n].period_min_us = 0;
+        }
+        n++;
+    }
+    return n;
+}
+
+void deadline_log_report(void)
+{
+    deadline_stats_t st[DEADLINE_MAX_MONITORS];
+    const size_t n = deadline_get_stats(st, DEADLINE_MAX_MONITORS);
+    ESP_LOGI(TAG, "=== Plazos: %u actividades ===", (unsigned)n);
+    for (size_t i = 0; i < n; i++) {
+        const deadline_stats_t *s = &st[i];
+        ESP_LOGI(TAG, "%-12s periodo %7lu us [%7lu..%7lu]  ejec. media %6lu máx %6lu us  tarde %lu  excedida %lu%s",
+                 s->name, (unsigned long)s->period_us, (unsigned long)s->period_min_us,
+                 (unsigned long)s->period_max_us,
+                 (unsigned long)(s->runs ? s->exec_sum_us / s->runs : 0), (unsigned long)s->exec_max_us,
+                 (unsigned long)s->misses_late, (unsigned long)s->misses_overrun,
+                 s->alarm ? "  << ALARMA" : "");
+        if (s->period_us) {
+            ESP_LOGI(TAG, "%-12s jitter ≤100us %lu  ≤500us %lu  ≤1ms %lu  ≤5ms %lu  ≤10ms %lu  ≤50ms %lu  ≤100ms %lu  >100ms %lu",
+                     "", (unsigned long)s->jitter_hist[0], (unsigned long)s->jitter_hist[1],
+                     (unsigned long)s->jitter_hist[2], (unsigned long)s->jitter_hist[3],
+                     (unsigned long)s->jitter_hist[4], (unsigned long)s->jitter_hist[5],
+                     (unsigned long)s->jitter_hist[6], (unsigned long)s->jitter_hist[7]);
+        }
+    }
+}
@@ -0,0 +1,123 @@
+/**
+ * @file deadline.h
+ * @brief Monitor de plazos de las actividades periódicas.
+ * @details Cada actividad (lazo de control, ventana del SSR, lectura del sensor, difusión
+ *          WebSocket, cuadro de LVGL) se registra con su periodo esperado, la tolerancia de
+ *          atraso y un presupuesto de ejecución, y marca el inicio y el fin de cada
+ *          activación. El monitor guarda periodo y tiempo de ejecución reales, un histograma
+ *          de jitter del periodo y cuenta como plazo perdido:
+ *          - una activación que llega más tarde que `period + tolerance`, o
+ *          - una ejecución que dura más que el presupuesto.
+ *
+ *          Un plazo perdido se avisa en el log y publica EVBUS_FAULT/EVBUS_FAULT_DEADLINE; la
+ *          falla se despeja cuando ningún monitor acumula DEADLINE_CLEAR_RUNS activaciones
+ *          seguidas a tiempo. Cada monitor debe actualizarse desde una sola tarea.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#ifndef DEADLINE_H
+#define DEADLINE_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DEADLINE_MAX_MONITORS   8       ///< Monitores registrados simultáneamente
+#define DEADLINE_HIST_BUCKETS   8       ///< Cubetas del histograma de jitter
+#define DEADLINE_CLEAR_RUNS     20      ///< Activaciones a tiempo para despejar la alarma
+
+/**
+ * @brief Límites superiores (µs) de las cubetas del histograma; la última es abierta
+ */
+#define DEADLINE_HIST_BOUNDS_US { 100, 500, 1000, 5000, 10000, 50000, 100000, UINT32_MAX }
+
+/**
+ * @brief Identificador de un monitor
+ */
+typedef struct deadline_monitor *deadline_handle_t;
+
+/**
+ * @brief Estadísticas de un monitor
+ */
+typedef struct {
+    const char *name;               ///< Nombre de la actividad
+    uint32_t period_us;             ///< Periodo esperado (0: sin control de periodo)
+    uint32_t tolerance_us;          ///< Atraso admitido sobre el periodo
+    uint32_t budget_us;             ///< Presupuesto de ejecución (0: sin límite)
+    uint32_t runs;                  ///< Activaciones
+    uint32_t misses_late;           ///< Activaciones fuera de tolerancia
+    uint32_t misses_overrun;        ///< Ejecuciones por encima del presupuesto
+    uint32_t period_last_us;        ///< Último periodo medido
+    uint32_t period_min_us;         ///< Periodo mínimo medido
+    uint32_t period_max_us;         ///< Periodo máximo medido
+    uint32_t exec_last_us;          ///< Última ejecución
+    uint32_t exec_max_us;           ///< Ejecución más larga
+    uint64_t exec_sum_us;           ///< Ejecución acumulada
+    uint32_t jitter_hist[DEADLINE_HIST_BUCKETS];    ///< |periodo real - esperado| por cubeta
+    bool alarm;                     ///< Perdió un plazo y aún no se despejó
+} deadline_stats_t;
+
+/**
+ * @brief Registra una actividad
+ * @param name Nombre (cadena estática)
+ * @param period_us Periodo esperado entre inicios; 0 para actividades sin periodo fijo
+ * @param tolerance_us Atraso del inicio admitido antes de contar un plazo perdido
+ * @param budget_us Duración máxima de una activación; 0 sin límite
+ * @param[out] out Identificador
+ * @return ESP_OK, ESP_ERR_INVALID_ARG o ESP_ERR_NO_MEM
+ */
+esp_err_t deadline_register(const char *name, uint32_t period_us, uint32_t tolerance_us,
+                            uint32_t budget_us, deadline_handle_t *out);
+
+/**
+ * @brief Marca el inicio de una activación (mide el periodo desde el inicio anterior)
+ * @details Acepta un identificador NULL (registro fallido) y no hace nada.
+ */
+void deadline_begin(deadline_handle_t h);
+
+/**
+ * @brief Marca el fin de la activación en curso (mide la ejecución)
+ */
+void deadline_end(deadline_handle_t h);
+
+/**
+ * @brief Cambia el periodo esperado (p. ej. al cambiar el tiempo de muestreo)
+ * @details Reinicia la medición del periodo: el próximo inicio no se compara.
+ */
+void deadline_set_period(deadline_handle_t h, uint32_t period_us);
+
+/**
+ * @brief Cambia el presupuesto de ejecución (ventanas de duración variable)
+ */
+void deadline_set_budget(deadline_handle_t h, uint32_t budget_us);
+
+/**
+ * @brief Olvida el inicio anterior (tras una pausa deliberada de la actividad)
+ */
+void deadline_restart(deadline_handle_t h);
+
+/**
+ * @brief Obtiene las estadísticas de todos los monitores
+ * @param out Arreglo de salida
+ * @param max Capacidad de `out`
+ * @return Número de monitores copiados
+ */
+size_t deadline_get_stats(deadline_stats_t *out, size_t max);
+
+/**
+ * @brief Imprime en el log periodos, ejecuciones, plazos perdidos y jitter
+ */
+void deadline_log_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DEADLINE_H
@@ -0,0 +1,281 @@
+/**
+ * @file event_bus.c
+ * @brief Implementación del bus de eventos.
+ * @details Cada suscriptor tiene una cola acotada de celdas con número de secuencia
+ *          (esquema de Vyukov): un productor reserva una celda con CAS sobre la posición
+ *          de escritura y la publica al guardar la secuencia; el único consumidor es el
+ *          trabajo del suscriptor. El trabajo se arma con sched_trigger() solo cuando la
+ *          cola pasa de vacía a pendiente, así que una ráfaga cuesta un único disparo.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#include "event_bus.h"
+#include "scheduler.h"
+#include "timebase.h"
+#include "metrics.h"
+#include "mem_budget.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+static const char *TAG = "EVBUS";
+
+typedef struct {
+    atomic_uint seq;
+    evbus_event_t ev;
+} evbus_cell_t;
+
+typedef struct {
+    const char *name;
+    uint32_t mask;
+    evbus_handler_t handler;
+    void *ctx;
+    evbus_cell_t *cells;
+    uint32_t index_mask;            ///< Profundidad - 1
+    atomic_uint enqueue_pos;
+    uint32_t dequeue_pos;           ///< Solo lo toca el consumidor
+    atomic_bool ready;              ///< Entrada completa y visible a los publicadores
+    atomic_bool pending;            ///< Trabajo ya disparado y aún sin vaciar la cola
+    sched_job_handle_t job;
+    atomic_uint dropped;
+    evbus_sub_stats_t stats;        ///< Lo actualiza el consumidor (salvo `dropped`)
+} evbus_sub_t;
+
+static evbus_sub_t s_subs[EVBUS_MAX_SUBSCRIBERS];
+static uint32_t s_sub_reserved = 0;    ///< Entradas tomadas (listas o no)
+static portMUX_TYPE s_sub_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static atomic_uint s_seq = 0;
+static atomic_uint s_published = 0;
+static atomic_uint s_dropped = 0;
+static atomic_uint s_cycles_last = 0;
+static atomic_uint s_cycles_max = 0;
+static atomic_uint s_cycles_total = 0;
+
+// ───────────────────────────────────────────────────────
+// Cola por suscriptor
+
+static bool queue_push(evbus_sub_t *sub, const evbus_event_t *ev)
+{
+    uint32_t pos = atomic_load_explicit(&sub->enqueue_pos, memory_order_relaxed);
+    evbus_cell_t *cell;
+    for (;;) {
+        cell = &sub->cells[pos & sub->index_mask];
+        const uint32_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        const int32_t dif = (int32_t)(seq - pos);
+        if (dif == 0) {
+            if (atomic_compare_exchange_weak_explicit(&sub->enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (dif < 0) {
+            return false;       // Llena: la celda aún no fue consumida
+        } else {
+            pos = atomic_load_explicit(&sub->enqueue_pos, memory_order_relaxed);
+        }
+    }
+    cell->ev = *ev;
+    atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+    return true;
+}
+
+static bool queue_pop(evbus_sub_t *sub, evbus_event_t *ev)
+{
+    const uint32_t pos = sub->dequeue_pos;
+    evbus_cell_t *cell = &sub->cells[pos & sub->index_mask];
+    const uint32_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+    if ((int32_t)(seq - (pos + 1)) < 0) {
+        return false;           // Vacía o el productor aún no terminó de escribir
+    }
+    *ev = cell->ev;
+    atomic_store_explicit(&cell->seq, pos + sub->index_mask + 1, memory_order_release);
+    sub->dequeue_pos = pos + 1;
+    return true;
+}
+
+/**
+ * @brief Trabajo del suscriptor: vacía su cola y entrega cada evento
+ */
+static void sub_job(void *ctx)
+{
+    evbus_sub_t *sub = ctx;
+    // Bajar la marca antes de vaciar: lo que llegue después vuelve a disparar el trabajo
+    atomic_store(&sub->pending, false);
+
+    evbus_event_t ev;
+    while (queue_pop(sub, &ev)) {
+        const int64_t lat = timebase_mono_us() - ev.t_us;
+        const uint32_t lat_us = lat > 0 ? (uint32_t)lat : 0;
+        sub->stats.latency_last_us = lat_us;
+        if (lat_us > sub->stats.latency_max_us) {
+            sub->stats.latency_max_us = lat_us;
+        }
+        sub->stats.latency_sum_us += lat_us;
+        sub->stats.delivered++;
+        sub->handler(&ev, sub->ctx);
+    }
+}
+
+// ───────────────────────────────────────────────────────
+// Métricas
+
+static void evbus_metrics(metrics_writer_t *w, void *ctx)
+{
+    (void)ctx;
+    evbus_stats_t st;
+    evbus_get_stats(&st);
+    metrics_write_uint(w, "evbus_published_total", NULL, st.published);
+    metrics_write_uint(w, "evbus_dropped_total", NULL, st.dropped);
+    metrics_write_uint(w, "evbus_publish_cycles_last", NULL, st.publish_cycles_last);
+    metrics_write_uint(w, "evbus_publish_cycles_max", NULL, st.publish_cycles_max);
+    metrics_write_uint(w, "evbus_publish_cycles_total", NULL, st.publish_cycles_total);
+
+    evbus_sub_stats_t subs[EVBUS_MAX_SUBSCRIBERS];
+    const size_t n = evbus_get_sub_stats(subs, EVBUS_MAX_SUBSCRIBERS);
+    char labels[40];
+    for (size_t i = 0; i < n; i++) {
+        snprintf(labels, sizeof(labels), "sub=\"%s\"", subs[i].name);
+        metrics_write_uint(w, "evbus_sub_delivered_total", labels, subs[i].delivered);
+        metrics_write_uint(w, "evbus_sub_dropped_total", labels, subs[i].dropped);
+        metrics_write_uint(w, "evbus_sub_latency_max_us", labels, subs[i].latency_max_us);
+        metrics_write_uint(w, "evbus_sub_latency_sum_us", labels, subs[i].latency_sum_us);
+    }
+}
+
+// ───────────────────────────────────────────────────────
+// API pública
+
+esp_err_t evbus_init(void)
+{
+    metrics_register("evbus", evbus_metrics, NULL);
+    return ESP_OK;
+}
+
+esp_err_t evbus_subscribe(const char *name, uint32_t mask, size_t depth,
+                          evbus_handler_t handler, void *ctx)
+{
+    if (name == NULL || handler == NULL || mask == 0 || depth == 0 || depth > 1024) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint32_t size = 1;
+    while (size < depth) {
+        size <<= 1;
+    }
+
+    // Las colas viven mientras dure la suscripción: se presupuestan antes de reservarlas
+    const size_t bytes = size * sizeof(evbus_cell_t);
+    esp_err_t ret = mem_budget_claim(MEM_MOD_EVBUS, MEM_REGION_INTERNAL, bytes);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    evbus_cell_t *cells = calloc(size, sizeof(evbus_cell_t));
+    if (cells == NULL) {
+        mem_budget_release(MEM_MOD_EVBUS, MEM_REGION_INTERNAL, bytes);
+        return ESP_ERR_NO_MEM;
+    }
+    for (uint32_t i = 0; i < size; i++) {
+        atomic_init(&cells[i].seq, i);
+    }
+
+    portENTER_CRITICAL(&s_sub_lock);
+    const uint32_t idx = s_sub_reserved;
+    if (idx < EVBUS_MAX_SUBSCRIBERS) {
+        s_sub_reserved++;
+    }
+    portEXIT_CRITICAL(&s_sub_lock);
+    if (idx >= EVBUS_MAX_SUBSCRIBERS) {
+        free(cells);
+        mem_budget_release(MEM_MOD_EVBUS, MEM_REGION_INTERNAL, bytes);
+        ESP_LOGE(TAG, "Sin entradas para el suscriptor '%s'", name);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // La entrada se completa antes de marcarla lista para los publicadores
+    evbus_sub_t *sub = &s_subs[idx];
+    sub->name = name;
+    sub->mask = mask;
+    sub->handler = handler;
+    sub->ctx = ctx;
+    sub->cells = cells;
+    sub->index_mask = size - 1;
+    sub->stats.name = name;
+    ret = sched_add(name, sub_job, sub, SCHED_DISARMED, 0, &sub->job);
+    if (ret != ESP_OK) {
+        // La entrada queda reservada pero nunca lista
+        ESP_LOGE(TAG, "No se pudo registrar el trabajo de '%s': %s", name, esp_err_to_name(ret));
+        return ret;
+    }
+    atomic_store_explicit(&sub->ready, true, memory_order_release);
+    return ESP_OK;
+}
+
+esp_err_t evbus_publish(evbus_event_t *ev)
+{
+    const uint32_t start = esp_cpu_get_cycle_count();
+
+    ev->seq = atomic_fetch_add_explicit(&s_seq, 1, memory_order_relaxed);
+    ev->t_us = timebase_mono_us();
+    const uint32_t bit = EVBUS_MASK(ev->type);
+
+    esp_err_t ret = ESP_OK;
+    for (uint32_t i = 0; i < EVBUS_MAX_SUBSCRIBERS; i++) {
+        evbus_sub_t *sub = &s_subs[i];
+        if (!atomic_load_explicit(&sub->ready, memory_order_acquire) || !(sub->mask & bit)) {
+            continue;
+        }
+        if (!queue_push(sub, ev)) {
+            atomic_fetch_add_explicit(&sub->dropped, 1, memory_order_relaxed);
+            atomic_fetch_add_explicit(&s_dropped, 1, memory_order_relaxed);
+            ret = ESP_ERR_NO_MEM;
+            continue;
+        }
+        if (!atomic_exchange(&sub->pending, true)) {
+            sched_trigger(sub->job, 0);
+        }
+    }
+    atomic_fetch_add_explicit(&s_published, 1, memory_order_relaxed);
+
+    const uint32_t cycles = esp_cpu_get_cycle_count() - start;
+    atomic_store_explicit(&s_cycles_last, cycles, memory_order_relaxed);
+    atomic_fetch_add_explicit(&s_cycles_total, cycles, memory_order_relaxed);
+    uint32_t max = atomic_load_explicit(&s_cycles_max, memory_order_relaxed);
+    while (cycles > max &&
+           !atomic_compare_exchange_weak_explicit(&s_cycles_max, &max, cycles,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+    return ret;
+}
+
+void evbus_get_stats(evbus_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    stats->published = atomic_load(&s_published);
+    stats->dropped = atomic_load(&s_dropped);
+    stats->publish_cycles_last = atomic_load(&s_cycles_last);
+    stats->publish_cycles_max = atomic_load(&s_cycles_max);
+    stats->publish_cycles_total = atomic_load(&s_cycles_total);
+}
+
+size_t evbus_get_sub_stats(evbus_sub_stats_t *out, size_t max)
+{
+    if (out == NULL) {
+        return 0;
+    }
+    size_t n = 0;
+    for (uint32_t i = 0; i < EVBUS_MAX_SUBSCRIBERS && n < max; i++) {
+        if (!atomic_load_explicit(&s_subs[i].ready, memory_order_acquire)) {
+            continue;
+        }
+        out[n] = s_subs[i].stats;
+        out[n].dropped = atomic_load(&s_subs[i].dropped);
+        n++;
+    }
+    return n;
+}
@@ -0,0 +1,162 @@
+/**
+ * @file event_bus.h
+ * @brief Bus de eventos publicar/suscribir entre módulos.
+ * @details Los módulos publican hechos (muestra de temperatura, flanco del SSR, cambio de
+ *          setpoint, falla, estado de red) sin conocer a quién le interesan. Cada suscriptor
+ *          tiene su propia cola circular sin bloqueos (varios productores, un consumidor) y
+ *          un trabajo del planificador que la vacía y llama a su manejador, de modo que el
+ *          trabajo del suscriptor nunca corre en el contexto de quien publica.
+ *
+ *          Publicar nunca bloquea: si la cola de un suscriptor está llena, el evento se
+ *          descarta para ese suscriptor y se cuenta. No se puede publicar desde una ISR.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EVBUS_MAX_SUBSCRIBERS   8       ///< Suscriptores registrados simultáneamente
+#define EVBUS_DEFAULT_DEPTH     16      ///< Profundidad de cola sugerida
+
+#define EVBUS_MASK(type)        (1u << (type))  ///< Máscara de suscripción para un tipo
+
+/**
+ * @brief Tipos de evento
+ */
+typedef enum {
+    EVBUS_SAMPLE = 0,       ///< Nueva muestra de temperatura
+    EVBUS_SSR_EDGE,         ///< El SSR cambió de estado
+    EVBUS_SETPOINT,         ///< El setpoint del PID cambió
+    EVBUS_FAULT,            ///< Una falla se activó o se despejó
+    EVBUS_NET_STATE,        ///< Cambio de estado de la conexión WiFi
+    EVBUS_TYPE_COUNT
+} evbus_type_t;
+
+/**
+ * @brief Códigos de falla
+ */
+typedef enum {
+    EVBUS_FAULT_SENSOR = 0, ///< Sin respuesta válida del sensor de temperatura
+    EVBUS_FAULT_OVERTEMP,   ///< Temperatura por encima del setpoint más el margen
+    EVBUS_FAULT_DEADLINE,   ///< Una actividad periódica perdió su plazo (deadline.h)
+} evbus_fault_t;
+
+/**
+ * @brief Evento publicado
+ * @details `seq` y `t_us` los completa evbus_publish().
+ */
+typedef struct {
+    uint8_t type;               ///< evbus_type_t
+    uint32_t seq;               ///< Número de publicación global
+    int64_t t_us;               ///< Instante de publicación (timebase_mono_us)
+    union {
+        struct {
+            float temp_c;       ///< Temperatura filtrada (EMA)
+            float raw_c;        ///< Lectura cruda
+        } sample;
+        struct {
+            bool on;            ///< Nuevo estado del SSR
+        } ssr;
+        struct {
+            float value;        ///< Nuevo setpoint en °C
+            uint8_t source;     ///< Origen de la orden (pid_cmd_source_t)
+        } setpoint;
+        struct {
+            uint8_t code;       ///< evbus_fault_t
+            bool active;        ///< true al activarse, false al despejarse
+        } fault;
+        struct {
+            uint8_t state;      ///< wifi_manager_state_t
+            uint8_t reason;     ///< Motivo de la última desconexión
+        } net;
+    };
+} evbus_event_t;
+
+/**
+ * @brief Manejador de un suscriptor
+ * @details Corre en la tarea del planificador; no debe bloquear.
+ * @param ev Evento recibido
+ * @param ctx Contexto indicado al suscribirse
+ */
+typedef void (*evbus_handler_t)(const evbus_event_t *ev, void *ctx);
+
+/**
+ * @brief Estadísticas globales del bus
+ */
+typedef struct {
+    uint32_t published;             ///< Eventos publicados
+    uint32_t dropped;               ///< Entregas descartadas por colas llenas
+    uint32_t publish_cycles_last;   ///< Ciclos de CPU de la última publicación
+    uint32_t publish_cycles_max;    ///< Ciclos de CPU de la publicación más costosa
+    uint32_t publish_cycles_total;  ///< Ciclos acumulados (contador de 32 bits, da la vuelta)
+} evbus_stats_t;
+
+/**
+ * @brief Estadísticas de un suscriptor
+ */
+typedef struct {
+    const char *name;           ///< Nombre del suscriptor
+    uint32_t delivered;         ///< Eventos entregados al manejador
+    uint32_t dropped;           ///< Eventos descartados por cola llena
+    uint32_t latency_last_us;   ///< Publicación → manejador, último evento
+    uint32_t latency_max_us;    ///< Publicación → manejador, máximo
+    uint64_t latency_sum_us;    ///< Publicación → manejador, acumulado
+} evbus_sub_stats_t;
+
+/**
+ * @brief Registra el proveedor de métricas "evbus"
+ * @return ESP_OK
+ */
+esp_err_t evbus_init(void);
+
+/**
+ * @brief Suscribe un manejador a uno o más tipos de evento
+ * @details No hay baja de suscripciones: se registran al iniciar cada módulo.
+ *          Los eventos publicados antes de suscribirse no se entregan.
+ * @param name Nombre (cadena estática; también nombra el trabajo del planificador)
+ * @param mask Máscara de tipos (EVBUS_MASK)
+ * @param depth Eventos pendientes como máximo (se redondea a potencia de dos)
+ * @param handler Manejador
+ * @param ctx Contexto para `handler`
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, ESP_ERR_NO_MEM, o el error de sched_add()
+ */
+esp_err_t evbus_subscribe(const char *name, uint32_t mask, size_t depth,
+                          evbus_handler_t handler, void *ctx);
+
+/**
+ * @brief Publica un evento a todos los suscriptores interesados
+ * @details No bloquea. Completa `seq` y `t_us` en `ev`.
+ * @param ev Evento con `type` y la carga correspondiente
+ * @return ESP_OK, o ESP_ERR_NO_MEM si al menos un suscriptor tenía la cola llena
+ */
+esp_err_t evbus_publish(evbus_event_t *ev);
+
+/**
+ * @brief Obtiene las estadísticas globales
+ */
+void evbus_get_stats(evbus_stats_t *stats);
+
+/**
+ * @brief Obtiene las estadísticas de los suscriptores
+ * @param out Arreglo de salida
+ * @param max Capacidad de `out`
+ * @return Número de suscriptores copiados
+ */
+size_t evbus_get_sub_stats(evbus_sub_stats_t *out, size_t max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EVENT_BUS_H
@@ -0,0 +1,441 @@
+/**
+ * @file log_tap.c
+ * @brief Implementación de la derivación remota del log.
+ * @details El anillo es un arreglo de celdas con número de secuencia. Quien escribe reserva
+ *          un turno con un incremento atómico, marca la celda como "en escritura" (secuencia
+ *          0), copia la línea y publica la secuencia turno + 1. Cada lector compara la
+ *          secuencia antes y después de copiar una celda (como un seqlock): si cambió, la
+ *          línea se pisó mientras se leía y se cuenta como descartada.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#include "log_tap.h"
+#include "metrics.h"
+#include "mem_budget.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_heap_caps.h"
+#include "sdkconfig.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#if CONFIG_LOG_TAP_ENABLE
+
+static const char *TAG = "LOGTAP";
+
+/**
+ * @brief Filtro de niveles por etiqueta
+ */
+typedef struct {
+    esp_log_level_t def;                    ///< Nivel para etiquetas sin regla
+    uint8_t count;                          ///< Reglas válidas
+    struct {
+        char tag[LOG_TAP_TAG_MAX];
+        esp_log_level_t level;
+    } rules[LOG_TAP_MAX_RULES];
+} tap_filter_t;
+
+/**
+ * @brief Celda del anillo
+ */
+typedef struct {
+    atomic_uint seq;                ///< Turno + 1 con la línea completa; 0 en escritura
+    uint8_t level;                  ///< esp_log_level_t de la línea
+    uint8_t tag_off;                ///< Posición de la etiqueta en `text`
+    uint8_t tag_len;                ///< Largo de la etiqueta (0 si no se reconoció)
+    uint8_t len;                    ///< Largo de `text` con el '\n' final
+    char text[LOG_TAP_LINE_MAX];
+} tap_slot_t;
+
+MEM_BUDGET_STATIC_ASSERT(LOG_TAP, PSRAM, CONFIG_LOG_TAP_LINES * sizeof(tap_slot_t));
+
+struct log_tap_client {
+    bool used;
+    uint32_t next;                  ///< Próximo turno a leer
+    uint32_t dropped;               ///< Descartadas aún no avisadas al cliente
+    tap_filter_t filter;
+};
+
+static tap_slot_t *s_slots = NULL;
+static uint32_t s_capacity = 0;
+static uint32_t s_index_mask = 0;
+static atomic_uint s_head;                  ///< Turnos entregados (líneas capturadas)
+static atomic_uint s_dropped;
+static atomic_uint s_client_count;
+static struct log_tap_client s_clients[LOG_TAP_MAX_CLIENTS];
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static vprintf_like_t s_uart_vprintf = NULL;
+
+// ───────────────────────────────────────────────────────
+// Captura
+
+static esp_log_level_t level_from_char(char c)
+{
+    switch (c) {
+    case 'E': return ESP_LOG_ERROR;
+    case 'W': return ESP_LOG_WARN;
+    case 'I': return ESP_LOG_INFO;
+    case 'D': return ESP_LOG_DEBUG;
+    case 'V': return ESP_LOG_VERBOSE;
+    case 'N': return ESP_LOG_NONE;
+    default:  return (esp_log_level_t)-1;
+    }
+}
+
+/**
+ * @brief Copia `src` sin las secuencias de color ANSI; garantiza el '\n' final
+ */
+static size_t strip_colors(char *dst, const char *src, size_t size)
+{
+    size_t n = 0;
+    for (const char *p = src; *p && n < size - 1; p++) {
+        if (p[0] == '\033' && p[1] == '[') {
+            p += 2;
+            while (*p && *p != 'm') {
+                p++;
+            }
+            if (!*p) {
+                break;
+            }
+            continue;
+        }
+        dst[n++] = *p;
+    }
+    if (n == 0 || dst[n - 1] != '\n') {
+        if (n == size - 1) {
+            n--;        // Línea truncada: se cambia el último carácter por el salto
+        }
+        dst[n++] = '\n';
+    }
+    return n;
+}
+
+/**
+ * @brief Reconoce "L (marca) ETIQUETA: mensaje" y guarda nivel y etiqueta en la celda
+ */
+static void parse_prefix(tap_slot_t *slot)
+{
+    const esp_log_level_t level = level_from_char(slot->text[0]);
+    slot->level = level == (esp_log_level_t)-1 ? ESP_LOG_INFO : level;
+    slot->tag_len = 0;
+    if (level == (esp_log_level_t)-1 || slot->text[1] != ' ' || slot->text[2] != '(') {
+        return;
+    }
+    const char *close = memchr(slot->text, ')', slot->len);
+    if (close == NULL || close[1] != ' ') {
+        return;
+    }
+    const char *tag = close + 2;
+    const char *end = tag;
+    while (end < slot->text + slot->len && *end != ':') {
+        end++;
+    }
+    if (end < slot->text + slot->len && end - tag <= UINT8_MAX) {
+        slot->tag_off = (uint8_t)(tag - slot->text);
+        slot->tag_len = (uint8_t)(end - tag);
+    }
+}
+
+static esp_log_level_t capture(const char *raw)
+{
+    const uint32_t ticket = atomic_fetch_add_explicit(&s_head, 1, memory_order_relaxed);
+    tap_slot_t *slot = &s_slots[ticket & s_index_mask];
+    atomic_store_explicit(&slot->seq, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    slot->len = (uint8_t)strip_colors(slot->text, raw, sizeof(slot->text));
+    parse_prefix(slot);
+    const esp_log_level_t level = slot->level;
+
+    atomic_store_explicit(&slot->seq, ticket + 1, memory_order_release);
+    return level;
+}
+
+static int tap_vprintf(const char *fmt, va_list args)
+{
+    char raw[LOG_TAP_LINE_MAX];
+    va_list copy;
+    va_copy(copy, args);
+    const int len = vsnprintf(raw, sizeof(raw), fmt, copy);
+    va_end(copy);
+
+    esp_log_level_t level = ESP_LOG_INFO;
+    if (len > 0) {
+        level = capture(raw);
+    }
+#if CONFIG_LOG_TAP_UART_IDLE_WARN
+    if (level > ESP_LOG_WARN && atomic_load_explicit(&s_client_count, memory_order_relaxed) == 0) {
+        return len;
+    }
+#endif
+    return s_uart_vprintf(fmt, args);
+}
+
+// ───────────────────────────────────────────────────────
+// Filtros
+
+static bool parse_filter(const char *spec, tap_filter_t *out)
+{
+    tap_filter_t f = { .def = ESP_LOG_INFO };
+    if (spec == NULL) {
+        *out = f;
+        return true;
+    }
+    const char *p = spec;
+    while (*p) {
+        const char *colon = strchr(p, ':');
+        if (colon == NULL || colon == p) {
+            return false;
+        }
+        const esp_log_level_t level = level_from_char(colon[1]);
+        if (level == (esp_log_level_t)-1 || (colon[2] != ',' && colon[2] != '\0')) {
+            return false;
+        }
+        const size_t tag_len = (size_t)(colon - p);
+        if (tag_len == 1 && *p == '*') {
+            f.def = level;
+        } else if (tag_len < LOG_TAP_TAG_MAX && f.count < LOG_TAP_MAX_RULES) {
+            memcpy(f.rules[f.count].tag, p, tag_len);
+            f.rules[f.count].tag[tag_len] = '\0';
+            f.rules[f.count].level = level;
+            f.count++;
+        } else {
+            return false;
+        }
+        p = colon[2] ? colon + 3 : colon + 2;
+    }
+    *out = f;
+    return true;
+}
+
+static bool filter_pass(const tap_filter_t *f, esp_log_level_t level, const char *tag, size_t tag_len)
+{
+    esp_log_level_t limit = f->def;
+    for (uint8_t i = 0; i < f->count; i++) {
+        if (strlen(f->rules[i].tag) == tag_len && memcmp(f->rules[i].tag, tag, tag_len) == 0) {
+            limit = f->rules[i].level;
+            break;
+        }
+    }
+    return level <= limit && limit != ESP_LOG_NONE;
+}
+
+// ───────────────────────────────────────────────────────
+// Métricas
+
+static void log_tap_metrics(metrics_writer_t *w, void *ctx)
+{
+    (void)ctx;
+    log_tap_stats_t st;
+    log_tap_get_stats(&st);
+    metrics_write_uint(w, "log_tap_lines_total", NULL, st.lines);
+    metrics_write_uint(w, "log_tap_dropped_total", NULL, st.dropped);
+    metrics_write_uint(w, "log_tap_capacity", NULL, st.capacity);
+    metrics_write_uint(w, "log_tap_clients", NULL, st.clients);
+}
+
+// ───────────────────────────────────────────────────────
+// API pública
+
+esp_err_t log_tap_init(void)
+{
+    if (s_slots) {
+        return ESP_OK;
+    }
+    uint32_t capacity = 1;
+    while (capacity * 2 <= CONFIG_LOG_TAP_LINES) {
+        capacity *= 2;
+    }
+    esp_err_t ret = mem_budget_claim(MEM_MOD_LOG_TAP, MEM_REGION_PSRAM, capacity * sizeof(tap_slot_t));
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    s_slots = heap_caps_calloc(capacity, sizeof(tap_slot_t), MALLOC_CAP_SPIRAM);
+    if (s_slots == NULL) {
+        ESP_LOGE(TAG, "Sin PSRAM para %lu líneas", (unsigned long)capacity);
+        mem_budget_release(MEM_MOD_LOG_TAP, MEM_REGION_PSRAM, capacity * sizeof(tap_slot_t));
+        return ESP_ERR_NO_MEM;
+    }
+    s_index_mask = capacity - 1;
+    s_capacity = capacity;
+    metrics_register("logtap", log_tap_metrics, NULL);
+
+    s_uart_vprintf = esp_log_set_vprintf(tap_vprintf);
+    ESP_LOGI(TAG, "Anillo de %lu líneas; UART solo con avisos sin clientes: %s", (unsigned long)capacity,
+             CONFIG_LOG_TAP_UART_IDLE_WARN ? "sí" : "no");
+    return ESP_OK;
+}
+
+esp_err_t log_tap_client_open(const char *filter, log_tap_client_t *out)
+{
+    if (out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_slots == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    tap_filter_t f;
+    if (!parse_filter(filter, &f)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    struct log_tap_client *c = NULL;
+    portENTER_CRITICAL(&s_lock);
+    for (int i = 0; i < LOG_TAP_MAX_CLIENTS; i++) {
+        if (!s_clients[i].used) {
+            c = &s_clients[i];
+            c->used = true;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&s_lock);
+    if (c == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    const uint32_t head = atomic_load(&s_head);
+    c->next = head > s_capacity ? head - s_capacity : 0;
+    c->dropped = 0;
+    c->filter = f;
+    atomic_fetch_add(&s_client_count, 1);
+    *out = c;
+    return ESP_OK;
+}
+
+esp_err_t log_tap_client_set_filter(log_tap_client_t client, const char *filter)
+{
+    tap_filter_t f;
+    if (client == NULL || !parse_filter(filter, &f)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    client->filter = f;
+    return ESP_OK;
+}
+
+void log_tap_client_close(log_tap_client_t client)
+{
+    if (client == NULL || !client->used) {
+        return;
+    }
+    atomic_fetch_sub(&s_client_count, 1);
+    portENTER_CRITICAL(&s_lock);
+    client->used = false;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+static void count_dropped(log_tap_client_t c, uint32_t n)
+{
+    c->dropped += n;
+    atomic_fetch_add(&s_dropped, n);
+}
+
+size_t log_tap_read(log_tap_client_t c, char *buf, size_t size)
+{
+    if (c == NULL || buf == NULL || size < LOG_TAP_LINE_MAX || s_slots == NULL) {
+        return 0;
+    }
+    const uint32_t head = atomic_load(&s_head);
+    if (head - c->next > s_capacity) {
+        // El anillo dio la vuelta sobre el cursor
+        count_dropped(c, head - s_capacity - c->next);
+        c->next = head - s_capacity;
+    }
+
+    size_t used = 0;
+    char line[LOG_TAP_LINE_MAX];
+    while (c->next != head && size - used >= LOG_TAP_LINE_MAX) {
+        if (c->dropped) {
+            used += snprintf(buf + used, size - used, "-- %lu líneas descartadas --\n", (unsigned long)c->dropped);
+            c->dropped = 0;
+            continue;
+        }
+        const tap_slot_t *slot = &s_slots[c->next & s_index_mask];
+        const uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        const uint32_t want = c->next + 1;
+        if (seq != want) {
+            if (seq != 0 && (int32_t)(seq - want) > 0) {
+                count_dropped(c, 1);      // Pisada por una línea más nueva
+                c->next++;
+                continue;
+            }
+            break;                          // Aún en escritura
+        }
+
+        const uint8_t len = slot->len;
+        const uint8_t level = slot->level;
+        const uint8_t tag_off = slot->tag_off;
+        const uint8_t tag_len = slot->tag_len;
+        memcpy(line, slot->text, len);
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&slot->seq, memory_order_relaxed) != seq) {
+            count_dropped(c, 1);          // Se pisó mientras se copiaba
+            c->next++;
+            continue;
+        }
+        c->next++;
+
+        if (filter_pass(&c->filter, (esp_log_level_t)level, line + tag_off, tag_len)) {
+            memcpy(buf + used, line, len);
+            used += len;
+        }
+    }
+    return used;
+}
+
+void log_tap_get_stats(log_tap_stats_t *out)
+{
+    if (out == NULL) {
+        return;
+    }
+    out->lines = atomic_load(&s_head);
+    out->dropped = atomic_load(&s_dropped);
+    out->capacity = s_capacity;
+    out->clients = atomic_load(&s_client_count);
+}
+
+#else
+
+esp_err_t log_tap_init(void)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t log_tap_client_open(const char *filter, log_tap_client_t *out)
+{
+    (void)filter;
+    (void)out;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t log_tap_client_set_filter(log_tap_client_t client, const char *filter)
+{
+    (void)client;
+    (void)filter;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void log_tap_client_close(log_tap_client_t client)
+{
+    (void)client;
+}
+
+size_t log_tap_read(log_tap_client_t client, char *buf, size_t size)
+{
+    (void)client;
+    (void)buf;
+    (void)size;
+    return 0;
+}
+
+void log_tap_get_stats(log_tap_stats_t *out)
+{
+    if (out) {
+        memset(out, 0, sizeof(*out));
+    }
+}
+
+#endif // CONFIG_LOG_TAP_ENABLE
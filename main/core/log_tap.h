@@ -0,0 +1,100 @@
+/**
+ * @file log_tap.h
+ * @brief Derivación remota del log: copia las líneas de ESP_LOG a un anillo para clientes de red.
+ * @details log_tap_init() instala un vprintf propio con esp_log_set_vprintf(). Cada línea se
+ *          formatea, se le quitan los códigos de color y se guarda en un anillo de celdas con
+ *          número de secuencia en PSRAM, sin locks: quien escribe nunca espera a un lector.
+ *          Con el anillo lleno se pisan las líneas más viejas; un cliente que se queda atrás
+ *          las recibe resumidas en una línea "-- N líneas descartadas --" y el total se
+ *          cuenta en las métricas "logtap".
+ *
+ *          Los clientes (WebSocket o HTTP chunked, ver ws_server.h) leen con su propio cursor
+ *          y filtro de niveles por etiqueta. Sin clientes, el eco por UART se limita a avisos
+ *          y errores (CONFIG_LOG_TAP_UART_IDLE_WARN); el eco conserva el comportamiento del
+ *          vprintf original. No se capturan las salidas de printf().
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#ifndef LOG_TAP_H
+#define LOG_TAP_H
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LOG_TAP_LINE_MAX        160     ///< Largo máximo de una línea guardada (se trunca)
+#define LOG_TAP_TAG_MAX         16      ///< Largo máximo de una etiqueta en los filtros
+#define LOG_TAP_MAX_CLIENTS     4       ///< Clientes leyendo simultáneamente
+#define LOG_TAP_MAX_RULES       8       ///< Reglas por etiqueta en un filtro
+
+/**
+ * @brief Identificador de un cliente
+ */
+typedef struct log_tap_client *log_tap_client_t;
+
+/**
+ * @brief Estadísticas del anillo
+ */
+typedef struct {
+    uint32_t lines;             ///< Líneas capturadas
+    uint32_t dropped;           ///< Líneas pisadas antes de que un cliente las leyera
+    uint32_t capacity;          ///< Líneas que caben en el anillo
+    uint32_t clients;           ///< Clientes abiertos
+} log_tap_stats_t;
+
+/**
+ * @brief Reserva el anillo, instala el vprintf y registra las métricas "logtap"
+ * @return ESP_OK, ESP_ERR_NO_MEM, o ESP_ERR_NOT_SUPPORTED sin CONFIG_LOG_TAP_ENABLE
+ */
+esp_err_t log_tap_init(void);
+
+/**
+ * @brief Abre un cliente que empieza por las líneas que aún están en el anillo
+ * @param filter Filtro (ver log_tap_client_set_filter()); NULL deja pasar todo hasta INFO
+ * @param[out] out Identificador
+ * @return ESP_OK, ESP_ERR_INVALID_ARG (filtro mal formado), ESP_ERR_NO_MEM (sin lugar)
+ *         o ESP_ERR_INVALID_STATE (sin anillo)
+ */
+esp_err_t log_tap_client_open(const char *filter, log_tap_client_t *out);
+
+/**
+ * @brief Cambia el filtro de un cliente
+ * @details Lista separada por comas de `etiqueta:nivel`, con `*` como nivel por defecto y
+ *          niveles E, W, I, D, V o N (ninguno), p. ej. `*:W,PID:D,MODBUS:I`.
+ * @return ESP_OK o ESP_ERR_INVALID_ARG (el filtro anterior se conserva)
+ */
+esp_err_t log_tap_client_set_filter(log_tap_client_t client, const char *filter);
+
+/**
+ * @brief Cierra un cliente
+ */
+void log_tap_client_close(log_tap_client_t client);
+
+/**
+ * @brief Copia las líneas nuevas que pasan el filtro del cliente
+ * @details Solo copia líneas completas, cada una terminada en '\n', y avanza el cursor del
+ *          cliente. No bloquea; una sola tarea debe leer cada cliente.
+ * @param client Cliente
+ * @param buf Destino
+ * @param size Capacidad de `buf` (al menos LOG_TAP_LINE_MAX)
+ * @return Bytes copiados; 0 si no hay líneas nuevas
+ */
+size_t log_tap_read(log_tap_client_t client, char *buf, size_t size);
+
+/**
+ * @brief Obtiene las estadísticas del anillo
+ */
+void log_tap_get_stats(log_tap_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOG_TAP_H
@@ -13,10 +13,13 @@
  */
 
 #include "waveshare_rgb_lcd_port.h"
+#include "display_power.h"
 #include "ui.h"
 #include "sensor.h"
 #include "esp_log.h"
 #include "wifi_manager.h"
+#include "wifi_scan.h"
+#include "ui_queue.h"
 #include "DEV_Config.h"
 #include "CH422G.h"
 #include "pid_controller.h"
@@ -25,6 +28,19 @@
 
 #include "update.h"
 #include "system_time.h"
+#include "boot.h"
+#include "scheduler.h"
+#include "event_bus.h"
+#include "profiler.h"
+#include "deadline.h"
+#include "tracer.h"
+#include "log_tap.h"
+#include "config_store.h"
+#include "serial_console.h"
+#include "mem_budget.h"
+#include "alloc_prof.h"
+#include "ws_server.h"
+#include "nvs_flash.h"
 #include <string.h>
 #include <time.h>
 #include "lvgl.h"
@@ -34,76 +50,240 @@
 #define TAG "main" ///< Etiqueta de log para este módulo
 #endif
 
+#define BOOT_SNTP_WAIT_MS   30000   ///< Espera máxima de conexión WiFi antes de sincronizar la hora
+#define SCHED_REPORT_MS     60000   ///< Informe del planificador con el sistema ya estable
+
+/**
+ * @brief Identificadores de las etapas de arranque (índices de `boot_stages`)
+ */
+enum {
+    STAGE_NVS = 0,
+    STAGE_I2C,
+    STAGE_DISPLAY,
+    STAGE_UI,
+    STAGE_SENSOR,
+    STAGE_CONTROL,
+    STAGE_TIME,
+    STAGE_WIFI,
+    STAGE_STATISTICS,
+    STAGE_SCAN,
+    STAGE_SNTP,
+    STAGE_COUNT
+};
+
+static esp_err_t stage_nvs(void)
+{
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        ESP_ERROR_CHECK(nvs_flash_erase());
+        ret = nvs_flash_init();
+    }
+    if (ret == ESP_OK) {
+        // Una sola lectura de NVS para toda la configuración (config_store.h)
+        ret = cfg_init();
+    }
+    return ret;
+}
+
+static esp_err_t stage_i2c(void)
+{
+    DEV_Module_Init();  // Inicializa I2C y el CH422G
+    return ESP_OK;
+}
+
+static esp_err_t stage_display(void)
+{
+    // Inicializa pantalla RGB y mutex de LVGL
+    esp_err_t ret = waveshare_esp32_s3_rgb_lcd_init();
+    if (ret == ESP_OK) {
+        ret = waveshare_rgb_lcd_bl_on();
+    }
+    return ret;
+}
+
+static esp_err_t stage_ui(void)
+{
+    /* Se realiza dentro de un bloque protegido por mutex para evitar
+     * conflictos con otras tareas que acceden a LVGL
+     */
+    if (!lvgl_port_lock(-1)) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    // Carga interfaz gráfica
+    ui_init();
+
+    // Trabajos de UI pedidos desde tareas de fondo
+    if (ui_queue_init() != ESP_OK) {
+        ESP_LOGE(TAG, "Error al inicializar la cola de UI");
+    } else if (ui_events_init() != ESP_OK) {
+        ESP_LOGE(TAG, "Error al suscribir la UI al bus de eventos");
+    }
+
+    // Atenuar/apagar la pantalla tras un tiempo sin toques
+    if (display_power_init(NULL) != ESP_OK) {
+        ESP_LOGE(TAG, "Error al inicializar la política de energía de la pantalla");
+    }
+
+    // Inicializar el módulo de gestión de barra de estado
+    statusbar_config_t statusbar_config = statusbar_get_default_config();
+    statusbar_config.time_format = "%d %b %Y   |   %H:%M";
+    statusbar_config.time_update_interval_ms = 60000;  // 1 minuto
+
+    if (!statusbar_manager_init(ui_STATUSBAR, &statusbar_config)) {
+        ESP_LOGE(TAG, "Error al inicializar el módulo de barra de estado");
+    } else {
+        ESP_LOGI(TAG, "Módulo de barra de estado inicializado correctamente");
+    }
+
+    lvgl_port_unlock();
+    return ESP_OK;
+}
+
+static esp_err_t stage_sensor(void)
+{
+    start_temperature_task();
+    return ESP_OK;
+}
+
+static esp_err_t stage_control(void)
+{
+    pid_controller_init(0.0f);
+    return ESP_OK;
+}
+
+static esp_err_t stage_time(void)
+{
+    // Solo NVS y RTC: la configuración de SNTP (lwIP) espera a stage_sntp, tras WiFi
+    system_time_init();
+    return ESP_OK;
+}
+
+/**
+ * @brief Muestra el icono WiFi de la barra de estado solo mientras hay conexión
+ */
+static void on_wifi_state(void *arg, esp_event_base_t base, int32_t state, void *data)
+{
+    if (lvgl_port_lock(-1)) {
+        statusbar_set_icon_visible(STATUSBAR_ICON_WIFI, state == WIFI_MANAGER_STATE_CONNECTED);
+        lvgl_port_unlock();
+    }
+}
+
+static esp_err_t stage_wifi(void)
+{
+    // El servidor WebSocket arranca solo al recibir la primera conexión por el bus
+    if (ws_server_init() != ESP_OK) {
+        ESP_LOGE(TAG, "Error al suscribir el servidor WebSocket al bus de eventos");
+    }
+    esp_err_t ret = wifi_manager_init();
+    if (ret == ESP_OK) {
+        ret = esp_event_handler_register(WIFI_MANAGER_EVENT, ESP_EVENT_ANY_ID, on_wifi_state, NULL);
+    }
+    return ret;
+}
+
+static esp_err_t stage_statistics(void)
+{
+    return statistics_init();
+}
+
+static esp_err_t stage_scan(void)
+{
+    esp_err_t ret = wifi_scan_init();
+    if (ret == ESP_OK) {
+        wifi_scan_bind_dropdown(ui_Dropdown1);
+        ret = wifi_scan_start();
+    }
+    return ret;
+}
+
+static esp_err_t stage_sntp(void)
+{
+    // SNTP reintenta por su cuenta; esperar la conexión solo evita consultas inútiles
+    if (!wifi_manager_wait_connected(BOOT_SNTP_WAIT_MS)) {
+        ESP_LOGW(TAG, "Sin conexión WiFi aún; SNTP sincronizará al conectar");
+    }
+    system_time_update_from_network();
+    return ESP_OK;
+}
+
+/**
+ * @brief Etapas de arranque
+ *
+ * Las de primer plano dejan la pantalla y el lazo de control en marcha lo antes posible;
+ * WiFi, escaneo, estadísticas y SNTP continúan en segundo plano.
+ */
+static const boot_stage_t boot_stages[STAGE_COUNT] = {
+    [STAGE_NVS]        = { "nvs",        stage_nvs,        0,                                      false },
+    [STAGE_I2C]        = { "i2c",        stage_i2c,        0,                                      false },
+    [STAGE_DISPLAY]    = { "display",    stage_display,    BOOT_DEP(STAGE_I2C),                    false },
+    [STAGE_UI]         = { "ui",         stage_ui,         BOOT_DEP(STAGE_DISPLAY),                false },
+    [STAGE_SENSOR]     = { "sensor",     stage_sensor,     0,                                      false },
+    [STAGE_CONTROL]    = { "control",    stage_control,    BOOT_DEP(STAGE_NVS) | BOOT_DEP(STAGE_I2C), false },
+    [STAGE_TIME]       = { "time",       stage_time,       BOOT_DEP(STAGE_NVS),                    true  },
+    [STAGE_WIFI]       = { "wifi",       stage_wifi,       BOOT_DEP(STAGE_NVS),                    true  },
+    [STAGE_STATISTICS] = { "statistics", stage_statistics, BOOT_DEP(STAGE_NVS),                    true  },
+    [STAGE_SCAN]       = { "scan",       stage_scan,       BOOT_DEP(STAGE_WIFI) | BOOT_DEP(STAGE_UI), true  },
+    [STAGE_SNTP]       = { "sntp",       stage_sntp,       BOOT_DEP(STAGE_WIFI) | BOOT_DEP(STAGE_TIME), true },
+};
+
+/**
+ * @brief Imprime una vez el informe del planificador, el perfil de tareas y heap, los plazos
+ *        y el consumo de la pantalla por modo
+ */
+static void sched_report_job(void *arg)
+{
+    sched_log_report();
+    profiler_log_report();
+    deadline_log_report();
+    display_power_log_report();
+}
+
 /**
  * @brief Función principal del firmware.
  * 
- * Realiza la inicialización de hardware y software:
-
- * - Configura el bus I2C.
- * - Inicializa la pantalla RGB y el backend de LVGL.
- * - Carga la interfaz gráfica exportada desde SquareLine Studio.
- * - Inicia el stack WiFi, sincronización de hora y actualización periódica del reloj.
- * - Inicia tareas de lectura de temperatura por Modbus y el controlador PID.
+ * Ejecuta el arranque por etapas (ver `boot_stages`):
+ * - Primer plano: NVS, bus I2C, pantalla RGB y LVGL, interfaz gráfica, lectura de
+ *   temperatura y controlador PID.
+ * - Segundo plano: stack WiFi, estadísticas, escaneo de redes y sincronización de hora.
  */
 void app_main(void)
 {
-    // ========================================
-    // INICIALIZACIÓN PRINCIPAL
-    // ========================================
-    
+    // Antes de la primera línea: el arranque queda en el anillo para los clientes remotos
+    log_tap_init();
+
     ESP_LOGI(TAG, "=== INICIANDO TRIPTABS HEAT CONTROLLER ===");
     ESP_LOGI(TAG, "Firmware Version: 1.0.0");
     ESP_LOGI(TAG, "ESP32-S3 Vacuum Oven Controller");
     
     // Inicializar módulo de actualización (solo variables, sin verificación de red)
     update_init();
-    
-    DEV_Module_Init();  // Inicializa I2C
-
-    // Inicializa pantalla RGB y mutex de LVGL
-    waveshare_esp32_s3_rgb_lcd_init();
-    waveshare_rgb_lcd_bl_on();
 
-    /* Inicialización de la interfaz gráfica y servicios principales
-     * Se realiza dentro de un bloque protegido por mutex para evitar
-     * conflictos con otras tareas que acceden a LVGL
-     */
-    if (lvgl_port_lock(-1)) {
-        // Carga interfaz gráfica
-        ui_init();
-
-        // Inicializar el módulo de gestión de barra de estado
-        statusbar_config_t statusbar_config = statusbar_get_default_config();
-        statusbar_config.time_format = "%d %b %Y   |   %H:%M";
-        statusbar_config.time_update_interval_ms = 60000;  // 1 minuto
-        
-        if (!statusbar_manager_init(ui_STATUSBAR, &statusbar_config)) {
-            ESP_LOGE(TAG, "Error al inicializar el módulo de barra de estado");
-        } else {
-            ESP_LOGI(TAG, "Módulo de barra de estado inicializado correctamente");
-        }
-
-        // Configura WiFi (sin pasar cui_datetime1 ya que ahora lo maneja statusbar_manager)
-        wifi_manager_init(ui_Dropdown1, NULL);
-        
-        // Inicializar sistema de tiempo DESPUÉS de WiFi
-        system_time_init();
-
-        // Inicia tareas principales
-        start_temperature_task();
-        pid_controller_init(0.0f);
-        
-        // Inicializar módulo de estadísticas
-        if (statistics_init() != ESP_OK) {
-            ESP_LOGE(TAG, "Error al inicializar el módulo de estadísticas");
-        } else {
-            ESP_LOGI(TAG, "Módulo de estadísticas inicializado correctamente");
-        }
+    // Las etapas registran su trabajo periódico en el planificador
+    ESP_ERROR_CHECK(sched_init());
+    evbus_init();
+    // Traza desde el arranque (GET /trace, WebSocket y tools/trace2perfetto.py)
+    tracer_init();
+    sched_add("sched_report", sched_report_job, NULL, SCHED_REPORT_MS, 0, NULL);
 
-        lvgl_port_unlock();
+    if (boot_run(boot_stages, STAGE_COUNT) != ESP_OK) {
+        ESP_LOGE(TAG, "Arranque con errores en etapas de primer plano");
     }
-    
-    ESP_LOGI(TAG, "🎉 Sistema iniciado completamente");
+
+    // CPU por tarea, pila y heap (pantalla Devmode, /metrics e informe)
+    profiler_init();
+
+    // Uso de memoria por módulo frente a su presupuesto (las etapas de segundo plano siguen sumando)
+    mem_budget_report();
+
+    // Rotación del heap en régimen (solo con CONFIG_ALLOC_PROF_ENABLE)
+    alloc_prof_init();
+
+    // REPL "tripta>" en el puerto de consola (serial_console.h)
+    serial_console_init();
+
+    ESP_LOGI(TAG, "🎉 Control en marcha; servicios de red iniciándose en segundo plano");
 
     // Nota: no se necesita un bucle explícito; LVGL corre en background.
 }
@@ -0,0 +1,171 @@
+/**
+ * @file mem_budget.c
+ * @brief Implementación de los presupuestos de memoria.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#include "mem_budget.h"
+#include "metrics.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_heap_caps.h"
+#include "esp_system.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "MEM";
+
+/**
+ * @brief Fila constante de la tabla de presupuestos
+ */
+typedef struct {
+    const char *name;
+    const char *subsystem;
+    uint32_t budget[MEM_REGION_COUNT];
+} mem_budget_def_t;
+
+static const mem_budget_def_t s_defs[MEM_MOD_COUNT] = {
+#define MEM_BUDGET_DEF(id, sub, internal, psram) \
+    [MEM_MOD_##id] = { #id, sub, { (internal), (psram) } },
+    MEM_BUDGET_TABLE(MEM_BUDGET_DEF)
+#undef MEM_BUDGET_DEF
+};
+
+static const char *const s_region_names[MEM_REGION_COUNT] = { "internal", "psram" };
+
+static uint32_t s_used[MEM_MOD_COUNT][MEM_REGION_COUNT];
+static uint32_t s_exceeded = 0;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static bool s_metrics_registered = false;
+
+static void mem_budget_metrics(metrics_writer_t *w, void *ctx)
+{
+    (void)ctx;
+    char labels[48];
+    for (int m = 0; m < MEM_MOD_COUNT; m++) {
+        mem_budget_entry_t e;
+        mem_budget_get((mem_module_t)m, &e);
+        for (int r = 0; r < MEM_REGION_COUNT; r++) {
+            snprintf(labels, sizeof(labels), "module=\"%s\",region=\"%s\"", e.name, s_region_names[r]);
+            metrics_write_uint(w, "mem_budget_used_bytes", labels, e.used[r]);
+            metrics_write_uint(w, "mem_budget_limit_bytes", labels, e.budget[r]);
+        }
+    }
+    metrics_write_uint(w, "mem_budget_exceeded_total", NULL, s_exceeded);
+}
+
+esp_err_t mem_budget_claim(mem_module_t module, mem_region_t region, size_t bytes)
+{
+    if (module >= MEM_MOD_COUNT || region >= MEM_REGION_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const uint32_t budget = s_defs[module].budget[region];
+    portENTER_CRITICAL(&s_lock);
+    const uint32_t used = s_used[module][region] + bytes;
+    const bool over = used > budget;
+    if (over) {
+        s_exceeded++;
+    } else {
+        s_used[module][region] = used;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    if (!over) {
+        return ESP_OK;
+    }
+
+    ESP_LOGE(TAG, "Presupuesto %s de %s excedido: %lu de %lu bytes (ajustar mem_budget.h)",
+             s_region_names[region], s_defs[module].name, (unsigned long)used, (unsigned long)budget);
+#if CONFIG_MEM_BUDGET_ABORT
+    static char reason[64];
+    snprintf(reason, sizeof(reason), "mem budget %s/%s: %lu > %lu", s_defs[module].name,
+             s_region_names[region], (unsigned long)used, (unsigned long)budget);
+    esp_system_abort(reason);
+#endif
+    return ESP_ERR_NO_MEM;
+}
+
+void mem_budget_release(mem_module_t module, mem_region_t region, size_t bytes)
+{
+    if (module >= MEM_MOD_COUNT || region >= MEM_REGION_COUNT) {
+        return;
+    }
+    portENTER_CRITICAL(&s_lock);
+    s_used[module][region] -= bytes < s_used[module][region] ? bytes : s_used[module][region];
+    portEXIT_CRITICAL(&s_lock);
+}
+
+bool mem_budget_get(mem_module_t module, mem_budget_entry_t *out)
+{
+    if (module >= MEM_MOD_COUNT || out == NULL) {
+        return false;
+    }
+    out->name = s_defs[module].name;
+    out->subsystem = s_defs[module].subsystem;
+    portENTER_CRITICAL(&s_lock);
+    for (int r = 0; r < MEM_REGION_COUNT; r++) {
+        out->used[r] = s_used[module][r];
+        out->budget[r] = s_defs[module].budget[r];
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return true;
+}
+
+void mem_budget_report(void)
+{
+    ESP_LOGI(TAG, "%-9s %-8s %19s %21s", "Módulo", "Subsist.", "Interna usada/pres.", "PSRAM usada/pres.");
+    for (int m = 0; m < MEM_MOD_COUNT; m++) {
+        mem_budget_entry_t e;
+        mem_budget_get((mem_module_t)m, &e);
+        ESP_LOGI(TAG, "%-9s %-8s %9lu/%-9lu %10lu/%-10lu", e.name, e.subsystem,
+                 (unsigned long)e.used[MEM_REGION_INTERNAL], (unsigned long)e.budget[MEM_REGION_INTERNAL],
+                 (unsigned long)e.used[MEM_REGION_PSRAM], (unsigned long)e.budget[MEM_REGION_PSRAM]);
+    }
+
+    // Totales por subsistema, en el orden en que aparece cada uno en la tabla
+    for (int m = 0; m < MEM_MOD_COUNT; m++) {
+        bool seen = false;
+        for (int p = 0; p < m && !seen; p++) {
+            seen = strcmp(s_defs[p].subsystem, s_defs[m].subsystem) == 0;
+        }
+        if (seen) {
+            continue;
+        }
+        uint32_t used[MEM_REGION_COUNT] = { 0 };
+        uint32_t budget[MEM_REGION_COUNT] = { 0 };
+        for (int s = m; s < MEM_MOD_COUNT; s++) {
+            if (strcmp(s_defs[s].subsystem, s_defs[m].subsystem) != 0) {
+                continue;
+            }
+            mem_budget_entry_t e;
+            mem_budget_get((mem_module_t)s, &e);
+            for (int r = 0; r < MEM_REGION_COUNT; r++) {
+                used[r] += e.used[r];
+                budget[r] += e.budget[r];
+            }
+        }
+        ESP_LOGI(TAG, "Subsistema %-8s interna %lu/%lu, PSRAM %lu/%lu", s_defs[m].subsystem,
+                 (unsigned long)used[MEM_REGION_INTERNAL], (unsigned long)budget[MEM_REGION_INTERNAL],
+                 (unsigned long)used[MEM_REGION_PSRAM], (unsigned long)budget[MEM_REGION_PSRAM]);
+    }
+
+    ESP_LOGI(TAG, "Heap interno: libre %u, mínimo %u, bloque mayor %u",
+             (unsigned)heap_caps_get_free_size(MALLOC_CAP_INTERNAL),
+             (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL),
+             (unsigned)heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL));
+    ESP_LOGI(TAG, "PSRAM: libre %u, mínimo %u, bloque mayor %u",
+             (unsigned)heap_caps_get_free_size(MALLOC_CAP_SPIRAM),
+             (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_SPIRAM),
+             (unsigned)heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM));
+    if (s_exceeded) {
+        ESP_LOGE(TAG, "%lu reservas rechazadas por exceder su presupuesto", (unsigned long)s_exceeded);
+    }
+
+    if (!s_metrics_registered) {
+        s_metrics_registered = true;
+        metrics_register("mem", mem_budget_metrics, NULL);
+    }
+}
@@ -0,0 +1,135 @@
+/**
+ * @file mem_budget.h
+ * @brief Presupuestos de memoria por módulo e informe de uso interno/PSRAM.
+ * @details Las tareas, colas y búferes de vida larga se reservan de forma estática en cada
+ *          módulo; sus tamaños y el presupuesto de cada módulo se declaran aquí, en un solo
+ *          lugar. Hay dos controles:
+ *          - al compilar, MEM_BUDGET_STATIC_ASSERT() compara la reserva estática del módulo
+ *            (o la máxima que permite su Kconfig) con su presupuesto y detiene la compilación;
+ *          - al arrancar, cada módulo declara lo que reservó con mem_budget_claim(). Si una
+ *            reserva supera el presupuesto se registra el módulo, la región y los bytes, y con
+ *            CONFIG_MEM_BUDGET_ABORT el firmware se detiene en ese momento.
+ *
+ *          mem_budget_report() deja en el log la tabla por módulo y por subsistema junto al
+ *          estado del heap, y publica las métricas "mem".
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#ifndef MEM_BUDGET_H
+#define MEM_BUDGET_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ───────────────────────────────────────────────────────
+// Pilas de las tareas propias (bytes; en ESP-IDF la profundidad se da en bytes)
+
+#define MEM_STACK_PID       4096    ///< Lazo PID y órdenes de la cola de control
+#define MEM_STACK_SCHED     4096    ///< Sensor Modbus, envío WebSocket y escrituras NVS
+#define MEM_STACK_BOOT      6144    ///< Wi-Fi, escaneo y SNTP (tarea transitoria, en el heap)
+#define MEM_STACK_I2C_BUS   4096    ///< Ejecuta la lectura del GT911
+
+/**
+ * @brief Tabla de presupuestos: X(módulo, subsistema, bytes internos, bytes de PSRAM)
+ * @details Los presupuestos internos cubren pila, TCB, colas y semáforos estáticos más las
+ *          reservas de heap declaradas; los de PSRAM, los anillos y búferes grandes.
+ */
+#define MEM_BUDGET_TABLE(X)                                         \
+    X(PID,      "control",  6 * 1024,   0)                          \
+    X(SCHED,    "core",     5 * 1024,   0)                          \
+    X(BOOT,     "core",     256,        0)                          \
+    X(CFG,      "core",     256,        0)                          \
+    X(EVBUS,    "core",     4 * 1024,   0)                          \
+    X(I2C_BUS,  "io",       6 * 1024,   0)                          \
+    X(LVGL,     "ui",       7 * 1024,   4 * 1024 * 1024)            \
+    X(UI_QUEUE, "ui",       512,        0)                          \
+    X(WIFI,     "net",      256,        0)                          \
+    X(TRACER,   "diag",     0,          256 * 1024)                 \
+    X(LOG_TAP,  "diag",     0,          64 * 1024)
+
+/**
+ * @brief Módulos con presupuesto
+ */
+typedef enum {
+#define MEM_BUDGET_ENUM(id, sub, internal, psram) MEM_MOD_##id,
+    MEM_BUDGET_TABLE(MEM_BUDGET_ENUM)
+#undef MEM_BUDGET_ENUM
+    MEM_MOD_COUNT
+} mem_module_t;
+
+/**
+ * @brief Presupuestos como constantes de compilación (para MEM_BUDGET_STATIC_ASSERT)
+ */
+enum {
+#define MEM_BUDGET_LIMITS(id, sub, internal, psram) \
+    MEM_BUDGET_INTERNAL_##id = (internal), MEM_BUDGET_PSRAM_##id = (psram),
+    MEM_BUDGET_TABLE(MEM_BUDGET_LIMITS)
+#undef MEM_BUDGET_LIMITS
+};
+
+/**
+ * @brief Detiene la compilación si `bytes` no cabe en el presupuesto de la región
+ * @param id     Módulo de la tabla (sin prefijo), p. ej. PID
+ * @param region INTERNAL o PSRAM
+ */
+#define MEM_BUDGET_STATIC_ASSERT(id, region, bytes)                             \
+    _Static_assert((bytes) <= MEM_BUDGET_##region##_##id,                       \
+                   "presupuesto de memoria " #region " excedido por " #id)
+
+/**
+ * @brief Región de memoria
+ */
+typedef enum {
+    MEM_REGION_INTERNAL = 0,
+    MEM_REGION_PSRAM,
+    MEM_REGION_COUNT
+} mem_region_t;
+
+/**
+ * @brief Uso y presupuesto de un módulo
+ */
+typedef struct {
+    const char *name;                       ///< Nombre del módulo
+    const char *subsystem;                  ///< Subsistema al que se suma en el informe
+    uint32_t used[MEM_REGION_COUNT];        ///< Bytes declarados con mem_budget_claim()
+    uint32_t budget[MEM_REGION_COUNT];      ///< Presupuesto de la tabla
+} mem_budget_entry_t;
+
+/**
+ * @brief Declara una reserva de memoria de vida larga de un módulo
+ * @details Se llama antes de reservar memoria dinámica (si falla, no se reserva) o después
+ *          de crear un objeto estático. Sin CONFIG_MEM_BUDGET_ABORT un exceso solo se
+ *          registra y se devuelve; con él, el firmware se detiene con el detalle en el log.
+ * @return ESP_OK, ESP_ERR_INVALID_ARG o ESP_ERR_NO_MEM si supera el presupuesto
+ */
+esp_err_t mem_budget_claim(mem_module_t module, mem_region_t region, size_t bytes);
+
+/**
+ * @brief Libera una reserva declarada (p. ej. si la inicialización falla después)
+ */
+void mem_budget_release(mem_module_t module, mem_region_t region, size_t bytes);
+
+/**
+ * @brief Copia el uso y el presupuesto de un módulo
+ * @return false si `module` está fuera de rango
+ */
+bool mem_budget_get(mem_module_t module, mem_budget_entry_t *out);
+
+/**
+ * @brief Escribe en el log el informe por módulo y subsistema y registra las métricas "mem"
+ */
+void mem_budget_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MEM_BUDGET_H
@@ -0,0 +1,100 @@
+/**
+ * @file metrics.c
+ * @brief Implementación del registro de métricas de diagnóstico.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#include "metrics.h"
+#include "freertos/FreeRTOS.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief Proveedor registrado
+ */
+typedef struct {
+    const char *name;
+    metrics_provider_fn_t fn;
+    void *ctx;
+} metrics_provider_t;
+
+static metrics_provider_t providers[METRICS_MAX_PROVIDERS];
+static size_t provider_count = 0;
+static portMUX_TYPE providers_lock = portMUX_INITIALIZER_UNLOCKED;
+
+esp_err_t metrics_register(const char *name, metrics_provider_fn_t fn, void *ctx)
+{
+    if (name == NULL || fn == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = ESP_ERR_NO_MEM;
+    portENTER_CRITICAL(&providers_lock);
+    if (provider_count < METRICS_MAX_PROVIDERS) {
+        providers[provider_count].name = name;
+        providers[provider_count].fn = fn;
+        providers[provider_count].ctx = ctx;
+        provider_count++;
+        ret = ESP_OK;
+    }
+    portEXIT_CRITICAL(&providers_lock);
+
+    return ret;
+}
+
+size_t metrics_render(char *buf, size_t size, const char *filter)
+{
+    metrics_writer_t w = { .buf = buf, .size = size, .len = 0 };
+    if (buf && size) {
+        buf[0] = '\0';
+    }
+
+    // Los proveedores solo se agregan, así que basta con leer el contador una vez
+    portENTER_CRITICAL(&providers_lock);
+    const size_t count = provider_count;
+    portEXIT_CRITICAL(&providers_lock);
+
+    for (size_t i = 0; i < count; i++) {
+        if (filter && strcmp(filter, providers[i].name) != 0) {
+            continue;
+        }
+        providers[i].fn(&w, providers[i].ctx);
+    }
+
+    return w.len;
+}
+
+void metrics_printf(metrics_writer_t *w, const char *fmt, ...)
+{
+    const size_t avail = (w->len < w->size) ? w->size - w->len : 0;
+
+    va_list args;
+    va_start(args, fmt);
+    const int n = vsnprintf(avail ? w->buf + w->len : NULL, avail, fmt, args);
+    va_end(args);
+
+    if (n > 0) {
+        w->len += (size_t)n;
+    }
+}
+
+void metrics_write_uint(metrics_writer_t *w, const char *name, const char *labels, uint64_t value)
+{
+    if (labels) {
+        metrics_printf(w, "%s{%s} %llu\n", name, labels, (unsigned long long)value);
+    } else {
+        metrics_printf(w, "%s %llu\n", name, (unsigned long long)value);
+    }
+}
+
+void metrics_write_float(metrics_writer_t *w, const char *name, const char *labels, double value)
+{
+    if (labels) {
+        metrics_printf(w, "%s{%s} %.3f\n", name, labels, value);
+    } else {
+        metrics_printf(w, "%s %.3f\n", name, value);
+    }
+}
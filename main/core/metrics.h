@@ -0,0 +1,87 @@
+/**
+ * @file metrics.h
+ * @brief Registro de métricas de diagnóstico del equipo.
+ * @details Cada módulo registra un proveedor que, al renderizar, escribe sus métricas en
+ *          formato de texto de Prometheus (`nombre{etiquetas} valor`). El registro no
+ *          guarda valores: los proveedores leen sus contadores en el momento de renderizar,
+ *          por lo que mantener las métricas no tiene costo mientras nadie las consulta.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define METRICS_MAX_PROVIDERS   16  ///< Número máximo de proveedores registrados
+
+/**
+ * @brief Destino de escritura de un proveedor
+ */
+typedef struct {
+    char *buf;      ///< Buffer de salida
+    size_t size;    ///< Tamaño del buffer
+    size_t len;     ///< Bytes escritos (puede superar `size` si la salida se truncó)
+} metrics_writer_t;
+
+/**
+ * @brief Función que escribe las métricas de un módulo
+ * @param w Destino de escritura
+ * @param ctx Contexto indicado al registrar el proveedor
+ */
+typedef void (*metrics_provider_fn_t)(metrics_writer_t *w, void *ctx);
+
+/**
+ * @brief Registra un proveedor de métricas
+ * @param name Nombre del proveedor (prefijo de sus métricas, p. ej. "i2c")
+ * @param fn Función que escribe las métricas
+ * @param ctx Contexto pasado a `fn`
+ * @return ESP_OK si se registró, ESP_ERR_NO_MEM si no hay espacio
+ */
+esp_err_t metrics_register(const char *name, metrics_provider_fn_t fn, void *ctx);
+
+/**
+ * @brief Renderiza las métricas en un buffer
+ * @param buf Buffer de salida (se termina siempre en '\0')
+ * @param size Tamaño del buffer
+ * @param filter Nombre del proveedor a renderizar, o NULL para todos
+ * @return Bytes necesarios para la salida completa (sin '\0'); si es >= size, se truncó
+ */
+size_t metrics_render(char *buf, size_t size, const char *filter);
+
+/**
+ * @brief Escribe texto con formato printf
+ */
+void metrics_printf(metrics_writer_t *w, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+/**
+ * @brief Escribe una métrica entera
+ * @param w Destino de escritura
+ * @param name Nombre de la métrica
+ * @param labels Etiquetas sin llaves (p. ej. `addr="0x24"`), o NULL
+ * @param value Valor
+ */
+void metrics_write_uint(metrics_writer_t *w, const char *name, const char *labels, uint64_t value);
+
+/**
+ * @brief Escribe una métrica de punto flotante
+ * @param w Destino de escritura
+ * @param name Nombre de la métrica
+ * @param labels Etiquetas sin llaves, o NULL
+ * @param value Valor
+ */
+void metrics_write_float(metrics_writer_t *w, const char *name, const char *labels, double value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // METRICS_H
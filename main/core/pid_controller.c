@@ -15,78 +15,24 @@
 #include <math.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
 #include "sensor.h"
-#include "nvs_flash.h"
-#include "nvs.h"
 #include "CH422G.h"
-#include "DEV_Config.h"
-#include "ui_events.h"
 #include "pid_controller.h"
-#include "statistics.h"
+#include "event_bus.h"
+#include "deadline.h"
+#include "tracer.h"
+#include "timebase.h"
+#include "scheduler.h"
+#include "metrics.h"
+#include "config_store.h"
+#include "mem_budget.h"
 
 // ───────────────────────────────────────────────────────
-// Estructura de configuración
-
-/**
- * @struct PIDConfig_t
- * @brief Estructura que contiene la configuración del controlador PID
- * 
- * @details Esta estructura almacena todos los parámetros de configuración necesarios
- * para el funcionamiento del controlador PID, incluyendo:
- * - Límites de salida (output_max, output_min)
- * - Tiempo de muestreo (sample_time_ms)
- * - Parámetros de estabilidad (watchdog_rise, stable_threshold, stable_cycles_for_reset)
- * - Parámetros de autotuning (autotune_hysteresis, autotune_relay_high, autotune_relay_low,
- *   autotune_min_cycles, autotune_delay_ms)
- * - Parámetros PID predeterminados (kp_default, ki_default, kd_default)
- */
-typedef struct {
-    float output_max;           ///< Límite máximo de salida del controlador (porcentaje)
-    float output_min;           ///< Límite mínimo de salida del controlador (porcentaje)
-    uint32_t sample_time_ms;    ///< Tiempo entre muestras del controlador en milisegundos
-    float watchdog_rise;        ///< Umbral de subida para el watchdog en grados
-    float stable_threshold;     ///< Umbral de estabilidad en grados
-    uint8_t stable_cycles_for_reset;  ///< Número de ciclos estables necesarios para resetear
-    float autotune_hysteresis;  ///< Histéresis para el autotuning en grados
-    float autotune_relay_high;  ///< Valor alto del relé durante autotuning (porcentaje)
-    float autotune_relay_low;   ///< Valor bajo del relé durante autotuning (porcentaje)
-    uint8_t autotune_min_cycles;///< Número mínimo de ciclos para el autotuning
-    uint32_t autotune_delay_ms; ///< Retardo entre ciclos de autotuning en milisegundos
-    float kp_default;           ///< Ganancia proporcional por defecto
-    float ki_default;           ///< Ganancia integral por defecto
-    float kd_default;           ///< Ganancia derivativa por defecto
-} PIDConfig_t;
-
-/**
- * @brief Configuración global del controlador PID
- * 
- * @details Define los parámetros por defecto para el control PID del horno:
- * - Límites de salida (0-100%)
- * - Tiempo de muestreo (5 segundos)
- * - Umbrales de estabilidad y watchdog
- * - Parámetros de autotuning
- * - Valores PID predeterminados
- * 
- * @note Esta configuración se utiliza como base para el control de temperatura
- * del horno y puede ser modificada según las necesidades específicas.
- */
-static const PIDConfig_t pid_config = {
-    .output_max = 100.0f,           // Límite máximo de salida (100%)
-    .output_min = 0.0f,             // Límite mínimo de salida (0%)
-    .sample_time_ms = 5000,         // Tiempo entre muestras (5 segundos)
-    .watchdog_rise = 2.0f,          // Umbral de subida para watchdog (2°C)
-    .stable_threshold = 0.5f,       // Umbral de estabilidad (0.5°C)
-    .stable_cycles_for_reset = 3,   // Ciclos estables para resetear
-    .autotune_hysteresis = 0.5f,    // Histéresis para autotuning (0.5°C)
-    .autotune_relay_high = 100.0f,  // Valor alto del relé (100%)
-    .autotune_relay_low = 0.0f,     // Valor bajo del relé (0%)
-    .autotune_min_cycles = 5,       // Mínimo de ciclos para autotuning
-    .autotune_delay_ms = 100,       // Retardo entre ciclos (100ms)
-    .kp_default = 1.0f,             // Ganancia proporcional por defecto
-    .ki_default = 0.1f,             // Ganancia integral por defecto
-    .kd_default = 2.0f              // Ganancia derivativa por defecto
-};
-
+// Configuración
+//
+// Límites de salida, periodo de muestreo, parámetros de autotuning y ganancias viven en el
+// almacén de configuración (config_store.h), con sus valores por defecto y rangos.
 
 /**
  * @struct PIDController
@@ -139,32 +85,84 @@ static PIDController pid = {
 
 // Variables de estado
 static float last_temp = 0.0f;
+static volatile uint32_t alarms = 0;    ///< Máscara PID_ALARM_*
+static uint32_t sample_time_ms = 0;     ///< Periodo vigente (PID_CMD_SET_SAMPLE_TIME)
+
+// Cola de órdenes: la tarea de control es la única que escribe `pid`
+#define PID_CMD_QUEUE_LEN   8
+#define PID_TASK_PRIORITY   5       ///< Por debajo del bus I2C y por encima del planificador
+#define PID_CFG_SUBMIT_MS   100     ///< Espera si la cola está llena al aplicar un cambio de configuración
+
+#define PID_TICK_TOLERANCE_US       50000   ///< Atraso admitido de un ciclo de control
+#define PID_TICK_BUDGET_US          20000   ///< Lectura y cálculo de un ciclo
+#define PID_SSR_WINDOW_TOLERANCE_US 10000   ///< Exceso admitido de la ventana encendida del SSR
+
+static deadline_handle_t tick_monitor = NULL;
+static deadline_handle_t ssr_window_monitor = NULL;
+static QueueHandle_t cmd_queue = NULL;
+static TaskHandle_t pid_task_handle = NULL;
+static uint8_t cmd_queue_storage[PID_CMD_QUEUE_LEN * sizeof(pid_cmd_t)];
+static StaticQueue_t cmd_queue_buffer;
+static StackType_t pid_task_stack[MEM_STACK_PID];
+static StaticTask_t pid_task_tcb;
+#define PID_STATIC_BYTES \
+    (sizeof(cmd_queue_storage) + sizeof(cmd_queue_buffer) + sizeof(pid_task_stack) + sizeof(pid_task_tcb))
+MEM_BUDGET_STATIC_ASSERT(PID, INTERNAL, PID_STATIC_BYTES);
+static pid_cmd_stats_t cmd_stats;
+static portMUX_TYPE cmd_stats_lock = portMUX_INITIALIZER_UNLOCKED;
 
 // ───────────────────────────────────────────────────────
 // Control del relé SSR
 
+/**
+ * @brief Publica un flanco del SSR (estadísticas e interfaz lo consumen desde el bus)
+ */
+static void publish_ssr_edge(bool on) {
+    evbus_event_t ev = { .type = EVBUS_SSR_EDGE, .ssr.on = on };
+    evbus_publish(&ev);
+}
+
+/**
+ * @brief Actualiza la alarma de sobretemperatura y publica solo sus transiciones
+ */
+static void set_overtemp_alarm(bool active) {
+    const bool was = (alarms & PID_ALARM_OVERTEMP) != 0;
+    if (active == was) {
+        return;
+    }
+    if (active) {
+        alarms |= PID_ALARM_OVERTEMP;
+    } else {
+        alarms &= ~PID_ALARM_OVERTEMP;
+    }
+    evbus_event_t ev = { .type = EVBUS_FAULT, .fault = { .code = EVBUS_FAULT_OVERTEMP, .active = active } };
+    evbus_publish(&ev);
+}
+
 /**
  * @brief Activa la salida digital DO1 (SSR) mediante el CH422G.
  */
 void activar_ssr(void) {
-    CH422G_EnsurePushPullMode();
-    CH422G_od_output(0x00);
-    pid.ssr_status = true;
-    
-    // Notificar al módulo de estadísticas el cambio de estado
-    statistics_update_ssr_state(true);
+    tracer_mark_begin(TRACER_MARK_SSR_WRITE);
+    CH422G_od_clear_bits(CH422G_OD_OUT_1);
+    tracer_mark_end(TRACER_MARK_SSR_WRITE);
+    if (!pid.ssr_status) {
+        pid.ssr_status = true;
+        publish_ssr_edge(true);
+    }
 }
 
 /**
  * @brief Desactiva la salida digital DO1 (SSR).
  */
 void desactivar_ssr(void) {
-    CH422G_EnsurePushPullMode();
-    CH422G_od_output(0x02);
-    pid.ssr_status = false;
-    
-    // Notificar al módulo de estadísticas el cambio de estado
-    statistics_update_ssr_state(false);
+    tracer_mark_begin(TRACER_MARK_SSR_WRITE);
+    CH422G_od_set_bits(CH422G_OD_OUT_1);
+    tracer_mark_end(TRACER_MARK_SSR_WRITE);
+    if (pid.ssr_status) {
+        pid.ssr_status = false;
+        publish_ssr_edge(false);
+    }
 }
 
 /**
@@ -175,46 +173,254 @@ bool pid_ssr_status(void) {
     return pid.ssr_status;
 }
 
+/**
+ * @brief Obtiene el setpoint actual.
+ */
+float pid_get_setpoint(void) {
+    return pid.setpoint;
+}
+
+/**
+ * @brief Obtiene la última salida del PID (0 si está desactivado).
+ */
+float pid_get_output(void) {
+    return pid.enabled ? pid.output : 0.0f;
+}
+
+/**
+ * @brief Indica si el PID está activo.
+ */
+bool pid_is_enabled(void) {
+    return pid.enabled;
+}
+
+/**
+ * @brief Obtiene la máscara de alarmas activas.
+ */
+uint32_t pid_get_alarms(void) {
+    return alarms;
+}
+
+/**
+ * @brief Obtiene el periodo de control vigente.
+ */
+uint32_t pid_get_sample_time_ms(void) {
+    return sample_time_ms;
+}
+
 // ───────────────────────────────────────────────────────
 // PID interno
 
 /**
- * @brief Calcula el valor de control PID.
+ * @brief Calcula el valor de control PID sobre un estado dado.
  * 
+ * @param s Estado del controlador (la instancia global o una copia de prueba).
  * @param current_temp Temperatura actual.
+ * @param dt Periodo de muestreo en segundos.
  * @return float Salida PID normalizada entre 0–100.
  */
-static float pid_compute(float current_temp) {
-    const float dt = pid_config.sample_time_ms / 1000.0f;
-    const float error = pid.setpoint - current_temp;
+static float pid_compute_state(PIDController *s, float current_temp, float dt) {
+    const float error = s->setpoint - current_temp;
     
     // Cálculo del término integral con anti-windup
-    pid.integral += error * dt;
+    s->integral += error * dt;
     
     // Cálculo del término derivativo
-    const float derivative = (error - pid.previous_error) / dt;
+    const float derivative = (error - s->previous_error) / dt;
     
     // Cálculo de la salida PID
-    float output = pid.kp * error + 
-                  pid.ki * pid.integral + 
-                  pid.kd * derivative;
+    float output = s->kp * error + 
+                  s->ki * s->integral + 
+                  s->kd * derivative;
     
     // Anti-windup y limitación de salida
-    if (output > pid_config.output_max) {
-        output = pid_config.output_max;
-        pid.integral -= error * dt;  // Anti-windup
-    } else if (output < pid_config.output_min) {
-        output = pid_config.output_min;
-        pid.integral -= error * dt;  // Anti-windup
+    const float output_max = cfg_get_float(CFG_PID_OUTPUT_MAX);
+    const float output_min = cfg_get_float(CFG_PID_OUTPUT_MIN);
+    if (output > output_max) {
+        output = output_max;
+        s->integral -= error * dt;  // Anti-windup
+    } else if (output < output_min) {
+        output = output_min;
+        s->integral -= error * dt;  // Anti-windup
     }
     
     // Actualización de estado
-    pid.previous_error = error;
-    pid.output = output;
+    s->previous_error = error;
+    s->output = output;
     
     return output;
 }
 
+/**
+ * @brief Calcula el valor de control PID del lazo.
+ */
+static float pid_compute(float current_temp) {
+    return pid_compute_state(&pid, current_temp, sample_time_ms / 1000.0f);
+}
+
+/**
+ * @brief Ejecuta el cálculo PID sobre una copia del estado (micro-benchmark).
+ */
+float pid_bench_compute(uint32_t iterations) {
+    PIDController s = pid;
+    s.setpoint = 60.0f;
+    s.integral = 0.0f;
+    s.previous_error = 0.0f;
+    const float dt = cfg_get_u32(CFG_PID_SAMPLE_TIME_MS) / 1000.0f;
+    float temp = 25.0f;
+    float acc = 0.0f;
+    for (uint32_t i = 0; i < iterations; i++) {
+        // Temperatura que oscila para recorrer los tres tramos de la saturación
+        temp += (i & 64) ? -0.5f : 0.5f;
+        acc += pid_compute_state(&s, temp, dt);
+    }
+    return acc;
+}
+
+// ───────────────────────────────────────────────────────
+// Órdenes
+
+/**
+ * @brief Aplica una orden al estado del PID (solo desde la tarea de control).
+ *
+ * @return ESP_OK, o ESP_ERR_INVALID_ARG si los valores no son válidos.
+ */
+static esp_err_t pid_apply(const pid_cmd_t *cmd) {
+    esp_err_t result = ESP_OK;
+
+    switch (cmd->type) {
+    case PID_CMD_ENABLE:
+        pid.enabled = true;
+        break;
+    case PID_CMD_DISABLE:
+        pid.enabled = false;
+        pid.output = 0.0f;
+        desactivar_ssr();
+        break;
+    case PID_CMD_SET_SETPOINT:
+        // BLE y la consola admiten cualquier valor; la pantalla ya lo limita con su arco
+        if (!isfinite(cmd->setpoint) || cmd->setpoint < PID_SETPOINT_MIN_C ||
+            cmd->setpoint > cfg_get_float(CFG_PID_SETPOINT_MAX)) {
+            result = ESP_ERR_INVALID_ARG;
+            break;
+        }
+        if (pid.setpoint != cmd->setpoint) {
+            pid.setpoint = cmd->setpoint;
+            evbus_event_t ev = { .type = EVBUS_SETPOINT,
+                                 .setpoint = { .value = cmd->setpoint, .source = cmd->source } };
+            evbus_publish(&ev);
+        }
+        break;
+    case PID_CMD_SET_PARAMS:
+        if (!cfg_valid(CFG_PID_KP, (cfg_value_t){ .f = cmd->gains.kp }) ||
+            !cfg_valid(CFG_PID_KI, (cfg_value_t){ .f = cmd->gains.ki }) ||
+            !cfg_valid(CFG_PID_KD, (cfg_value_t){ .f = cmd->gains.kd })) {
+            result = ESP_ERR_INVALID_ARG;
+            break;
+        }
+        pid.kp = cmd->gains.kp;
+        pid.ki = cmd->gains.ki;
+        pid.kd = cmd->gains.kd;
+        // El almacén agrupa la escritura en flash fuera de esta tarea
+        cfg_set_float(CFG_PID_KP, pid.kp);
+        cfg_set_float(CFG_PID_KI, pid.ki);
+        cfg_set_float(CFG_PID_KD, pid.kd);
+        break;
+    case PID_CMD_SET_SAMPLE_TIME:
+        if (!cfg_valid(CFG_PID_SAMPLE_TIME_MS, (cfg_value_t){ .u32 = cmd->sample_time_ms })) {
+            result = ESP_ERR_INVALID_ARG;
+            break;
+        }
+        // Rige desde el próximo ciclo; el integral queda en unidades de °C·s y no se reescala
+        sample_time_ms = cmd->sample_time_ms;
+        deadline_set_period(tick_monitor, sample_time_ms * 1000);
+        cfg_set_u32(CFG_PID_SAMPLE_TIME_MS, sample_time_ms);
+        break;
+    default:
+        result = ESP_ERR_INVALID_ARG;
+        break;
+    }
+
+    const uint32_t latency = (uint32_t)(timebase_mono_us() - cmd->submit_us);
+    portENTER_CRITICAL(&cmd_stats_lock);
+    if (result == ESP_OK) {
+        cmd_stats.applied++;
+        if (cmd->source < PID_SRC_COUNT) {
+            cmd_stats.by_source[cmd->source]++;
+        }
+    } else {
+        cmd_stats.rejected++;
+    }
+    cmd_stats.latency_last_us = latency;
+    cmd_stats.latency_sum_us += latency;
+    if (latency > cmd_stats.latency_max_us) {
+        cmd_stats.latency_max_us = latency;
+    }
+    portEXIT_CRITICAL(&cmd_stats_lock);
+
+    if (cmd->done) {
+        cmd->done(cmd, result, cmd->ctx);
+    }
+    return result;
+}
+
+/**
+ * @brief Espera `ms` atendiendo las órdenes que lleguen.
+ *
+ * Vuelve antes de tiempo si una orden activa o desactiva el PID, para que el lazo
+ * reaccione sin esperar al final del periodo.
+ */
+static void pid_wait(uint32_t ms) {
+    const int64_t end_us = timebase_mono_us() + (int64_t)ms * 1000;
+    const bool was_enabled = pid.enabled;
+    pid_cmd_t cmd;
+
+    for (;;) {
+        const int64_t remaining_us = end_us - timebase_mono_us();
+        if (remaining_us <= 0) {
+            return;
+        }
+        const TickType_t ticks = pdMS_TO_TICKS((remaining_us + 999) / 1000);
+        if (xQueueReceive(cmd_queue, &cmd, ticks ? ticks : 1) != pdTRUE) {
+            return;
+        }
+        pid_apply(&cmd);
+        if (pid.enabled != was_enabled) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Proveedor de métricas del controlador y de la cola de órdenes.
+ */
+static void pid_metrics(metrics_writer_t *w, void *ctx) {
+    (void)ctx;
+    static const char *const source_names[PID_SRC_COUNT] = {
+        "local", "ui", "websocket", "ble", "console", "modbus"
+    };
+    pid_cmd_stats_t st;
+    pid_get_cmd_stats(&st);
+
+    metrics_write_float(w, "pid_setpoint_celsius", NULL, pid.setpoint);
+    metrics_write_float(w, "pid_output_percent", NULL, pid_get_output());
+    metrics_write_uint(w, "pid_enabled", NULL, pid.enabled);
+    metrics_write_uint(w, "pid_alarms", NULL, alarms);
+    metrics_write_uint(w, "pid_sample_time_ms", NULL, sample_time_ms);
+    metrics_write_uint(w, "pid_cmd_submitted_total", NULL, st.submitted);
+    metrics_write_uint(w, "pid_cmd_rejected_total", NULL, st.rejected);
+    metrics_write_uint(w, "pid_cmd_dropped_total", NULL, st.dropped);
+    metrics_write_uint(w, "pid_cmd_latency_max_us", NULL, st.latency_max_us);
+    metrics_write_uint(w, "pid_cmd_latency_avg_us", NULL, st.applied + st.rejected ?
+                       st.latency_sum_us / (st.applied + st.rejected) : 0);
+
+    char labels[24];
+    for (int i = 0; i < PID_SRC_COUNT; i++) {
+        snprintf(labels, sizeof(labels), "source=\"%s\"", source_names[i]);
+        metrics_write_uint(w, "pid_cmd_applied_total", labels, st.by_source[i]);
+    }
+}
+
 /**
  * @brief Tarea principal del PID ejecutada periódicamente.
  * 
@@ -222,10 +428,11 @@ static float pid_compute(float current_temp) {
  * Incluye lógica de protección por sobretemperatura (0.5°C sobre el setpoint).
  */
 static void pid_task(void *pvParameters) {
-    const TickType_t xDelay = pdMS_TO_TICKS(pid_config.sample_time_ms);
     const float TEMP_OVERSHOOT_THRESHOLD = 0.5f;
 
     while (1) {
+        deadline_begin(tick_monitor);
+
         // Lectura de temperatura actual
         const float current_temp = read_ema_temp();
         last_temp = current_temp;
@@ -235,33 +442,47 @@ static void pid_task(void *pvParameters) {
 
             // Protección contra sobretemperatura
             if (error < -TEMP_OVERSHOOT_THRESHOLD) {
+                set_overtemp_alarm(true);
+                pid.output = 0.0f;
                 desactivar_ssr();
+                deadline_end(tick_monitor);
                 printf("[PID] 🧊 Sobrepasó el setpoint +%.1f°C → SSR apagado\n", TEMP_OVERSHOOT_THRESHOLD);
-                vTaskDelay(xDelay);
+                pid_wait(sample_time_ms);
                 continue;
             }
 
+            set_overtemp_alarm(false);
+
             // Cálculo del control PID
+            tracer_mark_begin(TRACER_MARK_PID_COMPUTE);
             const float control = pid_compute(current_temp);
-            const uint32_t on_time_ms = (uint32_t)((control / 100.0f) * pid_config.sample_time_ms);
-            const uint32_t off_time_ms = pid_config.sample_time_ms - on_time_ms;
+            tracer_mark_end(TRACER_MARK_PID_COMPUTE);
+            const uint32_t on_time_ms = (uint32_t)((control / 100.0f) * sample_time_ms);
+            const uint32_t off_time_ms = sample_time_ms - on_time_ms;
+            deadline_end(tick_monitor);
 
             // Control del SSR con modulación PWM
             if (on_time_ms > 0) {
                 printf("[PID] 🔌 Encendiendo SSR por %lu ms (Control %.2f%%)\n", 
                        (unsigned long)on_time_ms, control);
                 activar_ssr();
-                vTaskDelay(pdMS_TO_TICKS(on_time_ms));
+                // La ventana encendida no debe alargarse: cada ms de más es calor no pedido
+                deadline_set_budget(ssr_window_monitor, on_time_ms * 1000 + PID_SSR_WINDOW_TOLERANCE_US);
+                deadline_begin(ssr_window_monitor);
+                pid_wait(on_time_ms);
+                deadline_end(ssr_window_monitor);
             }
 
             if (off_time_ms > 0) {
                 printf("[PID] ⚡ Apagando SSR por %lu ms\n", (unsigned long)off_time_ms);
                 desactivar_ssr();
-                vTaskDelay(pdMS_TO_TICKS(off_time_ms));
+                pid_wait(off_time_ms);
             }
         } else {
+            set_overtemp_alarm(false);
             desactivar_ssr();
-            vTaskDelay(xDelay);
+            deadline_end(tick_monitor);
+            pid_wait(sample_time_ms);
         }
     }
 }
@@ -278,17 +499,17 @@ static void pid_task(void *pvParameters) {
 static void autotune_task(void *pvParameters) {
     pid.enabled = false;
 
-    const float hysteresis = pid_config.autotune_hysteresis;
-    const float relay_high = pid_config.autotune_relay_high;
-    const float relay_low = pid_config.autotune_relay_low;
+    const float hysteresis = cfg_get_float(CFG_AUTOTUNE_HYSTERESIS);
+    const float relay_high = cfg_get_float(CFG_AUTOTUNE_RELAY_HIGH);
+    const float relay_low = cfg_get_float(CFG_AUTOTUNE_RELAY_LOW);
     const float d = (relay_high - relay_low) / 2.0f;
 
     float setpoint = 50.0f;
 
     uint8_t cycleCount = 0;
-    const uint8_t minCycles = pid_config.autotune_min_cycles;
+    const uint8_t minCycles = (uint8_t)cfg_get_u32(CFG_AUTOTUNE_MIN_CYCLES);
     float periodSum = 0.0f;
-    TickType_t lastOnTick = 0;
+    int64_t lastOnUs = 0;
 
     float tempMax = -1000.0f;
     float tempMin =  1000.0f;
@@ -304,27 +525,25 @@ static void autotune_task(void *pvParameters) {
 
         if (!relayState && (currentTemp < setpoint - hysteresis)) {
             relayState = true;
-            CH422G_EnsurePushPullMode();
-            CH422G_od_output(0x00);
+            CH422G_od_clear_bits(CH422G_OD_OUT_1);
 
-            TickType_t now = xTaskGetTickCount();
-            if (lastOnTick != 0) {
-                float period = (now - lastOnTick) / 1000.0f;
+            int64_t now = timebase_mono_us();
+            if (lastOnUs != 0) {
+                float period = (now - lastOnUs) / 1e6f;
                 periodSum += period;
                 cycleCount++;
                 printf("[Autotune] 🔁 Periodo #%d: %.2fs\n", cycleCount, period);
             }
-            lastOnTick = now;
+            lastOnUs = now;
         } else if (relayState && (currentTemp > setpoint + hysteresis)) {
             relayState = false;
-            CH422G_EnsurePushPullMode();
-            CH422G_od_output(0x02);
+            CH422G_od_set_bits(CH422G_OD_OUT_1);
         }
 
-        vTaskDelay(pdMS_TO_TICKS(pid_config.autotune_delay_ms));
+        vTaskDelay(pdMS_TO_TICKS(cfg_get_u32(CFG_AUTOTUNE_DELAY_MS)));
     }
 
-    CH422G_od_output(0x02);
+    CH422G_od_set_bits(CH422G_OD_OUT_1);
 
     float Pu = periodSum / cycleCount;
     float amplitude = (tempMax - tempMin) / 2.0f;
@@ -345,41 +564,152 @@ static void autotune_task(void *pvParameters) {
 // ───────────────────────────────────────────────────────
 // API pública
 
+/**
+ * @brief Lleva a la tarea de control los cambios de ganancias o periodo hechos en el almacén.
+ *
+ * Los cambios que hace la propia tarea de control (pid_apply) ya están aplicados.
+ */
+static void pid_on_config_change(cfg_key_t key, cfg_value_t value, void *ctx) {
+    (void)ctx;
+    if (xTaskGetCurrentTaskHandle() == pid_task_handle) {
+        return;
+    }
+    pid_cmd_t cmd = { .source = PID_SRC_LOCAL };
+    if (key == CFG_PID_SAMPLE_TIME_MS) {
+        cmd.type = PID_CMD_SET_SAMPLE_TIME;
+        cmd.sample_time_ms = value.u32;
+    } else {
+        cmd.type = PID_CMD_SET_PARAMS;
+        cmd.gains.kp = cfg_get_float(CFG_PID_KP);
+        cmd.gains.ki = cfg_get_float(CFG_PID_KI);
+        cmd.gains.kd = cfg_get_float(CFG_PID_KD);
+    }
+    pid_submit(&cmd, PID_CFG_SUBMIT_MS);
+}
+
 /**
  * @brief Inicializa el controlador PID y crea la tarea de control.
  * 
  * @param setpoint Temperatura objetivo.
  */
 void pid_controller_init(float setpoint) {
-    if (pid_load_params() != ESP_OK) {
-        pid.kp = pid_config.kp_default;
-        pid.ki = pid_config.ki_default;
-        pid.kd = pid_config.kd_default;
-    }
+    pid_load_params();
 
     pid.setpoint = setpoint;
     pid.integral = 0.0f;
     pid.previous_error = 0.0f;
     pid.output = 0.0f;
     pid.enabled = false;
-
-    xTaskCreate(pid_task, "PID_Task", 4096, NULL, 5, NULL);
+    sample_time_ms = cfg_get_u32(CFG_PID_SAMPLE_TIME_MS);
+
+    cmd_queue = xQueueCreateStatic(PID_CMD_QUEUE_LEN, sizeof(pid_cmd_t), cmd_queue_storage, &cmd_queue_buffer);
+    cfg_subscribe((1u << CFG_PID_KP) | (1u << CFG_PID_KI) | (1u << CFG_PID_KD) |
+                  (1u << CFG_PID_SAMPLE_TIME_MS), pid_on_config_change, NULL);
+    metrics_register("pid", pid_metrics, NULL);
+    deadline_register("pid_tick", sample_time_ms * 1000, PID_TICK_TOLERANCE_US,
+                      PID_TICK_BUDGET_US, &tick_monitor);
+    deadline_register("ssr_window", 0, 0, 0, &ssr_window_monitor);
+
+    pid_task_handle = xTaskCreateStatic(pid_task, "PID_Task", MEM_STACK_PID, NULL, PID_TASK_PRIORITY,
+                                        pid_task_stack, &pid_task_tcb);
+    mem_budget_claim(MEM_MOD_PID, MEM_REGION_INTERNAL, PID_STATIC_BYTES);
     // xTaskCreate(autotune_task, "Autotune_Task", 4096, NULL, 5, NULL);
 }
 
+/**
+ * @brief Encola una orden para la tarea de control.
+ */
+esp_err_t pid_submit(const pid_cmd_t *cmd, uint32_t timeout_ms) {
+    if (cmd == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (cmd_queue == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    pid_cmd_t copy = *cmd;
+    copy.submit_us = timebase_mono_us();
+    const TickType_t ticks = timeout_ms == portMAX_DELAY ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    const bool queued = xQueueSend(cmd_queue, &copy, ticks) == pdTRUE;
+
+    portENTER_CRITICAL(&cmd_stats_lock);
+    if (queued) {
+        cmd_stats.submitted++;
+    } else {
+        cmd_stats.dropped++;
+    }
+    portEXIT_CRITICAL(&cmd_stats_lock);
+    return queued ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
+/**
+ * @brief Resultado de una orden enviada con pid_submit_wait().
+ */
+typedef struct {
+    TaskHandle_t waiter;
+    esp_err_t result;
+} pid_cmd_wait_t;
+
+static void pid_cmd_wait_done(const pid_cmd_t *cmd, esp_err_t result, void *ctx) {
+    (void)cmd;
+    pid_cmd_wait_t *wait = ctx;
+    wait->result = result;
+    xTaskNotifyGive(wait->waiter);
+}
+
+/**
+ * @brief Encola una orden y espera a que se aplique.
+ */
+esp_err_t pid_submit_wait(const pid_cmd_t *cmd, uint32_t timeout_ms) {
+    if (cmd == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pid_cmd_t copy = *cmd;
+    if (xTaskGetCurrentTaskHandle() == pid_task_handle) {
+        copy.submit_us = timebase_mono_us();
+        copy.done = NULL;
+        return pid_apply(&copy);
+    }
+
+    // `wait` vive en esta pila: tras encolar hay que esperar sí o sí al aviso
+    pid_cmd_wait_t wait = { .waiter = xTaskGetCurrentTaskHandle(), .result = ESP_FAIL };
+    copy.done = pid_cmd_wait_done;
+    copy.ctx = &wait;
+    esp_err_t ret = pid_submit(&copy, timeout_ms);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    return wait.result;
+}
+
+/**
+ * @brief Obtiene las estadísticas de la cola de órdenes.
+ */
+void pid_get_cmd_stats(pid_cmd_stats_t *stats) {
+    if (stats == NULL) {
+        return;
+    }
+    portENTER_CRITICAL(&cmd_stats_lock);
+    *stats = cmd_stats;
+    portEXIT_CRITICAL(&cmd_stats_lock);
+}
+
 /**
  * @brief Activa el controlador PID.
  */
 void enable_pid(void) {
-    pid.enabled = true;
+    const pid_cmd_t cmd = { .type = PID_CMD_ENABLE, .source = PID_SRC_LOCAL };
+    pid_submit(&cmd, portMAX_DELAY);
 }
 
 /**
  * @brief Desactiva el controlador PID y apaga el SSR.
  */
 void disable_pid(void) {
-    pid.enabled = false;
-    desactivar_ssr();
+    const pid_cmd_t cmd = { .type = PID_CMD_DISABLE, .source = PID_SRC_LOCAL };
+    pid_submit(&cmd, portMAX_DELAY);
 }
 
 /**
@@ -390,10 +720,12 @@ void disable_pid(void) {
  * @param new_kd Nuevo valor de Kd.
  */
 void pid_set_params(float new_kp, float new_ki, float new_kd) {
-    pid.kp = new_kp;
-    pid.ki = new_ki;
-    pid.kd = new_kd;
-    pid_save_params();
+    const pid_cmd_t cmd = {
+        .type = PID_CMD_SET_PARAMS,
+        .source = PID_SRC_LOCAL,
+        .gains = { new_kp, new_ki, new_kd },
+    };
+    pid_submit(&cmd, portMAX_DELAY);
 }
 
 /**
@@ -402,56 +734,33 @@ void pid_set_params(float new_kp, float new_ki, float new_kd) {
  * @param sp Nuevo setpoint en °C.
  */
 void pid_set_setpoint(float sp) {
-    pid.setpoint = sp;
+    const pid_cmd_t cmd = { .type = PID_CMD_SET_SETPOINT, .source = PID_SRC_LOCAL, .setpoint = sp };
+    pid_submit(&cmd, portMAX_DELAY);
 }
 
 // ───────────────────────────────────────────────────────
-// Manejo de NVS
+// Persistencia
 
 /**
- * @brief Guarda los parámetros Kp, Ki y Kd en NVS.
+ * @brief Escribe ya las ganancias vigentes (sin esperar al guardado agrupado del almacén).
  * 
- * @return esp_err_t ESP_OK si fue exitoso.
+ * @return esp_err_t ESP_OK si fue exitoso, o el error de cfg_flush().
  */
 esp_err_t pid_save_params(void) {
-    nvs_handle_t handle;
-    esp_err_t err = nvs_open("pid_params", NVS_READWRITE, &handle);
-    if (err != ESP_OK) return err;
-
-    err = nvs_set_blob(handle, "Kp", &pid.kp, sizeof(pid.kp));
-    if (err != ESP_OK) { nvs_close(handle); return err; }
-
-    err = nvs_set_blob(handle, "Ki", &pid.ki, sizeof(pid.ki));
-    if (err != ESP_OK) { nvs_close(handle); return err; }
-
-    err = nvs_set_blob(handle, "Kd", &pid.kd, sizeof(pid.kd));
-    if (err != ESP_OK) { nvs_close(handle); return err; }
-
-    err = nvs_commit(handle);
-    nvs_close(handle);
-    return err;
+    cfg_set_float(CFG_PID_KP, pid.kp);
+    cfg_set_float(CFG_PID_KI, pid.ki);
+    cfg_set_float(CFG_PID_KD, pid.kd);
+    return cfg_flush();
 }
 
 /**
- * @brief Carga los parámetros Kp, Ki y Kd desde NVS.
+ * @brief Toma Kp, Ki y Kd del almacén de configuración.
  * 
- * @return esp_err_t ESP_OK si fue exitoso.
+ * @return esp_err_t ESP_OK.
  */
 esp_err_t pid_load_params(void) {
-    nvs_handle_t handle;
-    esp_err_t err = nvs_open("pid_params", NVS_READONLY, &handle);
-    if (err != ESP_OK) return err;
-
-    size_t size = sizeof(pid.kp);
-    err = nvs_get_blob(handle, "Kp", &pid.kp, &size);
-    if (err != ESP_OK) { nvs_close(handle); return err; }
-
-    size = sizeof(pid.ki);
-    err = nvs_get_blob(handle, "Ki", &pid.ki, &size);
-    if (err != ESP_OK) { nvs_close(handle); return err; }
-
-    size = sizeof(pid.kd);
-    err = nvs_get_blob(handle, "Kd", &pid.kd, &size);
-    nvs_close(handle);
-    return err;
+    pid.kp = cfg_get_float(CFG_PID_KP);
+    pid.ki = cfg_get_float(CFG_PID_KI);
+    pid.kd = cfg_get_float(CFG_PID_KD);
+    return ESP_OK;
 }
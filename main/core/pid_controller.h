@@ -3,8 +3,12 @@
  * @brief Interfaz del controlador PID para regulación de temperatura en el horno de vacío.
  *
  * Este módulo proporciona las funciones necesarias para configurar, iniciar,
- * activar/desactivar y ajustar los parámetros del controlador PID. También permite
- * guardar y recuperar los parámetros desde la NVS del ESP32.
+ * activar/desactivar y ajustar los parámetros del controlador PID. Ganancias, periodo y
+ * límites de salida se guardan en el almacén de configuración (config_store.h).
+ *
+ * La tarea de control es la única que escribe el estado del PID. Las demás fuentes
+ * (UI, WebSocket, BLE, consola, autotuning) envían órdenes tipadas con pid_submit();
+ * la tarea las aplica entre dos pasos del lazo, nunca a mitad de un cálculo.
  *
  * @version 1.0
  * @date 2024-01-27
@@ -14,32 +18,139 @@
 #define PID_CONTROLLER_H
 
 #include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/** @brief Alarma: la temperatura superó el setpoint y el SSR se forzó a apagado. */
+#define PID_ALARM_OVERTEMP  (1u << 0)
+
+#define PID_SAMPLE_TIME_MIN_MS  1000    ///< Periodo de control mínimo (no menor que la lectura Modbus)
+#define PID_SAMPLE_TIME_MAX_MS  60000   ///< Periodo de control máximo
+#define PID_SETPOINT_MIN_C      0.0f    ///< Setpoint mínimo; el máximo es la clave CFG_PID_SETPOINT_MAX
+
+/**
+ * @brief Tipos de orden aceptados por la tarea de control.
+ */
+typedef enum {
+    PID_CMD_ENABLE = 0,     ///< Activar el PID
+    PID_CMD_DISABLE,        ///< Desactivar el PID y apagar el SSR
+    PID_CMD_SET_SETPOINT,   ///< Nuevo setpoint (`setpoint`)
+    PID_CMD_SET_PARAMS,     ///< Nuevas ganancias (`gains`), se guardan en el almacén
+    PID_CMD_SET_SAMPLE_TIME,///< Nuevo periodo de control (`sample_time_ms`), se guarda en el almacén
+} pid_cmd_type_t;
+
+/**
+ * @brief Origen de una orden (para estadísticas y log).
+ */
+typedef enum {
+    PID_SRC_LOCAL = 0,      ///< Lógica interna del firmware (autotuning)
+    PID_SRC_UI,             ///< Pantalla táctil
+    PID_SRC_WEBSOCKET,      ///< Cliente WebSocket
+    PID_SRC_BLE,            ///< Cliente BLE
+    PID_SRC_CONSOLE,        ///< Consola serie
+    PID_SRC_MODBUS,         ///< Modbus TCP
+    PID_SRC_COUNT
+} pid_cmd_source_t;
+
+typedef struct pid_cmd pid_cmd_t;
+
+/**
+ * @brief Aviso de orden aplicada (se ejecuta en la tarea de control; debe ser breve).
+ *
+ * @param cmd Orden aplicada.
+ * @param result ESP_OK, o ESP_ERR_INVALID_ARG si los valores no eran válidos.
+ * @param ctx Contexto indicado en la orden.
+ */
+typedef void (*pid_cmd_done_fn_t)(const pid_cmd_t *cmd, esp_err_t result, void *ctx);
+
+/**
+ * @brief Orden para la tarea de control.
+ */
+struct pid_cmd {
+    pid_cmd_type_t type;        ///< Tipo de orden
+    pid_cmd_source_t source;    ///< Origen
+    union {
+        float setpoint;         ///< PID_CMD_SET_SETPOINT, en °C, entre PID_SETPOINT_MIN_C y CFG_PID_SETPOINT_MAX
+        struct {
+            float kp, ki, kd;
+        } gains;                ///< PID_CMD_SET_PARAMS
+        uint32_t sample_time_ms;///< PID_CMD_SET_SAMPLE_TIME, entre PID_SAMPLE_TIME_MIN_MS y _MAX_MS
+    };
+    pid_cmd_done_fn_t done;     ///< Aviso al aplicarse (puede ser NULL)
+    void *ctx;                  ///< Contexto para `done`
+    int64_t submit_us;          ///< Instante de envío (lo completa pid_submit())
+};
+
+/**
+ * @brief Estadísticas de la cola de órdenes.
+ */
+typedef struct {
+    uint32_t submitted;                     ///< Órdenes encoladas
+    uint32_t applied;                       ///< Órdenes aplicadas
+    uint32_t rejected;                      ///< Órdenes con valores no válidos
+    uint32_t dropped;                       ///< Órdenes descartadas por cola llena
+    uint32_t by_source[PID_SRC_COUNT];      ///< Órdenes aplicadas por origen
+    uint32_t latency_last_us;               ///< Envío → aplicación de la última orden
+    uint32_t latency_max_us;                ///< Máximo envío → aplicación
+    uint64_t latency_sum_us;                ///< Suma para el promedio
+} pid_cmd_stats_t;
+
 /**
  * @brief Inicializa el controlador PID con un setpoint inicial y crea la tarea PID.
  *
- * Si existen parámetros almacenados en NVS, se cargan automáticamente.
+ * Toma ganancias y periodo del almacén de configuración (requiere cfg_init()) y se
+ * suscribe a sus cambios, que aplica como órdenes de origen local.
  *
  * @param setpoint Temperatura objetivo (°C).
  */
 void pid_controller_init(float setpoint);
 
 /**
- * @brief Activa el funcionamiento del PID.
+ * @brief Envía una orden a la tarea de control sin esperar a que se aplique.
+ *
+ * @param cmd Orden (se copia; `submit_us` se ignora).
+ * @param timeout_ms Espera máxima si la cola está llena.
+ * @return ESP_OK si se encoló, ESP_ERR_TIMEOUT si la cola siguió llena,
+ *         ESP_ERR_INVALID_STATE antes de pid_controller_init().
+ */
+esp_err_t pid_submit(const pid_cmd_t *cmd, uint32_t timeout_ms);
+
+/**
+ * @brief Envía una orden y espera a que la tarea de control la aplique.
+ *
+ * La espera tras encolar no tiene límite: la tarea atiende la cola en cada paso del
+ * lazo. `done` y `ctx` de la orden se ignoran. Llamada desde la propia tarea de
+ * control, aplica la orden directamente.
+ *
+ * @param cmd Orden.
+ * @param timeout_ms Espera máxima si la cola está llena.
+ * @return Resultado de la aplicación, o el error de pid_submit().
+ */
+esp_err_t pid_submit_wait(const pid_cmd_t *cmd, uint32_t timeout_ms);
+
+/**
+ * @brief Obtiene las estadísticas de la cola de órdenes.
+ */
+void pid_get_cmd_stats(pid_cmd_stats_t *stats);
+
+/**
+ * @brief Activa el funcionamiento del PID (orden PID_CMD_ENABLE de origen local).
  */
 void enable_pid(void);
 
 /**
- * @brief Desactiva el funcionamiento del PID y apaga el SSR.
+ * @brief Desactiva el PID y apaga el SSR (orden PID_CMD_DISABLE de origen local).
  */
 void disable_pid(void);
 
 /**
- * @brief Asigna nuevos valores a los parámetros PID (Kp, Ki, Kd) y los guarda en NVS.
+ * @brief Asigna nuevos valores a los parámetros PID (Kp, Ki, Kd) y los guarda en el almacén.
+ *
+ * Envía una orden PID_CMD_SET_PARAMS de origen local.
  *
  * @param new_kp Nuevo valor de la constante proporcional Kp.
  * @param new_ki Nuevo valor de la constante integral Ki.
@@ -50,6 +161,8 @@ void pid_set_params(float new_kp, float new_ki, float new_kd);
 /**
  * @brief Establece un nuevo setpoint de temperatura para el PID.
  *
+ * Envía una orden PID_CMD_SET_SETPOINT de origen local.
+ *
  * @param sp Nuevo setpoint en grados Celsius (°C).
  */
 void pid_set_setpoint(float sp);
@@ -62,16 +175,61 @@ void pid_set_setpoint(float sp);
 bool pid_ssr_status(void);
 
 /**
- * @brief Guarda los parámetros PID actuales en la NVS (almacenamiento no volátil).
+ * @brief Obtiene el setpoint actual.
+ *
+ * @return Setpoint en grados Celsius (°C).
+ */
+float pid_get_setpoint(void);
+
+/**
+ * @brief Obtiene la última salida calculada por el PID.
+ *
+ * @return Salida entre 0 y 100 %.
+ */
+float pid_get_output(void);
+
+/**
+ * @brief Indica si el PID está activo.
+ */
+bool pid_is_enabled(void);
+
+/**
+ * @brief Obtiene las alarmas activas.
+ *
+ * @return Máscara de bits PID_ALARM_*.
+ */
+uint32_t pid_get_alarms(void);
+
+/**
+ * @brief Obtiene el periodo de control vigente (ventana del SSR).
+ *
+ * @return Periodo en milisegundos.
+ */
+uint32_t pid_get_sample_time_ms(void);
+
+/**
+ * @brief Ejecuta el cálculo PID `iterations` veces sobre una copia del estado.
+ *
+ * No modifica el controlador; la usa el banco de pruebas (bench.h).
+ *
+ * @return Suma de las salidas, para que el compilador no descarte el cálculo.
+ */
+float pid_bench_compute(uint32_t iterations);
+
+/**
+ * @brief Guarda ya los parámetros PID actuales, sin esperar al guardado agrupado del almacén.
  *
  * @return esp_err_t ESP_OK si fue exitoso, o un código de error de NVS.
  */
 esp_err_t pid_save_params(void);
 
 /**
- * @brief Carga los parámetros PID desde la NVS.
+ * @brief Toma los parámetros PID del almacén de configuración.
  *
- * @return esp_err_t ESP_OK si fue exitoso, o un código de error de NVS.
+ * Solo antes de pid_controller_init(); después, la tarea de control recibe los cambios
+ * del almacén como órdenes.
+ *
+ * @return esp_err_t ESP_OK.
  */
 esp_err_t pid_load_params(void);
 
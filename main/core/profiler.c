@@ -0,0 +1,291 @@
+/**
+ * @file profiler.c
+ * @brief Implementación del perfilador de tiempo de ejecución.
+ * @details Cada muestra compara el contador de tiempo de ejecución de cada tarea con el de
+ *          la muestra anterior (emparejando por xTaskNumber), arma la instantánea en un
+ *          buffer de trabajo y la publica copiándola bajo un spinlock. Los buffers son
+ *          estáticos para no cargar la pila del planificador.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#include "profiler.h"
+#include "scheduler.h"
+#include "timebase.h"
+#include "metrics.h"
+#include "freertos/task.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "PROF";
+
+#define PROFILER_ENABLED (CONFIG_FREERTOS_USE_TRACE_FACILITY && CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS)
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static profiler_snapshot_t s_snapshot;      ///< Última instantánea publicada (lock)
+static bool s_have_snapshot = false;
+
+#if PROFILER_ENABLED
+
+/**
+ * @brief Estado de una tarea en la muestra anterior
+ */
+typedef struct {
+    UBaseType_t number;                     ///< xTaskNumber
+    configRUN_TIME_COUNTER_TYPE runtime;    ///< Contador de ejecución acumulado
+    bool warned;                            ///< Ya se avisó de poca pila
+} prev_task_t;
+
+static TaskStatus_t s_status[PROFILER_MAX_TASKS];
+static profiler_snapshot_t s_work;
+static prev_task_t s_prev[PROFILER_MAX_TASKS];
+static prev_task_t s_next[PROFILER_MAX_TASKS];
+static size_t s_prev_count = 0;
+static configRUN_TIME_COUNTER_TYPE s_prev_total = 0;
+static uint32_t s_samples = 0;
+static sched_job_handle_t s_job = NULL;
+
+static const uint32_t s_heap_caps[PROFILER_HEAP_COUNT] = {
+    [PROFILER_HEAP_INTERNAL] = MALLOC_CAP_INTERNAL,
+    [PROFILER_HEAP_PSRAM] = MALLOC_CAP_SPIRAM,
+    [PROFILER_HEAP_DMA] = MALLOC_CAP_DMA,
+};
+
+static const prev_task_t *find_prev(UBaseType_t number)
+{
+    for (size_t i = 0; i < s_prev_count; i++) {
+        if (s_prev[i].number == number) {
+            return &s_prev[i];
+        }
+    }
+    return NULL;
+}
+
+static void take_sample(void)
+{
+    configRUN_TIME_COUNTER_TYPE total = 0;
+    const UBaseType_t n = uxTaskGetSystemState(s_status, PROFILER_MAX_TASKS, &total);
+    const uint32_t tasks_total = uxTaskGetNumberOfTasks();
+    if (n == 0) {
+        // uxTaskGetSystemState() no devuelve nada si el arreglo no alcanza
+        ESP_LOGW(TAG, "%lu tareas; la capacidad es %d", (unsigned long)tasks_total, PROFILER_MAX_TASKS);
+        return;
+    }
+
+    const configRUN_TIME_COUNTER_TYPE window = total - s_prev_total;
+    TaskHandle_t idle[PROFILER_CORES];
+    for (int c = 0; c < PROFILER_CORES; c++) {
+        idle[c] = xTaskGetIdleTaskHandleForCore(c);
+        s_work.core_load_pct[c] = 0.0f;
+    }
+
+    s_work.stack_warnings = 0;
+    for (UBaseType_t i = 0; i < n; i++) {
+        const TaskStatus_t *st = &s_status[i];
+        profiler_task_t *t = &s_work.tasks[i];
+        const prev_task_t *prev = find_prev(st->xTaskNumber);
+
+        strlcpy(t->name, st->pcTaskName, sizeof(t->name));
+        const BaseType_t core = xTaskGetCoreID(st->xHandle);
+        t->core = (core >= 0 && core < PROFILER_CORES) ? (uint8_t)core : PROFILER_CORE_ANY;
+        t->priority = (uint8_t)st->uxCurrentPriority;
+        t->stack_free_min = st->usStackHighWaterMark;   // En bytes en ESP-IDF
+        t->stack_low = t->stack_free_min < CONFIG_PROFILER_STACK_WARN_BYTES;
+
+        // Una tarea nueva cuenta desde la muestra anterior con su acumulado completo
+        const configRUN_TIME_COUNTER_TYPE ran = st->ulRunTimeCounter - (prev ? prev->runtime : 0);
+        t->cpu_pct = (window && s_samples) ? (float)ran * 100.0f / (float)window : 0.0f;
+
+        for (int c = 0; c < PROFILER_CORES; c++) {
+            if (st->xHandle == idle[c]) {
+                s_work.core_load_pct[c] = 100.0f - t->cpu_pct;
+            }
+        }
+
+        s_next[i].number = st->xTaskNumber;
+        s_next[i].runtime = st->ulRunTimeCounter;
+        s_next[i].warned = prev ? prev->warned : false;
+        if (t->stack_low) {
+            s_work.stack_warnings++;
+            if (!s_next[i].warned) {
+                ESP_LOGW(TAG, "Tarea '%s' cerca de desbordar la pila: %lu B libres como mínimo",
+                         t->name, (unsigned long)t->stack_free_min);
+                s_next[i].warned = true;
+            }
+        }
+    }
+    memcpy(s_prev, s_next, n * sizeof(s_next[0]));
+    s_prev_count = n;
+    s_prev_total = total;
+
+    // Orden por CPU descendente (inserción: pocas tareas)
+    for (UBaseType_t i = 1; i < n; i++) {
+        const profiler_task_t key = s_work.tasks[i];
+        UBaseType_t j = i;
+        while (j > 0 && s_work.tasks[j - 1].cpu_pct < key.cpu_pct) {
+            s_work.tasks[j] = s_work.tasks[j - 1];
+            j--;
+        }
+        s_work.tasks[j] = key;
+    }
+
+    for (int r = 0; r < PROFILER_HEAP_COUNT; r++) {
+        s_work.heap[r].free = heap_caps_get_free_size(s_heap_caps[r]);
+        s_work.heap[r].min_free = heap_caps_get_minimum_free_size(s_heap_caps[r]);
+        s_work.heap[r].largest = heap_caps_get_largest_free_block(s_heap_caps[r]);
+    }
+
+    s_work.t_us = timebase_mono_us();
+    s_work.window_us = s_samples ? (uint32_t)window : 0;
+    s_work.samples = ++s_samples;
+    s_work.task_count = n;
+    s_work.tasks_total = tasks_total;
+
+    portENTER_CRITICAL(&s_lock);
+    s_snapshot = s_work;
+    s_have_snapshot = true;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+static void profiler_job(void *ctx)
+{
+    (void)ctx;
+    take_sample();
+}
+
+#endif // PROFILER_ENABLED
+
+// ───────────────────────────────────────────────────────
+// Métricas
+
+static const char *const s_region_names[PROFILER_HEAP_COUNT] = {
+    [PROFILER_HEAP_INTERNAL] = "internal",
+    [PROFILER_HEAP_PSRAM] = "psram",
+    [PROFILER_HEAP_DMA] = "dma",
+};
+
+static void profiler_metrics(metrics_writer_t *w, void *ctx)
+{
+    (void)ctx;
+    profiler_snapshot_t *snap = malloc(sizeof(*snap));
+    if (snap == NULL || profiler_get_snapshot(snap) != ESP_OK) {
+        free(snap);
+        return;
+    }
+    char labels[64];
+    metrics_write_uint(w, "prof_samples_total", NULL, snap->samples);
+    metrics_write_uint(w, "prof_window_us", NULL, snap->window_us);
+    metrics_write_uint(w, "prof_tasks", NULL, snap->tasks_total);
+    metrics_write_uint(w, "prof_stack_warnings", NULL, snap->stack_warnings);
+    for (int c = 0; c < PROFILER_CORES; c++) {
+        snprintf(labels, sizeof(labels), "core=\"%d\"", c);
+        metrics_write_float(w, "prof_core_load_pct", labels, snap->core_load_pct[c]);
+    }
+    for (size_t i = 0; i < snap->task_count; i++) {
+        const profiler_task_t *t = &snap->tasks[i];
+        if (t->core == PROFILER_CORE_ANY) {
+            snprintf(labels, sizeof(labels), "task=\"%s\",core=\"any\"", t->name);
+        } else {
+            snprintf(labels, sizeof(labels), "task=\"%s\",core=\"%u\"", t->name, t->core);
+        }
+        metrics_write_float(w, "prof_task_cpu_pct", labels, t->cpu_pct);
+        metrics_write_uint(w, "prof_task_stack_free_min_bytes", labels, t->stack_free_min);
+        metrics_write_uint(w, "prof_task_stack_low", labels, t->stack_low);
+    }
+    for (int r = 0; r < PROFILER_HEAP_COUNT; r++) {
+        snprintf(labels, sizeof(labels), "region=\"%s\"", s_region_names[r]);
+        metrics_write_uint(w, "prof_heap_free_bytes", labels, snap->heap[r].free);
+        metrics_write_uint(w, "prof_heap_min_free_bytes", labels, snap->heap[r].min_free);
+        metrics_write_uint(w, "prof_heap_largest_block_bytes", labels, snap->heap[r].largest);
+    }
+    free(snap);
+}
+
+// ───────────────────────────────────────────────────────
+// API pública
+
+esp_err_t profiler_init(void)
+{
+#if PROFILER_ENABLED
+    if (s_job != NULL) {
+        return ESP_OK;
+    }
+    take_sample();      // Línea base de la primera ventana
+    esp_err_t ret = sched_add("profiler", profiler_job, NULL, CONFIG_PROFILER_SAMPLE_MS,
+                              CONFIG_PROFILER_SAMPLE_MS, &s_job);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "No se pudo registrar el muestreo: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    metrics_register("prof", profiler_metrics, NULL);
+    return ESP_OK;
+#else
+    (void)profiler_metrics;
+    ESP_LOGW(TAG, "Requiere CONFIG_FREERTOS_USE_TRACE_FACILITY y CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS");
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+void profiler_sample_now(void)
+{
+#if PROFILER_ENABLED
+    if (s_job) {
+        sched_trigger(s_job, 0);
+    }
+#endif
+}
+
+esp_err_t profiler_get_snapshot(profiler_snapshot_t *out)
+{
+    if (out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t ret = ESP_ERR_INVALID_STATE;
+    portENTER_CRITICAL(&s_lock);
+    if (s_have_snapshot) {
+        *out = s_snapshot;
+        ret = ESP_OK;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return ret;
+}
+
+void profiler_log_report(void)
+{
+    profiler_snapshot_t *snap = malloc(sizeof(*snap));
+    if (snap == NULL) {
+        return;
+    }
+    if (profiler_get_snapshot(snap) != ESP_OK) {
+        ESP_LOGI(TAG, "Sin muestras todavía");
+        free(snap);
+        return;
+    }
+
+    ESP_LOGI(TAG, "=== Perfil: ventana %lu ms, %lu tareas, CPU0 %.1f %%, CPU1 %.1f %% ===",
+             (unsigned long)(snap->window_us / 1000), (unsigned long)snap->tasks_total,
+             snap->core_load_pct[0], snap->core_load_pct[1]);
+    for (size_t i = 0; i < snap->task_count; i++) {
+        const profiler_task_t *t = &snap->tasks[i];
+        char core[4];
+        if (t->core == PROFILER_CORE_ANY) {
+            strcpy(core, "-");
+        } else {
+            snprintf(core, sizeof(core), "%u", t->core);
+        }
+        ESP_LOGI(TAG, "%-16s núcleo %-2s prio %2u  CPU %5.1f %%  pila libre mín %5lu B%s",
+                 t->name, core, t->priority, t->cpu_pct, (unsigned long)t->stack_free_min,
+                 t->stack_low ? "  << POCA PILA" : "");
+    }
+    for (int r = 0; r < PROFILER_HEAP_COUNT; r++) {
+        ESP_LOGI(TAG, "Heap %-8s libre %7lu B  mínimo %7lu B  bloque mayor %7lu B", s_region_names[r],
+                 (unsigned long)snap->heap[r].free, (unsigned long)snap->heap[r].min_free,
+                 (unsigned long)snap->heap[r].largest);
+    }
+    free(snap);
+}
@@ -0,0 +1,110 @@
+/**
+ * @file profiler.h
+ * @brief Perfilador de tiempo de ejecución: CPU por tarea, pila y heap.
+ * @details Un trabajo del planificador toma cada CONFIG_PROFILER_SAMPLE_MS una instantánea
+ *          con uxTaskGetSystemState(): porcentaje de CPU de cada tarea en la ventana (sobre
+ *          un núcleo, por lo que una tarea puede llegar al 100 %), núcleo al que está fijada,
+ *          mínimo de pila libre y carga de cada núcleo (100 % menos su tarea IDLE). También
+ *          registra libre/mínimo/bloque mayor del heap interno, PSRAM y DMA.
+ *
+ *          Las tareas con menos de CONFIG_PROFILER_STACK_WARN_BYTES de pila libre se marcan
+ *          y se avisan una vez en el log. La instantánea alimenta la pantalla Devmode, las
+ *          métricas "prof" (/metrics) y profiler_log_report().
+ *
+ *          Requiere CONFIG_FREERTOS_USE_TRACE_FACILITY y CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PROFILER_MAX_TASKS      40      ///< Tareas registradas en una instantánea
+#define PROFILER_CORES          2       ///< Núcleos del ESP32-S3
+#define PROFILER_CORE_ANY       0xFF    ///< Tarea sin afinidad de núcleo
+
+/**
+ * @brief Regiones de heap vigiladas
+ */
+typedef enum {
+    PROFILER_HEAP_INTERNAL = 0,     ///< RAM interna (MALLOC_CAP_INTERNAL)
+    PROFILER_HEAP_PSRAM,            ///< PSRAM (MALLOC_CAP_SPIRAM)
+    PROFILER_HEAP_DMA,              ///< Apta para DMA (MALLOC_CAP_DMA)
+    PROFILER_HEAP_COUNT
+} profiler_heap_region_t;
+
+/**
+ * @brief Datos de una tarea
+ */
+typedef struct {
+    char name[configMAX_TASK_NAME_LEN];     ///< Nombre de la tarea
+    uint8_t core;                           ///< Núcleo fijado o PROFILER_CORE_ANY
+    uint8_t priority;                       ///< Prioridad actual
+    bool stack_low;                         ///< Pila libre por debajo del umbral
+    uint32_t stack_free_min;                ///< Mínimo de pila libre (bytes)
+    float cpu_pct;                          ///< CPU en la última ventana (% de un núcleo)
+} profiler_task_t;
+
+/**
+ * @brief Uso de una región de heap
+ */
+typedef struct {
+    uint32_t free;              ///< Bytes libres
+    uint32_t min_free;          ///< Mínimo de bytes libres desde el arranque
+    uint32_t largest;           ///< Bloque libre más grande
+} profiler_heap_t;
+
+/**
+ * @brief Instantánea completa
+ */
+typedef struct {
+    int64_t t_us;                               ///< Instante de la muestra (timebase_mono_us)
+    uint32_t window_us;                         ///< Duración de la ventana de CPU
+    uint32_t samples;                           ///< Instantáneas tomadas
+    float core_load_pct[PROFILER_CORES];        ///< Carga de cada núcleo en la ventana
+    size_t task_count;                          ///< Tareas válidas en `tasks`
+    uint32_t tasks_total;                       ///< Tareas del sistema (puede superar la capacidad)
+    uint32_t stack_warnings;                    ///< Tareas marcadas con poca pila
+    profiler_task_t tasks[PROFILER_MAX_TASKS];  ///< Ordenadas por CPU descendente
+    profiler_heap_t heap[PROFILER_HEAP_COUNT];  ///< Uso de heap por región
+} profiler_snapshot_t;
+
+/**
+ * @brief Registra el muestreo periódico y el proveedor de métricas "prof"
+ * @return ESP_OK, ESP_ERR_NOT_SUPPORTED sin las estadísticas de FreeRTOS, o el error de sched_add()
+ */
+esp_err_t profiler_init(void);
+
+/**
+ * @brief Toma una instantánea fuera de turno (también reinicia la ventana de CPU)
+ */
+void profiler_sample_now(void);
+
+/**
+ * @brief Copia la última instantánea
+ * @param out Destino
+ * @return ESP_OK, o ESP_ERR_INVALID_STATE si aún no hay ninguna
+ */
+esp_err_t profiler_get_snapshot(profiler_snapshot_t *out);
+
+/**
+ * @brief Imprime en el log la última instantánea como tabla
+ */
+void profiler_log_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PROFILER_H
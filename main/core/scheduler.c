@@ -0,0 +1,458 @@
+/**
+ * @file scheduler.c
+ * @brief Implementación del planificador de trabajos.
+ * @details Los trabajos viven en un arreglo estático; el montículo guarda índices a ese
+ *          arreglo ordenados por vencimiento y cada trabajo recuerda su posición en el
+ *          montículo para poder desarmarlo en O(log n). Un trabajo sale del montículo
+ *          mientras se ejecuta y vuelve a entrar al terminar si es periódico.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#include "scheduler.h"
+#include "metrics.h"
+#include "mem_budget.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "SCHED";
+
+#define SCHED_TASK_PRIORITY 4       ///< Por debajo del PID y del bus I2C
+#define NOT_QUEUED          (-1)
+
+typedef enum {
+    JOB_FREE = 0,
+    JOB_IDLE,       ///< Registrado pero no armado
+    JOB_QUEUED,     ///< En el montículo
+    JOB_RUNNING,    ///< Ejecutándose (fuera del montículo)
+} job_state_t;
+
+struct sched_job {
+    const char *name;
+    sched_fn_t fn;
+    void *ctx;
+    int64_t due_us;
+    uint32_t period_ms;
+    job_state_t state;
+    int heap_pos;
+    bool cancel;            ///< Eliminar al terminar la ejecución en curso
+    bool rearm;             ///< Rearmado durante la ejecución en curso
+    bool disarm;            ///< Desarmado durante la ejecución en curso
+    sched_job_stats_t stats;
+};
+
+static struct sched_job s_jobs[SCHED_MAX_JOBS];
+static int s_heap[SCHED_MAX_JOBS];
+static int s_heap_len = 0;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t s_task = NULL;
+static StackType_t s_task_stack[MEM_STACK_SCHED];
+static StaticTask_t s_task_tcb;
+MEM_BUDGET_STATIC_ASSERT(SCHED, INTERNAL, sizeof(s_task_stack) + sizeof(s_task_tcb));
+static sched_stats_t s_stats;
+
+// ───────────────────────────────────────────────────────
+// Montículo mínimo (lock tomado)
+
+static inline bool heap_less(int a, int b)
+{
+    return s_jobs[s_heap[a]].due_us < s_jobs[s_heap[b]].due_us;
+}
+
+static void heap_swap(int a, int b)
+{
+    const int tmp = s_heap[a];
+    s_heap[a] = s_heap[b];
+    s_heap[b] = tmp;
+    s_jobs[s_heap[a]].heap_pos = a;
+    s_jobs[s_heap[b]].heap_pos = b;
+}
+
+static void heap_sift_up(int pos)
+{
+    while (pos > 0) {
+        const int parent = (pos - 1) / 2;
+        if (!heap_less(pos, parent)) {
+            break;
+        }
+        heap_swap(pos, parent);
+        pos = parent;
+    }
+}
+
+static void heap_sift_down(int pos)
+{
+    for (;;) {
+        const int left = 2 * pos + 1;
+        const int right = left + 1;
+        int smallest = pos;
+        if (left < s_heap_len && heap_less(left, smallest)) {
+            smallest = left;
+        }
+        if (right < s_heap_len && heap_less(right, smallest)) {
+            smallest = right;
+        }
+        if (smallest == pos) {
+            break;
+        }
+        heap_swap(pos, smallest);
+        pos = smallest;
+    }
+}
+
+static void heap_push(int idx)
+{
+    const int pos = s_heap_len++;
+    s_heap[pos] = idx;
+    s_jobs[idx].heap_pos = pos;
+    s_jobs[idx].state = JOB_QUEUED;
+    heap_sift_up(pos);
+}
+
+static void heap_remove(int pos)
+{
+    const int idx = s_heap[pos];
+    const int last = --s_heap_len;
+    if (pos != last) {
+        heap_swap(pos, last);
+        heap_sift_down(pos);
+        heap_sift_up(pos);
+    }
+    s_jobs[idx].heap_pos = NOT_QUEUED;
+}
+
+// ───────────────────────────────────────────────────────
+// Tarea
+
+/**
+ * @brief Despierta la tarea si el trabajo `idx` quedó como el próximo a vencer
+ */
+static void wake_if_first_locked(int idx, bool *wake)
+{
+    if (s_jobs[idx].heap_pos == 0) {
+        *wake = true;
+    }
+}
+
+static void sched_task(void *arg)
+{
+    (void)arg;
+    for (;;) {
+        TickType_t wait = portMAX_DELAY;
+        int idx = NOT_QUEUED;
+        int64_t late_us = 0;
+
+        portENTER_CRITICAL(&s_lock);
+        if (s_heap_len > 0) {
+            const int64_t now = esp_timer_get_time();
+            const int64_t due = s_jobs[s_heap[0]].due_us;
+            if (due <= now) {
+                idx = s_heap[0];
+                heap_remove(0);
+                s_jobs[idx].state = JOB_RUNNING;
+                s_jobs[idx].rearm = false;
+                s_jobs[idx].disarm = false;
+                late_us = now - due;
+            } else {
+                // Redondear hacia arriba: despertar antes de tiempo solo costaría otra vuelta
+                wait = (TickType_t)((due - now + portTICK_PERIOD_MS * 1000 - 1) / (portTICK_PERIOD_MS * 1000));
+            }
+        }
+        portEXIT_CRITICAL(&s_lock);
+
+        if (idx == NOT_QUEUED) {
+            ulTaskNotifyTake(pdTRUE, wait);
+            s_stats.wakeups++;
+            continue;
+        }
+
+        struct sched_job *job = &s_jobs[idx];
+        const int64_t start = esp_timer_get_time();
+        job->fn(job->ctx);
+        const int64_t end = esp_timer_get_time();
+
+        portENTER_CRITICAL(&s_lock);
+        const uint32_t run_us = (uint32_t)(end - start);
+        job->stats.runs++;
+        job->stats.total_run_us += run_us;
+        if (run_us > job->stats.max_run_us) {
+            job->stats.max_run_us = run_us;
+        }
+        if (late_us > job->stats.max_late_us) {
+            job->stats.max_late_us = (uint32_t)late_us;
+        }
+        if (late_us > s_stats.max_late_us) {
+            s_stats.max_late_us = (uint32_t)late_us;
+        }
+        s_stats.runs++;
+
+        if (job->cancel) {
+            memset(job, 0, sizeof(*job));
+            job->heap_pos = NOT_QUEUED;
+            s_stats.jobs--;
+        } else if (job->rearm) {
+            heap_push(idx);             // due_us ya fijado por sched_trigger()
+        } else if (job->period_ms && !job->disarm) {
+            const int64_t period_us = (int64_t)job->period_ms * 1000;
+            job->due_us += period_us;
+            if (job->due_us <= end) {
+                // Atraso de más de un periodo: retomar la fase desde ahora
+                const int64_t missed = (end - job->due_us) / period_us + 1;
+                job->stats.overruns += (uint32_t)missed;
+                job->due_us += missed * period_us;
+            }
+            heap_push(idx);
+        } else {
+            job->state = JOB_IDLE;
+        }
+        portEXIT_CRITICAL(&s_lock);
+    }
+}
+
+// ───────────────────────────────────────────────────────
+// Métricas
+
+static void sched_metrics(metrics_writer_t *w, void *ctx)
+{
+    (void)ctx;
+    sched_stats_t st;
+    sched_get_stats(&st);
+    metrics_write_uint(w, "sched_jobs", NULL, st.jobs);
+    metrics_write_uint(w, "sched_runs_total", NULL, st.runs);
+    metrics_write_uint(w, "sched_wakeups_total", NULL, st.wakeups);
+    metrics_write_uint(w, "sched_late_max_us", NULL, st.max_late_us);
+    metrics_write_uint(w, "sched_stack_free_min_bytes", NULL, st.stack_free_min);
+    metrics_write_uint(w, "system_tasks", NULL, uxTaskGetNumberOfTasks());
+
+    sched_job_stats_t jobs[SCHED_MAX_JOBS];
+    const size_t n = sched_get_job_stats(jobs, SCHED_MAX_JOBS);
+    char labels[40];
+    for (size_t i = 0; i < n; i++) {
+        snprintf(labels, sizeof(labels), "job=\"%s\"", jobs[i].name);
+        metrics_write_uint(w, "sched_job_runs_total", labels, jobs[i].runs);
+        metrics_write_uint(w, "sched_job_overruns_total", labels, jobs[i].overruns);
+        metrics_write_uint(w, "sched_job_run_max_us", labels, jobs[i].max_run_us);
+        metrics_write_uint(w, "sched_job_late_max_us", labels, jobs[i].max_late_us);
+    }
+}
+
+// ───────────────────────────────────────────────────────
+// API pública
+
+esp_err_t sched_init(void)
+{
+    if (s_task != NULL) {
+        return ESP_OK;
+    }
+    for (int i = 0; i < SCHED_MAX_JOBS; i++) {
+        s_jobs[i].heap_pos = NOT_QUEUED;
+    }
+    s_task = xTaskCreateStatic(sched_task, "Sched", MEM_STACK_SCHED, NULL, SCHED_TASK_PRIORITY,
+                               s_task_stack, &s_task_tcb);
+    mem_budget_claim(MEM_MOD_SCHED, MEM_REGION_INTERNAL, sizeof(s_task_stack) + sizeof(s_task_tcb));
+    metrics_register("sched", sched_metrics, NULL);
+    return ESP_OK;
+}
+
+esp_err_t sched_add(const char *name, sched_fn_t fn, void *ctx, uint32_t delay_ms,
+                    uint32_t period_ms, sched_job_handle_t *out)
+{
+    if (name == NULL || fn == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_task == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    bool wake = false;
+    esp_err_t ret = ESP_ERR_NO_MEM;
+    portENTER_CRITICAL(&s_lock);
+    for (int i = 0; i < SCHED_MAX_JOBS; i++) {
+        struct sched_job *job = &s_jobs[i];
+        if (job->state != JOB_FREE) {
+            continue;
+        }
+        job->name = name;
+        job->fn = fn;
+        job->ctx = ctx;
+        job->period_ms = period_ms;
+        job->cancel = false;
+        job->stats.name = name;
+        job->stats.period_ms = period_ms;
+        if (delay_ms == SCHED_DISARMED) {
+            job->state = JOB_IDLE;
+        } else {
+            job->due_us = esp_timer_get_time() + (int64_t)delay_ms * 1000;
+            heap_push(i);
+            wake_if_first_locked(i, &wake);
+        }
+        s_stats.jobs++;
+        if (out) {
+            *out = job;
+        }
+        ret = ESP_OK;
+        break;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    if (wake) {
+        xTaskNotifyGive(s_task);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Sin espacio para el trabajo '%s'", name);
+    }
+    return ret;
+}
+
+esp_err_t sched_trigger(sched_job_handle_t job, uint32_t delay_ms)
+{
+    if (job == NULL || delay_ms == SCHED_DISARMED) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    bool wake = false;
+    esp_err_t ret = ESP_OK;
+    const int idx = job - s_jobs;
+    portENTER_CRITICAL(&s_lock);
+    if (job->state == JOB_FREE || job->cancel) {
+        ret = ESP_ERR_INVALID_STATE;
+    } else {
+        job->due_us = esp_timer_get_time() + (int64_t)delay_ms * 1000;
+        if (job->state == JOB_QUEUED) {
+            heap_sift_up(job->heap_pos);
+            heap_sift_down(job->heap_pos);
+        } else if (job->state == JOB_IDLE) {
+            heap_push(idx);
+        } else {
+            job->rearm = true;      // Se reinserta al terminar la ejecución en curso
+            job->disarm = false;
+        }
+        if (job->state == JOB_QUEUED) {
+            wake_if_first_locked(idx, &wake);
+        }
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    if (wake) {
+        xTaskNotifyGive(s_task);
+    }
+    return ret;
+}
+
+esp_err_t sched_set_period(sched_job_handle_t job, uint32_t period_ms)
+{
+    if (job == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = ESP_OK;
+    portENTER_CRITICAL(&s_lock);
+    if (job->state == JOB_FREE || job->cancel) {
+        ret = ESP_ERR_INVALID_STATE;
+    } else {
+        job->period_ms = period_ms;
+        job->stats.period_ms = period_ms;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return ret;
+}
+
+esp_err_t sched_disarm(sched_job_handle_t job)
+{
+    if (job == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = ESP_OK;
+    portENTER_CRITICAL(&s_lock);
+    if (job->state == JOB_FREE) {
+        ret = ESP_ERR_INVALID_STATE;
+    } else if (job->state == JOB_QUEUED) {
+        heap_remove(job->heap_pos);
+        job->state = JOB_IDLE;
+    } else if (job->state == JOB_RUNNING) {
+        job->rearm = false;
+        job->disarm = true;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return ret;
+}
+
+esp_err_t sched_cancel(sched_job_handle_t job)
+{
+    if (job == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = ESP_OK;
+    portENTER_CRITICAL(&s_lock);
+    if (job->state == JOB_FREE) {
+        ret = ESP_ERR_INVALID_STATE;
+    } else if (job->state == JOB_RUNNING) {
+        job->cancel = true;
+    } else {
+        if (job->state == JOB_QUEUED) {
+            heap_remove(job->heap_pos);
+        }
+        memset(job, 0, sizeof(*job));
+        job->heap_pos = NOT_QUEUED;
+        s_stats.jobs--;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return ret;
+}
+
+void sched_get_stats(sched_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    portENTER_CRITICAL(&s_lock);
+    *stats = s_stats;
+    portEXIT_CRITICAL(&s_lock);
+    if (s_task != NULL) {
+        stats->stack_free_min = uxTaskGetStackHighWaterMark(s_task) * sizeof(StackType_t);
+    }
+}
+
+size_t sched_get_job_stats(sched_job_stats_t *out, size_t max)
+{
+    if (out == NULL) {
+        return 0;
+    }
+    size_t n = 0;
+    portENTER_CRITICAL(&s_lock);
+    for (int i = 0; i < SCHED_MAX_JOBS && n < max; i++) {
+        if (s_jobs[i].state != JOB_FREE) {
+            out[n++] = s_jobs[i].stats;
+        }
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return n;
+}
+
+void sched_log_report(void)
+{
+    sched_stats_t st;
+    sched_get_stats(&st);
+    ESP_LOGI(TAG, "=== Planificador: %lu trabajos, %lu ejecuciones, %lu despertares, atraso máx %lu us ===",
+             (unsigned long)st.jobs, (unsigned long)st.runs, (unsigned long)st.wakeups,
+             (unsigned long)st.max_late_us);
+    ESP_LOGI(TAG, "Tareas del sistema: %u, pila libre mínima del planificador: %lu B",
+             (unsigned)uxTaskGetNumberOfTasks(), (unsigned long)st.stack_free_min);
+
+    sched_job_stats_t jobs[SCHED_MAX_JOBS];
+    const size_t n = sched_get_job_stats(jobs, SCHED_MAX_JOBS);
+    for (size_t i = 0; i < n; i++) {
+        const sched_job_stats_t *j = &jobs[i];
+        ESP_LOGI(TAG, "%-14s periodo %6lu ms  %6lu ejec.  media %6lu us  máx %6lu us  atraso máx %6lu us  desbordes %lu",
+                 j->name, (unsigned long)j->period_ms, (unsigned long)j->runs,
+                 (unsigned long)(j->runs ? j->total_run_us / j->runs : 0), (unsigned long)j->max_run_us,
+                 (unsigned long)j->max_late_us, (unsigned long)j->overruns);
+    }
+}
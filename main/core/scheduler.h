@@ -0,0 +1,137 @@
+/**
+ * @file scheduler.h
+ * @brief Planificador cooperativo de trabajos periódicos y diferidos.
+ * @details Agrupa en una sola tarea el trabajo que no es de tiempo real (lectura del
+ *          sensor, difusión WebSocket, estadísticas, guardado de la hora, telemetría BLE,
+ *          reintentos de escaneo, autotuning) en lugar de una tarea o un `esp_timer` por
+ *          módulo. Los trabajos se ordenan en un montículo mínimo por instante de
+ *          vencimiento y se ejecutan de uno en uno hasta terminar, por lo que un trabajo
+ *          no debe bloquear más de lo imprescindible.
+ *
+ *          Los trabajos periódicos mantienen su fase (el siguiente vencimiento se calcula
+ *          desde el anterior, no desde el fin de la ejecución); si uno se atrasa más de un
+ *          periodo se omiten las ejecuciones perdidas y se cuenta un desborde.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SCHED_MAX_JOBS      24              ///< Trabajos registrados simultáneamente
+#define SCHED_DISARMED      UINT32_MAX      ///< Retardo para registrar un trabajo sin armarlo
+
+/**
+ * @brief Función de un trabajo
+ * @param ctx Contexto indicado al registrarlo
+ */
+typedef void (*sched_fn_t)(void *ctx);
+
+/**
+ * @brief Identificador de un trabajo registrado
+ */
+typedef struct sched_job *sched_job_handle_t;
+
+/**
+ * @brief Estadísticas de un trabajo
+ */
+typedef struct {
+    const char *name;           ///< Nombre del trabajo
+    uint32_t period_ms;         ///< Periodo (0 si es de una sola vez)
+    uint32_t runs;              ///< Ejecuciones
+    uint32_t overruns;          ///< Ejecuciones perdidas por atraso
+    uint32_t max_run_us;        ///< Duración máxima de una ejecución
+    uint64_t total_run_us;      ///< Tiempo total de ejecución
+    uint32_t max_late_us;       ///< Atraso máximo respecto al vencimiento
+} sched_job_stats_t;
+
+/**
+ * @brief Estadísticas del planificador
+ */
+typedef struct {
+    uint32_t jobs;              ///< Trabajos registrados
+    uint32_t runs;              ///< Ejecuciones totales
+    uint32_t wakeups;           ///< Veces que la tarea despertó
+    uint32_t max_late_us;       ///< Atraso máximo de cualquier trabajo
+    uint32_t stack_free_min;    ///< Mínimo de pila libre de la tarea (bytes)
+} sched_stats_t;
+
+/**
+ * @brief Crea la tarea del planificador
+ * @return ESP_OK si quedó en marcha (también si ya lo estaba)
+ */
+esp_err_t sched_init(void);
+
+/**
+ * @brief Registra un trabajo
+ * @param name Nombre (cadena estática, para estadísticas y log)
+ * @param fn Función a ejecutar
+ * @param ctx Contexto para `fn`
+ * @param delay_ms Retardo hasta la primera ejecución (SCHED_DISARMED para no armarlo)
+ * @param period_ms Periodo; 0 para un trabajo de una sola vez
+ * @param[out] out Identificador del trabajo (puede ser NULL)
+ * @return ESP_OK, ESP_ERR_NO_MEM si no quedan entradas, ESP_ERR_INVALID_STATE sin sched_init()
+ */
+esp_err_t sched_add(const char *name, sched_fn_t fn, void *ctx, uint32_t delay_ms,
+                    uint32_t period_ms, sched_job_handle_t *out);
+
+/**
+ * @brief Arma (o rearma) un trabajo para que venza dentro de `delay_ms`
+ * @details Un trabajo periódico continúa con su periodo a partir de ese instante.
+ *          Se puede llamar desde el propio trabajo.
+ */
+esp_err_t sched_trigger(sched_job_handle_t job, uint32_t delay_ms);
+
+/**
+ * @brief Cambia el periodo de un trabajo
+ * @details Rige a partir de la próxima ejecución; sched_trigger() adelanta la primera.
+ * @param period_ms Nuevo periodo; 0 lo vuelve de una sola vez
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, o ESP_ERR_INVALID_STATE si el trabajo no existe
+ */
+esp_err_t sched_set_period(sched_job_handle_t job, uint32_t period_ms);
+
+/**
+ * @brief Desarma un trabajo sin eliminarlo; sched_trigger() lo vuelve a armar
+ */
+esp_err_t sched_disarm(sched_job_handle_t job);
+
+/**
+ * @brief Elimina un trabajo
+ * @details Si está en ejecución, esa ejecución termina y el trabajo ya no se vuelve a
+ *          ejecutar. Se puede llamar desde el propio trabajo.
+ */
+esp_err_t sched_cancel(sched_job_handle_t job);
+
+/**
+ * @brief Obtiene las estadísticas globales
+ */
+void sched_get_stats(sched_stats_t *stats);
+
+/**
+ * @brief Obtiene las estadísticas de los trabajos registrados
+ * @param out Arreglo de salida
+ * @param max Capacidad de `out`
+ * @return Número de trabajos copiados
+ */
+size_t sched_get_job_stats(sched_job_stats_t *out, size_t max);
+
+/**
+ * @brief Imprime en el log los trabajos, sus tiempos y el número de tareas del sistema
+ */
+void sched_log_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SCHEDULER_H
@@ -0,0 +1,564 @@
+/**
+ * @file serial_console.c
+ * @brief Implementación de la consola serie.
+ * @details Los comandos corren en la tarea del REPL. Las lecturas (perfilador, métricas,
+ *          trazador) usan las mismas funciones que el servidor web; las órdenes al PID pasan
+ *          por su cola como cualquier otro origen, y los cambios de periodo usan las API de
+ *          sensor.h y PID_CMD_SET_SAMPLE_TIME.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#include "serial_console.h"
+#include "sdkconfig.h"
+
+#if CONFIG_SERIAL_CONSOLE_ENABLE
+
+#include "bench.h"
+#include "metrics.h"
+#include "profiler.h"
+#include "tracer.h"
+#include "sensor.h"
+#include "pid_controller.h"
+#include "config_store.h"
+#include "mem_budget.h"
+#include "alloc_prof.h"
+#include "esp_console.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "mbedtls/base64.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+static const char *TAG = "CONSOLE";
+
+#define CONSOLE_PROMPT          "tripta>"
+#define CONSOLE_TASK_STACK      6144    ///< bench y metrics formatean en la pila del REPL
+#define CONSOLE_METRICS_BUF     8192    ///< Primer intento de metrics_render()
+#define CONSOLE_PID_TIMEOUT_MS  100     ///< Espera si la cola del PID está llena
+#define CONSOLE_B64_LINE        48      ///< Bytes por línea del volcado (64 caracteres base64)
+
+// ───────────────────────────────────────────────────────
+// Utilidades
+
+static bool parse_u32(const char *s, uint32_t *out)
+{
+    char *end;
+    errno = 0;
+    const unsigned long v = strtoul(s, &end, 10);
+    if (errno != 0 || end == s || *end != '\0' || v > UINT32_MAX) {
+        return false;
+    }
+    *out = (uint32_t)v;
+    return true;
+}
+
+static bool parse_float(const char *s, float *out)
+{
+    char *end;
+    errno = 0;
+    const float v = strtof(s, &end);
+    if (errno != 0 || end == s || *end != '\0') {
+        return false;
+    }
+    *out = v;
+    return true;
+}
+
+static int report(esp_err_t err)
+{
+    if (err != ESP_OK) {
+        printf("error: %s\n", esp_err_to_name(err));
+        return 1;
+    }
+    printf("ok\n");
+    return 0;
+}
+
+// ───────────────────────────────────────────────────────
+// tasks, heap, metrics
+
+static int cmd_tasks(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+    // La instantánea pesa unos 2 KB: fuera de la pila del REPL
+    profiler_snapshot_t *snap = malloc(sizeof(*snap));
+    if (snap == NULL) {
+        return report(ESP_ERR_NO_MEM);
+    }
+    esp_err_t err = profiler_get_snapshot(snap);
+    if (err != ESP_OK) {
+        free(snap);
+        return report(err);
+    }
+    printf("ventana %lu ms, carga core0 %.1f%% core1 %.1f%%, %lu tareas\n",
+           (unsigned long)(snap->window_us / 1000), snap->core_load_pct[0], snap->core_load_pct[1],
+           (unsigned long)snap->tasks_total);
+    printf("%-16s %4s %4s %7s %10s\n", "tarea", "core", "prio", "cpu%", "pila_min");
+    for (size_t i = 0; i < snap->task_count; i++) {
+        const profiler_task_t *t = &snap->tasks[i];
+        char core[4];
+        if (t->core == PROFILER_CORE_ANY) {
+            strcpy(core, "-");
+        } else {
+            snprintf(core, sizeof(core), "%u", t->core);
+        }
+        printf("%-16s %4s %4u %7.2f %10lu%s\n", t->name, core, t->priority, t->cpu_pct,
+               (unsigned long)t->stack_free_min, t->stack_low ? " !" : "");
+    }
+    free(snap);
+    return 0;
+}
+
+static int cmd_heap(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+    static const struct {
+        const char *name;
+        uint32_t caps;
+    } regions[] = {
+        { "internal", MALLOC_CAP_INTERNAL },
+        { "psram",    MALLOC_CAP_SPIRAM },
+        { "dma",      MALLOC_CAP_DMA },
+    };
+    printf("%-9s %10s %10s %10s\n", "region", "libre", "minimo", "bloque_max");
+    for (size_t i = 0; i < sizeof(regions) / sizeof(regions[0]); i++) {
+        printf("%-9s %10u %10u %10u\n", regions[i].name,
+               (unsigned)heap_caps_get_free_size(regions[i].caps),
+               (unsigned)heap_caps_get_minimum_free_size(regions[i].caps),
+               (unsigned)heap_caps_get_largest_free_block(regions[i].caps));
+    }
+
+    printf("\n%-9s %-8s %10s %10s %10s %10s\n", "modulo", "subsist", "interna", "presup", "psram", "presup");
+    for (int m = 0; m < MEM_MOD_COUNT; m++) {
+        mem_budget_entry_t e;
+        mem_budget_get((mem_module_t)m, &e);
+        printf("%-9s %-8s %10lu %10lu %10lu %10lu\n", e.name, e.subsystem,
+               (unsigned long)e.used[MEM_REGION_INTERNAL], (unsigned long)e.budget[MEM_REGION_INTERNAL],
+               (unsigned long)e.used[MEM_REGION_PSRAM], (unsigned long)e.budget[MEM_REGION_PSRAM]);
+    }
+    return 0;
+}
+
+static int cmd_metrics(int argc, char **argv)
+{
+    const char *filter = argc > 1 ? argv[1] : NULL;
+    size_t size = CONSOLE_METRICS_BUF;
+    char *buf = malloc(size);
+    if (buf == NULL) {
+        return report(ESP_ERR_NO_MEM);
+    }
+    size_t needed = metrics_render(buf, size, filter);
+    if (needed >= size) {
+        size = needed + 1;
+        char *bigger = realloc(buf, size);
+        if (bigger == NULL) {
+            free(buf);
+            return report(ESP_ERR_NO_MEM);
+        }
+        buf = bigger;
+        metrics_render(buf, size, filter);
+    }
+    fputs(buf, stdout);
+    free(buf);
+    return 0;
+}
+
+// ───────────────────────────────────────────────────────
+// bench
+
+static int run_bench(const char *name, uint32_t iterations, uint32_t repeats)
+{
+    bench_result_t res;
+    esp_err_t err = bench_run(name, iterations, repeats, &res);
+    if (err != ESP_OK) {
+        printf("BENCH {\"bench\":\"%s\",\"error\":\"%s\"}\n", name, esp_err_to_name(err));
+        return 1;
+    }
+    char line[320];
+    bench_format_json(&res, line, sizeof(line));
+    printf("BENCH %s\n", line);
+    return 0;
+}
+
+static int cmd_bench(int argc, char **argv)
+{
+    const char *name = "all";
+    uint32_t iterations = 0;
+    uint32_t repeats = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            if (!parse_u32(argv[++i], &iterations) || iterations == 0) {
+                printf("error: -n espera un entero positivo\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            if (!parse_u32(argv[++i], &repeats) || repeats == 0 || repeats > BENCH_MAX_REPEATS) {
+                printf("error: -r espera un entero entre 1 y %d\n", BENCH_MAX_REPEATS);
+                return 1;
+            }
+        } else {
+            name = argv[i];
+        }
+    }
+
+    if (strcmp(name, "list") == 0) {
+        for (size_t i = 0; i < bench_count(); i++) {
+            printf("%-12s %lu\n", bench_name(i), (unsigned long)bench_default_iterations(i));
+        }
+        return 0;
+    }
+    if (strcmp(name, "all") != 0) {
+        return run_bench(name, iterations, repeats);
+    }
+    int failed = 0;
+    for (size_t i = 0; i < bench_count(); i++) {
+        failed |= run_bench(bench_name(i), iterations, repeats);
+    }
+    return failed;
+}
+
+// ───────────────────────────────────────────────────────
+// trace
+
+/**
+ * @brief Estado del volcado en base64 (líneas de CONSOLE_B64_LINE bytes)
+ */
+typedef struct {
+    uint8_t pending[CONSOLE_B64_LINE];
+    size_t len;
+    size_t total;
+} b64_writer_t;
+
+static void b64_flush(b64_writer_t *w)
+{
+    unsigned char out[((CONSOLE_B64_LINE + 2) / 3) * 4 + 1];
+    size_t olen = 0;
+    if (w->len && mbedtls_base64_encode(out, sizeof(out), &olen, w->pending, w->len) == 0) {
+        printf("%.*s\n", (int)olen, (const char *)out);
+    }
+    w->len = 0;
+}
+
+static esp_err_t b64_write(const void *data, size_t len, void *ctx)
+{
+    b64_writer_t *w = ctx;
+    const uint8_t *p = data;
+    w->total += len;
+    while (len) {
+        const size_t n = len < CONSOLE_B64_LINE - w->len ? len : CONSOLE_B64_LINE - w->len;
+        memcpy(&w->pending[w->len], p, n);
+        w->len += n;
+        p += n;
+        len -= n;
+        if (w->len == CONSOLE_B64_LINE) {
+            b64_flush(w);
+        }
+    }
+    return ESP_OK;
+}
+
+static bool parse_trace_classes(const char *list, uint32_t *mask)
+{
+    static const struct {
+        const char *name;
+        uint32_t cls;
+    } classes[] = {
+        { "task",  TRACER_CLASS_TASK },
+        { "queue", TRACER_CLASS_QUEUE },
+        { "isr",   TRACER_CLASS_ISR },
+        { "mark",  TRACER_CLASS_MARK },
+        { "all",   TRACER_CLASS_ALL },
+    };
+    *mask = 0;
+    while (*list) {
+        const char *comma = strchr(list, ',');
+        const size_t len = comma ? (size_t)(comma - list) : strlen(list);
+        bool found = false;
+        for (size_t i = 0; i < sizeof(classes) / sizeof(classes[0]); i++) {
+            if (strlen(classes[i].name) == len && strncasecmp(list, classes[i].name, len) == 0) {
+                *mask |= classes[i].cls;
+                found = true;
+            }
+        }
+        if (!found) {
+            return false;
+        }
+        list += len + (comma ? 1 : 0);
+    }
+    return *mask != 0;
+}
+
+static int cmd_trace(int argc, char **argv)
+{
+    const char *sub = argc > 1 ? argv[1] : "status";
+
+    if (strcmp(sub, "start") == 0) {
+        uint32_t mask = TRACER_CLASS_ALL;
+        if (argc > 2 && !parse_trace_classes(argv[2], &mask)) {
+            printf("error: clases válidas: task,queue,isr,mark,all\n");
+            return 1;
+        }
+        tracer_start(mask);
+    } else if (strcmp(sub, "stop") == 0) {
+        tracer_stop();
+    } else if (strcmp(sub, "dump") == 0) {
+        b64_writer_t w = { .len = 0, .total = 0 };
+        printf("TRACE-BEGIN\n");
+        esp_err_t err = tracer_dump(b64_write, &w);
+        b64_flush(&w);
+        printf("TRACE-END %u\n", (unsigned)w.total);
+        return err == ESP_OK ? 0 : report(err);
+    } else if (strcmp(sub, "status") != 0) {
+        printf("uso: trace start [clases]|stop|status|dump\n");
+        return 1;
+    }
+
+    tracer_stats_t st;
+    tracer_get_stats(&st);
+    printf("mascara 0x%02lx, capacidad %lu por núcleo, escritos %lu/%lu\n",
+           (unsigned long)st.mask, (unsigned long)st.capacity,
+           (unsigned long)st.written[0], (unsigned long)st.written[1]);
+    return 0;
+}
+
+// ───────────────────────────────────────────────────────
+// rate y pid
+
+static esp_err_t set_pid_sample_time(uint32_t ms)
+{
+    const pid_cmd_t cmd = { .type = PID_CMD_SET_SAMPLE_TIME, .source = PID_SRC_CONSOLE,
+                            .sample_time_ms = ms };
+    return pid_submit_wait(&cmd, CONSOLE_PID_TIMEOUT_MS);
+}
+
+static int cmd_rate(int argc, char **argv)
+{
+    if ((argc - 1) % 2 != 0) {
+        printf("uso: rate [poll <ms>] [pid <ms>]\n");
+        return 1;
+    }
+    for (int i = 1; i + 1 < argc; i += 2) {
+        uint32_t ms;
+        if (!parse_u32(argv[i + 1], &ms)) {
+            printf("error: periodo inválido '%s'\n", argv[i + 1]);
+            return 1;
+        }
+        esp_err_t err;
+        if (strcmp(argv[i], "poll") == 0) {
+            err = sensor_set_poll_period(ms);
+        } else if (strcmp(argv[i], "pid") == 0) {
+            err = set_pid_sample_time(ms);
+        } else {
+            printf("error: '%s' no es poll ni pid\n", argv[i]);
+            return 1;
+        }
+        if (err != ESP_OK) {
+            printf("error: %s %lu ms: %s\n", argv[i], (unsigned long)ms, esp_err_to_name(err));
+            return 1;
+        }
+    }
+    printf("poll %lu ms, pid %lu ms\n", (unsigned long)sensor_get_poll_period(),
+           (unsigned long)pid_get_sample_time_ms());
+    return 0;
+}
+
+static int cmd_pid(int argc, char **argv)
+{
+    const char *sub = argc > 1 ? argv[1] : "status";
+    pid_cmd_t cmd = { .source = PID_SRC_CONSOLE };
+
+    if (strcmp(sub, "status") == 0) {
+        printf("%s, setpoint %.2f °C, salida %.1f%%, ssr %s, alarmas 0x%lx, periodo %lu ms\n",
+               pid_is_enabled() ? "activo" : "inactivo", pid_get_setpoint(), pid_get_output(),
+               pid_ssr_status() ? "on" : "off", (unsigned long)pid_get_alarms(),
+               (unsigned long)pid_get_sample_time_ms());
+        return 0;
+    } else if (strcmp(sub, "on") == 0) {
+        cmd.type = PID_CMD_ENABLE;
+    } else if (strcmp(sub, "off") == 0) {
+        cmd.type = PID_CMD_DISABLE;
+    } else if (strcmp(sub, "sp") == 0 && argc == 3 && parse_float(argv[2], &cmd.setpoint)) {
+        cmd.type = PID_CMD_SET_SETPOINT;
+    } else if (strcmp(sub, "gains") == 0 && argc == 5 && parse_float(argv[2], &cmd.gains.kp) &&
+               parse_float(argv[3], &cmd.gains.ki) && parse_float(argv[4], &cmd.gains.kd)) {
+        cmd.type = PID_CMD_SET_PARAMS;
+    } else {
+        printf("uso: pid on|off|sp <°C>|gains <kp> <ki> <kd>|status\n");
+        return 1;
+    }
+    return report(pid_submit_wait(&cmd, CONSOLE_PID_TIMEOUT_MS));
+}
+
+// ───────────────────────────────────────────────────────
+// config
+
+static void print_cfg_value(cfg_type_t type, cfg_value_t v)
+{
+    if (type == CFG_TYPE_U32) {
+        printf("%lu", (unsigned long)v.u32);
+    } else {
+        printf("%g", v.f);
+    }
+}
+
+static int cmd_config(int argc, char **argv)
+{
+    const char *sub = argc > 1 ? argv[1] : "list";
+
+    if (strcmp(sub, "set") == 0 && argc == 4) {
+        esp_err_t err = cfg_set_from_string(argv[2], argv[3]);
+        return report(err);
+    } else if (strcmp(sub, "save") == 0) {
+        return report(cfg_flush());
+    } else if (strcmp(sub, "stats") == 0) {
+        cfg_stats_t st;
+        cfg_get_stats(&st);
+        printf("carga %lu us, nvs: %lu aperturas, %lu lecturas, %lu escrituras, %lu commits; "
+               "%lu cambios, %lu rechazados, %lu guardados evitados%s\n",
+               (unsigned long)st.load_us, (unsigned long)st.nvs_opens, (unsigned long)st.nvs_reads,
+               (unsigned long)st.nvs_writes, (unsigned long)st.nvs_commits, (unsigned long)st.changes,
+               (unsigned long)st.rejected, (unsigned long)st.saves_skipped,
+               st.migrated ? ", migrado de pid_params" : "");
+        return 0;
+    } else if (strcmp(sub, "list") != 0) {
+        printf("uso: config [list|set <clave> <valor>|save|stats]\n");
+        return 1;
+    }
+
+    for (int k = 0; k < CFG_KEY_COUNT; k++) {
+        const char *name;
+        cfg_type_t type;
+        cfg_value_t def, min, max;
+        cfg_describe(k, &name, &type, &def, &min, &max);
+        const cfg_value_t cur = type == CFG_TYPE_U32 ? (cfg_value_t){ .u32 = cfg_get_u32(k) }
+                                                     : (cfg_value_t){ .f = cfg_get_float(k) };
+        printf("%-16s ", name);
+        print_cfg_value(type, cur);
+        printf("  [");
+        print_cfg_value(type, min);
+        printf(" .. ");
+        print_cfg_value(type, max);
+        printf("] defecto ");
+        print_cfg_value(type, def);
+        printf("\n");
+    }
+    return 0;
+}
+
+static int cmd_alloc(int argc, char **argv)
+{
+    const char *sub = argc > 1 ? argv[1] : "report";
+
+    if (strcmp(sub, "reset") == 0) {
+        uint32_t warmup_s = 0;
+        if (argc > 2 && !parse_u32(argv[2], &warmup_s)) {
+            printf("uso: alloc reset [calentamiento_s]\n");
+            return 1;
+        }
+        alloc_prof_reset(warmup_s * 1000);
+        return 0;
+    } else if (strcmp(sub, "report") != 0) {
+        printf("uso: alloc [report|reset [calentamiento_s]]\n");
+        return 1;
+    }
+
+    alloc_prof_stats_t st;
+    alloc_prof_get_stats(&st);
+    if (st.window_ms == 0) {
+        printf("perfil de reservas desactivado (CONFIG_ALLOC_PROF_ENABLE)\n");
+        return 1;
+    }
+    printf("%s: %lu reservas en %lu ms, %.2f/s, %.2f por ciclo de control; +%lu -%lu bytes, "
+           "%lu liberaciones, ISR %lu, sin lugar %lu\n",
+           st.steady ? "regimen" : "calentamiento", (unsigned long)st.allocs, (unsigned long)st.window_ms,
+           st.allocs_per_s, st.allocs_per_cycle, (unsigned long)st.bytes_alloc, (unsigned long)st.bytes_freed,
+           (unsigned long)st.frees, (unsigned long)st.isr_allocs, (unsigned long)st.dropped);
+
+    alloc_prof_task_t tasks[ALLOC_PROF_MAX_TASKS];
+    const size_t nt = alloc_prof_get_tasks(tasks, ALLOC_PROF_MAX_TASKS);
+    for (size_t i = 0; i < nt; i++) {
+        printf("tarea %-16s %8lu %10lu\n", tasks[i].name, (unsigned long)tasks[i].allocs,
+               (unsigned long)tasks[i].bytes);
+    }
+    alloc_prof_site_t sites[ALLOC_PROF_MAX_SITES];
+    const size_t ns = alloc_prof_get_sites(sites, ALLOC_PROF_MAX_SITES);
+    for (size_t i = 0; i < ns; i++) {
+        printf("sitio 0x%08lx %-16s %8lu %10lu\n", (unsigned long)sites[i].caller, sites[i].task,
+               (unsigned long)sites[i].allocs, (unsigned long)sites[i].bytes);
+    }
+    return 0;
+}
+
+// ───────────────────────────────────────────────────────
+// Registro
+
+static const esp_console_cmd_t s_commands[] = {
+    { .command = "tasks", .help = "CPU, prioridad y pila mínima por tarea", .func = cmd_tasks },
+    { .command = "heap", .help = "Heap libre, mínimo y bloque mayor por región; uso de los presupuestos de memoria", .func = cmd_heap },
+    { .command = "metrics", .help = "Métricas (todas o de un proveedor: i2c, sensor, pid...)",
+      .hint = "[proveedor]", .func = cmd_metrics },
+    { .command = "bench", .help = "Micro-benchmarks; una línea BENCH {json} por prueba",
+      .hint = "[nombre|all|list] [-n iteraciones] [-r repeticiones]", .func = cmd_bench },
+    { .command = "trace", .help = "Trazador: iniciar, detener, estado o volcado en base64",
+      .hint = "start [task,queue,isr,mark]|stop|status|dump", .func = cmd_trace },
+    { .command = "rate", .help = "Periodo de lectura del sensor y del lazo PID",
+      .hint = "[poll <ms>] [pid <ms>]", .func = cmd_rate },
+    { .command = "pid", .help = "Órdenes al PID", .hint = "on|off|sp <°C>|gains <kp> <ki> <kd>|status",
+      .func = cmd_pid },
+    { .command = "config", .help = "Configuración persistente (config_store.h)",
+      .hint = "[list|set <clave> <valor>|save|stats]", .func = cmd_config },
+    { .command = "alloc", .help = "Perfil de reservas de heap: totales, tareas y sitios (addr2line)",
+      .hint = "[report|reset [calentamiento_s]]", .func = cmd_alloc },
+};
+
+esp_err_t serial_console_init(void)
+{
+    esp_console_repl_t *repl = NULL;
+    esp_console_repl_config_t repl_config = ESP_CONSOLE_REPL_CONFIG_DEFAULT();
+    repl_config.prompt = CONSOLE_PROMPT;
+    repl_config.task_stack_size = CONSOLE_TASK_STACK;
+
+    esp_err_t err;
+#if CONFIG_ESP_CONSOLE_UART_DEFAULT || CONFIG_ESP_CONSOLE_UART_CUSTOM
+    esp_console_dev_uart_config_t hw_config = ESP_CONSOLE_DEV_UART_CONFIG_DEFAULT();
+    err = esp_console_new_repl_uart(&hw_config, &repl_config, &repl);
+#elif CONFIG_ESP_CONSOLE_USB_CDC
+    esp_console_dev_usb_cdc_config_t hw_config = ESP_CONSOLE_DEV_CDC_CONFIG_DEFAULT();
+    err = esp_console_new_repl_usb_cdc(&hw_config, &repl_config, &repl);
+#elif CONFIG_ESP_CONSOLE_USB_SERIAL_JTAG
+    esp_console_dev_usb_serial_jtag_config_t hw_config = ESP_CONSOLE_DEV_USB_SERIAL_JTAG_CONFIG_DEFAULT();
+    err = esp_console_new_repl_usb_serial_jtag(&hw_config, &repl_config, &repl);
+#else
+    err = ESP_ERR_NOT_SUPPORTED;
+#endif
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "No se pudo crear el REPL: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    esp_console_register_help_command();
+    for (size_t i = 0; i < sizeof(s_commands) / sizeof(s_commands[0]); i++) {
+        err = esp_console_cmd_register(&s_commands[i]);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "No se pudo registrar '%s': %s", s_commands[i].command, esp_err_to_name(err));
+            return err;
+        }
+    }
+    return esp_console_start_repl(repl);
+}
+
+#else
+
+esp_err_t serial_console_init(void)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+#endif // CONFIG_SERIAL_CONSOLE_ENABLE
@@ -0,0 +1,47 @@
+/**
+ * @file serial_console.h
+ * @brief Consola interactiva por el puerto serie (UART, USB-CDC o USB-Serial-JTAG).
+ * @details Levanta un REPL de esp_console en el puerto elegido como consola del sistema
+ *          (CONFIG_ESP_CONSOLE_*) con el prompt `tripta>` y estos comandos:
+ *          - `tasks`: CPU, prioridad y pila mínima por tarea (última instantánea del perfilador);
+ *          - `heap`: libre, mínimo y bloque mayor de cada región de heap y uso de los
+ *            presupuestos por módulo (mem_budget.h);
+ *          - `metrics [proveedor]`: las mismas métricas que GET /metrics;
+ *          - `bench [nombre|all|list] [-n N] [-r R]`: micro-benchmarks (bench.h), una línea
+ *            `BENCH {json}` por prueba;
+ *          - `trace start [task,queue,isr,mark]|stop|status|dump`: control del trazador; el
+ *            volcado sale en base64 entre `TRACE-BEGIN` y `TRACE-END` y
+ *            tools/trace2perfetto.py lo acepta tal cual desde una captura de la consola;
+ *          - `rate [poll <ms>] [pid <ms>]`: periodo de lectura del sensor y del lazo PID;
+ *          - `pid on|off|sp <°C>|gains <kp> <ki> <kd>|status`: órdenes al PID (PID_SRC_CONSOLE);
+ *          - `config [list|set <clave> <valor>|save|stats]`: almacén de configuración;
+ *          - `alloc [report|reset [s]]`: perfil de reservas de heap (alloc_prof.h).
+ *
+ *          Las respuestas se escriben con printf(), no con ESP_LOG, para que no las filtre
+ *          el nivel de log ni la derivación remota (log_tap.h).
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#ifndef SERIAL_CONSOLE_H
+#define SERIAL_CONSOLE_H
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Registra los comandos y arranca la tarea del REPL
+ * @return ESP_OK, el error de esp_console, o ESP_ERR_NOT_SUPPORTED sin
+ *         CONFIG_SERIAL_CONSOLE_ENABLE o sin puerto de consola
+ */
+esp_err_t serial_console_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SERIAL_CONSOLE_H
@@ -8,12 +8,13 @@
  */
 
 #include "statistics.h"
+#include "hal_nvs.h"
 #include "esp_log.h"
-#include "nvs_flash.h"
-#include "nvs.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "esp_timer.h"
+#include "timebase.h"
+#include "scheduler.h"
+#include "event_bus.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -24,10 +25,12 @@
 // Variable global para almacenar las estadísticas
 static statistics_data_t g_stats = {0};
 static bool g_stats_initialized = false;
-static esp_timer_handle_t g_stats_timer = NULL;
+static sched_job_handle_t g_stats_job = NULL;
 
 // Prototipos de funciones privadas
 static void statistics_timer_callback(void* arg);
+static void statistics_on_ssr_edge(const evbus_event_t *ev, void *ctx);
+static void statistics_apply_ssr_state(bool ssr_active, uint64_t change_time);
 static esp_err_t statistics_save_single_value(const char* key, const void* value, size_t length);
 static esp_err_t statistics_load_single_value(const char* key, void* value, size_t* length);
 static uint64_t get_current_timestamp_ms(void);
@@ -38,11 +41,7 @@ esp_err_t statistics_init(void)
     ESP_LOGI(TAG, "Inicializando módulo de estadísticas");
 
     // Inicializar NVS si no está inicializado
-    esp_err_t ret = nvs_flash_init();
-    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
-        ESP_ERROR_CHECK(nvs_flash_erase());
-        ret = nvs_flash_init();
-    }
+    esp_err_t ret = hal_nvs_init();
     ESP_ERROR_CHECK(ret);
 
     // Cargar estadísticas desde NVS
@@ -52,23 +51,19 @@ esp_err_t statistics_init(void)
         memset(&g_stats, 0, sizeof(statistics_data_t));
     }
 
-    // Crear timer para actualización periódica
-    const esp_timer_create_args_t timer_args = {
-        .callback = &statistics_timer_callback,
-        .arg = NULL,
-        .name = "stats_timer"
-    };
-
-    ret = esp_timer_create(&timer_args, &g_stats_timer);
+    // Registrar la actualización periódica en el planificador
+    ret = sched_add("stats", statistics_timer_callback, NULL, STATS_UPDATE_PERIOD_MS,
+                    STATS_UPDATE_PERIOD_MS, &g_stats_job);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Error al crear timer de estadísticas: %s", esp_err_to_name(ret));
+        ESP_LOGE(TAG, "Error al registrar la actualización de estadísticas: %s", esp_err_to_name(ret));
         return ret;
     }
 
-    // Iniciar el timer
-    ret = esp_timer_start_periodic(g_stats_timer, STATS_UPDATE_PERIOD_MS * 1000); // microsegundos
+    // Flancos del SSR publicados por el PID; se procesan en la misma tarea que la actualización periódica
+    ret = evbus_subscribe("stats_ssr", EVBUS_MASK(EVBUS_SSR_EDGE), EVBUS_DEFAULT_DEPTH,
+                          statistics_on_ssr_edge, NULL);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Error al iniciar timer de estadísticas: %s", esp_err_to_name(ret));
+        ESP_LOGE(TAG, "Error al suscribirse a los flancos del SSR: %s", esp_err_to_name(ret));
         return ret;
     }
 
@@ -140,30 +135,7 @@ esp_err_t statistics_update_ssr_state(bool ssr_active)
         return ESP_ERR_INVALID_STATE;
     }
 
-    uint64_t current_time = get_current_timestamp_ms();
-
-    // Si hay un cambio de estado
-    if (g_stats.ssr_last_state != ssr_active) {
-        ESP_LOGD(TAG, "Cambio de estado SSR: %s -> %s", 
-                 g_stats.ssr_last_state ? "ON" : "OFF",
-                 ssr_active ? "ON" : "OFF");
-
-        // Si el SSR estaba activo, sumar el tiempo de calentamiento
-        if (g_stats.ssr_last_state && g_stats.ssr_last_change_time > 0) {
-            uint64_t heating_duration = (current_time - g_stats.ssr_last_change_time) / 1000;
-            g_stats.total_heating_time_seconds += heating_duration;
-        }
-
-        // Incrementar contador de ciclos si se activa el SSR
-        if (ssr_active) {
-            g_stats.ssr_cycle_count++;
-        }
-
-        // Actualizar estado y timestamp
-        g_stats.ssr_last_state = ssr_active;
-        g_stats.ssr_last_change_time = current_time;
-    }
-
+    statistics_apply_ssr_state(ssr_active, get_current_timestamp_ms());
     return ESP_OK;
 }
 
@@ -301,44 +273,86 @@ static void statistics_timer_callback(void* arg)
     statistics_periodic_update();
 }
 
+/**
+ * @brief Contabiliza un cambio de estado del SSR ocurrido en change_time (ms monotónicos)
+ */
+static void statistics_apply_ssr_state(bool ssr_active, uint64_t change_time)
+{
+    // Un flanco entregado tarde nunca retrocede respecto al último cambio contabilizado
+    if (change_time < g_stats.ssr_last_change_time) {
+        change_time = g_stats.ssr_last_change_time;
+    }
+
+    // Si hay un cambio de estado
+    if (g_stats.ssr_last_state != ssr_active) {
+        ESP_LOGD(TAG, "Cambio de estado SSR: %s -> %s", 
+                 g_stats.ssr_last_state ? "ON" : "OFF",
+                 ssr_active ? "ON" : "OFF");
+
+        // Si el SSR estaba activo, sumar el tiempo de calentamiento
+        if (g_stats.ssr_last_state && g_stats.ssr_last_change_time > 0) {
+            uint64_t heating_duration = (change_time - g_stats.ssr_last_change_time) / 1000;
+            g_stats.total_heating_time_seconds += heating_duration;
+        }
+
+        // Incrementar contador de ciclos si se activa el SSR
+        if (ssr_active) {
+            g_stats.ssr_cycle_count++;
+        }
+
+        // Actualizar estado y timestamp
+        g_stats.ssr_last_state = ssr_active;
+        g_stats.ssr_last_change_time = change_time;
+    }
+}
+
+static void statistics_on_ssr_edge(const evbus_event_t *ev, void *ctx)
+{
+    // El flanco cuenta en el instante de publicación, no en el de entrega
+    if (g_stats_initialized) {
+        statistics_apply_ssr_state(ev->ssr.on, (uint64_t)(ev->t_us / 1000));
+    }
+}
+
 static esp_err_t statistics_save_single_value(const char* key, const void* value, size_t length)
 {
-    nvs_handle_t nvs_handle;
+    hal_nvs_handle_t nvs_handle;
     esp_err_t ret;
 
-    ret = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+    ret = hal_nvs_open(NVS_NAMESPACE, HAL_NVS_READWRITE, &nvs_handle);
     if (ret != ESP_OK) {
         return ret;
     }
 
-    ret = nvs_set_blob(nvs_handle, key, value, length);
+    ret = hal_nvs_set_blob(nvs_handle, key, value, length);
     if (ret == ESP_OK) {
-        ret = nvs_commit(nvs_handle);
+        ret = hal_nvs_commit(nvs_handle);
     }
 
-    nvs_close(nvs_handle);
+    hal_nvs_close(nvs_handle);
     return ret;
 }
 
 static esp_err_t statistics_load_single_value(const char* key, void* value, size_t* length)
 {
-    nvs_handle_t nvs_handle;
+    hal_nvs_handle_t nvs_handle;
     esp_err_t ret;
 
-    ret = nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs_handle);
+    ret = hal_nvs_open(NVS_NAMESPACE, HAL_NVS_READONLY, &nvs_handle);
     if (ret != ESP_OK) {
         return ret;
     }
 
-    ret = nvs_get_blob(nvs_handle, key, value, length);
-    nvs_close(nvs_handle);
+    ret = hal_nvs_get_blob(nvs_handle, key, value, length);
+    hal_nvs_close(nvs_handle);
     
     return ret;
 }
 
 static uint64_t get_current_timestamp_ms(void)
 {
-    return esp_timer_get_time() / 1000; // Convertir de microsegundos a milisegundos
+    // Solo se usa para duraciones: reloj monotónico, inmune a ajustes de hora
+    return (uint64_t)timebase_mono_ms();
 }
 
 static void format_time_duration(uint64_t seconds, char* buffer, size_t buffer_size)
@@ -356,4 +370,16 @@ static void format_time_duration(uint64_t seconds, char* buffer, size_t buffer_s
     } else {
         snprintf(buffer, buffer_size, "%llus", (unsigned long long)remaining_seconds);
     }
-} 
\ No newline at end of file
+}
+
+size_t statistics_bench_format(uint32_t iterations)
+{
+    char buffer[sizeof(((statistics_formatted_t *)0)->total_operation_time)];
+    size_t len = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        // 0 s .. ~40 h: en su mayoría "Xh Ymin", el caso de un equipo en uso
+        format_time_duration((uint64_t)(i % 4000) * 37, buffer, sizeof(buffer));
+        len += strlen(buffer);
+    }
+    return len;
+}
@@ -70,7 +70,8 @@ esp_err_t statistics_end_session(void);
 
 /**
  * @brief Actualiza las estadísticas del SSR
- * @details Debe llamarse cada vez que cambie el estado del SSR
+ * @details Contabiliza el cambio en el instante de la llamada. Los flancos EVBUS_SSR_EDGE del
+ *          bus de eventos se contabilizan en su instante de publicación (`t_us`), no al entregarse.
  * @param ssr_active true si el SSR está activo, false si está inactivo
  * @return ESP_OK si la actualización fue exitosa
  */
@@ -114,6 +115,13 @@ esp_err_t statistics_reset(void);
  */
 void statistics_periodic_update(void);
 
+/**
+ * @brief Formatea `iterations` duraciones como en statistics_get_formatted() (micro-benchmark)
+ * @details Recorre los tres formatos (segundos, minutos y horas); la usa el banco de pruebas (bench.h)
+ * @return Largo total de los textos, para que el compilador no descarte el formateo
+ */
+size_t statistics_bench_format(uint32_t iterations);
+
 #ifdef __cplusplus
 }
 #endif
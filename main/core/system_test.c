@@ -12,7 +12,6 @@
 #include "sensor.h"
 #include "pid_controller.h"
 #include "CH422G.h"
-#include "DEV_Config.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
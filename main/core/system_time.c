@@ -6,23 +6,34 @@
 #include "ui.h"
 #include "ui_helpers.h"
 #include "statusbar_manager.h"
+#include "lvgl_port.h"
+#include "timebase.h"
 
 static const char *TAG = "SYSTEM_TIME";
 
 // Variables globales
 system_datetime_t g_system_datetime = {2025, 6, 25, 12, 0, 0};
-esp_timer_handle_t datetime_update_timer = NULL;
-bool timer_active = false;
+
+/**
+ * @brief Llamada por SNTP tras cada sincronización
+ *
+ * En modo SMOOTH, lwIP ya corrigió el reloj de libc con adjtime(); aquí se informa
+ * la referencia a la base de tiempo, que aplica su propio slew.
+ */
+static void sntp_sync_cb(struct timeval *tv) {
+    timebase_set_utc((int64_t)tv->tv_sec * 1000000LL + tv->tv_usec, TIMEBASE_UTC_SYNCED);
+    system_time_get(&g_system_datetime);
+    system_time_update_ui_displays();
+    ESP_LOGI(TAG, "Tiempo sincronizado exitosamente desde red");
+}
 
 void system_time_init(void) {
     ESP_LOGI(TAG, "Inicializando sistema de tiempo");
-    
-    // Configurar SNTP para sincronización automática
-    esp_sntp_setoperatingmode(SNTP_OPMODE_POLL);
-    esp_sntp_setservername(0, "pool.ntp.org");
-    esp_sntp_setservername(1, "time.nist.gov");
-    esp_sntp_set_sync_mode(SNTP_SYNC_MODE_IMMED);
-    
+
+    // Restaurar la última hora conocida (NVS o RTC); SNTP se configura al iniciarlo,
+    // cuando la pila TCP/IP ya existe
+    timebase_init();
+
     // Configurar zona horaria (ajustar según necesidad)
     setenv("TZ", "UTC-0", 1);
     tzset();
@@ -36,12 +47,13 @@ void system_time_set(system_datetime_t* datetime) {
     // Actualizar variable global
     g_system_datetime = *datetime;
     
-    // Convertir a timestamp y actualizar el RTC del sistema
+    // Convertir a timestamp y actualizar el RTC del sistema y la base de tiempo
     time_t timestamp = system_datetime_to_timestamp(datetime);
     struct timeval tv;
     tv.tv_sec = timestamp;
     tv.tv_usec = 0;
     settimeofday(&tv, NULL);
+    timebase_set_utc((int64_t)timestamp * 1000000LL, TIMEBASE_UTC_MANUAL);
     
     // Actualizar displays de UI
     system_time_update_ui_displays();
@@ -54,8 +66,7 @@ void system_time_set(system_datetime_t* datetime) {
 void system_time_get(system_datetime_t* datetime) {
     if (datetime == NULL) return;
     
-    time_t now;
-    time(&now);
+    time_t now = (time_t)(timebase_utc_us() / 1000000);
     timestamp_to_system_datetime(now, datetime);
     
     // También actualizar la variable global
@@ -63,69 +74,18 @@ void system_time_get(system_datetime_t* datetime) {
 }
 
 void system_time_update_from_network(void) {
-    ESP_LOGI(TAG, "Actualizando tiempo desde red...");
-    
-    // Inicializar SNTP si no está inicializado
-    if (esp_sntp_get_sync_status() == SNTP_SYNC_STATUS_RESET) {
+    // No bloquea: la hora se aplica en sntp_sync_cb al llegar la respuesta,
+    // y SNTP vuelve a sincronizar periódicamente por sí solo
+    if (!esp_sntp_enabled()) {
+        ESP_LOGI(TAG, "Iniciando sincronización SNTP");
+        // Sincronización automática, corrigiendo sin saltos
+        esp_sntp_setoperatingmode(SNTP_OPMODE_POLL);
+        esp_sntp_setservername(0, "pool.ntp.org");
+        esp_sntp_setservername(1, "time.nist.gov");
+        esp_sntp_set_sync_mode(SNTP_SYNC_MODE_SMOOTH);
+        esp_sntp_set_time_sync_notification_cb(sntp_sync_cb);
         esp_sntp_init();
     }
-    
-    // Esperar sincronización (hasta 10 segundos)
-    int retry = 0;
-    const int retry_count = 100; // 10 segundos con delays de 100ms
-    
-    while (esp_sntp_get_sync_status() == SNTP_SYNC_STATUS_RESET && ++retry < retry_count) {
-        ESP_LOGI(TAG, "Esperando sincronización SNTP... (%d/%d)", retry, retry_count);
-        vTaskDelay(100 / portTICK_PERIOD_MS);
-    }
-    
-    if (esp_sntp_get_sync_status() == SNTP_SYNC_STATUS_COMPLETED) {
-        // Obtener tiempo actualizado del sistema
-        system_time_get(&g_system_datetime);
-        system_time_update_ui_displays();
-        ESP_LOGI(TAG, "Tiempo sincronizado exitosamente desde red");
-    } else {
-        ESP_LOGW(TAG, "No se pudo sincronizar tiempo desde red");
-    }
-}
-
-void system_time_start_auto_update(void) {
-    if (timer_active) return;
-    
-    const esp_timer_create_args_t timer_args = {
-        .callback = &datetime_timer_callback,
-        .arg = NULL,
-        .name = "datetime_timer"
-    };
-    
-    ESP_ERROR_CHECK(esp_timer_create(&timer_args, &datetime_update_timer));
-    
-    // Configurar para ejecutar cada minuto (60 segundos)
-    ESP_ERROR_CHECK(esp_timer_start_periodic(datetime_update_timer, 60 * 1000000)); // 60 segundos en microsegundos
-    
-    timer_active = true;
-    ESP_LOGI(TAG, "Timer de actualización automática iniciado");
-}
-
-void system_time_stop_auto_update(void) {
-    if (!timer_active || datetime_update_timer == NULL) return;
-    
-    ESP_ERROR_CHECK(esp_timer_stop(datetime_update_timer));
-    ESP_ERROR_CHECK(esp_timer_delete(datetime_update_timer));
-    datetime_update_timer = NULL;
-    timer_active = false;
-    
-    ESP_LOGI(TAG, "Timer de actualización automática detenido");
-}
-
-void datetime_timer_callback(void* arg) {
-    // Obtener tiempo actual del sistema
-    system_time_get(&g_system_datetime);
-    
-    // Actualizar todas las pantallas que muestren fecha/hora
-    system_time_update_ui_displays();
-    
-    ESP_LOGD(TAG, "Timer: Fecha y hora actualizada automáticamente");
 }
 
 time_t system_datetime_to_timestamp(system_datetime_t* datetime) {
@@ -157,8 +117,11 @@ void timestamp_to_system_datetime(time_t timestamp, system_datetime_t* datetime)
 }
 
 void system_time_update_ui_displays(void) {
-    // Actualizar la barra de estado forzando la actualización
-    statusbar_update_time(true);
+    // Se llama desde tareas de fondo (arranque, SNTP, timer): tomar el mutex de LVGL (recursivo)
+    if (lvgl_port_lock(-1)) {
+        statusbar_update_time(true);
+        lvgl_port_unlock();
+    }
     
     // Aquí se pueden agregar más actualizaciones de UI según sea necesario
     // Por ejemplo, si hay otros widgets que muestren fecha/hora en otras pantallas
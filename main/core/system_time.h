@@ -3,7 +3,6 @@
 
 #include <time.h>
 #include <sys/time.h>
-#include "esp_timer.h"
 #include "esp_log.h"
 
 // Estructura para manejar fecha y hora del sistema
@@ -19,19 +18,11 @@ typedef struct {
 // Variable global del sistema
 extern system_datetime_t g_system_datetime;
 
-// Timer para actualización automática
-extern esp_timer_handle_t datetime_update_timer;
-
 // Funciones principales
-void system_time_init(void);
+void system_time_init(void);                  // Restaura la hora (NVS/RTC); no toca la red
 void system_time_set(system_datetime_t* datetime);
 void system_time_get(system_datetime_t* datetime);
-void system_time_update_from_network(void);
-void system_time_start_auto_update(void);
-void system_time_stop_auto_update(void);
-
-// Callback del timer (actualización cada minuto)
-void datetime_timer_callback(void* arg);
+void system_time_update_from_network(void);  // Configura e inicia SNTP sin bloquear (tras esp_netif_init)
 
 // Funciones de conversión
 time_t system_datetime_to_timestamp(system_datetime_t* datetime);
@@ -0,0 +1,197 @@
+/**
+ * @file timebase.c
+ * @brief Implementación de la base de tiempo.
+ * @details La hora UTC se calcula como `mono + desfase(mono)`. Al recibir una referencia
+ *          se fija el desfase objetivo y la diferencia con el desfase vigente queda como
+ *          corrección residual, que se consume linealmente a TIMEBASE_SLEW_PPM. Como esa
+ *          velocidad es mucho menor que 1 µs/µs, la hora UTC siempre avanza.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#include "timebase.h"
+#include "freertos/FreeRTOS.h"
+#include "hal_clock.h"
+#include "hal_nvs.h"
+#include "esp_log.h"
+#include "scheduler.h"
+
+static const char *TAG = "TIMEBASE";
+
+#define NVS_NAMESPACE   "timebase"
+#define NVS_KEY_UTC     "utc_s"
+#define MIN_VALID_UTC_S 1704067200LL    ///< 2024-01-01: antes de esto la hora del RTC no es real
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static timebase_utc_state_t s_state = TIMEBASE_UTC_NONE;
+static int64_t s_offset_us = 0;         ///< Desfase objetivo (UTC - monotónico)
+static int64_t s_slew_us = 0;           ///< Corrección residual al inicio del slew
+static int64_t s_slew_start_us = 0;     ///< Instante monotónico de inicio del slew
+static sched_job_handle_t s_save_job = NULL;
+
+/**
+ * @brief Corrección que aún falta aplicar en el instante `mono_us` (lock tomado)
+ */
+static int64_t residual_locked(int64_t mono_us)
+{
+    if (s_slew_us == 0 || mono_us <= s_slew_start_us) {
+        return s_slew_us;
+    }
+    const int64_t applied = (mono_us - s_slew_start_us) * TIMEBASE_SLEW_PPM / 1000000;
+    if (s_slew_us > 0) {
+        return applied >= s_slew_us ? 0 : s_slew_us - applied;
+    }
+    return applied >= -s_slew_us ? 0 : s_slew_us + applied;
+}
+
+static int64_t to_utc_locked(int64_t mono_us)
+{
+    if (s_state == TIMEBASE_UTC_NONE) {
+        return 0;
+    }
+    return mono_us + s_offset_us - residual_locked(mono_us);
+}
+
+static void save_job(void *arg)
+{
+    (void)arg;
+    timebase_save();
+}
+
+esp_err_t timebase_init(void)
+{
+    hal_nvs_handle_t handle;
+    int64_t saved_s = 0;
+    esp_err_t ret = hal_nvs_open(NVS_NAMESPACE, HAL_NVS_READONLY, &handle);
+    if (ret == ESP_OK) {
+        ret = hal_nvs_get_i64(handle, NVS_KEY_UTC, &saved_s);
+        hal_nvs_close(handle);
+    }
+
+    // La hora del sistema sobrevive a un reinicio por software (RTC); NVS cubre los cortes de energía
+    const int64_t wall_s = hal_clock_wall_s();
+    if (wall_s > MIN_VALID_UTC_S && wall_s > saved_s) {
+        saved_s = wall_s;
+    }
+
+    if (saved_s > MIN_VALID_UTC_S) {
+        const int64_t now = timebase_mono_us();
+        portENTER_CRITICAL(&s_lock);
+        if (s_state == TIMEBASE_UTC_NONE) {
+            s_offset_us = saved_s * 1000000LL - now;
+            s_slew_us = 0;
+            s_state = TIMEBASE_UTC_RESTORED;
+        }
+        portEXIT_CRITICAL(&s_lock);
+
+        if (wall_s < saved_s) {
+            hal_clock_set_wall_s(saved_s);
+        }
+        ESP_LOGI(TAG, "Hora restaurada: %lld s UTC", (long long)saved_s);
+    }
+
+    if (s_save_job == NULL) {
+        ret = sched_add("timebase_save", save_job, NULL, TIMEBASE_SAVE_PERIOD_S * 1000,
+                        TIMEBASE_SAVE_PERIOD_S * 1000, &s_save_job);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "No se pudo registrar el guardado periódico: %s", esp_err_to_name(ret));
+            return ret;
+        }
+    }
+    return ESP_OK;
+}
+
+int64_t timebase_mono_us(void)
+{
+    return hal_clock_mono_us();
+}
+
+int64_t timebase_mono_ms(void)
+{
+    return hal_clock_mono_us() / 1000;
+}
+
+int64_t timebase_mono_to_utc_us(int64_t mono_us)
+{
+    portENTER_CRITICAL(&s_lock);
+    const int64_t utc = to_utc_locked(mono_us);
+    portEXIT_CRITICAL(&s_lock);
+    return utc;
+}
+
+int64_t timebase_utc_us(void)
+{
+    return timebase_mono_to_utc_us(timebase_mono_us());
+}
+
+timebase_stamp_t timebase_now(void)
+{
+    timebase_stamp_t stamp;
+    stamp.mono_us = timebase_mono_us();
+    stamp.utc_us = timebase_mono_to_utc_us(stamp.mono_us);
+    return stamp;
+}
+
+void timebase_set_utc(int64_t utc_us, timebase_utc_state_t state)
+{
+    const int64_t now = timebase_mono_us();
+    bool stepped;
+    int64_t error;
+
+    portENTER_CRITICAL(&s_lock);
+    const int64_t current_offset = s_offset_us - residual_locked(now);
+    const int64_t new_offset = utc_us - now;
+    error = new_offset - current_offset;
+
+    // Sin referencia previa confiable o con un error grande, saltar; si no, corregir gradualmente
+    stepped = s_state == TIMEBASE_UTC_NONE || s_state == TIMEBASE_UTC_RESTORED ||
+              state == TIMEBASE_UTC_MANUAL || error > TIMEBASE_STEP_THRESHOLD_US ||
+              error < -TIMEBASE_STEP_THRESHOLD_US;
+    s_offset_us = new_offset;
+    s_slew_us = stepped ? 0 : error;
+    s_slew_start_us = now;
+    s_state = state;
+    portEXIT_CRITICAL(&s_lock);
+
+    if (stepped) {
+        ESP_LOGI(TAG, "Hora ajustada (salto de %lld ms)", (long long)(error / 1000));
+        timebase_save();
+    } else {
+        ESP_LOGI(TAG, "Hora corregida gradualmente (%lld ms)", (long long)(error / 1000));
+    }
+}
+
+timebase_utc_state_t timebase_get_utc_state(void)
+{
+    return s_state;
+}
+
+int64_t timebase_get_pending_slew_us(void)
+{
+    const int64_t now = timebase_mono_us();
+    portENTER_CRITICAL(&s_lock);
+    const int64_t residual = residual_locked(now);
+    portEXIT_CRITICAL(&s_lock);
+    return residual;
+}
+
+esp_err_t timebase_save(void)
+{
+    const int64_t utc_us = timebase_utc_us();
+    if (utc_us == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    hal_nvs_handle_t handle;
+    esp_err_t ret = hal_nvs_open(NVS_NAMESPACE, HAL_NVS_READWRITE, &handle);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = hal_nvs_set_i64(handle, NVS_KEY_UTC, utc_us / 1000000);
+    if (ret == ESP_OK) {
+        ret = hal_nvs_commit(handle);
+    }
+    hal_nvs_close(handle);
+    return ret;
+}
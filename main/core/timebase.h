@@ -0,0 +1,114 @@
+/**
+ * @file timebase.h
+ * @brief Base de tiempo única del firmware.
+ * @details Ofrece dos relojes derivados del mismo contador:
+ *          - Monotónico (µs desde el arranque, `esp_timer`): para el lazo de control, el
+ *            muestreo, las duraciones y cualquier cálculo de intervalos.
+ *          - UTC: el monotónico más un desfase que se corrige al sincronizar (SNTP o ajuste
+ *            manual). Las correcciones pequeñas se aplican gradualmente (slew), de modo que
+ *            la hora UTC nunca retrocede ni salta; solo las correcciones grandes o la primera
+ *            sincronización se aplican de golpe.
+ *
+ *          La última hora UTC conocida se guarda en NVS y se restaura al arrancar, para que
+ *          las marcas de tiempo no vuelvan a 1970 tras un reinicio sin red.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TIMEBASE_SLEW_PPM           500     ///< Velocidad máxima de corrección gradual (µs por s)
+#define TIMEBASE_STEP_THRESHOLD_US  (60LL * 1000000LL) ///< Corrección a partir de la cual se salta
+#define TIMEBASE_SAVE_PERIOD_S      3600    ///< Periodo de guardado de la hora en NVS
+
+/**
+ * @brief Calidad de la hora UTC
+ */
+typedef enum {
+    TIMEBASE_UTC_NONE = 0,      ///< Sin referencia: la hora UTC no es válida
+    TIMEBASE_UTC_RESTORED,      ///< Restaurada de NVS (aproximada, no cuenta el tiempo apagado)
+    TIMEBASE_UTC_MANUAL,        ///< Ajustada por el usuario
+    TIMEBASE_UTC_SYNCED,        ///< Sincronizada por SNTP
+} timebase_utc_state_t;
+
+/**
+ * @brief Marca de tiempo de una muestra o evento
+ */
+typedef struct {
+    int64_t mono_us;            ///< Reloj monotónico
+    int64_t utc_us;             ///< Hora UTC (µs desde 1970), 0 si no hay referencia
+} timebase_stamp_t;
+
+/**
+ * @brief Restaura la última hora conocida desde NVS
+ * @details Requiere NVS inicializado. Se puede usar el reloj monotónico sin llamarla.
+ * @return ESP_OK si el servicio quedó listo
+ */
+esp_err_t timebase_init(void);
+
+/**
+ * @brief Reloj monotónico en µs desde el arranque
+ */
+int64_t timebase_mono_us(void);
+
+/**
+ * @brief Reloj monotónico en ms desde el arranque
+ */
+int64_t timebase_mono_ms(void);
+
+/**
+ * @brief Hora UTC en µs desde 1970
+ * @return Hora UTC, 0 si no hay referencia
+ */
+int64_t timebase_utc_us(void);
+
+/**
+ * @brief Convierte un instante monotónico a UTC con la corrección vigente
+ * @param mono_us Instante del reloj monotónico
+ * @return Hora UTC, 0 si no hay referencia
+ */
+int64_t timebase_mono_to_utc_us(int64_t mono_us);
+
+/**
+ * @brief Toma una marca de tiempo con ambos relojes
+ */
+timebase_stamp_t timebase_now(void);
+
+/**
+ * @brief Informa una hora UTC de referencia
+ * @param utc_us Hora UTC en µs desde 1970
+ * @param state Origen de la referencia (MANUAL o SYNCED)
+ */
+void timebase_set_utc(int64_t utc_us, timebase_utc_state_t state);
+
+/**
+ * @brief Obtiene la calidad de la hora UTC
+ */
+timebase_utc_state_t timebase_get_utc_state(void);
+
+/**
+ * @brief Corrección pendiente de aplicar gradualmente (µs, positiva si el reloj va atrasado)
+ */
+int64_t timebase_get_pending_slew_us(void);
+
+/**
+ * @brief Guarda la hora actual en NVS
+ * @return ESP_OK si se guardó
+ */
+esp_err_t timebase_save(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TIMEBASE_H
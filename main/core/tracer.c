@@ -0,0 +1,329 @@
+/**
+ * @file tracer.c
+ * @brief Implementación del trazador de eventos del sistema.
+ * @details Cada núcleo escribe solo en su propio anillo con las interrupciones enmascaradas,
+ *          así que un registro nunca se intercala con otro y no hace falta lock entre
+ *          núcleos. Para leer los anillos se apaga la máscara de clases y se espera unos
+ *          microsegundos: una escritura que ya pasó el control termina en ese lapso porque no
+ *          puede ser interrumpida.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#include "tracer.h"
+
+#if CONFIG_TRACER_ENABLE
+
+#include "tracer_hooks.h"
+#include "mem_budget.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "esp_cpu.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_rom_sys.h"
+#include "esp_private/cache_utils.h"
+#include <string.h>
+
+static const char *TAG = "TRACE";
+
+#define TRACER_CORES        2       ///< Un anillo por núcleo del ESP32-S3
+#define TRACER_MAX_TASKS    40      ///< Tareas en la tabla del volcado
+#define TRACER_QUIESCE_US   5       ///< Espera para que terminen las escrituras en curso
+
+_Static_assert(sizeof(tracer_record_t) == 12, "el formato del volcado fija registros de 12 bytes");
+_Static_assert(sizeof(tracer_dump_header_t) == 48, "el formato del volcado fija un encabezado de 48 bytes");
+MEM_BUDGET_STATIC_ASSERT(TRACER, PSRAM, CONFIG_TRACER_RING_RECORDS * sizeof(tracer_record_t) * TRACER_CORES);
+
+/**
+ * @brief Anillo de un núcleo
+ */
+typedef struct {
+    tracer_record_t *buf;       ///< Registros en PSRAM
+    volatile uint32_t head;     ///< Registros escritos; el índice es head & s_index_mask
+} tracer_ring_t;
+
+static tracer_ring_t s_rings[TRACER_CORES];
+static uint32_t s_capacity = 0;
+static uint32_t s_index_mask = 0;
+static volatile uint32_t s_classes = 0;     ///< Clases activas; 0 detiene el registro
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static bool s_dumping = false;
+
+static TaskStatus_t s_status[TRACER_MAX_TASKS];
+static tracer_dump_task_t s_task_table[TRACER_MAX_TASKS];
+
+static const char *const s_mark_names[TRACER_MARK_COUNT] = {
+    [TRACER_MARK_SENSOR_POLL]  = "sensor_poll",
+    [TRACER_MARK_MODBUS_WAIT]  = "modbus_wait",
+    [TRACER_MARK_PID_COMPUTE]  = "pid_compute",
+    [TRACER_MARK_SSR_WRITE]    = "ssr_write",
+    [TRACER_MARK_LVGL_FLUSH]   = "lvgl_flush",
+    [TRACER_MARK_WS_BROADCAST] = "ws_broadcast",
+};
+
+static const char *const s_isr_names[TRACER_ISR_COUNT] = {
+    [TRACER_ISR_TOUCH] = "touch",
+    [TRACER_ISR_VSYNC] = "vsync",
+};
+
+_Static_assert(TRACER_EV_QUEUE_SEND == TRACER_HOOK_QUEUE_SEND &&
+               TRACER_EV_QUEUE_RECV == TRACER_HOOK_QUEUE_RECV &&
+               TRACER_EV_QUEUE_BLOCK == TRACER_HOOK_QUEUE_BLOCK,
+               "tracer_hooks.h debe usar los mismos códigos que tracer_event_t");
+
+// ───────────────────────────────────────────────────────
+// Escritura
+
+static IRAM_ATTR void put(uint32_t cls, uint8_t type, uint32_t arg, uint16_t id)
+{
+    const UBaseType_t irq = portSET_INTERRUPT_MASK_FROM_ISR();
+    // Sin caché (escritura de flash en curso) la PSRAM no es accesible
+    if ((s_classes & cls) && spi_flash_cache_enabled()) {
+        const uint32_t core = esp_cpu_get_core_id();
+        tracer_ring_t *r = &s_rings[core];
+        tracer_record_t *rec = &r->buf[r->head & s_index_mask];
+        rec->t_us = (uint32_t)esp_timer_get_time();
+        rec->arg = arg;
+        rec->type = type;
+        rec->core = (uint8_t)core;
+        rec->id = id;
+        r->head++;
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(irq);
+}
+
+static inline uint32_t current_task(void)
+{
+    return (uint32_t)(uintptr_t)xTaskGetCurrentTaskHandle();
+}
+
+IRAM_ATTR void tracer_hook_task_in(void)
+{
+    put(TRACER_CLASS_TASK, TRACER_EV_TASK_IN, current_task(), 0);
+}
+
+IRAM_ATTR void tracer_hook_task_out(void)
+{
+    put(TRACER_CLASS_TASK, TRACER_EV_TASK_OUT, current_task(), 0);
+}
+
+IRAM_ATTR void tracer_hook_queue(unsigned type, const void *queue, unsigned waiting)
+{
+    put(TRACER_CLASS_QUEUE, (uint8_t)type, (uint32_t)(uintptr_t)queue, waiting > UINT16_MAX ? UINT16_MAX : (uint16_t)waiting);
+}
+
+void tracer_mark_begin(tracer_mark_t mark)
+{
+    put(TRACER_CLASS_MARK, TRACER_EV_MARK_BEGIN, current_task(), (uint16_t)mark);
+}
+
+void tracer_mark_end(tracer_mark_t mark)
+{
+    put(TRACER_CLASS_MARK, TRACER_EV_MARK_END, current_task(), (uint16_t)mark);
+}
+
+void tracer_mark_instant(tracer_mark_t mark, uint32_t value)
+{
+    put(TRACER_CLASS_MARK, TRACER_EV_MARK_INSTANT, value, (uint16_t)mark);
+}
+
+IRAM_ATTR void tracer_isr_enter(tracer_isr_t isr)
+{
+    put(TRACER_CLASS_ISR, TRACER_EV_ISR_ENTER, 0, (uint16_t)isr);
+}
+
+IRAM_ATTR void tracer_isr_exit(tracer_isr_t isr)
+{
+    put(TRACER_CLASS_ISR, TRACER_EV_ISR_EXIT, 0, (uint16_t)isr);
+}
+
+// ───────────────────────────────────────────────────────
+// Control
+
+/**
+ * @brief Detiene el registro y espera a que terminen las escrituras en curso
+ * @return Máscara que estaba activa
+ */
+static uint32_t quiesce(void)
+{
+    const uint32_t mask = s_classes;
+    s_classes = 0;
+    esp_rom_delay_us(TRACER_QUIESCE_US);
+    return mask;
+}
+
+esp_err_t tracer_init(void)
+{
+    if (s_capacity) {
+        return ESP_OK;
+    }
+    // Potencia de dos para indexar con una máscara
+    uint32_t capacity = 1;
+    while (capacity * 2 <= CONFIG_TRACER_RING_RECORDS) {
+        capacity *= 2;
+    }
+
+    const size_t ring_bytes = capacity * sizeof(tracer_record_t);
+    esp_err_t ret = mem_budget_claim(MEM_MOD_TRACER, MEM_REGION_PSRAM, ring_bytes * TRACER_CORES);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    for (int c = 0; c < TRACER_CORES; c++) {
+        s_rings[c].buf = heap_caps_calloc(capacity, sizeof(tracer_record_t), MALLOC_CAP_SPIRAM);
+        if (s_rings[c].buf == NULL) {
+            ESP_LOGE(TAG, "Sin PSRAM para %lu registros", (unsigned long)capacity);
+            for (int i = 0; i < c; i++) {
+                heap_caps_free(s_rings[i].buf);
+                s_rings[i].buf = NULL;
+            }
+            mem_budget_release(MEM_MOD_TRACER, MEM_REGION_PSRAM, ring_bytes * TRACER_CORES);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    s_index_mask = capacity - 1;
+    s_capacity = capacity;
+    ESP_LOGI(TAG, "%lu registros por núcleo (%lu KB en PSRAM)", (unsigned long)capacity,
+             (unsigned long)(capacity * sizeof(tracer_record_t) * TRACER_CORES / 1024));
+
+#if CONFIG_TRACER_AUTOSTART
+    tracer_start(TRACER_CLASS_ALL);
+#endif
+    return ESP_OK;
+}
+
+void tracer_start(uint32_t mask)
+{
+    if (s_capacity == 0) {
+        return;
+    }
+    quiesce();
+    for (int c = 0; c < TRACER_CORES; c++) {
+        s_rings[c].head = 0;
+    }
+    s_classes = mask & TRACER_CLASS_ALL;
+}
+
+void tracer_stop(void)
+{
+    quiesce();
+}
+
+void tracer_get_stats(tracer_stats_t *out)
+{
+    if (out == NULL) {
+        return;
+    }
+    out->mask = s_classes;
+    out->capacity = s_capacity;
+    for (int c = 0; c < TRACER_CORES; c++) {
+        out->written[c] = s_rings[c].head;
+    }
+}
+
+// ───────────────────────────────────────────────────────
+// Volcado
+
+static size_t build_task_table(void)
+{
+    const UBaseType_t n = uxTaskGetSystemState(s_status, TRACER_MAX_TASKS, NULL);
+    for (UBaseType_t i = 0; i < n; i++) {
+        s_task_table[i].handle = (uint32_t)(uintptr_t)s_status[i].xHandle;
+        strncpy(s_task_table[i].name, s_status[i].pcTaskName, TRACER_NAME_LEN);
+    }
+    return n;
+}
+
+static esp_err_t write_labels(tracer_write_fn_t write, void *ctx)
+{
+    tracer_dump_label_t label;
+    for (int kind = 0; kind < 2; kind++) {
+        const char *const *names = kind == 0 ? s_mark_names : s_isr_names;
+        const int count = kind == 0 ? TRACER_MARK_COUNT : TRACER_ISR_COUNT;
+        for (int i = 0; i < count; i++) {
+            memset(&label, 0, sizeof(label));
+            label.kind = kind;
+            label.id = i;
+            strncpy(label.name, names[i], TRACER_NAME_LEN);
+            esp_err_t err = write(&label, sizeof(label), ctx);
+            if (err != ESP_OK) {
+                return err;
+            }
+        }
+    }
+    return ESP_OK;
+}
+
+static esp_err_t write_ring(const tracer_ring_t *r, uint32_t count, tracer_write_fn_t write, void *ctx)
+{
+    // Del más viejo al más nuevo, en uno o dos tramos contiguos
+    const uint32_t first = (r->head - count) & s_index_mask;
+    const uint32_t tail = count < s_capacity - first ? count : s_capacity - first;
+    esp_err_t err = ESP_OK;
+    if (tail) {
+        err = write(&r->buf[first], tail * sizeof(tracer_record_t), ctx);
+    }
+    if (err == ESP_OK && count > tail) {
+        err = write(&r->buf[0], (count - tail) * sizeof(tracer_record_t), ctx);
+    }
+    return err;
+}
+
+esp_err_t tracer_dump(tracer_write_fn_t write, void *ctx)
+{
+    if (write == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_capacity == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    portENTER_CRITICAL(&s_lock);
+    const bool busy = s_dumping;
+    s_dumping = true;
+    portEXIT_CRITICAL(&s_lock);
+    if (busy) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    const uint32_t mask = quiesce();
+
+    tracer_dump_header_t hdr = {
+        .version = TRACER_DUMP_VERSION,
+        .record_size = sizeof(tracer_record_t),
+        .dump_us = (uint64_t)esp_timer_get_time(),
+        .label_count = TRACER_MARK_COUNT + TRACER_ISR_COUNT,
+        .core_count = TRACER_CORES,
+    };
+    memcpy(hdr.magic, TRACER_DUMP_MAGIC, sizeof(hdr.magic));
+    for (int c = 0; c < TRACER_CORES; c++) {
+        const uint32_t head = s_rings[c].head;
+        hdr.records[c] = head < s_capacity ? head : s_capacity;
+        hdr.overwritten[c] = head - hdr.records[c];
+    }
+    hdr.task_count = build_task_table();
+
+    esp_err_t err = write(&hdr, sizeof(hdr), ctx);
+    if (err == ESP_OK && hdr.task_count) {
+        err = write(s_task_table, hdr.task_count * sizeof(tracer_dump_task_t), ctx);
+    }
+    if (err == ESP_OK) {
+        err = write_labels(write, ctx);
+    }
+    for (int c = 0; c < TRACER_CORES && err == ESP_OK; c++) {
+        err = write_ring(&s_rings[c], hdr.records[c], write, ctx);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Volcado interrumpido: %s", esp_err_to_name(err));
+    }
+
+    s_classes = mask;
+    portENTER_CRITICAL(&s_lock);
+    s_dumping = false;
+    portEXIT_CRITICAL(&s_lock);
+    return err;
+}
+
+#endif // CONFIG_TRACER_ENABLE
@@ -0,0 +1,216 @@
+/**
+ * @file tracer.h
+ * @brief Trazador liviano de eventos del sistema para reconstruir líneas de tiempo.
+ * @details Registra en anillos de PSRAM (uno por núcleo, sin locks entre núcleos) registros
+ *          de 12 bytes con marca de tiempo:
+ *          - cambios de contexto y operaciones de colas de FreeRTOS (tracer_hooks.h, con
+ *            CONFIG_TRACER_KERNEL_HOOKS),
+ *          - entrada y salida de las ISR propias (táctil, VSYNC del panel RGB),
+ *          - marcadores de la aplicación: lectura del sensor y espera Modbus, cálculo del
+ *            PID, escritura del SSR, flush de LVGL, difusión WebSocket.
+ *
+ *          Cuando un anillo se llena se sobrescriben los registros más viejos. tracer_dump()
+ *          congela la traza y la serializa (encabezado, tabla de tareas, nombres de
+ *          marcadores y registros) para GET /trace, el WebSocket ("trace") o la consola;
+ *          tools/trace2perfetto.py la convierte a JSON de Chrome trace / Perfetto.
+ *
+ *          Sin CONFIG_TRACER_ENABLE todas las funciones quedan vacías.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#ifndef TRACER_H
+#define TRACER_H
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRACER_DUMP_MAGIC       "TRC1"  ///< Firma del volcado
+#define TRACER_DUMP_VERSION     1       ///< Versión del formato del volcado
+#define TRACER_NAME_LEN         16      ///< Longitud fija de los nombres en el volcado
+
+/**
+ * @brief Tipos de registro
+ */
+typedef enum {
+    TRACER_EV_TASK_IN = 1,      ///< Una tarea entra a ejecutarse (arg: handle)
+    TRACER_EV_TASK_OUT,         ///< Una tarea deja de ejecutarse (arg: handle)
+    TRACER_EV_ISR_ENTER,        ///< Entrada a una ISR (id: tracer_isr_t)
+    TRACER_EV_ISR_EXIT,         ///< Salida de una ISR (id: tracer_isr_t)
+    TRACER_EV_QUEUE_SEND,       ///< Envío a una cola (arg: cola, id: mensajes en espera)
+    TRACER_EV_QUEUE_RECV,       ///< Recepción de una cola o toma de semáforo
+    TRACER_EV_QUEUE_BLOCK,      ///< La tarea se bloquea esperando una cola
+    TRACER_EV_MARK_BEGIN,       ///< Inicio de un marcador (arg: tarea, id: tracer_mark_t)
+    TRACER_EV_MARK_END,         ///< Fin de un marcador
+    TRACER_EV_MARK_INSTANT,     ///< Marcador puntual (arg: valor libre)
+} tracer_event_t;
+
+/**
+ * @brief Clases de registro que se pueden activar por separado
+ */
+#define TRACER_CLASS_TASK       (1u << 0)   ///< Cambios de contexto
+#define TRACER_CLASS_QUEUE      (1u << 1)   ///< Operaciones de colas y semáforos
+#define TRACER_CLASS_ISR        (1u << 2)   ///< ISR propias
+#define TRACER_CLASS_MARK       (1u << 3)   ///< Marcadores de la aplicación
+#define TRACER_CLASS_ALL        0x0Fu
+
+/**
+ * @brief Marcadores de la aplicación
+ * @note Agregar al final y nombrar en tracer.c (s_mark_names).
+ */
+typedef enum {
+    TRACER_MARK_SENSOR_POLL = 0,    ///< Trabajo de lectura de temperatura
+    TRACER_MARK_MODBUS_WAIT,        ///< Espera de la respuesta Modbus por la UART
+    TRACER_MARK_PID_COMPUTE,        ///< Cálculo del PID
+    TRACER_MARK_SSR_WRITE,          ///< Escritura de la salida del SSR en el CH422G
+    TRACER_MARK_LVGL_FLUSH,         ///< Flush de un área de LVGL al panel
+    TRACER_MARK_WS_BROADCAST,       ///< Difusión del estado por WebSocket
+    TRACER_MARK_COUNT
+} tracer_mark_t;
+
+/**
+ * @brief ISR instrumentadas
+ */
+typedef enum {
+    TRACER_ISR_TOUCH = 0,           ///< Interrupción del panel táctil
+    TRACER_ISR_VSYNC,               ///< VSYNC del panel RGB
+    TRACER_ISR_COUNT
+} tracer_isr_t;
+
+/**
+ * @brief Registro de la traza (12 bytes, little endian en el volcado)
+ */
+typedef struct {
+    uint32_t t_us;      ///< 32 bits bajos de esp_timer_get_time()
+    uint32_t arg;       ///< Handle de tarea o cola, o valor del marcador puntual
+    uint8_t type;       ///< tracer_event_t
+    uint8_t core;       ///< Núcleo que escribió el registro
+    uint16_t id;        ///< Marcador, ISR o mensajes en espera según `type`
+} tracer_record_t;
+
+/**
+ * @brief Encabezado del volcado
+ * @details Le siguen `task_count` entradas tracer_dump_task_t, `label_count` entradas
+ *          tracer_dump_label_t y los registros de cada núcleo, del más viejo al más nuevo.
+ */
+typedef struct {
+    char magic[4];                  ///< TRACER_DUMP_MAGIC
+    uint16_t version;               ///< TRACER_DUMP_VERSION
+    uint16_t record_size;           ///< sizeof(tracer_record_t)
+    uint64_t dump_us;               ///< esp_timer_get_time() al congelar (ancla de los 32 bits)
+    uint32_t task_count;            ///< Entradas de la tabla de tareas
+    uint32_t label_count;           ///< Entradas de la tabla de nombres
+    uint32_t core_count;            ///< Núcleos con anillo
+    uint32_t records[2];            ///< Registros de cada núcleo en el volcado
+    uint32_t overwritten[2];        ///< Registros perdidos por sobrescritura en cada núcleo
+    uint32_t reserved;              ///< Relleno explícito hasta 48 bytes
+} tracer_dump_header_t;
+
+/**
+ * @brief Entrada de la tabla de tareas del volcado
+ */
+typedef struct {
+    uint32_t handle;                ///< Handle como aparece en los registros
+    char name[TRACER_NAME_LEN];     ///< Nombre de la tarea
+} tracer_dump_task_t;
+
+/**
+ * @brief Entrada de la tabla de nombres de marcadores e ISR
+ */
+typedef struct {
+    uint16_t kind;                  ///< 0: marcador, 1: ISR
+    uint16_t id;                    ///< tracer_mark_t o tracer_isr_t
+    char name[TRACER_NAME_LEN];     ///< Nombre
+} tracer_dump_label_t;
+
+/**
+ * @brief Estado del trazador
+ */
+typedef struct {
+    uint32_t mask;                  ///< Clases activas (0: detenido)
+    uint32_t capacity;              ///< Registros por núcleo
+    uint32_t written[2];            ///< Registros escritos por núcleo desde el último inicio
+} tracer_stats_t;
+
+/**
+ * @brief Recibe un tramo del volcado
+ * @return ESP_OK para continuar; otro valor aborta el volcado
+ */
+typedef esp_err_t (*tracer_write_fn_t)(const void *data, size_t len, void *ctx);
+
+#if CONFIG_TRACER_ENABLE
+
+/**
+ * @brief Reserva los anillos en PSRAM y, con CONFIG_TRACER_AUTOSTART, empieza a trazar
+ * @return ESP_OK o ESP_ERR_NO_MEM
+ */
+esp_err_t tracer_init(void);
+
+/**
+ * @brief Vacía los anillos y empieza a registrar las clases indicadas
+ * @param mask Combinación de TRACER_CLASS_*
+ */
+void tracer_start(uint32_t mask);
+
+/**
+ * @brief Deja de registrar; la traza queda disponible para volcarla
+ */
+void tracer_stop(void);
+
+/**
+ * @brief Obtiene el estado del trazador
+ */
+void tracer_get_stats(tracer_stats_t *out);
+
+/**
+ * @brief Congela la traza y la serializa por tramos
+ * @details Detiene el registro mientras dura el volcado y lo reanuda con la misma máscara.
+ * @param write Receptor de los tramos
+ * @param ctx Contexto para `write`
+ * @return ESP_OK, ESP_ERR_INVALID_STATE sin anillos, o el error de `write`
+ */
+esp_err_t tracer_dump(tracer_write_fn_t write, void *ctx);
+
+/** @brief Marca el inicio de `mark` en la tarea actual */
+void tracer_mark_begin(tracer_mark_t mark);
+
+/** @brief Marca el fin de `mark` en la tarea actual */
+void tracer_mark_end(tracer_mark_t mark);
+
+/** @brief Marca un instante de `mark` con un valor libre */
+void tracer_mark_instant(tracer_mark_t mark, uint32_t value);
+
+/** @brief Entrada a una ISR; solo desde la propia ISR */
+void tracer_isr_enter(tracer_isr_t isr);
+
+/** @brief Salida de una ISR; solo desde la propia ISR */
+void tracer_isr_exit(tracer_isr_t isr);
+
+#else
+
+static inline esp_err_t tracer_init(void) { return ESP_OK; }
+static inline void tracer_start(uint32_t mask) { (void)mask; }
+static inline void tracer_stop(void) {}
+static inline void tracer_get_stats(tracer_stats_t *out) { if (out) { *out = (tracer_stats_t){0}; } }
+static inline esp_err_t tracer_dump(tracer_write_fn_t write, void *ctx) { (void)write; (void)ctx; return ESP_ERR_NOT_SUPPORTED; }
+static inline void tracer_mark_begin(tracer_mark_t mark) { (void)mark; }
+static inline void tracer_mark_end(tracer_mark_t mark) { (void)mark; }
+static inline void tracer_mark_instant(tracer_mark_t mark, uint32_t value) { (void)mark; (void)value; }
+static inline void tracer_isr_enter(tracer_isr_t isr) { (void)isr; }
+static inline void tracer_isr_exit(tracer_isr_t isr) { (void)isr; }
+
+#endif // CONFIG_TRACER_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TRACER_H
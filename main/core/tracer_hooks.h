@@ -0,0 +1,43 @@
+/**
+ * @file tracer_hooks.h
+ * @brief Macros de traza de FreeRTOS redirigidas al trazador (tracer.h).
+ * @details El CMakeLists.txt de la raíz incluye este archivo en todas las unidades de C con
+ *          `-include`, de modo que el núcleo de FreeRTOS lo ve antes de definir sus macros
+ *          vacías. Solo declara funciones: no puede incluir cabeceras de FreeRTOS.
+ *
+ *          No se instrumentan las variantes *_FROM_ISR: una ISR en IRAM puede correr con la
+ *          caché deshabilitada y los anillos viven en PSRAM.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#ifndef TRACER_HOOKS_H
+#define TRACER_HOOKS_H
+
+#ifndef __ASSEMBLER__
+
+#include "sdkconfig.h"
+
+#if CONFIG_TRACER_ENABLE && CONFIG_TRACER_KERNEL_HOOKS && !CONFIG_APPTRACE_SV_ENABLE
+
+// Mismos valores que TRACER_EV_QUEUE_* en tracer.h
+#define TRACER_HOOK_QUEUE_SEND      5
+#define TRACER_HOOK_QUEUE_RECV      6
+#define TRACER_HOOK_QUEUE_BLOCK     7
+
+void tracer_hook_task_in(void);
+void tracer_hook_task_out(void);
+void tracer_hook_queue(unsigned type, const void *queue, unsigned waiting);
+
+#define traceTASK_SWITCHED_IN()                 tracer_hook_task_in()
+#define traceTASK_SWITCHED_OUT()                tracer_hook_task_out()
+#define traceQUEUE_SEND(pxQueue)                tracer_hook_queue(TRACER_HOOK_QUEUE_SEND, (pxQueue), (pxQueue)->uxMessagesWaiting)
+#define traceQUEUE_RECEIVE(pxQueue)             tracer_hook_queue(TRACER_HOOK_QUEUE_RECV, (pxQueue), (pxQueue)->uxMessagesWaiting)
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue) tracer_hook_queue(TRACER_HOOK_QUEUE_BLOCK, (pxQueue), (pxQueue)->uxMessagesWaiting)
+
+#endif
+
+#endif // __ASSEMBLER__
+
+#endif // TRACER_HOOKS_H
@@ -9,35 +9,275 @@
 #include "nvs_flash.h"
 #include "esp_netif.h"
 #include "esp_event.h"
-#include "lwip/apps/sntp.h"
-#include "lvgl.h"
 #include "system_time.h"
 #include <string.h>
 #include <time.h>
 #include "wifi_prov.h"
 #include "network_config.h"
 #include "mdns.h"
-#include "ws_server.h"
+#include "event_bus.h"
+#include "metrics.h"
+#include "mem_budget.h"
+#include "esp_timer.h"
+#include "esp_random.h"
 
 static const char *TAG = "wifi_manager";
 
+ESP_EVENT_DEFINE_BASE(WIFI_MANAGER_EVENT);
+
+/// Órdenes internas, atendidas en la tarea del bucle de eventos junto con los eventos WiFi
+static const char *const WIFI_MANAGER_CMD = "WIFI_MANAGER_CMD";
+enum {
+    WIFI_CMD_RETRY,     ///< Venció el retardo de reintento
+    WIFI_CMD_CONNECT,   ///< Nuevas credenciales (dato: wifi_credentials_t)
+};
+
 static EventGroupHandle_t s_wifi_event_group;
+static StaticEventGroup_t s_wifi_event_group_buffer;
 #define WIFI_CONNECTED_BIT BIT0
-#define WIFI_FAIL_BIT BIT1
-static int s_retry_num = 0;
+
+#define WIFI_BACKOFF_MIN_MS     CONFIG_WIFI_MANAGER_BACKOFF_MIN_MS
+#define WIFI_BACKOFF_MAX_MS     CONFIG_WIFI_MANAGER_BACKOFF_MAX_MS
+#define WIFI_FAST_ATTEMPTS      CONFIG_WIFI_MANAGER_FAST_RECONNECT_ATTEMPTS
+
+static wifi_manager_state_t s_state = WIFI_MANAGER_STATE_IDLE;
+static wifi_credentials_t s_creds;              ///< Credenciales de la conexión en curso
+static bool s_creds_valid = false;
+static wifi_ap_info_t s_ap;                     ///< Último AP conocido para s_creds.ssid
+static uint32_t s_attempt = 0;                  ///< Intentos fallidos desde la última conexión
+static bool s_switching = false;                ///< Desconexión pedida al cambiar de red
+static esp_timer_handle_t s_retry_timer = NULL;
+static wifi_manager_stats_t s_stats;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static const char *const state_names[] = {
+    [WIFI_MANAGER_STATE_IDLE]       = "idle",
+    [WIFI_MANAGER_STATE_CONNECTING] = "connecting",
+    [WIFI_MANAGER_STATE_CONNECTED]  = "connected",
+    [WIFI_MANAGER_STATE_BACKOFF]    = "backoff",
+};
+
+/**
+ * @brief Cambia de estado y lo publica en WIFI_MANAGER_EVENT
+ */
+static void set_state(wifi_manager_state_t state, uint8_t reason, uint32_t delay_ms)
+{
+    s_state = state;
+    const wifi_manager_event_t ev = {
+        .state = state,
+        .attempt = s_attempt,
+        .reason = reason,
+        .retry_in_ms = delay_ms,
+    };
+    esp_event_post(WIFI_MANAGER_EVENT, state, &ev, sizeof(ev), 0);
+
+    evbus_event_t bus_ev = { .type = EVBUS_NET_STATE, .net = { .state = state, .reason = reason } };
+    evbus_publish(&bus_ev);
+}
+
+/**
+ * @brief Retardo del siguiente intento: exponencial con jitter ("equal jitter")
+ *
+ * La mitad del retardo es fija y la otra mitad aleatoria, para que varios equipos
+ * que pierden el mismo AP no reintenten a la vez.
+ */
+static uint32_t backoff_delay_ms(uint32_t attempt)
+{
+    const uint32_t shift = attempt > 16 ? 16 : attempt;
+    uint64_t delay = (uint64_t)WIFI_BACKOFF_MIN_MS << shift;
+    if (delay > WIFI_BACKOFF_MAX_MS) {
+        delay = WIFI_BACKOFF_MAX_MS;
+    }
+    const uint32_t half = (uint32_t)delay / 2;
+    return half + (half ? esp_random() % (half + 1) : 0);
+}
+
+/**
+ * @brief Aplica las credenciales actuales e inicia un intento de conexión
+ *
+ * Los primeros intentos usan el BSSID y canal guardados; si fallan se vuelve
+ * a un escaneo completo de canales.
+ */
+static esp_err_t start_attempt(void)
+{
+    // Los campos de wifi_sta_config_t no necesitan '\0': caben un SSID de 32 y una PSK de 64
+    wifi_config_t wifi_config = { 0 };
+    memcpy(wifi_config.sta.ssid, s_creds.ssid, strnlen(s_creds.ssid, sizeof(wifi_config.sta.ssid)));
+    memcpy(wifi_config.sta.password, s_creds.password,
+           strnlen(s_creds.password, sizeof(wifi_config.sta.password)));
+
+    const bool fast = s_ap.valid && s_attempt < WIFI_FAST_ATTEMPTS;
+    if (fast) {
+        wifi_config.sta.bssid_set = true;
+        memcpy(wifi_config.sta.bssid, s_ap.bssid, sizeof(s_ap.bssid));
+        wifi_config.sta.channel = s_ap.channel;
+        wifi_config.sta.scan_method = WIFI_FAST_SCAN;
+    } else {
+        wifi_config.sta.scan_method = WIFI_ALL_CHANNEL_SCAN;
+        wifi_config.sta.sort_method = WIFI_CONNECT_AP_BY_SIGNAL;
+    }
+
+    esp_err_t ret = esp_wifi_set_config(WIFI_IF_STA, &wifi_config);
+    if (ret == ESP_OK) {
+        ret = esp_wifi_connect();
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    s_stats.attempts++;
+    if (fast) {
+        s_stats.fast_attempts++;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "No se pudo iniciar la conexión: %s", esp_err_to_name(ret));
+    } else {
+        ESP_LOGI(TAG, "Conectando a %s (intento %lu, %s)", s_creds.ssid, (unsigned long)s_attempt + 1,
+                 fast ? "BSSID guardado" : "escaneo completo");
+        set_state(WIFI_MANAGER_STATE_CONNECTING, 0, 0);
+    }
+    return ret;
+}
+
+/**
+ * @brief Programa el siguiente intento tras un fallo o una desconexión
+ */
+static void schedule_retry(uint8_t reason)
+{
+    const uint32_t delay_ms = backoff_delay_ms(s_attempt);
+    s_attempt++;
+    esp_timer_stop(s_retry_timer);
+    esp_timer_start_once(s_retry_timer, (uint64_t)delay_ms * 1000);
+    ESP_LOGI(TAG, "Reintento %lu en %lu ms (motivo %u)", (unsigned long)s_attempt, (unsigned long)delay_ms, reason);
+    set_state(WIFI_MANAGER_STATE_BACKOFF, reason, delay_ms);
+}
+
+/**
+ * @brief Reacciona a un intento que no se pudo iniciar
+ *
+ * Si el WiFi fue apagado desde la UI no tiene sentido seguir reintentando.
+ */
+static void attempt_failed(esp_err_t err)
+{
+    if (err == ESP_ERR_WIFI_NOT_STARTED || err == ESP_ERR_WIFI_NOT_INIT) {
+        esp_timer_stop(s_retry_timer);
+        set_state(WIFI_MANAGER_STATE_IDLE, 0, 0);
+    } else {
+        schedule_retry(0);
+    }
+}
+
+static void retry_timer_cb(void *arg)
+{
+    (void)arg;
+    // El estado solo se modifica en la tarea del bucle de eventos
+    esp_event_post(WIFI_MANAGER_CMD, WIFI_CMD_RETRY, NULL, 0, 0);
+}
+
+/**
+ * @brief Cambia a las credenciales indicadas y reinicia los intentos
+ */
+static void apply_credentials(const wifi_credentials_t *creds)
+{
+    esp_timer_stop(s_retry_timer);
+    if (s_state == WIFI_MANAGER_STATE_CONNECTED || s_state == WIFI_MANAGER_STATE_CONNECTING) {
+        s_switching = true;
+        esp_wifi_disconnect();
+    }
+
+    if (!s_creds_valid || strcmp(s_creds.ssid, creds->ssid) != 0) {
+        wifi_prov_get_ap_info(creds->ssid, &s_ap);
+    }
+    s_creds = *creds;
+    s_creds_valid = true;
+    s_attempt = 0;
+
+    portENTER_CRITICAL(&s_lock);
+    s_stats.disconnected_at_us = esp_timer_get_time();
+    portEXIT_CRITICAL(&s_lock);
+
+    const esp_err_t err = start_attempt();
+    if (err != ESP_OK) {
+        attempt_failed(err);
+    }
+}
+
+static void cmd_event_handler(void* arg, esp_event_base_t event_base, int32_t event_id, void* event_data)
+{
+    if (event_id == WIFI_CMD_RETRY) {
+        if (s_state == WIFI_MANAGER_STATE_BACKOFF) {
+            const esp_err_t err = start_attempt();
+            if (err != ESP_OK) {
+                attempt_failed(err);
+            }
+        }
+    } else if (event_id == WIFI_CMD_CONNECT) {
+        apply_credentials(event_data);
+    }
+}
+
+/**
+ * @brief Registra el AP actual y la duración de la reconexión al obtener IP
+ */
+static void on_connected(void)
+{
+    const int64_t now = esp_timer_get_time();
+
+    wifi_ap_record_t ap_record;
+    if (esp_wifi_sta_get_ap_info(&ap_record) == ESP_OK) {
+        memcpy(s_ap.bssid, ap_record.bssid, sizeof(s_ap.bssid));
+        s_ap.channel = ap_record.primary;
+        s_ap.valid = true;
+        portENTER_CRITICAL(&s_lock);
+        s_stats.last_rssi = ap_record.rssi;
+        portEXIT_CRITICAL(&s_lock);
+    }
+    // Guardar las credenciales solo cuando se comprobó que funcionan
+    wifi_prov_save_credentials(&s_creds, &s_ap);
+
+    portENTER_CRITICAL(&s_lock);
+    s_stats.connects++;
+    if (s_stats.disconnected_at_us) {
+        const uint32_t ms = (uint32_t)((now - s_stats.disconnected_at_us) / 1000);
+        s_stats.reconnect_last_ms = ms;
+        if (ms > s_stats.reconnect_max_ms) {
+            s_stats.reconnect_max_ms = ms;
+        }
+        s_stats.disconnected_at_us = 0;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    s_attempt = 0;
+    set_state(WIFI_MANAGER_STATE_CONNECTED, 0, 0);
+}
 
 static void wifi_event_handler(void* arg, esp_event_base_t event_base, int32_t event_id, void* event_data)
 {
     if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
-        if (s_retry_num < 5) {
-            esp_wifi_connect();
-            s_retry_num++;
-            ESP_LOGI(TAG, "Reintentando conexión WiFi (%d)", s_retry_num);
+        const wifi_event_sta_disconnected_t *ev = event_data;
+        xEventGroupClearBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
+
+        if (s_switching && ev->reason == WIFI_REASON_ASSOC_LEAVE) {
+            // Desconexión de la red anterior pedida por wifi_manager_connect()
+            s_switching = false;
+            return;
+        }
+
+        portENTER_CRITICAL(&s_lock);
+        s_stats.last_reason = ev->reason;
+        if (s_state == WIFI_MANAGER_STATE_CONNECTED) {
+            s_stats.disconnects++;
+            s_stats.disconnected_at_us = esp_timer_get_time();
+        }
+        portEXIT_CRITICAL(&s_lock);
+
+        if (s_creds_valid && s_state != WIFI_MANAGER_STATE_IDLE) {
+            schedule_retry(ev->reason);
         } else {
-            xEventGroupSetBits(s_wifi_event_group, WIFI_FAIL_BIT);
+            set_state(WIFI_MANAGER_STATE_IDLE, ev->reason, 0);
         }
     } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
-        s_retry_num = 0;
+        on_connected();
         xEventGroupSetBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
         // Inicializar mDNS una sola vez
         static bool mdns_started = false;
@@ -45,23 +285,34 @@ static void wifi_event_handler(void* arg, esp_event_base_t event_base, int32_t e
             mdns_init();
             mdns_hostname_set("horno");
             mdns_service_add(NULL, "_ws", "_tcp", WS_SERVER_PORT, NULL, 0);
-            ws_server_start();
             mdns_started = true;
             ESP_LOGI(TAG, "mDNS hostname 'horno.local' registrado");
         }
     }
 }
 
-esp_err_t wifi_manager_init(lv_obj_t *dropdown, lv_obj_t *datetime_label) {
-    ESP_LOGI(TAG, "Inicializando WiFi...");
+/**
+ * @brief Proveedor de métricas del gestor WiFi
+ */
+static void wifi_metrics(metrics_writer_t *w, void *ctx)
+{
+    (void)ctx;
+    wifi_manager_stats_t st;
+    wifi_manager_get_stats(&st);
+    metrics_write_uint(w, "wifi_state", NULL, s_state);
+    metrics_write_uint(w, "wifi_attempts_total", NULL, st.attempts);
+    metrics_write_uint(w, "wifi_fast_attempts_total", NULL, st.fast_attempts);
+    metrics_write_uint(w, "wifi_connects_total", NULL, st.connects);
+    metrics_write_uint(w, "wifi_disconnects_total", NULL, st.disconnects);
+    metrics_write_uint(w, "wifi_last_disconnect_reason", NULL, st.last_reason);
+    metrics_write_uint(w, "wifi_reconnect_last_ms", NULL, st.reconnect_last_ms);
+    metrics_write_uint(w, "wifi_reconnect_max_ms", NULL, st.reconnect_max_ms);
+}
 
-    // Inicializa el almacenamiento no volátil
-    esp_err_t ret = nvs_flash_init();
-    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
-        ESP_ERROR_CHECK(nvs_flash_erase());
-        ESP_ERROR_CHECK(nvs_flash_init());
-    }
+esp_err_t wifi_manager_init(void) {
+    ESP_LOGI(TAG, "Inicializando WiFi...");
 
+    // NVS debe estar inicializado antes de esp_wifi_init (lo hace la etapa de arranque "nvs")
     ESP_ERROR_CHECK(esp_netif_init());
     ESP_ERROR_CHECK(esp_event_loop_create_default());
     esp_netif_create_default_wifi_sta();
@@ -70,64 +321,84 @@ esp_err_t wifi_manager_init(lv_obj_t *dropdown, lv_obj_t *datetime_label) {
     ESP_ERROR_CHECK(esp_wifi_init(&cfg));
     ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
 
-    // Reemplazar bloque de configuración hard-coded
-    wifi_credentials_t creds;
-    if (wifi_prov_get_credentials(&creds) != ESP_OK) {
-        ESP_LOGW(TAG, "Sin credenciales en NVS; iniciando provisioning BLE");
-        wifi_prov_start_ble_provisioning();
-        // Fallback temporal mientras se prueba
-        strcpy(creds.ssid, "DemoSSID");
-        strcpy(creds.password, "password");
-    }
+    const esp_timer_create_args_t timer_args = {
+        .callback = retry_timer_cb,
+        .name = "wifi_retry",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&timer_args, &s_retry_timer));
 
-    wifi_config_t wifi_config = { 0 };
-    strncpy((char *)wifi_config.sta.ssid, creds.ssid, sizeof(wifi_config.sta.ssid));
-    strncpy((char *)wifi_config.sta.password, creds.password, sizeof(wifi_config.sta.password));
+    // Registrar los eventos antes de conectar para no perder el primer GOT_IP
+    s_wifi_event_group = xEventGroupCreateStatic(&s_wifi_event_group_buffer);
+    mem_budget_claim(MEM_MOD_WIFI, MEM_REGION_INTERNAL, sizeof(s_wifi_event_group_buffer));
+    ESP_ERROR_CHECK(esp_event_handler_instance_register(WIFI_EVENT, WIFI_EVENT_STA_DISCONNECTED, &wifi_event_handler, NULL, NULL));
+    ESP_ERROR_CHECK(esp_event_handler_instance_register(IP_EVENT, IP_EVENT_STA_GOT_IP, &wifi_event_handler, NULL, NULL));
+    ESP_ERROR_CHECK(esp_event_handler_instance_register(WIFI_MANAGER_CMD, ESP_EVENT_ANY_ID, &cmd_event_handler, NULL, NULL));
+    metrics_register("wifi", wifi_metrics, NULL);
 
-    ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_config));
     ESP_ERROR_CHECK(esp_wifi_start());
-    ESP_ERROR_CHECK(esp_wifi_connect());
 
-    ESP_LOGI(TAG, "Conectado a Yahel2023");
+    wifi_credentials_t creds;
+    if (wifi_prov_get_credentials(&creds) != ESP_OK) {
+        ESP_LOGW(TAG, "Sin credenciales en NVS; esperando configuración desde la UI");
+        wifi_prov_start_ble_provisioning();
+        return ESP_OK;
+    }
 
-    // Espera para permitir escaneo de redes
-    vTaskDelay(pdMS_TO_TICKS(3000));
+    return esp_event_post(WIFI_MANAGER_CMD, WIFI_CMD_CONNECT, &creds, sizeof(creds), portMAX_DELAY);
+}
 
-    // Escaneo de redes y construcción de lista para el dropdown
-    uint16_t ap_num = 0;
-    wifi_ap_record_t ap_records[20];
+esp_err_t wifi_manager_connect(const char *ssid, const char *password) {
+    if (ssid == NULL || password == NULL || ssid[0] == '\0') {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // Recortar una clave la haría inválida: se rechaza en lugar de truncarla
+    const size_t ssid_len = strnlen(ssid, WIFI_SSID_MAX_LEN + 1);
+    const size_t pass_len = strnlen(password, WIFI_PASS_MAX_LEN + 1);
+    if (ssid_len > WIFI_SSID_MAX_LEN || pass_len > WIFI_PASS_MAX_LEN) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_retry_timer == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
 
-    ESP_ERROR_CHECK(esp_wifi_scan_start(NULL, true));
-    ESP_ERROR_CHECK(esp_wifi_scan_get_ap_num(&ap_num));
-    ESP_ERROR_CHECK(esp_wifi_scan_get_ap_records(&ap_num, ap_records));
+    wifi_credentials_t creds = { 0 };
+    memcpy(creds.ssid, ssid, ssid_len);
+    memcpy(creds.password, password, pass_len);
+    return esp_event_post(WIFI_MANAGER_CMD, WIFI_CMD_CONNECT, &creds, sizeof(creds), pdMS_TO_TICKS(100));
+}
 
-    static char options[512] = "";
-    options[0] = '\0';
+wifi_manager_state_t wifi_manager_get_state(void) {
+    return s_state;
+}
 
-    for (int i = 0; i < ap_num && i < 20; i++) {
-        strcat(options, (const char *)ap_records[i].ssid);
-        if (i < ap_num - 1) strcat(options, "\n");
-    }
+const char *wifi_manager_state_name(wifi_manager_state_t state) {
+    return state < WIFI_MANAGER_STATE_COUNT ? state_names[state] : "?";
+}
 
-    if (dropdown != NULL) {
-        lv_dropdown_set_options(dropdown, options);
-        ESP_LOGI(TAG, "Redes actualizadas en el dropdown.");
+void wifi_manager_get_stats(wifi_manager_stats_t *stats) {
+    if (stats == NULL) {
+        return;
     }
+    portENTER_CRITICAL(&s_lock);
+    *stats = s_stats;
+    portEXIT_CRITICAL(&s_lock);
+}
 
-    // Usar el nuevo sistema de tiempo para sincronización automática
-    ESP_LOGI(TAG, "Sincronizando tiempo con la red usando el nuevo sistema...");
-    system_time_update_from_network();
-    
-    // Iniciar timer de actualización automática
-    system_time_start_auto_update();
-    
-    ESP_LOGI(TAG, "Sistema de tiempo integrado con WiFi completado");
-
-    ESP_LOGI(TAG, "WiFi y hora configurados correctamente.");
-
-    s_wifi_event_group = xEventGroupCreate();
-    ESP_ERROR_CHECK(esp_event_handler_instance_register(WIFI_EVENT, ESP_EVENT_ANY_ID, &wifi_event_handler, NULL, NULL));
-    ESP_ERROR_CHECK(esp_event_handler_instance_register(IP_EVENT, IP_EVENT_STA_GOT_IP, &wifi_event_handler, NULL, NULL));
+void wifi_manager_log_stats(void) {
+    wifi_manager_stats_t st;
+    wifi_manager_get_stats(&st);
+    ESP_LOGI(TAG, "Estado %s: %lu intentos (%lu rápidos), %lu conexiones, %lu caídas, "
+             "reconexión última %lu ms / máx %lu ms, último motivo %u",
+             wifi_manager_state_name(s_state), (unsigned long)st.attempts, (unsigned long)st.fast_attempts,
+             (unsigned long)st.connects, (unsigned long)st.disconnects,
+             (unsigned long)st.reconnect_last_ms, (unsigned long)st.reconnect_max_ms, st.last_reason);
+}
 
-    return ESP_OK;
-} 
\ No newline at end of file
+bool wifi_manager_wait_connected(uint32_t timeout_ms) {
+    if (s_wifi_event_group == NULL) {
+        return false;
+    }
+    EventBits_t bits = xEventGroupWaitBits(s_wifi_event_group, WIFI_CONNECTED_BIT, pdFALSE, pdFALSE,
+                                           pdMS_TO_TICKS(timeout_ms));
+    return (bits & WIFI_CONNECTED_BIT) != 0;
+}
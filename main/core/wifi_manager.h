@@ -7,18 +7,106 @@
 #define WIFI_MANAGER_H
 
 #include "esp_err.h"
-#include "lvgl.h"
+#include "esp_event.h"
+#include <stdbool.h>
+#include <stdint.h>
 
 /**
- * @brief Inicializa el stack de WiFi, escanea redes y sincroniza la hora vía SNTP
+ * @brief Base de los eventos de estado del gestor WiFi
+ *
+ * El identificador del evento es el nuevo estado (wifi_manager_state_t) y el dato
+ * un wifi_manager_event_t. Se publican en el bucle de eventos por defecto.
+ */
+ESP_EVENT_DECLARE_BASE(WIFI_MANAGER_EVENT);
+
+/**
+ * @brief Estados de la conexión
+ */
+typedef enum {
+    WIFI_MANAGER_STATE_IDLE = 0,    ///< Sin credenciales configuradas
+    WIFI_MANAGER_STATE_CONNECTING,  ///< Intento de conexión en curso
+    WIFI_MANAGER_STATE_CONNECTED,   ///< Conectado y con IP
+    WIFI_MANAGER_STATE_BACKOFF,     ///< Esperando para reintentar
+    WIFI_MANAGER_STATE_COUNT
+} wifi_manager_state_t;
+
+/**
+ * @brief Dato de los eventos WIFI_MANAGER_EVENT
+ */
+typedef struct {
+    wifi_manager_state_t state; ///< Nuevo estado
+    uint32_t attempt;           ///< Intentos fallidos desde la última conexión
+    uint8_t reason;             ///< Motivo de desconexión (wifi_err_reason_t), 0 si no aplica
+    uint32_t retry_in_ms;       ///< Retardo hasta el próximo intento (estado BACKOFF)
+} wifi_manager_event_t;
+
+/**
+ * @brief Estadísticas de conexión
+ */
+typedef struct {
+    uint32_t attempts;              ///< Intentos de conexión iniciados
+    uint32_t fast_attempts;         ///< Intentos con BSSID y canal guardados
+    uint32_t connects;              ///< Veces que se obtuvo IP
+    uint32_t disconnects;           ///< Pérdidas de una conexión establecida
+    uint32_t reconnect_last_ms;     ///< Tiempo desde la caída (o el pedido de conexión) hasta obtener IP
+    uint32_t reconnect_max_ms;      ///< Peor tiempo de reconexión
+    int64_t disconnected_at_us;     ///< Instante de la caída en curso (0 si conectado)
+    int8_t last_rssi;               ///< RSSI del AP al conectar
+    uint8_t last_reason;            ///< Último motivo de desconexión
+} wifi_manager_stats_t;
+
+/**
+ * @brief Inicializa el stack de WiFi e inicia la conexión con las credenciales guardadas
+ * 
+ * No bloquea esperando la conexión: mDNS y el servidor WebSocket se inician al obtener IP.
+ * Tras cada fallo se reintenta sin límite con retardo exponencial y jitter; los primeros
+ * intentos usan el BSSID y canal del último AP con el que se conectó.
+ * Requiere NVS inicializado.
  * 
- * @param dropdown Elemento dropdown de LVGL para mostrar las redes WiFi
- * @param datetime_label Elemento label de LVGL para mostrar la fecha y hora (puede ser NULL)
  * @return esp_err_t ESP_OK si la inicialización fue exitosa
+ */
+esp_err_t wifi_manager_init(void);
+
+/**
+ * @brief Conecta a otra red
+ * 
+ * No bloquea: el resultado se publica como eventos WIFI_MANAGER_EVENT. Las credenciales
+ * se guardan en NVS, junto con el AP, cuando se obtiene IP.
+ * 
+ * @param ssid Nombre de la red (hasta 32 caracteres)
+ * @param password Clave de la red (hasta 64 caracteres: admite una PSK hexadecimal)
+ * @return esp_err_t ESP_OK si el pedido fue aceptado, ESP_ERR_INVALID_ARG si un campo no cabe
+ */
+esp_err_t wifi_manager_connect(const char *ssid, const char *password);
+
+/**
+ * @brief Obtiene el estado actual de la conexión
+ */
+wifi_manager_state_t wifi_manager_get_state(void);
+
+/**
+ * @brief Nombre legible de un estado
+ */
+const char *wifi_manager_state_name(wifi_manager_state_t state);
+
+/**
+ * @brief Obtiene las estadísticas de conexión
+ * 
+ * @param stats Estructura donde se copiarán las estadísticas
+ */
+void wifi_manager_get_stats(wifi_manager_stats_t *stats);
+
+/**
+ * @brief Imprime en el log las estadísticas de conexión
+ */
+void wifi_manager_log_stats(void);
+
+/**
+ * @brief Espera a que la estación obtenga IP
  * 
- * @note El parámetro datetime_label se mantiene por compatibilidad pero se recomienda
- *       usar el módulo statusbar_manager para gestión de la hora en la barra de estado
+ * @param timeout_ms Tiempo máximo de espera
+ * @return true si hay conexión
  */
-esp_err_t wifi_manager_init(lv_obj_t *dropdown, lv_obj_t *datetime_label);
+bool wifi_manager_wait_connected(uint32_t timeout_ms);
 
 #endif /* WIFI_MANAGER_H */ 
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "wifi_prov.h"
+#include "bt.h"
 #include "esp_log.h"
 #include "nvs_flash.h"
 #include "nvs.h"
@@ -6,6 +7,7 @@
 
 static const char *TAG = "wifi_prov";
 #define NVS_NAMESPACE "wifi_cfg"
+#define NVS_STR_MAX   (WIFI_PASS_MAX_LEN + 1)  ///< La cadena más larga guardada, con el '\0'
 
 esp_err_t wifi_prov_get_credentials(wifi_credentials_t *cred)
 {
@@ -36,9 +38,95 @@ esp_err_t wifi_prov_get_credentials(wifi_credentials_t *cred)
     return ESP_OK;
 }
 
+/**
+ * @brief Escribe una cadena solo si difiere de la guardada
+ */
+static esp_err_t nvs_set_str_if_changed(nvs_handle_t handle, const char *key, const char *value, bool *changed)
+{
+    char current[NVS_STR_MAX];
+    size_t len = sizeof(current);
+    if (nvs_get_str(handle, key, current, &len) == ESP_OK && strcmp(current, value) == 0) {
+        return ESP_OK;
+    }
+    *changed = true;
+    return nvs_set_str(handle, key, value);
+}
+
+esp_err_t wifi_prov_save_credentials(const wifi_credentials_t *cred, const wifi_ap_info_t *ap)
+{
+    if (!cred) return ESP_ERR_INVALID_ARG;
+
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "No se pudo abrir NVS: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    bool changed = false;
+    err = nvs_set_str_if_changed(handle, "ssid", cred->ssid, &changed);
+    if (err == ESP_OK) {
+        err = nvs_set_str_if_changed(handle, "pass", cred->password, &changed);
+    }
+
+    if (err == ESP_OK && ap && ap->valid) {
+        uint8_t blob[7];
+        size_t len = sizeof(blob);
+        if (nvs_get_blob(handle, "ap", blob, &len) != ESP_OK || len != sizeof(blob) ||
+            memcmp(blob, ap->bssid, 6) != 0 || blob[6] != ap->channel) {
+            memcpy(blob, ap->bssid, 6);
+            blob[6] = ap->channel;
+            err = nvs_set_blob(handle, "ap", blob, sizeof(blob));
+            changed = true;
+        }
+    }
+
+    if (err == ESP_OK && changed) {
+        err = nvs_commit(handle);
+        ESP_LOGI(TAG, "Credenciales guardadas: SSID=%s", cred->ssid);
+    }
+    nvs_close(handle);
+    return err;
+}
+
+esp_err_t wifi_prov_get_ap_info(const char *ssid, wifi_ap_info_t *ap)
+{
+    if (!ssid || !ap) return ESP_ERR_INVALID_ARG;
+    memset(ap, 0, sizeof(*ap));
+
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READONLY, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    // El BSSID guardado solo sirve si pertenece a la red configurada
+    char saved_ssid[WIFI_SSID_MAX_LEN + 1];
+    size_t ssid_len = sizeof(saved_ssid);
+    uint8_t blob[7];
+    size_t len = sizeof(blob);
+    err = nvs_get_str(handle, "ssid", saved_ssid, &ssid_len);
+    if (err == ESP_OK) {
+        err = nvs_get_blob(handle, "ap", blob, &len);
+    }
+    nvs_close(handle);
+
+    if (err != ESP_OK || len != sizeof(blob) || strcmp(saved_ssid, ssid) != 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    memcpy(ap->bssid, blob, 6);
+    ap->channel = blob[6];
+    ap->valid = true;
+    return ESP_OK;
+}
+
 esp_err_t wifi_prov_start_ble_provisioning(void)
 {
-    // Placeholder: en implementación completa se integrará wifi_provisioning.
-    ESP_LOGW(TAG, "Provisioning BLE no implementado (stub)");
-    return ESP_ERR_NOT_SUPPORTED;
+    // El servicio GATT de provisioning se publica junto con el de telemetría
+    esp_err_t err = bt_start();
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "No se pudo iniciar el provisioning BLE: %s", esp_err_to_name(err));
+    }
+    return err;
 } 
\ No newline at end of file
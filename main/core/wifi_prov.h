@@ -1,19 +1,35 @@
 #pragma once
 
 #include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#define WIFI_SSID_MAX_LEN   32  ///< Largo máximo del SSID (wifi_sta_config_t::ssid)
+#define WIFI_PASS_MAX_LEN   64  ///< Largo máximo de la clave: PSK de 64 dígitos hexadecimales
+
 /**
  * @brief Estructura que contiene las credenciales Wi-Fi.
  */
 typedef struct {
-    char ssid[32];
-    char password[64];
+    char ssid[WIFI_SSID_MAX_LEN + 1];
+    char password[WIFI_PASS_MAX_LEN + 1];
 } wifi_credentials_t;
 
+/**
+ * @brief Último punto de acceso con el que se obtuvo IP.
+ *
+ * Permite reconectar sin escanear todos los canales.
+ */
+typedef struct {
+    uint8_t bssid[6];
+    uint8_t channel;
+    bool valid;         ///< false si no hay datos o pertenecen a otro SSID
+} wifi_ap_info_t;
+
 /**
  * @brief Obtiene las credenciales Wi-Fi almacenadas en NVS.
  *
@@ -22,9 +38,30 @@ typedef struct {
  */
 esp_err_t wifi_prov_get_credentials(wifi_credentials_t *cred);
 
+/**
+ * @brief Guarda las credenciales y el punto de acceso con el que se conectó.
+ *
+ * Solo escribe en NVS los campos que cambiaron.
+ *
+ * @param cred  Credenciales usadas en la conexión.
+ * @param ap    BSSID y canal del AP (puede ser NULL para no guardarlos).
+ * @return ESP_OK si se guardaron correctamente.
+ */
+esp_err_t wifi_prov_save_credentials(const wifi_credentials_t *cred, const wifi_ap_info_t *ap);
+
+/**
+ * @brief Obtiene el último punto de acceso guardado para el SSID indicado.
+ *
+ * @param ssid      SSID de las credenciales actuales.
+ * @param[out] ap   Datos del AP; `valid` es false si no corresponden a `ssid`.
+ * @return ESP_OK si se encontraron datos para ese SSID.
+ */
+esp_err_t wifi_prov_get_ap_info(const char *ssid, wifi_ap_info_t *ap);
+
 /**
  * @brief Inicia el proceso de provisioning BLE para capturar SSID/clave.
- *        Implementación placeholder.
+ *        Publica el servicio GATT de provisioning (ver ble_service.h); la
+ *        conexión se aplica con wifi_manager_connect().
  */
 esp_err_t wifi_prov_start_ble_provisioning(void);
 
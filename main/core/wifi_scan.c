@@ -0,0 +1,331 @@
+/**
+ * @file wifi_scan.c
+ * @brief Implementación del escaneo de redes WiFi en segundo plano.
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#include "wifi_scan.h"
+#include "ui_queue.h"
+#include "esp_wifi.h"
+#include "esp_event.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "scheduler.h"
+#include "mem_budget.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <string.h>
+
+static const char *TAG = "wifi_scan";
+
+#define SCAN_RETRY_MS   3000    ///< Espera antes de reintentar si el WiFi está ocupado
+
+static wifi_scan_result_t s_cache[WIFI_SCAN_MAX_RESULTS];
+static size_t s_count = 0;
+static wifi_scan_stats_t s_stats;
+static SemaphoreHandle_t s_mutex = NULL;        ///< Protege la caché y las estadísticas
+static StaticSemaphore_t s_mutex_buffer;
+
+static bool s_scanning = false;
+static int64_t s_scan_start_us = 0;
+static sched_job_handle_t s_retry_job = NULL;
+static portMUX_TYPE s_flag_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static lv_obj_t *s_dropdown = NULL;
+static volatile bool s_ui_pending = false;      ///< Ya hay una actualización del dropdown encolada
+
+/**
+ * @brief Incorpora un registro de AP a la caché (mutex tomado)
+ * @details Una entrada por SSID: si el SSID ya se vio en este escaneo se conserva el AP
+ *          de mejor señal; si la caché está llena se reemplaza la red más débil.
+ */
+static void cache_merge(const wifi_ap_record_t *rec)
+{
+    const char *ssid = (const char *)rec->ssid;
+    if (ssid[0] == '\0') {
+        return; // Red oculta: no se puede elegir desde el dropdown
+    }
+
+    wifi_scan_result_t *slot = NULL;
+    for (size_t i = 0; i < s_count; i++) {
+        if (strncmp(s_cache[i].ssid, ssid, sizeof(s_cache[i].ssid)) == 0) {
+            if (s_cache[i].age == 0 && s_cache[i].rssi >= rec->rssi) {
+                return; // Duplicado más débil del mismo escaneo
+            }
+            slot = &s_cache[i];
+            break;
+        }
+    }
+
+    if (slot == NULL) {
+        if (s_count < WIFI_SCAN_MAX_RESULTS) {
+            slot = &s_cache[s_count++];
+        } else {
+            size_t weakest = 0;
+            for (size_t i = 1; i < s_count; i++) {
+                if (s_cache[i].rssi < s_cache[weakest].rssi) {
+                    weakest = i;
+                }
+            }
+            if (s_cache[weakest].rssi >= rec->rssi) {
+                return;
+            }
+            slot = &s_cache[weakest];
+        }
+        strlcpy(slot->ssid, ssid, sizeof(slot->ssid));
+    }
+
+    slot->rssi = rec->rssi;
+    slot->channel = rec->primary;
+    slot->auth = rec->authmode;
+    slot->age = 0;
+}
+
+/**
+ * @brief Elimina las redes que no se ven hace tiempo y ordena por RSSI (mutex tomado)
+ */
+static void cache_finish(void)
+{
+    size_t kept = 0;
+    for (size_t i = 0; i < s_count; i++) {
+        if (s_cache[i].age < WIFI_SCAN_MAX_AGE) {
+            s_cache[kept++] = s_cache[i];
+        }
+    }
+    s_count = kept;
+
+    // Inserción: la caché es pequeña y casi siempre ya está ordenada
+    for (size_t i = 1; i < s_count; i++) {
+        const wifi_scan_result_t item = s_cache[i];
+        size_t j = i;
+        while (j > 0 && s_cache[j - 1].rssi < item.rssi) {
+            s_cache[j] = s_cache[j - 1];
+            j--;
+        }
+        s_cache[j] = item;
+    }
+}
+
+/**
+ * @brief Actualiza el dropdown asociado (se ejecuta en la tarea de LVGL)
+ */
+static void update_dropdown(void *arg)
+{
+    (void)arg;
+    s_ui_pending = false;
+    if (s_dropdown == NULL) {
+        return;
+    }
+
+    static char options[WIFI_SCAN_MAX_RESULTS * sizeof(((wifi_scan_result_t *)0)->ssid)];
+    wifi_scan_build_options(options, sizeof(options));
+
+    // Reasignar las mismas opciones cerraría la lista si el usuario la tiene abierta
+    if (strcmp(lv_dropdown_get_options(s_dropdown), options) != 0) {
+        lv_dropdown_set_options(s_dropdown, options);
+    }
+}
+
+static void request_dropdown_update(void)
+{
+    if (s_dropdown != NULL && !s_ui_pending) {
+        s_ui_pending = true;
+        if (ui_queue_post(update_dropdown, NULL) != ESP_OK) {
+            s_ui_pending = false;
+        }
+    }
+}
+
+static void scan_done_handler(void *arg, esp_event_base_t base, int32_t id, void *data)
+{
+    const wifi_event_sta_scan_done_t *ev = data;
+
+    portENTER_CRITICAL(&s_flag_lock);
+    const bool ours = s_scanning;
+    s_scanning = false;
+    portEXIT_CRITICAL(&s_flag_lock);
+    if (!ours) {
+        return;
+    }
+
+    const uint32_t duration_ms = (uint32_t)((esp_timer_get_time() - s_scan_start_us) / 1000);
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    if (ev->status != 0) {
+        s_stats.failures++;
+        xSemaphoreGive(s_mutex);
+        esp_wifi_clear_ap_list();
+        ESP_LOGW(TAG, "Escaneo fallido");
+        return;
+    }
+
+    for (size_t i = 0; i < s_count; i++) {
+        if (s_cache[i].age < UINT8_MAX) {
+            s_cache[i].age++;
+        }
+    }
+
+    // Leer los registros de uno en uno: el driver libera cada registro al entregarlo
+    wifi_ap_record_t rec;
+    uint32_t seen = 0;
+    while (esp_wifi_scan_get_ap_record(&rec) == ESP_OK) {
+        cache_merge(&rec);
+        seen++;
+    }
+    esp_wifi_clear_ap_list();
+    cache_finish();
+
+    s_stats.scans++;
+    s_stats.last_duration_ms = duration_ms;
+    s_stats.last_seen = seen;
+    s_stats.cached = s_count;
+    xSemaphoreGive(s_mutex);
+
+    ESP_LOGI(TAG, "Escaneo en %lu ms: %lu registros, %u redes en caché",
+             (unsigned long)duration_ms, (unsigned long)seen, (unsigned)s_count);
+    request_dropdown_update();
+}
+
+static void retry_job(void *arg)
+{
+    (void)arg;
+    wifi_scan_start();
+}
+
+/**
+ * @brief Refresca la lista cada vez que el usuario abre el dropdown
+ */
+static void dropdown_event_cb(lv_event_t *e)
+{
+    (void)e;
+    wifi_scan_start();
+}
+
+/**
+ * @brief Asocia el dropdown desde la tarea de LVGL
+ */
+static void bind_dropdown_job(void *arg)
+{
+    lv_obj_t *dropdown = arg;
+    if (s_dropdown != NULL) {
+        lv_obj_remove_event_cb(s_dropdown, dropdown_event_cb);
+    }
+    s_dropdown = dropdown;
+    if (dropdown != NULL) {
+        lv_obj_add_event_cb(dropdown, dropdown_event_cb, LV_EVENT_CLICKED, NULL);
+        update_dropdown(NULL);
+    }
+}
+
+esp_err_t wifi_scan_init(void)
+{
+    if (s_mutex != NULL) {
+        return ESP_OK;
+    }
+
+    s_mutex = xSemaphoreCreateMutexStatic(&s_mutex_buffer);
+    mem_budget_claim(MEM_MOD_WIFI, MEM_REGION_INTERNAL, sizeof(s_mutex_buffer));
+
+    esp_err_t ret = sched_add("wifi_scan_retry", retry_job, NULL, SCHED_DISARMED, 0, &s_retry_job);
+    if (ret == ESP_OK) {
+        ret = esp_event_handler_register(WIFI_EVENT, WIFI_EVENT_SCAN_DONE, scan_done_handler, NULL);
+    }
+    return ret;
+}
+
+void wifi_scan_bind_dropdown(lv_obj_t *dropdown)
+{
+    if (ui_queue_post(bind_dropdown_job, dropdown) != ESP_OK) {
+        ESP_LOGW(TAG, "No se pudo asociar el dropdown");
+    }
+}
+
+esp_err_t wifi_scan_start(void)
+{
+    if (s_mutex == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    portENTER_CRITICAL(&s_flag_lock);
+    const bool busy = s_scanning;
+    s_scanning = true;
+    portEXIT_CRITICAL(&s_flag_lock);
+    if (busy) {
+        return ESP_OK;
+    }
+
+    s_scan_start_us = esp_timer_get_time();
+    esp_err_t ret = esp_wifi_scan_start(NULL, false);
+    if (ret == ESP_OK) {
+        return ESP_OK;
+    }
+
+    portENTER_CRITICAL(&s_flag_lock);
+    s_scanning = false;
+    portEXIT_CRITICAL(&s_flag_lock);
+
+    if (ret == ESP_ERR_WIFI_STATE) {
+        // La estación está conectando: volver a intentar cuando termine
+        sched_trigger(s_retry_job, SCAN_RETRY_MS);
+        ESP_LOGD(TAG, "WiFi ocupado; escaneo reprogramado");
+        return ESP_OK;
+    }
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    s_stats.failures++;
+    xSemaphoreGive(s_mutex);
+    ESP_LOGW(TAG, "No se pudo iniciar el escaneo: %s", esp_err_to_name(ret));
+    return ret;
+}
+
+size_t wifi_scan_get_results(wifi_scan_result_t *out, size_t max)
+{
+    if (out == NULL || s_mutex == NULL) {
+        return 0;
+    }
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    const size_t n = s_count < max ? s_count : max;
+    memcpy(out, s_cache, n * sizeof(*out));
+    xSemaphoreGive(s_mutex);
+    return n;
+}
+
+size_t wifi_scan_build_options(char *buf, size_t size)
+{
+    if (buf == NULL || size == 0) {
+        return 0;
+    }
+    buf[0] = '\0';
+    if (s_mutex == NULL) {
+        return 0;
+    }
+
+    size_t len = 0;
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    for (size_t i = 0; i < s_count; i++) {
+        const size_t ssid_len = strlen(s_cache[i].ssid);
+        const size_t sep = (len > 0) ? 1 : 0;
+        if (len + sep + ssid_len >= size) {
+            break;
+        }
+        if (sep) {
+            buf[len++] = '\n';
+        }
+        memcpy(buf + len, s_cache[i].ssid, ssid_len);
+        len += ssid_len;
+    }
+    buf[len] = '\0';
+    xSemaphoreGive(s_mutex);
+    return len;
+}
+
+void wifi_scan_get_stats(wifi_scan_stats_t *stats)
+{
+    if (stats == NULL || s_mutex == NULL) {
+        return;
+    }
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    *stats = s_stats;
+    xSemaphoreGive(s_mutex);
+}
@@ -0,0 +1,102 @@
+/**
+ * @file wifi_scan.h
+ * @brief Escaneo de redes WiFi en segundo plano con caché de resultados.
+ *
+ * El escaneo no bloquea: se inicia y los resultados se leen uno a uno al llegar
+ * `WIFI_EVENT_SCAN_DONE`. Se fusionan en una caché sin duplicados (una entrada por SSID,
+ * con el AP de mejor señal) ordenada por RSSI. Las redes que dejan de verse en varios
+ * escaneos seguidos se eliminan.
+ *
+ * Si hay un dropdown asociado, sus opciones se actualizan a través de la cola de UI.
+ *
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#ifndef WIFI_SCAN_H
+#define WIFI_SCAN_H
+
+#include "esp_err.h"
+#include "esp_wifi_types.h"
+#include "lvgl.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WIFI_SCAN_MAX_RESULTS   24  ///< Redes en la caché
+#define WIFI_SCAN_MAX_AGE       3   ///< Escaneos sin ver una red antes de eliminarla
+
+/**
+ * @brief Red encontrada
+ */
+typedef struct {
+    char ssid[33];              ///< SSID terminado en '\0'
+    int8_t rssi;                ///< Mejor RSSI visto en el último escaneo que la encontró
+    uint8_t channel;            ///< Canal primario del AP con mejor señal
+    wifi_auth_mode_t auth;      ///< Modo de autenticación
+    uint8_t age;                ///< Escaneos desde que se vio por última vez
+} wifi_scan_result_t;
+
+/**
+ * @brief Estadísticas del servicio de escaneo
+ */
+typedef struct {
+    uint32_t scans;             ///< Escaneos completados
+    uint32_t failures;          ///< Escaneos que no pudieron iniciarse o fallaron
+    uint32_t last_duration_ms;  ///< Duración del último escaneo
+    uint32_t last_seen;         ///< Registros de AP recibidos en el último escaneo
+    uint32_t cached;            ///< Redes en la caché
+} wifi_scan_stats_t;
+
+/**
+ * @brief Registra los eventos del escaneo
+ * @details Requiere el WiFi inicializado y el bucle de eventos por defecto creado.
+ * @return ESP_OK si el servicio quedó listo
+ */
+esp_err_t wifi_scan_init(void);
+
+/**
+ * @brief Asocia el dropdown que muestra las redes encontradas
+ * @param dropdown Dropdown de LVGL (NULL para desasociar)
+ */
+void wifi_scan_bind_dropdown(lv_obj_t *dropdown);
+
+/**
+ * @brief Inicia un escaneo sin bloquear
+ * @details Si el WiFi está ocupado conectando, el escaneo se reintenta más tarde.
+ *          Un pedido durante un escaneo en curso no tiene efecto.
+ * @return ESP_OK si el escaneo se inició o quedó programado
+ */
+esp_err_t wifi_scan_start(void);
+
+/**
+ * @brief Copia las redes de la caché, ordenadas por señal
+ * @param out Destino
+ * @param max Número máximo de redes a copiar
+ * @return Número de redes copiadas
+ */
+size_t wifi_scan_get_results(wifi_scan_result_t *out, size_t max);
+
+/**
+ * @brief Construye las opciones del dropdown ("ssid1\nssid2...")
+ * @details Recorta la lista si no cabe; nunca excede `size`.
+ * @param buf Buffer de destino
+ * @param size Tamaño del buffer
+ * @return Longitud escrita (sin contar '\0')
+ */
+size_t wifi_scan_build_options(char *buf, size_t size);
+
+/**
+ * @brief Obtiene las estadísticas del escaneo
+ * @param stats Estructura donde se copiarán las estadísticas
+ */
+void wifi_scan_get_stats(wifi_scan_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WIFI_SCAN_H
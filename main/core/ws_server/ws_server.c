@@ -5,60 +5,319 @@
 #include "freertos/task.h"
 #include "sensor.h"
 #include "pid_controller.h"
-#include "cJSON.h"
+#include "scheduler.h"
+#include "event_bus.h"
+#include "wifi_manager.h"
+#include "metrics.h"
+#include "deadline.h"
+#include "tracer.h"
+#include "log_tap.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#define WS_BROADCAST_PERIOD_MS 1000
+#define WS_BROADCAST_TOLERANCE_US 250000
+#define WS_BROADCAST_BUDGET_US 100000
+#define WS_LOG_PUMP_MS 250
+#define WS_LOG_CHUNK 1024
+#define WS_LOG_CHUNKS_PER_PUMP 4
+#define WS_STATUS_MAX 160       // JSON de estado difundido cada segundo
+#define WS_RX_MAX 128           // Mensaje entrante más largo ("log <filtro>")
 
 static const char *TAG = "ws_server";
 static httpd_handle_t s_server = NULL;
-static TaskHandle_t s_broadcast_task = NULL;
+static sched_job_handle_t s_broadcast_job = NULL;
+static volatile bool s_broadcasting = false;
+static deadline_handle_t s_broadcast_monitor = NULL;
+
+/**
+ * @brief Cliente del log remoto (WebSocket o GET /logs)
+ * @details La tabla solo la tocan los manejadores y el trabajo encolado en la tarea de httpd.
+ */
+typedef struct {
+    log_tap_client_t client;    ///< NULL si la entrada está libre
+    int fd;                     ///< Socket WebSocket, o -1 para un flujo HTTP
+    httpd_req_t *req;           ///< Solicitud asíncrona del flujo HTTP
+} log_stream_t;
+
+static log_stream_t s_log_streams[LOG_TAP_MAX_CLIENTS];
+static char s_log_chunk[WS_LOG_CHUNK];
+static sched_job_handle_t s_log_job = NULL;
+static atomic_bool s_log_pump_queued = false;
+static char s_status_json[WS_STATUS_MAX];   // Solo lo usa el trabajo de difusión
+static uint8_t s_rx_buf[WS_RX_MAX + 1];     // Solo lo usa la tarea de httpd
 
 /************** Helpers JSON **************/
-static char *build_status_json(void)
-{
-    float temp = read_ema_temp();
-    cJSON *root = cJSON_CreateObject();
-    cJSON_AddStringToObject(root, "type", "status");
-    cJSON_AddNumberToObject(root, "temp", temp);
-    cJSON_AddNumberToObject(root, "setpoint", 0.0f); // TODO: obtener setpoint real
-    cJSON_AddBoolToObject(root, "pid_enabled", true); // TODO
-    cJSON_AddBoolToObject(root, "ssr", pid_ssr_status());
-    cJSON_AddBoolToObject(root, "alarm", false);
-    char *str = cJSON_PrintUnformatted(root);
-    cJSON_Delete(root);
-    return str;
-}
-
-/************** Broadcast Task **************/
-static void broadcast_task(void *arg)
-{
-    while (s_server) {
-        size_t clients = CONFIG_LWIP_MAX_SOCKETS;
-        int client_fds[CONFIG_LWIP_MAX_SOCKETS];
-        httpd_get_client_list(s_server, &clients, client_fds);
-        httpd_ws_frame_t frame = {
-            .type = HTTPD_WS_TYPE_TEXT,
-            .payload = NULL,
-            .len = 0
-        };
-        char *payload = build_status_json();
-        if (!payload) {
-            ESP_LOGE(TAG, "No memory for JSON payload");
-            vTaskDelay(pdMS_TO_TICKS(1000));
-            continue;
+// Formato fijo con snprintf: la difusión periódica no reserva memoria
+int ws_server_format_status(char *buf, size_t size)
+{
+    return snprintf(buf, size,
+                    "{\"type\":\"status\",\"temp\":%.2f,\"setpoint\":%.2f,\"pid_enabled\":%s,"
+                    "\"ssr\":%s,\"alarm\":%s}",
+                    read_ema_temp(), pid_get_setpoint(), pid_is_enabled() ? "true" : "false",
+                    pid_ssr_status() ? "true" : "false", pid_get_alarms() != 0 ? "true" : "false");
+}
+
+/************** Broadcast Job **************/
+static void broadcast_status(httpd_handle_t server)
+{
+    size_t clients = CONFIG_LWIP_MAX_SOCKETS;
+    int client_fds[CONFIG_LWIP_MAX_SOCKETS];
+    if (httpd_get_client_list(server, &clients, client_fds) != ESP_OK || clients == 0) {
+        return; // Sin clientes no hace falta armar el JSON
+    }
+    httpd_ws_frame_t frame = {
+        .type = HTTPD_WS_TYPE_TEXT,
+        .payload = NULL,
+        .len = 0
+    };
+    const int len = ws_server_format_status(s_status_json, sizeof(s_status_json));
+    if (len < 0 || len >= (int)sizeof(s_status_json)) {
+        ESP_LOGE(TAG, "Status JSON truncated");
+        return;
+    }
+    frame.payload = (uint8_t *)s_status_json;
+    frame.len = len;
+
+    for (size_t i = 0; i < clients; ++i) {
+        httpd_ws_client_info_t info = httpd_ws_get_fd_info(server, client_fds[i]);
+        if (info == HTTPD_WS_CLIENT_WEBSOCKET) {
+            httpd_ws_send_frame_async(server, client_fds[i], &frame);
+        }
+    }
+}
+
+static void broadcast_job(void *arg)
+{
+    s_broadcasting = true;
+    deadline_begin(s_broadcast_monitor);
+    tracer_mark_begin(TRACER_MARK_WS_BROADCAST);
+    httpd_handle_t server = s_server;
+    if (server) {
+        broadcast_status(server);
+    }
+    tracer_mark_end(TRACER_MARK_WS_BROADCAST);
+    deadline_end(s_broadcast_monitor);
+    s_broadcasting = false;
+}
+
+/************** Trace Dump **************/
+typedef struct {
+    httpd_req_t *req;
+    bool started;       ///< Ya se envió el primer fragmento del mensaje WebSocket
+} ws_dump_ctx_t;
+
+// Cada tramo del volcado es un fragmento de un único mensaje binario
+static esp_err_t ws_dump_write(const void *data, size_t len, void *arg)
+{
+    ws_dump_ctx_t *ctx = arg;
+    httpd_ws_frame_t frame = {
+        .type = ctx->started ? HTTPD_WS_TYPE_CONTINUE : HTTPD_WS_TYPE_BINARY,
+        .fragmented = true,
+        .final = false,
+        .payload = (uint8_t *)data,
+        .len = len
+    };
+    ctx->started = true;
+    return httpd_ws_send_frame(ctx->req, &frame);
+}
+
+static esp_err_t ws_send_trace(httpd_req_t *req)
+{
+    ws_dump_ctx_t ctx = { .req = req };
+    esp_err_t ret = tracer_dump(ws_dump_write, &ctx);
+    if (!ctx.started) {
+        return ret;
+    }
+    // Fragmento final vacío: el tamaño del último tramo no se conoce de antemano
+    httpd_ws_frame_t last = { .type = HTTPD_WS_TYPE_CONTINUE, .fragmented = true, .final = true };
+    return httpd_ws_send_frame(req, &last);
+}
+
+static esp_err_t http_dump_write(const void *data, size_t len, void *arg)
+{
+    return httpd_resp_send_chunk((httpd_req_t *)arg, data, len);
+}
+
+// GET /trace: volcado binario para tools/trace2perfetto.py
+static esp_err_t trace_handler(httpd_req_t *req)
+{
+    httpd_resp_set_type(req, "application/octet-stream");
+    httpd_resp_set_hdr(req, "Content-Disposition", "attachment; filename=\"trace.bin\"");
+    esp_err_t ret = tracer_dump(http_dump_write, req);
+    if (ret == ESP_ERR_INVALID_STATE || ret == ESP_ERR_NOT_SUPPORTED) {
+        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Traza no disponible");
+    }
+    httpd_resp_send_chunk(req, NULL, 0);
+    return ret;
+}
+
+/************** Log Tap **************/
+static log_stream_t *log_stream_find(int fd)
+{
+    for (int i = 0; i < LOG_TAP_MAX_CLIENTS; i++) {
+        if (s_log_streams[i].client && s_log_streams[i].fd == fd) {
+            return &s_log_streams[i];
         }
-        frame.payload = (uint8_t *)payload;
-        frame.len = strlen(payload);
+    }
+    return NULL;
+}
 
-        for (size_t i = 0; i < clients; ++i) {
-            httpd_ws_client_info_t info = httpd_ws_get_fd_info(s_server, client_fds[i]);
-            if (info == HTTPD_WS_CLIENT_WEBSOCKET) {
-                httpd_ws_send_frame_async(s_server, client_fds[i], &frame);
+static esp_err_t log_stream_open(const char *filter, int fd, log_stream_t **out)
+{
+    log_stream_t *s = NULL;
+    for (int i = 0; s == NULL && i < LOG_TAP_MAX_CLIENTS; i++) {
+        if (s_log_streams[i].client == NULL) {
+            s = &s_log_streams[i];
+        }
+    }
+    if (s == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    esp_err_t ret = log_tap_client_open(filter, &s->client);
+    if (ret != ESP_OK) {
+        s->client = NULL;
+        return ret;
+    }
+    s->fd = fd;
+    s->req = NULL;
+    *out = s;
+    return ESP_OK;
+}
+
+static void log_stream_close(log_stream_t *s)
+{
+    log_tap_client_close(s->client);
+    if (s->req) {
+        httpd_req_async_handler_complete(s->req);
+    }
+    *s = (log_stream_t){ .fd = -1 };
+}
+
+static esp_err_t log_stream_send(log_stream_t *s, size_t len)
+{
+    if (s->req) {
+        return httpd_resp_send_chunk(s->req, s_log_chunk, len);
+    }
+    if (httpd_ws_get_fd_info(s_server, s->fd) != HTTPD_WS_CLIENT_WEBSOCKET) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    httpd_ws_frame_t frame = {
+        .type = HTTPD_WS_TYPE_TEXT,
+        .payload = (uint8_t *)s_log_chunk,
+        .len = len
+    };
+    return httpd_ws_send_frame_async(s_server, s->fd, &frame);
+}
+
+// Corre en la tarea de httpd, igual que los manejadores que abren y cierran clientes
+static void log_pump_work(void *arg)
+{
+    atomic_store(&s_log_pump_queued, false);
+    for (int i = 0; i < LOG_TAP_MAX_CLIENTS; i++) {
+        log_stream_t *s = &s_log_streams[i];
+        for (int n = 0; s->client && n < WS_LOG_CHUNKS_PER_PUMP; n++) {
+            const size_t len = log_tap_read(s->client, s_log_chunk, sizeof(s_log_chunk));
+            if (len == 0) {
+                break;
             }
+            if (log_stream_send(s, len) != ESP_OK) {
+                log_stream_close(s);    // Cliente desconectado
+            }
+        }
+    }
+}
+
+static void log_close_all_work(void *arg)
+{
+    for (int i = 0; i < LOG_TAP_MAX_CLIENTS; i++) {
+        if (s_log_streams[i].client) {
+            log_stream_close(&s_log_streams[i]);
         }
-        free(payload);
-        vTaskDelay(pdMS_TO_TICKS(1000));
     }
-    s_broadcast_task = NULL; // Señalar finalización
-    vTaskDelete(NULL);
+}
+
+static bool log_streams_active(void)
+{
+    for (int i = 0; i < LOG_TAP_MAX_CLIENTS; i++) {
+        if (s_log_streams[i].client) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void log_pump_job(void *arg)
+{
+    httpd_handle_t server = s_server;
+    if (server == NULL || atomic_exchange(&s_log_pump_queued, true)) {
+        return;
+    }
+    if (!log_streams_active() || httpd_queue_work(server, log_pump_work, NULL) != ESP_OK) {
+        atomic_store(&s_log_pump_queued, false);
+    }
+}
+
+static esp_err_t ws_reply(httpd_req_t *req, const char *text)
+{
+    httpd_ws_frame_t frame = {
+        .type = HTTPD_WS_TYPE_TEXT,
+        .payload = (uint8_t *)text,
+        .len = strlen(text)
+    };
+    return httpd_ws_send_frame(req, &frame);
+}
+
+// "log [filtro]" suscribe o cambia el filtro; "log off" cancela la suscripción
+static esp_err_t ws_log_command(httpd_req_t *req, const char *args)
+{
+    const int fd = httpd_req_to_sockfd(req);
+    log_stream_t *s = log_stream_find(fd);
+    if (strcmp(args, "off") == 0) {
+        if (s) {
+            log_stream_close(s);
+        }
+        return ws_reply(req, "log: off");
+    }
+    const char *filter = *args ? args : NULL;
+    esp_err_t ret = s ? log_tap_client_set_filter(s->client, filter) : log_stream_open(filter, fd, &s);
+    if (ret == ESP_ERR_INVALID_ARG) {
+        return ws_reply(req, "log: filtro inválido (etiqueta:nivel,...; niveles E W I D V N)");
+    }
+    if (ret != ESP_OK) {
+        return ws_reply(req, "log: sin lugar para otro cliente");
+    }
+    return ws_reply(req, "log: on");
+}
+
+// GET /logs[?filter=*:W,PID:D]: flujo chunked de líneas de log
+static esp_err_t logs_handler(httpd_req_t *req)
+{
+    char query[96];
+    char filter[80];
+    const char *spec = NULL;
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK &&
+        httpd_query_key_value(query, "filter", filter, sizeof(filter)) == ESP_OK) {
+        spec = filter;
+    }
+
+    log_stream_t *s = NULL;
+    esp_err_t ret = log_stream_open(spec, -1, &s);
+    if (ret == ESP_ERR_INVALID_ARG) {
+        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Filtro inválido");
+    }
+    if (ret != ESP_OK) {
+        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Sin lugar para otro cliente");
+    }
+    // La solicitud sigue abierta fuera del manejador; el trabajo de bombeo envía los tramos
+    if (httpd_req_async_handler_begin(req, &s->req) != ESP_OK) {
+        log_stream_close(s);
+        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Sin memoria");
+    }
+    httpd_resp_set_type(s->req, "text/plain; charset=utf-8");
+    return ESP_OK;
 }
 
 /************** WebSocket Handler **************/
@@ -75,21 +334,65 @@ static esp_err_t ws_handler(httpd_req_t *req)
         ESP_LOGE(TAG, "ws recv frame failed: %s", esp_err_to_name(ret));
         return ret;
     }
-    uint8_t *buf = calloc(1, frame.len + 1);
-    if (!buf) {
-        ESP_LOGE(TAG, "Out of memory reading WS frame");
-        return ESP_ERR_NO_MEM;
+    if (frame.len > WS_RX_MAX) {
+        ESP_LOGW(TAG, "WS message too long (%u bytes)", (unsigned)frame.len);
+        return ESP_ERR_INVALID_SIZE;
     }
-    frame.payload = buf;
+    frame.payload = s_rx_buf;
     ret = httpd_ws_recv_frame(req, &frame, frame.len);
     if (ret == ESP_OK) {
+        s_rx_buf[frame.len] = '\0';
         ESP_LOGI(TAG, "Received WS message: %s", (char *)frame.payload);
-        // TODO: parse comando y ejecutar
+        if (strcmp((char *)frame.payload, "trace") == 0) {
+            ret = ws_send_trace(req);
+        } else if (strncmp((char *)frame.payload, "log", 3) == 0 &&
+                   (frame.payload[3] == '\0' || frame.payload[3] == ' ')) {
+            ret = ws_log_command(req, (char *)frame.payload + (frame.payload[3] ? 4 : 3));
+        }
+        // Cualquier otro mensaje se ignora
+    }
+    return ret;
+}
+
+/************** Metrics Handler **************/
+// GET /metrics[?provider=<nombre>] en formato de texto de Prometheus
+static esp_err_t metrics_handler(httpd_req_t *req)
+{
+    char query[48];
+    char provider[24];
+    const char *filter = NULL;
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK &&
+        httpd_query_key_value(query, "provider", provider, sizeof(provider)) == ESP_OK) {
+        filter = provider;
     }
+
+    // Primera pasada solo para medir; los proveedores no guardan estado entre ambas
+    const size_t size = metrics_render(NULL, 0, filter) + 256;
+    char *buf = malloc(size);
+    if (!buf) {
+        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Sin memoria");
+    }
+    const size_t len = metrics_render(buf, size, filter);
+    httpd_resp_set_type(req, "text/plain; version=0.0.4");
+    esp_err_t ret = httpd_resp_send(req, buf, len < size ? len : size - 1);
     free(buf);
     return ret;
 }
 
+/************** Network Events **************/
+static void on_net_state(const evbus_event_t *ev, void *ctx)
+{
+    // Arrancar con la primera conexión; el servidor sigue vivo entre reconexiones
+    if (ev->net.state == WIFI_MANAGER_STATE_CONNECTED) {
+        ws_server_start();
+    }
+}
+
+esp_err_t ws_server_init(void)
+{
+    return evbus_subscribe("ws_net", EVBUS_MASK(EVBUS_NET_STATE), 8, on_net_state, NULL);
+}
+
 /************** Server Start/Stop **************/
 esp_err_t ws_server_start(void)
 {
@@ -97,7 +400,7 @@ esp_err_t ws_server_start(void)
 
     httpd_config_t config = HTTPD_DEFAULT_CONFIG();
     config.server_port = WS_SERVER_PORT;
-    config.ctrl_port = 0; // deshabilitar control socket para ahorrar
+    // El socket de control (puerto por defecto) lo usan httpd_queue_work() y httpd_stop()
 
     ESP_LOGI(TAG, "Iniciando servidor WS en puerto %d", config.server_port);
     esp_err_t ret = httpd_start(&s_server, &config);
@@ -116,7 +419,37 @@ esp_err_t ws_server_start(void)
     };
     httpd_register_uri_handler(s_server, &ws_uri);
 
-    xTaskCreate(broadcast_task, "ws_broadcast", 4096, NULL, 4, &s_broadcast_task);
+    httpd_uri_t metrics_uri = {
+        .uri = "/metrics",
+        .method = HTTP_GET,
+        .handler = metrics_handler,
+        .user_ctx = NULL
+    };
+    httpd_register_uri_handler(s_server, &metrics_uri);
+
+    httpd_uri_t trace_uri = {
+        .uri = "/trace",
+        .method = HTTP_GET,
+        .handler = trace_handler,
+        .user_ctx = NULL
+    };
+    httpd_register_uri_handler(s_server, &trace_uri);
+
+    httpd_uri_t logs_uri = {
+        .uri = "/logs",
+        .method = HTTP_GET,
+        .handler = logs_handler,
+        .user_ctx = NULL
+    };
+    httpd_register_uri_handler(s_server, &logs_uri);
+
+    if (s_broadcast_monitor == NULL) {
+        deadline_register("ws_broadcast", WS_BROADCAST_PERIOD_MS * 1000, WS_BROADCAST_TOLERANCE_US,
+                          WS_BROADCAST_BUDGET_US, &s_broadcast_monitor);
+    }
+    deadline_restart(s_broadcast_monitor);  // Sin periodo que comparar tras un reinicio del servidor
+    sched_add("ws_broadcast", broadcast_job, NULL, WS_BROADCAST_PERIOD_MS, WS_BROADCAST_PERIOD_MS, &s_broadcast_job);
+    sched_add("ws_logs", log_pump_job, NULL, WS_LOG_PUMP_MS, WS_LOG_PUMP_MS, &s_log_job);
     return ESP_OK;
 }
 
@@ -125,10 +458,23 @@ esp_err_t ws_server_stop(void)
     if (!s_server) return ESP_OK;
 
     httpd_handle_t hd = s_server;
-    s_server = NULL; // Señal para que broadcast_task termine por sí misma
+    s_server = NULL; // Señal para que una difusión en curso no empiece a enviar
+    if (s_broadcast_job) {
+        sched_cancel(s_broadcast_job);
+        s_broadcast_job = NULL;
+    }
+
+    if (s_log_job) {
+        sched_cancel(s_log_job);
+        s_log_job = NULL;
+    }
+    // Los clientes del log se cierran en la tarea de httpd, dueña de la tabla
+    if (log_streams_active()) {
+        httpd_queue_work(hd, log_close_all_work, NULL);
+    }
 
-    // Esperar hasta 100 ms a que la tarea se elimine sola
-    for (int i = 0; i < 100 && s_broadcast_task; ++i) {
+    // Esperar hasta 100 ms a que termine una difusión en curso y se cierren los clientes del log
+    for (int i = 0; i < 100 && (s_broadcasting || log_streams_active()); ++i) {
         vTaskDelay(pdMS_TO_TICKS(1));
     }
 
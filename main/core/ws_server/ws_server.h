@@ -1,13 +1,26 @@
 #pragma once
 
 #include "esp_err.h"
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * @brief Arranca el servidor automáticamente cuando el bus de eventos informa conexión WiFi.
+ */
+esp_err_t ws_server_init(void);
+
 /**
  * @brief Inicializa y arranca el servidor WebSocket.
+ * @details Además de `/ws` sirve:
+ *          - `GET /metrics`: todas las métricas, o un solo proveedor con `?provider=<nombre>`;
+ *          - `GET /trace`: volcado binario del trazador (tools/trace2perfetto.py);
+ *          - `GET /logs`: flujo chunked del log, con `?filter=*:W,PID:D` opcional.
+ *
+ *          Por `/ws` acepta los mensajes `trace` (volcado en un mensaje binario) y
+ *          `log [filtro]` / `log off` (líneas de log como mensajes de texto).
  */
 esp_err_t ws_server_start(void);
 
@@ -19,6 +32,12 @@ esp_err_t ws_server_start(void);
 /** Detiene el servidor WebSocket */
 esp_err_t ws_server_stop(void);
 
+/**
+ * @brief Escribe en `buf` el JSON de estado que se difunde a los clientes (sin reservar memoria)
+ * @return Largo del JSON como snprintf(); si es >= `size` quedó truncado
+ */
+int ws_server_format_status(char *buf, size_t size);
+
 #ifdef __cplusplus
 }
 #endif 
\ No newline at end of file
@@ -28,31 +28,20 @@
  */
 
 #include "DEV_Config.h"
+#include "CH422G.h"
+#include "i2c_bus.h"
 
 /**
  * @brief Inicializa el bus I2C en modo maestro.
  * 
- * Configura los pines SDA y SCL, habilita resistencias de pull-up internas
- * y establece la velocidad de reloj definida en `I2C_MASTER_FREQ_HZ`.
+ * Crea el bus con el driver `i2c_master` y la tarea del árbitro (ver i2c_bus.h), que
+ * serializa por prioridad todas las transacciones del CH422G y del táctil.
  * 
  * @return esp_err_t ESP_OK si la inicialización fue exitosa, o un código de error.
  */
 esp_err_t i2c_master_init(void)
 {
-    int i2c_master_port = I2C_MASTER_NUM;
-
-    i2c_config_t conf = {
-        .mode = I2C_MODE_MASTER,
-        .sda_io_num = I2C_MASTER_SDA_IO,
-        .scl_io_num = I2C_MASTER_SCL_IO,
-        .sda_pullup_en = GPIO_PULLUP_ENABLE,
-        .scl_pullup_en = GPIO_PULLUP_ENABLE,
-        .master.clk_speed = I2C_MASTER_FREQ_HZ,
-    };
-
-    i2c_param_config(i2c_master_port, &conf);
-
-    return i2c_driver_install(i2c_master_port, conf.mode, I2C_MASTER_RX_BUF_DISABLE, I2C_MASTER_TX_BUF_DISABLE, 0);
+    return i2c_bus_init();
 }
 
 /**
@@ -66,7 +55,7 @@ esp_err_t i2c_master_init(void)
 esp_err_t DEV_I2C_Write_Byte(uint8_t addr, uint8_t reg, uint8_t Value)
 {
     uint8_t write_buf[2] = {reg, Value};
-    return i2c_master_write_to_device(I2C_MASTER_NUM, addr, write_buf, 2, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
+    return i2c_bus_write(addr, write_buf, 2, I2C_BUS_PRIO_NORMAL);
 }
 
 /**
@@ -79,7 +68,7 @@ esp_err_t DEV_I2C_Write_Byte(uint8_t addr, uint8_t reg, uint8_t Value)
  */
 esp_err_t DEV_I2C_Write_nByte(uint8_t addr, uint8_t *pData, uint32_t Len)
 {
-    return i2c_master_write_to_device(I2C_MASTER_NUM, addr, pData, Len, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
+    return i2c_bus_write(addr, pData, Len, I2C_BUS_PRIO_NORMAL);
 }
 
 /**
@@ -92,7 +81,7 @@ esp_err_t DEV_I2C_Write_nByte(uint8_t addr, uint8_t *pData, uint32_t Len)
  */
 esp_err_t DEV_I2C_Read_Byte(uint8_t addr, uint8_t reg, uint8_t *data)
 {
-    return i2c_master_write_read_device(I2C_MASTER_NUM, addr, &reg, 1, data, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
+    return i2c_bus_write_read(addr, &reg, 1, data, 1, I2C_BUS_PRIO_NORMAL);
 }
 
 /**
@@ -106,7 +95,7 @@ esp_err_t DEV_I2C_Read_Byte(uint8_t addr, uint8_t reg, uint8_t *data)
  */
 esp_err_t DEV_I2C_Read_nByte(uint8_t addr, uint8_t reg, uint8_t *pData, uint32_t Len)
 {
-    return i2c_master_write_read_device(I2C_MASTER_NUM, addr, &reg, 1, pData, Len, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
+    return i2c_bus_write_read(addr, &reg, 1, pData, Len, I2C_BUS_PRIO_NORMAL);
 }
 
 /**
@@ -122,13 +111,14 @@ void DEV_Delay_ms(uint32_t xms)
 /**
  * @brief Inicializa el módulo de configuración de hardware (I2C).
  * 
- * Esta función encapsula la inicialización del bus I2C y puede extenderse
- * para inicializar otros periféricos en el futuro.
+ * Esta función encapsula la inicialización del bus I2C y del driver del CH422G,
+ * y puede extenderse para inicializar otros periféricos en el futuro.
  * 
  * @return uint8_t Siempre retorna 0 si no hay error. 
  */
 uint8_t DEV_Module_Init(void)
 {
     ESP_ERROR_CHECK(i2c_master_init());
+    ESP_ERROR_CHECK(CH422G_init());
     return 0;
 }
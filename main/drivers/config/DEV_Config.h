@@ -46,7 +46,7 @@
 #include "esp_rom_sys.h"
 #include "esp_log.h"
 #include "argtable3/argtable3.h"
-#include "driver/i2c.h"
+#include "i2c_bus.h"
 #include "esp_console.h"
 #include "driver/gpio.h"
 #include "freertos/task.h"
@@ -89,8 +89,6 @@
 #define I2C_MASTER_TX_BUF_DISABLE 0            /**< Deshabilitar buffer de transmisión */
 #define I2C_MASTER_RX_BUF_DISABLE 0            /**< Deshabilitar buffer de recepción */
 #define I2C_MASTER_TIMEOUT_MS 1000             /**< Tiempo de espera I2C (1000 ms) */
-#define WRITE_BIT I2C_MASTER_WRITE             /**< Bit de escritura I2C (0) */
-#define READ_BIT I2C_MASTER_READ               /**< Bit de lectura I2C (1) */
 #define ACK_CHECK_EN 0x1                       /**< Habilitar verificación ACK */
 #define ACK_CHECK_DIS 0x0                      /**< Deshabilitar verificación ACK */
 #define ACK_VAL 0x0                            /**< Valor de ACK (0) */
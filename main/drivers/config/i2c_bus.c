@@ -0,0 +1,484 @@
+/**
+ * @file i2c_bus.c
+ * @brief Implementación del árbitro del bus I2C.
+ *
+ * Cada solicitud se describe con un trabajo que vive en la pila de la tarea llamante. El
+ * trabajo se encola en la cola de su prioridad y la tarea del bus, la única que ejecuta
+ * transacciones, atiende siempre primero la cola de mayor prioridad no vacía.
+ *
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#include "i2c_bus.h"
+#include "metrics.h"
+#include "mem_budget.h"
+#include "waveshare_rgb_lcd_port.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "i2c_bus";
+
+#define I2C_BUS_TASK_PRIORITY   10      ///< Por encima de PID (5) y LVGL para no retrasar el SSR
+#define I2C_BUS_QUEUE_LEN       8       ///< Trabajos pendientes por prioridad
+#define I2C_BUS_MAX_DEVICES     8       ///< Direcciones registradas (el CH422G usa cuatro)
+
+/**
+ * @brief Tipos de trabajo
+ */
+typedef enum {
+    JOB_WRITE,
+    JOB_READ,
+    JOB_WRITE_READ,
+    JOB_CALL,
+} job_type_t;
+
+/**
+ * @brief Trabajo encolado en el árbitro
+ */
+typedef struct {
+    job_type_t type;
+    uint16_t addr;
+    i2c_master_dev_handle_t dev;
+    const uint8_t *tx;
+    size_t tx_len;
+    uint8_t *rx;
+    size_t rx_len;
+    i2c_bus_job_fn_t fn;
+    void *arg;
+    int64_t enqueue_us;             ///< Instante en que se encoló
+    esp_err_t result;               ///< Resultado de la transacción
+    SemaphoreHandle_t done;         ///< Se libera al completar el trabajo
+    StaticSemaphore_t done_buffer;
+} i2c_bus_job_t;
+
+/**
+ * @brief Dispositivo registrado en el bus
+ */
+typedef struct {
+    uint16_t addr;
+    i2c_master_dev_handle_t handle;
+} i2c_bus_device_t;
+
+static i2c_master_bus_handle_t bus_handle = NULL;
+static TaskHandle_t bus_task = NULL;
+static QueueHandle_t job_queues[I2C_BUS_PRIO_COUNT];
+static SemaphoreHandle_t jobs_pending = NULL;
+static SemaphoreHandle_t devices_mutex = NULL;
+static uint8_t job_queue_storage[I2C_BUS_PRIO_COUNT][I2C_BUS_QUEUE_LEN * sizeof(i2c_bus_job_t *)];
+static StaticQueue_t job_queue_buffers[I2C_BUS_PRIO_COUNT];
+static StaticSemaphore_t jobs_pending_buffer;
+static StaticSemaphore_t devices_mutex_buffer;
+static StackType_t bus_task_stack[MEM_STACK_I2C_BUS];
+static StaticTask_t bus_task_tcb;
+#define I2C_BUS_STATIC_BYTES \
+    (sizeof(job_queue_storage) + sizeof(job_queue_buffers) + sizeof(jobs_pending_buffer) + \
+     sizeof(devices_mutex_buffer) + sizeof(bus_task_stack) + sizeof(bus_task_tcb))
+MEM_BUDGET_STATIC_ASSERT(I2C_BUS, INTERNAL, I2C_BUS_STATIC_BYTES);
+static i2c_bus_device_t devices[I2C_BUS_MAX_DEVICES];
+static size_t device_count = 0;
+static i2c_bus_stats_t bus_stats = {0};
+static portMUX_TYPE stats_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Traza y contadores por dispositivo: solo los escribe la tarea del bus, bajo stats_lock
+static i2c_bus_trace_entry_t trace[I2C_BUS_TRACE_LEN];
+static uint32_t trace_head = 0;     ///< Total de entradas escritas (índice = head % LEN)
+static i2c_bus_device_stats_t tracked[I2C_BUS_MAX_TRACKED];
+static size_t tracked_count = 0;
+static const uint32_t hist_bounds_us[I2C_BUS_HIST_BUCKETS - 1] = I2C_BUS_HIST_BOUNDS_US;
+
+/**
+ * @brief Ejecuta un trabajo y devuelve su resultado
+ */
+static esp_err_t execute_job(i2c_bus_job_t *job)
+{
+    switch (job->type) {
+        case JOB_WRITE:
+            return i2c_master_transmit(job->dev, job->tx, job->tx_len, I2C_MASTER_TIMEOUT_MS);
+        case JOB_READ:
+            return i2c_master_receive(job->dev, job->rx, job->rx_len, I2C_MASTER_TIMEOUT_MS);
+        case JOB_WRITE_READ:
+            return i2c_master_transmit_receive(job->dev, job->tx, job->tx_len, job->rx, job->rx_len, I2C_MASTER_TIMEOUT_MS);
+        case JOB_CALL:
+            return job->fn(job->arg);
+        default:
+            return ESP_ERR_INVALID_ARG;
+    }
+}
+
+/**
+ * @brief Busca (o agrega) los contadores de un dispositivo
+ */
+static i2c_bus_device_stats_t *tracked_device(uint16_t addr)
+{
+    for (size_t i = 0; i < tracked_count; i++) {
+        if (tracked[i].addr == addr) {
+            return &tracked[i];
+        }
+    }
+    if (tracked_count < I2C_BUS_MAX_TRACKED) {
+        tracked[tracked_count].addr = addr;
+        return &tracked[tracked_count++];
+    }
+    return NULL;
+}
+
+/**
+ * @brief Registra los tiempos de un trabajo completado en las estadísticas y la traza
+ */
+static void account_job(const i2c_bus_job_t *job, i2c_bus_prio_t prio, int64_t start_us,
+                        uint32_t wait_us, uint32_t exec_us)
+{
+    const esp_err_t result = job->result;
+    const uint16_t len = (uint16_t)(job->tx_len + job->rx_len);
+
+    portENTER_CRITICAL(&stats_lock);
+    {
+        i2c_bus_trace_entry_t *e = &trace[trace_head % I2C_BUS_TRACE_LEN];
+        e->start_us = (uint32_t)start_us;
+        e->wait_us = wait_us;
+        e->dur_us = exec_us;
+        e->addr = job->addr;
+        e->len = len;
+        e->err = (int16_t)result;
+        e->prio = (uint8_t)prio;
+        trace_head++;
+    }
+
+    i2c_bus_device_stats_t *dev = tracked_device(job->addr);
+    if (dev) {
+        const uint32_t latency_us = wait_us + exec_us;
+        int bucket = 0;
+        while (bucket < I2C_BUS_HIST_BUCKETS - 1 && latency_us > hist_bounds_us[bucket]) {
+            bucket++;
+        }
+        dev->hist[bucket]++;
+        dev->transactions++;
+        dev->bytes += len;
+        if (result != ESP_OK) {
+            dev->errors++;
+        }
+    }
+    bus_stats.busy_us += exec_us;
+
+    i2c_bus_prio_stats_t *st = &bus_stats.prio[prio];
+    st->jobs++;
+    if (result != ESP_OK) {
+        st->errors++;
+    }
+    st->wait_last_us = wait_us;
+    st->exec_last_us = exec_us;
+    if (wait_us > st->wait_max_us) {
+        st->wait_max_us = wait_us;
+    }
+    if (exec_us > st->exec_max_us) {
+        st->exec_max_us = exec_us;
+    }
+    if (wait_us + exec_us > st->total_max_us) {
+        st->total_max_us = wait_us + exec_us;
+    }
+    portEXIT_CRITICAL(&stats_lock);
+}
+
+/**
+ * @brief Tarea propietaria del bus: atiende las colas en orden de prioridad
+ */
+static void i2c_bus_task(void *arg)
+{
+    (void)arg;
+    while (1) {
+        xSemaphoreTake(jobs_pending, portMAX_DELAY);
+
+        for (int prio = 0; prio < I2C_BUS_PRIO_COUNT; prio++) {
+            i2c_bus_job_t *job = NULL;
+            if (xQueueReceive(job_queues[prio], &job, 0) != pdTRUE) {
+                continue;
+            }
+
+            const int64_t start_us = esp_timer_get_time();
+            job->result = execute_job(job);
+            const int64_t end_us = esp_timer_get_time();
+
+            account_job(job, (i2c_bus_prio_t)prio, start_us, (uint32_t)(start_us - job->enqueue_us),
+                        (uint32_t)(end_us - start_us));
+            xSemaphoreGive(job->done);
+            break; // Volver a revisar desde la prioridad más alta
+        }
+    }
+}
+
+/**
+ * @brief Encola un trabajo y espera a que la tarea del bus lo complete
+ */
+static esp_err_t submit_job(i2c_bus_job_t *job, i2c_bus_prio_t prio)
+{
+    if (bus_handle == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (prio >= I2C_BUS_PRIO_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Un trabajo que hace más transacciones ya se ejecuta en la tarea del bus
+    if (xTaskGetCurrentTaskHandle() == bus_task) {
+        return execute_job(job);
+    }
+
+    job->done = xSemaphoreCreateBinaryStatic(&job->done_buffer);
+    job->enqueue_us = esp_timer_get_time();
+    if (xQueueSend(job_queues[prio], &job, pdMS_TO_TICKS(I2C_MASTER_TIMEOUT_MS)) != pdTRUE) {
+        vSemaphoreDelete(job->done);
+        return ESP_ERR_TIMEOUT;
+    }
+    xSemaphoreGive(jobs_pending);
+
+    xSemaphoreTake(job->done, portMAX_DELAY);
+    vSemaphoreDelete(job->done);
+    return job->result;
+}
+
+/**
+ * @brief Proveedor de métricas del bus: utilización, histograma por dispositivo y errores
+ */
+static void i2c_bus_metrics(metrics_writer_t *w, void *ctx)
+{
+    (void)ctx;
+    static const char *prio_names[I2C_BUS_PRIO_COUNT] = { "high", "normal", "low" };
+    i2c_bus_stats_t st;
+    i2c_bus_device_stats_t devs[I2C_BUS_MAX_TRACKED];
+    i2c_bus_get_stats(&st);
+    const size_t dev_count = i2c_bus_get_device_stats(devs, I2C_BUS_MAX_TRACKED);
+
+    const int64_t elapsed_us = esp_timer_get_time() - st.since_us;
+    metrics_write_uint(w, "i2c_busy_us_total", NULL, st.busy_us);
+    metrics_write_float(w, "i2c_utilization_pct", NULL, elapsed_us > 0 ? 100.0 * st.busy_us / elapsed_us : 0.0);
+
+    char labels[48];
+    for (int p = 0; p < I2C_BUS_PRIO_COUNT; p++) {
+        snprintf(labels, sizeof(labels), "prio=\"%s\"", prio_names[p]);
+        metrics_write_uint(w, "i2c_jobs_total", labels, st.prio[p].jobs);
+        metrics_write_uint(w, "i2c_wait_max_us", labels, st.prio[p].wait_max_us);
+        metrics_write_uint(w, "i2c_latency_max_us", labels, st.prio[p].total_max_us);
+    }
+
+    for (size_t i = 0; i < dev_count; i++) {
+        const i2c_bus_device_stats_t *d = &devs[i];
+        snprintf(labels, sizeof(labels), "addr=\"0x%02X\"", d->addr);
+        metrics_write_uint(w, "i2c_transactions_total", labels, d->transactions);
+        metrics_write_uint(w, "i2c_errors_total", labels, d->errors);
+        metrics_write_uint(w, "i2c_bytes_total", labels, d->bytes);
+        metrics_write_float(w, "i2c_error_rate", labels, d->transactions ? (double)d->errors / d->transactions : 0.0);
+
+        // Histograma acumulado, como lo espera Prometheus
+        uint32_t cumulative = 0;
+        for (int b = 0; b < I2C_BUS_HIST_BUCKETS; b++) {
+            cumulative += d->hist[b];
+            if (b < I2C_BUS_HIST_BUCKETS - 1) {
+                metrics_printf(w, "i2c_latency_us_bucket{addr=\"0x%02X\",le=\"%lu\"} %lu\n",
+                               d->addr, (unsigned long)hist_bounds_us[b], (unsigned long)cumulative);
+            } else {
+                metrics_printf(w, "i2c_latency_us_bucket{addr=\"0x%02X\",le=\"+Inf\"} %lu\n",
+                               d->addr, (unsigned long)cumulative);
+            }
+        }
+    }
+}
+
+esp_err_t i2c_bus_init(void)
+{
+    if (bus_handle != NULL) {
+        return ESP_OK;
+    }
+
+    const i2c_master_bus_config_t bus_config = {
+        .i2c_port = I2C_MASTER_NUM,
+        .sda_io_num = I2C_MASTER_SDA_IO,
+        .scl_io_num = I2C_MASTER_SCL_IO,
+        .clk_source = I2C_CLK_SRC_DEFAULT,
+        .glitch_ignore_cnt = 7,
+        .flags.enable_internal_pullup = true,
+    };
+    esp_err_t ret = i2c_new_master_bus(&bus_config, &bus_handle);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Error al crear el bus I2C: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    devices_mutex = xSemaphoreCreateMutexStatic(&devices_mutex_buffer);
+    jobs_pending = xSemaphoreCreateCountingStatic(I2C_BUS_PRIO_COUNT * I2C_BUS_QUEUE_LEN, 0, &jobs_pending_buffer);
+    for (int prio = 0; prio < I2C_BUS_PRIO_COUNT; prio++) {
+        job_queues[prio] = xQueueCreateStatic(I2C_BUS_QUEUE_LEN, sizeof(i2c_bus_job_t *),
+                                              job_queue_storage[prio], &job_queue_buffers[prio]);
+    }
+    bus_task = xTaskCreateStatic(i2c_bus_task, "I2C_Bus", MEM_STACK_I2C_BUS, NULL, I2C_BUS_TASK_PRIORITY,
+                                 bus_task_stack, &bus_task_tcb);
+    mem_budget_claim(MEM_MOD_I2C_BUS, MEM_REGION_INTERNAL, I2C_BUS_STATIC_BYTES);
+
+    bus_stats.since_us = esp_timer_get_time();
+    metrics_register("i2c", i2c_bus_metrics, NULL);
+
+    ESP_LOGI(TAG, "Bus I2C inicializado (SDA=%d, SCL=%d, %d Hz)", I2C_MASTER_SDA_IO, I2C_MASTER_SCL_IO, I2C_MASTER_FREQ_HZ);
+    return ESP_OK;
+}
+
+i2c_master_bus_handle_t i2c_bus_get_handle(void)
+{
+    return bus_handle;
+}
+
+i2c_master_dev_handle_t i2c_bus_get_device(uint16_t addr)
+{
+    if (bus_handle == NULL) {
+        return NULL;
+    }
+
+    i2c_master_dev_handle_t handle = NULL;
+    xSemaphoreTake(devices_mutex, portMAX_DELAY);
+    for (size_t i = 0; i < device_count; i++) {
+        if (devices[i].addr == addr) {
+            handle = devices[i].handle;
+            break;
+        }
+    }
+
+    if (handle == NULL && device_count < I2C_BUS_MAX_DEVICES) {
+        const i2c_device_config_t dev_config = {
+            .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+            .device_address = addr,
+            .scl_speed_hz = I2C_MASTER_FREQ_HZ,
+        };
+        if (i2c_master_bus_add_device(bus_handle, &dev_config, &handle) == ESP_OK) {
+            devices[device_count].addr = addr;
+            devices[device_count].handle = handle;
+            device_count++;
+        } else {
+            ESP_LOGE(TAG, "No se pudo registrar el dispositivo 0x%02X", addr);
+            handle = NULL;
+        }
+    }
+    xSemaphoreGive(devices_mutex);
+
+    return handle;
+}
+
+esp_err_t i2c_bus_write(uint16_t addr, const uint8_t *data, size_t len, i2c_bus_prio_t prio)
+{
+    i2c_bus_job_t job = {
+        .type = JOB_WRITE,
+        .addr = addr,
+        .dev = i2c_bus_get_device(addr),
+        .tx = data,
+        .tx_len = len,
+    };
+    if (job.dev == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return submit_job(&job, prio);
+}
+
+esp_err_t i2c_bus_read(uint16_t addr, uint8_t *data, size_t len, i2c_bus_prio_t prio)
+{
+    i2c_bus_job_t job = {
+        .type = JOB_READ,
+        .addr = addr,
+        .dev = i2c_bus_get_device(addr),
+        .rx = data,
+        .rx_len = len,
+    };
+    if (job.dev == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return submit_job(&job, prio);
+}
+
+esp_err_t i2c_bus_write_read(uint16_t addr, const uint8_t *tx, size_t tx_len,
+                             uint8_t *rx, size_t rx_len, i2c_bus_prio_t prio)
+{
+    i2c_bus_job_t job = {
+        .type = JOB_WRITE_READ,
+        .addr = addr,
+        .dev = i2c_bus_get_device(addr),
+        .tx = tx,
+        .tx_len = tx_len,
+        .rx = rx,
+        .rx_len = rx_len,
+    };
+    if (job.dev == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return submit_job(&job, prio);
+}
+
+esp_err_t i2c_bus_run(uint16_t addr, i2c_bus_job_fn_t fn, void *arg, i2c_bus_prio_t prio)
+{
+    if (fn == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    i2c_bus_job_t job = {
+        .type = JOB_CALL,
+        .addr = addr,
+        .fn = fn,
+        .arg = arg,
+    };
+    return submit_job(&job, prio);
+}
+
+void i2c_bus_get_stats(i2c_bus_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    portENTER_CRITICAL(&stats_lock);
+    *stats = bus_stats;
+    portEXIT_CRITICAL(&stats_lock);
+}
+
+size_t i2c_bus_get_trace(i2c_bus_trace_entry_t *out, size_t max)
+{
+    if (out == NULL) {
+        return 0;
+    }
+
+    portENTER_CRITICAL(&stats_lock);
+    const uint32_t available = trace_head < I2C_BUS_TRACE_LEN ? trace_head : I2C_BUS_TRACE_LEN;
+    const size_t count = max < available ? max : available;
+    for (size_t i = 0; i < count; i++) {
+        out[i] = trace[(trace_head - count + i) % I2C_BUS_TRACE_LEN];
+    }
+    portEXIT_CRITICAL(&stats_lock);
+
+    return count;
+}
+
+size_t i2c_bus_get_device_stats(i2c_bus_device_stats_t *out, size_t max)
+{
+    if (out == NULL) {
+        return 0;
+    }
+
+    portENTER_CRITICAL(&stats_lock);
+    const size_t count = max < tracked_count ? max : tracked_count;
+    memcpy(out, tracked, count * sizeof(*out));
+    portEXIT_CRITICAL(&stats_lock);
+
+    return count;
+}
+
+void i2c_bus_log_stats(void)
+{
+    static const char *names[I2C_BUS_PRIO_COUNT] = { "ALTA", "NORMAL", "BAJA" };
+    i2c_bus_stats_t st;
+    i2c_bus_get_stats(&st);
+
+    for (int prio = 0; prio < I2C_BUS_PRIO_COUNT; prio++) {
+        const i2c_bus_prio_stats_t *p = &st.prio[prio];
+        ESP_LOGI(TAG, "%-6s: %lu trans, %lu errores | cola máx %lu us | ejecución máx %lu us | peor total %lu us",
+                 names[prio], (unsigned long)p->jobs, (unsigned long)p->errors,
+                 (unsigned long)p->wait_max_us, (unsigned long)p->exec_max_us, (unsigned long)p->total_max_us);
+    }
+}
@@ -0,0 +1,198 @@
+/**
+ * @file i2c_bus.h
+ * @brief Árbitro del bus I2C compartido por el CH422G (SSR, retroiluminación) y el táctil GT911.
+ *
+ * Todas las transacciones del bus se ejecutan en una única tarea propietaria, que atiende
+ * tres colas por prioridad. Una escritura del SSR (prioridad alta) espera como máximo a que
+ * termine la transacción en curso y nunca queda detrás de lecturas táctiles encoladas.
+ *
+ * El bus se gestiona con el driver `i2c_master` de ESP-IDF. Las operaciones son síncronas
+ * para quien las llama: la transacción se encola y la tarea llamante se bloquea hasta que
+ * la tarea del bus la completa.
+ *
+ * Cada transacción queda registrada en una traza circular (dirección, longitud, inicio,
+ * espera, duración y error) y en un histograma de latencia por dispositivo. Las métricas
+ * se publican en el registro de métricas bajo el proveedor "i2c".
+ *
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include "esp_err.h"
+#include "driver/i2c_master.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define I2C_BUS_TRACE_LEN       128     ///< Entradas de la traza circular
+#define I2C_BUS_HIST_BUCKETS    8       ///< Intervalos del histograma de latencia
+#define I2C_BUS_MAX_TRACKED     12      ///< Dispositivos con histograma propio
+
+/**
+ * @brief Límites superiores (µs) de los intervalos del histograma; el último no tiene límite
+ */
+#define I2C_BUS_HIST_BOUNDS_US  { 100, 250, 500, 1000, 2500, 5000, 10000 }
+
+/**
+ * @brief Prioridades de las transacciones del bus
+ */
+typedef enum {
+    I2C_BUS_PRIO_HIGH = 0,  ///< Salidas de seguridad (SSR)
+    I2C_BUS_PRIO_NORMAL,    ///< Retroiluminación, reset táctil y demás salidas
+    I2C_BUS_PRIO_LOW,       ///< Lectura del panel táctil
+    I2C_BUS_PRIO_COUNT      ///< Número de prioridades
+} i2c_bus_prio_t;
+
+/**
+ * @brief Función ejecutada en la tarea del bus (p. ej. lectura del GT911 vía esp_lcd)
+ */
+typedef esp_err_t (*i2c_bus_job_fn_t)(void *arg);
+
+/**
+ * @brief Estadísticas de una prioridad
+ */
+typedef struct {
+    uint32_t jobs;          ///< Transacciones completadas
+    uint32_t errors;        ///< Transacciones fallidas
+    uint32_t wait_last_us;  ///< Tiempo en cola de la última transacción
+    uint32_t wait_max_us;   ///< Tiempo máximo en cola
+    uint32_t exec_last_us;  ///< Duración de la última transacción
+    uint32_t exec_max_us;   ///< Duración máxima de una transacción
+    uint32_t total_max_us;  ///< Peor latencia total (cola + ejecución)
+} i2c_bus_prio_stats_t;
+
+/**
+ * @brief Estadísticas del árbitro
+ */
+typedef struct {
+    i2c_bus_prio_stats_t prio[I2C_BUS_PRIO_COUNT]; ///< Estadísticas por prioridad
+    uint64_t busy_us;                               ///< Tiempo total con una transacción en curso
+    int64_t since_us;                               ///< Instante de inicialización del bus
+} i2c_bus_stats_t;
+
+/**
+ * @brief Entrada de la traza de transacciones
+ */
+typedef struct {
+    uint32_t start_us;  ///< Inicio de la transacción (32 bits bajos de esp_timer)
+    uint32_t wait_us;   ///< Tiempo en cola antes de ejecutarse
+    uint32_t dur_us;    ///< Duración de la transacción
+    uint16_t addr;      ///< Dirección de 7 bits del dispositivo
+    uint16_t len;       ///< Bytes transferidos (0 si no se conocen)
+    int16_t err;        ///< Código esp_err_t (0 si fue exitosa)
+    uint8_t prio;       ///< Prioridad (i2c_bus_prio_t)
+} i2c_bus_trace_entry_t;
+
+/**
+ * @brief Contadores e histograma de latencia (espera + duración) de un dispositivo
+ */
+typedef struct {
+    uint16_t addr;                          ///< Dirección de 7 bits
+    uint32_t transactions;                  ///< Transacciones realizadas
+    uint32_t errors;                        ///< Transacciones fallidas
+    uint64_t bytes;                         ///< Bytes transferidos
+    uint32_t hist[I2C_BUS_HIST_BUCKETS];    ///< Transacciones por intervalo de latencia
+} i2c_bus_device_stats_t;
+
+/**
+ * @brief Inicializa el bus I2C y la tarea del árbitro
+ * @details Llamadas posteriores no tienen efecto.
+ * @return ESP_OK si la inicialización fue exitosa
+ */
+esp_err_t i2c_bus_init(void);
+
+/**
+ * @brief Obtiene el handle del bus (para crear el panel IO del táctil)
+ * @return i2c_master_bus_handle_t Handle del bus, NULL si no está inicializado
+ */
+i2c_master_bus_handle_t i2c_bus_get_handle(void);
+
+/**
+ * @brief Obtiene el handle de un dispositivo, registrándolo en el bus la primera vez
+ * @param addr Dirección de 7 bits
+ * @return i2c_master_dev_handle_t Handle del dispositivo, NULL en caso de error
+ */
+i2c_master_dev_handle_t i2c_bus_get_device(uint16_t addr);
+
+/**
+ * @brief Escribe bytes en un dispositivo
+ * @param addr Dirección de 7 bits
+ * @param data Datos a escribir
+ * @param len Número de bytes
+ * @param prio Prioridad de la transacción
+ * @return ESP_OK si la operación fue exitosa
+ */
+esp_err_t i2c_bus_write(uint16_t addr, const uint8_t *data, size_t len, i2c_bus_prio_t prio);
+
+/**
+ * @brief Lee bytes de un dispositivo
+ * @param addr Dirección de 7 bits
+ * @param data Buffer de destino
+ * @param len Número de bytes
+ * @param prio Prioridad de la transacción
+ * @return ESP_OK si la operación fue exitosa
+ */
+esp_err_t i2c_bus_read(uint16_t addr, uint8_t *data, size_t len, i2c_bus_prio_t prio);
+
+/**
+ * @brief Escribe y luego lee de un dispositivo con una condición de repeated start
+ * @param addr Dirección de 7 bits
+ * @param tx Datos a escribir
+ * @param tx_len Bytes a escribir
+ * @param rx Buffer de destino
+ * @param rx_len Bytes a leer
+ * @param prio Prioridad de la transacción
+ * @return ESP_OK si la operación fue exitosa
+ */
+esp_err_t i2c_bus_write_read(uint16_t addr, const uint8_t *tx, size_t tx_len,
+                             uint8_t *rx, size_t rx_len, i2c_bus_prio_t prio);
+
+/**
+ * @brief Ejecuta una función en la tarea del bus con la prioridad indicada
+ * @details Permite serializar transacciones hechas por otros drivers (esp_lcd_touch).
+ * @param addr Dirección del dispositivo al que accede `fn` (para la traza)
+ * @param fn Función a ejecutar
+ * @param arg Argumento de la función
+ * @param prio Prioridad del trabajo
+ * @return Valor devuelto por `fn`, o error si no se pudo encolar
+ */
+esp_err_t i2c_bus_run(uint16_t addr, i2c_bus_job_fn_t fn, void *arg, i2c_bus_prio_t prio);
+
+/**
+ * @brief Obtiene las estadísticas del árbitro
+ * @param stats Estructura donde se copiarán las estadísticas
+ */
+void i2c_bus_get_stats(i2c_bus_stats_t *stats);
+
+/**
+ * @brief Copia las últimas transacciones de la traza
+ * @param out Destino (de la más antigua a la más reciente)
+ * @param max Número máximo de entradas a copiar
+ * @return Número de entradas copiadas
+ */
+size_t i2c_bus_get_trace(i2c_bus_trace_entry_t *out, size_t max);
+
+/**
+ * @brief Copia los contadores por dispositivo
+ * @param out Destino
+ * @param max Número máximo de dispositivos a copiar
+ * @return Número de dispositivos copiados
+ */
+size_t i2c_bus_get_device_stats(i2c_bus_device_stats_t *out, size_t max);
+
+/**
+ * @brief Imprime en el log la latencia de cada prioridad
+ */
+void i2c_bus_log_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // I2C_BUS_H
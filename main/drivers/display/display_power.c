@@ -0,0 +1,303 @@
+/**
+ * @file display_power.c
+ * @brief Implementación de la política de ahorro de energía de la pantalla.
+ *
+ * La política se evalúa dentro de la tarea LVGL (timer LVGL + hook de la tarea), por lo que
+ * todas las llamadas a LVGL se realizan con el mutex tomado. Los cambios de modo ajustan:
+ * - El periodo del timer de refresco del display y del timer de lectura táctil.
+ * - El rango de espera de la tarea LVGL entre llamadas a `lv_timer_handler()`.
+ * - La retroiluminación (IO2 del CH422G, solo admite encendido/apagado).
+ *
+ * @note El CH422G no dispone de PWM, por lo que el modo atenuado no reduce el brillo real
+ *       de la retroiluminación: se oscurece la UI con una capa semitransparente y se reduce
+ *       la frecuencia de refresco.
+ *
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#include "display_power.h"
+#include "waveshare_rgb_lcd_port.h"
+#include "lvgl_port.h"
+#include "metrics.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "lvgl.h"
+#include <stdatomic.h>
+#include <stdio.h>
+
+static const char *TAG = "display_power";
+
+#define POLICY_PERIOD_MS        500     ///< Periodo de evaluación de la inactividad
+#define DIM_OVERLAY_OPA         LV_OPA_60 ///< Opacidad de la capa oscura en modo atenuado
+#define DIM_TOUCH_PERIOD_MS     (LV_INDEV_DEF_READ_PERIOD * 2) ///< Lectura táctil en modo atenuado
+#define STATS_LOCK_TIMEOUT_MS   100     ///< Espera máxima del mutex de LVGL al leer los indicadores
+
+static const char *MODE_NAMES[DISPLAY_POWER_MODE_COUNT] = { "ACTIVO", "ATENUADO", "APAGADO" };
+static const char *MODE_LABELS[DISPLAY_POWER_MODE_COUNT] = { "active", "dim", "off" };
+
+static display_power_config_t g_config;
+static display_power_mode_t g_mode = DISPLAY_POWER_ACTIVE;
+static display_power_stats_t g_stats[DISPLAY_POWER_MODE_COUNT];
+static lvgl_port_stats_t g_mode_start_port_stats;   ///< Contadores de LVGL al entrar al modo actual
+static int64_t g_mode_start_us = 0;                 ///< Instante de entrada al modo actual
+static lv_obj_t *g_overlay = NULL;
+static lv_timer_t *g_policy_timer = NULL;
+static bool g_swallow_touch = false;                ///< Oculta a LVGL el toque que despertó la pantalla
+static atomic_bool g_wake_pending = false;
+static bool g_initialized = false;
+
+/**
+ * @brief Acumula en el modo actual el tiempo y la actividad de LVGL desde que se entró a él
+ */
+static void account_current_mode(void)
+{
+    lvgl_port_stats_t now_stats;
+    lvgl_port_get_stats(&now_stats);
+    const int64_t now_us = esp_timer_get_time();
+
+    display_power_stats_t *st = &g_stats[g_mode];
+    st->time_us += now_us - g_mode_start_us;
+    st->lvgl_busy_us += now_stats.busy_us - g_mode_start_port_stats.busy_us;
+    st->rendered_bytes += (now_stats.rendered_px - g_mode_start_port_stats.rendered_px) * sizeof(lv_color_t);
+    st->frames += now_stats.frames - g_mode_start_port_stats.frames;
+
+    g_mode_start_port_stats = now_stats;
+    g_mode_start_us = now_us;
+}
+
+/**
+ * @brief Aplica los periodos de refresco y lectura táctil de LVGL
+ */
+static void set_lvgl_periods(uint32_t refresh_ms, uint32_t touch_ms)
+{
+    lv_disp_t *disp = lv_disp_get_default();
+    if (disp && disp->refr_timer) {
+        lv_timer_set_period(disp->refr_timer, refresh_ms);
+    }
+
+    for (lv_indev_t *indev = lv_indev_get_next(NULL); indev; indev = lv_indev_get_next(indev)) {
+        if (indev->driver && indev->driver->read_timer) {
+            lv_timer_set_period(indev->driver->read_timer, touch_ms);
+        }
+    }
+
+    // La tarea LVGL no necesita despertar antes de la siguiente lectura táctil
+    lvgl_port_set_task_delay_range(touch_ms < LVGL_PORT_TASK_MIN_DELAY_MS ? LVGL_PORT_TASK_MIN_DELAY_MS : touch_ms,
+                                   LVGL_PORT_TASK_MAX_DELAY_MS);
+}
+
+/**
+ * @brief Cambia al modo indicado
+ */
+static void apply_mode(display_power_mode_t mode)
+{
+    if (mode == g_mode) {
+        return;
+    }
+
+    account_current_mode();
+    const display_power_mode_t previous = g_mode;
+    g_mode = mode;
+    g_stats[mode].entries++;
+
+    switch (mode) {
+        case DISPLAY_POWER_ACTIVE:
+            // Primero la lectura táctil y el refresco para responder en el siguiente frame
+            set_lvgl_periods(LV_DISP_DEF_REFR_PERIOD, LV_INDEV_DEF_READ_PERIOD);
+            lv_obj_add_flag(g_overlay, LV_OBJ_FLAG_HIDDEN);
+            if (previous == DISPLAY_POWER_OFF) {
+                waveshare_rgb_lcd_bl_on();
+            }
+            break;
+        case DISPLAY_POWER_DIM:
+            lv_obj_clear_flag(g_overlay, LV_OBJ_FLAG_HIDDEN);
+            set_lvgl_periods(g_config.dim_refresh_period_ms, DIM_TOUCH_PERIOD_MS);
+            break;
+        case DISPLAY_POWER_OFF:
+            wavesahre_rgb_lcd_bl_off();
+            set_lvgl_periods(g_config.off_refresh_period_ms, g_config.off_touch_period_ms);
+            break;
+        default:
+            break;
+    }
+
+    ESP_LOGI(TAG, "Modo de pantalla: %s -> %s", MODE_NAMES[previous], MODE_NAMES[mode]);
+}
+
+/**
+ * @brief Timer LVGL que evalúa el tiempo de inactividad
+ */
+static void policy_timer_cb(lv_timer_t *timer)
+{
+    (void)timer;
+    const uint32_t inactive_ms = lv_disp_get_inactive_time(NULL);
+
+    display_power_mode_t target = DISPLAY_POWER_ACTIVE;
+    if (g_config.off_timeout_ms && inactive_ms >= g_config.off_timeout_ms) {
+        target = DISPLAY_POWER_OFF;
+    } else if (g_config.dim_timeout_ms && inactive_ms >= g_config.dim_timeout_ms) {
+        target = DISPLAY_POWER_DIM;
+    }
+
+    apply_mode(target);
+}
+
+/**
+ * @brief Hook de la tarea LVGL: atiende las solicitudes de `display_power_wake()`
+ */
+static void wake_hook(void)
+{
+    if (atomic_exchange(&g_wake_pending, false)) {
+        lv_disp_trig_activity(NULL);
+        apply_mode(DISPLAY_POWER_ACTIVE);
+    }
+}
+
+/**
+ * @brief Callback de lectura táctil: un toque con la pantalla inactiva solo la despierta
+ */
+static bool touch_cb(bool pressed)
+{
+    if (g_swallow_touch) {
+        // Ocultar el toque de activación hasta que se levante el dedo
+        if (!pressed) {
+            g_swallow_touch = false;
+        }
+        return true;
+    }
+
+    if (pressed && g_mode != DISPLAY_POWER_ACTIVE) {
+        lv_disp_trig_activity(NULL);
+        apply_mode(DISPLAY_POWER_ACTIVE);
+        g_swallow_touch = true;
+        return true;
+    }
+
+    return false;
+}
+
+display_power_config_t display_power_get_default_config(void)
+{
+    display_power_config_t config = {
+        .dim_timeout_ms = CONFIG_DISPLAY_IDLE_DIM_TIMEOUT_MIN * 60 * 1000,
+        .off_timeout_ms = CONFIG_DISPLAY_IDLE_OFF_TIMEOUT_MIN * 60 * 1000,
+        .dim_refresh_period_ms = 100,
+        .off_refresh_period_ms = 1000,
+        .off_touch_period_ms = 100
+    };
+    return config;
+}
+
+/**
+ * @brief Proveedor de métricas: permanencia, CPU de LVGL y tráfico de PSRAM por modo
+ */
+static void display_power_metrics(metrics_writer_t *w, void *ctx)
+{
+    (void)ctx;
+    metrics_write_uint(w, "display_mode", NULL, g_mode);
+
+    char labels[24];
+    for (int i = 0; i < DISPLAY_POWER_MODE_COUNT; i++) {
+        display_power_stats_t st;
+        if (display_power_get_stats((display_power_mode_t)i, &st) != ESP_OK) {
+            return;
+        }
+        snprintf(labels, sizeof(labels), "mode=\"%s\"", MODE_LABELS[i]);
+        metrics_write_uint(w, "display_time_us_total", labels, st.time_us);
+        metrics_write_uint(w, "display_lvgl_busy_us_total", labels, st.lvgl_busy_us);
+        metrics_write_uint(w, "display_rendered_bytes_total", labels, st.rendered_bytes);
+        metrics_write_uint(w, "display_frames_total", labels, st.frames);
+        metrics_write_uint(w, "display_entries_total", labels, st.entries);
+    }
+}
+
+esp_err_t display_power_init(const display_power_config_t *config)
+{
+    if (g_initialized) {
+        return ESP_OK;
+    }
+
+    g_config = config ? *config : display_power_get_default_config();
+
+    // Capa oscura para el modo atenuado: no captura toques y arranca oculta
+    g_overlay = lv_obj_create(lv_layer_top());
+    lv_obj_remove_style_all(g_overlay);
+    lv_obj_set_size(g_overlay, LV_PCT(100), LV_PCT(100));
+    lv_obj_set_style_bg_color(g_overlay, lv_color_black(), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(g_overlay, DIM_OVERLAY_OPA, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_clear_flag(g_overlay, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_flag(g_overlay, LV_OBJ_FLAG_HIDDEN);
+
+    lvgl_port_get_stats(&g_mode_start_port_stats);
+    g_mode_start_us = esp_timer_get_time();
+    g_stats[DISPLAY_POWER_ACTIVE].entries = 1;
+
+    esp_err_t ret = lvgl_port_add_task_hook(wake_hook);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "No se pudo registrar el hook de la tarea LVGL: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    lvgl_port_set_touch_cb(touch_cb);
+
+    g_policy_timer = lv_timer_create(policy_timer_cb, POLICY_PERIOD_MS, NULL);
+    if (!g_policy_timer) {
+        ESP_LOGE(TAG, "No se pudo crear el timer de inactividad");
+        return ESP_ERR_NO_MEM;
+    }
+
+    g_initialized = true;
+    metrics_register("display", display_power_metrics, NULL);
+    ESP_LOGI(TAG, "Política de inactividad: atenuar a los %lu s, apagar a los %lu s",
+             (unsigned long)(g_config.dim_timeout_ms / 1000), (unsigned long)(g_config.off_timeout_ms / 1000));
+    return ESP_OK;
+}
+
+void display_power_wake(void)
+{
+    if (!g_initialized) {
+        return;
+    }
+    atomic_store(&g_wake_pending, true);
+    lvgl_port_wake();
+}
+
+display_power_mode_t display_power_get_mode(void)
+{
+    return g_mode;
+}
+
+esp_err_t display_power_get_stats(display_power_mode_t mode, display_power_stats_t *stats)
+{
+    if (!g_initialized || mode >= DISPLAY_POWER_MODE_COUNT || !stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Acotado: las métricas y el informe se leen desde httpd y el planificador
+    if (!lvgl_port_lock(STATS_LOCK_TIMEOUT_MS)) {
+        return ESP_ERR_TIMEOUT;
+    }
+    account_current_mode();
+    *stats = g_stats[mode];
+    lvgl_port_unlock();
+
+    return ESP_OK;
+}
+
+void display_power_log_report(void)
+{
+    for (int i = 0; i < DISPLAY_POWER_MODE_COUNT; i++) {
+        display_power_stats_t st;
+        if (display_power_get_stats((display_power_mode_t)i, &st) != ESP_OK || st.time_us == 0) {
+            continue;
+        }
+
+        const double seconds = st.time_us / 1e6;
+        ESP_LOGI(TAG, "%-8s: %7.0f s | CPU LVGL %5.2f%% | %5.1f fps | PSRAM %7.1f KB/s | entradas %lu",
+                 MODE_NAMES[i], seconds,
+                 100.0 * st.lvgl_busy_us / st.time_us,
+                 st.frames / seconds,
+                 st.rendered_bytes / 1024.0 / seconds,
+                 (unsigned long)st.entries);
+    }
+}
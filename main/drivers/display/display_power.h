@@ -0,0 +1,105 @@
+/**
+ * @file display_power.h
+ * @brief Política de ahorro de energía de la pantalla según inactividad táctil.
+ *
+ * Tras un tiempo sin toques la pantalla pasa a modo atenuado (refresco de LVGL más lento
+ * y capa oscura) y después a modo apagado (retroiluminación apagada vía CH422G y
+ * `lv_timer_handler` espaciado al máximo). Cualquier toque o una alarma
+ * (`display_power_wake()`) restauran el modo activo en el siguiente ciclo de LVGL.
+ *
+ * Para cada modo se acumulan el tiempo de permanencia, el tiempo de CPU de la tarea LVGL
+ * y los bytes renderizados en los frame buffers de PSRAM, como indicadores de consumo. Se
+ * exportan como métricas `display_*` (metrics.h) y se imprimen con el informe periódico.
+ *
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#ifndef DISPLAY_POWER_H
+#define DISPLAY_POWER_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Modos de energía de la pantalla
+ */
+typedef enum {
+    DISPLAY_POWER_ACTIVE = 0,   ///< Refresco completo, retroiluminación encendida
+    DISPLAY_POWER_DIM,          ///< Refresco reducido y capa oscura sobre la UI
+    DISPLAY_POWER_OFF,          ///< Retroiluminación apagada, refresco mínimo
+    DISPLAY_POWER_MODE_COUNT    ///< Número de modos
+} display_power_mode_t;
+
+/**
+ * @brief Configuración de la política de inactividad
+ */
+typedef struct {
+    uint32_t dim_timeout_ms;        ///< Inactividad antes de atenuar (0 = nunca)
+    uint32_t off_timeout_ms;        ///< Inactividad antes de apagar (0 = nunca)
+    uint32_t dim_refresh_period_ms; ///< Periodo de refresco de LVGL en modo atenuado
+    uint32_t off_refresh_period_ms; ///< Periodo de refresco de LVGL en modo apagado
+    uint32_t off_touch_period_ms;   ///< Periodo de lectura táctil en modo apagado
+} display_power_config_t;
+
+/**
+ * @brief Indicadores de consumo acumulados en un modo
+ */
+typedef struct {
+    uint64_t time_us;           ///< Tiempo total en el modo
+    uint64_t lvgl_busy_us;      ///< Tiempo de CPU dentro de lv_timer_handler()
+    uint64_t rendered_bytes;    ///< Bytes renderizados en los frame buffers (tráfico PSRAM)
+    uint32_t frames;            ///< Refrescos completados
+    uint32_t entries;           ///< Veces que se entró al modo
+} display_power_stats_t;
+
+/**
+ * @brief Obtiene la configuración por defecto (valores de menuconfig)
+ * @return display_power_config_t Configuración por defecto
+ */
+display_power_config_t display_power_get_default_config(void);
+
+/**
+ * @brief Inicializa la política de inactividad
+ * @details Debe llamarse con el mutex de LVGL tomado, después de `lvgl_port_init()`.
+ * @param config Configuración (NULL para usar la configuración por defecto)
+ * @return ESP_OK si la inicialización fue exitosa
+ */
+esp_err_t display_power_init(const display_power_config_t *config);
+
+/**
+ * @brief Restaura el modo activo (p. ej. ante una alarma)
+ * @details Se puede llamar desde cualquier tarea; el cambio se aplica en el siguiente
+ *          ciclo de la tarea LVGL, que se despierta de inmediato.
+ */
+void display_power_wake(void);
+
+/**
+ * @brief Obtiene el modo de energía actual
+ * @return display_power_mode_t Modo actual
+ */
+display_power_mode_t display_power_get_mode(void);
+
+/**
+ * @brief Obtiene los indicadores de consumo acumulados en un modo
+ * @param mode Modo a consultar
+ * @param stats Estructura donde se copiarán los indicadores
+ * @return ESP_OK si la operación fue exitosa, ESP_ERR_TIMEOUT si la tarea LVGL retuvo su mutex
+ */
+esp_err_t display_power_get_stats(display_power_mode_t mode, display_power_stats_t *stats);
+
+/**
+ * @brief Imprime en el log el promedio de CPU y tráfico de PSRAM de cada modo
+ */
+void display_power_log_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DISPLAY_POWER_H
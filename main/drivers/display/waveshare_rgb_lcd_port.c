@@ -11,6 +11,9 @@
  */
 
 #include "waveshare_rgb_lcd_port.h"
+#include "CH422G.h"
+#include "DEV_Config.h"
+#include "tracer.h"
 
 static const char *TAG = "rgb_lcd";
 
@@ -27,36 +30,14 @@ static const char *TAG = "rgb_lcd";
  */
 IRAM_ATTR static bool rgb_lcd_on_vsync_event(esp_lcd_panel_handle_t panel, const esp_lcd_rgb_panel_event_data_t *edata, void *user_ctx)
 {
-    return lvgl_port_notify_rgb_vsync();
+    tracer_isr_enter(TRACER_ISR_VSYNC);
+    const bool need_yield = lvgl_port_notify_rgb_vsync();
+    tracer_isr_exit(TRACER_ISR_VSYNC);
+    return need_yield;
 }
 
 #if CONFIG_EXAMPLE_LCD_TOUCH_CONTROLLER_GT911
 
-/**
- * @brief Initializes the I2C master for communication with the touch controller.
- * 
- * Configures the I2C master parameters, installs the I2C driver, and sets up the GPIO pins
- * for SDA and SCL.
- * 
- * @return esp_err_t Returns ESP_OK on success, or an error code otherwise.
- */
-static esp_err_t i2c_master_init(void)
-{
-    int i2c_master_port = I2C_MASTER_NUM;
-    i2c_config_t i2c_conf = {
-        .mode = I2C_MODE_MASTER,
-        .sda_io_num = I2C_MASTER_SDA_IO,
-        .scl_io_num = I2C_MASTER_SCL_IO,
-        .sda_pullup_en = GPIO_PULLUP_ENABLE,
-        .scl_pullup_en = GPIO_PULLUP_ENABLE,
-        .master.clk_speed = I2C_MASTER_FREQ_HZ,
-    };
-    // Configure I2C parameters
-    i2c_param_config(i2c_master_port, &i2c_conf);
-    // Install I2C driver
-    return i2c_driver_install(i2c_master_port, i2c_conf.mode, 0, 0, 0);
-}
-
 /**
  * @brief Initializes the GPIO pins used in the application.
  * 
@@ -79,15 +60,12 @@ void gpio_init(void)
  */
 void waveshare_esp32_s3_touch_reset()
 {
-    uint8_t write_buf = 0x01;
-    i2c_master_write_to_device(I2C_MASTER_NUM, 0x24, &write_buf, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
-    write_buf = 0x2C;
-    i2c_master_write_to_device(I2C_MASTER_NUM, 0x38, &write_buf, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
+    // Hold the touch reset (IO1) low with the backlight and LCD reset lines high
+    CH422G_io_output(CH422G_IO_2 | CH422G_IO_3 | CH422G_IO_5);
     esp_rom_delay_us(100 * 1000);
     gpio_set_level(GPIO_INPUT_IO_4, 0);
     esp_rom_delay_us(100 * 1000);
-    write_buf = 0x2E;
-    i2c_master_write_to_device(I2C_MASTER_NUM, 0x38, &write_buf, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
+    CH422G_io_set_bits(CH422G_IO_1);
     esp_rom_delay_us(200 * 1000);
 }
 
@@ -170,15 +148,16 @@ esp_err_t waveshare_esp32_s3_rgb_lcd_init()
     esp_lcd_touch_handle_t tp_handle = NULL;
 #if CONFIG_EXAMPLE_LCD_TOUCH_CONTROLLER_GT911
     ESP_LOGI(TAG, "Initialize I2C bus");
-    i2c_master_init();
+    ESP_ERROR_CHECK(i2c_bus_init()); // Shared with the CH422G, already created by DEV_Module_Init()
     ESP_LOGI(TAG, "Initialize GPIO");
     gpio_init();
     ESP_LOGI(TAG, "Initialize Touch LCD");
     waveshare_esp32_s3_touch_reset();
     esp_lcd_panel_io_handle_t tp_io_handle = NULL;
-    const esp_lcd_panel_io_i2c_config_t tp_io_config = ESP_LCD_TOUCH_IO_I2C_GT911_CONFIG();
+    esp_lcd_panel_io_i2c_config_t tp_io_config = ESP_LCD_TOUCH_IO_I2C_GT911_CONFIG();
+    tp_io_config.scl_speed_hz = I2C_MASTER_FREQ_HZ;
     ESP_LOGI(TAG, "Initialize I2C panel IO");
-    ESP_ERROR_CHECK(esp_lcd_new_panel_io_i2c((esp_lcd_i2c_bus_handle_t)I2C_MASTER_NUM, &tp_io_config, &tp_io_handle));
+    ESP_ERROR_CHECK(esp_lcd_new_panel_io_i2c(i2c_bus_get_handle(), &tp_io_config, &tp_io_handle));
     ESP_LOGI(TAG, "Initialize touch controller GT911");
     const esp_lcd_touch_config_t tp_cfg = {
         .x_max = EXAMPLE_LCD_H_RES,
@@ -194,6 +173,9 @@ esp_err_t waveshare_esp32_s3_rgb_lcd_init()
             .mirror_x = 0,
             .mirror_y = 0,
         },
+#if CONFIG_EXAMPLE_LVGL_PORT_TOUCH_IRQ
+        .interrupt_callback = lvgl_port_touch_isr, // Read on INT edges instead of polling
+#endif
     };
     ESP_ERROR_CHECK(esp_lcd_touch_new_i2c_gt911(tp_io_handle, &tp_cfg, &tp_handle));
 #endif
@@ -212,33 +194,29 @@ esp_err_t waveshare_esp32_s3_rgb_lcd_init()
 /**
  * @brief Turns on the backlight of the RGB LCD.
  * 
- * Configures the CH422G chip to enable the backlight by setting the appropriate I2C commands.
+ * Sets the backlight line (IO2) of the CH422G. As the original 0x1E write did, it also
+ * drives IO4 (SD_CS) high and IO5 (USB_SEL) low; the other IO lines are left untouched.
+ * No I2C transaction is issued if the lines are already at these levels.
  * 
  * @return esp_err_t Returns ESP_OK on success, or an error code otherwise.
  */
 esp_err_t waveshare_rgb_lcd_bl_on()
 {
-    uint8_t write_buf = 0x01;
-    i2c_master_write_to_device(I2C_MASTER_NUM, 0x24, &write_buf, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
-    write_buf = 0x1E;
-    i2c_master_write_to_device(I2C_MASTER_NUM, 0x38, &write_buf, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
-    return ESP_OK;
+    return CH422G_io_update_bits(CH422G_IO_2 | CH422G_IO_4, CH422G_IO_5);
 }
 
 /**
  * @brief Turns off the backlight of the RGB LCD.
  * 
- * Configures the CH422G chip to disable the backlight by setting the appropriate I2C commands.
+ * Clears the backlight line (IO2) of the CH422G. As the original 0x1A write did, it also
+ * drives IO4 (SD_CS) high and IO5 (USB_SEL) low; the other IO lines are left untouched.
+ * No I2C transaction is issued if the lines are already at these levels.
  * 
  * @return esp_err_t Returns ESP_OK on success, or an error code otherwise.
  */
 esp_err_t wavesahre_rgb_lcd_bl_off()
 {
-    uint8_t write_buf = 0x01;
-    i2c_master_write_to_device(I2C_MASTER_NUM, 0x24, &write_buf, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
-    write_buf = 0x1A;
-    i2c_master_write_to_device(I2C_MASTER_NUM, 0x38, &write_buf, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
-    return ESP_OK;
+    return CH422G_io_update_bits(CH422G_IO_4, CH422G_IO_2 | CH422G_IO_5);
 }
 
 /**
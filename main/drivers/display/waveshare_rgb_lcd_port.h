@@ -24,7 +24,7 @@
 #include "esp_log.h"
 #include "esp_heap_caps.h"
 #include "driver/gpio.h"
-#include "driver/i2c.h"
+#include "i2c_bus.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_lcd_panel_ops.h"
@@ -221,8 +221,13 @@
 
 /**
  * @brief GPIO pin number for touch interrupt signal (-1 if not used).
+ * @note GPIO4 selects the GT911 I2C address during reset and is then used as INT input.
  */
+#if CONFIG_EXAMPLE_LVGL_PORT_TOUCH_IRQ
+#define EXAMPLE_PIN_NUM_TOUCH_INT       (GPIO_INPUT_IO_4)
+#else
 #define EXAMPLE_PIN_NUM_TOUCH_INT       (-1)
+#endif
 
 
 
@@ -28,8 +28,35 @@
  */
 
 #include "CH422G.h"
+#include "i2c_bus.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "timebase.h"
+#include "esp_log.h"
+#include <string.h>
 
-static bool ch422g_mode_initialized = false;
+static const char *TAG = "CH422G";
+
+/**
+ * @brief Copia en RAM de los registros de escritura del CH422G.
+ *
+ * Los registros del CH422G son de solo escritura, por lo que el driver mantiene el último
+ * valor escrito en cada uno. Un registro con `*_valid = false` (arranque o error de I2C)
+ * se escribe siempre en la siguiente operación.
+ */
+typedef struct {
+    uint8_t mode;       ///< Último valor escrito en el registro de modo
+    uint8_t io_out;     ///< Último valor escrito en las salidas IO0~IO7
+    uint8_t od_out;     ///< Último valor escrito en las salidas OC0~OC3
+    bool mode_valid;    ///< El registro de modo coincide con el chip
+    bool io_valid;      ///< El registro IO coincide con el chip
+    bool od_valid;      ///< El registro OC coincide con el chip
+} ch422g_shadow_t;
+
+static ch422g_shadow_t shadow = {0};
+static ch422g_stats_t stats = {0};
+static SemaphoreHandle_t ch422g_mutex = NULL;
+static StaticSemaphore_t ch422g_mutex_buffer;
 
 /**
  * @brief Lee un registro de entrada del CH422G.
@@ -40,7 +67,7 @@ static bool ch422g_mode_initialized = false;
  */
 esp_err_t read_input_reg(uint8_t addr, uint8_t *data)
 {
-    return i2c_master_read_from_device(I2C_MASTER_NUM, addr, data, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
+    return i2c_bus_read(addr, data, 1, I2C_BUS_PRIO_NORMAL);
 }
 
 /**
@@ -52,7 +79,128 @@ esp_err_t read_input_reg(uint8_t addr, uint8_t *data)
  */
 esp_err_t write_output_reg(uint8_t addr, uint8_t data)
 {
-    return i2c_master_write_to_device(I2C_MASTER_NUM, addr, &data, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
+    return i2c_bus_write(addr, &data, 1, I2C_BUS_PRIO_NORMAL);
+}
+
+/**
+ * @brief Toma el mutex del driver, creándolo si aún no existe.
+ */
+static void ch422g_lock(void)
+{
+    if (ch422g_mutex == NULL) {
+        CH422G_init();
+    }
+    xSemaphoreTake(ch422g_mutex, portMAX_DELAY);
+}
+
+/**
+ * @brief Libera el mutex del driver.
+ */
+static void ch422g_unlock(void)
+{
+    xSemaphoreGive(ch422g_mutex);
+}
+
+/**
+ * @brief Escribe un registro solo si su copia en RAM difiere del valor pedido.
+ *
+ * @param addr Dirección de función del registro.
+ * @param cached Copia en RAM del registro.
+ * @param valid Indicador de validez de la copia.
+ * @param value Valor deseado.
+ * @param prio Prioridad de la transacción en el bus.
+ * @return esp_err_t ESP_OK si el registro quedó con el valor pedido.
+ */
+static esp_err_t shadow_write(uint8_t addr, uint8_t *cached, bool *valid, uint8_t value, i2c_bus_prio_t prio)
+{
+    if (*valid && *cached == value) {
+        stats.writes_skipped++;
+        return ESP_OK;
+    }
+
+    esp_err_t ret = i2c_bus_write(addr, &value, 1, prio);
+    stats.writes++;
+    if (ret != ESP_OK) {
+        // Estado del chip desconocido: forzar la escritura en el próximo intento
+        stats.errors++;
+        *valid = false;
+        ESP_LOGW(TAG, "Error escribiendo 0x%02X en 0x%02X: %s", value, addr, esp_err_to_name(ret));
+        return ret;
+    }
+
+    *cached = value;
+    *valid = true;
+    return ESP_OK;
+}
+
+/**
+ * @brief Aplica el modo pedido conservando los bits que no se modifican.
+ *
+ * @param set Bits de modo a activar.
+ * @param clear Bits de modo a desactivar.
+ * @param prio Prioridad de la transacción en el bus.
+ * @return esp_err_t Resultado de la operación I2C.
+ */
+static esp_err_t shadow_update_mode(uint8_t set, uint8_t clear, i2c_bus_prio_t prio)
+{
+    const uint8_t base = shadow.mode_valid ? shadow.mode : 0x00;
+    return shadow_write(CH422G_Mode, &shadow.mode, &shadow.mode_valid, (uint8_t)((base & ~clear) | set), prio);
+}
+
+/**
+ * @brief Escribe el puerto IO en modo push-pull con los bits indicados.
+ */
+static esp_err_t io_update(uint8_t set, uint8_t clear)
+{
+    esp_err_t ret = shadow_update_mode(CH422G_Mode_IO_OE, 0, I2C_BUS_PRIO_NORMAL);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    const uint8_t base = shadow.io_valid ? shadow.io_out : 0x00;
+    return shadow_write(CH422G_IO_OUT, &shadow.io_out, &shadow.io_valid, (uint8_t)((base & ~clear) | set), I2C_BUS_PRIO_NORMAL);
+}
+
+/**
+ * @brief Escribe las salidas OC (push-pull, OD_EN = 0) con los bits indicados.
+ *
+ * Las salidas OC manejan el SSR, por lo que se encolan con prioridad alta en el bus.
+ */
+static esp_err_t od_update(uint8_t set, uint8_t clear)
+{
+    const int64_t start_us = timebase_mono_us();
+
+    // OD_EN = 0 deja OC0~OC3 en push-pull; IO_OE se conserva para no soltar la retroiluminación
+    esp_err_t ret = shadow_update_mode(0, CH422G_Mode_OD_EN, I2C_BUS_PRIO_HIGH);
+    if (ret == ESP_OK) {
+        const uint8_t base = shadow.od_valid ? shadow.od_out : 0x00;
+        ret = shadow_write(CH422G_OD_OUT, &shadow.od_out, &shadow.od_valid, (uint8_t)((base & ~clear) | set), I2C_BUS_PRIO_HIGH);
+    }
+
+    const uint32_t latency_us = (uint32_t)(timebase_mono_us() - start_us);
+    stats.od_switch_last_us = latency_us;
+    if (latency_us > stats.od_switch_max_us) {
+        stats.od_switch_max_us = latency_us;
+    }
+    return ret;
+}
+
+/**
+ * @brief Inicializa el driver del CH422G.
+ *
+ * Crea el mutex que serializa el acceso de las distintas tareas e invalida la copia de los
+ * registros, de modo que la primera operación sobre cada uno se escriba en el chip.
+ *
+ * @return esp_err_t ESP_OK si la inicialización fue exitosa.
+ */
+esp_err_t CH422G_init(void)
+{
+    if (ch422g_mutex == NULL) {
+        ch422g_mutex = xSemaphoreCreateMutexStatic(&ch422g_mutex_buffer);
+        memset(&shadow, 0, sizeof(shadow));
+        memset(&stats, 0, sizeof(stats));
+        stats.since_us = timebase_mono_us();
+    }
+    return ESP_OK;
 }
 
 /**
@@ -63,8 +211,53 @@ esp_err_t write_output_reg(uint8_t addr, uint8_t data)
  */
 esp_err_t CH422G_io_output(uint8_t pin)
 {
-    write_output_reg(CH422G_Mode, CH422G_Mode_IO_OE); // Configura IO como salida push-pull
-    return write_output_reg(CH422G_IO_OUT, pin);
+    ch422g_lock();
+    esp_err_t ret = io_update(pin, 0xFF);
+    ch422g_unlock();
+    return ret;
+}
+
+/**
+ * @brief Pone a nivel alto los pines IO indicados sin modificar el resto.
+ *
+ * @param mask Máscara de los pines a activar.
+ * @return esp_err_t ESP_OK si la operación fue exitosa, o un código de error.
+ */
+esp_err_t CH422G_io_set_bits(uint8_t mask)
+{
+    ch422g_lock();
+    esp_err_t ret = io_update(mask, 0);
+    ch422g_unlock();
+    return ret;
+}
+
+/**
+ * @brief Pone a nivel bajo los pines IO indicados sin modificar el resto.
+ *
+ * @param mask Máscara de los pines a desactivar.
+ * @return esp_err_t ESP_OK si la operación fue exitosa, o un código de error.
+ */
+esp_err_t CH422G_io_clear_bits(uint8_t mask)
+{
+    ch422g_lock();
+    esp_err_t ret = io_update(0, mask);
+    ch422g_unlock();
+    return ret;
+}
+
+/**
+ * @brief Pone a nivel alto `set` y a nivel bajo `clear` en una sola escritura.
+ *
+ * @param set Máscara de pines a activar.
+ * @param clear Máscara de pines a desactivar.
+ * @return esp_err_t ESP_OK si la operación fue exitosa, o un código de error.
+ */
+esp_err_t CH422G_io_update_bits(uint8_t set, uint8_t clear)
+{
+    ch422g_lock();
+    esp_err_t ret = io_update(set, clear);
+    ch422g_unlock();
+    return ret;
 }
 
 /**
@@ -75,8 +268,38 @@ esp_err_t CH422G_io_output(uint8_t pin)
  */
 esp_err_t CH422G_od_output(uint8_t pin)
 {
-    write_output_reg(CH422G_Mode, CH422G_Mode_OD_EN & 0x00); // Configura IO como salida OD
-    return write_output_reg(CH422G_OD_OUT, pin);
+    ch422g_lock();
+    esp_err_t ret = od_update(pin, 0xFF);
+    ch422g_unlock();
+    return ret;
+}
+
+/**
+ * @brief Pone a nivel alto las salidas OC indicadas sin modificar el resto.
+ *
+ * @param mask Máscara de las salidas a activar.
+ * @return esp_err_t ESP_OK si la operación fue exitosa, o un código de error.
+ */
+esp_err_t CH422G_od_set_bits(uint8_t mask)
+{
+    ch422g_lock();
+    esp_err_t ret = od_update(mask, 0);
+    ch422g_unlock();
+    return ret;
+}
+
+/**
+ * @brief Pone a nivel bajo las salidas OC indicadas sin modificar el resto.
+ *
+ * @param mask Máscara de las salidas a desactivar.
+ * @return esp_err_t ESP_OK si la operación fue exitosa, o un código de error.
+ */
+esp_err_t CH422G_od_clear_bits(uint8_t mask)
+{
+    ch422g_lock();
+    esp_err_t ret = od_update(0, mask);
+    ch422g_unlock();
+    return ret;
 }
 
 /**
@@ -88,23 +311,65 @@ esp_err_t CH422G_od_output(uint8_t pin)
 uint8_t CH422G_io_input(uint8_t pin)
 {
     uint8_t value = 0;
-    write_output_reg(CH422G_Mode, 0); // Configura IO como entrada
-    read_input_reg(CH422G_IO_IN, &value);
+
+    ch422g_lock();
+    // Configura IO como entrada; con el modo ya aplicado no se repite la escritura
+    if (shadow_update_mode(0, CH422G_Mode_IO_OE, I2C_BUS_PRIO_NORMAL) == ESP_OK) {
+        if (read_input_reg(CH422G_IO_IN, &value) != ESP_OK) {
+            stats.errors++;
+        }
+        stats.reads++;
+    }
+    ch422g_unlock();
+
     return (value & pin);
 }
 
 /**
- * @brief Asegura que el CH422G esté configurado en modo push-pull solo una vez.
+ * @brief Asegura que el registro de modo del CH422G haya sido escrito al menos una vez.
  * 
- * Esta función es útil al inicializar el sistema para evitar reconfiguraciones
- * innecesarias del chip.
+ * Deja las salidas OC en push-pull (OD_EN = 0) conservando el resto del modo. Tras la
+ * primera escritura la llamada no genera tráfico I2C.
  */
 void CH422G_EnsurePushPullMode(void)
 {
-    if (!ch422g_mode_initialized) {
-        write_output_reg(0x48, 0x00);  // Configura OCx como push-pull
-        DEV_Delay_ms(1);
-        ch422g_mode_initialized = true;
-        printf("CH422G configurado en modo push-pull\n");
+    ch422g_lock();
+    const bool configured = shadow.mode_valid;
+    if (shadow_update_mode(0, CH422G_Mode_OD_EN, I2C_BUS_PRIO_NORMAL) == ESP_OK && !configured) {
+        ESP_LOGI(TAG, "CH422G configurado en modo push-pull");
+    }
+    ch422g_unlock();
+}
+
+/**
+ * @brief Obtiene los contadores de transacciones I2C del driver.
+ *
+ * @param out Estructura donde se copiarán los contadores.
+ */
+void CH422G_get_stats(ch422g_stats_t *out)
+{
+    if (out == NULL) {
+        return;
+    }
+    ch422g_lock();
+    *out = stats;
+    ch422g_unlock();
+}
+
+/**
+ * @brief Imprime en el log las transacciones ahorradas por hora y la latencia de conmutación OC.
+ */
+void CH422G_log_stats(void)
+{
+    ch422g_stats_t st;
+    CH422G_get_stats(&st);
+
+    const double hours = (timebase_mono_us() - st.since_us) / 3600e6;
+    if (hours <= 0.0) {
+        return;
     }
+    ESP_LOGI(TAG, "I2C: %lu escrituras, %lu lecturas, %lu errores | ahorradas %lu (%.0f/h) | OC: última %lu us, máx %lu us",
+             (unsigned long)st.writes, (unsigned long)st.reads, (unsigned long)st.errors,
+             (unsigned long)st.writes_skipped, st.writes_skipped / hours,
+             (unsigned long)st.od_switch_last_us, (unsigned long)st.od_switch_max_us);
 }
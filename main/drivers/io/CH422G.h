@@ -31,7 +31,9 @@
 #ifndef _CH422G_H_
 #define _CH422G_H_
 
-#include "DEV_Config.h"
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
 
 /**
  * @note El chip CH422G no tiene una dirección I2C fija.
@@ -91,6 +93,26 @@
 extern "C" {
 #endif
 
+/**
+ * @brief Contadores de transacciones I2C del driver del CH422G.
+ */
+typedef struct {
+    uint32_t writes;            ///< Escrituras I2C realizadas
+    uint32_t writes_skipped;    ///< Escrituras evitadas porque el registro ya tenía el valor
+    uint32_t reads;             ///< Lecturas I2C realizadas
+    uint32_t errors;            ///< Transacciones fallidas
+    uint32_t od_switch_last_us; ///< Latencia de la última escritura de salidas OC (SSR)
+    uint32_t od_switch_max_us;  ///< Latencia máxima de escritura de salidas OC
+    int64_t since_us;           ///< Instante de inicio del conteo
+} ch422g_stats_t;
+
+/**
+ * @brief Inicializa el driver (mutex y copia en RAM de los registros).
+ * 
+ * @return esp_err_t ESP_OK si fue exitoso.
+ */
+esp_err_t CH422G_init(void);
+
 /**
  * @brief Escribe un valor en un registro de salida del CH422G.
  * 
@@ -103,11 +125,38 @@ esp_err_t write_output_reg(uint8_t addr, uint8_t data);
 /**
  * @brief Configura el CH422G en modo push-pull y establece el estado de los pines IO.
  * 
+ * Solo genera tráfico I2C para los registros cuyo valor cambia.
+ * 
  * @param pin Máscara de bits para los pines a controlar.
  * @return esp_err_t Resultado de la operación I2C.
  */
 esp_err_t CH422G_io_output(uint8_t pin);
 
+/**
+ * @brief Pone a nivel alto los pines IO indicados sin modificar el resto.
+ * 
+ * @param mask Máscara de pines.
+ * @return esp_err_t Resultado de la operación I2C (ESP_OK sin tráfico si no hay cambio).
+ */
+esp_err_t CH422G_io_set_bits(uint8_t mask);
+
+/**
+ * @brief Pone a nivel bajo los pines IO indicados sin modificar el resto.
+ * 
+ * @param mask Máscara de pines.
+ * @return esp_err_t Resultado de la operación I2C (ESP_OK sin tráfico si no hay cambio).
+ */
+esp_err_t CH422G_io_clear_bits(uint8_t mask);
+
+/**
+ * @brief Pone a nivel alto unos pines IO y a nivel bajo otros en una sola escritura.
+ * 
+ * @param set Máscara de pines a activar.
+ * @param clear Máscara de pines a desactivar.
+ * @return esp_err_t Resultado de la operación I2C (ESP_OK sin tráfico si no hay cambio).
+ */
+esp_err_t CH422G_io_update_bits(uint8_t set, uint8_t clear);
+
 /**
  * @brief Lee el estado de uno o más pines IO configurados como entrada.
  * 
@@ -124,6 +173,22 @@ uint8_t CH422G_io_input(uint8_t pin);
  */
 esp_err_t CH422G_od_output(uint8_t pin);
 
+/**
+ * @brief Pone a nivel alto las salidas OC indicadas sin modificar el resto.
+ * 
+ * @param mask Máscara de salidas OC.
+ * @return esp_err_t Resultado de la operación I2C (ESP_OK sin tráfico si no hay cambio).
+ */
+esp_err_t CH422G_od_set_bits(uint8_t mask);
+
+/**
+ * @brief Pone a nivel bajo las salidas OC indicadas sin modificar el resto.
+ * 
+ * @param mask Máscara de salidas OC.
+ * @return esp_err_t Resultado de la operación I2C (ESP_OK sin tráfico si no hay cambio).
+ */
+esp_err_t CH422G_od_clear_bits(uint8_t mask);
+
 /**
  * @brief Inicializa el CH422G en modo push-pull si aún no ha sido configurado.
  * 
@@ -131,6 +196,18 @@ esp_err_t CH422G_od_output(uint8_t pin);
  */
 void CH422G_EnsurePushPullMode(void);
 
+/**
+ * @brief Obtiene los contadores de transacciones I2C.
+ * 
+ * @param out Estructura donde se copiarán los contadores.
+ */
+void CH422G_get_stats(ch422g_stats_t *out);
+
+/**
+ * @brief Imprime en el log las transacciones ahorradas por hora y la latencia del SSR.
+ */
+void CH422G_log_stats(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -3,65 +3,75 @@
  * @brief Lectura de temperatura vía Modbus RTU usando UART y visualización en LVGL.
  *
  * Este módulo configura el puerto UART en modo RS485 half-duplex, realiza la comunicación
- * Modbus con un esclavo, obtiene la temperatura, aplica un filtro EMA y actualiza una
- * gráfica en la interfaz táctil mediante LVGL.
+ * Modbus con un esclavo, obtiene la temperatura, aplica un filtro EMA y publica cada
+ * muestra en el bus de eventos (la interfaz la grafica desde su propio suscriptor).
  *
  * @version 1.0
  * @date 2024-01-27
  */
 
-#include "mb.h"
+#include "sensor.h"
+#include "hal_uart.h"
 #include "esp_log.h"
-#include "driver/uart.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "lvgl.h"
-#include "ui_events.h"
-#include "ui.h"
-#include "ui_chart_data.h"
+#include "scheduler.h"
+#include "event_bus.h"
+#include "deadline.h"
+#include "tracer.h"
+#include "metrics.h"
+#include "timebase.h"
 
 // ───────────────────────────────────────────────────────
-// Objetos y constantes externas
+// Constantes
 
-extern lv_obj_t *ui_Chart;
-extern lv_chart_series_t *ui_Chart_series_1;
-extern lv_coord_t ui_Chart_series_1_array[240];
-
-#define UART_PORT       UART_NUM_1      ///< Puerto UART utilizado
+#define UART_PORT       1               ///< Puerto UART utilizado
 #define UART_TXD        44              ///< Pin TXD (también DE/RE en RS485)
 #define UART_RXD        43              ///< Pin RXD
 #define TAG             "MODBUS"        ///< Etiqueta para logs
 #define MODBUS_SLAVE_ID 1               ///< ID del esclavo Modbus
 #define TEMPERATURE_REGISTER 0x0000     ///< Registro que contiene la temperatura
+#define TEMPERATURE_PERIOD_MS 5000      ///< Periodo de lectura por defecto
+#define TEMPERATURE_TOLERANCE_US 250000 ///< Atraso admitido de una lectura
+#define TEMPERATURE_BUDGET_US 1500000   ///< Trama, espera de respuesta (1 s) y filtro
+#define MODBUS_REPLY_LEN 7              ///< Esclavo, función, largo, registro (2) y CRC (2)
+#define MODBUS_REPLY_TIMEOUT_MS 1000    ///< Plazo del esclavo para responder
+#define MODBUS_REPLY_CHECK_MS 20        ///< Consulta y respuesta a 9600 baud tardan ~16 ms en la línea
 
 // ───────────────────────────────────────────────────────
 // Variables de estado
 
 static float ema_temperature = 0.0f;
 static const float alpha = 0.15f;    ///< Factor de suavizado para filtro EMA
-
-#define TEMP_BUFFER_SIZE 240
-static float temp_buffer[TEMP_BUFFER_SIZE] = {0};  ///< Buffer circular para gráfica
-static int temp_index = 0;                          ///< Índice del buffer
-
-// ───────────────────────────────────────────────────────
-// Funciones internas
+static bool sensor_fault = false;    ///< Última lectura sin respuesta válida
+static deadline_handle_t poll_monitor = NULL;
+static sched_job_handle_t poll_job = NULL;
+static sched_job_handle_t reply_job = NULL;
+static uint32_t poll_period_ms = TEMPERATURE_PERIOD_MS;
 
 /**
- * @brief Actualiza la gráfica de temperatura en la interfaz.
- *
- * Copia los datos del buffer circular `temp_buffer` al arreglo usado por `LVGL`.
+ * @brief Respuesta en curso del trabajo periódico (la recoge temperature_reply_job)
  */
-void actualizar_grafica_temp() {
-    int i, idx;
+static struct {
+    bool pending;               ///< Consulta enviada, respuesta sin procesar
+    int64_t start_us;           ///< Envío de la consulta
+    uint8_t rx[MODBUS_REPLY_LEN];
+    int len;                    ///< Bytes recibidos
+} reply;
 
-    for (i = 0; i < TEMP_BUFFER_SIZE; i++) {
-        idx = (temp_index + i) % TEMP_BUFFER_SIZE;
-        ui_Chart_series_1_array[i] = (lv_coord_t) temp_buffer[idx];
-    }
+/**
+ * @brief Contadores de las transacciones Modbus (proveedor de métricas "sensor")
+ */
+static struct {
+    uint32_t requests;          ///< Tramas enviadas
+    uint32_t timeouts;          ///< Sin respuesta dentro del tiempo de espera
+    uint32_t invalid;           ///< Respuesta con esclavo, función, largo o CRC inválidos
+    uint32_t last_us;           ///< Duración de la última transacción
+    uint32_t max_us;            ///< Transacción más larga
+} modbus_stats;
 
-    lv_chart_refresh(ui_Chart);
-}
+// ───────────────────────────────────────────────────────
+// Funciones internas
 
 /**
  * @brief Calcula el CRC16 para tramas Modbus RTU.
@@ -70,7 +80,7 @@ void actualizar_grafica_temp() {
  * @param len Longitud del mensaje.
  * @return uint16_t CRC calculado.
  */
-uint16_t modbus_crc(uint8_t *data, uint16_t len) {
+uint16_t modbus_crc(const uint8_t *data, uint16_t len) {
     uint16_t crc = 0xFFFF;
     for (uint16_t i = 0; i < len; i++) {
         crc ^= data[i];
@@ -98,15 +108,34 @@ static void print_hex(const char *tag, const uint8_t *data, int len) {
 }
 
 /**
- * @brief Envía una trama Modbus RTU y decodifica la respuesta como temperatura.
+ * @brief Convierte el registro de una respuesta válida (décimas de °C con signo) a °C.
+ */
+static float decode_temperature(const uint8_t *rx) {
+    int temperature_raw = (rx[3] << 8) | rx[4];
+    float temperature = temperature_raw / 10.0f;
+    if (rx[3] & 0x80) {
+        temperature = (temperature_raw - 65536) / 10.0f;
+    }
+    return temperature;
+}
+
+/**
+ * @brief Un paso del filtro EMA; la primera muestra (EMA en 0) lo inicializa.
+ */
+static float ema_update(float ema, float raw) {
+    if (ema == 0.0f) {
+        return raw;
+    }
+    return alpha * raw + (1 - alpha) * ema;
+}
+
+/**
+ * @brief Envía la consulta del registro de temperatura y cuenta la transacción.
  *
- * @return float Temperatura en °C o -1 si hubo error.
+ * @return int64_t Instante del envío.
  */
-float read_temperature_raw() {
+static int64_t modbus_send_request(void) {
     uint8_t tx_buffer[8];
-    uint8_t rx_buffer[16];
-    int temperature_raw;
-    float temperature;
 
     tx_buffer[0] = MODBUS_SLAVE_ID;
     tx_buffer[1] = 0x03;
@@ -118,35 +147,75 @@ float read_temperature_raw() {
     tx_buffer[6] = crc & 0xFF;
     tx_buffer[7] = (crc >> 8) & 0xFF;
 
-    uart_flush(UART_PORT);
+    const int64_t start_us = timebase_mono_us();
+    modbus_stats.requests++;
+    hal_uart_flush_input(UART_PORT);
     ESP_LOGI(TAG, "Trama enviada:");
     print_hex(TAG, tx_buffer, sizeof(tx_buffer));
-    uart_write_bytes(UART_PORT, (const char *)tx_buffer, sizeof(tx_buffer));
-    uart_wait_tx_done(UART_PORT, pdMS_TO_TICKS(100));
+    hal_uart_write(UART_PORT, tx_buffer, sizeof(tx_buffer));
+    return start_us;
+}
 
-    int len = uart_read_bytes(UART_PORT, rx_buffer, sizeof(rx_buffer), pdMS_TO_TICKS(1000));
+/**
+ * @brief Comprueba esclavo, función, largo y CRC de la respuesta a la consulta de temperatura.
+ */
+static bool modbus_reply_valid(const uint8_t *rx, int len) {
+    if (len < MODBUS_REPLY_LEN || rx[0] != MODBUS_SLAVE_ID || rx[1] != 0x03 || rx[2] != 2) {
+        return false;
+    }
+    // Una trama alterada en la línea conserva el encabezado: solo el CRC la delata
+    return modbus_crc(rx, 5) == (uint16_t)(rx[5] | rx[6] << 8);
+}
+
+/**
+ * @brief Cierra la transacción: duración, validación y decodificación de la respuesta.
+ *
+ * @return float Temperatura en °C o -1 si hubo error.
+ */
+static float modbus_finish(int64_t start_us, const uint8_t *rx, int len) {
+    modbus_stats.last_us = (uint32_t)(timebase_mono_us() - start_us);
+    if (modbus_stats.last_us > modbus_stats.max_us) {
+        modbus_stats.max_us = modbus_stats.last_us;
+    }
     ESP_LOGI(TAG, "Bytes leídos: %d", len);
 
     if (len > 0) {
         ESP_LOGI(TAG, "Respuesta recibida:");
-        print_hex(TAG, rx_buffer, len);
+        print_hex(TAG, rx, len);
     } else {
         ESP_LOGE(TAG, "No se recibieron bytes");
+        modbus_stats.timeouts++;
         return -1;
     }
 
-    if (len < 7 || rx_buffer[0] != MODBUS_SLAVE_ID || rx_buffer[1] != 0x03 || rx_buffer[2] != 2) {
+    if (!modbus_reply_valid(rx, len)) {
         ESP_LOGE(TAG, "Respuesta inválida");
+        modbus_stats.invalid++;
         return -1;
     }
 
-    temperature_raw = (rx_buffer[3] << 8) | rx_buffer[4];
-    temperature = temperature_raw / 10.0f;
-    if (rx_buffer[3] & 0x80) {
-        temperature = (temperature_raw - 65536) / 10.0f;
-    }
+    return decode_temperature(rx);
+}
 
-    return temperature;
+/**
+ * @brief Envía una trama Modbus RTU y espera la respuesta (bloqueante, hasta 1 s).
+ *
+ * La lectura periódica no usa esta función: recoge la respuesta en un trabajo aparte
+ * para no retener al planificador.
+ *
+ * @return float Temperatura en °C o -1 si hubo error.
+ */
+float read_temperature_raw() {
+    uint8_t rx_buffer[MODBUS_REPLY_LEN];
+
+    const int64_t start_us = modbus_send_request();
+    hal_uart_wait_tx_done(UART_PORT, 100);
+
+    // Se piden exactamente los bytes esperados: la lectura vuelve apenas llega la respuesta
+    tracer_mark_begin(TRACER_MARK_MODBUS_WAIT);
+    int len = hal_uart_read(UART_PORT, rx_buffer, sizeof(rx_buffer), MODBUS_REPLY_TIMEOUT_MS);
+    tracer_mark_end(TRACER_MARK_MODBUS_WAIT);
+    return modbus_finish(start_us, rx_buffer, len);
 }
 
 /**
@@ -163,56 +232,168 @@ float read_ema_temp(void) {
  * Configura la velocidad, pines, buffer y modo para Modbus RTU.
  */
 void uart_init() {
-    uart_config_t uart_config = {
+    const hal_uart_config_t uart_config = {
         .baud_rate = 9600,
-        .data_bits = UART_DATA_8_BITS,
-        .parity    = UART_PARITY_DISABLE,
-        .stop_bits = UART_STOP_BITS_1,
-        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
-        .source_clk = UART_SCLK_DEFAULT
+        .tx_pin = UART_TXD,
+        .rx_pin = UART_RXD,
+        .rx_buffer = 256,
+        .tx_buffer = 256,
+        .rs485 = true,
     };
 
-    uart_param_config(UART_PORT, &uart_config);
-    uart_set_pin(UART_PORT, UART_TXD, UART_RXD, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
-    uart_driver_install(UART_PORT, 256, 256, 0, NULL, 0);
-    uart_set_mode(UART_PORT, UART_MODE_RS485_HALF_DUPLEX);
+    if (hal_uart_open(UART_PORT, &uart_config) != ESP_OK) {
+        ESP_LOGE(TAG, "No se pudo configurar UART%d", UART_PORT);
+    }
 }
 
 /**
- * @brief Tarea FreeRTOS que se ejecuta continuamente para leer la temperatura.
- *
- * Lee temperatura cada 5 segundos, aplica filtro EMA, actualiza gráfica y etiqueta en UI.
+ * @brief Publica la falla del sensor solo al activarse o despejarse.
  */
-void temperature_task(void *pvParameters) {
-    while (1) {
-        float raw = read_temperature_raw();
-        if (raw != -1) {
-            if (ema_temperature == 0.0f) {
-                ema_temperature = raw;
-            } else {
-                ema_temperature = alpha * raw + (1 - alpha) * ema_temperature;
-            }
+static void set_sensor_fault(bool active) {
+    if (active == sensor_fault) {
+        return;
+    }
+    sensor_fault = active;
+    evbus_event_t ev = { .type = EVBUS_FAULT, .fault = { .code = EVBUS_FAULT_SENSOR, .active = active } };
+    evbus_publish(&ev);
+}
 
-            ESP_LOGI("Main", "Raw: %.2f°C | EMA: %.2f°C", raw, ema_temperature);
+/**
+ * @brief Trabajo periódico del planificador que consulta la temperatura.
+ *
+ * Se ejecuta cada poll_period_ms (5 s por defecto): envía la consulta y deja a
+ * temperature_reply_job la respuesta, así el trabajador del planificador no espera a la UART.
+ */
+static void temperature_job(void *ctx) {
+    (void)ctx;
+    if (reply.pending) {
+        // La consulta anterior aún espera respuesta (periodo cercano al plazo del esclavo)
+        return;
+    }
+    deadline_begin(poll_monitor);
+    tracer_mark_begin(TRACER_MARK_SENSOR_POLL);
+    reply.start_us = modbus_send_request();
+    reply.len = 0;
+    reply.pending = true;
+    sched_trigger(reply_job, MODBUS_REPLY_CHECK_MS);
+    tracer_mark_end(TRACER_MARK_SENSOR_POLL);
+}
 
-            temp_buffer[temp_index] = ema_temperature;
-            temp_index = (temp_index + 1) % TEMP_BUFFER_SIZE;
+/**
+ * @brief Recoge sin bloquear la respuesta de temperature_job; al completarla (o vencer el
+ *        plazo del esclavo) aplica el filtro EMA y publica la muestra en el bus.
+ */
+static void temperature_reply_job(void *ctx) {
+    (void)ctx;
+    if (!reply.pending) {
+        return;
+    }
+    tracer_mark_begin(TRACER_MARK_SENSOR_POLL);
+    const int n = hal_uart_read(UART_PORT, reply.rx + reply.len, MODBUS_REPLY_LEN - reply.len, 0);
+    if (n > 0) {
+        reply.len += n;
+    }
+    if (reply.len < MODBUS_REPLY_LEN &&
+        timebase_mono_us() - reply.start_us < MODBUS_REPLY_TIMEOUT_MS * 1000LL) {
+        sched_trigger(reply_job, MODBUS_REPLY_CHECK_MS);
+        tracer_mark_end(TRACER_MARK_SENSOR_POLL);
+        return;
+    }
+    reply.pending = false;
+
+    float raw = modbus_finish(reply.start_us, reply.rx, reply.len);
+    if (raw == -1) {
+        tracer_mark_end(TRACER_MARK_SENSOR_POLL);
+        deadline_end(poll_monitor);
+        set_sensor_fault(true);
+        return;
+    }
+    set_sensor_fault(false);
 
-            actualizar_grafica_temp();
+    ema_temperature = ema_update(ema_temperature, raw);
 
-            bool ssr_on = false;  // ← Este valor se debe obtener desde el controlador PID
+    ESP_LOGI("Main", "Raw: %.2f°C | EMA: %.2f°C", raw, ema_temperature);
 
-            ui_actualizar_estado_pid(ema_temperature, ssr_on);
-        }
+    evbus_event_t ev = { .type = EVBUS_SAMPLE, .sample = { .temp_c = ema_temperature, .raw_c = raw } };
+    evbus_publish(&ev);
+    tracer_mark_end(TRACER_MARK_SENSOR_POLL);
+    deadline_end(poll_monitor);
+}
 
-        vTaskDelay(pdMS_TO_TICKS(5000));
-    }
+/**
+ * @brief Proveedor de métricas "sensor": transacciones Modbus y periodo de lectura.
+ */
+static void sensor_metrics(metrics_writer_t *w, void *ctx) {
+    (void)ctx;
+    metrics_write_uint(w, "sensor_poll_period_ms", NULL, poll_period_ms);
+    metrics_write_uint(w, "sensor_fault", NULL, sensor_fault);
+    metrics_write_uint(w, "sensor_modbus_requests_total", NULL, modbus_stats.requests);
+    metrics_write_uint(w, "sensor_modbus_timeouts_total", NULL, modbus_stats.timeouts);
+    metrics_write_uint(w, "sensor_modbus_invalid_total", NULL, modbus_stats.invalid);
+    metrics_write_uint(w, "sensor_modbus_last_us", NULL, modbus_stats.last_us);
+    metrics_write_uint(w, "sensor_modbus_max_us", NULL, modbus_stats.max_us);
 }
 
 /**
- * @brief Inicializa UART y lanza la tarea de lectura de temperatura.
+ * @brief Inicializa UART y registra la lectura periódica de temperatura.
  */
 void start_temperature_task() {
     uart_init();
-    xTaskCreate(temperature_task, "temperature_task", 4096, NULL, 5, NULL);
+    deadline_register("sensor_poll", poll_period_ms * 1000, TEMPERATURE_TOLERANCE_US,
+                      TEMPERATURE_BUDGET_US, &poll_monitor);
+    metrics_register("sensor", sensor_metrics, NULL);
+    if (sched_add("temperature_rx", temperature_reply_job, NULL, SCHED_DISARMED, 0, &reply_job) != ESP_OK ||
+        sched_add("temperature", temperature_job, NULL, 0, poll_period_ms, &poll_job) != ESP_OK) {
+        ESP_LOGE(TAG, "No se pudo registrar la lectura de temperatura");
+    }
+}
+
+/**
+ * @brief Cambia el periodo de lectura; la próxima lectura se hace de inmediato.
+ */
+esp_err_t sensor_set_poll_period(uint32_t period_ms) {
+    if (period_ms < SENSOR_POLL_MIN_MS || period_ms > SENSOR_POLL_MAX_MS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (poll_job == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    esp_err_t err = sched_set_period(poll_job, period_ms);
+    if (err != ESP_OK) {
+        return err;
+    }
+    poll_period_ms = period_ms;
+    deadline_set_period(poll_monitor, period_ms * 1000);
+    sched_trigger(poll_job, 0);
+    ESP_LOGI(TAG, "Periodo de lectura: %lu ms", (unsigned long)period_ms);
+    return ESP_OK;
+}
+
+/**
+ * @brief Devuelve el periodo de lectura vigente.
+ */
+uint32_t sensor_get_poll_period(void) {
+    return poll_period_ms;
+}
+
+/**
+ * @brief Valida, decodifica y filtra respuestas sintéticas como lo hace temperature_job (micro-benchmark).
+ */
+float sensor_bench_filter(uint32_t iterations) {
+    // Respuesta de 7 bytes a la consulta de temperatura: esclavo, función, largo, registro, CRC
+    uint8_t frame[MODBUS_REPLY_LEN] = { MODBUS_SLAVE_ID, 0x03, 2, 0, 0, 0, 0 };
+    float ema = 0.0f;
+    for (uint32_t i = 0; i < iterations; i++) {
+        // Rampa de 25,0 a 150,0 °C en décimas, para no filtrar siempre el mismo valor
+        const uint16_t reg = 250 + (i % 1250);
+        frame[3] = reg >> 8;
+        frame[4] = reg & 0xFF;
+        const uint16_t crc = modbus_crc(frame, 5);
+        frame[5] = crc & 0xFF;
+        frame[6] = crc >> 8;
+        if (modbus_reply_valid(frame, sizeof(frame))) {
+            ema = ema_update(ema, decode_temperature(frame));
+        }
+    }
+    return ema;
 }
@@ -18,13 +18,17 @@ extern "C" {
 #endif
 
 #include "esp_err.h"
+#include <stdint.h>
+
+#define SENSOR_POLL_MIN_MS  1000    ///< Periodo mínimo de lectura (la respuesta puede tardar 1 s)
+#define SENSOR_POLL_MAX_MS  60000   ///< Periodo máximo de lectura
 
 /**
- * @brief Inicializa el UART y lanza la tarea FreeRTOS de lectura de temperatura.
+ * @brief Inicializa el UART y registra la lectura periódica de temperatura.
  *
- * Esta función configura UART1 en modo RS485 half-duplex y crea una tarea
- * que lee periódicamente la temperatura del sensor PT100 (vía Modbus RTU),
- * aplicando filtro EMA y actualizando la gráfica y el estado en la interfaz LVGL.
+ * Esta función configura UART1 en modo RS485 half-duplex y registra en el
+ * planificador (scheduler.h) un trabajo que lee periódicamente la temperatura
+ * del sensor PT100 (vía Modbus RTU), aplicando filtro EMA y publicando cada muestra como EVBUS_SAMPLE (event_bus.h).
  */
 void start_temperature_task(void);
 
@@ -32,7 +36,8 @@ void start_temperature_task(void);
  * @brief Realiza una lectura directa de la temperatura sin aplicar ningún filtro.
  *
  * Envía una consulta Modbus RTU al esclavo definido y retorna la temperatura cruda
- * en grados Celsius.
+ * en grados Celsius. Bloquea hasta recibir la respuesta o hasta 1 s sin ella: no llamarla
+ * desde un trabajo del planificador (la lectura periódica recoge la respuesta sin bloquear).
  *
  * @return float Temperatura leída del sensor, o -1 si hubo error de comunicación.
  */
@@ -45,6 +50,42 @@ float read_temperature_raw(void);
  */
 float read_ema_temp(void);
 
+/**
+ * @brief Cambia el periodo de lectura en caliente.
+ *
+ * Actualiza el trabajo del planificador y el monitor de plazos "sensor_poll", y
+ * adelanta la próxima lectura para que el nuevo periodo rija desde ahora.
+ *
+ * @param period_ms Periodo entre SENSOR_POLL_MIN_MS y SENSOR_POLL_MAX_MS.
+ * @return ESP_OK, ESP_ERR_INVALID_ARG fuera de rango o ESP_ERR_INVALID_STATE si la
+ *         lectura no está registrada.
+ */
+esp_err_t sensor_set_poll_period(uint32_t period_ms);
+
+/**
+ * @brief Retorna el periodo de lectura vigente en milisegundos.
+ */
+uint32_t sensor_get_poll_period(void);
+
+/**
+ * @brief Calcula el CRC16 de una trama Modbus RTU (polinomio 0xA001, semilla 0xFFFF).
+ *
+ * @param data Bytes de la trama sin el CRC.
+ * @param len Cantidad de bytes.
+ * @return uint16_t CRC, que se transmite con el byte bajo primero.
+ */
+uint16_t modbus_crc(const uint8_t *data, uint16_t len);
+
+/**
+ * @brief Valida (CRC incluido) y decodifica `iterations` respuestas Modbus sintéticas y les aplica el filtro EMA.
+ *
+ * Usa las mismas funciones que la lectura periódica, sin tocar la EMA publicada; la usa el
+ * banco de pruebas (bench.h).
+ *
+ * @return EMA final, para que el compilador no descarte el cálculo.
+ */
+float sensor_bench_filter(uint32_t iterations);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,29 @@
+/**
+ * @file hal_clock.c
+ * @brief Reloj del sistema sobre esp_timer y el reloj de newlib.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#include "hal_clock.h"
+#include "esp_timer.h"
+#include <sys/time.h>
+
+int64_t hal_clock_mono_us(void)
+{
+    return esp_timer_get_time();
+}
+
+int64_t hal_clock_wall_s(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec;
+}
+
+esp_err_t hal_clock_set_wall_s(int64_t utc_s)
+{
+    const struct timeval tv = { .tv_sec = (time_t)utc_s, .tv_usec = 0 };
+    return settimeofday(&tv, NULL) == 0 ? ESP_OK : ESP_FAIL;
+}
@@ -0,0 +1,43 @@
+/**
+ * @file hal_clock.h
+ * @brief Reloj monotónico y hora de pared del sistema.
+ * @details En el equipo los respaldan esp_timer y el reloj de newlib (mantenido por el RTC);
+ *          en el host, un reloj virtual que solo avanza cuando el código espera o cuando la
+ *          prueba lo adelanta (host/hal/hal_host.h). El resto del firmware lee el tiempo a
+ *          través de timebase.h, no de aquí.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#ifndef HAL_CLOCK_H
+#define HAL_CLOCK_H
+
+#include "esp_err.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Microsegundos desde el arranque
+ */
+int64_t hal_clock_mono_us(void);
+
+/**
+ * @brief Hora de pared en segundos UTC (0 o un valor anterior a 2024 si nunca se fijó)
+ */
+int64_t hal_clock_wall_s(void);
+
+/**
+ * @brief Fija la hora de pared
+ * @return ESP_OK o ESP_FAIL si el sistema la rechaza
+ */
+esp_err_t hal_clock_set_wall_s(int64_t utc_s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HAL_CLOCK_H
@@ -0,0 +1,66 @@
+/**
+ * @file hal_nvs.c
+ * @brief Almacenamiento no volátil sobre nvs_flash de ESP-IDF.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#include "hal_nvs.h"
+#include "nvs_flash.h"
+#include "nvs.h"
+
+_Static_assert(HAL_NVS_ERR_NOT_FOUND == ESP_ERR_NVS_NOT_FOUND, "HAL_NVS_ERR_NOT_FOUND desalineado");
+_Static_assert(sizeof(hal_nvs_handle_t) == sizeof(nvs_handle_t), "hal_nvs_handle_t desalineado");
+
+esp_err_t hal_nvs_init(void)
+{
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        ret = nvs_flash_erase();
+        if (ret == ESP_OK) {
+            ret = nvs_flash_init();
+        }
+    }
+    return ret;
+}
+
+esp_err_t hal_nvs_open(const char *ns, hal_nvs_mode_t mode, hal_nvs_handle_t *out)
+{
+    return nvs_open(ns, mode == HAL_NVS_READWRITE ? NVS_READWRITE : NVS_READONLY, (nvs_handle_t *)out);
+}
+
+void hal_nvs_close(hal_nvs_handle_t handle)
+{
+    nvs_close(handle);
+}
+
+esp_err_t hal_nvs_get_blob(hal_nvs_handle_t handle, const char *key, void *out, size_t *len)
+{
+    return nvs_get_blob(handle, key, out, len);
+}
+
+esp_err_t hal_nvs_set_blob(hal_nvs_handle_t handle, const char *key, const void *value, size_t len)
+{
+    return nvs_set_blob(handle, key, value, len);
+}
+
+esp_err_t hal_nvs_get_i64(hal_nvs_handle_t handle, const char *key, int64_t *out)
+{
+    return nvs_get_i64(handle, key, out);
+}
+
+esp_err_t hal_nvs_set_i64(hal_nvs_handle_t handle, const char *key, int64_t value)
+{
+    return nvs_set_i64(handle, key, value);
+}
+
+esp_err_t hal_nvs_erase_all(hal_nvs_handle_t handle)
+{
+    return nvs_erase_all(handle);
+}
+
+esp_err_t hal_nvs_commit(hal_nvs_handle_t handle)
+{
+    return nvs_commit(handle);
+}
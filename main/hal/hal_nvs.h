@@ -0,0 +1,89 @@
+/**
+ * @file hal_nvs.h
+ * @brief Almacenamiento clave-valor no volátil por espacio de nombres.
+ * @details Sigue la semántica de la NVS de ESP-IDF (los códigos de error son los mismos). En el
+ *          equipo es un envoltorio directo de nvs_flash; en el host, una tabla en RAM con
+ *          inyección de fallas (host/hal/hal_host.h).
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#ifndef HAL_NVS_H
+#define HAL_NVS_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HAL_NVS_ERR_NOT_FOUND   0x1102  ///< La clave no existe (ESP_ERR_NVS_NOT_FOUND)
+
+typedef uint32_t hal_nvs_handle_t;      ///< Espacio de nombres abierto
+
+/**
+ * @brief Modo de apertura de un espacio de nombres
+ */
+typedef enum {
+    HAL_NVS_READONLY = 0,
+    HAL_NVS_READWRITE,
+} hal_nvs_mode_t;
+
+/**
+ * @brief Inicializa la partición; si está llena o tiene un formato anterior, la borra
+ * @return ESP_OK o el error de la inicialización
+ */
+esp_err_t hal_nvs_init(void);
+
+/**
+ * @brief Abre un espacio de nombres
+ * @return ESP_OK, o HAL_NVS_ERR_NOT_FOUND si no existe y se abre en solo lectura
+ */
+esp_err_t hal_nvs_open(const char *ns, hal_nvs_mode_t mode, hal_nvs_handle_t *out);
+
+/**
+ * @brief Cierra un espacio de nombres (sin confirmar lo pendiente)
+ */
+void hal_nvs_close(hal_nvs_handle_t handle);
+
+/**
+ * @brief Lee un blob
+ * @param out Destino, o NULL para consultar solo el tamaño
+ * @param[in,out] len Capacidad de `out`; a la salida, el tamaño del blob
+ * @return ESP_OK, HAL_NVS_ERR_NOT_FOUND o ESP_ERR_NVS_INVALID_LENGTH
+ */
+esp_err_t hal_nvs_get_blob(hal_nvs_handle_t handle, const char *key, void *out, size_t *len);
+
+/**
+ * @brief Escribe un blob
+ */
+esp_err_t hal_nvs_set_blob(hal_nvs_handle_t handle, const char *key, const void *value, size_t len);
+
+/**
+ * @brief Lee un entero de 64 bits
+ */
+esp_err_t hal_nvs_get_i64(hal_nvs_handle_t handle, const char *key, int64_t *out);
+
+/**
+ * @brief Escribe un entero de 64 bits
+ */
+esp_err_t hal_nvs_set_i64(hal_nvs_handle_t handle, const char *key, int64_t value);
+
+/**
+ * @brief Borra todas las claves del espacio de nombres
+ */
+esp_err_t hal_nvs_erase_all(hal_nvs_handle_t handle);
+
+/**
+ * @brief Confirma las escrituras pendientes
+ */
+esp_err_t hal_nvs_commit(hal_nvs_handle_t handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HAL_NVS_H
@@ -0,0 +1,59 @@
+/**
+ * @file hal_uart.c
+ * @brief Puerto serie sobre driver/uart de ESP-IDF.
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#include "hal_uart.h"
+#include "driver/uart.h"
+#include "freertos/FreeRTOS.h"
+
+esp_err_t hal_uart_open(int port, const hal_uart_config_t *config)
+{
+    if (port < 0 || port >= HAL_UART_PORTS || config == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const uart_config_t uart_config = {
+        .baud_rate = (int)config->baud_rate,
+        .data_bits = UART_DATA_8_BITS,
+        .parity    = UART_PARITY_DISABLE,
+        .stop_bits = UART_STOP_BITS_1,
+        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
+        .source_clk = UART_SCLK_DEFAULT
+    };
+
+    esp_err_t ret = uart_param_config(port, &uart_config);
+    if (ret == ESP_OK) {
+        ret = uart_set_pin(port, config->tx_pin, config->rx_pin, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+    }
+    if (ret == ESP_OK) {
+        ret = uart_driver_install(port, config->rx_buffer, config->tx_buffer, 0, NULL, 0);
+    }
+    if (ret == ESP_OK && config->rs485) {
+        ret = uart_set_mode(port, UART_MODE_RS485_HALF_DUPLEX);
+    }
+    return ret;
+}
+
+int hal_uart_write(int port, const void *data, size_t len)
+{
+    return uart_write_bytes(port, data, len);
+}
+
+esp_err_t hal_uart_wait_tx_done(int port, uint32_t timeout_ms)
+{
+    return uart_wait_tx_done(port, pdMS_TO_TICKS(timeout_ms));
+}
+
+int hal_uart_read(int port, void *buf, size_t len, uint32_t timeout_ms)
+{
+    return uart_read_bytes(port, buf, len, pdMS_TO_TICKS(timeout_ms));
+}
+
+esp_err_t hal_uart_flush_input(int port)
+{
+    return uart_flush_input(port);
+}
@@ -0,0 +1,69 @@
+/**
+ * @file hal_uart.h
+ * @brief Puerto serie (RS485 half-duplex para el sensor Modbus).
+ * @details En el equipo envuelve driver/uart; en el host, el puerto es un tubo conectado a un
+ *          modelo de dispositivo que recibe lo escrito y deja la respuesta en la recepción
+ *          (host/hal/hal_host.h).
+ * @author TriptaLabs
+ * @version 1.0
+ * @date 2025-07-21
+ */
+
+#ifndef HAL_UART_H
+#define HAL_UART_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HAL_UART_PORTS  3   ///< Puertos disponibles (0 es la consola)
+
+/**
+ * @brief Configuración de un puerto (8N1, sin control de flujo)
+ */
+typedef struct {
+    uint32_t baud_rate;     ///< Velocidad en baudios
+    int tx_pin;             ///< GPIO de transmisión (también DE/RE en RS485)
+    int rx_pin;             ///< GPIO de recepción
+    size_t rx_buffer;       ///< Búfer de recepción del driver
+    size_t tx_buffer;       ///< Búfer de transmisión del driver
+    bool rs485;             ///< Modo RS485 half-duplex
+} hal_uart_config_t;
+
+/**
+ * @brief Configura e instala el driver del puerto
+ */
+esp_err_t hal_uart_open(int port, const hal_uart_config_t *config);
+
+/**
+ * @brief Escribe bytes (copia al búfer de transmisión)
+ * @return Bytes aceptados o -1
+ */
+int hal_uart_write(int port, const void *data, size_t len);
+
+/**
+ * @brief Espera a que termine de salir lo escrito
+ */
+esp_err_t hal_uart_wait_tx_done(int port, uint32_t timeout_ms);
+
+/**
+ * @brief Lee hasta `len` bytes; espera hasta completarlos o hasta `timeout_ms`
+ * @return Bytes leídos (0 si no llegó nada) o -1
+ */
+int hal_uart_read(int port, void *buf, size_t len, uint32_t timeout_ms);
+
+/**
+ * @brief Descarta lo recibido y no leído
+ */
+esp_err_t hal_uart_flush_input(int port);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HAL_UART_H
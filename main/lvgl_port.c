@@ -10,14 +10,46 @@
 #include "esp_lcd_panel_ops.h"
 #include "esp_lcd_panel_rgb.h"
 #include "esp_lcd_touch.h"
+#include "esp_lcd_touch_gt911.h"
 #include "esp_timer.h"
 #include "esp_log.h"
 #include "lvgl.h"
 #include "lvgl_port.h"
+#include "i2c_bus.h"
+#include "deadline.h"
+#include "tracer.h"
+#include "mem_budget.h"
 
 static const char *TAG = "lv_port";                      // Tag for logging
 static SemaphoreHandle_t lvgl_mux;                       // LVGL mutex for synchronization
 static TaskHandle_t lvgl_task_handle = NULL;             // Handle for the LVGL task
+static SemaphoreHandle_t lvgl_wake_sem;                  // Wakes the LVGL task before its delay expires
+static StaticSemaphore_t lvgl_mux_buffer;                // Static storage of the LVGL mutex
+static StaticSemaphore_t lvgl_wake_sem_buffer;           // Static storage of the wake-up semaphore
+static StackType_t lvgl_task_stack[LVGL_PORT_TASK_STACK_SIZE]; // Stack of the LVGL task
+static StaticTask_t lvgl_task_tcb;                       // Control block of the LVGL task
+#define LVGL_PORT_STATIC_BYTES \
+    (sizeof(lvgl_mux_buffer) + sizeof(lvgl_wake_sem_buffer) + sizeof(lvgl_task_stack) + sizeof(lvgl_task_tcb))
+MEM_BUDGET_STATIC_ASSERT(LVGL, INTERNAL, LVGL_PORT_STATIC_BYTES);
+MEM_BUDGET_STATIC_ASSERT(LVGL, PSRAM, LVGL_PORT_LCD_RGB_BUFFER_NUMS * LVGL_PORT_H_RES * LVGL_PORT_V_RES * sizeof(lv_color_t));
+
+#define LVGL_PORT_TASK_HOOKS_MAX    (4)                  // Maximum number of task hooks
+#define LVGL_PORT_FRAME_BUDGET_US   (100000)             // Longest lv_timer_handler() run before it counts as a missed frame
+
+static lvgl_port_task_hook_t lvgl_task_hooks[LVGL_PORT_TASK_HOOKS_MAX]; // Hooks run on every loop iteration
+static lvgl_port_touch_cb_t lvgl_touch_cb = NULL;        // Callback invoked on every touch read
+static lvgl_port_stats_t lvgl_stats;                     // Activity counters of the LVGL task
+static deadline_handle_t lvgl_frame_monitor = NULL;      // Deadline monitor of each lv_timer_handler() run
+static uint32_t lvgl_task_min_delay_ms = LVGL_PORT_TASK_MIN_DELAY_MS; // Current minimum task delay
+static uint32_t lvgl_task_max_delay_ms = LVGL_PORT_TASK_MAX_DELAY_MS; // Current maximum task delay
+static lv_indev_t *lvgl_touch_indev = NULL;              // Touch input device, read early on INT edges
+static lvgl_port_touch_stats_t lvgl_touch_stats;         // Touch counters and latencies
+static volatile bool touch_irq_pending = false;          // Set by the touch ISR, cleared when the panel is read
+static volatile int64_t touch_irq_us = 0;                // Timestamp of the first pending touch interrupt
+static bool touch_last_pressed = false;                  // Last state reported by the touch panel
+static int64_t touch_last_read_us = 0;                   // Timestamp of the last I2C read of the panel
+static bool touch_latency_pending = false;               // A press is waiting for its refresh to be flushed
+static int64_t touch_latency_irq_us = 0;                 // Interrupt timestamp of that press
 
 #if EXAMPLE_LVGL_PORT_ROTATION_DEGREE != 0
 // Function to get the next frame buffer for double buffering
@@ -34,55 +66,6 @@ static void *get_next_frame_buffer(esp_lcd_panel_handle_t panel_handle)
     }
     return next_fb;                                       // Return the next frame buffer
 }
-
-// Function to rotate and copy pixels from one buffer to another
-IRAM_ATTR static void rotate_copy_pixel(const uint16_t *from, uint16_t *to, uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, uint16_t w, uint16_t h, uint16_t rotation)
-{
-    int from_index = 0;                                   // Index for source buffer
-    int to_index = 0;                                     // Index for destination buffer
-    int to_index_const = 0;                               // Constant index for destination buffer
-
-    switch (rotation) {
-    case 90:
-        to_index_const = (w - x_start - 1) * h;          // Calculate constant index for 90-degree rotation
-        for (int from_y = y_start; from_y < y_end + 1; from_y++) {
-            from_index = from_y * w + x_start;           // Calculate index in the source buffer
-            to_index = to_index_const + from_y;          // Calculate index in the destination buffer
-            for (int from_x = x_start; from_x < x_end + 1; from_x++) {
-                *(to + to_index) = *(from + from_index);  // Copy pixel
-                from_index += 1;                          // Move to the next pixel in the source
-                to_index -= h;                            // Move to the next pixel in the destination
-            }
-        }
-        break;
-    case 180:
-        to_index_const = h * w - x_start - 1;            // Calculate constant index for 180-degree rotation
-        for (int from_y = y_start; from_y < y_end + 1; from_y++) {
-            from_index = from_y * w + x_start;           // Calculate index in the source buffer
-            to_index = to_index_const - from_y * w;      // Calculate index in the destination buffer
-            for (int from_x = x_start; from_x < x_end + 1; from_x++) {
-                *(to + to_index) = *(from + from_index);  // Copy pixel
-                from_index += 1;                          // Move to the next pixel in the source
-                to_index -= 1;                            // Move to the next pixel in the destination
-            }
-        }
-        break;
-    case 270:
-        to_index_const = (x_start + 1) * h - 1;          // Calculate constant index for 270-degree rotation
-        for (int from_y = y_start; from_y < y_end + 1; from_y++) {
-            from_index = from_y * w + x_start;           // Calculate index in the source buffer
-            to_index = to_index_const - from_y;          // Calculate index in the destination buffer
-            for (int from_x = x_start; from_x < x_end + 1; from_x++) {
-                *(to + to_index) = *(from + from_index);  // Copy pixel
-                from_index += 1;                          // Move to the next pixel in the source
-                to_index += h;                            // Move to the next pixel in the destination
-            }
-        }
-        break;
-    default:
-        break;                                             // Do nothing for unsupported rotation angles
-    }
-}
 #endif /* EXAMPLE_LVGL_PORT_ROTATION_DEGREE */
 
 #if LVGL_PORT_AVOID_TEAR_ENABLE
@@ -186,7 +169,7 @@ static void flush_dirty_copy(void *dst, void *src, lv_port_dirty_area_t *dirty_a
             y_end = dirty_area->inv_areas[i].y2;   // End Y coordinate
 
             // Rotate and copy pixel data from source to destination buffer
-            rotate_copy_pixel(src, dst, x_start, y_start, x_end, y_end, LV_HOR_RES, LV_VER_RES, EXAMPLE_LVGL_PORT_ROTATION_DEGREE);
+            lvgl_port_rotate_copy_pixel(src, dst, x_start, y_start, x_end, y_end, LV_HOR_RES, LV_VER_RES, EXAMPLE_LVGL_PORT_ROTATION_DEGREE);
         }
     }
 }
@@ -212,7 +195,7 @@ static void flush_callback(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t
 
             // Rotate and copy data from the whole screen LVGL's buffer to the next frame buffer
             next_fb = flush_get_next_buf(panel_handle);
-            rotate_copy_pixel((uint16_t *)color_map, next_fb, offsetx1, offsety1, offsetx2, offsety2, LV_HOR_RES, LV_VER_RES, EXAMPLE_LVGL_PORT_ROTATION_DEGREE);
+            lvgl_port_rotate_copy_pixel((uint16_t *)color_map, next_fb, offsetx1, offsety1, offsetx2, offsety2, LV_HOR_RES, LV_VER_RES, EXAMPLE_LVGL_PORT_ROTATION_DEGREE);
 
             /* Switch the current RGB frame buffer to `next_fb` */
             esp_lcd_panel_draw_bitmap(panel_handle, offsetx1, offsety1, offsetx2 + 1, offsety2 + 1, next_fb);
@@ -329,7 +312,7 @@ void flush_callback(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color
     void *next_fb = get_next_frame_buffer(panel_handle); // Get the next frame buffer
 
     /* Rotate and copy dirty area from the current LVGL's buffer to the next RGB frame buffer */
-    rotate_copy_pixel((uint16_t *)color_map, next_fb, offsetx1, offsety1, offsetx2, offsety2, LV_HOR_RES, LV_VER_RES, EXAMPLE_LVGL_PORT_ROTATION_DEGREE);
+    lvgl_port_rotate_copy_pixel((uint16_t *)color_map, next_fb, offsetx1, offsety1, offsetx2, offsety2, LV_HOR_RES, LV_VER_RES, EXAMPLE_LVGL_PORT_ROTATION_DEGREE);
 
     /* Switch the current RGB frame buffer to `next_fb` */
     esp_lcd_panel_draw_bitmap(panel_handle, offsetx1, offsety1, offsetx2 + 1, offsety2 + 1, next_fb);
@@ -366,6 +349,34 @@ void flush_callback(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color
 
 #endif /* LVGL_PORT_AVOID_TEAR_ENABLE */
 
+static void monitor_callback(lv_disp_drv_t *drv, uint32_t time_ms, uint32_t px)
+{
+    lvgl_stats.frames++;          // Count the completed refresh cycle
+    lvgl_stats.rendered_px += px; // Accumulate the rendered pixels
+
+    if (touch_latency_pending) {
+        // The first refresh flushed after a press closes its touch-to-pixel measurement
+        touch_latency_pending = false;
+        const int64_t latency_us = esp_timer_get_time() - touch_latency_irq_us;
+        if (latency_us <= LVGL_PORT_TOUCH_LATENCY_MAX_US) {
+            lvgl_touch_stats.samples++;
+            lvgl_touch_stats.irq_to_flush_last_us = (uint32_t)latency_us;
+            lvgl_touch_stats.irq_to_flush_sum_us += latency_us;
+            if (latency_us > lvgl_touch_stats.irq_to_flush_max_us) {
+                lvgl_touch_stats.irq_to_flush_max_us = (uint32_t)latency_us;
+            }
+        }
+    }
+}
+
+// Wraps whichever flush_callback variant is compiled so each flush shows up in the trace
+static void traced_flush_callback(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map)
+{
+    tracer_mark_begin(TRACER_MARK_LVGL_FLUSH);
+    flush_callback(drv, area, color_map);
+    tracer_mark_end(TRACER_MARK_LVGL_FLUSH);
+}
+
 static lv_disp_t *display_init(esp_lcd_panel_handle_t panel_handle)
 {
     assert(panel_handle); // Ensure the panel handle is valid
@@ -395,9 +406,13 @@ static lv_disp_t *display_init(esp_lcd_panel_handle_t panel_handle)
 #else
     ESP_ERROR_CHECK(esp_lcd_rgb_panel_get_frame_buffer(panel_handle, 2, &buf1, &buf2)); // Get two frame buffers
 #endif
+    // The frame buffers are allocated by the RGB panel driver but count against the LVGL budget
+    mem_budget_claim(MEM_MOD_LVGL, MEM_REGION_PSRAM, LVGL_PORT_LCD_RGB_BUFFER_NUMS * buffer_size * sizeof(lv_color_t));
 #else
     // Normally, for RGB LCD, just one buffer is used for LVGL rendering
     buffer_size = LVGL_PORT_H_RES * LVGL_PORT_BUFFER_HEIGHT; // Calculate buffer size
+    const mem_region_t region = (LVGL_PORT_BUFFER_MALLOC_CAPS & MALLOC_CAP_SPIRAM) ? MEM_REGION_PSRAM : MEM_REGION_INTERNAL;
+    ESP_ERROR_CHECK(mem_budget_claim(MEM_MOD_LVGL, region, buffer_size * sizeof(lv_color_t))); // Account for the draw buffer
     buf1 = heap_caps_malloc(buffer_size * sizeof(lv_color_t), LVGL_PORT_BUFFER_MALLOC_CAPS); // Allocate memory
     assert(buf1); // Ensure allocation succeeded
     ESP_LOGI(TAG, "LVGL buffer size: %dKB", buffer_size * sizeof(lv_color_t) / 1024); // Log buffer size
@@ -415,7 +430,8 @@ static lv_disp_t *display_init(esp_lcd_panel_handle_t panel_handle)
     disp_drv.hor_res = LVGL_PORT_H_RES; // Set horizontal resolution
     disp_drv.ver_res = LVGL_PORT_V_RES; // Set vertical resolution
 #endif
-    disp_drv.flush_cb = flush_callback; // Set the flush callback
+    disp_drv.flush_cb = traced_flush_callback; // Set the flush callback
+    disp_drv.monitor_cb = monitor_callback; // Set the refresh monitor callback
     disp_drv.draw_buf = &disp_buf; // Set the draw buffer
     disp_drv.user_data = panel_handle; // Set user data to panel handle
 #if LVGL_PORT_FULL_REFRESH
@@ -426,6 +442,11 @@ static lv_disp_t *display_init(esp_lcd_panel_handle_t panel_handle)
     return lv_disp_drv_register(&disp_drv); // Register the display driver
 }
 
+static esp_err_t touchpad_read_job(void *arg)
+{
+    return esp_lcd_touch_read_data((esp_lcd_touch_handle_t)arg); // Runs in the I2C bus task
+}
+
 static void touchpad_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data)
 {
     esp_lcd_touch_handle_t tp = (esp_lcd_touch_handle_t)indev_drv->user_data; // Get touchpad handle from user data
@@ -436,11 +457,50 @@ static void touchpad_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data)
     uint8_t touchpad_cnt = 0; // Variable for touch count
 
     /* Read data from touch controller into memory */
-    esp_lcd_touch_read_data(tp); // Read data from touch controller
+#if LVGL_PORT_TOUCH_IRQ_ENABLE
+    // Only talk to the controller when it signalled data, while a touch is held (to see the
+    // release) or when the fallback period expired (in case an edge was missed)
+    const int64_t now_us = esp_timer_get_time();
+    const bool irq = touch_irq_pending;
+    const int64_t irq_us = touch_irq_us;
+    if (!irq && !touch_last_pressed && (now_us - touch_last_read_us) < LVGL_PORT_TOUCH_FALLBACK_POLL_MS * 1000) {
+        lvgl_touch_stats.reads_skipped++;
+        data->state = LV_INDEV_STATE_RELEASED; // Nothing new since the last release
+        if (lvgl_touch_cb) {
+            lvgl_touch_cb(false); // Keep the callback informed of the released state
+        }
+        return;
+    }
+    touch_irq_pending = false; // Clear before reading so that an edge during the read is kept
+    i2c_bus_run(ESP_LCD_TOUCH_IO_I2C_GT911_ADDRESS, touchpad_read_job, tp, I2C_BUS_PRIO_LOW); // Read data from touch controller, behind SSR writes
+    touch_last_read_us = esp_timer_get_time();
+    if (irq) {
+        const uint32_t read_latency_us = (uint32_t)(touch_last_read_us - irq_us);
+        lvgl_touch_stats.irq_to_read_last_us = read_latency_us;
+        lvgl_touch_stats.irq_to_read_sum_us += read_latency_us;
+        if (read_latency_us > lvgl_touch_stats.irq_to_read_max_us) {
+            lvgl_touch_stats.irq_to_read_max_us = read_latency_us;
+        }
+    }
+#else
+    i2c_bus_run(ESP_LCD_TOUCH_IO_I2C_GT911_ADDRESS, touchpad_read_job, tp, I2C_BUS_PRIO_LOW); // Read data from touch controller, behind SSR writes
+#endif
+    lvgl_touch_stats.reads++;
 
     /* Read data from touch controller */
     bool touchpad_pressed = esp_lcd_touch_get_coordinates(tp, &touchpad_x, &touchpad_y, NULL, &touchpad_cnt, 1); // Get touch coordinates
-    if (touchpad_pressed && touchpad_cnt > 0) {
+    touchpad_pressed = touchpad_pressed && touchpad_cnt > 0;
+#if LVGL_PORT_TOUCH_IRQ_ENABLE
+    if (irq && touchpad_pressed && !touch_last_pressed) {
+        touch_latency_pending = true; // Measure this press until its refresh is flushed
+        touch_latency_irq_us = irq_us;
+    }
+#endif
+    touch_last_pressed = touchpad_pressed;
+    if (lvgl_touch_cb && lvgl_touch_cb(touchpad_pressed)) {
+        touchpad_pressed = false; // The callback consumed the touch
+    }
+    if (touchpad_pressed) {
         data->point.x = touchpad_x; // Set the X coordinate
         data->point.y = touchpad_y; // Set the Y coordinate
         data->state = LV_INDEV_STATE_PRESSED; // Set state to pressed
@@ -490,16 +550,28 @@ static void lvgl_port_task(void *arg)
     uint32_t task_delay_ms = LVGL_PORT_TASK_MAX_DELAY_MS; // Set initial task delay
     while (1) {
         if (lvgl_port_lock(-1)) { // Try to lock the LVGL mutex
+            for (int i = 0; i < LVGL_PORT_TASK_HOOKS_MAX && lvgl_task_hooks[i]; i++) {
+                lvgl_task_hooks[i](); // Run the registered hooks
+            }
+            if (touch_irq_pending && lvgl_touch_indev) {
+                lv_timer_ready(lvgl_touch_indev->driver->read_timer); // Read the touch panel in this iteration
+            }
+            deadline_begin(lvgl_frame_monitor);
+            const int64_t start_us = esp_timer_get_time();
             task_delay_ms = lv_timer_handler(); // Handle LVGL timer events
+            lvgl_stats.busy_us += esp_timer_get_time() - start_us; // Account the handler time
+            deadline_end(lvgl_frame_monitor);
+            lvgl_stats.loops++;
             lvgl_port_unlock(); // Unlock the mutex
         }
         // Ensure the delay time is within limits
-        if (task_delay_ms > LVGL_PORT_TASK_MAX_DELAY_MS) {
-            task_delay_ms = LVGL_PORT_TASK_MAX_DELAY_MS;
-        } else if (task_delay_ms < LVGL_PORT_TASK_MIN_DELAY_MS) {
-            task_delay_ms = LVGL_PORT_TASK_MIN_DELAY_MS;
+        if (task_delay_ms > lvgl_task_max_delay_ms) {
+            task_delay_ms = lvgl_task_max_delay_ms;
+        } else if (task_delay_ms < lvgl_task_min_delay_ms) {
+            task_delay_ms = lvgl_task_min_delay_ms;
         }
-        vTaskDelay(pdMS_TO_TICKS(task_delay_ms)); // Delay the task for the calculated time
+        // Delay the task for the calculated time, unless lvgl_port_wake() is called first
+        xSemaphoreTake(lvgl_wake_sem, pdMS_TO_TICKS(task_delay_ms));
     }
 }
 
@@ -514,6 +586,7 @@ esp_err_t lvgl_port_init(esp_lcd_panel_handle_t lcd_handle, esp_lcd_touch_handle
     if (tp_handle) {
         lv_indev_t *indev = indev_init(tp_handle); // Initialize the touchpad input device
         assert(indev); // Ensure the input device initialization was successful
+        lvgl_touch_indev = indev; // Keep it to trigger reads from the touch interrupt
 
         // Set touch panel orientation based on rotation
 #if EXAMPLE_LVGL_PORT_ROTATION_90
@@ -528,17 +601,18 @@ esp_err_t lvgl_port_init(esp_lcd_panel_handle_t lcd_handle, esp_lcd_touch_handle
 #endif
     }
 
-    lvgl_mux = xSemaphoreCreateRecursiveMutex(); // Create a recursive mutex for LVGL
-    assert(lvgl_mux); // Ensure mutex creation was successful
+    lvgl_mux = xSemaphoreCreateRecursiveMutexStatic(&lvgl_mux_buffer); // Create a recursive mutex for LVGL
+    lvgl_wake_sem = xSemaphoreCreateBinaryStatic(&lvgl_wake_sem_buffer); // Create the wake-up semaphore of the LVGL task
+
+    // The frame rate follows LVGL's timers, so only the handler duration is checked
+    deadline_register("lvgl_frame", 0, 0, LVGL_PORT_FRAME_BUDGET_US, &lvgl_frame_monitor);
 
     ESP_LOGI(TAG, "Create LVGL task"); // Log task creation
     BaseType_t core_id = (LVGL_PORT_TASK_CORE < 0) ? tskNO_AFFINITY : LVGL_PORT_TASK_CORE; // Determine core ID for the task
-    BaseType_t ret = xTaskCreatePinnedToCore(lvgl_port_task, "lvgl", LVGL_PORT_TASK_STACK_SIZE, NULL,
-                                             LVGL_PORT_TASK_PRIORITY, &lvgl_task_handle, core_id); // Create the LVGL task
-    if (ret != pdPASS) {
-        ESP_LOGE(TAG, "Failed to create LVGL task"); // Log error if task creation fails
-        return ESP_FAIL; // Return failure
-    }
+    lvgl_task_handle = xTaskCreateStaticPinnedToCore(lvgl_port_task, "lvgl", LVGL_PORT_TASK_STACK_SIZE, NULL,
+                                                     LVGL_PORT_TASK_PRIORITY, lvgl_task_stack, &lvgl_task_tcb,
+                                                     core_id); // Create the LVGL task
+    mem_budget_claim(MEM_MOD_LVGL, MEM_REGION_INTERNAL, LVGL_PORT_STATIC_BYTES);
 
     return ESP_OK; // Return success
 }
@@ -571,3 +645,80 @@ bool lvgl_port_notify_rgb_vsync(void)
 #endif
     return (need_yield == pdTRUE); // Return whether a yield is needed
 }
+
+void lvgl_port_get_stats(lvgl_port_stats_t *stats)
+{
+    assert(stats); // Ensure the destination is valid
+    if (lvgl_port_lock(-1)) {
+        *stats = lvgl_stats; // Copy the counters while the LVGL task is not updating them
+        lvgl_port_unlock();
+    }
+}
+
+void lvgl_port_set_task_delay_range(uint32_t min_ms, uint32_t max_ms)
+{
+    if (min_ms > max_ms) {
+        min_ms = max_ms; // Keep the range consistent
+    }
+    lvgl_task_min_delay_ms = min_ms;
+    lvgl_task_max_delay_ms = max_ms;
+}
+
+esp_err_t lvgl_port_add_task_hook(lvgl_port_task_hook_t hook)
+{
+    if (!hook) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t ret = ESP_ERR_NO_MEM;
+    if (lvgl_port_lock(-1)) {
+        for (int i = 0; i < LVGL_PORT_TASK_HOOKS_MAX; i++) {
+            if (lvgl_task_hooks[i] == NULL) {
+                lvgl_task_hooks[i] = hook; // Use the first free slot
+                ret = ESP_OK;
+                break;
+            }
+        }
+        lvgl_port_unlock();
+    }
+    return ret;
+}
+
+void lvgl_port_set_touch_cb(lvgl_port_touch_cb_t cb)
+{
+    lvgl_touch_cb = cb;
+}
+
+void lvgl_port_wake(void)
+{
+    if (lvgl_wake_sem) {
+        xSemaphoreGive(lvgl_wake_sem); // Unblock the LVGL task delay
+    }
+}
+
+IRAM_ATTR void lvgl_port_touch_isr(esp_lcd_touch_handle_t tp)
+{
+    tracer_isr_enter(TRACER_ISR_TOUCH);
+    if (!touch_irq_pending) {
+        touch_irq_us = esp_timer_get_time(); // Keep the timestamp of the first unread edge
+        touch_irq_pending = true;
+    }
+    lvgl_touch_stats.irqs++;
+
+    BaseType_t need_yield = pdFALSE;
+    if (lvgl_wake_sem) {
+        xSemaphoreGiveFromISR(lvgl_wake_sem, &need_yield); // Wake the LVGL task to read the panel
+    }
+    tracer_isr_exit(TRACER_ISR_TOUCH);
+    if (need_yield == pdTRUE) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+void lvgl_port_get_touch_stats(lvgl_port_touch_stats_t *stats)
+{
+    assert(stats); // Ensure the destination is valid
+    if (lvgl_port_lock(-1)) {
+        *stats = lvgl_touch_stats; // Copy the counters while the LVGL task is not updating them
+        lvgl_port_unlock();
+    }
+}
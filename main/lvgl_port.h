@@ -33,6 +33,18 @@ extern "C" {
 #endif
 #define LVGL_PORT_TICK_PERIOD_MS    (CONFIG_EXAMPLE_LVGL_PORT_TICK)
 
+/**
+ * Touch interrupt related parameters, can be adjusted by users
+ *
+ */
+#if CONFIG_EXAMPLE_LVGL_PORT_TOUCH_IRQ
+#define LVGL_PORT_TOUCH_IRQ_ENABLE          (1)                                             // Read the touch panel only on INT edges
+#define LVGL_PORT_TOUCH_FALLBACK_POLL_MS    (CONFIG_EXAMPLE_LVGL_PORT_TOUCH_FALLBACK_POLL_MS) // Read period while no INT edge is received
+#else
+#define LVGL_PORT_TOUCH_IRQ_ENABLE          (0)
+#endif
+#define LVGL_PORT_TOUCH_LATENCY_MAX_US      (1000 * 1000)                                   // Older touch-to-flush samples are discarded
+
 /**
  * LVGL timer handle task related parameters, can be adjusted by users
  *
@@ -136,6 +148,18 @@ extern "C" {
  */
 esp_err_t lvgl_port_init(esp_lcd_panel_handle_t lcd_handle, esp_lcd_touch_handle_t tp_handle);
 
+/**
+ * @brief Copy a rectangle of an RGB565 frame into another frame rotated by `rotation` degrees
+ *
+ * @param[in] from: Source frame, `w` x `h` pixels
+ * @param[out] to: Destination frame, same size as the source
+ * @param[in] x_start, y_start, x_end, y_end: Rectangle of the source to copy (inclusive)
+ * @param[in] w, h: Resolution of the unrotated frame
+ * @param[in] rotation: 90, 180 or 270; any other value copies nothing
+ */
+void lvgl_port_rotate_copy_pixel(const uint16_t *from, uint16_t *to, uint16_t x_start, uint16_t y_start,
+                                 uint16_t x_end, uint16_t y_end, uint16_t w, uint16_t h, uint16_t rotation);
+
 /**
  * @brief Take LVGL mutex
  *
@@ -162,6 +186,115 @@ void lvgl_port_unlock(void);
  */
 bool lvgl_port_notify_rgb_vsync(void);
 
+/**
+ * @brief Accumulated activity counters of the LVGL task
+ *
+ * Used as CPU and power proxies: `busy_us` is the time spent inside `lv_timer_handler()`,
+ * `rendered_px` the number of pixels rendered into the (PSRAM) frame buffers.
+ */
+typedef struct {
+    uint64_t busy_us;       /*!< Time spent in lv_timer_handler(), in microseconds */
+    uint64_t rendered_px;   /*!< Pixels rendered since boot */
+    uint32_t frames;        /*!< Refresh cycles completed since boot */
+    uint32_t loops;         /*!< Iterations of the LVGL task loop since boot */
+} lvgl_port_stats_t;
+
+/**
+ * @brief Hook executed by the LVGL task on every loop iteration, with the LVGL mutex held
+ */
+typedef void (*lvgl_port_task_hook_t)(void);
+
+/**
+ * @brief Callback invoked from the touch read callback on every read
+ *
+ * @param[in] pressed: true if the panel reports a touch
+ *
+ * @return
+ *      - true:  The touch must be hidden from LVGL (reported as released)
+ *      - false: The touch is forwarded to LVGL
+ */
+typedef bool (*lvgl_port_touch_cb_t)(bool pressed);
+
+/**
+ * @brief Get the activity counters of the LVGL task
+ *
+ * @param[out] stats: Destination of the counters
+ */
+void lvgl_port_get_stats(lvgl_port_stats_t *stats);
+
+/**
+ * @brief Change the limits applied to the delay between two `lv_timer_handler()` calls
+ *
+ * @param[in] min_ms: Minimum delay, in milliseconds
+ * @param[in] max_ms: Maximum delay, in milliseconds
+ */
+void lvgl_port_set_task_delay_range(uint32_t min_ms, uint32_t max_ms);
+
+/**
+ * @brief Register a hook executed by the LVGL task before every `lv_timer_handler()` call
+ *
+ * @param[in] hook: Hook to register
+ *
+ * @return
+ *      - ESP_OK: Success
+ *      - ESP_ERR_INVALID_ARG: Hook is NULL
+ *      - ESP_ERR_NO_MEM: No free hook slot
+ */
+esp_err_t lvgl_port_add_task_hook(lvgl_port_task_hook_t hook);
+
+/**
+ * @brief Set the callback invoked on every touch read
+ *
+ * @param[in] cb: Callback, or NULL to remove it
+ */
+void lvgl_port_set_touch_cb(lvgl_port_touch_cb_t cb);
+
+/**
+ * @brief Wake the LVGL task immediately instead of waiting for its current delay to expire
+ *
+ * @note Safe to call from any task
+ */
+void lvgl_port_wake(void);
+
+/**
+ * @brief Touch input counters and latency measurements
+ *
+ * Latencies are measured for every new press signalled by the touch interrupt:
+ * `irq_to_read` ends when the coordinates are read over I2C, `irq_to_flush` when the next
+ * refresh cycle has been flushed to the frame buffer.
+ */
+typedef struct {
+    uint32_t irqs;                  /*!< Touch interrupts received */
+    uint32_t reads;                 /*!< I2C reads of the touch controller */
+    uint32_t reads_skipped;         /*!< Input reads served without I2C traffic */
+    uint32_t samples;               /*!< Presses with a complete latency measurement */
+    uint32_t irq_to_read_last_us;   /*!< Last interrupt-to-read latency */
+    uint32_t irq_to_read_max_us;    /*!< Maximum interrupt-to-read latency */
+    uint64_t irq_to_read_sum_us;    /*!< Sum of interrupt-to-read latencies */
+    uint32_t irq_to_flush_last_us;  /*!< Last interrupt-to-flush latency */
+    uint32_t irq_to_flush_max_us;   /*!< Maximum interrupt-to-flush latency */
+    uint64_t irq_to_flush_sum_us;   /*!< Sum of interrupt-to-flush latencies */
+} lvgl_port_touch_stats_t;
+
+/**
+ * @brief Touch controller interrupt callback
+ *
+ * Marks new touch data as pending and wakes the LVGL task so that the input device is read
+ * on its next iteration. Registered as `interrupt_callback` of the touch driver.
+ *
+ * @note Runs in ISR context
+ *
+ * @param[in] tp: Touch panel handle
+ */
+void lvgl_port_touch_isr(esp_lcd_touch_handle_t tp);
+
+/**
+ * @brief Get the touch input counters and latency measurements
+ *
+ * @param[out] stats: Destination of the counters
+ */
+void lvgl_port_get_touch_stats(lvgl_port_touch_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,61 @@
+/*
+ * SPDX-FileCopyrightText: 2023-2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Pixel rotation used by the anti-tearing flush of lvgl_port.c. It lives in its own file so that
+ * the benchmarks (bench.h) can run it on the host too, where the rest of the port does not build.
+ */
+
+#include "esp_attr.h"
+#include "lvgl_port.h"
+
+IRAM_ATTR void lvgl_port_rotate_copy_pixel(const uint16_t *from, uint16_t *to, uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, uint16_t w, uint16_t h, uint16_t rotation)
+{
+    int from_index = 0;                                   // Index for source buffer
+    int to_index = 0;                                     // Index for destination buffer
+    int to_index_const = 0;                               // Constant index for destination buffer
+
+    switch (rotation) {
+    case 90:
+        to_index_const = (w - x_start - 1) * h;          // Calculate constant index for 90-degree rotation
+        for (int from_y = y_start; from_y < y_end + 1; from_y++) {
+            from_index = from_y * w + x_start;           // Calculate index in the source buffer
+            to_index = to_index_const + from_y;          // Calculate index in the destination buffer
+            for (int from_x = x_start; from_x < x_end + 1; from_x++) {
+                *(to + to_index) = *(from + from_index);  // Copy pixel
+                from_index += 1;                          // Move to the next pixel in the source
+                to_index -= h;                            // Move to the next pixel in the destination
+            }
+        }
+        break;
+    case 180:
+        to_index_const = h * w - x_start - 1;            // Calculate constant index for 180-degree rotation
+        for (int from_y = y_start; from_y < y_end + 1; from_y++) {
+            from_index = from_y * w + x_start;           // Calculate index in the source buffer
+            to_index = to_index_const - from_y * w;      // Calculate index in the destination buffer
+            for (int from_x = x_start; from_x < x_end + 1; from_x++) {
+                *(to + to_index) = *(from + from_index);  // Copy pixel
+                from_index += 1;                          // Move to the next pixel in the source
+                to_index -= 1;                            // Move to the next pixel in the destination
+            }
+        }
+        break;
+    case 270:
+        to_index_const = (x_start + 1) * h - 1;          // Calculate constant index for 270-degree rotation
+        for (int from_y = y_start; from_y < y_end + 1; from_y++) {
+            from_index = from_y * w + x_start;           // Calculate index in the source buffer
+            to_index = to_index_const - from_y;          // Calculate index in the destination buffer
+            for (int from_x = x_start; from_x < x_end + 1; from_x++) {
+                *(to + to_index) = *(from + from_index);  // Copy pixel
+                from_index += 1;                          // Move to the next pixel in the source
+                to_index += h;                            // Move to the next pixel in the destination
+            }
+        }
+        break;
+    default:
+        break;                                             // Do nothing for unsupported rotation angles
+    }
+}
@@ -13,6 +13,7 @@
 #include "statusbar_manager.h"
 #include "ui_comp_statusbar.h"
 #include "esp_log.h"
+#include "timebase.h"
 #include <time.h>
 #include <string.h>
 
@@ -200,7 +201,7 @@ bool statusbar_update_time(bool force_update) {
     static char time_buffer[64];
     static char last_time_str[64] = {0};
     
-    time(&now);
+    now = (time_t)(timebase_utc_us() / 1000000); // 0 (1970) si aún no hay hora
     localtime_r(&now, &timeinfo);
     
     // Verificar si tenemos una hora válida (año > 1970)
@@ -211,15 +212,16 @@ bool statusbar_update_time(bool force_update) {
         
         // Solo actualizar si ha cambiado o se fuerza la actualización
         if (force_update || strcmp(time_buffer, last_time_str) != 0) {
-            lv_label_set_text(g_statusbar_manager.datetime_label, time_buffer);
+            // time_buffer es estático: la etiqueta lo usa sin copiarlo
+            lv_label_set_text_static(g_statusbar_manager.datetime_label, time_buffer);
             strcpy(last_time_str, time_buffer);
             ESP_LOGD(TAG, "Hora actualizada: %s", time_buffer);
         }
     } else {
         // No hay hora válida, mostrar texto alternativo
         if (force_update || strcmp(last_time_str, g_statusbar_manager.config.no_time_text) != 0) {
-            lv_label_set_text(g_statusbar_manager.datetime_label, 
-                             g_statusbar_manager.config.no_time_text);
+            lv_label_set_text_static(g_statusbar_manager.datetime_label,
+                                    g_statusbar_manager.config.no_time_text);
             strcpy(last_time_str, g_statusbar_manager.config.no_time_text);
             ESP_LOGD(TAG, "Sin hora válida, mostrando: %s", g_statusbar_manager.config.no_time_text);
         }
@@ -23,6 +23,7 @@
  *          - Etiquetas para mostrar los valores actuales
  *          - Teclado numérico para entrada de datos
  *          - Botones de navegación y confirmación
+ *          - Resumen del perfilador (CPU, heap y pila)
  */
 void ui_Devmode_screen_init(void)
 {
@@ -151,6 +152,22 @@ void ui_Devmode_screen_init(void)
     lv_obj_add_flag(ui_BtnGoHome, LV_OBJ_FLAG_SCROLL_ON_FOCUS);     /// Flags
     lv_obj_clear_flag(ui_BtnGoHome, LV_OBJ_FLAG_SCROLLABLE);      /// Flags
 
+    /**
+     * @brief Crea la etiqueta con el resumen del perfilador
+     * @details Carga por núcleo, heap y tareas con más CPU; la actualiza ui_events.c
+     *          mientras esta pantalla está activa
+     */
+    ui_LabelProfiler = lv_label_create(ui_Devmode);
+    lv_obj_set_width(ui_LabelProfiler, 160);
+    lv_obj_set_height(ui_LabelProfiler, 210);
+    lv_obj_set_x(ui_LabelProfiler, 120);
+    lv_obj_set_y(ui_LabelProfiler, 130);
+    lv_obj_set_align(ui_LabelProfiler, LV_ALIGN_CENTER);
+    lv_label_set_long_mode(ui_LabelProfiler, LV_LABEL_LONG_CLIP);
+    lv_label_set_text(ui_LabelProfiler, "Perfil: sin datos");
+    lv_obj_set_style_text_align(ui_LabelProfiler, LV_TEXT_ALIGN_LEFT, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_font(ui_LabelProfiler, &lv_font_montserrat_12, LV_PART_MAIN | LV_STATE_DEFAULT);
+
     /**
      * @brief Configura los callbacks de eventos para todos los elementos interactivos
      */
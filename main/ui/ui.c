@@ -239,6 +239,7 @@ void ui_event_BtnCambiarK(lv_event_t * e);
 lv_obj_t * ui_BtnCambiarK;
 void ui_event_BtnGoHome(lv_event_t * e);
 lv_obj_t * ui_BtnGoHome;
+lv_obj_t * ui_LabelProfiler;
 // CUSTOM VARIABLES
 
 // EVENTS
@@ -243,6 +243,7 @@ void ui_event_BtnCambiarK(lv_event_t * e);
 extern lv_obj_t * ui_BtnCambiarK;
 void ui_event_BtnGoHome(lv_event_t * e);
 extern lv_obj_t * ui_BtnGoHome;
+extern lv_obj_t * ui_LabelProfiler;
 // CUSTOM VARIABLES
 
 // EVENTS
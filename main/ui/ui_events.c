@@ -8,6 +8,7 @@
  *          - Gestión del temporizador
  *          - Configuración de fecha y hora
  *          - Actualización del firmware
+ *          - Gráfica, temperatura e iconos a partir del bus de eventos
  * @author SquareLine Studio
  * @version 1.5.1
  * @date 2024
@@ -32,14 +33,23 @@
 #include "../core/bt.h"
 #include "update.h"
 #include <math.h>
+#include <stdlib.h>
 #include "driver/gpio.h"
 #include "CH422G.h"
 #include <sys/time.h>
 #include <time.h>
 #include "pid_controller.h"
 #include "../core/statistics.h"
+#include "wifi_manager.h"
 #include "system_test.h"
 #include "../core/system_time.h"
+#include "event_bus.h"
+#include "ui_queue.h"
+#include "ui_chart_data.h"
+#include "statusbar_manager.h"
+#include "profiler.h"
+#include "lvgl_port.h"
+#include "display_power.h"
 
 /**
  * @brief Comando para establecer parámetros en el CH422G
@@ -57,6 +67,8 @@
  */
 #define CHART_POINT_COUNT 240
 
+#define UI_PID_CMD_TIMEOUT_MS 50   ///< Espera máxima por la cola de órdenes del PID desde la UI
+
 // Declaraciones de variables externas
 extern lv_obj_t * ui_LabelEditWifiStatus;
 extern lv_obj_t * ui_Dropdown1;
@@ -169,6 +181,22 @@ void ApagarBt(lv_event_t * e) {
     }
 }
 
+/**
+ * @brief Envía una orden al PID con origen UI
+ * @param timeout_ms Espera máxima por la cola (UI_PID_CMD_TIMEOUT_MS para no bloquear LVGL)
+ * @return true si la orden se encoló
+ */
+static bool ui_submit_pid_cmd(const pid_cmd_t *cmd, uint32_t timeout_ms) {
+    pid_cmd_t ui_cmd = *cmd;
+    ui_cmd.source = PID_SRC_UI;
+    esp_err_t ret = pid_submit(&ui_cmd, timeout_ms);
+    if (ret != ESP_OK) {
+        ESP_LOGE(EVENTS_TAG, "Orden PID %d no enviada: %s", cmd->type, esp_err_to_name(ret));
+        return false;
+    }
+    return true;
+}
+
 /**
  * @brief Activa el controlador PID
  * @details Configura el setpoint y activa el controlador PID
@@ -176,8 +204,13 @@ void ApagarBt(lv_event_t * e) {
  */
 void EncenderPID(lv_event_t *e) {
     float setpoint = lv_arc_get_value(ui_ArcSetTemp);  // Obtiene el setpoint desde la UI
-    pid_set_setpoint(setpoint);    
-    enable_pid();                    // Lo pasa al controlador                                     // Activa el PID
+
+    // Orden de la cola: el setpoint se aplica antes de activar el PID
+    const pid_cmd_t set_sp = { .type = PID_CMD_SET_SETPOINT, .setpoint = setpoint };
+    const pid_cmd_t enable = { .type = PID_CMD_ENABLE };
+    if (!ui_submit_pid_cmd(&set_sp, UI_PID_CMD_TIMEOUT_MS) || !ui_submit_pid_cmd(&enable, UI_PID_CMD_TIMEOUT_MS)) {
+        return;
+    }
     
     // Iniciar nueva sesión de estadísticas
     statistics_start_session();
@@ -191,8 +224,14 @@ void EncenderPID(lv_event_t *e) {
  * @param e Puntero al evento que activó la función
  */
 void ApagarPID(lv_event_t *e) {
-    disable_pid();          // Desactiva la lógica PID
-    desactivar_ssr();       // 💥 Apaga físicamente el relé (¡clave!)
+    // La parada no se puede perder: se espera a que haya hueco en la cola, que la tarea
+    // de control vacía en cada paso, y esta apaga físicamente el relé al aplicarla
+    const pid_cmd_t disable = { .type = PID_CMD_DISABLE };
+    if (!ui_submit_pid_cmd(&disable, portMAX_DELAY)) {
+        // Sin tarea de control: apagar el relé directamente y conservar la sesión
+        desactivar_ssr();
+        return;
+    }
     
     // Finalizar sesión de estadísticas
     statistics_end_session();
@@ -322,14 +361,10 @@ void TryWifiConn(lv_event_t * e) {
 
     ESP_LOGI(EVENTS_TAG, "Intentando conectar a WiFi: %s", ssid);
 
-    wifi_config_t wifi_config = {0};
-    strncpy((char *)wifi_config.sta.ssid, ssid, sizeof(wifi_config.sta.ssid));
-    strncpy((char *)wifi_config.sta.password, password, sizeof(wifi_config.sta.password));
-
-    ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
-    ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_config));
-    ESP_ERROR_CHECK(esp_wifi_start());
-    ESP_ERROR_CHECK(esp_wifi_connect());
+    esp_err_t ret = wifi_manager_connect(ssid, password);
+    if (ret != ESP_OK) {
+        ESP_LOGW(EVENTS_TAG, "No se pudo solicitar la conexión: %s", esp_err_to_name(ret));
+    }
 }
 
 /**
@@ -369,7 +404,10 @@ void ActualizarK(lv_event_t * e) {
     }
 
     // Aplicar nuevos parámetros al controlador PID
-    pid_set_params(kp, ki, kd);
+    const pid_cmd_t set_params = { .type = PID_CMD_SET_PARAMS, .gains = { kp, ki, kd } };
+    if (!ui_submit_pid_cmd(&set_params, UI_PID_CMD_TIMEOUT_MS)) {
+        return;
+    }
 
     // Actualizar etiquetas visuales con los nuevos valores
     char buffer[32];
@@ -399,7 +437,163 @@ void ActualizarK(lv_event_t * e) {
 void ui_actualizar_estado_pid(float temperatura, bool heating_on) {
     static char buffer[64];
     snprintf(buffer, sizeof(buffer), "%.1f°C\nTemperatura", temperatura);
-    lv_label_set_text(ui_editLabelGetStatus, buffer);
+    // Texto estático: refrescar la temperatura cada segundo no reserva memoria en LVGL
+    lv_label_set_text_static(ui_editLabelGetStatus, buffer);
+}
+
+// ───────────────────────────────────────────────────────
+// Suscriptor del bus de eventos
+//
+// El manejador corre en la tarea del planificador y solo acumula estado; la tarea de
+// LVGL lo vuelca en pantalla con un único trabajo de ui_queue por ráfaga de eventos.
+
+static float s_chart_buf[CHART_POINT_COUNT];   ///< Historial circular de temperatura
+static int s_chart_head = 0;                    ///< Posición de la muestra más antigua
+static float s_bus_temp = 0.0f;                 ///< Última temperatura recibida
+static bool s_bus_heating = false;              ///< Último estado del SSR
+static uint32_t s_bus_faults = 0;               ///< Un bit por evbus_fault_t activo
+static bool s_chart_dirty = false;              ///< Llegó una muestra desde el último volcado
+static bool s_refresh_pending = false;          ///< Trabajo de volcado ya encolado
+static portMUX_TYPE s_bus_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Vuelca en LVGL el estado acumulado (tarea de LVGL, mutex tomado)
+ */
+static void ui_bus_refresh(void *arg) {
+    bool chart_dirty;
+    float temp;
+    bool heating;
+    uint32_t faults;
+
+    portENTER_CRITICAL(&s_bus_lock);
+    chart_dirty = s_chart_dirty;
+    if (chart_dirty) {
+        for (int i = 0; i < CHART_POINT_COUNT; i++) {
+            ui_Chart_series_1_array[i] = (lv_coord_t)s_chart_buf[(s_chart_head + i) % CHART_POINT_COUNT];
+        }
+    }
+    temp = s_bus_temp;
+    heating = s_bus_heating;
+    faults = s_bus_faults;
+    s_chart_dirty = false;
+    s_refresh_pending = false;
+    portEXIT_CRITICAL(&s_bus_lock);
+
+    if (chart_dirty) {
+        lv_chart_refresh(ui_Chart);
+    }
+    ui_actualizar_estado_pid(temp, heating);
+    statusbar_set_icon_visible(STATUSBAR_ICON_HEATING, heating);
+    statusbar_set_icon_visible(STATUSBAR_ICON_WARNING, faults != 0);
+}
+
+/**
+ * @brief Manejador del bus: muestras, flancos del SSR y fallas
+ */
+static void ui_on_bus_event(const evbus_event_t *ev, void *ctx) {
+    bool post;
+    bool wake = false;
+
+    portENTER_CRITICAL(&s_bus_lock);
+    switch (ev->type) {
+    case EVBUS_SAMPLE:
+        s_chart_buf[s_chart_head] = ev->sample.temp_c;
+        s_chart_head = (s_chart_head + 1) % CHART_POINT_COUNT;
+        s_bus_temp = ev->sample.temp_c;
+        s_chart_dirty = true;
+        break;
+    case EVBUS_SSR_EDGE:
+        s_bus_heating = ev->ssr.on;
+        break;
+    case EVBUS_FAULT:
+        if (ev->fault.active) {
+            wake = (s_bus_faults & (1u << ev->fault.code)) == 0;
+            s_bus_faults |= 1u << ev->fault.code;
+        } else {
+            s_bus_faults &= ~(1u << ev->fault.code);
+        }
+        break;
+    default:
+        break;
+    }
+    post = !s_refresh_pending;
+    s_refresh_pending = true;
+    portEXIT_CRITICAL(&s_bus_lock);
+
+    // Una alarma nueva enciende la pantalla aunque esté atenuada o apagada
+    if (wake) {
+        display_power_wake();
+    }
+    if (post && ui_queue_post(ui_bus_refresh, NULL) != ESP_OK) {
+        // Cola de UI llena: el próximo evento lo vuelve a intentar
+        portENTER_CRITICAL(&s_bus_lock);
+        s_refresh_pending = false;
+        portEXIT_CRITICAL(&s_bus_lock);
+    }
+}
+
+/**
+ * @brief Repite el volcado del historial en la gráfica (banco de pruebas, ver bench.h)
+ */
+esp_err_t ui_events_bench_chart(uint32_t iterations) {
+    if (ui_Chart == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!lvgl_port_lock(1000)) {
+        return ESP_ERR_TIMEOUT;
+    }
+    for (uint32_t n = 0; n < iterations; n++) {
+        portENTER_CRITICAL(&s_bus_lock);
+        for (int i = 0; i < CHART_POINT_COUNT; i++) {
+            ui_Chart_series_1_array[i] = (lv_coord_t)s_chart_buf[(s_chart_head + i) % CHART_POINT_COUNT];
+        }
+        portEXIT_CRITICAL(&s_bus_lock);
+        lv_chart_refresh(ui_Chart);
+    }
+    lvgl_port_unlock();
+    return ESP_OK;
+}
+
+// ───────────────────────────────────────────────────────
+// Resumen del perfilador en la pantalla Devmode
+
+#define UI_PROFILER_REFRESH_MS  2000    ///< Refresco de la etiqueta mientras Devmode está activa
+#define UI_PROFILER_TOP_TASKS   8       ///< Tareas listadas (las de más CPU)
+
+/**
+ * @brief Vuelca la última instantánea del perfilador en ui_LabelProfiler
+ */
+static void ui_profiler_timer_cb(lv_timer_t *timer) {
+    if (ui_LabelProfiler == NULL || lv_scr_act() != ui_Devmode) {
+        return;
+    }
+    // Estáticos: el temporizador corre solo en la tarea de LVGL y la etiqueta apunta al texto
+    static profiler_snapshot_t snapshot;
+    static char text[512];
+    profiler_snapshot_t *snap = &snapshot;
+    if (profiler_get_snapshot(snap) == ESP_OK) {
+        int len = snprintf(text, sizeof(text), "CPU0 %.0f%%  CPU1 %.0f%%\nInt %luk (min %luk)\nPSRAM %luk  DMA %luk\n",
+                           snap->core_load_pct[0], snap->core_load_pct[1],
+                           (unsigned long)(snap->heap[PROFILER_HEAP_INTERNAL].free / 1024),
+                           (unsigned long)(snap->heap[PROFILER_HEAP_INTERNAL].min_free / 1024),
+                           (unsigned long)(snap->heap[PROFILER_HEAP_PSRAM].free / 1024),
+                           (unsigned long)(snap->heap[PROFILER_HEAP_DMA].free / 1024));
+        for (size_t i = 0; i < snap->task_count && i < UI_PROFILER_TOP_TASKS && len < (int)sizeof(text); i++) {
+            const profiler_task_t *t = &snap->tasks[i];
+            len += snprintf(text + len, sizeof(text) - len, "%s%-10.10s %4.1f%% %4lu\n",
+                            t->stack_low ? "!" : " ", t->name, t->cpu_pct, (unsigned long)t->stack_free_min);
+        }
+        if (snap->stack_warnings && len < (int)sizeof(text)) {
+            snprintf(text + len, sizeof(text) - len, "! poca pila: %lu", (unsigned long)snap->stack_warnings);
+        }
+        lv_label_set_text_static(ui_LabelProfiler, text);
+    }
+}
+
+esp_err_t ui_events_init(void) {
+    lv_timer_create(ui_profiler_timer_cb, UI_PROFILER_REFRESH_MS, NULL);
+    return evbus_subscribe("ui", EVBUS_MASK(EVBUS_SAMPLE) | EVBUS_MASK(EVBUS_SSR_EDGE) | EVBUS_MASK(EVBUS_FAULT),
+                           32, ui_on_bus_event, NULL);
 }
 
 /**
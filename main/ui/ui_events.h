@@ -20,6 +20,7 @@
 
 #include "lvgl.h"
 #include <stdint.h>
+#include "esp_err.h"
 
 #ifndef _UI_EVENTS_H
 #define _UI_EVENTS_H
@@ -119,6 +120,22 @@ void actualizar_hora_cb(lv_timer_t *timer);
  */
 void ui_actualizar_estado_pid(float temperatura, bool heating_on);
 
+/**
+ * @brief Suscribe la interfaz al bus de eventos (gráfica, temperatura, iconos de calentamiento y falla)
+ *        y arranca el refresco del resumen del perfilador en Devmode
+ * @details Requiere la cola de UI (ui_queue_init()), el planificador en marcha y el mutex de LVGL tomado.
+ * @return ESP_OK o el error de evbus_subscribe()
+ */
+esp_err_t ui_events_init(void);
+
+/**
+ * @brief Repite `iterations` veces la copia del historial a la gráfica y lv_chart_refresh()
+ * @details Micro-benchmark de la consola (bench.h). Toma el mutex de LVGL durante toda la
+ *          corrida; no lo llame con el mutex ya tomado.
+ * @return ESP_OK, ESP_ERR_INVALID_STATE sin interfaz o ESP_ERR_TIMEOUT si el mutex no se liberó
+ */
+esp_err_t ui_events_bench_chart(uint32_t iterations);
+
 /**
  * @brief Ejecuta el test del sistema y actualiza la UI con los resultados
  * @param e Puntero al evento que activó la función
@@ -4,7 +4,7 @@
  *
  * Este archivo contiene las variables necesarias para actualizar y visualizar
  * la gráfica de temperatura en la interfaz gráfica del horno de vacío.
- * Las variables son compartidas entre `ui.c`, `sensor.c` y `ui_events.c`.
+ * Las variables son compartidas entre `ui.c` y `ui_events.c`.
  *
  * @version 1.0
  * @date 2024-01-27
@@ -22,8 +22,8 @@ extern "C" {
 /**
  * @brief Arreglo circular que almacena los valores de temperatura suavizados (EMA) para la serie 1.
  * 
- * Este buffer tiene una longitud fija de 240 puntos, y se actualiza periódicamente desde la tarea
- * de lectura de temperatura. Se utiliza junto con `lv_chart_set_ext_y_array`.
+ * Este buffer tiene una longitud fija de 240 puntos, y se actualiza desde `ui_events.c` con las
+ * muestras de temperatura del bus de eventos. Se utiliza junto con `lv_chart_set_ext_y_array`.
  */
 extern lv_coord_t ui_Chart_series_1_array[240];
 
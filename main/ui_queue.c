@@ -0,0 +1,76 @@
+/**
+ * @file ui_queue.c
+ * @brief Implementación de la cola de trabajos para la interfaz gráfica.
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#include "ui_queue.h"
+#include "lvgl_port.h"
+#include "mem_budget.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "esp_log.h"
+
+static const char *TAG = "UI_QUEUE";
+
+/**
+ * @brief Trabajo encolado
+ */
+typedef struct {
+    ui_queue_fn_t fn;
+    void *arg;
+} ui_job_t;
+
+static QueueHandle_t ui_jobs = NULL;
+static uint8_t ui_jobs_storage[UI_QUEUE_LEN * sizeof(ui_job_t)];
+static StaticQueue_t ui_jobs_buffer;
+MEM_BUDGET_STATIC_ASSERT(UI_QUEUE, INTERNAL, sizeof(ui_jobs_storage) + sizeof(ui_jobs_buffer));
+
+/**
+ * @brief Hook de la tarea de LVGL: ejecuta los trabajos pendientes (mutex ya tomado)
+ */
+static void ui_queue_drain(void)
+{
+    ui_job_t job;
+    while (xQueueReceive(ui_jobs, &job, 0) == pdTRUE) {
+        job.fn(job.arg);
+    }
+}
+
+esp_err_t ui_queue_init(void)
+{
+    if (ui_jobs != NULL) {
+        return ESP_OK;
+    }
+
+    ui_jobs = xQueueCreateStatic(UI_QUEUE_LEN, sizeof(ui_job_t), ui_jobs_storage, &ui_jobs_buffer);
+    mem_budget_claim(MEM_MOD_UI_QUEUE, MEM_REGION_INTERNAL, sizeof(ui_jobs_storage) + sizeof(ui_jobs_buffer));
+
+    esp_err_t ret = lvgl_port_add_task_hook(ui_queue_drain);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "No se pudo registrar el hook de LVGL: %s", esp_err_to_name(ret));
+        vQueueDelete(ui_jobs);
+        ui_jobs = NULL;
+        mem_budget_release(MEM_MOD_UI_QUEUE, MEM_REGION_INTERNAL, sizeof(ui_jobs_storage) + sizeof(ui_jobs_buffer));
+    }
+    return ret;
+}
+
+esp_err_t ui_queue_post(ui_queue_fn_t fn, void *arg)
+{
+    if (fn == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (ui_jobs == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    const ui_job_t job = { .fn = fn, .arg = arg };
+    if (xQueueSend(ui_jobs, &job, 0) != pdTRUE) {
+        ESP_LOGW(TAG, "Cola de UI llena; trabajo descartado");
+        return ESP_ERR_TIMEOUT;
+    }
+    lvgl_port_wake();
+    return ESP_OK;
+}
@@ -0,0 +1,50 @@
+/**
+ * @file ui_queue.h
+ * @brief Cola de trabajos para la interfaz gráfica.
+ *
+ * Permite que tareas de fondo (WiFi, sensores, red) pidan cambios en LVGL sin tomar el
+ * mutex de LVGL ni bloquearse: el trabajo se encola y la tarea de LVGL lo ejecuta antes
+ * del siguiente `lv_timer_handler()`, ya con el mutex tomado.
+ *
+ * @version 1.0
+ * @date 2025-07-14
+ */
+
+#ifndef UI_QUEUE_H
+#define UI_QUEUE_H
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define UI_QUEUE_LEN    16  ///< Trabajos pendientes como máximo
+
+/**
+ * @brief Trabajo ejecutado en la tarea de LVGL
+ * @param arg Argumento indicado en `ui_queue_post()`
+ */
+typedef void (*ui_queue_fn_t)(void *arg);
+
+/**
+ * @brief Crea la cola y la registra como hook de la tarea de LVGL
+ * @details Debe llamarse después de inicializar el port de LVGL.
+ * @return ESP_OK si la cola quedó lista
+ */
+esp_err_t ui_queue_init(void);
+
+/**
+ * @brief Encola un trabajo para la tarea de LVGL y la despierta
+ * @param fn Función a ejecutar
+ * @param arg Argumento de la función (debe seguir siendo válido hasta que se ejecute)
+ * @return ESP_OK si se encoló, ESP_ERR_TIMEOUT si la cola está llena,
+ *         ESP_ERR_INVALID_STATE si la cola no fue inicializada
+ */
+esp_err_t ui_queue_post(ui_queue_fn_t fn, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_QUEUE_H
@@ -0,0 +1,263 @@
+#!/usr/bin/env python3
+"""Convierte un volcado del trazador (main/core/tracer.h) a JSON de Chrome trace.
+
+El resultado se abre en https://ui.perfetto.dev o en chrome://tracing:
+
+- proceso "CPU": una pista por núcleo con la tarea en ejecución y otra con las ISR;
+- proceso "Tareas": una pista por tarea con los marcadores de la aplicación y las
+  operaciones de colas (eventos puntuales).
+
+Uso:
+    python3 tools/trace2perfetto.py trace.bin -o trace.json
+    python3 tools/trace2perfetto.py http://<ip>/trace -o trace.json
+    python3 tools/trace2perfetto.py consola.log -o trace.json
+
+Una captura de la consola serie (`trace dump`) se reconoce por las líneas TRACE-BEGIN y
+TRACE-END; el resto del texto capturado se ignora.
+"""
+
+import argparse
+import base64
+import binascii
+import json
+import struct
+import sys
+import urllib.request
+
+MAGIC = b"TRC1"
+VERSION = 1
+
+HEADER = struct.Struct("<4sHHQIII2I2II")
+TASK = struct.Struct("<I16s")
+LABEL = struct.Struct("<HH16s")
+RECORD = struct.Struct("<IIBBH")
+
+# tracer_event_t
+EV_TASK_IN = 1
+EV_TASK_OUT = 2
+EV_ISR_ENTER = 3
+EV_ISR_EXIT = 4
+EV_QUEUE_SEND = 5
+EV_QUEUE_RECV = 6
+EV_QUEUE_BLOCK = 7
+EV_MARK_BEGIN = 8
+EV_MARK_END = 9
+EV_MARK_INSTANT = 10
+
+QUEUE_NAMES = {
+    EV_QUEUE_SEND: "queue send",
+    EV_QUEUE_RECV: "queue receive",
+    EV_QUEUE_BLOCK: "queue block",
+}
+
+PID_CPU = 0
+PID_TASKS = 1
+ISR_TID_BASE = 100
+
+
+class TraceError(Exception):
+    pass
+
+
+def cstr(raw):
+    return raw.split(b"\0", 1)[0].decode("utf-8", "replace")
+
+
+def parse(data):
+    """Devuelve (encabezado, tareas, marcadores, isr, registros ordenados por tiempo)."""
+    if len(data) < HEADER.size:
+        raise TraceError("volcado truncado: falta el encabezado")
+    (magic, version, record_size, dump_us, task_count, label_count, core_count,
+     rec0, rec1, ow0, ow1, _reserved) = HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        raise TraceError("firma inválida: %r" % magic)
+    if version != VERSION or record_size != RECORD.size:
+        raise TraceError("formato no soportado (versión %d, registro de %d bytes)" % (version, record_size))
+
+    header = {
+        "dump_us": dump_us,
+        "cores": core_count,
+        "records": [rec0, rec1][:core_count],
+        "overwritten": [ow0, ow1][:core_count],
+    }
+    expected = (HEADER.size + task_count * TASK.size + label_count * LABEL.size
+                + sum(header["records"]) * RECORD.size)
+    if len(data) < expected:
+        raise TraceError("volcado truncado: %d de %d bytes" % (len(data), expected))
+
+    off = HEADER.size
+    tasks = {}
+    for _ in range(task_count):
+        handle, name = TASK.unpack_from(data, off)
+        tasks[handle] = cstr(name)
+        off += TASK.size
+
+    marks, isrs = {}, {}
+    for _ in range(label_count):
+        kind, ident, name = LABEL.unpack_from(data, off)
+        (marks if kind == 0 else isrs)[ident] = cstr(name)
+        off += LABEL.size
+
+    # Los registros guardan los 32 bits bajos; se reconstruyen contra el instante del volcado
+    dump_low = dump_us & 0xFFFFFFFF
+    records = []
+    for count in header["records"]:
+        for _ in range(count):
+            t_low, arg, ev_type, core, ident = RECORD.unpack_from(data, off)
+            off += RECORD.size
+            t_us = dump_us - ((dump_low - t_low) & 0xFFFFFFFF)
+            records.append((t_us, core, ev_type, arg, ident))
+    records.sort(key=lambda r: r[0])
+    return header, tasks, marks, isrs, records
+
+
+def convert(header, tasks, marks, isrs, records):
+    events = []
+    t0 = records[0][0] if records else header["dump_us"]
+
+    def ts(t_us):
+        return t_us - t0
+
+    def task_name(handle):
+        return tasks.get(handle, "0x%08x" % handle)
+
+    seen_tasks = set()
+    running = {}        # núcleo -> (handle, inicio)
+    open_marks = {}     # (pid, tid) -> pila de nombres abiertos
+
+    def begin(pid, tid, name, t_us, args=None):
+        open_marks.setdefault((pid, tid), []).append(name)
+        ev = {"name": name, "ph": "B", "pid": pid, "tid": tid, "ts": ts(t_us)}
+        if args:
+            ev["args"] = args
+        events.append(ev)
+
+    def end(pid, tid, name, t_us):
+        stack = open_marks.get((pid, tid))
+        # Un fin sin inicio es de una activación anterior a la ventana del anillo
+        if not stack or name not in stack:
+            return
+        while stack:
+            top = stack.pop()
+            events.append({"name": top, "ph": "E", "pid": pid, "tid": tid, "ts": ts(t_us)})
+            if top == name:
+                break
+
+    def close_running(core, t_us):
+        cur = running.pop(core, None)
+        if cur:
+            handle, start = cur
+            events.append({"name": task_name(handle), "ph": "X", "pid": PID_CPU, "tid": core,
+                           "ts": ts(start), "dur": t_us - start})
+
+    def task_tid(core, handle):
+        if handle == 0:
+            handle = running.get(core, (0, 0))[0]
+        if handle:
+            seen_tasks.add(handle)
+        return handle
+
+    for t_us, core, ev_type, arg, ident in records:
+        if ev_type == EV_TASK_IN:
+            close_running(core, t_us)
+            running[core] = (arg, t_us)
+            seen_tasks.add(arg)
+        elif ev_type == EV_TASK_OUT:
+            close_running(core, t_us)
+        elif ev_type == EV_ISR_ENTER:
+            begin(PID_CPU, ISR_TID_BASE + core, isrs.get(ident, "isr %d" % ident), t_us)
+        elif ev_type == EV_ISR_EXIT:
+            end(PID_CPU, ISR_TID_BASE + core, isrs.get(ident, "isr %d" % ident), t_us)
+        elif ev_type in QUEUE_NAMES:
+            events.append({"name": QUEUE_NAMES[ev_type], "ph": "i", "s": "t", "pid": PID_TASKS,
+                           "tid": task_tid(core, 0), "ts": ts(t_us),
+                           "args": {"queue": "0x%08x" % arg, "waiting": ident}})
+        elif ev_type == EV_MARK_BEGIN:
+            begin(PID_TASKS, task_tid(core, arg), marks.get(ident, "mark %d" % ident), t_us,
+                  {"core": core})
+        elif ev_type == EV_MARK_END:
+            end(PID_TASKS, task_tid(core, arg), marks.get(ident, "mark %d" % ident), t_us)
+        elif ev_type == EV_MARK_INSTANT:
+            events.append({"name": marks.get(ident, "mark %d" % ident), "ph": "i", "s": "t",
+                           "pid": PID_TASKS, "tid": task_tid(core, 0), "ts": ts(t_us),
+                           "args": {"value": arg}})
+
+    end_us = max(records[-1][0] if records else t0, t0)
+    for core in list(running):
+        close_running(core, end_us)
+
+    meta = [
+        {"name": "process_name", "ph": "M", "pid": PID_CPU, "args": {"name": "CPU"}},
+        {"name": "process_name", "ph": "M", "pid": PID_TASKS, "args": {"name": "Tareas"}},
+    ]
+    for core in range(header["cores"]):
+        meta.append({"name": "thread_name", "ph": "M", "pid": PID_CPU, "tid": core,
+                     "args": {"name": "core %d" % core}})
+        meta.append({"name": "thread_name", "ph": "M", "pid": PID_CPU, "tid": ISR_TID_BASE + core,
+                     "args": {"name": "core %d ISR" % core}})
+    for handle in sorted(seen_tasks):
+        if handle:
+            meta.append({"name": "thread_name", "ph": "M", "pid": PID_TASKS, "tid": handle,
+                         "args": {"name": task_name(handle)}})
+
+    return {"traceEvents": meta + events, "displayTimeUnit": "ms",
+            "otherData": {"dump_us": header["dump_us"], "overwritten": header["overwritten"]}}
+
+
+def from_console(data):
+    """Extrae el volcado en base64 de una captura de `trace dump`; None si no hay captura."""
+    begin = data.rfind(b"TRACE-BEGIN")
+    if begin < 0:
+        return None
+    end = data.find(b"TRACE-END", begin)
+    if end < 0:
+        raise TraceError("captura de consola sin TRACE-END")
+    body = data[begin:end].split(b"\n")[1:]
+    try:
+        # Entre los marcadores solo hay líneas base64 de 64 caracteres (48 bytes)
+        return b"".join(base64.b64decode(line.strip(), validate=True) for line in body if line.strip())
+    except binascii.Error as e:
+        raise TraceError("captura de consola con base64 inválido: %s" % e)
+
+
+def load(source):
+    if source.startswith(("http://", "https://")):
+        with urllib.request.urlopen(source, timeout=30) as resp:
+            return resp.read()
+    with open(source, "rb") as f:
+        data = f.read()
+    if not data.startswith(MAGIC):
+        dump = from_console(data)
+        if dump is not None:
+            return dump
+    return data
+
+
+def main(argv=None):
+    ap = argparse.ArgumentParser(description=__doc__.split("\n", 1)[0])
+    ap.add_argument("source", help="archivo del volcado, captura de la consola o URL de GET /trace")
+    ap.add_argument("-o", "--output", default="-", help="JSON de salida (por defecto stdout)")
+    args = ap.parse_args(argv)
+
+    try:
+        header, tasks, marks, isrs, records = parse(load(args.source))
+    except (OSError, TraceError) as e:
+        print("error: %s" % e, file=sys.stderr)
+        return 1
+
+    trace = convert(header, tasks, marks, isrs, records)
+    if args.output == "-":
+        json.dump(trace, sys.stdout)
+    else:
+        with open(args.output, "w") as f:
+            json.dump(trace, f)
+
+    span_ms = (records[-1][0] - records[0][0]) / 1000.0 if records else 0.0
+    print("%d registros en %.1f ms (%s perdidos por sobrescritura), %d tareas"
+          % (len(records), span_ms, "/".join(str(n) for n in header["overwritten"]), len(tasks)),
+          file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())